@@ -0,0 +1,51 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include "cfft.h"
+
+#include <math.h>
+
+void cfft_twiddles(float* tw, unsigned twn)
+{
+    for (unsigned i = 0; i < twn / 2; i++) {
+        tw[2 * i + 0] = cos(2 * M_PI * i / twn);
+        tw[2 * i + 1] = -sin(2 * M_PI * i / twn);
+    }
+}
+
+void cfft_run(float* d, unsigned n, const float* tw, unsigned twn, bool inv)
+{
+    unsigned i, j, len;
+
+    for (i = 1, j = 0; i < n; i++) {
+        unsigned bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j |= bit;
+
+        if (i < j) {
+            float t0 = d[2 * i], t1 = d[2 * i + 1];
+            d[2 * i] = d[2 * j]; d[2 * i + 1] = d[2 * j + 1];
+            d[2 * j] = t0; d[2 * j + 1] = t1;
+        }
+    }
+
+    for (len = 2; len <= n; len <<= 1) {
+        unsigned half = len / 2;
+        unsigned tstep = twn / len;
+
+        for (i = 0; i < n; i += len) {
+            for (j = 0; j < half; j++) {
+                float wr = tw[2 * j * tstep];
+                float wi = inv ? -tw[2 * j * tstep + 1] : tw[2 * j * tstep + 1];
+                float* a = d + 2 * (i + j);
+                float* b = d + 2 * (i + j + half);
+                float br = b[0] * wr - b[1] * wi;
+                float bi = b[0] * wi + b[1] * wr;
+
+                b[0] = a[0] - br; b[1] = a[1] - bi;
+                a[0] += br;       a[1] += bi;
+            }
+        }
+    }
+}
@@ -0,0 +1,18 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef CFFT_H
+#define CFFT_H
+
+#include <stdbool.h>
+
+// Plain in-place radix-2 FFT on interleaved complex float data, unnormalized
+// in both directions
+
+// Fill twiddle table for sizes up to twn (power of 2), twn / 2 complex values
+void cfft_twiddles(float* tw, unsigned twn);
+
+// n is a power of 2 not exceeding twn
+void cfft_run(float* d, unsigned n, const float* tw, unsigned twn, bool inv);
+
+#endif
@@ -0,0 +1,215 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include "nmea.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+
+enum {
+    NMEA_MAX_FIELDS = 24,
+};
+
+void nmea_init(nmea_state_t* st)
+{
+    memset(st, 0, sizeof(*st));
+}
+
+static int _nmea_hex(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+static int _nmea_dec(const char* s, unsigned n)
+{
+    int v = 0;
+    for (unsigned i = 0; i < n; i++) {
+        if (s[i] < '0' || s[i] > '9')
+            return -1;
+        v = v * 10 + (s[i] - '0');
+    }
+    return v;
+}
+
+// hhmmss[.sss]
+static int _nmea_parse_time(const char* f, uint32_t* tod_ms)
+{
+    int hh = _nmea_dec(f, 2);
+    int mm = (hh < 0) ? -1 : _nmea_dec(f + 2, 2);
+    int ss = (mm < 0) ? -1 : _nmea_dec(f + 4, 2);
+    unsigned ms = 0, scale = 100;
+
+    if (ss < 0 || hh > 23 || mm > 59 || ss > 60)
+        return -EINVAL;
+
+    if (f[6] == '.') {
+        for (const char* p = f + 7; *p >= '0' && *p <= '9' && scale > 0; p++, scale /= 10) {
+            ms += (*p - '0') * scale;
+        }
+    } else if (f[6] != 0) {
+        return -EINVAL;
+    }
+
+    *tod_ms = ((hh * 60 + mm) * 60 + ss) * 1000 + ms;
+    return 0;
+}
+
+static void _nmea_sentence(nmea_state_t* st, char* s)
+{
+    char* fields[NMEA_MAX_FIELDS];
+    unsigned nf = 0;
+    const char* type;
+    uint32_t tod;
+
+    for (char* p = s; nf < NMEA_MAX_FIELDS; ) {
+        fields[nf++] = p;
+        p = strchr(p, ',');
+        if (p == NULL)
+            break;
+        *p++ = 0;
+    }
+
+    // Talker id is ignored: GP, GN, GL, GA, BD ...
+    if (strlen(fields[0]) != 5)
+        return;
+
+    type = fields[0] + 2;
+    if (strcmp(type, "RMC") == 0 && nf >= 10) {
+        if (_nmea_parse_time(fields[1], &tod) == 0) {
+            st->tod_ms = tod;
+            st->has_time = true;
+            st->seq++;
+        }
+        st->valid = (fields[2][0] == 'A');
+
+        if (strlen(fields[9]) == 6) {
+            int dd = _nmea_dec(fields[9], 2);
+            int mo = _nmea_dec(fields[9] + 2, 2);
+            int yy = _nmea_dec(fields[9] + 4, 2);
+
+            if (dd > 0 && mo > 0 && mo <= 12 && yy >= 0) {
+                st->day = dd;
+                st->month = mo;
+                st->year = 2000 + yy;
+                st->has_date = true;
+            }
+        }
+    } else if (strcmp(type, "GGA") == 0 && nf >= 8) {
+        if (_nmea_parse_time(fields[1], &tod) == 0) {
+            st->tod_ms = tod;
+            st->has_time = true;
+            st->seq++;
+        }
+        st->fix = atoi(fields[6]);
+        st->sats = atoi(fields[7]);
+    } else if (strcmp(type, "ZDA") == 0 && nf >= 5) {
+        int dd = _nmea_dec(fields[2], 2);
+        int mo = _nmea_dec(fields[3], 2);
+        int yyyy = _nmea_dec(fields[4], 4);
+
+        if (_nmea_parse_time(fields[1], &tod) == 0) {
+            st->tod_ms = tod;
+            st->has_time = true;
+            st->seq++;
+        }
+        if (dd > 0 && mo > 0 && mo <= 12 && yyyy > 0) {
+            st->day = dd;
+            st->month = mo;
+            st->year = yyyy;
+            st->has_date = true;
+        }
+    }
+}
+
+// $<body>*HH, CR/LF already stripped
+static bool _nmea_line(nmea_state_t* st)
+{
+    char* l = st->line;
+    unsigned n = st->pos;
+    uint8_t cs = 0;
+    int h, lo;
+
+    if (n < 4 || l[0] != '$' || l[n - 3] != '*')
+        return false;
+
+    h = _nmea_hex(l[n - 2]);
+    lo = _nmea_hex(l[n - 1]);
+    if (h < 0 || lo < 0)
+        return false;
+
+    for (unsigned i = 1; i < n - 3; i++) {
+        cs ^= (uint8_t)l[i];
+    }
+    if (cs != ((h << 4) | lo))
+        return false;
+
+    l[n] = 0;
+    memcpy(st->last, l, n + 1);
+
+    l[n - 3] = 0;
+    _nmea_sentence(st, l + 1);
+    return true;
+}
+
+unsigned nmea_feed(nmea_state_t* st, const char* data, unsigned len)
+{
+    unsigned accepted = 0;
+
+    for (unsigned i = 0; i < len; i++) {
+        char c = data[i];
+
+        if (c == '$') {
+            if (st->pos != 0)
+                st->errors++;
+
+            st->line[0] = c;
+            st->pos = 1;
+        } else if (c == '\r' || c == '\n') {
+            if (st->pos == 0)
+                continue;
+
+            if (_nmea_line(st)) {
+                st->sentences++;
+                accepted++;
+            } else {
+                st->errors++;
+            }
+            st->pos = 0;
+        } else if (st->pos != 0) {
+            if (st->pos >= NMEA_MAX_LINE - 1 || c < 32 || c > 126) {
+                st->errors++;
+                st->pos = 0;
+                continue;
+            }
+            st->line[st->pos++] = c;
+        }
+    }
+
+    return accepted;
+}
+
+int nmea_unix_time(const nmea_state_t* st, int64_t* sec)
+{
+    int y = st->year, m = st->month, d = st->day;
+    int64_t era, yoe, doy, doe;
+
+    if (!st->has_time || !st->has_date)
+        return -EAGAIN;
+
+    // Days from civil, proleptic Gregorian calendar
+    y -= (m <= 2) ? 1 : 0;
+    era = y / 400;
+    yoe = y - era * 400;
+    doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    *sec = (era * 146097 + doe - 719468) * 86400 + st->tod_ms / 1000;
+    return 0;
+}
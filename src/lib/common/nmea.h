@@ -0,0 +1,48 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef NMEA_H
+#define NMEA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Incremental parser of NMEA 0183 stream from GPS/GNSS modules. Bytes are fed
+// as they come from UART, sentences are validated by checksum, only time, fix
+// and satellites information is extracted (RMC, GGA and ZDA of any talker).
+
+#define NMEA_MAX_LINE  96
+
+struct nmea_state {
+    char line[NMEA_MAX_LINE];
+    unsigned pos;
+
+    uint32_t tod_ms;      // UTC time of day of the last sentence carrying time
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    bool has_time;
+    bool has_date;
+    bool valid;           // RMC status 'A'
+
+    unsigned fix;         // GGA fix quality, 0 - no fix
+    unsigned sats;        // Satellites in use
+
+    unsigned seq;         // Incremented on every sentence carrying time
+    unsigned sentences;   // Accepted sentences
+    unsigned errors;      // Malformed or checksum mismatch
+
+    char last[NMEA_MAX_LINE]; // Last accepted sentence
+};
+typedef struct nmea_state nmea_state_t;
+
+void nmea_init(nmea_state_t* st);
+
+// Returns number of sentences accepted
+unsigned nmea_feed(nmea_state_t* st, const char* data, unsigned len);
+
+// UTC seconds since the epoch of the last time sentence, -EAGAIN if date or
+// time hasn't been received yet
+int nmea_unix_time(const nmea_state_t* st, int64_t* sec);
+
+#endif
@@ -0,0 +1,63 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include "rx_agc.h"
+
+#include <math.h>
+
+void rx_agc_init(rx_agc_t* agc, const struct rx_agc_params* params, unsigned rate, int gain)
+{
+    agc->p = *params;
+    agc->rate = rate;
+
+    if (gain < agc->p.gain_min)
+        gain = agc->p.gain_min;
+    else if (gain > agc->p.gain_max)
+        gain = agc->p.gain_max;
+
+    agc->gain = gain;
+    agc->gain_applied = gain;
+    agc->hold_ts = 0;
+}
+
+bool rx_agc_update(rx_agc_t* agc, double level_dbfs, bool clipped,
+                   uint64_t ts, unsigned nsyms, int* gain)
+{
+    double err = agc->p.target_dbfs - level_dbfs;
+    double tau, k;
+    int g;
+
+    if (ts < agc->hold_ts || nsyms == 0 || agc->rate == 0)
+        return false;
+
+    if (clipped) {
+        if (err > -RX_AGC_CLIP_STEP)
+            err = -RX_AGC_CLIP_STEP;
+    } else if (fabs(err) <= agc->p.hyst_db) {
+        return false;
+    }
+
+    tau = (err < 0) ? agc->p.attack_us : agc->p.decay_us;
+    k = (tau > 0 && !clipped) ? 1.0 - exp(-1.0e6 * nsyms / agc->rate / tau) : 1.0;
+
+    agc->gain += err * k;
+    if (agc->gain < agc->p.gain_min)
+        agc->gain = agc->p.gain_min;
+    else if (agc->gain > agc->p.gain_max)
+        agc->gain = agc->p.gain_max;
+
+    g = (int)lrint(agc->gain);
+    if (g == agc->gain_applied)
+        return false;
+
+    agc->gain_applied = g;
+    agc->hold_ts = ts + nsyms + (uint64_t)agc->p.holdoff_us * agc->rate / 1000000u;
+    *gain = g;
+    return true;
+}
+
+double rx_agc_level_dbfs(uint64_t sum_sq, unsigned nsyms, unsigned fs)
+{
+    double p = (nsyms && sum_sq) ? (double)sum_sq / nsyms / ((double)fs * fs) : 1.0e-12;
+    return 10 * log10(p);
+}
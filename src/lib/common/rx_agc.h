@@ -0,0 +1,48 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef RX_AGC_H
+#define RX_AGC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Closed loop RX gain control driven by the level of received packets.
+//
+// Gain is tracked as a real value moving towards the target with separate
+// attack (gain reduction) and decay (gain increase) time constants, integer
+// gain is applied only when it changes. Packets received before a change has
+// propagated through the receive chain are ignored.
+
+#define RX_AGC_CLIP_STEP  6  // dB of immediate reduction on clipping
+
+struct rx_agc_params {
+    int target_dbfs;      // Desired mean power
+    unsigned hyst_db;     // No action while level is within target +/- hyst_db
+    unsigned attack_us;   // Gain reduction time constant, 0 - immediate
+    unsigned decay_us;    // Gain increase time constant, 0 - immediate
+    unsigned holdoff_us;  // Settle time of the receive chain after a change
+    int gain_min;
+    int gain_max;
+};
+
+struct rx_agc {
+    struct rx_agc_params p;
+    unsigned rate;
+    double gain;
+    int gain_applied;
+    uint64_t hold_ts;     // First sample to be measured after the last change
+};
+typedef struct rx_agc rx_agc_t;
+
+void rx_agc_init(rx_agc_t* agc, const struct rx_agc_params* params, unsigned rate, int gain);
+
+// Feed level of nsyms samples starting at ts. Returns true and the gain to be
+// applied in *gain when it changes.
+bool rx_agc_update(rx_agc_t* agc, double level_dbfs, bool clipped,
+                   uint64_t ts, unsigned nsyms, int* gain);
+
+// Mean power in dBFS from sum of I^2 + Q^2, full scale is fs
+double rx_agc_level_dbfs(uint64_t sum_sq, unsigned nsyms, unsigned fs);
+
+#endif
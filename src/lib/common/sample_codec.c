@@ -0,0 +1,463 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include "sample_codec.h"
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+// Rice code: unary quotient longer than SCODEC_ESC is replaced by the raw value
+#define SCODEC_ESC       24
+#define SCODEC_ESC_BITS  20
+#define SCODEC_KMAX      18
+// Worst case encoded group size in bytes
+#define SCODEC_GROUP_MAX (1 + (SCODEC_GROUP * (SCODEC_ESC + SCODEC_ESC_BITS) + 7) / 8)
+
+static const char* s_mode_names[] = { "raw", "fast", "strong" };
+
+int sample_codec_fmt_from_str(const char* fmt)
+{
+    if (strcmp(fmt, "ci8") == 0)
+        return SCODEC_CI8;
+    if (strcmp(fmt, "ci12") == 0)
+        return SCODEC_CI12;
+    if (strcmp(fmt, "ci16") == 0)
+        return SCODEC_CI16;
+    return -EINVAL;
+}
+
+int sample_codec_mode_from_str(const char* mode)
+{
+    for (unsigned i = 0; i < sizeof(s_mode_names) / sizeof(s_mode_names[0]); i++) {
+        if (strcmp(mode, s_mode_names[i]) == 0)
+            return i;
+    }
+    return -EINVAL;
+}
+
+const char* sample_codec_mode_to_str(unsigned mode)
+{
+    return (mode <= SCODEC_STRONG) ? s_mode_names[mode] : "unknown";
+}
+
+// Only whole complex samples are coded, the rest of the block is stored as is
+static unsigned _codec_nvals(unsigned fmt, unsigned bytes)
+{
+    switch (fmt) {
+    case SCODEC_CI8: return bytes / 2 * 2;
+    case SCODEC_CI12: return bytes / 3 * 2;
+    default: return bytes / 4 * 2;
+    }
+}
+
+static unsigned _codec_bytes(unsigned fmt, unsigned nvals)
+{
+    switch (fmt) {
+    case SCODEC_CI8: return nvals;
+    case SCODEC_CI12: return nvals / 2 * 3;
+    default: return nvals * 2;
+    }
+}
+
+static void _codec_load(unsigned fmt, const uint8_t* in, unsigned start, unsigned cnt, int32_t* x)
+{
+    switch (fmt) {
+    case SCODEC_CI8:
+        for (unsigned k = 0; k < cnt; k++) {
+            x[k] = (int8_t)in[start + k];
+        }
+        break;
+    case SCODEC_CI12:
+        in += start / 2 * 3;
+        for (unsigned k = 0; k < cnt; k += 2, in += 3) {
+            x[k + 0] = (int32_t)((uint32_t)(in[0] | (in[1] << 8)) << 20) >> 20;
+            x[k + 1] = (int32_t)((uint32_t)((in[1] >> 4) | (in[2] << 4)) << 20) >> 20;
+        }
+        break;
+    default:
+        in += start * 2;
+        for (unsigned k = 0; k < cnt; k++) {
+            x[k] = (int16_t)(in[2 * k] | (in[2 * k + 1] << 8));
+        }
+        break;
+    }
+}
+
+static void _codec_store(unsigned fmt, uint8_t* out, unsigned start, unsigned cnt, const int32_t* x)
+{
+    switch (fmt) {
+    case SCODEC_CI8:
+        for (unsigned k = 0; k < cnt; k++) {
+            out[start + k] = x[k];
+        }
+        break;
+    case SCODEC_CI12:
+        out += start / 2 * 3;
+        for (unsigned k = 0; k < cnt; k += 2, out += 3) {
+            out[0] = x[k];
+            out[1] = ((x[k] >> 8) & 0x0f) | ((uint32_t)x[k + 1] << 4);
+            out[2] = x[k + 1] >> 4;
+        }
+        break;
+    default:
+        out += start * 2;
+        for (unsigned k = 0; k < cnt; k++) {
+            out[2 * k] = x[k];
+            out[2 * k + 1] = x[k] >> 8;
+        }
+        break;
+    }
+}
+
+static inline uint32_t _zigzag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t _unzigzag(uint32_t v)
+{
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static inline unsigned _bitlen(uint32_t v)
+{
+    return v ? 32 - __builtin_clz(v) : 0;
+}
+
+struct bitw {
+    uint8_t* start;
+    uint8_t* p;
+    uint64_t acc;
+    unsigned cnt;
+};
+
+// v should fit into n bits, n <= 32
+static inline void _bitw_put(struct bitw* w, uint32_t v, unsigned n)
+{
+    w->acc |= (uint64_t)v << w->cnt;
+    w->cnt += n;
+    if (w->cnt >= 32) {
+        w->p[0] = w->acc;
+        w->p[1] = w->acc >> 8;
+        w->p[2] = w->acc >> 16;
+        w->p[3] = w->acc >> 24;
+        w->p += 4;
+        w->acc >>= 32;
+        w->cnt -= 32;
+    }
+}
+
+static unsigned _bitw_size(const struct bitw* w)
+{
+    return (w->p - w->start) + (w->cnt + 7) / 8;
+}
+
+static void _bitw_flush(struct bitw* w)
+{
+    for (; w->cnt > 0; w->cnt = (w->cnt > 8) ? w->cnt - 8 : 0) {
+        *(w->p++) = w->acc;
+        w->acc >>= 8;
+    }
+}
+
+struct bitr {
+    const uint8_t* start;
+    const uint8_t* p;
+    const uint8_t* end;
+    uint64_t acc;
+    unsigned cnt;
+    unsigned over; // Zero bytes padded after the end
+};
+
+static inline void _bitr_fill(struct bitr* r)
+{
+    while (r->cnt <= 56) {
+        uint64_t b = 0;
+        if (r->p < r->end) {
+            b = *(r->p++);
+        } else {
+            r->over++;
+        }
+        r->acc |= b << r->cnt;
+        r->cnt += 8;
+    }
+}
+
+static inline uint32_t _bitr_get(struct bitr* r, unsigned n)
+{
+    _bitr_fill(r);
+    uint32_t v = r->acc & ((1ull << n) - 1);
+    r->acc >>= n;
+    r->cnt -= n;
+    return v;
+}
+
+// Returns SCODEC_ESC on escape
+static inline unsigned _bitr_unary(struct bitr* r)
+{
+    _bitr_fill(r);
+    unsigned q = (~r->acc) ? __builtin_ctzll(~r->acc) : 64;
+    if (q >= SCODEC_ESC) {
+        r->acc >>= SCODEC_ESC;
+        r->cnt -= SCODEC_ESC;
+        return SCODEC_ESC;
+    }
+    r->acc >>= q + 1;
+    r->cnt -= q + 1;
+    return q;
+}
+
+static int _bitr_consumed(const struct bitr* r)
+{
+    unsigned bits = (r->p - r->start + r->over) * 8 - r->cnt;
+    if (r->over * 8 > r->cnt)
+        return -EINVAL;
+    return (bits + 7) / 8;
+}
+
+// x[] holds 4 history values followed by the group, I and Q are predicted separately
+static void _codec_group_fast(struct bitw* w, const int32_t* x, unsigned cnt)
+{
+    uint32_t z[SCODEC_GROUP];
+    uint32_t acc = 0;
+
+    for (unsigned k = 0; k < cnt; k++) {
+        z[k] = _zigzag(x[k + 4] - x[k + 2]);
+        acc |= z[k];
+    }
+
+    unsigned bits = _bitlen(acc);
+    _bitw_put(w, bits, 8);
+    if (bits == 0)
+        return;
+
+    for (unsigned k = 0; k < cnt; k++) {
+        _bitw_put(w, z[k], bits);
+    }
+}
+
+static uint64_t _codec_rice_cost(const uint32_t* z, unsigned cnt, unsigned k)
+{
+    uint64_t cost = 0;
+    for (unsigned i = 0; i < cnt; i++) {
+        uint32_t q = z[i] >> k;
+        cost += (q < SCODEC_ESC) ? q + 1 + k : SCODEC_ESC + SCODEC_ESC_BITS;
+    }
+    return cost;
+}
+
+static void _codec_group_strong(struct bitw* w, const int32_t* x, unsigned cnt)
+{
+    uint32_t z1[SCODEC_GROUP];
+    uint32_t z2[SCODEC_GROUP];
+    uint64_t s1 = 0, s2 = 0;
+
+    for (unsigned k = 0; k < cnt; k++) {
+        z1[k] = _zigzag(x[k + 4] - x[k + 2]);
+        z2[k] = _zigzag(x[k + 4] - 2 * x[k + 2] + x[k]);
+        s1 += z1[k];
+        s2 += z2[k];
+    }
+
+    bool order2 = s2 < s1;
+    const uint32_t* z = order2 ? z2 : z1;
+    uint64_t mean = (order2 ? s2 : s1) / cnt;
+
+    // Optimal Rice parameter is close to log2(mean), check the neighbours
+    unsigned k0 = mean ? _bitlen(mean) - 1 : 0;
+    if (k0 > SCODEC_KMAX)
+        k0 = SCODEC_KMAX;
+    unsigned kbest = 0;
+    uint64_t cbest = UINT64_MAX;
+    for (unsigned k = (k0 ? k0 - 1 : 0); k <= k0 + 1 && k <= SCODEC_KMAX; k++) {
+        uint64_t c = _codec_rice_cost(z, cnt, k);
+        if (c < cbest) {
+            cbest = c;
+            kbest = k;
+        }
+    }
+
+    _bitw_put(w, kbest | (order2 ? 0x80 : 0), 8);
+    for (unsigned i = 0; i < cnt; i++) {
+        uint32_t q = z[i] >> kbest;
+        if (q < SCODEC_ESC) {
+            _bitw_put(w, (1u << q) - 1, q + 1);
+            if (kbest)
+                _bitw_put(w, z[i] & ((1u << kbest) - 1), kbest);
+        } else {
+            _bitw_put(w, (1u << SCODEC_ESC) - 1, SCODEC_ESC);
+            _bitw_put(w, z[i], SCODEC_ESC_BITS);
+        }
+    }
+}
+
+// Returns 0 when coded data isn't smaller than limit
+static unsigned _codec_encode_vals(unsigned fmt, unsigned mode, const uint8_t* in, unsigned nvals,
+                                   uint8_t* out, unsigned limit)
+{
+    int32_t x[SCODEC_GROUP + 4] = { 0, };
+    struct bitw w = { out, out, 0, 0 };
+
+    for (unsigned s = 0; s < nvals; s += SCODEC_GROUP) {
+        unsigned cnt = (nvals - s > SCODEC_GROUP) ? SCODEC_GROUP : nvals - s;
+        if (_bitw_size(&w) + SCODEC_GROUP_MAX > limit)
+            return 0;
+
+        _codec_load(fmt, in, s, cnt, x + 4);
+        if (mode == SCODEC_FAST) {
+            _codec_group_fast(&w, x, cnt);
+        } else {
+            _codec_group_strong(&w, x, cnt);
+        }
+        memmove(x, x + cnt, 4 * sizeof(x[0]));
+    }
+
+    _bitw_flush(&w);
+    return (_bitw_size(&w) < limit) ? _bitw_size(&w) : 0;
+}
+
+static int _codec_decode_vals(unsigned fmt, unsigned mode, const uint8_t* in, unsigned len,
+                              unsigned nvals, uint8_t* out)
+{
+    int32_t x[SCODEC_GROUP + 4] = { 0, };
+    struct bitr r = { in, in, in + len, 0, 0, 0 };
+    // Encoder only produces values of the sample format, anything else is corrupted data
+    const int64_t vmax = (fmt == SCODEC_CI8) ? INT8_MAX : (fmt == SCODEC_CI12) ? 2047 : INT16_MAX;
+    const int64_t vmin = -vmax - 1;
+
+    for (unsigned s = 0; s < nvals; s += SCODEC_GROUP) {
+        unsigned cnt = (nvals - s > SCODEC_GROUP) ? SCODEC_GROUP : nvals - s;
+        unsigned hdr = _bitr_get(&r, 8);
+
+        if (mode == SCODEC_FAST) {
+            if (hdr > 32)
+                return -EINVAL;
+
+            for (unsigned k = 0; k < cnt; k++) {
+                int32_t d = hdr ? _unzigzag(_bitr_get(&r, hdr)) : 0;
+                int64_t v = (int64_t)x[k + 2] + d;
+                if (v < vmin || v > vmax)
+                    return -EINVAL;
+
+                x[k + 4] = v;
+            }
+        } else {
+            unsigned kp = hdr & 0x1f;
+            bool order2 = hdr & 0x80;
+            if (kp > SCODEC_KMAX)
+                return -EINVAL;
+
+            for (unsigned k = 0; k < cnt; k++) {
+                unsigned q = _bitr_unary(&r);
+                uint32_t z = (q == SCODEC_ESC) ? _bitr_get(&r, SCODEC_ESC_BITS) :
+                                                 (q << kp) | (kp ? _bitr_get(&r, kp) : 0);
+                int32_t d = _unzigzag(z);
+                int64_t v = order2 ? 2 * (int64_t)x[k + 2] - x[k] + d : (int64_t)x[k + 2] + d;
+                if (v < vmin || v > vmax)
+                    return -EINVAL;
+
+                x[k + 4] = v;
+            }
+        }
+
+        _codec_store(fmt, out, s, cnt, x + 4);
+        memmove(x, x + cnt, 4 * sizeof(x[0]));
+    }
+
+    return _bitr_consumed(&r);
+}
+
+int sample_codec_encode(unsigned fmt, unsigned mode,
+                        const void* in, unsigned raw_len,
+                        void* out, unsigned out_max)
+{
+    sample_codec_hdr_t hdr;
+    uint8_t* payload = (uint8_t*)out + sizeof(hdr);
+    unsigned nvals, used, len = 0;
+
+    if (fmt > SCODEC_CI16 || mode > SCODEC_STRONG)
+        return -EINVAL;
+    if (out_max < sample_codec_bound(raw_len))
+        return -ENOSPC;
+
+    nvals = _codec_nvals(fmt, raw_len);
+    used = _codec_bytes(fmt, nvals);
+    if (mode != SCODEC_RAW && nvals > 0) {
+        len = _codec_encode_vals(fmt, mode, (const uint8_t*)in, nvals, payload, used);
+    }
+
+    if (len == 0) {
+        mode = SCODEC_RAW;
+        memcpy(payload, in, raw_len);
+        len = raw_len;
+    } else {
+        memcpy(payload + len, (const uint8_t*)in + used, raw_len - used);
+        len += raw_len - used;
+    }
+
+    hdr.magic = SCODEC_MAGIC;
+    hdr.mode = mode;
+    hdr.fmt = fmt;
+    hdr.reserved = 0;
+    hdr.raw_len = raw_len;
+    hdr.enc_len = len;
+    memcpy(out, &hdr, sizeof(hdr));
+
+    return sizeof(hdr) + len;
+}
+
+int sample_codec_block_info(const void* in, unsigned* raw_len, unsigned* enc_len)
+{
+    sample_codec_hdr_t hdr;
+    memcpy(&hdr, in, sizeof(hdr));
+
+    if (hdr.magic != SCODEC_MAGIC || hdr.mode > SCODEC_STRONG || hdr.fmt > SCODEC_CI16)
+        return -EINVAL;
+    if (hdr.mode == SCODEC_RAW && hdr.raw_len != hdr.enc_len)
+        return -EINVAL;
+
+    *raw_len = hdr.raw_len;
+    *enc_len = hdr.enc_len;
+    return 0;
+}
+
+int sample_codec_decode(const void* in, unsigned blk_len,
+                        void* out, unsigned out_max)
+{
+    sample_codec_hdr_t hdr;
+    const uint8_t* payload = (const uint8_t*)in + sizeof(hdr);
+    unsigned raw_len, enc_len;
+    int res;
+
+    if (blk_len < sizeof(hdr))
+        return -EINVAL;
+
+    res = sample_codec_block_info(in, &raw_len, &enc_len);
+    if (res)
+        return res;
+    if (blk_len < sizeof(hdr) + enc_len)
+        return -EINVAL;
+    if (out_max < raw_len)
+        return -ENOSPC;
+
+    memcpy(&hdr, in, sizeof(hdr));
+    if (hdr.mode == SCODEC_RAW) {
+        memcpy(out, payload, raw_len);
+        return raw_len;
+    }
+
+    unsigned nvals = _codec_nvals(hdr.fmt, raw_len);
+    unsigned used = _codec_bytes(hdr.fmt, nvals);
+    unsigned tail = raw_len - used;
+    if (enc_len < tail)
+        return -EINVAL;
+
+    res = _codec_decode_vals(hdr.fmt, hdr.mode, payload, enc_len - tail, nvals, (uint8_t*)out);
+    if (res < 0)
+        return res;
+    if ((unsigned)res != enc_len - tail)
+        return -EINVAL;
+
+    memcpy((uint8_t*)out + used, payload + res, tail);
+    return raw_len;
+}
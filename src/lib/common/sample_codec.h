@@ -0,0 +1,64 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef SAMPLE_CODEC_H
+#define SAMPLE_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Lossless block codec for interleaved complex integer samples.
+//
+// Every block is self-contained (predictor restarts at the block beginning),
+// so blocks may be compressed in parallel and a stream of blocks is just
+// their concatenation. Block layout is sample_codec_hdr followed by enc_len
+// bytes of payload.
+
+#define SCODEC_MAGIC  0x31435355 // "USC1"
+#define SCODEC_GROUP  64         // Values sharing one bit width / Rice parameter
+
+enum sample_codec_fmt {
+    SCODEC_CI8,
+    SCODEC_CI12,
+    SCODEC_CI16,
+};
+
+enum sample_codec_mode {
+    SCODEC_RAW,    // Stored as is
+    SCODEC_FAST,   // Zigzag delta + fixed width bit packing per group
+    SCODEC_STRONG, // Adaptive 1st/2nd order prediction + Rice coding per group
+};
+
+struct sample_codec_hdr {
+    uint32_t magic;
+    uint8_t mode;
+    uint8_t fmt;
+    uint16_t reserved;
+    uint32_t raw_len;  // Decoded size in bytes
+    uint32_t enc_len;  // Payload size in bytes
+};
+typedef struct sample_codec_hdr sample_codec_hdr_t;
+
+// Worst case block size (header included) for raw_len bytes of input
+static inline size_t sample_codec_bound(size_t raw_len) {
+    return sizeof(sample_codec_hdr_t) + raw_len + 512;
+}
+
+int sample_codec_fmt_from_str(const char* fmt);
+int sample_codec_mode_from_str(const char* mode);
+const char* sample_codec_mode_to_str(unsigned mode);
+
+// Returns block size written to out or negative error code, incompressible
+// data is stored in SCODEC_RAW mode
+int sample_codec_encode(unsigned fmt, unsigned mode,
+                        const void* in, unsigned raw_len,
+                        void* out, unsigned out_max);
+
+// Validate block header, returns 0 and fills sizes on success
+int sample_codec_block_info(const void* hdr, unsigned* raw_len, unsigned* enc_len);
+
+// Decode the whole block (header included), returns decoded size or negative error code
+int sample_codec_decode(const void* in, unsigned blk_len,
+                        void* out, unsigned out_max);
+
+#endif
@@ -0,0 +1,207 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include "wb_stitch.h"
+#include "cfft.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+#define WB_STITCH_MAX_BOARDS  32
+#define WB_STITCH_MAX_OUT     (1u << 20)
+
+struct wb_stitch {
+    unsigned boards;
+    unsigned n;        // Board FFT size
+    unsigned m;        // Output FFT size
+    unsigned interp;
+    unsigned spacing;
+    uint64_t blk;
+
+    float* tw;         // e^-j2pik/m, m/2 complex
+    float* resp;       // Crossover response at bins -n/2..n/2-1 (scaled by interp/m)
+    float* hist;       // Last n samples of every board
+    float* x;          // n complex
+    float* z;          // m complex
+    float* coef;       // Per board eq and delay rotation
+    float* eq;         // Per board user gain/phase, 2 floats
+    int* offs;
+};
+
+// Blackman windowed sinc of m/2 + 1 taps at the output rate, cutoff is half of
+// the spacing, unity DC gain
+static void _wb_design(wb_stitch_t* st)
+{
+    unsigned taps = st->m / 2 + 1;
+    double d = (taps - 1) / 2.0;
+    double fc = st->spacing / 2.0 / st->m;
+    double sum = 0;
+    unsigned i;
+    int k;
+
+    memset(st->z, 0, st->m * 2 * sizeof(float));
+    for (i = 0; i < taps; i++) {
+        double t = i - d;
+        double s = (t == 0) ? 2 * fc : sin(2 * M_PI * fc * t) / (M_PI * t);
+        double w = 0.42 - 0.5 * cos(2 * M_PI * i / (taps - 1)) + 0.08 * cos(4 * M_PI * i / (taps - 1));
+        st->z[2 * i] = s * w;
+        sum += s * w;
+    }
+
+    cfft_run(st->z, st->m, st->tw, st->m, false);
+
+    for (k = -(int)st->n / 2; k < (int)st->n / 2; k++) {
+        unsigned bin = (k + st->m) % st->m;
+        st->resp[2 * (k + st->n / 2) + 0] = st->z[2 * bin + 0] * st->interp / st->m / sum;
+        st->resp[2 * (k + st->n / 2) + 1] = st->z[2 * bin + 1] * st->interp / st->m / sum;
+    }
+}
+
+static void _wb_update_coef(wb_stitch_t* st, unsigned b)
+{
+    // Filter delay is applied before the frequency shift, undo its board
+    // dependent phase so all boards add up coherently
+    double ph = st->eq[2 * b + 1] - 2 * M_PI * st->offs[b] * (st->m / 4.0) / st->m;
+
+    st->coef[2 * b + 0] = st->eq[2 * b] * cos(ph);
+    st->coef[2 * b + 1] = st->eq[2 * b] * sin(ph);
+}
+
+int wb_stitch_create(unsigned boards, unsigned fftsz, unsigned spacing, wb_stitch_t** out)
+{
+    wb_stitch_t* st;
+    unsigned i;
+
+    if (boards == 0 || boards > WB_STITCH_MAX_BOARDS)
+        return -EINVAL;
+    if (fftsz < 64 || (fftsz & (fftsz - 1)))
+        return -EINVAL;
+    if (spacing == 0 || (spacing & 1) || spacing + WB_STITCH_GUARD > fftsz)
+        return -EINVAL;
+
+    st = (wb_stitch_t*)calloc(1, sizeof(wb_stitch_t));
+    if (!st)
+        return -ENOMEM;
+
+    st->boards = boards;
+    st->n = fftsz;
+    st->spacing = spacing;
+    for (st->interp = 1; st->interp * fftsz < boards * spacing + WB_STITCH_GUARD; st->interp <<= 1);
+    st->m = st->interp * fftsz;
+    if (st->m > WB_STITCH_MAX_OUT) {
+        free(st);
+        return -EINVAL;
+    }
+
+    st->tw = (float*)malloc(st->m * sizeof(float));
+    st->resp = (float*)malloc(st->n * 2 * sizeof(float));
+    st->hist = (float*)calloc(boards * st->n * 2, sizeof(float));
+    st->x = (float*)malloc(st->n * 2 * sizeof(float));
+    st->z = (float*)malloc(st->m * 2 * sizeof(float));
+    st->coef = (float*)malloc(boards * 2 * sizeof(float));
+    st->eq = (float*)malloc(boards * 2 * sizeof(float));
+    st->offs = (int*)malloc(boards * sizeof(int));
+    if (!st->tw || !st->resp || !st->hist || !st->x || !st->z || !st->coef || !st->eq || !st->offs) {
+        wb_stitch_destroy(st);
+        return -ENOMEM;
+    }
+
+    cfft_twiddles(st->tw, st->m);
+
+    for (i = 0; i < boards; i++) {
+        st->offs[i] = (int)(i * spacing) - (int)((boards - 1) * spacing / 2);
+        st->eq[2 * i + 0] = 1.0f;
+        st->eq[2 * i + 1] = 0.0f;
+        _wb_update_coef(st, i);
+    }
+
+    _wb_design(st);
+
+    *out = st;
+    return 0;
+}
+
+void wb_stitch_destroy(wb_stitch_t* st)
+{
+    free(st->tw);
+    free(st->resp);
+    free(st->hist);
+    free(st->x);
+    free(st->z);
+    free(st->coef);
+    free(st->eq);
+    free(st->offs);
+    free(st);
+}
+
+unsigned wb_stitch_interp(const wb_stitch_t* st)
+{
+    return st->interp;
+}
+
+int wb_stitch_offset(const wb_stitch_t* st, unsigned board)
+{
+    return (board < st->boards) ? st->offs[board] : 0;
+}
+
+int wb_stitch_set_eq(wb_stitch_t* st, unsigned board, float gain, float phase)
+{
+    if (board >= st->boards)
+        return -EINVAL;
+
+    st->eq[2 * board + 0] = gain;
+    st->eq[2 * board + 1] = phase;
+    _wb_update_coef(st, board);
+    return 0;
+}
+
+int wb_stitch_process(wb_stitch_t* st, const float* const* in, unsigned nsyms, float* out)
+{
+    unsigned hop = st->n / 2;
+    unsigned p, b;
+    int k;
+
+    if (nsyms % hop)
+        return -EINVAL;
+
+    for (p = 0; p < nsyms; p += hop, st->blk++) {
+        memset(st->z, 0, st->m * 2 * sizeof(float));
+
+        for (b = 0; b < st->boards; b++) {
+            float* h = st->hist + b * st->n * 2;
+            float cr = st->coef[2 * b + 0];
+            float ci = st->coef[2 * b + 1];
+
+            // Block starts half a hop earlier than the output it produces,
+            // keep the frequency shift continuous from block to block
+            if ((st->offs[b] & 1) && !(st->blk & 1)) {
+                cr = -cr;
+                ci = -ci;
+            }
+
+            memmove(h, h + hop * 2, hop * 2 * sizeof(float));
+            memcpy(h + hop * 2, in[b] + p * 2, hop * 2 * sizeof(float));
+            memcpy(st->x, h, st->n * 2 * sizeof(float));
+
+            cfft_run(st->x, st->n, st->tw, st->m, false);
+
+            for (k = -(int)st->n / 2 + 1; k < (int)st->n / 2; k++) {
+                const float* xv = st->x + 2 * ((k + st->n) % st->n);
+                const float* rv = st->resp + 2 * (k + st->n / 2);
+                float* zv = st->z + 2 * ((k + st->offs[b] + st->m) % st->m);
+                float wr = rv[0] * cr - rv[1] * ci;
+                float wi = rv[0] * ci + rv[1] * cr;
+
+                zv[0] += xv[0] * wr - xv[1] * wi;
+                zv[1] += xv[0] * wi + xv[1] * wr;
+            }
+        }
+
+        cfft_run(st->z, st->m, st->tw, st->m, true);
+        memcpy(out + p * st->interp * 2, st->z + st->m, st->m * sizeof(float));
+    }
+
+    return 0;
+}
@@ -0,0 +1,45 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef WB_STITCH_H
+#define WB_STITCH_H
+
+#include <stdint.h>
+
+// Synthesis of one wideband complex stream from several boards tuned to
+// adjacent, overlapping sub-bands.
+//
+// Every board delivers cf32 samples at rate fs, boards are spaced by
+// spacing * fs / fftsz Hz around the common center. Output rate is
+// fs * interp, interp being the smallest power of 2 to hold the whole band.
+//
+// Processing is overlap-save with a hop of fftsz / 2 input samples: board
+// spectra are weighted by a linear phase crossover filter with the cutoff in
+// the middle between neighbouring centers, moved to their place in the output
+// spectrum and inverse transformed at once. Crossover responses of adjacent
+// boards are complementary, so the stitched response is flat across the seams
+// once boards are gain/phase equalized. Output is delayed by fftsz * interp / 4
+// samples.
+
+#define WB_STITCH_GUARD  32 // Output bins reserved for the outer transition bands
+
+struct wb_stitch;
+typedef struct wb_stitch wb_stitch_t;
+
+// fftsz is a power of 2, spacing is in fs / fftsz units and must be even
+int wb_stitch_create(unsigned boards, unsigned fftsz, unsigned spacing, wb_stitch_t** out);
+void wb_stitch_destroy(wb_stitch_t* st);
+
+unsigned wb_stitch_interp(const wb_stitch_t* st);
+
+// Center of the board relative to the stitched center, fs / fftsz units
+int wb_stitch_offset(const wb_stitch_t* st, unsigned board);
+
+// Correction applied to board samples
+int wb_stitch_set_eq(wb_stitch_t* st, unsigned board, float gain, float phase);
+
+// Consume nsyms samples of every board (multiple of fftsz / 2) and produce
+// nsyms * interp output samples
+int wb_stitch_process(wb_stitch_t* st, const float* const* in, unsigned nsyms, float* out);
+
+#endif
@@ -13,6 +13,14 @@
 static int _usdr_device_vfs_get_by_path(device_t *base, const char* fullpath, pusdr_vfs_obj_t *obj);
 int usdr_device_base_create(pdevice_t dev, lldev_t lldev)
 {
+    pthread_mutexattr_t attr;
+
+    // Notify callbacks may issue nested control calls
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&dev->ctrl_mtx, &attr);
+    pthread_mutexattr_destroy(&attr);
+
     dev->dev = lldev;
     dev->initialize = NULL;
     dev->destroy = NULL;
@@ -27,6 +35,7 @@ int usdr_device_base_create(pdevice_t dev, lldev_t lldev)
 int usdr_device_base_destroy(pdevice_t dev)
 {
     vfs_folder_destroy(&dev->rootfs);
+    pthread_mutex_destroy(&dev->ctrl_mtx);
     return 0;
 }
 
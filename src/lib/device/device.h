@@ -6,6 +6,7 @@
 
 #include <usdr_port.h>
 #include <usdr_lowlevel.h>
+#include <pthread.h>
 
 #include "device_vfs.h"
 
@@ -35,6 +36,7 @@ struct device {
     lldev_t dev;              ///< Underlying lowlevel device
 
     vfs_object_t rootfs;      ///< All
+    pthread_mutex_t ctrl_mtx; ///< Serializes VFS control calls of all callers (recursive)
 
     int (*initialize)(device_t *udev, unsigned pcount, const char** devparam, const char** devval);
     void (*destroy)(device_t *udev);
@@ -70,6 +72,17 @@ struct device_factory_ops {
 int usdr_device_base_create(pdevice_t dev, lldev_t lldev);
 int usdr_device_base_destroy(pdevice_t dev);
 
+// Control calls may come from the application and the broker thread
+static inline void usdr_device_ctrl_lock(pdevice_t dev)
+{
+    pthread_mutex_lock(&dev->ctrl_mtx);
+}
+
+static inline void usdr_device_ctrl_unlock(pdevice_t dev)
+{
+    pthread_mutex_unlock(&dev->ctrl_mtx);
+}
+
 
 int usdr_device_create(lldev_t dev, device_id_t devid);
 int usdr_device_destroy(pdevice_t udev);
@@ -0,0 +1,806 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "device_broker.h"
+#include "../ipblks/streams/streams_api.h"
+#include "../ipblks/streams/stream_shm.h"
+
+#include <usdr_logging.h>
+
+enum {
+    BROKER_STR_MAX = 256,
+    BROKER_PUMP_TIMEOUT_MS = 100,
+    BROKER_REPLY_TIMEOUT_MS = 5000,
+};
+
+enum broker_op {
+    BROKER_HELLO,
+    BROKER_LOOKUP,
+    BROKER_GET,
+    BROKER_SET,
+    BROKER_GET_STR,
+    BROKER_SET_STR,
+    BROKER_STREAM,
+};
+
+// Every request is answered with the same message, SOCK_SEQPACKET keeps boundaries.
+// The owner echoes @p seq back, so replies arriving after a client timeout
+// are told apart from the answer to the next request.
+struct broker_msg {
+    uint32_t op;
+    int32_t res;
+    uint32_t seq;
+    uint32_t _reserved;
+    uint64_t value;
+    char path[VFS_MAX_PATH];
+    char str[BROKER_STR_MAX];
+};
+
+struct broker_pub {
+    char sid[VFS_MAX_PATH];
+    char shm_name[STREAM_SHM_NAME_MAX];
+
+    stream_handle_t* reader;
+    stream_shm_producer_t* ring;
+    unsigned pktsyms;
+    unsigned wire_bytes;
+
+    pthread_t thread;
+    volatile bool stop;
+};
+
+struct device_broker {
+    device_t* dev;
+    char name[40];
+
+    int lfd;
+    int wake[2];
+    pthread_t thread;
+
+    int cfd[BROKER_MAX_CLIENTS];
+    unsigned ccnt;
+
+    pthread_mutex_t mtx;
+    unsigned pcnt;
+    struct broker_pub pubs[BROKER_MAX_STREAMS];
+};
+
+static socklen_t _broker_addr(const char* name, struct sockaddr_un* addr)
+{
+    int len;
+
+    // Abstract namespace, nothing to clean up after a crash
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    len = snprintf(addr->sun_path + 1, sizeof(addr->sun_path) - 1, "usdr-broker-%s", name);
+    return offsetof(struct sockaddr_un, sun_path) + 1 + len;
+}
+
+// Abstract sockets have no file permissions, only the owner's user is let in
+static int _broker_check_peer(int fd)
+{
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len))
+        return -errno;
+    if (cred.uid != geteuid()) {
+        USDR_LOG("BRKR", USDR_LOG_WARNING, "Client pid %d uid %d rejected, broker runs as uid %d\n",
+                 (int)cred.pid, (int)cred.uid, (int)geteuid());
+        return -EPERM;
+    }
+    return 0;
+}
+
+static void* _broker_pump_thread(void* param)
+{
+    struct broker_pub* p = (struct broker_pub*)param;
+    struct usdr_dms_recv_nfo nfo;
+    void* wire;
+    int res;
+
+    while (!p->stop) {
+        res = p->reader->ops->recv_raw(p->reader, &wire, BROKER_PUMP_TIMEOUT_MS, &nfo);
+        if (res == -ETIMEDOUT)
+            continue;
+        if (res) {
+            USDR_LOG("BRKR", USDR_LOG_ERROR, "Stream `%s` receive failed, error %d, publishing stopped\n",
+                     p->sid, res);
+            break;
+        }
+
+        // The only copy on the way to all clients
+        unsigned bytes = (uint64_t)nfo.totsyms * p->wire_bytes / p->pktsyms;
+        if (bytes > p->wire_bytes) {
+            USDR_LOG("BRKR", USDR_LOG_ERROR, "Stream `%s` packet grew to %d bytes, publishing stopped\n",
+                     p->sid, bytes);
+            p->reader->ops->release_raw(p->reader, wire);
+            break;
+        }
+
+        memcpy(stream_shm_producer_slot(p->ring), wire, bytes);
+        p->reader->ops->release_raw(p->reader, wire);
+        stream_shm_producer_commit(p->ring, &nfo);
+    }
+
+    return NULL;
+}
+
+static void _broker_serve(device_broker_t* b, struct broker_msg* m)
+{
+    device_t* dev = b->dev;
+    pusdr_vfs_obj_t obj;
+    const char* str;
+    int res = 0;
+
+    m->path[sizeof(m->path) - 1] = 0;
+    m->str[sizeof(m->str) - 1] = 0;
+
+    // Same lock as the owner's own control calls
+    if (m->op >= BROKER_LOOKUP && m->op <= BROKER_SET_STR) {
+        usdr_device_ctrl_lock(dev);
+        res = dev->vfs_get_single_object(dev, m->path, &obj);
+        if (res)
+            goto done;
+    }
+
+    switch (m->op) {
+    case BROKER_HELLO:
+        m->value = getpid();
+        memset(m->str, 0, sizeof(m->str));
+        if (lowlevel_get_uuid(dev->dev))
+            memcpy(m->str, lowlevel_get_uuid(dev->dev), sizeof(device_id_t));
+        strncpy(m->path, lowlevel_get_devname(dev->dev), sizeof(m->path) - 1);
+        break;
+    case BROKER_LOOKUP:
+        break;
+    case BROKER_GET:
+        res = usdr_device_vfs_obj_val_get(dev, obj, &m->value);
+        break;
+    case BROKER_SET:
+        res = usdr_device_vfs_obj_val_set(dev, obj, m->value);
+        break;
+    case BROKER_GET_STR:
+        // Integer objects never hold a pointer valid for the broker
+        if (obj->type != VFST_STR || obj->ops.gstr == NULL) {
+            res = -EINVAL;
+            break;
+        }
+        res = obj->ops.gstr(obj, 0, NULL);
+        str = obj->data.str;
+        if (res == 0)
+            snprintf(m->str, sizeof(m->str), "%s", str ? str : "");
+        break;
+    case BROKER_SET_STR:
+        if (obj->type != VFST_STR || obj->ops.sstr == NULL) {
+            res = -EINVAL;
+            break;
+        }
+        res = obj->ops.sstr(obj, m->str);
+        break;
+    case BROKER_STREAM:
+        res = -ENOENT;
+        pthread_mutex_lock(&b->mtx);
+        for (unsigned i = 0; i < b->pcnt; i++) {
+            if (strcmp(b->pubs[i].sid, m->path) == 0) {
+                strncpy(m->str, b->pubs[i].shm_name, sizeof(m->str) - 1);
+                res = 0;
+                break;
+            }
+        }
+        pthread_mutex_unlock(&b->mtx);
+        break;
+    default:
+        res = -EINVAL;
+    }
+
+done:
+    if (m->op >= BROKER_LOOKUP && m->op <= BROKER_SET_STR)
+        usdr_device_ctrl_unlock(dev);
+
+    USDR_LOG("BRKR", USDR_LOG_DEBUG, "Request %d `%s` => %d\n", m->op, m->path, res);
+    m->res = res;
+}
+
+static void* _broker_thread(void* param)
+{
+    device_broker_t* b = (device_broker_t*)param;
+    struct pollfd pfd[2 + BROKER_MAX_CLIENTS];
+    struct broker_msg m;
+
+    for (;;) {
+        pfd[0].fd = b->wake[0];
+        pfd[0].events = POLLIN;
+        pfd[1].fd = b->lfd;
+        pfd[1].events = POLLIN;
+        for (unsigned i = 0; i < b->ccnt; i++) {
+            pfd[2 + i].fd = b->cfd[i];
+            pfd[2 + i].events = POLLIN;
+        }
+
+        if (poll(pfd, 2 + b->ccnt, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        if (pfd[0].revents)
+            break;
+
+        // Clients first, accepting may reorder the array
+        for (unsigned i = b->ccnt; i > 0; i--) {
+            short ev = pfd[1 + i].revents;
+            ssize_t sz = 0;
+            if (ev == 0)
+                continue;
+
+            if (ev & POLLIN) {
+                sz = recv(b->cfd[i - 1], &m, sizeof(m), 0);
+                if (sz == sizeof(m)) {
+                    _broker_serve(b, &m);
+                    if (send(b->cfd[i - 1], &m, sizeof(m), MSG_NOSIGNAL) == sizeof(m))
+                        continue;
+                }
+            }
+
+            USDR_LOG("BRKR", USDR_LOG_INFO, "Client %d disconnected\n", b->cfd[i - 1]);
+            close(b->cfd[i - 1]);
+            b->cfd[i - 1] = b->cfd[--b->ccnt];
+        }
+
+        if (pfd[1].revents & POLLIN) {
+            int fd = accept(b->lfd, NULL, NULL);
+            if (fd < 0)
+                continue;
+
+            if (_broker_check_peer(fd)) {
+                close(fd);
+                continue;
+            }
+
+            if (b->ccnt == BROKER_MAX_CLIENTS) {
+                USDR_LOG("BRKR", USDR_LOG_WARNING, "Too many clients, connection rejected\n");
+                close(fd);
+                continue;
+            }
+
+            USDR_LOG("BRKR", USDR_LOG_INFO, "Client %d connected\n", fd);
+            b->cfd[b->ccnt++] = fd;
+        }
+    }
+
+    return NULL;
+}
+
+int device_broker_create(device_t* dev, const char* name, device_broker_t** out)
+{
+    device_broker_t* b;
+    struct sockaddr_un addr;
+    socklen_t alen;
+    int res;
+
+    if (strlen(name) >= sizeof(b->name))
+        return -EINVAL;
+
+    b = (device_broker_t*)malloc(sizeof(device_broker_t));
+    if (b == NULL)
+        return -ENOMEM;
+
+    memset(b, 0, sizeof(*b));
+    b->dev = dev;
+    strncpy(b->name, name, sizeof(b->name) - 1);
+
+    b->lfd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (b->lfd < 0) {
+        res = -errno;
+        goto failed_free;
+    }
+
+    alen = _broker_addr(name, &addr);
+    if (bind(b->lfd, (struct sockaddr*)&addr, alen) || listen(b->lfd, BROKER_MAX_CLIENTS)) {
+        res = -errno;
+        USDR_LOG("BRKR", USDR_LOG_ERROR, "Unable to listen on broker `%s`, error %d\n", name, res);
+        goto failed_sock;
+    }
+
+    if (pipe(b->wake)) {
+        res = -errno;
+        goto failed_sock;
+    }
+
+    pthread_mutex_init(&b->mtx, NULL);
+
+    res = pthread_create(&b->thread, NULL, _broker_thread, b);
+    if (res) {
+        res = -res;
+        goto failed_pipe;
+    }
+
+    USDR_LOG("BRKR", USDR_LOG_INFO, "Broker `%s` is serving device %s\n",
+             name, lowlevel_get_devname(dev->dev));
+
+    *out = b;
+    return 0;
+
+failed_pipe:
+    pthread_mutex_destroy(&b->mtx);
+    close(b->wake[0]);
+    close(b->wake[1]);
+failed_sock:
+    close(b->lfd);
+failed_free:
+    free(b);
+    return res;
+}
+
+void device_broker_destroy(device_broker_t* b)
+{
+    char c = 0;
+
+    if (write(b->wake[1], &c, 1) == 1) {
+        pthread_join(b->thread, NULL);
+    }
+
+    for (unsigned i = 0; i < b->ccnt; i++) {
+        close(b->cfd[i]);
+    }
+    close(b->lfd);
+    close(b->wake[0]);
+    close(b->wake[1]);
+
+    for (unsigned i = 0; i < b->pcnt; i++) {
+        struct broker_pub* p = &b->pubs[i];
+
+        p->stop = true;
+        pthread_join(p->thread, NULL);
+
+        stream_fanout_detach(p->reader);
+        stream_shm_producer_destroy(p->ring);
+    }
+
+    pthread_mutex_destroy(&b->mtx);
+
+    USDR_LOG("BRKR", USDR_LOG_INFO, "Broker `%s` destroyed\n", b->name);
+    free(b);
+}
+
+int device_broker_publish(device_broker_t* b, const char* sid,
+                          stream_fanout_t* fan, unsigned depth)
+{
+    struct broker_pub* p;
+    usdr_dms_nfo_t nfo;
+    int64_t wfmt, wbytes;
+    int res;
+
+    if (depth == 0)
+        depth = BROKER_DEF_DEPTH;
+    if (strlen(sid) >= sizeof(p->sid))
+        return -EINVAL;
+
+    // The slot stays locked until it's either filled or given back
+    pthread_mutex_lock(&b->mtx);
+    for (unsigned i = 0; i < b->pcnt; i++) {
+        if (strcmp(b->pubs[i].sid, sid) == 0) {
+            res = -EEXIST;
+            goto failed_unlock;
+        }
+    }
+    if (b->pcnt == BROKER_MAX_STREAMS) {
+        res = -EBUSY;
+        goto failed_unlock;
+    }
+    p = &b->pubs[b->pcnt];
+    memset(p, 0, sizeof(*p));
+
+    strncpy(p->sid, sid, sizeof(p->sid) - 1);
+    snprintf(p->shm_name, sizeof(p->shm_name), "/usdr-%s-%u", b->name, b->pcnt);
+
+    res = stream_fanout_attach(fan, NULL, USDR_DMS_FANOUT_DROP_OLDEST, &p->reader);
+    if (res)
+        goto failed_unlock;
+
+    res = p->reader->ops->stat(p->reader, &nfo);
+    res = (res) ? res : p->reader->ops->option_get(p->reader, "wire_fmt", &wfmt);
+    res = (res) ? res : p->reader->ops->option_get(p->reader, "wire_bytes", &wbytes);
+    if (res)
+        goto failed_detach;
+
+    p->pktsyms = nfo.pktsyms;
+    p->wire_bytes = wbytes;
+
+    res = stream_shm_producer_create(p->shm_name, (const char*)(intptr_t)wfmt, nfo.channels,
+                                     p->pktsyms, p->wire_bytes, depth, &p->ring);
+    if (res)
+        goto failed_detach;
+
+    res = pthread_create(&p->thread, NULL, _broker_pump_thread, p);
+    if (res) {
+        res = -res;
+        goto failed_ring;
+    }
+
+    b->pcnt++;
+    pthread_mutex_unlock(&b->mtx);
+
+    USDR_LOG("BRKR", USDR_LOG_INFO, "Stream `%s` published as `%s`\n", sid, p->shm_name);
+    return 0;
+
+failed_ring:
+    stream_shm_producer_destroy(p->ring);
+failed_detach:
+    stream_fanout_detach(p->reader);
+failed_unlock:
+    pthread_mutex_unlock(&b->mtx);
+    return res;
+}
+
+
+// Client side
+
+struct broker_client;
+typedef struct broker_client broker_client_t;
+
+struct broker_obj {
+    vfs_object_t vfs;
+    broker_client_t* c;
+    char str[BROKER_STR_MAX];
+};
+typedef struct broker_obj broker_obj_t;
+
+struct broker_client {
+    lowlevel_dev_t lldev;
+    device_t dev;
+
+    int fd;
+    pthread_mutex_t mtx;
+    uint32_t seq;
+
+    char name[64 + VFS_MAX_PATH];
+    device_id_t uuid;
+
+    // Object cache, guarded by dev.ctrl_mtx
+    unsigned ocnt;
+    unsigned omax;
+    broker_obj_t** objs;
+};
+
+static int _broker_call(broker_client_t* c, struct broker_msg* m)
+{
+    uint32_t seq;
+    int res = 0;
+
+    pthread_mutex_lock(&c->mtx);
+    seq = m->seq = ++c->seq;
+    if (send(c->fd, m, sizeof(*m), MSG_NOSIGNAL) != sizeof(*m)) {
+        res = -EPIPE;
+    } else {
+        // Drop late replies to the requests which have already timed out
+        do {
+            ssize_t r = recv(c->fd, m, sizeof(*m), 0);
+            if (r != sizeof(*m)) {
+                // Zero means the owner has gone, errno isn't updated then
+                res = (r == 0) ? -ECONNRESET : (r > 0) ? -EPIPE :
+                      (errno == EAGAIN) ? -ETIMEDOUT : -EPIPE;
+                break;
+            }
+        } while (m->seq != seq);
+    }
+    pthread_mutex_unlock(&c->mtx);
+
+    if (res) {
+        USDR_LOG("BRKR", USDR_LOG_ERROR, "Broker `%s` request failed, error %d\n", c->name, res);
+        return res;
+    }
+    return m->res;
+}
+
+static int _broker_obj_req(vfs_object_t* obj, unsigned op, struct broker_msg* m)
+{
+    broker_obj_t* bo = (broker_obj_t*)obj;
+
+    m->op = op;
+    memcpy(m->path, obj->full_path, sizeof(m->path));
+    m->path[sizeof(m->path) - 1] = 0;
+    return _broker_call(bo->c, m);
+}
+
+static int _broker_obj_set(vfs_object_t* obj, uint64_t value)
+{
+    struct broker_msg m = { .value = value };
+    return _broker_obj_req(obj, BROKER_SET, &m);
+}
+
+static int _broker_obj_get(vfs_object_t* obj, uint64_t* ovalue)
+{
+    struct broker_msg m = { .value = 0 };
+    int res = _broker_obj_req(obj, BROKER_GET, &m);
+    if (res == 0)
+        *ovalue = m.value;
+    return res;
+}
+
+static int _broker_obj_set_str(vfs_object_t* obj, const char* str)
+{
+    struct broker_msg m = { .value = 0 };
+    if (strlen(str) >= sizeof(m.str))
+        return -EINVAL;
+
+    strncpy(m.str, str, sizeof(m.str) - 1);
+    return _broker_obj_req(obj, BROKER_SET_STR, &m);
+}
+
+static int _broker_obj_get_str(vfs_object_t* obj, unsigned max_str, char* stor)
+{
+    broker_obj_t* bo = (broker_obj_t*)obj;
+    struct broker_msg m = { .value = 0 };
+    int res = _broker_obj_req(obj, BROKER_GET_STR, &m);
+    if (res)
+        return res;
+
+    if (stor == NULL) {
+        memcpy(bo->str, m.str, sizeof(bo->str));
+        bo->str[sizeof(bo->str) - 1] = 0;
+        obj->data.str = bo->str;
+    } else if (max_str) {
+        strncpy(stor, m.str, max_str - 1);
+        stor[max_str - 1] = 0;
+    }
+    return 0;
+}
+
+static int _broker_lookup_obj(broker_client_t* c, const char* fullpath, pusdr_vfs_obj_t* out)
+{
+    struct broker_msg m = { .op = BROKER_LOOKUP };
+    broker_obj_t* bo;
+    int res;
+
+    for (unsigned i = 0; i < c->ocnt; i++) {
+        if (strcmp(c->objs[i]->vfs.full_path, fullpath) == 0) {
+            *out = &c->objs[i]->vfs;
+            return 0;
+        }
+    }
+
+    if (strlen(fullpath) >= VFS_MAX_PATH)
+        return -EINVAL;
+
+    strncpy(m.path, fullpath, sizeof(m.path) - 1);
+    res = _broker_call(c, &m);
+    if (res)
+        return res;
+
+    if (c->ocnt == c->omax) {
+        unsigned nmax = c->omax ? 2 * c->omax : 16;
+        broker_obj_t** n = (broker_obj_t**)realloc(c->objs, nmax * sizeof(broker_obj_t*));
+        if (n == NULL)
+            return -ENOMEM;
+
+        c->objs = n;
+        c->omax = nmax;
+    }
+
+    bo = (broker_obj_t*)malloc(sizeof(broker_obj_t));
+    if (bo == NULL)
+        return -ENOMEM;
+
+    memset(bo, 0, sizeof(*bo));
+    bo->c = c;
+    // Both integers and strings are forwarded, the owner checks the real type
+    bo->vfs.type = VFST_STR;
+    bo->vfs.object = c;
+    bo->vfs.ops.si64 = &_broker_obj_set;
+    bo->vfs.ops.gi64 = &_broker_obj_get;
+    bo->vfs.ops.sstr = &_broker_obj_set_str;
+    bo->vfs.ops.gstr = &_broker_obj_get_str;
+    bo->vfs.data.str = bo->str;
+    strncpy(bo->vfs.full_path, fullpath, sizeof(bo->vfs.full_path) - 1);
+
+    c->objs[c->ocnt++] = bo;
+    *out = &bo->vfs;
+    return 0;
+}
+
+static int _broker_get_obj(device_t* dev, const char* fullpath, pusdr_vfs_obj_t* out)
+{
+    broker_client_t* c = container_of(dev, broker_client_t, dev);
+    int res;
+
+    usdr_device_ctrl_lock(dev);
+    res = _broker_lookup_obj(c, fullpath, out);
+    usdr_device_ctrl_unlock(dev);
+    return res;
+}
+
+static int _broker_vfs_filter(device_t* UNUSED dev, const char* UNUSED filter,
+                              unsigned UNUSED max_objects, vfs_filter_obj_t* UNUSED objs)
+{
+    return -EOPNOTSUPP;
+}
+
+static int _broker_create_stream(device_t* dev, const char* sid, const char* dformat,
+                                 uint64_t UNUSED channels, unsigned UNUSED pktsyms,
+                                 unsigned UNUSED flags, stream_handle_t** out_handle)
+{
+    broker_client_t* c = container_of(dev, broker_client_t, dev);
+    struct broker_msg m = { .op = BROKER_STREAM };
+    char host_fmt[32] = { 0 };
+    int res;
+
+    // Channels and packet size are defined by the owner
+    if (strlen(sid) >= sizeof(m.path))
+        return -EINVAL;
+
+    strncpy(m.path, sid, sizeof(m.path) - 1);
+    res = _broker_call(c, &m);
+    if (res) {
+        USDR_LOG("BRKR", USDR_LOG_ERROR, "Stream `%s` isn't published by `%s`, error %d\n",
+                 sid, c->name, res);
+        return res;
+    }
+
+    if (dformat) {
+        for (unsigned i = 0; i < sizeof(host_fmt) - 1 && dformat[i] && dformat[i] != '@'; i++) {
+            host_fmt[i] = dformat[i];
+        }
+    }
+
+    return stream_shm_attach(dev, m.str, host_fmt[0] ? host_fmt : NULL, out_handle);
+}
+
+static int _broker_unregister_stream(device_t* UNUSED dev, stream_handle_t* stream)
+{
+    return stream->ops->destroy(stream);
+}
+
+static int _broker_timer_op(device_t* UNUSED dev, stream_handle_t** UNUSED pstreams,
+                            unsigned UNUSED stream_count, const char* UNUSED sync_op)
+{
+    // Streams are started by the owner
+    return -ENOTSUP;
+}
+
+static void _broker_dev_destroy(device_t* dev)
+{
+    usdr_device_base_destroy(dev);
+}
+
+static
+int broker_generic_get(lldev_t dev, int generic_op, const char** pout)
+{
+    broker_client_t* c = container_of(dev, broker_client_t, lldev);
+
+    switch (generic_op) {
+    case LLGO_DEVICE_NAME: *pout = c->name; return 0;
+    case LLGO_DEVICE_UUID: *pout = (const char*)c->uuid.d; return 0;
+    }
+
+    return -EINVAL;
+}
+
+static
+int broker_ls_op(lldev_t UNUSED dev, subdev_t UNUSED subdev,
+                 unsigned UNUSED ls_op, lsopaddr_t UNUSED ls_op_addr,
+                 size_t UNUSED meminsz, void* UNUSED pin,
+                 size_t UNUSED memoutsz, const void* UNUSED pout)
+{
+    // Raw hardware access stays with the owner
+    return -EOPNOTSUPP;
+}
+
+static
+int broker_generic_destroy(lldev_t dev)
+{
+    broker_client_t* c = container_of(dev, broker_client_t, lldev);
+
+    if (dev->pdev) {
+        dev->pdev->destroy(dev->pdev);
+    }
+
+    close(c->fd);
+    for (unsigned i = 0; i < c->ocnt; i++) {
+        free(c->objs[i]);
+    }
+    free(c->objs);
+    pthread_mutex_destroy(&c->mtx);
+
+    USDR_LOG("BRKR", USDR_LOG_INFO, "Disconnected from %s\n", c->name);
+    free(c);
+    return 0;
+}
+
+static
+struct lowlevel_ops s_broker_ops = {
+    broker_generic_get,
+    broker_ls_op,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    broker_generic_destroy,
+};
+
+int device_broker_connect(const char* name, lldev_t* odev)
+{
+    broker_client_t* c;
+    struct sockaddr_un addr;
+    struct timeval tv = { BROKER_REPLY_TIMEOUT_MS / 1000, 0 };
+    struct broker_msg m = { .op = BROKER_HELLO };
+    socklen_t alen;
+    int res;
+
+    c = (broker_client_t*)malloc(sizeof(broker_client_t));
+    if (c == NULL)
+        return -ENOMEM;
+
+    memset(c, 0, sizeof(*c));
+    c->fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (c->fd < 0) {
+        res = -errno;
+        goto failed_free;
+    }
+
+    alen = _broker_addr(name, &addr);
+    if (connect(c->fd, (struct sockaddr*)&addr, alen)) {
+        res = -errno;
+        USDR_LOG("BRKR", USDR_LOG_ERROR, "Unable to connect to broker `%s`, error %d\n", name, res);
+        goto failed_sock;
+    }
+    setsockopt(c->fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    pthread_mutex_init(&c->mtx, NULL);
+    snprintf(c->name, sizeof(c->name), "broker:%s", name);
+
+    res = _broker_call(c, &m);
+    if (res)
+        goto failed_mtx;
+
+    memcpy(c->uuid.d, m.str, sizeof(c->uuid.d));
+    m.path[sizeof(m.path) - 1] = 0;
+    snprintf(c->name, sizeof(c->name), "broker:%s:%s", name, m.path);
+
+    c->lldev.ops = &s_broker_ops;
+    res = usdr_device_base_create(&c->dev, &c->lldev);
+    if (res)
+        goto failed_mtx;
+
+    c->lldev.pdev = &c->dev;
+    c->dev.destroy = &_broker_dev_destroy;
+    c->dev.create_stream = &_broker_create_stream;
+    c->dev.unregister_stream = &_broker_unregister_stream;
+    c->dev.timer_op = &_broker_timer_op;
+    c->dev.vfs_get_single_object = &_broker_get_obj;
+    c->dev.vfs_filter = &_broker_vfs_filter;
+
+    USDR_LOG("BRKR", USDR_LOG_INFO, "Connected to %s, owner pid %d\n",
+             c->name, (int)m.value);
+
+    *odev = &c->lldev;
+    return 0;
+
+failed_mtx:
+    pthread_mutex_destroy(&c->mtx);
+failed_sock:
+    close(c->fd);
+failed_free:
+    free(c);
+    return res;
+}
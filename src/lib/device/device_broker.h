@@ -0,0 +1,46 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef DEVICE_BROKER_H
+#define DEVICE_BROKER_H
+
+#include "device.h"
+#include "../ipblks/streams/stream_fanout.h"
+
+// Sharing of a device between processes.
+//
+// The owner process runs the broker: control requests of other processes
+// arrive on a Unix socket and are executed on the owner's device, published
+// RX streams are copied once into shared memory rings (see stream_shm.h).
+// Other processes open `broker=<name>` and get a proxy device, where every
+// VFS get/set is forwarded to the owner and RX streams are read directly
+// from the shared memory.
+//
+// Only processes running as the owner's user are accepted, as the socket
+// gives access to every VFS path including raw register writes.
+//
+// Forwarded requests run on the broker thread under the device control lock
+// (usdr_device_ctrl_lock), the same one taken by the usdr_dme_* calls of the
+// owner. Proxy devices may be shared by several threads of a client.
+
+enum {
+    BROKER_MAX_CLIENTS = 16,
+    BROKER_MAX_STREAMS = 8,
+    BROKER_DEF_DEPTH = 32,
+};
+
+struct device_broker;
+typedef struct device_broker device_broker_t;
+
+int device_broker_create(device_t* dev, const char* name, device_broker_t** out);
+void device_broker_destroy(device_broker_t* b);
+
+// Export RX stream fan-out as @p sid, the broker attaches its own wire format
+// reader which drops the oldest packets and never holds the owner back
+int device_broker_publish(device_broker_t* b, const char* sid,
+                          stream_fanout_t* fan, unsigned depth);
+
+// Client side, creates proxy lowlevel device connected to the broker
+int device_broker_connect(const char* name, lldev_t* odev);
+
+#endif
@@ -35,6 +35,13 @@ static int _debug_typefe_reg_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* ov
 
 static int _debug_ll_mdev_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
 
+static int _gps_time_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* ovalue);
+static int _gps_fix_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* ovalue);
+static int _gps_sats_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* ovalue);
+static int _gps_nmea_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* ovalue);
+static int _gps_pps_settime_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int _gps_pps_settime_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* ovalue);
+
 static
 const usdr_dev_param_func_t s_fe_params[] = {
     { "/ll/fe/type",            { NULL, _debug_typefe_reg_get }},
@@ -47,6 +54,15 @@ const usdr_dev_param_func_t s_fe_pcie_params[] = {
     { "/debug/hw/pciefe_cmd/0/reg", { _debug_pciefe_cmd_set, _debug_pciefe_cmd_get }},
 };
 
+static
+const usdr_dev_param_func_t s_gps_params[] = {
+    { "/dm/gps/time",           { NULL, _gps_time_get }},
+    { "/dm/gps/fix",            { NULL, _gps_fix_get }},
+    { "/dm/gps/sats",           { NULL, _gps_sats_get }},
+    { "/dm/gps/nmea",           { NULL, _gps_nmea_get }},
+    { "/dm/gps/pps_settime",    { _gps_pps_settime_set, _gps_pps_settime_get }},
+};
+
 static
 const usdr_dev_param_func_t s_lmk05318_params[] = {
     { "/debug/hw/lmk05318/0/reg", { _debug_lmk05318_reg_set, _debug_lmk05318_reg_get }},
@@ -102,6 +118,8 @@ struct dev_fe {
     uint32_t debug_ext_fe_100_5000_cmd_last;
     uint32_t debug_lmk05318_last;
     uint32_t debug_lmk5c33216_last;
+
+    char gps_last[NMEA_MAX_LINE];
 };
 typedef struct dev_fe dev_fe_t;
 
@@ -215,6 +233,12 @@ int device_fe_probe(device_t* base, const char* compat, const char* fename, unsi
                                                   (void*)n,
                                                   s_fe_pcie_params,
                                                   SIZEOF_ARRAY(s_fe_pcie_params));
+        if (res == 0 && n->fe.devboard.gps) {
+            res = usdr_vfs_obj_param_init_array_param(base,
+                                                      (void*)n,
+                                                      s_gps_params,
+                                                      SIZEOF_ARRAY(s_gps_params));
+        }
         break;
     case FET_PCIE_SIMPLE_SYNC:
         res = usdr_vfs_obj_param_init_array_param(base,
@@ -261,6 +285,9 @@ int _debug_typefe_reg_get(pdevice_t ud_x, pusdr_vfs_obj_t obj, uint64_t* ovalue)
 int device_fe_destroy(struct dev_fe* obj)
 {
     //TODO deinit
+    if (obj->type == FET_PCIE_DEVBOARD) {
+        board_ext_pciefe_destroy(&obj->fe.devboard);
+    }
 
     free(obj);
     return 0;
@@ -440,3 +467,96 @@ int _debug_lmk5c33216_reg_set(pdevice_t ud_x, pusdr_vfs_obj_t obj, uint64_t valu
     return res;
 }
 
+
+static device_gps_t* _gps_get_obj(pusdr_vfs_obj_t obj, nmea_state_t* st)
+{
+    dev_fe_t* o = (dev_fe_t*)obj->object;
+    device_gps_t* gps = o->fe.devboard.gps;
+
+    if (o->type != FET_PCIE_DEVBOARD || gps == NULL)
+        return NULL;
+
+    return (device_gps_get(gps, st) == 0) ? gps : NULL;
+}
+
+int _gps_time_get(pdevice_t ud_x, pusdr_vfs_obj_t obj, uint64_t* ovalue)
+{
+    nmea_state_t st;
+    int64_t sec;
+    int res;
+
+    if (_gps_get_obj(obj, &st) == NULL)
+        return -EIO;
+
+    res = nmea_unix_time(&st, &sec);
+    if (res)
+        return res;
+
+    *ovalue = sec;
+    return 0;
+}
+
+int _gps_fix_get(pdevice_t ud_x, pusdr_vfs_obj_t obj, uint64_t* ovalue)
+{
+    nmea_state_t st;
+
+    if (_gps_get_obj(obj, &st) == NULL)
+        return -EIO;
+
+    *ovalue = st.valid ? st.fix : 0;
+    return 0;
+}
+
+int _gps_sats_get(pdevice_t ud_x, pusdr_vfs_obj_t obj, uint64_t* ovalue)
+{
+    nmea_state_t st;
+
+    if (_gps_get_obj(obj, &st) == NULL)
+        return -EIO;
+
+    *ovalue = st.sats;
+    return 0;
+}
+
+int _gps_nmea_get(pdevice_t ud_x, pusdr_vfs_obj_t obj, uint64_t* ovalue)
+{
+    dev_fe_t* o = (dev_fe_t*)obj->object;
+    nmea_state_t st;
+
+    if (_gps_get_obj(obj, &st) == NULL)
+        return -EIO;
+
+    memcpy(o->gps_last, st.last, sizeof(o->gps_last));
+    *ovalue = (uintptr_t)o->gps_last;
+    return 0;
+}
+
+// value is timeout in ms, 0 for default
+int _gps_pps_settime_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
+{
+    dev_fe_t* o = (dev_fe_t*)obj->object;
+    nmea_state_t st;
+
+    if (_gps_get_obj(obj, &st) == NULL)
+        return -EIO;
+
+    return device_gps_pps_settime(o->fe.devboard.gps, ud, value ? value : 2500, NULL);
+}
+
+int _gps_pps_settime_get(pdevice_t ud_x, pusdr_vfs_obj_t obj, uint64_t* ovalue)
+{
+    dev_fe_t* o = (dev_fe_t*)obj->object;
+    nmea_state_t st;
+    int64_t epoch;
+    int res;
+
+    if (_gps_get_obj(obj, &st) == NULL)
+        return -EIO;
+
+    res = device_gps_pps_epoch(o->fe.devboard.gps, &epoch);
+    if (res)
+        return res;
+
+    *ovalue = epoch;
+    return 0;
+}
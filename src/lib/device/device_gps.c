@@ -0,0 +1,213 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include "device_gps.h"
+#include "../ipblks/uart.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <usdr_logging.h>
+
+enum {
+    // FPGA RX FIFO is 31 bytes deep, at 9600 bod it fills up in ~32ms
+    GPS_POLL_US = 10000,
+    GPS_RX_CHUNK = 64,
+};
+
+struct device_gps {
+    uart_core_t uart;
+
+    pthread_t thread;
+    pthread_mutex_t mtx;
+    pthread_cond_t cond;
+    bool stop;
+    int error;
+
+    nmea_state_t nmea;
+
+    bool epoch_valid;
+    int64_t epoch;
+};
+
+static void* _device_gps_thread(void* param)
+{
+    device_gps_t* gps = (device_gps_t*)param;
+    char buf[GPS_RX_CHUNK];
+    int res = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&gps->mtx);
+        if (gps->stop) {
+            pthread_mutex_unlock(&gps->mtx);
+            break;
+        }
+        pthread_mutex_unlock(&gps->mtx);
+
+        // Drain everything available, FIFO may hold more than one chunk
+        do {
+            res = uart_core_rx_get(&gps->uart, sizeof(buf), buf);
+            if (res <= 0)
+                break;
+
+            pthread_mutex_lock(&gps->mtx);
+            if (nmea_feed(&gps->nmea, buf, res)) {
+                pthread_cond_broadcast(&gps->cond);
+            }
+            pthread_mutex_unlock(&gps->mtx);
+        } while (res == sizeof(buf));
+
+        if (res < 0) {
+            USDR_LOG("GNSS", USDR_LOG_ERROR, "UART read failed, error %d, reader stopped\n", res);
+
+            pthread_mutex_lock(&gps->mtx);
+            gps->error = res;
+            pthread_cond_broadcast(&gps->cond);
+            pthread_mutex_unlock(&gps->mtx);
+            break;
+        }
+
+        usleep(GPS_POLL_US);
+    }
+
+    return NULL;
+}
+
+int device_gps_create(lldev_t dev, subdev_t subdev, unsigned uart_base,
+                      device_gps_t** out)
+{
+    device_gps_t* gps;
+    int res;
+
+    gps = (device_gps_t*)malloc(sizeof(device_gps_t));
+    if (gps == NULL)
+        return -ENOMEM;
+
+    memset(gps, 0, sizeof(*gps));
+    nmea_init(&gps->nmea);
+
+    res = uart_core_init(dev, subdev, uart_base, &gps->uart);
+    if (res)
+        goto failed_free;
+
+    pthread_mutex_init(&gps->mtx, NULL);
+    pthread_cond_init(&gps->cond, NULL);
+
+    res = pthread_create(&gps->thread, NULL, _device_gps_thread, gps);
+    if (res) {
+        res = -res;
+        goto failed_sync;
+    }
+
+    *out = gps;
+    return 0;
+
+failed_sync:
+    pthread_cond_destroy(&gps->cond);
+    pthread_mutex_destroy(&gps->mtx);
+failed_free:
+    free(gps);
+    return res;
+}
+
+void device_gps_destroy(device_gps_t* gps)
+{
+    if (gps == NULL)
+        return;
+
+    pthread_mutex_lock(&gps->mtx);
+    gps->stop = true;
+    pthread_mutex_unlock(&gps->mtx);
+
+    pthread_join(gps->thread, NULL);
+
+    USDR_LOG("GNSS", USDR_LOG_INFO, "GPS reader stopped, %u sentences, %u errors\n",
+             gps->nmea.sentences, gps->nmea.errors);
+
+    pthread_cond_destroy(&gps->cond);
+    pthread_mutex_destroy(&gps->mtx);
+    free(gps);
+}
+
+int device_gps_get(device_gps_t* gps, nmea_state_t* st)
+{
+    int res;
+
+    pthread_mutex_lock(&gps->mtx);
+    *st = gps->nmea;
+    res = gps->error;
+    pthread_mutex_unlock(&gps->mtx);
+
+    return (res) ? -EIO : 0;
+}
+
+int device_gps_pps_settime(device_gps_t* gps, device_t* dev,
+                           unsigned timeout_ms, int64_t* epoch)
+{
+    struct timespec deadline;
+    unsigned seq;
+    int64_t sec;
+    int res = 0;
+
+    if (dev->timer_op == NULL)
+        return -ENOTSUP;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    // Catch the first sentence of the burst, so there's almost a whole
+    // second left to arm the timer before the next edge
+    pthread_mutex_lock(&gps->mtx);
+    seq = gps->nmea.seq;
+    while (gps->nmea.seq == seq && gps->error == 0 && res == 0) {
+        res = pthread_cond_timedwait(&gps->cond, &gps->mtx, &deadline);
+    }
+    if (res == 0 && gps->error)
+        res = -EIO;
+    else if (res)
+        res = -ETIMEDOUT;
+    else if (!gps->nmea.valid && gps->nmea.fix == 0)
+        res = -EAGAIN;
+    else
+        res = nmea_unix_time(&gps->nmea, &sec);
+    pthread_mutex_unlock(&gps->mtx);
+
+    if (res)
+        return res;
+
+    res = dev->timer_op(dev, NULL, 0, "1pps");
+    if (res)
+        return res;
+
+    pthread_mutex_lock(&gps->mtx);
+    gps->epoch = sec + 1;
+    gps->epoch_valid = true;
+    pthread_mutex_unlock(&gps->mtx);
+
+    USDR_LOG("GNSS", USDR_LOG_INFO, "Timer armed on 1PPS, edge at %lld UTC\n",
+             (long long)(sec + 1));
+
+    if (epoch)
+        *epoch = sec + 1;
+    return 0;
+}
+
+int device_gps_pps_epoch(device_gps_t* gps, int64_t* epoch)
+{
+    int res = -EAGAIN;
+
+    pthread_mutex_lock(&gps->mtx);
+    if (gps->epoch_valid) {
+        *epoch = gps->epoch;
+        res = 0;
+    }
+    pthread_mutex_unlock(&gps->mtx);
+    return res;
+}
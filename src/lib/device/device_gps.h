@@ -0,0 +1,34 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef DEVICE_GPS_H
+#define DEVICE_GPS_H
+
+#include "device.h"
+#include "../common/nmea.h"
+
+// Background reader of GPS module attached to the FPGA UART core. UART FIFO
+// is drained on a timer and NMEA sentences are parsed on the fly, so the
+// device initialization doesn't wait for the module.
+
+struct device_gps;
+typedef struct device_gps device_gps_t;
+
+int device_gps_create(lldev_t dev, subdev_t subdev, unsigned uart_base,
+                      device_gps_t** out);
+void device_gps_destroy(device_gps_t* gps);
+
+// Snapshot of the parsed state, -EIO if the reader has stopped on error
+int device_gps_get(device_gps_t* gps, nmea_state_t* st);
+
+// Pair GPS time of day with the next 1PPS edge: waits for a fresh time
+// sentence (modules report second N shortly after its PPS edge), then arms
+// the device timer on 1PPS, so sample counter 0 corresponds to N + 1.
+// Returns UTC second of the armed edge in @p epoch.
+int device_gps_pps_settime(device_gps_t* gps, device_t* dev,
+                           unsigned timeout_ms, int64_t* epoch);
+
+// UTC second of the last armed edge, -EAGAIN if time was never set
+int device_gps_pps_epoch(device_gps_t* gps, int64_t* epoch);
+
+#endif
@@ -33,6 +33,7 @@ typedef int (*vfs_set_i64_func_t)(vfs_object_t* obj, uint64_t value);
 typedef int (*vfs_get_i64_func_t)(vfs_object_t* obj, uint64_t* ovalue);
 
 typedef int (*vfs_set_str_func_t)(vfs_object_t* obj, const char* str);
+// VFST_STR objects accept NULL @p stor and leave the string in obj->data.str
 typedef int (*vfs_get_str_func_t)(vfs_object_t* obj, unsigned max_str, char* stor);
 
 typedef int (*vfs_set_ai64_func_t)(vfs_object_t* obj, unsigned count, const uint64_t* value);
@@ -6,7 +6,6 @@
 #include <usdr_logging.h>
 
 #include "../ipblks/gpio.h"
-#include "../ipblks/uart.h"
 #include "../hw/dac80501/dac80501.h"
 #include "../common/parse_params.h"
 
@@ -78,22 +77,12 @@ int board_ext_pciefe_updpwr(board_ext_pciefe_t* ob);
 int board_ext_pciefe_updfe(board_ext_pciefe_t* ob);
 
 
-static int tca6416_reg_wr(lldev_t dev, subdev_t subdev, lsopaddr_t ls_op_addr,
-                   uint8_t reg, uint8_t out)
+static int tca6416_reg_q(struct lowlevel_i2c_queue* q, lsopaddr_t ls_op_addr,
+                         unsigned cnt, uint8_t reg, uint16_t out)
 {
-    uint8_t data[2] = { reg, out };
-    return lowlevel_ls_op(dev, subdev,
-                          USDR_LSOP_I2C_DEV, ls_op_addr,
-                          0, NULL, SIZEOF_ARRAY(data), data);
-}
-
-static int tca6416_reg_wr2(lldev_t dev, subdev_t subdev, lsopaddr_t ls_op_addr,
-                    uint8_t reg, uint8_t out0, uint8_t out1)
-{
-    uint8_t data[3] = { reg, out0, out1 };
-    return lowlevel_ls_op(dev, subdev,
-                          USDR_LSOP_I2C_DEV, ls_op_addr,
-                          0, NULL, SIZEOF_ARRAY(data), data);
+    uint8_t data[3] = { reg, out, out >> 8 };
+    int res = lowlevel_i2c_q_add(q, ls_op_addr, cnt + 1, data, 0);
+    return (res < 0) ? res : 0;
 }
 
 static int tca6416_reg_rd(lldev_t dev, subdev_t subdev, lsopaddr_t ls_op_addr,
@@ -117,9 +106,12 @@ static inline int dev_gpi_get32(lldev_t dev, unsigned bank, unsigned* data)
     return lowlevel_reg_rd32(dev, 0, 16 + (bank / 4), data);
 }
 
-static int _board_ext_pciefe_wr(board_ext_pciefe_t* ob, uint32_t v)
+static int _board_ext_pciefe_ereg_q(board_ext_pciefe_t* ob, struct lowlevel_i2c_queue* q,
+                                    uint32_t addr, uint32_t reg);
+
+static int _board_ext_pciefe_q(board_ext_pciefe_t* ob, struct lowlevel_i2c_queue* q, uint32_t v)
 {
-    return board_ext_pciefe_ereg_wr(ob, v >> 16, v);
+    return _board_ext_pciefe_ereg_q(ob, q, v >> 16, v);
 }
 
 enum {
@@ -217,6 +209,7 @@ int board_ext_pciefe_init(lldev_t dev,
     // We need to enable VOSC to check DAC ID
     ob->osc_en = 1;
     ob->gps_en = 0;
+    ob->gps = NULL;
 
     ob->lna_en = 0;
     ob->pa_en = 0;
@@ -285,15 +278,14 @@ int board_ext_pciefe_init(lldev_t dev,
         }
     }
 
-    res = (res) ? res : tca6416_reg_wr(dev, subdev, i2ca_gpio, CONFIG_P0, 0);
-    res = (res) ? res : tca6416_reg_wr(dev, subdev, i2ca_gpio, CONFIG_P1, 0);
-    res = (res) ? res : tca6416_reg_wr(dev, subdev, i2ca_gpio, OUT_P0, 0);
-    res = (res) ? res : tca6416_reg_wr(dev, subdev, i2ca_gpio, OUT_P1, 0);
+    struct lowlevel_i2c_queue q;
+    lowlevel_i2c_q_init(&q);
 
-    res = (res) ? res : tca6416_reg_wr(dev, subdev, i2ca_fe, CONFIG_P0, 0);
-    res = (res) ? res : tca6416_reg_wr(dev, subdev, i2ca_fe, CONFIG_P1, 0);
-    res = (res) ? res : tca6416_reg_wr(dev, subdev, i2ca_fe, OUT_P0, 0);
-    res = (res) ? res : tca6416_reg_wr(dev, subdev, i2ca_fe, OUT_P1, 1);
+    res = (res) ? res : tca6416_reg_q(&q, i2ca_gpio, 2, CONFIG_P0, 0);
+    res = (res) ? res : tca6416_reg_q(&q, i2ca_gpio, 2, OUT_P0, 0);
+    res = (res) ? res : tca6416_reg_q(&q, i2ca_fe, 2, CONFIG_P0, 0);
+    res = (res) ? res : tca6416_reg_q(&q, i2ca_fe, 2, OUT_P0, 0x0100);
+    res = (res) ? res : lowlevel_i2c_q_exec(dev, subdev, &q);
 
     res = (res) ? res : board_ext_pciefe_updpwr(ob);
     if (res)
@@ -408,24 +400,28 @@ int board_ext_pciefe_init(lldev_t dev,
     res = res ? res : board_ext_pciefe_updfe(ob);
     res = res ? res : board_ext_pciefe_updpwr(ob);
 
-    if (is_param_on(&pd[P_UART]) == 1) {
-        // check uart
-        char b[2048];
-        uart_core_t uc;
-        res = (res) ? res : uart_core_init(dev, subdev, uart_base, &uc);
-        res = (res) ? res : uart_core_rx_collect(&uc, sizeof(b), b, 2250);
-
-        if (res > 0)
-            res = 0;
-        USDR_LOG("M2PE", USDR_LOG_ERROR, "UART: `%s`\n", b);
-    }
     if (res)
         return res;
 
+    if (is_param_on(&pd[P_UART]) == 1) {
+        // GPS module output is collected in background, don't wait for it here
+        res = device_gps_create(dev, subdev, uart_base, &ob->gps);
+        if (res) {
+            USDR_LOG("PCIF", USDR_LOG_WARNING, "Unable to start GPS reader, error %d\n", res);
+            ob->gps = NULL;
+        }
+    }
+
     USDR_LOG("PCIF", USDR_LOG_INFO, "PCIeFE initialized, mod %d\n", ob->board);
     return 0;
 }
 
+void board_ext_pciefe_destroy(board_ext_pciefe_t* ob)
+{
+    device_gps_destroy(ob->gps);
+    ob->gps = NULL;
+}
+
 int board_ext_pciefe_updpwr(board_ext_pciefe_t* ob)
 {
     uint32_t regs[2];
@@ -461,8 +457,12 @@ int board_ext_pciefe_updpwr(board_ext_pciefe_t* ob)
         return -EINVAL;
     }
 
-    res = (res) ? res : _board_ext_pciefe_wr(ob, regs[0]);
-    res = (res) ? res : _board_ext_pciefe_wr(ob, regs[1]);
+    struct lowlevel_i2c_queue q;
+    lowlevel_i2c_q_init(&q);
+
+    res = (res) ? res : _board_ext_pciefe_q(ob, &q, regs[0]);
+    res = (res) ? res : _board_ext_pciefe_q(ob, &q, regs[1]);
+    res = (res) ? res : lowlevel_i2c_q_exec(ob->dev, ob->subdev, &q);
     return res;
 }
 
@@ -563,47 +563,54 @@ int board_ext_pciefe_updfe(board_ext_pciefe_t* ob)
         return -EINVAL;
     }
 
-    res = (res || (regs[0] == 0)) ? res : _board_ext_pciefe_wr(ob, regs[0]);
-    res = (res || (regs[1] == 0)) ? res : _board_ext_pciefe_wr(ob, regs[1]);
+    struct lowlevel_i2c_queue q;
+    lowlevel_i2c_q_init(&q);
+
+    res = (res || (regs[0] == 0)) ? res : _board_ext_pciefe_q(ob, &q, regs[0]);
+    res = (res || (regs[1] == 0)) ? res : _board_ext_pciefe_q(ob, &q, regs[1]);
+    res = (res) ? res : lowlevel_i2c_q_exec(ob->dev, ob->subdev, &q);
     return res;
 }
 
 
-int board_ext_pciefe_ereg_wr(board_ext_pciefe_t* ob, uint32_t addr, uint32_t reg)
+static int _board_ext_pciefe_ereg_q(board_ext_pciefe_t* ob, struct lowlevel_i2c_queue* q,
+                                    uint32_t addr, uint32_t reg)
 {
-    int res;
     unsigned i2ca_gpio = MAKE_LSOP_I2C_ADDR(LSOP_I2C_INSTANCE(ob->i2c_loc), LSOP_I2C_BUSNO(ob->i2c_loc), I2C_ADDR_GPIO);
     unsigned i2ca_fe = MAKE_LSOP_I2C_ADDR(LSOP_I2C_INSTANCE(ob->i2c_loc), LSOP_I2C_BUSNO(ob->i2c_loc), I2C_ADDR_FE);
-    unsigned i2ca_dac = MAKE_LSOP_I2C_ADDR(LSOP_I2C_INSTANCE(ob->i2c_loc), LSOP_I2C_BUSNO(ob->i2c_loc), I2C_ADDR_DAC);
 
     switch (addr) {
     case V1_FE:
-        res = tca6416_reg_wr2(ob->dev, ob->subdev, i2ca_fe, OUT_P0, reg, reg >> 8);
-        break;
+        return tca6416_reg_q(q, i2ca_fe, 2, OUT_P0, reg);
     case V0_FE0:
     case V0_FE0_ALT:
-        res = tca6416_reg_wr(ob->dev, ob->subdev, i2ca_fe, OUT_P0, reg);
-        break;
+        return tca6416_reg_q(q, i2ca_fe, 1, OUT_P0, reg);
     case V0_FE1:
     case V0_AFE1_ALT:
-        res = tca6416_reg_wr(ob->dev, ob->subdev, i2ca_fe, OUT_P1, reg);
-        break;
+        return tca6416_reg_q(q, i2ca_fe, 1, OUT_P1, reg);
     case V0_GPIO0:
     case V1_GPIO0:
-        res = tca6416_reg_wr(ob->dev, ob->subdev, i2ca_gpio, OUT_P0, reg);
-        break;
+        return tca6416_reg_q(q, i2ca_gpio, 1, OUT_P0, reg);
     case V0_GPIO1:
     case V1_GPIO1:
-        res = tca6416_reg_wr(ob->dev, ob->subdev, i2ca_gpio, OUT_P1, reg);
-        break;
-    case GENERAL_DAC:
-        res = dac80501_dac_set(ob->dev, ob->subdev, i2ca_dac, reg);
-        break;
-    default:
-        return -EINVAL;
+        return tca6416_reg_q(q, i2ca_gpio, 1, OUT_P1, reg);
     }
 
-    return res;
+    return -EINVAL;
+}
+
+int board_ext_pciefe_ereg_wr(board_ext_pciefe_t* ob, uint32_t addr, uint32_t reg)
+{
+    int res;
+    unsigned i2ca_dac = MAKE_LSOP_I2C_ADDR(LSOP_I2C_INSTANCE(ob->i2c_loc), LSOP_I2C_BUSNO(ob->i2c_loc), I2C_ADDR_DAC);
+    struct lowlevel_i2c_queue q;
+
+    if (addr == GENERAL_DAC)
+        return dac80501_dac_set(ob->dev, ob->subdev, i2ca_dac, reg);
+
+    lowlevel_i2c_q_init(&q);
+    res = _board_ext_pciefe_ereg_q(ob, &q, addr, reg);
+    return (res) ? res : lowlevel_i2c_q_exec(ob->dev, ob->subdev, &q);
 }
 
 int board_ext_pciefe_ereg_rd(board_ext_pciefe_t* ob, uint32_t addr, uint32_t* preg)
@@ -9,6 +9,7 @@
 #include <stdbool.h>
 #include "../device.h"
 #include "../device_vfs.h"
+#include "../device_gps.h"
 
 enum board_type {
     V0_QORVO,
@@ -73,6 +74,9 @@ struct board_ext_pciefe {
     uint8_t rxattn;
 
     uint16_t dac;
+
+    // Background NMEA reader, started with `uart_` option
+    device_gps_t* gps;
 };
 
 typedef struct board_ext_pciefe board_ext_pciefe_t;
@@ -85,6 +89,7 @@ int board_ext_pciefe_init(lldev_t dev,
                           const char *compat,
                           unsigned i2c_loc,
                           board_ext_pciefe_t* ob);
+void board_ext_pciefe_destroy(board_ext_pciefe_t* ob);
 
 // Raw board interface
 int board_ext_pciefe_ereg_wr(board_ext_pciefe_t* ob, uint32_t addr, uint32_t reg);
@@ -127,6 +127,8 @@ const usdr_dev_param_constant_t s_params_m2_dsdr_rev000[] = {
     { "/ll/rfe/0/core",    USDR_MAKE_COREID(USDR_CS_FE, USDR_FC_BRSTN) },
     { "/ll/rfe/0/base",    CSR_RFE4_BASE },
 
+    { "/ll/sync/0/base",   M2PCI_REG_WR_TXDMA_COMB },
+
 
     { "/ll/sdr/0/rfic/0", (uintptr_t)"afe79xx" },
     { "/ll/sdr/max_hw_rx_chans",  4 },
@@ -84,6 +84,9 @@ const usdr_dev_param_constant_t s_params_m2_lm6_1_rev000[] = {
     { "/ll/stx/0/irq",     M2PCI_INT_TX},
     { "/ll/stx/0/dmacap",  0x555 },
 
+    { "/ll/sync/0/base",   M2PCI_REG_WR_TXDMA_COMB },
+    { "/ll/sync/0/ts",     M2PCI_REG_RD_TXDMA_STATTS },
+
     { "/ll/dsp/atcrbs/0/core", USDR_MAKE_COREID(USDR_CS_DSP, 0x23675e) },
     { "/ll/dsp/atcrbs/0/base", M2PCI_REG_WR_LBDSP },
 
@@ -845,6 +848,9 @@ void usdr_device_m2_lm6_1_destroy(pdevice_t udev)
     if (d->tx) {
         d->tx->ops->destroy(d->tx);
     }
+    if (d->fe) {
+        device_fe_destroy(d->fe);
+    }
 
     usdr_dtor(&d->d);
 
@@ -985,6 +991,7 @@ int usdr_device_m2_lm6_1_create(lldev_t dev, /*UNUSED*/ device_id_t devid)
     d->base.timer_op = &sfetrx4_stream_sync;
     d->rx = NULL;
     d->tx = NULL;
+    d->fe = NULL;
 
     dev->pdev = &d->base;
     return 0;
@@ -8,6 +8,7 @@
 #include <string.h>
 #include <math.h>
 #include <limits.h>
+#include <time.h>
 
 #include <usdr_logging.h>
 #include "lms7002m_ctrl.h"
@@ -90,7 +91,24 @@ int lms7002m_init(lms7002_dev_t* d, lldev_t dev, unsigned subdev, unsigned refcl
     d->rx_cfg_path = 0;
     d->tx_cfg_path = 0;
 
-    return 0;
+    memset(&d->tdd, 0, sizeof(d->tdd));
+
+    for (unsigned i = 0; i < RFIC_CHANS; i++) {
+        opt_u32_set_null(&d->rx_gfir_bw[i]);
+        opt_u32_set_null(&d->tx_gfir_bw[i]);
+    }
+    d->gfir_auto = false;
+
+    d->rx_gain = -1;
+    d->rx_gain_writes = 0;
+    return lms7002m_rx_gain_table_build(d, RFIC_LMS7_GAIN_NF);
+}
+
+// Path or streaming configuration has been rewritten, TDD sequences have to be rebuilt
+static void _lms7002m_tdd_invalidate(lms7002_dev_t *d)
+{
+    d->tdd.valid = false;
+    d->tdd.synced = false;
 }
 
 static int _lms7002m_check_chan(unsigned chan)
@@ -109,6 +127,7 @@ static int _lms7002m_set_lna_rx(lms7002_dev_t *d, unsigned cfg_idx)
     lms7002m_rfe_path_t band = (lms7002m_rfe_path_t)cfg->band;
     lms7002m_trf_path_t txlbband = TRF_MUTE;
     d->rx_cfg_path = cfg_idx;
+    _lms7002m_tdd_invalidate(d);
     if (d->rx_lna_lb_active) {
         txlbband = lms7002m_trf_from_rfe_path(band);
     }
@@ -140,6 +159,7 @@ static int _lms7002m_set_lna_tx(lms7002_dev_t *d, unsigned cfg_idx)
     lms7002m_trf_path_t band = (lms7002m_trf_path_t)cfg->band;
     int res = 0;
     d->tx_cfg_path = cfg_idx;
+    _lms7002m_tdd_invalidate(d);
 
     USDR_LOG("XDEV", USDR_LOG_INFO, "%s: Set TX band to %d (%s/%s)\n",
              lowlevel_get_devname(d->lmsstate.dev), band, cfg->name0, cfg->name1);
@@ -239,6 +259,10 @@ int lms7002m_set_gain(lms7002_dev_t *d,
     if (res)
         return res;
 
+    if (gain_type <= RFIC_LMS7_RX_LB_GAIN) {
+        d->rx_gain = -1;
+    }
+
     switch (gain_type) {
     case RFIC_LMS7_RX_LNA_GAIN:
         res = lms7002m_rfe_gain(&d->lmsstate, RFE_GAIN_LNA, (gain - 30) * 10, &aret);
@@ -306,6 +330,70 @@ int lms7002m_set_gain(lms7002_dev_t *d,
     return res;
 }
 
+int lms7002m_rx_gain_table_build(lms7002_dev_t *d, unsigned profile)
+{
+    if (profile != RFIC_LMS7_GAIN_NF && profile != RFIC_LMS7_GAIN_LINEARITY)
+        return -EINVAL;
+
+    // Every split of each 1 dB step is checked, NF profile prefers the highest
+    // LNA and then TIA gain, linearity profile the lowest
+    for (unsigned g = 0; g <= LMS7_RX_GAIN_MAX; g++) {
+        int best_score = INT_MIN;
+
+        for (unsigned lna = 1; lna < 16; lna++) {
+            int lna_g = 30 - lms7002m_rfe_step_atten(RFE_GAIN_LNA, lna) / 10;
+            for (unsigned tia = 1; tia < 4; tia++) {
+                int tia_g = 12 - lms7002m_rfe_step_atten(RFE_GAIN_TIA, tia) / 10;
+                int pga = (int)g - lna_g - tia_g;
+                int score = lna_g * 16 + tia_g;
+
+                if (pga < 0 || pga > 31)
+                    continue;
+                if (profile == RFIC_LMS7_GAIN_LINEARITY)
+                    score = -score;
+                if (score <= best_score)
+                    continue;
+
+                best_score = score;
+                d->rx_gain_table[g].lna = lna;
+                d->rx_gain_table[g].tia = tia;
+                d->rx_gain_table[g].pga = pga;
+            }
+        }
+    }
+
+    d->rx_gain_profile = profile;
+    d->rx_gain = -1;
+    return 0;
+}
+
+int lms7002m_set_rx_gain(lms7002_dev_t *d,
+                         unsigned channel,
+                         int gain,
+                         int *actualgain)
+{
+    const struct lms7002m_rx_gain_step* step;
+    int res = _lms7002m_check_chan(channel);
+    if (res)
+        return res;
+
+    gain = clamp(gain, 0, LMS7_RX_GAIN_MAX);
+    step = &d->rx_gain_table[gain];
+
+    res = lms7002m_rx_gain_set(&d->lmsstate, channel, step->lna, step->tia, step->pga, &d->rx_gain_writes);
+    if (res)
+        return res;
+
+    USDR_LOG("XDEV", USDR_LOG_DEBUG, "%s: RX gain %d dB => LNA:%d TIA:%d PGA:%d in %d writes\n",
+             lowlevel_get_devname(d->lmsstate.dev), gain, step->lna, step->tia, step->pga,
+             d->rx_gain_writes);
+
+    d->rx_gain = gain;
+    if (actualgain)
+        *actualgain = gain;
+    return 0;
+}
+
 int lms7002m_fe_set_freq(lms7002_dev_t *d,
                        unsigned channel,
                        unsigned type,
@@ -584,6 +672,82 @@ int lms7002m_bb_set_badwidth(lms7002_dev_t *d,
     return res;
 }
 
+enum {
+    LMS7_GFIR_TRANSITION_PCT = 20, // Stopband edge relative to passband edge
+};
+
+// Redesign GFIR3 for the current TSP rate, MAC has to be set to @p ich
+static int _lms7002m_gfir_update(lms7002_dev_t *d, bool dir_tx, unsigned ich)
+{
+    const opt_u32_t* obw = dir_tx ? &d->tx_gfir_bw[ich] : &d->rx_gfir_bw[ich];
+    const lms7002m_xxtsp_t tsp = dir_tx ? LMS_TXTSP : LMS_RXTSP;
+    unsigned clkdiv = dir_tx ? d->txtsp_div : d->rxtsp_div;
+    unsigned cgen_div = dir_tx ? d->txcgen_div : d->rxcgen_div;
+    lms7002m_gfir_design_t fd;
+    double rate, pass, stop;
+    unsigned bw;
+    int res;
+
+    // Rate isn't configured yet
+    if (clkdiv == 0 || cgen_div == 0 || d->cgen_clk == 0)
+        return 0;
+
+    rate = (double)d->cgen_clk / cgen_div / clkdiv;
+    bw = (obw->set) ? obw->value : (d->gfir_auto) ? (unsigned)(0.8 * rate) : 0;
+    pass = bw / 2.0 / rate;
+    stop = pass * (100 + LMS7_GFIR_TRANSITION_PCT) / 100;
+    if (stop > 0.5)
+        stop = 0.5;
+
+    if (bw == 0 || pass >= 0.45) {
+        return lms7002m_xxtsp_gfir(&d->lmsstate, tsp, LMS7_GFIR3, NULL);
+    }
+
+    res = lms7002m_gfir_design(LMS7_GFIR3, clkdiv, pass, stop, &fd);
+    if (res)
+        return res;
+
+    USDR_LOG("XDEV", USDR_LOG_INFO, "%s: %s[%d] GFIR3 passband %.3f MHz at %.3f MHz, %d taps, %.0f dB\n",
+             lowlevel_get_devname(d->lmsstate.dev), dir_tx ? "TX" : "RX", ich,
+             bw / 1e6, rate / 1e6, fd.taps, fd.atten_db);
+
+    return lms7002m_xxtsp_gfir(&d->lmsstate, tsp, LMS7_GFIR3, &fd);
+}
+
+int lms7002m_bb_set_gfir(lms7002_dev_t *d,
+                         unsigned channel,
+                         bool dir_tx,
+                         unsigned bw)
+{
+    int res;
+    res = _lms7002m_check_chan(channel);
+    if (res)
+        return res;
+
+    for (unsigned i = 0; i < RFIC_CHANS; i++) {
+        lms7002m_mac_mode_t lch = (i == 0) ? LMS7_CH_A : LMS7_CH_B;
+        if (!(channel & lch))
+            continue;
+
+        opt_u32_set_val(dir_tx ? &d->tx_gfir_bw[i] : &d->rx_gfir_bw[i], bw);
+
+        // Applied on streaming_up otherwise
+        if (!(dir_tx ? d->tx_run[i] : d->rx_run[i]))
+            continue;
+
+        res = lms7002m_mac_set(&d->lmsstate, lch);
+        if (res)
+            return res;
+
+        res = _lms7002m_gfir_update(d, dir_tx, i);
+        if (res)
+            return res;
+    }
+
+    _lms7002m_tdd_invalidate(d);
+    return 0;
+}
+
 
 
 int lms7002m_bb_set_freq(lms7002_dev_t *d,
@@ -633,6 +797,8 @@ int lms7002m_bb_set_freq(lms7002_dev_t *d,
 
 int lms7002m_streaming_down(lms7002_dev_t *d, unsigned dir)
 {
+    _lms7002m_tdd_invalidate(d);
+
     // SET MAC
     lms7002m_mac_set(&d->lmsstate, LMS7_CH_AB);
 
@@ -689,6 +855,8 @@ int lms7002m_streaming_up(lms7002_dev_t *d, unsigned dir,
     unsigned ich;
     const char* devstr = lowlevel_get_devname(d->lmsstate.dev);
 
+    _lms7002m_tdd_invalidate(d);
+
     if (dir & RFIC_LMS7_RX) {
         if (_lms7002m_check_chan(rx_chs_i)) {
             return -EINVAL;
@@ -786,6 +954,10 @@ int lms7002m_streaming_up(lms7002_dev_t *d, unsigned dir,
             res = lms7002m_xxtsp_cmix(&d->lmsstate, LMS_RXTSP, freqoffset);
             if (res)
                 return res;
+
+            res = _lms7002m_gfir_update(d, false, ich);
+            if (res)
+                return res;
         }
     }
     if (dir & RFIC_LMS7_TX) {
@@ -833,6 +1005,10 @@ int lms7002m_streaming_up(lms7002_dev_t *d, unsigned dir,
             res = lms7002m_xxtsp_cmix(&d->lmsstate, LMS_TXTSP, freqoffset);
             if (res)
                 return res;
+
+            res = _lms7002m_gfir_update(d, true, ich);
+            if (res)
+                return res;
         }
 
         d->tx_run[0] = txafen_a;
@@ -877,6 +1053,171 @@ int lms7002m_streaming_up(lms7002_dev_t *d, unsigned dir,
 }
 
 
+static uint64_t _lms7002m_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Capture register writes bringing active TDD channels to RX or TX state,
+// driver cache is left as it was
+static int _lms7002m_tdd_record(lms7002_dev_t *d, bool tx, uint32_t* regs, lms7002m_state_t* st)
+{
+    const freq_auto_band_map_t* rxcfg = &d->cfg_auto_rx[d->rx_cfg_path];
+    const freq_auto_band_map_t* txcfg = &d->cfg_auto_tx[d->tx_cfg_path];
+    lms7002m_state_t saved = d->lmsstate;
+    int res, cnt;
+
+    res = lms7002m_rec_start(&d->lmsstate, regs, LMS7002M_SEQ_MAX);
+    if (res)
+        return res;
+
+    res = lms7002m_mac_set(&d->lmsstate, d->tdd.chs);
+    res = res ? res : lms7002m_xxtsp_en(&d->lmsstate, LMS_RXTSP, !tx);
+    res = res ? res : lms7002m_xxtsp_en(&d->lmsstate, LMS_TXTSP, tx);
+    res = res ? res : lms7002m_rfe_path(&d->lmsstate, (lms7002m_rfe_path_t)rxcfg->band,
+                                        tx ? RFE_MODE_DISABLE : RFE_MODE_NORMAL);
+    res = res ? res : lms7002m_trf_path(&d->lmsstate, (lms7002m_trf_path_t)txcfg->band,
+                                        tx ? TRF_MODE_NORMAL : TRF_MODE_DISABLE);
+    cnt = lms7002m_rec_stop(&d->lmsstate);
+
+    *st = d->lmsstate;
+    d->lmsstate = saved;
+    return (res) ? res : cnt;
+}
+
+static int _lms7002m_tdd_prepare(lms7002_dev_t *d)
+{
+    struct lms7002m_tdd* t = &d->tdd;
+    uint32_t rxregs[LMS7002M_SEQ_MAX];
+    uint32_t txregs[LMS7002M_SEQ_MAX];
+    int rxcnt, txcnt, res;
+
+    if (d->rx_lna_lb_active) {
+        USDR_LOG("LMS7", USDR_LOG_ERROR, "%s: TDD turnaround isn't available in RF loopback mode\n",
+                 lowlevel_get_devname(d->lmsstate.dev));
+        return -EINVAL;
+    }
+
+    rxcnt = _lms7002m_tdd_record(d, false, rxregs, &t->st_rx);
+    if (rxcnt < 0)
+        return rxcnt;
+    txcnt = _lms7002m_tdd_record(d, true, txregs, &t->st_tx);
+    if (txcnt < 0)
+        return txcnt;
+
+    res = lms7002m_regs_delta(&d->lmsstate, rxregs, rxcnt, txregs, txcnt, t->rx2tx, LMS7002M_SEQ_MAX);
+    if (res < 0)
+        return res;
+    t->rx2tx_cnt = res;
+
+    res = lms7002m_regs_delta(&d->lmsstate, txregs, txcnt, rxregs, rxcnt, t->tx2rx, LMS7002M_SEQ_MAX);
+    if (res < 0)
+        return res;
+    t->tx2rx_cnt = res;
+
+    res = lms7002m_regs_delta(&d->lmsstate, NULL, 0, rxregs, rxcnt, t->rx_full, LMS7002M_SEQ_MAX);
+    if (res < 0)
+        return res;
+    t->rx_full_cnt = res;
+
+    res = lms7002m_regs_delta(&d->lmsstate, NULL, 0, txregs, txcnt, t->tx_full, LMS7002M_SEQ_MAX);
+    if (res < 0)
+        return res;
+    t->tx_full_cnt = res;
+
+    t->valid = true;
+    t->synced = false;
+
+    USDR_LOG("LMS7", USDR_LOG_INFO, "%s: TDD sequences ready RX->TX %d, TX->RX %d writes (full state %d/%d)\n",
+             lowlevel_get_devname(d->lmsstate.dev), t->rx2tx_cnt, t->tx2rx_cnt,
+             t->rx_full_cnt, t->tx_full_cnt);
+    return 0;
+}
+
+int lms7002m_tdd_enable(lms7002_dev_t *d, lms7002m_mac_mode_t chs, bool enable)
+{
+    struct lms7002m_tdd* t = &d->tdd;
+
+    if (!enable) {
+        t->enabled = false;
+        _lms7002m_tdd_invalidate(d);
+        return 0;
+    }
+
+    if (_lms7002m_check_chan(chs))
+        return -EINVAL;
+
+    t->enabled = true;
+    t->chs = chs;
+    t->switches = 0;
+    t->last_writes = 0;
+    t->last_ns = 0;
+    t->max_ns = 0;
+    _lms7002m_tdd_invalidate(d);
+
+    return _lms7002m_tdd_prepare(d);
+}
+
+int lms7002m_tdd_switch(lms7002_dev_t *d, bool tx)
+{
+    struct lms7002m_tdd* t = &d->tdd;
+    const lms7002m_state_t* st;
+    const uint32_t* seq;
+    unsigned cnt;
+    uint64_t start;
+    int res;
+
+    if (!t->enabled)
+        return -EINVAL;
+
+    // Full state is written after any reconfiguration, deltas afterwards
+    if (!t->valid || !t->synced) {
+        res = _lms7002m_tdd_prepare(d);
+        if (res)
+            return res;
+
+        seq = tx ? t->tx_full : t->rx_full;
+        cnt = tx ? t->tx_full_cnt : t->rx_full_cnt;
+    } else if (t->tx == tx) {
+        return 0;
+    } else {
+        seq = tx ? t->rx2tx : t->tx2rx;
+        cnt = tx ? t->rx2tx_cnt : t->tx2rx_cnt;
+    }
+
+    start = _lms7002m_now_ns();
+    res = lms7002m_regs_post(&d->lmsstate, seq, cnt);
+    if (res) {
+        t->synced = false;
+        return res;
+    }
+    t->last_ns = _lms7002m_now_ns() - start;
+    if (t->last_ns > t->max_ns)
+        t->max_ns = t->last_ns;
+    t->last_writes = cnt + 1;
+    t->switches++;
+
+    st = tx ? &t->st_tx : &t->st_rx;
+    for (unsigned i = 0; i < 2; i++) {
+        d->lmsstate.rfe[i].en = st->rfe[i].en;
+        d->lmsstate.trf[i].en = st->trf[i].en;
+        d->lmsstate.reg_en_dir[i] = st->reg_en_dir[i];
+        // Sequences carry TSP mode registers only, NCO / GFIR / correction bypasses stay cached
+        d->lmsstate.reg_rxtsp_dscmode[i] = st->reg_rxtsp_dscmode[i];
+        d->lmsstate.reg_txtsp_dscmode[i] = st->reg_txtsp_dscmode[i];
+    }
+
+    t->tx = tx;
+    t->synced = true;
+
+    USDR_LOG("LMS7", USDR_LOG_DEBUG, "%s: TDD -> %s in %d writes, %d ns\n",
+             lowlevel_get_devname(d->lmsstate.dev), tx ? "TX" : "RX", cnt + 1, t->last_ns);
+    return 0;
+}
+
+
 // Internal API
 static bool _check_lime_decimation(unsigned decim)
 {
@@ -923,6 +1264,8 @@ int lms7002m_samplerate(lms7002_dev_t *d,
     bool extclk_rx = ((flags & XSDR_LML_EXT_FIFOCLK_RX) == XSDR_LML_EXT_FIFOCLK_RX);
     bool extclk_tx = ((flags & XSDR_LML_EXT_FIFOCLK_TX) == XSDR_LML_EXT_FIFOCLK_TX);
 
+    d->gfir_auto = ((flags & XSDR_SR_GFIR) == XSDR_SR_GFIR);
+
     const unsigned mpy_adc = 4; // Always fixed to 4
     unsigned mpy_dac = 4; // Might be 4,2,1
     unsigned rxdiv = 1;
@@ -1097,6 +1440,16 @@ int lms7002m_samplerate(lms7002_dev_t *d,
             res = res ? res : lms7002m_set_gain(d, i == 0 ? LMS7_CH_A : LMS7_CH_B,
                                                 RFIC_LMS7_TX_PAD_GAIN, 0, NULL);
         }
+
+        // Channel filters depend on the TSP rate
+        if (rxrate > 1 && d->rx_run[i]) {
+            res = res ? res : lms7002m_mac_set(&d->lmsstate, i == 0 ? LMS7_CH_A : LMS7_CH_B);
+            res = res ? res : _lms7002m_gfir_update(d, false, i);
+        }
+        if (txrate > 1 && d->tx_run[i]) {
+            res = res ? res : lms7002m_mac_set(&d->lmsstate, i == 0 ? LMS7_CH_A : LMS7_CH_B);
+            res = res ? res : _lms7002m_gfir_update(d, true, i);
+        }
     }
 
 
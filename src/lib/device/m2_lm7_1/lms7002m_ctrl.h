@@ -60,9 +60,52 @@ enum {
     RFIC_LMS7_RX = BIT(1),
 };
 
+enum rfic_lms7_gain_profile {
+    RFIC_LMS7_GAIN_NF,        // Keep LNA / TIA gain high, best noise figure
+    RFIC_LMS7_GAIN_LINEARITY, // Keep PGA gain high, best front-end linearity
+};
+
+enum {
+    LMS7_RX_GAIN_MAX = 73, // LNA 30 + TIA 12 + PGA 31 dB
+};
+
+// Register codes of one 1 dB step of the overall RX gain
+struct lms7002m_rx_gain_step {
+    uint8_t lna; // RFE G_LNA code
+    uint8_t tia; // RFE G_TIA code
+    uint8_t pga; // RBB G_PGA, dB
+};
+
 struct lms7002_dev;
 typedef struct lms7002_dev lms7002_dev_t;
 
+// Pre-staged TDD turnaround, register delta between RX and TX states
+struct lms7002m_tdd {
+    bool enabled;
+    bool valid;     // Sequences match current RFIC configuration
+    bool synced;    // Chip is known to be in one of the two states
+    bool tx;        // Current state
+    uint8_t chs;
+
+    uint8_t rx2tx_cnt;
+    uint8_t tx2rx_cnt;
+    uint8_t rx_full_cnt;
+    uint8_t tx_full_cnt;
+    uint32_t rx2tx[LMS7002M_SEQ_MAX];
+    uint32_t tx2rx[LMS7002M_SEQ_MAX];
+    uint32_t rx_full[LMS7002M_SEQ_MAX];
+    uint32_t tx_full[LMS7002M_SEQ_MAX];
+
+    // Cached RFE/TRF/TSP state after each transition
+    lms7002m_state_t st_rx;
+    lms7002m_state_t st_tx;
+
+    unsigned switches;
+    unsigned last_writes;
+    unsigned last_ns;
+    unsigned max_ns;
+};
+
 typedef int (*on_change_antenna_port_sw_t)(lms7002_dev_t* dev, int direction, unsigned sw);
 typedef const lms7002m_lml_map_t (*on_get_lml_portcfg_t)(bool rx, unsigned chs, unsigned flags, bool no_siso_map);
 
@@ -105,6 +148,11 @@ struct lms7002_dev
     opt_u32_t tx_dsp[RFIC_CHANS];
     opt_u32_t rx_dsp[RFIC_CHANS];
 
+    // TSP GFIR3 channel filter passband, 0 - bypassed
+    opt_u32_t tx_gfir_bw[RFIC_CHANS];
+    opt_u32_t rx_gfir_bw[RFIC_CHANS];
+    bool gfir_auto; // XSDR_SR_GFIR, filter channels without explicit passband
+
     unsigned fref; // Reference clock
     unsigned cgen_clk; // LMS7002 CGEN frequency
     unsigned rx_lo;
@@ -124,6 +172,14 @@ struct lms7002_dev
     freq_auto_band_map_t cfg_auto_tx[MAX_TX_BANDS];
 
     bool rx_lna_lb_active;
+
+    struct lms7002m_tdd tdd;
+
+    // Overall RX gain, 0 .. LMS7_RX_GAIN_MAX
+    uint8_t rx_gain_profile;
+    int rx_gain;          // Last applied, -1 when set by individual stages
+    unsigned rx_gain_writes;
+    struct lms7002m_rx_gain_step rx_gain_table[LMS7_RX_GAIN_MAX + 1];
 };
 
 int lms7002m_rbb_bandwidth(lms7002_dev_t *d, unsigned bw, bool loopback);
@@ -139,6 +195,15 @@ int lms7002m_set_gain(lms7002_dev_t *d,
                      int gain,
                      double *actualgain);
 
+// Fill rx_gain_table for the profile
+int lms7002m_rx_gain_table_build(lms7002_dev_t *d, unsigned profile);
+
+// Overall RX gain through rx_gain_table, only changed registers are written
+int lms7002m_set_rx_gain(lms7002_dev_t *d,
+                         unsigned channel,
+                         int gain,
+                         int *actualgain);
+
 int lms7002m_fe_set_freq(lms7002_dev_t *d,
                        unsigned channel,
                        unsigned type,
@@ -162,6 +227,12 @@ int lms7002m_bb_set_badwidth(lms7002_dev_t *d,
                              unsigned bw,
                              unsigned* actualbw);
 
+// Channel filter in TSP GFIR3 at the stream rate, @p bw 0 bypasses it
+int lms7002m_bb_set_gfir(lms7002_dev_t *d,
+                         unsigned channel,
+                         bool dir_tx,
+                         unsigned bw);
+
 int lms7002m_bb_set_freq(lms7002_dev_t *d,
                         unsigned channel,
                         bool dir_tx,
@@ -190,6 +261,13 @@ int lms7002m_streaming_up(lms7002_dev_t *d, unsigned dir,
                           lms7002m_mac_mode_t rx_chs, unsigned rx_flags,
                           lms7002m_mac_mode_t tx_chs, unsigned tx_flags);
 
+// Fast TDD turnaround on running RX & TX streams. Only LNA / PA enables,
+// RFE / TRF switches and RX/TX TSP enables are toggled, the rest of the
+// configuration stays untouched. Bursts are rebuilt lazily after any path or
+// streaming change.
+int lms7002m_tdd_enable(lms7002_dev_t *d, lms7002m_mac_mode_t chs, bool enable);
+int lms7002m_tdd_switch(lms7002_dev_t *d, bool tx);
+
 
 enum {
     XSDR_SR_MAXCONVRATE = 1,
@@ -198,6 +276,7 @@ enum {
     XSDR_LML_EXT_FIFOCLK_RX = 8,
     XSDR_LML_EXT_FIFOCLK_TX = 16,
     XSDR_LML_SISO_DDR_TX = 32,
+    XSDR_SR_GFIR = 64, // Channel filtering in TSP GFIR3 at the decimated rate
 };
 
 int lms7002m_samplerate(lms7002_dev_t *d,
@@ -8,6 +8,8 @@
 #include <assert.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
+#include <pthread.h>
 
 #include "../device.h"
 #include "../device_ids.h"
@@ -22,6 +24,8 @@
 #include "../ipblks/streams/sfe_tx_4.h"
 #include "../ipblks/streams/stream_sfetrx4_dma32.h"
 
+#include "../common/rx_agc.h"
+
 #include "xsdr_ctrl.h"
 
 //#include "../device/ext_exm2pe/board_exm2pe.h"
@@ -98,6 +102,9 @@ const usdr_dev_param_constant_t s_params_m2_lm7_1_rev000[] = {
     { "/ll/stx/0/irq",     M2PCI_INT_TX},
     { "/ll/stx/0/dmacap",  0x555 },
 
+    { "/ll/sync/0/base",   M2PCI_REG_WR_TXDMA_COMB },
+    { "/ll/sync/0/ts",     M2PCI_REG_RD_TXDMA_STATTS },
+
     { "/ll/dsp/atcrbs/0/core", USDR_MAKE_COREID(USDR_CS_DSP, 0x23675e) },
     { "/ll/dsp/atcrbs/0/base", M2PCI_REG_WR_LBDSP },
 
@@ -116,8 +123,16 @@ static int dev_m2_lm7_1_rate_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t val
 static int dev_m2_lm7_1_rate_m_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
 static int dev_m2_lm7_1_debug_all_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* ovalue);
 static int dev_m2_lm7_1_pwren_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int dev_m2_lm7_1_snapshot_save_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
 
 static int dev_m2_lm7_1_sdr_tdd_freq_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int dev_m2_lm7_1_sdr_tdd_mode_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int dev_m2_lm7_1_sdr_tdd_mode_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value);
+static int dev_m2_lm7_1_sdr_tdd_trigger_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int dev_m2_lm7_1_sdr_tdd_switch_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int dev_m2_lm7_1_sdr_tdd_switch_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value);
+static int dev_m2_lm7_1_sdr_tdd_turnaround_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value);
+static int dev_m2_lm7_1_sdr_tdd_turnaround_max_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value);
 static int dev_m2_lm7_1_sdr_rx_freq_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
 static int dev_m2_lm7_1_sdr_tx_freq_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
 static int dev_m2_lm7_1_sdr_rx_gain_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
@@ -127,14 +142,34 @@ static int dev_m2_lm7_1_sdr_tx_gainbb_set(pdevice_t ud, pusdr_vfs_obj_t obj, uin
 
 static int dev_m2_lm7_1_sdr_rx_bbfreq_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
 static int dev_m2_lm7_1_sdr_tx_bbfreq_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int dev_m2_lm7_1_sdr_rx_bbfreq_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value);
+static int dev_m2_lm7_1_sdr_tx_bbfreq_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value);
+static int dev_m2_lm7_1_sdr_rx_rffreq_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value);
+static int dev_m2_lm7_1_sdr_tx_rffreq_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value);
+static int dev_m2_lm7_1_sdr_tune_policy_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int dev_m2_lm7_1_sdr_tune_policy_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value);
 
 static int dev_m2_lm7_1_sdr_rx_bandwidth_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
 static int dev_m2_lm7_1_sdr_tx_bandwidth_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int dev_m2_lm7_1_sdr_rx_gfir_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int dev_m2_lm7_1_sdr_tx_gfir_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
 
 static int dev_m2_lm7_1_sdr_rx_gainpga_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
 static int dev_m2_lm7_1_sdr_rx_gainvga_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
 static int dev_m2_lm7_1_sdr_rx_gainlna_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
 static int dev_m2_lm7_1_sdr_rx_gainlb_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int dev_m2_lm7_1_sdr_rx_gainauto_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int dev_m2_lm7_1_sdr_rx_gainauto_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value);
+static int dev_m2_lm7_1_sdr_rx_gainprofile_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int dev_m2_lm7_1_sdr_rx_gainprofile_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value);
+static int dev_m2_lm7_1_sdr_rx_gainwrites_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value);
+
+static int dev_m2_lm7_1_sdr_rx_agc_enable_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int dev_m2_lm7_1_sdr_rx_agc_enable_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value);
+static int dev_m2_lm7_1_sdr_rx_agc_target_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int dev_m2_lm7_1_sdr_rx_agc_attack_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int dev_m2_lm7_1_sdr_rx_agc_decay_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int dev_m2_lm7_1_sdr_rx_agc_event_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value);
 
 static int dev_m2_lm7_1_sdr_rx_path_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
 //static int dev_m2_lm7_1_sdr_tx_path_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
@@ -145,6 +180,8 @@ static int dev_m2_lm7_1_debug_lms7002m_reg_get(pdevice_t ud, pusdr_vfs_obj_t obj
 
 static int dev_m2_lm7_1_debug_lms8001_reg_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
 static int dev_m2_lm7_1_debug_lms8001_reg_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* ovalue);
+static int dev_m2_lm7_1_lms8001_preload_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
+static int dev_m2_lm7_1_lms8001_hop_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* ovalue);
 
 
 static int dev_m2_lm7_1_sdr_rx_dccorr_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
@@ -194,6 +231,7 @@ static int dev_m2_lm7_1_lms7002rxlml_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint
 static int dev_m2_lm7_1_debug_clkinfo_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value);
 
 static int dev_m2_lm7_1_revision_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t *ovalue);
+static int dev_m2_lm7_1_stream_restart_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t *ovalue);
 
 static
 const usdr_dev_param_func_t s_fparams_m2_lm7_1_rev000[] = {
@@ -202,6 +240,7 @@ const usdr_dev_param_func_t s_fparams_m2_lm7_1_rev000[] = {
 
     { "/dm/debug/all",          { NULL, dev_m2_lm7_1_debug_all_get }},
     { "/dm/power/en",           { dev_m2_lm7_1_pwren_set, NULL }},
+    { "/dm/snapshot/save",      { dev_m2_lm7_1_snapshot_save_set, NULL }},
 
     { "/dm/sdr/channels",       { NULL, NULL }},
     { "/dm/sensor/temp",        { NULL, dev_m2_lm7_1_senstemp_get }},
@@ -216,8 +255,11 @@ const usdr_dev_param_func_t s_fparams_m2_lm7_1_rev000[] = {
     { "/dm/sdr/0/rx/phgaincorr",{ dev_m2_lm7_1_sdr_rx_phgaincorr_set, NULL }},
     { "/dm/sdr/0/tx/phgaincorr",{ dev_m2_lm7_1_sdr_tx_phgaincorr_set, NULL }},
 
-    { "/dm/sdr/0/rx/freqency/bb",  { dev_m2_lm7_1_sdr_rx_bbfreq_set, NULL }},
-    { "/dm/sdr/0/tx/freqency/bb",  { dev_m2_lm7_1_sdr_tx_bbfreq_set, NULL }},
+    { "/dm/sdr/0/rx/freqency/bb",  { dev_m2_lm7_1_sdr_rx_bbfreq_set, dev_m2_lm7_1_sdr_rx_bbfreq_get }},
+    { "/dm/sdr/0/tx/freqency/bb",  { dev_m2_lm7_1_sdr_tx_bbfreq_set, dev_m2_lm7_1_sdr_tx_bbfreq_get }},
+    { "/dm/sdr/0/rx/freqency/rf",  { NULL, dev_m2_lm7_1_sdr_rx_rffreq_get }},
+    { "/dm/sdr/0/tx/freqency/rf",  { NULL, dev_m2_lm7_1_sdr_tx_rffreq_get }},
+    { "/dm/sdr/0/tune/policy",     { dev_m2_lm7_1_sdr_tune_policy_set, dev_m2_lm7_1_sdr_tune_policy_get }},
 
     { "/dm/sdr/0/rx/freqency",  { dev_m2_lm7_1_sdr_rx_freq_set, NULL }},
     { "/dm/sdr/0/tx/freqency",  { dev_m2_lm7_1_sdr_tx_freq_set, NULL }},
@@ -230,6 +272,15 @@ const usdr_dev_param_func_t s_fparams_m2_lm7_1_rev000[] = {
     { "/dm/sdr/0/rx/gain/vga",  { dev_m2_lm7_1_sdr_rx_gainvga_set, NULL }},
     { "/dm/sdr/0/rx/gain/lna",  { dev_m2_lm7_1_sdr_rx_gainlna_set, NULL }},
     { "/dm/sdr/0/rx/gain/lb",   { dev_m2_lm7_1_sdr_rx_gainlb_set, NULL }},
+    { "/dm/sdr/0/rx/gain/auto",    { dev_m2_lm7_1_sdr_rx_gainauto_set, dev_m2_lm7_1_sdr_rx_gainauto_get }},
+    { "/dm/sdr/0/rx/gain/profile", { dev_m2_lm7_1_sdr_rx_gainprofile_set, dev_m2_lm7_1_sdr_rx_gainprofile_get }},
+    { "/dm/sdr/0/rx/gain/writes",  { NULL, dev_m2_lm7_1_sdr_rx_gainwrites_get }},
+
+    { "/dm/sdr/0/rx/agc/enable",   { dev_m2_lm7_1_sdr_rx_agc_enable_set, dev_m2_lm7_1_sdr_rx_agc_enable_get }},
+    { "/dm/sdr/0/rx/agc/target",   { dev_m2_lm7_1_sdr_rx_agc_target_set, NULL }},
+    { "/dm/sdr/0/rx/agc/attack",   { dev_m2_lm7_1_sdr_rx_agc_attack_set, NULL }},
+    { "/dm/sdr/0/rx/agc/decay",    { dev_m2_lm7_1_sdr_rx_agc_decay_set, NULL }},
+    { "/dm/sdr/0/rx/agc/event",    { NULL, dev_m2_lm7_1_sdr_rx_agc_event_get }},
 
     { "/dm/sdr/0/rx/path",      { dev_m2_lm7_1_sdr_rx_path_set, NULL }},
     { "/dm/sdr/0/tx/path",      { dev_m2_lm7_1_sdr_rx_path_set, NULL }},
@@ -238,10 +289,17 @@ const usdr_dev_param_func_t s_fparams_m2_lm7_1_rev000[] = {
 
     { "/dm/sdr/0/rx/bandwidth", { dev_m2_lm7_1_sdr_rx_bandwidth_set, NULL }},
     { "/dm/sdr/0/tx/bandwidth", { dev_m2_lm7_1_sdr_tx_bandwidth_set, NULL }},
+    { "/dm/sdr/0/rx/gfir",      { dev_m2_lm7_1_sdr_rx_gfir_set, NULL }},
+    { "/dm/sdr/0/tx/gfir",      { dev_m2_lm7_1_sdr_tx_gfir_set, NULL }},
 
     { "/dm/sdr/0/rxdsp/swapab", { dev_m2_lm7_1_sdr_rxdsp_swapab_set, NULL }},
 
     { "/dm/sdr/0/tdd/freqency",          { dev_m2_lm7_1_sdr_tdd_freq_set, NULL }},
+    { "/dm/sdr/0/tdd/mode",              { dev_m2_lm7_1_sdr_tdd_mode_set, dev_m2_lm7_1_sdr_tdd_mode_get }},
+    { "/dm/sdr/0/tdd/trigger",           { dev_m2_lm7_1_sdr_tdd_trigger_set, NULL }},
+    { "/dm/sdr/0/tdd/switch",            { dev_m2_lm7_1_sdr_tdd_switch_set, dev_m2_lm7_1_sdr_tdd_switch_get }},
+    { "/dm/sdr/0/tdd/turnaround",        { NULL, dev_m2_lm7_1_sdr_tdd_turnaround_get }},
+    { "/dm/sdr/0/tdd/turnaround_max",    { NULL, dev_m2_lm7_1_sdr_tdd_turnaround_max_get }},
     { "/dm/sdr/0/tfe/antcfg",            { dev_m2_lm7_1_tx_antennat_port_cfg_set, NULL }},
 
     { "/dm/sdr/0/tfe/generator/enable",  { dev_m2_lm7_1_tfe_gen_en_set, NULL }},
@@ -256,6 +314,10 @@ const usdr_dev_param_func_t s_fparams_m2_lm7_1_rev000[] = {
     { "/dm/sdr/0/rfe/nco/freqency",{ dev_m2_lm7_1_rfe_nco_enable_frequency, NULL }},
     { "/dm/sdr/0/rfe/pwrdc",       { NULL, dev_m2_lm7_1_rfe_nco_pwrdc_get }},
 
+    // LMS8001 PLL profiles (SSDR only)
+    { "/dm/sdr/0/lms8001/preload", { dev_m2_lm7_1_lms8001_preload_set, NULL }},
+    { "/dm/sdr/0/lms8001/hop",     { NULL, dev_m2_lm7_1_lms8001_hop_get }},
+
     // Debug interface
     { "/debug/hw/lms7002m/0/reg",  { dev_m2_lm7_1_debug_lms7002m_reg_set, dev_m2_lm7_1_debug_lms7002m_reg_get }},
     { "/debug/hw/lms8001/0/reg" ,  { dev_m2_lm7_1_debug_lms8001_reg_set, dev_m2_lm7_1_debug_lms8001_reg_get }},
@@ -277,6 +339,13 @@ const usdr_dev_param_func_t s_fparams_m2_lm7_1_rev000[] = {
     { "/debug/clk_info",            { dev_m2_lm7_1_debug_clkinfo_set, NULL }},
 
     { "/dm/revision",               { NULL, dev_m2_lm7_1_revision_get }},
+
+    // Time spent on the last stream creation (ns), pooled streams are restarted without reallocation
+    { "/dm/stream/restart_ns",      { NULL, dev_m2_lm7_1_stream_restart_get }},
+};
+
+enum {
+    AGC_EVENTS = 64,
 };
 
 struct dev_m2_lm7_1_gps {
@@ -293,11 +362,29 @@ struct dev_m2_lm7_1_gps {
     struct dev_fe* fe;
     bool bifurcation_en;
     bool nodecint;
+    bool gfir;
 
     int cal_data[8];
 
     stream_handle_t* rx;
     stream_handle_t* tx;
+
+    struct sfetrx4_pool pool;
+
+    // Timestamp of the next TDD switch, applies once
+    bool tdd_trigger_armed;
+    uint32_t tdd_trigger_ts;
+
+    // Serializes every RFIC access: all VFS parameters, stream creation and
+    // RX AGC, which changes gain from usdr_dms_recv() context
+    pthread_mutex_t rfic_lock;
+    unsigned agc_fullscale;
+    bool agc_en;
+    struct rx_agc_params agc_params;
+    rx_agc_t agc;
+    unsigned agc_evt_rd;
+    unsigned agc_evt_wr;
+    uint64_t agc_evt[AGC_EVENTS]; // Sample timestamp << 8 | gain
 };
 
 int dev_m2_lm7_1_debug_clkinfo_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
@@ -367,6 +454,22 @@ int dev_m2_lm7_1_debug_lms8001_reg_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64
     return res;
 }
 
+int dev_m2_lm7_1_lms8001_preload_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    return xsdr_rfic_fe_preload_freq(&d->xdev, value);
+}
+
+// SPI transactions [63:32], settle time in ns [31:0] of the last LO change
+int dev_m2_lm7_1_lms8001_hop_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* ovalue)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    if (!d->xdev.ssdr)
+        return -ENOTSUP;
+
+    *ovalue = ((uint64_t)d->xdev.lms8.last_hop.spi_transactions << 32) | d->xdev.lms8.last_hop.settle_ns;
+    return 0;
+}
 
 int dev_m2_lm7_1_sdr_rx_dccorr_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
 {
@@ -654,7 +757,8 @@ int dev_m2_lm7_1_rate_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
 
      //Simple SISO RX only
     return xsdr_set_samplerate_ex(&d->xdev, (unsigned)value, (unsigned)value, 0, 0,
-                                  (d->nodecint ? 0 : XSDR_SR_MAXCONVRATE) | XSDR_SR_EXTENDED_CGEN);
+                                  (d->nodecint ? 0 : XSDR_SR_MAXCONVRATE) | XSDR_SR_EXTENDED_CGEN |
+                                  (d->gfir ? XSDR_SR_GFIR : 0));
 }
 
 int dev_m2_lm7_1_rate_m_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
@@ -678,7 +782,8 @@ int dev_m2_lm7_1_rate_m_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
         return -ERANGE;
 
     return xsdr_set_samplerate_ex(&d->xdev, rx_rate, tx_rate, adc_rate, dac_rate,
-                                  (d->nodecint ? 0 : XSDR_SR_MAXCONVRATE) | XSDR_SR_EXTENDED_CGEN);
+                                  (d->nodecint ? 0 : XSDR_SR_MAXCONVRATE) | XSDR_SR_EXTENDED_CGEN |
+                                  (d->gfir ? XSDR_SR_GFIR : 0));
 }
 
 int dev_m2_lm7_1_debug_all_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* ovalue)
@@ -706,18 +811,129 @@ int dev_m2_lm7_1_debug_all_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* oval
 int dev_m2_lm7_1_sdr_tdd_freq_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
 {
     struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
-    return xsdr_rfic_fe_set_freq(&d->xdev, LMS7_CH_AB, RFIC_LMS7_TX_AND_RX_TDD, value, NULL);
+    return xsdr_rfic_fe_tune(&d->xdev, RFIC_LMS7_TX_AND_RX_TDD, value, d->xdev.tune_policy);
+}
+
+// Channel mask of TDD turnaround, 0 turns it off
+int dev_m2_lm7_1_sdr_tdd_mode_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    d->tdd_trigger_armed = false;
+    return lms7002m_tdd_enable(&d->xdev.base, (lms7002m_mac_mode_t)value, value != 0);
+}
+
+int dev_m2_lm7_1_sdr_tdd_mode_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    *value = d->xdev.base.tdd.enabled ? d->xdev.base.tdd.chs : 0;
+    return 0;
+}
+
+// Sample timestamp for the next /dm/sdr/0/tdd/switch
+int dev_m2_lm7_1_sdr_tdd_trigger_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    d->tdd_trigger_armed = true;
+    d->tdd_trigger_ts = (uint32_t)value;
+    return 0;
+}
+
+enum {
+    TDD_TRIGGER_TIMEOUT_NS = 1000000000,
+    TDD_TRIGGER_SPIN_US = 200,
+    TDD_TRIGGER_SLEEP_MAX_US = 10000,
+};
+
+// Poll board sample counter until the sequence issued now completes at the
+// requested timestamp, last turnaround time is used as the lead. The thread
+// sleeps through the most of the distance and only spins on the last stretch.
+static int _dev_m2_lm7_1_tdd_wait(struct dev_m2_lm7_1_gps *d, uint32_t ts)
+{
+    uint32_t lead = (uint64_t)d->xdev.base.tdd.last_ns * d->xdev.s_txrate / 1000000000u;
+    uint32_t now;
+    struct timespec start, cur;
+    int res;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (;;) {
+        res = lowlevel_reg_rd32(d->base.dev, 0, M2PCI_REG_RD_TXDMA_STATTS, &now);
+        if (res)
+            return res;
+
+        int32_t diff = (int32_t)(ts - now);
+        if (diff <= (int32_t)lead) {
+            if (diff < 0) {
+                USDR_LOG("UDEV", USDR_LOG_WARNING, "TDD switch is late by %d samples\n", -diff);
+            }
+            return 0;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &cur);
+        if ((cur.tv_sec - start.tv_sec) * 1000000000ll + (cur.tv_nsec - start.tv_nsec) > TDD_TRIGGER_TIMEOUT_NS) {
+            USDR_LOG("UDEV", USDR_LOG_ERROR, "TDD trigger timestamp %u is too far, now %u\n", ts, now);
+            return -ETIMEDOUT;
+        }
+
+        // Sleep for half of the remaining time, spin only when close to the lead
+        uint64_t left_us = (d->xdev.s_txrate == 0) ? TDD_TRIGGER_SLEEP_MAX_US :
+                               (uint64_t)(diff - lead) * 1000000u / d->xdev.s_txrate / 2;
+        if (left_us > TDD_TRIGGER_SPIN_US) {
+            usleep(left_us > TDD_TRIGGER_SLEEP_MAX_US ? TDD_TRIGGER_SLEEP_MAX_US : left_us);
+        }
+    }
+}
+
+// 1 - TX, 0 - RX
+int dev_m2_lm7_1_sdr_tdd_switch_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    int res;
+
+    if (d->tdd_trigger_armed) {
+        d->tdd_trigger_armed = false;
+        res = _dev_m2_lm7_1_tdd_wait(d, d->tdd_trigger_ts);
+        if (res)
+            return res;
+    }
+
+    return lms7002m_tdd_switch(&d->xdev.base, value != 0);
+}
+
+int dev_m2_lm7_1_sdr_tdd_switch_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    if (!d->xdev.base.tdd.enabled)
+        return -EINVAL;
+
+    *value = d->xdev.base.tdd.tx ? 1 : 0;
+    return 0;
+}
+
+// SPI writes [63:32], time in ns [31:0] of the last turnaround
+int dev_m2_lm7_1_sdr_tdd_turnaround_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    *value = ((uint64_t)d->xdev.base.tdd.last_writes << 32) | d->xdev.base.tdd.last_ns;
+    return 0;
+}
+
+// Number of switches [63:32], worst turnaround in ns [31:0]
+int dev_m2_lm7_1_sdr_tdd_turnaround_max_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    *value = ((uint64_t)d->xdev.base.tdd.switches << 32) | d->xdev.base.tdd.max_ns;
+    return 0;
 }
 
 int dev_m2_lm7_1_sdr_rx_freq_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
 {
     struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
-    return xsdr_rfic_fe_set_freq(&d->xdev, LMS7_CH_AB, RFIC_LMS7_TUNE_RX_FDD, value, NULL);
+    return xsdr_rfic_fe_tune(&d->xdev, RFIC_LMS7_TUNE_RX_FDD, value, d->xdev.tune_policy);
 }
 int dev_m2_lm7_1_sdr_tx_freq_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
 {
     struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
-    return xsdr_rfic_fe_set_freq(&d->xdev, LMS7_CH_AB, RFIC_LMS7_TUNE_TX_FDD, value, NULL);
+    return xsdr_rfic_fe_tune(&d->xdev, RFIC_LMS7_TUNE_TX_FDD, value, d->xdev.tune_policy);
 }
 
 int dev_m2_lm7_1_sdr_rx_bbfreq_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
@@ -726,7 +942,10 @@ int dev_m2_lm7_1_sdr_rx_bbfreq_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t v
     unsigned channel = value >> 32;
     int32_t freq = (int32_t)(value & 0xffffffff);
 
-    return xsdr_rfic_bb_set_freq(&d->xdev, channel, false, freq);
+    int res = xsdr_rfic_bb_set_freq(&d->xdev, channel, false, freq);
+    if (res == 0 && (channel & LMS7_CH_A))
+        d->xdev.tune_bb[0] = freq;
+    return res;
 }
 int dev_m2_lm7_1_sdr_tx_bbfreq_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
 {
@@ -734,7 +953,52 @@ int dev_m2_lm7_1_sdr_tx_bbfreq_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t v
     unsigned channel = value >> 32;
     int32_t freq = (int32_t)(value & 0xffffffff);
 
-    return xsdr_rfic_bb_set_freq(&d->xdev, channel, true, freq);
+    int res = xsdr_rfic_bb_set_freq(&d->xdev, channel, true, freq);
+    if (res == 0 && (channel & LMS7_CH_A))
+        d->xdev.tune_bb[1] = freq;
+    return res;
+}
+
+int dev_m2_lm7_1_sdr_rx_bbfreq_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    *value = (uint64_t)(int64_t)d->xdev.tune_bb[0];
+    return 0;
+}
+int dev_m2_lm7_1_sdr_tx_bbfreq_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    *value = (uint64_t)(int64_t)d->xdev.tune_bb[1];
+    return 0;
+}
+
+int dev_m2_lm7_1_sdr_rx_rffreq_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    *value = d->xdev.tune_rf[0];
+    return 0;
+}
+int dev_m2_lm7_1_sdr_tx_rffreq_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    *value = d->xdev.tune_rf[1];
+    return 0;
+}
+
+int dev_m2_lm7_1_sdr_tune_policy_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    if (value > XSDR_TUNE_NCO_FIRST)
+        return -EINVAL;
+
+    d->xdev.tune_policy = value;
+    return 0;
+}
+int dev_m2_lm7_1_sdr_tune_policy_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    *value = d->xdev.tune_policy;
+    return 0;
 }
 
 int dev_m2_lm7_1_sdr_rx_gain_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
@@ -767,6 +1031,16 @@ int dev_m2_lm7_1_sdr_tx_bandwidth_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_
     struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
     return xsdr_rfic_bb_set_badwidth(&d->xdev, LMS7_CH_AB, true, value, NULL);
 }
+int dev_m2_lm7_1_sdr_rx_gfir_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    return xsdr_rfic_bb_set_gfir(&d->xdev, LMS7_CH_AB, false, value);
+}
+int dev_m2_lm7_1_sdr_tx_gfir_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    return xsdr_rfic_bb_set_gfir(&d->xdev, LMS7_CH_AB, true, value);
+}
 int dev_m2_lm7_1_sdr_rx_gainpga_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
 {
     struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
@@ -791,6 +1065,186 @@ int dev_m2_lm7_1_sdr_rx_gainlb_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t v
     return xsdr_rfic_set_gain(&d->xdev, LMS7_CH_AB, RFIC_LMS7_RX_LB_GAIN, value, NULL);
 }
 
+// Overall RX gain in dB through the precomputed table, turns AGC off
+int dev_m2_lm7_1_sdr_rx_gainauto_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+
+    d->agc_en = false;
+    return lms7002m_set_rx_gain(&d->xdev.base, LMS7_CH_AB, (int)value, NULL);
+}
+
+int dev_m2_lm7_1_sdr_rx_gainauto_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    if (d->xdev.base.rx_gain < 0)
+        return -EINVAL;
+
+    *value = d->xdev.base.rx_gain;
+    return 0;
+}
+
+int dev_m2_lm7_1_sdr_rx_gainprofile_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    int gain, res;
+
+    gain = d->xdev.base.rx_gain;
+    res = lms7002m_rx_gain_table_build(&d->xdev.base, value);
+    if (res == 0 && gain >= 0) {
+        res = lms7002m_set_rx_gain(&d->xdev.base, LMS7_CH_AB, gain, NULL);
+    }
+    return res;
+}
+
+int dev_m2_lm7_1_sdr_rx_gainprofile_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    *value = d->xdev.base.rx_gain_profile;
+    return 0;
+}
+
+// SPI writes used by the last overall RX gain change
+int dev_m2_lm7_1_sdr_rx_gainwrites_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    *value = d->xdev.base.rx_gain_writes;
+    return 0;
+}
+
+static void _dev_m2_lm7_1_agc_level(void* obj, const struct usdr_dms_ch_stat* stats,
+                                    unsigned channels, unsigned nsyms, uint64_t ts)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)obj;
+    double level = -200;
+    bool clipped = false;
+    int gain, res;
+
+    for (unsigned i = 0; i < channels; i++) {
+        double l = rx_agc_level_dbfs(stats[i].sum_sq, nsyms, d->agc_fullscale);
+        if (l > level)
+            level = l;
+        if (stats[i].clips)
+            clipped = true;
+    }
+
+    pthread_mutex_lock(&d->rfic_lock);
+    if (d->agc_en && rx_agc_update(&d->agc, level, clipped, ts, nsyms, &gain)) {
+        res = lms7002m_set_rx_gain(&d->xdev.base, LMS7_CH_AB, gain, NULL);
+        if (res) {
+            USDR_LOG("UDEV", USDR_LOG_WARNING, "AGC: unable to set RX gain %d, error %d\n", gain, res);
+        } else {
+            // Gain is in effect for samples following the measured packet
+            if (d->agc_evt_wr - d->agc_evt_rd == AGC_EVENTS) {
+                d->agc_evt_rd++;
+            }
+            d->agc_evt[d->agc_evt_wr++ % AGC_EVENTS] = ((ts + nsyms) << 8) | (unsigned)gain;
+        }
+    }
+    pthread_mutex_unlock(&d->rfic_lock);
+}
+
+static int _dev_m2_lm7_1_agc_attach(struct dev_m2_lm7_1_gps *d)
+{
+    const char* wfmt;
+    int64_t val;
+    unsigned bits;
+
+    if (!d->rx)
+        return 0;
+
+    // Full scale of the wire samples, ci12 packets carry 12-bit values
+    if (d->rx->ops->option_get(d->rx, "wire_fmt", &val))
+        return -EINVAL;
+    wfmt = (const char*)(intptr_t)val;
+    while (*wfmt && (*wfmt < '0' || *wfmt > '9'))
+        wfmt++;
+    bits = atoi(wfmt);
+    if (bits < 2 || bits > 16)
+        return -ENOTSUP;
+    d->agc_fullscale = (1u << (bits - 1)) - 1;
+
+    return sfetrx4_stream_set_level_cb(d->rx, d->agc_en ? &_dev_m2_lm7_1_agc_level : NULL, d);
+}
+
+int dev_m2_lm7_1_sdr_rx_agc_enable_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    int gain, res = 0;
+
+    if (value && !d->agc_en) {
+        gain = d->xdev.base.rx_gain;
+        if (gain < 0) {
+            gain = (d->agc_params.gain_min + d->agc_params.gain_max) / 2;
+            res = lms7002m_set_rx_gain(&d->xdev.base, LMS7_CH_AB, gain, NULL);
+        }
+
+        rx_agc_init(&d->agc, &d->agc_params, d->xdev.s_rxrate, gain);
+        d->agc_evt_rd = d->agc_evt_wr;
+    }
+    d->agc_en = (res == 0) && (value != 0);
+    if (res)
+        return res;
+
+    res = _dev_m2_lm7_1_agc_attach(d);
+    if (res) {
+        d->agc_en = false;
+    }
+    return res;
+}
+
+int dev_m2_lm7_1_sdr_rx_agc_enable_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    *value = d->agc_en ? 1 : 0;
+    return 0;
+}
+
+// Mean power in dBFS, negative values are passed as signed
+int dev_m2_lm7_1_sdr_rx_agc_target_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    int target = (int)(int64_t)value;
+    if (target > 0 || target < -100)
+        return -EINVAL;
+
+    d->agc_params.target_dbfs = target;
+    d->agc.p.target_dbfs = target;
+    return 0;
+}
+
+// Gain reduction time constant in us
+int dev_m2_lm7_1_sdr_rx_agc_attack_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    d->agc_params.attack_us = value;
+    d->agc.p.attack_us = value;
+    return 0;
+}
+
+// Gain increase time constant in us
+int dev_m2_lm7_1_sdr_rx_agc_decay_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    d->agc_params.decay_us = value;
+    d->agc.p.decay_us = value;
+    return 0;
+}
+
+// Oldest unread gain change: sample timestamp [63:8], gain dB [7:0]; -ENOENT if none
+int dev_m2_lm7_1_sdr_rx_agc_event_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t* value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    int res = 0;
+
+    if (d->agc_evt_rd == d->agc_evt_wr) {
+        res = -ENOENT;
+    } else {
+        *value = d->agc_evt[d->agc_evt_rd++ % AGC_EVENTS];
+    }
+    return res;
+}
+
 int dev_m2_lm7_1_sdr_rxdsp_swapab_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t ovalue)
 {
     struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
@@ -897,6 +1351,12 @@ void usdr_device_m2_lm7_1_destroy(pdevice_t udev)
     if (d->tx) {
         d->tx->ops->destroy(d->tx);
     }
+    sfetrx4_pool_destroy(&d->pool);
+    pthread_mutex_destroy(&d->rfic_lock);
+
+    if (d->fe) {
+        device_fe_destroy(d->fe);
+    }
 
     xsdr_dtor(&d->xdev);
     USDR_LOG("UDEV", USDR_LOG_INFO, "m2_lm7_1_GPS: turnoff\n");
@@ -920,6 +1380,16 @@ int dev_m2_lm7_1_pwren_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
     return xsdr_pwren(&d->xdev, on);
 }
 
+// Save configured state to the file, restored on open with `snapshot=<file>`
+int dev_m2_lm7_1_snapshot_save_set(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    if (value <= 4096)
+        return -EINVAL;
+
+    return xsdr_snapshot_save(&d->xdev, (const char*)value);
+}
+
 int dev_m2_lm7_1_sensor_freqpps_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t *value)
 {
     struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
@@ -974,9 +1444,12 @@ int usdr_device_m2_lm7_1_initialize(pdevice_t udev, unsigned pcount, const char*
     lldev_t dev = d->base.dev;
     int res;
     const char* fe = NULL;
+    const char* snapshot = NULL;
+    unsigned pool_pktsyms = 0;
 
     d->bifurcation_en = false;
     d->nodecint = false;
+    d->gfir = false;
 
     for (unsigned i = 0; i < pcount; i++) {
         if (strcmp(devparam[i], "fe") == 0) {
@@ -988,6 +1461,15 @@ int usdr_device_m2_lm7_1_initialize(pdevice_t udev, unsigned pcount, const char*
         if (strcmp(devparam[i], "nodec") == 0) {
             d->nodecint = true;
         }
+        if (strcmp(devparam[i], "gfir") == 0) {
+            d->gfir = true;
+        }
+        if (strcmp(devparam[i], "streampool") == 0) {
+            pool_pktsyms = atoi(devval[i]);
+        }
+        if (strcmp(devparam[i], "snapshot") == 0) {
+            snapshot = devval[i];
+        }
     }
 
     res = xsdr_init(&d->xdev);
@@ -1002,6 +1484,15 @@ int usdr_device_m2_lm7_1_initialize(pdevice_t udev, unsigned pcount, const char*
         }
     }
 
+    if (snapshot) {
+        // Device stays usable in cold state when snapshot can't be applied
+        res = xsdr_snapshot_restore(&d->xdev, snapshot);
+        if (res) {
+            USDR_LOG("UDEV", USDR_LOG_WARNING, "Unable to restore snapshot `%s`, error %d\n",
+                     snapshot, res);
+        }
+    }
+
 #if 0
     //Load DSP ucode
     lowlevel_reg_wr32(dev, 0, 0, 0x02000001);
@@ -1017,6 +1508,29 @@ int usdr_device_m2_lm7_1_initialize(pdevice_t udev, unsigned pcount, const char*
     d->p_original_ops = lowlevel_get_ops(dev);
     dev->ops = &d->my_ops;
 
+    if (pool_pktsyms) {
+        // Preallocate MIMO RX buffers, so usdr_dms_create() is served from the pool
+        stream_handle_t* str;
+        unsigned hwchs;
+
+        res = sfetrx4_pool_create_stream(&d->pool, udev, CORE_SFERX_DMA32_R0, SFMT_CI16, 0x3, pool_pktsyms,
+                                         DMS_FLAG_NEED_FD, M2PCI_REG_WR_RXDMA_CONFIRM, VIRT_CFG_SFX_BASE,
+                                         SRF4_FIFOBSZ, CSR_RFE4_BASE, &str, &hwchs);
+        res = (res) ? res : sfetrx4_pool_release_stream(&d->pool, str);
+        if (res) {
+            USDR_LOG("UDEV", USDR_LOG_WARNING, "Unable to preallocate RX stream for %d samples, error %d\n",
+                     pool_pktsyms, res);
+        }
+    }
+
+    return 0;
+}
+
+static
+int dev_m2_lm7_1_stream_restart_get(pdevice_t ud, pusdr_vfs_obj_t obj, uint64_t *ovalue)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)ud;
+    *ovalue = d->pool.restart_ns;
     return 0;
 }
 
@@ -1089,12 +1603,21 @@ int usdr_device_m2_lm7_1_create_stream(device_t* dev, const char* sid, const cha
             }
         }
 
-        res = create_sfetrx4_stream(dev, CORE_SFERX_DMA32_R0, dformat, channels, pktsyms,
-                                    flags, M2PCI_REG_WR_RXDMA_CONFIRM, VIRT_CFG_SFX_BASE,
-                                    SRF4_FIFOBSZ, CSR_RFE4_BASE, &d->rx, &hwchs);
+        res = sfetrx4_pool_create_stream(&d->pool, dev, CORE_SFERX_DMA32_R0, dformat, channels, pktsyms,
+                                         flags, M2PCI_REG_WR_RXDMA_CONFIRM, VIRT_CFG_SFX_BASE,
+                                         SRF4_FIFOBSZ, CSR_RFE4_BASE, &d->rx, &hwchs);
         if (res) {
             return res;
         }
+        if (d->agc_en) {
+            rx_agc_init(&d->agc, &d->agc_params, d->xdev.s_rxrate, d->agc.gain_applied);
+
+            res = _dev_m2_lm7_1_agc_attach(d);
+            if (res) {
+                USDR_LOG("UDEV", USDR_LOG_WARNING, "RX AGC isn't available for `%s` format\n", dformat);
+                d->agc_en = false;
+            }
+        }
         *out_handle = d->rx;
     } else if (strstr(sid, "tx") != NULL) {
         if (d->tx) {
@@ -1119,9 +1642,9 @@ int usdr_device_m2_lm7_1_create_stream(device_t* dev, const char* sid, const cha
             flags |= DMS_FLAG_BIFURCATION;
         }
 
-        res = create_sfetrx4_stream(dev, CORE_SFETX_DMA32_R0, dformat, channels, pktsyms,
-                                    flags, M2PCI_REG_WR_TXDMA_CNF_L, VIRT_CFG_SFX_BASE + 512,
-                                    0, 0, &d->tx, &hwchs);
+        res = sfetrx4_pool_create_stream(&d->pool, dev, CORE_SFETX_DMA32_R0, dformat, channels, pktsyms,
+                                         flags, M2PCI_REG_WR_TXDMA_CNF_L, VIRT_CFG_SFX_BASE + 512,
+                                         0, 0, &d->tx, &hwchs);
         if (res) {
             return res;
         }
@@ -1137,22 +1660,82 @@ static
 int usdr_device_m2_lm7_1_unregister_stream(device_t* dev, stream_handle_t* stream)
 {
     struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)dev;
+    int res;
     if (stream == d->tx) {
-        d->tx->ops->destroy(d->tx);
+        res = sfetrx4_pool_release_stream(&d->pool, d->tx);
         d->tx = NULL;
     } else if (stream == d->rx) {
-        d->rx->ops->destroy(d->rx);
+        res = sfetrx4_pool_release_stream(&d->pool, d->rx);
         d->rx = NULL;
     } else {
         return -EINVAL;
     }
-    return 0;
+    return res;
+}
+
+
+static
+int usdr_device_m2_lm7_1_create_stream_locked(device_t* dev, const char* sid, const char* dformat,
+                                              uint64_t channels, unsigned pktsyms,
+                                              unsigned flags, stream_handle_t** out_handle)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)dev;
+    int res;
+
+    pthread_mutex_lock(&d->rfic_lock);
+    res = usdr_device_m2_lm7_1_create_stream(dev, sid, dformat, channels, pktsyms, flags, out_handle);
+    pthread_mutex_unlock(&d->rfic_lock);
+    return res;
+}
+
+static
+int usdr_device_m2_lm7_1_unregister_stream_locked(device_t* dev, stream_handle_t* stream)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)dev;
+    int res;
+
+    pthread_mutex_lock(&d->rfic_lock);
+    res = usdr_device_m2_lm7_1_unregister_stream(dev, stream);
+    pthread_mutex_unlock(&d->rfic_lock);
+    return res;
 }
 
+static int _dev_m2_lm7_1_vfs_set_locked(vfs_object_t* obj, uint64_t value)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)obj->object;
+    usdr_vfs_obj_ops_t* ops = (usdr_vfs_obj_ops_t*)obj->data.obj;
+    int res;
+
+    if (!ops->val_set)
+        return -ENOENT;
+
+    pthread_mutex_lock(&d->rfic_lock);
+    res = ops->val_set(&d->base, obj, value);
+    pthread_mutex_unlock(&d->rfic_lock);
+    return res;
+}
+
+static int _dev_m2_lm7_1_vfs_get_locked(vfs_object_t* obj, uint64_t* ovalue)
+{
+    struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)obj->object;
+    usdr_vfs_obj_ops_t* ops = (usdr_vfs_obj_ops_t*)obj->data.obj;
+    int res;
+
+    if (!ops->val_get)
+        return -ENOENT;
+
+    pthread_mutex_lock(&d->rfic_lock);
+    res = ops->val_get(&d->base, obj, ovalue);
+    pthread_mutex_unlock(&d->rfic_lock);
+    return res;
+}
 
 static
 int usdr_device_m2_lm7_1_create(lldev_t dev, device_id_t devid)
 {
+    pthread_mutexattr_t attr;
+    vfs_object_t *nodes;
+    unsigned fparams_idx;
     int res;
 
     struct dev_m2_lm7_1_gps *d = (struct dev_m2_lm7_1_gps *)malloc(sizeof(struct dev_m2_lm7_1_gps));
@@ -1172,19 +1755,47 @@ int usdr_device_m2_lm7_1_create(lldev_t dev, device_id_t devid)
     if (res)
         goto failed_tree_creation;
 
+    fparams_idx = d->base.rootfs.eparam[0];
     res = usdr_vfs_obj_param_init_array(&d->base,
                                         s_fparams_m2_lm7_1_rev000,
                                         SIZEOF_ARRAY(s_fparams_m2_lm7_1_rev000));
     if (res)
         goto failed_tree_creation;
 
+    // Parameters run under rfic_lock, RX AGC may change gain at any moment
+    nodes = (vfs_object_t *)d->base.rootfs.data.obj;
+    for (unsigned i = fparams_idx; i < d->base.rootfs.eparam[0]; i++) {
+        nodes[i].ops.si64 = &_dev_m2_lm7_1_vfs_set_locked;
+        nodes[i].ops.gi64 = &_dev_m2_lm7_1_vfs_get_locked;
+    }
+
     d->base.initialize = &usdr_device_m2_lm7_1_initialize;
     d->base.destroy = &usdr_device_m2_lm7_1_destroy;
-    d->base.create_stream = &usdr_device_m2_lm7_1_create_stream;
-    d->base.unregister_stream = &usdr_device_m2_lm7_1_unregister_stream;
+    d->base.create_stream = &usdr_device_m2_lm7_1_create_stream_locked;
+    d->base.unregister_stream = &usdr_device_m2_lm7_1_unregister_stream_locked;
     d->base.timer_op = &sfetrx4_stream_sync;
     d->rx = NULL;
     d->tx = NULL;
+    d->fe = NULL;
+    sfetrx4_pool_init(&d->pool);
+
+    d->tdd_trigger_armed = false;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&d->rfic_lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    d->agc_en = false;
+    d->agc_fullscale = 32767;
+    d->agc_params.target_dbfs = -20;
+    d->agc_params.hyst_db = 3;
+    d->agc_params.attack_us = 100;
+    d->agc_params.decay_us = 50000;
+    d->agc_params.holdoff_us = 200;
+    d->agc_params.gain_min = 0;
+    d->agc_params.gain_max = LMS7_RX_GAIN_MAX;
+    d->agc_evt_rd = 0;
+    d->agc_evt_wr = 0;
 
     dev->pdev = &d->base;
     return 0;
@@ -12,9 +12,12 @@
 #include <usdr_logging.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <math.h>
 #include <limits.h>
+#include <stdio.h>
+#include <time.h>
 
 #include "../cal/cal_lo_iqimb.h"
 #include "../ipblks/streams/sfe_rx_4.h"
@@ -36,6 +39,7 @@
 
 enum {
     XSDR_INT_REFCLK = 26000000,
+    XSDR_LMS8_LOB = 1010000000, // LMS7002M LO while LMS8001 upconverter is in use
 };
 
 // 1001011 - PDAC80501MDQFT
@@ -378,12 +382,14 @@ int xsdr_clk_debug_info(xsdr_dev_t *d)
 int xsdr_set_rx_port_switch(xsdr_dev_t *d, unsigned path)
 {
     USDR_LOG("XDEV", USDR_LOG_INFO, "RXSW:%d\n", path);
+    d->gpo_rxsw = path;
     return dev_gpo_set(d->base.lmsstate.dev, IGPO_RXSW, path);
 }
 
 int xsdr_set_tx_port_switch(xsdr_dev_t *d, unsigned path)
 {
     USDR_LOG("XDEV", USDR_LOG_INFO, "TXSW:%d\n", path);
+    d->gpo_txsw = path;
     return dev_gpo_set(d->base.lmsstate.dev, IGPO_TXSW, path);
 }
 
@@ -618,6 +624,14 @@ int xsdr_rfic_bb_set_badwidth(xsdr_dev_t *d,
     return lms7002m_bb_set_badwidth(&d->base, channel, dir_tx, bw, actualbw);
 }
 
+int xsdr_rfic_bb_set_gfir(xsdr_dev_t *d,
+                          unsigned channel,
+                          bool dir_tx,
+                          unsigned bw)
+{
+    return lms7002m_bb_set_gfir(&d->base, channel, dir_tx, bw);
+}
+
 int xsdr_rfic_set_gain(xsdr_dev_t *d,
                      unsigned channel,
                      unsigned gain_type,
@@ -635,7 +649,7 @@ int xsdr_rfic_fe_set_freq(xsdr_dev_t *d,
 {
     if (d->ssdr && freq > 3.7e9) {
         int res = 0;
-        d->lms7_lob = 1.01e9;
+        d->lms7_lob = XSDR_LMS8_LOB;
 
         res = res ? res : dev_gpo_set(d->base.lmsstate.dev, IGPO_LMS8_CTRL, 0x81);
         res = res ? res : lms8001_tune(&d->lms8, d->base.fref, freq - d->lms7_lob);
@@ -645,14 +659,162 @@ int xsdr_rfic_fe_set_freq(xsdr_dev_t *d,
             return res;
 
         USDR_LOG("XDEV", USDR_LOG_INFO, "Setting FREQ  %.3f Mhz, LNB %.3f Mhz\n", freq / 1.0e6, d->lms7_lob / 1.0e6);
-        freq = d->lms7_lob;
-    } else {
-        d->lms7_lob = 0;
+        res = lms7002m_fe_set_freq(&d->base, channel, type, d->lms7_lob, actualfreq);
+        if (res == 0 && actualfreq)
+            *actualfreq += freq - d->lms7_lob;
+        return res;
     }
 
+    d->lms7_lob = 0;
     return lms7002m_fe_set_freq(&d->base, channel, type, freq, actualfreq);
 }
 
+int xsdr_rfic_fe_preload_freq(xsdr_dev_t *d,
+                              double freq)
+{
+    int res = 0;
+    // Same split as xsdr_rfic_fe_set_freq() will use
+    uint64_t lo = freq - XSDR_LMS8_LOB;
+
+    if (!d->ssdr || freq <= 3.7e9)
+        return -EINVAL;
+
+    res = res ? res : dev_gpo_set(d->base.lmsstate.dev, IGPO_LMS8_CTRL, 0x81);
+    res = res ? res : lms8001_profile_preload(&d->lms8, d->base.fref, &lo, 1);
+
+    dev_gpo_set(d->base.lmsstate.dev, IGPO_LMS8_CTRL, 0x80);
+    return res;
+}
+
+
+// Part of the converter / decimator passband usable for NCO offsets
+#define XSDR_TUNE_IF_USABLE 0.8
+
+// Max NCO offset that keeps the whole host channel inside the converter
+// band and the explicitly set analog baseband filter. Filter in auto mode
+// is widened by _xsdr_tune_if_lpf() so it doesn't limit the span.
+static double _xsdr_tune_if_span(xsdr_dev_t *d, bool dir_tx)
+{
+    const lms7002_dev_t *b = &d->base;
+    unsigned cdiv = dir_tx ? b->txcgen_div : b->rxcgen_div;
+    unsigned tdiv = dir_tx ? b->txtsp_div : b->rxtsp_div;
+    unsigned hdiv = dir_tx ? b->tx_host_inter : b->rx_host_decim;
+    const opt_u32_t *bw = dir_tx ? b->tx_bw : b->rx_bw;
+
+    if (b->cgen_clk == 0 || cdiv == 0 || tdiv == 0 || hdiv == 0)
+        return 0;
+
+    double conv = (double)b->cgen_clk / cdiv;
+    double host = conv / tdiv / hdiv;
+    double lpf = conv;
+
+    for (unsigned i = 0; i < RFIC_CHANS; i++) {
+        if (bw[i].set && bw[i].value < lpf)
+            lpf = bw[i].value;
+    }
+
+    double span = lpf * XSDR_TUNE_IF_USABLE / 2 - host / 2;
+    return (span > 0) ? span : 0;
+}
+
+// Baseband filter in auto mode follows host rate, make it pass the channel
+// shifted by bb or return it back to the host rate when bb is 0
+static int _xsdr_tune_if_lpf(xsdr_dev_t *d, bool dir_tx, double bb)
+{
+    lms7002_dev_t *b = &d->base;
+    unsigned cdiv = dir_tx ? b->txcgen_div : b->rxcgen_div;
+    unsigned tdiv = dir_tx ? b->txtsp_div : b->rxtsp_div;
+    unsigned hdiv = dir_tx ? b->tx_host_inter : b->rx_host_decim;
+    const opt_u32_t *bw = dir_tx ? b->tx_bw : b->rx_bw;
+    const bool *run = dir_tx ? b->tx_run : b->rx_run;
+    int res = 0;
+
+    if (b->cgen_clk == 0 || cdiv == 0 || tdiv == 0 || hdiv == 0)
+        return 0;
+
+    unsigned lpf = b->cgen_clk / cdiv / tdiv / hdiv + 2 * fabs(bb);
+
+    for (unsigned i = 0; i < RFIC_CHANS && res == 0; i++) {
+        if (!run[i] || bw[i].set)
+            continue;
+
+        res = lms7002m_mac_set(&b->lmsstate, i == 0 ? LMS7_CH_A : LMS7_CH_B);
+        res = res ? res : (dir_tx ? lms7002m_tbb_bandwidth(b, lpf, false) :
+                                    lms7002m_rbb_bandwidth(b, lpf, false));
+    }
+    return res;
+}
+
+int xsdr_rfic_fe_tune(xsdr_dev_t *d,
+                      unsigned type,
+                      double freq,
+                      unsigned policy)
+{
+    bool rx = (type == RFIC_LMS7_TUNE_RX_FDD || type == RFIC_LMS7_TX_AND_RX_TDD);
+    bool tx = (type == RFIC_LMS7_TUNE_TX_FDD || type == RFIC_LMS7_TX_AND_RX_TDD);
+    int res;
+
+    if (!rx && !tx)
+        return -EINVAL;
+
+    if (policy == XSDR_TUNE_NCO_FIRST && freq != 0.0) {
+        double rf = d->tune_rf[rx ? 0 : 1];
+        double bb = freq - rf;
+        bool nco_only = (rf != 0.0) && !(rx && tx && d->tune_rf[0] != d->tune_rf[1]);
+
+        if (nco_only && rx && fabs(bb) > _xsdr_tune_if_span(d, false))
+            nco_only = false;
+        if (nco_only && tx && fabs(bb) > _xsdr_tune_if_span(d, true))
+            nco_only = false;
+
+        if (nco_only) {
+            res = 0;
+            res = (res || !rx) ? res : _xsdr_tune_if_lpf(d, false, bb);
+            res = (res || !tx) ? res : _xsdr_tune_if_lpf(d, true, bb);
+            res = (res || !rx) ? res : xsdr_rfic_bb_set_freq(d, LMS7_CH_AB, false, bb);
+            res = (res || !tx) ? res : xsdr_rfic_bb_set_freq(d, LMS7_CH_AB, true, bb);
+            if (res == 0) {
+                if (rx)
+                    d->tune_bb[0] = bb;
+                if (tx)
+                    d->tune_bb[1] = bb;
+
+                USDR_LOG("XDEV", USDR_LOG_INFO, "Tune %.6f MHz by NCO: RF %.6f MHz + BB %.3f kHz\n",
+                         freq / 1.0e6, rf / 1.0e6, bb / 1.0e3);
+                return 0;
+            }
+
+            USDR_LOG("XDEV", USDR_LOG_WARNING, "NCO retune failed, error %d; relocking RF\n", res);
+        }
+    }
+
+    double actual = freq;
+    res = xsdr_rfic_fe_set_freq(d, LMS7_CH_AB, type, freq, &actual);
+    if (res)
+        return res;
+
+    // NCO offsets of the next tunes are counted from the real LO
+    if (rx)
+        d->tune_rf[0] = actual;
+    if (tx)
+        d->tune_rf[1] = actual;
+
+    // Channel is centered again, otherwise NCO keeps user defined offset
+    if (policy == XSDR_TUNE_NCO_FIRST) {
+        res = (res || !rx || d->tune_bb[0] == 0.0) ? res : xsdr_rfic_bb_set_freq(d, LMS7_CH_AB, false, 0);
+        res = (res || !tx || d->tune_bb[1] == 0.0) ? res : xsdr_rfic_bb_set_freq(d, LMS7_CH_AB, true, 0);
+        res = (res || !rx || d->tune_bb[0] == 0.0) ? res : _xsdr_tune_if_lpf(d, false, 0);
+        res = (res || !tx || d->tune_bb[1] == 0.0) ? res : _xsdr_tune_if_lpf(d, true, 0);
+        if (res)
+            return res;
+
+        if (rx)
+            d->tune_bb[0] = 0;
+        if (tx)
+            d->tune_bb[1] = 0;
+    }
+    return 0;
+}
 
 int xsdr_rfic_rfe_set_path(xsdr_dev_t *d,
                            unsigned path)
@@ -818,7 +980,8 @@ int _xsdr_init_revx(xsdr_dev_t *d, unsigned hwid)
     }
 
     // Enable internal clocking by default
-    res = res ? res : dev_gpo_set(d->base.lmsstate.dev, IGPO_CLK_CFG, 1);
+    d->gpo_clk_cfg = 1;
+    res = res ? res : dev_gpo_set(d->base.lmsstate.dev, IGPO_CLK_CFG, d->gpo_clk_cfg);
     if (hwid == SSDR_DEV) {
         uint32_t chipver = ~0;
 
@@ -1162,6 +1325,7 @@ int xsdr_set_extref(xsdr_dev_t *d, bool ext, uint32_t freq)
 
     // TODO retrigger samplerate / TX / RX
 
+    d->gpo_clk_cfg = clk_cfg;
     return dev_gpo_set(d->base.lmsstate.dev, IGPO_CLK_CFG, clk_cfg);
 }
 
@@ -1617,3 +1781,512 @@ int xsdr_trim_dac_vctcxo(xsdr_dev_t *d, uint16_t val)
 
 
 
+
+// Device snapshot
+enum {
+    XSDR_SNAPSHOT_MAGIC = 0x504e5358, // "XSNP"
+    XSDR_SNAPSHOT_VERSION = 3,
+    XSDR_SNAPSHOT_SETTLE_US = 2000,
+};
+
+#define XSDR_LAYOUT(t, m) offsetof(t, m), sizeof(((t*)0)->m)
+
+static uint32_t _xsdr_snapshot_hash(uint32_t h, const void* data, size_t size)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+// Offsets and sizes of every field in the record
+uint32_t xsdr_snapshot_layout(void)
+{
+    static const uint32_t layout[] = {
+        XSDR_SNAPSHOT_VERSION,
+        sizeof(struct xsdr_snapshot_cfg),
+        sizeof(struct lms7002m_rfe_cfg), sizeof(struct lms7002m_rbb_cfg), sizeof(struct lms7002m_trf_cfg),
+        sizeof(lms7002m_limelight_conf_t), sizeof(lms7002m_lml_map_t),
+
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rfe),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rbb),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, trf),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, reg_mac),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, reg_en_dir),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, reg_rxtsp_dscpcfg),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, reg_rxtsp_dscmode),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, reg_rxtsp_hbdo_iq),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, reg_txtsp_dscpcfg),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, reg_txtsp_dscmode),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, reg_txtsp_hbdo_iq),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, reg_tbb_gc_corr),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, reg_tbb_gc),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, reg_rxgain),
+
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rx_cfg_path),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, tx_cfg_path),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, trf_lb_loss),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, trf_lb_atten),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, tx_loss),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rx_rfic_path),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, tx_rfic_path),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rx_lna_lb_active),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rx_gain_profile),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rx_gain),
+
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rxcgen_div),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, txcgen_div),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rxtsp_div),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, txtsp_div),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, tx_host_inter),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rx_host_decim),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rx_no_siso_map),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, tx_no_siso_map),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, lml_mode),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, map_rx),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, map_tx),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, lml_rx_chs),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, lml_rx_flags),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, lml_tx_chs),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, lml_tx_flags),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, s_rxrate),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, s_txrate),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, s_adcclk),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, s_dacclk),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, s_flags),
+
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, fref),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, cgen_clk),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rx_lo),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, tx_lo),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, lms7_lob),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, tune_policy),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, tune_rf),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, tune_bb),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rx_bw),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, tx_bw),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rx_dsp),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, tx_dsp),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rx_gfir_bw),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, tx_gfir_bw),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rx_bw_set),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, tx_bw_set),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rx_dsp_set),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, tx_dsp_set),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, rx_gfir_bw_set),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, tx_gfir_bw_set),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, gfir_auto),
+
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, gpo_clk_cfg),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, gpo_rxsw),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, gpo_txsw),
+        XSDR_LAYOUT(struct xsdr_snapshot_cfg, afe_active),
+    };
+
+    return _xsdr_snapshot_hash(2166136261u, layout, sizeof(layout));
+}
+
+static void _xsdr_opt_get(const opt_u32_t* opt, uint32_t* value, uint8_t* set)
+{
+    *set = 0;
+    for (unsigned i = 0; i < RFIC_CHANS; i++) {
+        value[i] = opt[i].value;
+        *set |= (opt[i].set ? 1 : 0) << i;
+    }
+}
+
+static void _xsdr_opt_set(opt_u32_t* opt, const uint32_t* value, uint8_t set)
+{
+    for (unsigned i = 0; i < RFIC_CHANS; i++) {
+        opt[i].value = value[i];
+        opt[i].set = (set >> i) & 1;
+    }
+}
+
+void xsdr_snapshot_cfg_get(const xsdr_dev_t *d, struct xsdr_snapshot_cfg *cfg)
+{
+    const lms7002m_state_t* m = &d->base.lmsstate;
+    const lms7002_dev_t* b = &d->base;
+
+    // Padding goes to the file and the checksum too
+    memset(cfg, 0, sizeof(*cfg));
+
+    memcpy(cfg->rfe, m->rfe, sizeof(cfg->rfe));
+    memcpy(cfg->rbb, m->rbb, sizeof(cfg->rbb));
+    memcpy(cfg->trf, m->trf, sizeof(cfg->trf));
+    cfg->reg_mac = m->reg_mac;
+    memcpy(cfg->reg_en_dir, m->reg_en_dir, sizeof(cfg->reg_en_dir));
+    memcpy(cfg->reg_rxtsp_dscpcfg, m->reg_rxtsp_dscpcfg, sizeof(cfg->reg_rxtsp_dscpcfg));
+    memcpy(cfg->reg_rxtsp_dscmode, m->reg_rxtsp_dscmode, sizeof(cfg->reg_rxtsp_dscmode));
+    memcpy(cfg->reg_rxtsp_hbdo_iq, m->reg_rxtsp_hbdo_iq, sizeof(cfg->reg_rxtsp_hbdo_iq));
+    memcpy(cfg->reg_txtsp_dscpcfg, m->reg_txtsp_dscpcfg, sizeof(cfg->reg_txtsp_dscpcfg));
+    memcpy(cfg->reg_txtsp_dscmode, m->reg_txtsp_dscmode, sizeof(cfg->reg_txtsp_dscmode));
+    memcpy(cfg->reg_txtsp_hbdo_iq, m->reg_txtsp_hbdo_iq, sizeof(cfg->reg_txtsp_hbdo_iq));
+    memcpy(cfg->reg_tbb_gc_corr, m->reg_tbb_gc_corr, sizeof(cfg->reg_tbb_gc_corr));
+    memcpy(cfg->reg_tbb_gc, m->reg_tbb_gc, sizeof(cfg->reg_tbb_gc));
+    memcpy(cfg->reg_rxgain, m->reg_rxgain, sizeof(cfg->reg_rxgain));
+
+    cfg->rx_cfg_path = b->rx_cfg_path;
+    cfg->tx_cfg_path = b->tx_cfg_path;
+    cfg->trf_lb_loss = b->trf_lb_loss;
+    cfg->trf_lb_atten = b->trf_lb_atten;
+    memcpy(cfg->tx_loss, b->tx_loss, sizeof(cfg->tx_loss));
+    cfg->rx_rfic_path = b->rx_rfic_path;
+    cfg->tx_rfic_path = b->tx_rfic_path;
+    cfg->rx_lna_lb_active = b->rx_lna_lb_active;
+    cfg->rx_gain_profile = b->rx_gain_profile;
+    cfg->rx_gain = b->rx_gain;
+
+    cfg->rxcgen_div = b->rxcgen_div;
+    cfg->txcgen_div = b->txcgen_div;
+    cfg->rxtsp_div = b->rxtsp_div;
+    cfg->txtsp_div = b->txtsp_div;
+    cfg->tx_host_inter = b->tx_host_inter;
+    cfg->rx_host_decim = b->rx_host_decim;
+    cfg->rx_no_siso_map = b->rx_no_siso_map;
+    cfg->tx_no_siso_map = b->tx_no_siso_map;
+    cfg->lml_mode = b->lml_mode;
+    cfg->map_rx = b->map_rx;
+    cfg->map_tx = b->map_tx;
+    cfg->lml_rx_chs = b->lml_rx_chs;
+    cfg->lml_rx_flags = b->lml_rx_flags;
+    cfg->lml_tx_chs = b->lml_tx_chs;
+    cfg->lml_tx_flags = b->lml_tx_flags;
+    cfg->s_rxrate = d->s_rxrate;
+    cfg->s_txrate = d->s_txrate;
+    cfg->s_adcclk = d->s_adcclk;
+    cfg->s_dacclk = d->s_dacclk;
+    cfg->s_flags = d->s_flags;
+
+    cfg->fref = b->fref;
+    cfg->cgen_clk = b->cgen_clk;
+    cfg->rx_lo = b->rx_lo;
+    cfg->tx_lo = b->tx_lo;
+    cfg->lms7_lob = d->lms7_lob;
+    cfg->tune_policy = d->tune_policy;
+    memcpy(cfg->tune_rf, d->tune_rf, sizeof(cfg->tune_rf));
+    memcpy(cfg->tune_bb, d->tune_bb, sizeof(cfg->tune_bb));
+    _xsdr_opt_get(b->rx_bw, cfg->rx_bw, &cfg->rx_bw_set);
+    _xsdr_opt_get(b->tx_bw, cfg->tx_bw, &cfg->tx_bw_set);
+    _xsdr_opt_get(b->rx_dsp, cfg->rx_dsp, &cfg->rx_dsp_set);
+    _xsdr_opt_get(b->tx_dsp, cfg->tx_dsp, &cfg->tx_dsp_set);
+    _xsdr_opt_get(b->rx_gfir_bw, cfg->rx_gfir_bw, &cfg->rx_gfir_bw_set);
+    _xsdr_opt_get(b->tx_gfir_bw, cfg->tx_gfir_bw, &cfg->tx_gfir_bw_set);
+    cfg->gfir_auto = b->gfir_auto;
+
+    cfg->gpo_clk_cfg = d->gpo_clk_cfg;
+    cfg->gpo_rxsw = d->gpo_rxsw;
+    cfg->gpo_txsw = d->gpo_txsw;
+    cfg->afe_active = d->afe_active;
+}
+
+int xsdr_snapshot_write(const xsdr_dev_t *d, const uint32_t* regs, unsigned cnt, const char* path)
+{
+    struct xsdr_snapshot_hdr hdr;
+    struct xsdr_snapshot_cfg cfg;
+    char tmp[PATH_MAX];
+    FILE* f;
+    int res;
+
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp))
+        return -ENAMETOOLONG;
+
+    xsdr_snapshot_cfg_get(d, &cfg);
+
+    hdr.magic = XSDR_SNAPSHOT_MAGIC;
+    hdr.version = XSDR_SNAPSHOT_VERSION;
+    hdr.layout = xsdr_snapshot_layout();
+    hdr.hwid = d->hwid;
+    hdr.state_size = sizeof(cfg);
+    hdr.regs_cnt = cnt;
+    hdr.checksum = _xsdr_snapshot_hash(2166136261u, &cfg, sizeof(cfg));
+    hdr.checksum = _xsdr_snapshot_hash(hdr.checksum, regs, cnt * sizeof(uint32_t));
+
+    f = fopen(tmp, "wb");
+    if (!f)
+        return -errno;
+
+    res = (fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+           fwrite(&cfg, sizeof(cfg), 1, f) == 1 &&
+           fwrite(regs, sizeof(uint32_t), cnt, f) == cnt) ? 0 : -EIO;
+    if (fclose(f) && !res)
+        res = -EIO;
+
+    // Replace old snapshot only when the new one is complete
+    if (!res && rename(tmp, path))
+        res = -errno;
+    if (res)
+        remove(tmp);
+    return res;
+}
+
+int xsdr_snapshot_read(const char* path, uint32_t hwid, struct xsdr_snapshot_cfg *cfg, uint32_t* regs, unsigned max)
+{
+    struct xsdr_snapshot_hdr hdr;
+    uint32_t checksum;
+    FILE* f;
+    int res;
+
+    f = fopen(path, "rb");
+    if (!f)
+        return -errno;
+
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 || hdr.magic != XSDR_SNAPSHOT_MAGIC ||
+        hdr.version != XSDR_SNAPSHOT_VERSION) {
+        USDR_LOG("XDEV", USDR_LOG_WARNING, "Snapshot `%s` has unknown format\n", path);
+        res = -EINVAL;
+        goto failed;
+    }
+    if (hdr.layout != xsdr_snapshot_layout() || hdr.state_size != sizeof(*cfg)) {
+        USDR_LOG("XDEV", USDR_LOG_WARNING, "Snapshot `%s` layout %08x doesn't match this build %08x\n",
+                 path, hdr.layout, xsdr_snapshot_layout());
+        res = -EINVAL;
+        goto failed;
+    }
+    if (hdr.regs_cnt > max) {
+        res = -E2BIG;
+        goto failed;
+    }
+    if (hdr.hwid != hwid) {
+        USDR_LOG("XDEV", USDR_LOG_WARNING, "Snapshot `%s` was taken on HWID %08x, device is %08x\n",
+                 path, hdr.hwid, hwid);
+        res = -ESTALE;
+        goto failed;
+    }
+
+    if (fread(cfg, sizeof(*cfg), 1, f) != 1 ||
+        fread(regs, sizeof(uint32_t), hdr.regs_cnt, f) != hdr.regs_cnt) {
+        res = -EIO;
+        goto failed;
+    }
+
+    checksum = _xsdr_snapshot_hash(2166136261u, cfg, sizeof(*cfg));
+    checksum = _xsdr_snapshot_hash(checksum, regs, hdr.regs_cnt * sizeof(uint32_t));
+    if (checksum != hdr.checksum) {
+        USDR_LOG("XDEV", USDR_LOG_WARNING, "Snapshot `%s` is corrupted\n", path);
+        res = -EINVAL;
+        goto failed;
+    }
+    res = (int)hdr.regs_cnt;
+
+failed:
+    fclose(f);
+    return res;
+}
+
+int xsdr_snapshot_save(xsdr_dev_t *d, const char* path)
+{
+    uint32_t* regs;
+    int res, cnt;
+
+    if (!d->pwr_en)
+        return -EINVAL;
+
+    regs = (uint32_t*)malloc(LMS7002M_DUMP_MAX * sizeof(uint32_t));
+    if (!regs)
+        return -ENOMEM;
+
+    res = cnt = lms7002m_regs_dump(&d->base.lmsstate, regs, LMS7002M_DUMP_MAX);
+    if (cnt >= 0) {
+        res = xsdr_snapshot_write(d, regs, cnt, path);
+        USDR_LOG("XDEV", (res) ? USDR_LOG_ERROR : USDR_LOG_INFO, "Snapshot `%s`: %d registers saved, res=%d\n",
+                 path, cnt, res);
+    }
+
+    free(regs);
+    return res;
+}
+
+// Only the recorded configuration is taken, everything else stays as opened
+static int _xsdr_snapshot_apply(xsdr_dev_t *d, const struct xsdr_snapshot_cfg *cfg)
+{
+    lms7002m_state_t* m = &d->base.lmsstate;
+    lms7002_dev_t* b = &d->base;
+    int res;
+
+    // Gain table is derived from the profile, it's not part of the record
+    res = lms7002m_rx_gain_table_build(b, cfg->rx_gain_profile);
+    if (res)
+        return res;
+
+    memcpy(m->rfe, cfg->rfe, sizeof(m->rfe));
+    memcpy(m->rbb, cfg->rbb, sizeof(m->rbb));
+    memcpy(m->trf, cfg->trf, sizeof(m->trf));
+    m->reg_mac = cfg->reg_mac;
+    memcpy(m->reg_en_dir, cfg->reg_en_dir, sizeof(m->reg_en_dir));
+    memcpy(m->reg_rxtsp_dscpcfg, cfg->reg_rxtsp_dscpcfg, sizeof(m->reg_rxtsp_dscpcfg));
+    memcpy(m->reg_rxtsp_dscmode, cfg->reg_rxtsp_dscmode, sizeof(m->reg_rxtsp_dscmode));
+    memcpy(m->reg_rxtsp_hbdo_iq, cfg->reg_rxtsp_hbdo_iq, sizeof(m->reg_rxtsp_hbdo_iq));
+    memcpy(m->reg_txtsp_dscpcfg, cfg->reg_txtsp_dscpcfg, sizeof(m->reg_txtsp_dscpcfg));
+    memcpy(m->reg_txtsp_dscmode, cfg->reg_txtsp_dscmode, sizeof(m->reg_txtsp_dscmode));
+    memcpy(m->reg_txtsp_hbdo_iq, cfg->reg_txtsp_hbdo_iq, sizeof(m->reg_txtsp_hbdo_iq));
+    memcpy(m->reg_tbb_gc_corr, cfg->reg_tbb_gc_corr, sizeof(m->reg_tbb_gc_corr));
+    memcpy(m->reg_tbb_gc, cfg->reg_tbb_gc, sizeof(m->reg_tbb_gc));
+    memcpy(m->reg_rxgain, cfg->reg_rxgain, sizeof(m->reg_rxgain));
+
+    b->rx_cfg_path = cfg->rx_cfg_path;
+    b->tx_cfg_path = cfg->tx_cfg_path;
+    b->trf_lb_loss = cfg->trf_lb_loss;
+    b->trf_lb_atten = cfg->trf_lb_atten;
+    memcpy(b->tx_loss, cfg->tx_loss, sizeof(b->tx_loss));
+    b->rx_rfic_path = (rfic_lms7_rf_path_t)cfg->rx_rfic_path;
+    b->tx_rfic_path = (rfic_lms7_rf_path_t)cfg->tx_rfic_path;
+    b->rx_lna_lb_active = cfg->rx_lna_lb_active;
+    b->rx_gain = cfg->rx_gain;
+
+    b->rxcgen_div = cfg->rxcgen_div;
+    b->txcgen_div = cfg->txcgen_div;
+    b->rxtsp_div = cfg->rxtsp_div;
+    b->txtsp_div = cfg->txtsp_div;
+    b->tx_host_inter = cfg->tx_host_inter;
+    b->rx_host_decim = cfg->rx_host_decim;
+    b->rx_no_siso_map = cfg->rx_no_siso_map;
+    b->tx_no_siso_map = cfg->tx_no_siso_map;
+    b->lml_mode = cfg->lml_mode;
+    b->map_rx = cfg->map_rx;
+    b->map_tx = cfg->map_tx;
+    b->lml_rx_chs = cfg->lml_rx_chs;
+    b->lml_rx_flags = cfg->lml_rx_flags;
+    b->lml_tx_chs = cfg->lml_tx_chs;
+    b->lml_tx_flags = cfg->lml_tx_flags;
+    d->s_rxrate = cfg->s_rxrate;
+    d->s_txrate = cfg->s_txrate;
+    d->s_adcclk = cfg->s_adcclk;
+    d->s_dacclk = cfg->s_dacclk;
+    d->s_flags = cfg->s_flags;
+
+    b->fref = cfg->fref;
+    b->cgen_clk = cfg->cgen_clk;
+    b->rx_lo = cfg->rx_lo;
+    b->tx_lo = cfg->tx_lo;
+    d->lms7_lob = cfg->lms7_lob;
+    d->tune_policy = cfg->tune_policy;
+    memcpy(d->tune_rf, cfg->tune_rf, sizeof(d->tune_rf));
+    memcpy(d->tune_bb, cfg->tune_bb, sizeof(d->tune_bb));
+    _xsdr_opt_set(b->rx_bw, cfg->rx_bw, cfg->rx_bw_set);
+    _xsdr_opt_set(b->tx_bw, cfg->tx_bw, cfg->tx_bw_set);
+    _xsdr_opt_set(b->rx_dsp, cfg->rx_dsp, cfg->rx_dsp_set);
+    _xsdr_opt_set(b->tx_dsp, cfg->tx_dsp, cfg->tx_dsp_set);
+    _xsdr_opt_set(b->rx_gfir_bw, cfg->rx_gfir_bw, cfg->rx_gfir_bw_set);
+    _xsdr_opt_set(b->tx_gfir_bw, cfg->tx_gfir_bw, cfg->tx_gfir_bw_set);
+    b->gfir_auto = cfg->gfir_auto;
+
+    d->gpo_clk_cfg = cfg->gpo_clk_cfg;
+    d->gpo_rxsw = cfg->gpo_rxsw;
+    d->gpo_txsw = cfg->gpo_txsw;
+    d->afe_active = cfg->afe_active;
+    d->pwr_en = true;
+    return 0;
+}
+
+static int _xsdr_snapshot_warm(xsdr_dev_t *d, const struct xsdr_snapshot_cfg *cfg,
+                               const uint32_t* regs, unsigned cnt)
+{
+    lldev_t dev = d->base.lmsstate.dev;
+    unsigned plls = 0, unlocked = 0;
+    int res;
+
+    // Reference selection goes first, CGEN locks right after register load
+    res = dev_gpo_set(dev, IGPO_CLK_CFG, cfg->gpo_clk_cfg);
+    res = res ? res : xsdr_pwren(d, true);
+    res = res ? res : lms7002m_regs_load(&d->base.lmsstate, regs, cnt);
+    if (res)
+        return res;
+
+    res = _xsdr_snapshot_apply(d, cfg);
+    res = res ? res : dev_gpo_set(dev, IGPO_RXSW, d->gpo_rxsw);
+    res = res ? res : dev_gpo_set(dev, IGPO_TXSW, d->gpo_txsw);
+    res = res ? res : lms7002m_regs_verify(&d->base.lmsstate, regs, cnt);
+    if (res)
+        return res;
+
+    usleep(XSDR_SNAPSHOT_SETTLE_US);
+
+    plls |= (d->base.cgen_clk) ? LMS7002M_PLL_CGEN : 0;
+    plls |= (d->base.rx_lo) ? LMS7002M_PLL_SXR : 0;
+    plls |= (d->base.tx_lo) ? LMS7002M_PLL_SXT : 0;
+
+    res = lms7002m_pll_check(&d->base.lmsstate, plls, &unlocked);
+    if (res)
+        return res;
+    if (unlocked) {
+        USDR_LOG("XDEV", USDR_LOG_WARNING, "Snapshot: PLLs %x aren't locked\n", unlocked);
+        return -ESTALE;
+    }
+    return 0;
+}
+
+// Regular bring-up with parameters recorded in the snapshot
+static int _xsdr_snapshot_replay(xsdr_dev_t *d, const struct xsdr_snapshot_cfg *cfg)
+{
+    int res = 0;
+
+    res = res ? res : xsdr_set_extref(d, cfg->gpo_clk_cfg & 2, cfg->fref);
+    res = res ? res : xsdr_pwren(d, true);
+    if (cfg->s_rxrate || cfg->s_txrate) {
+        res = res ? res : xsdr_set_samplerate_ex(d, cfg->s_rxrate, cfg->s_txrate,
+                                                 cfg->s_adcclk, cfg->s_dacclk, cfg->s_flags);
+    }
+    if (cfg->rx_lo) {
+        res = res ? res : xsdr_rfic_fe_set_freq(d, LMS7_CH_AB, RFIC_LMS7_TUNE_RX_FDD, cfg->rx_lo, NULL);
+    }
+    if (cfg->tx_lo) {
+        res = res ? res : xsdr_rfic_fe_set_freq(d, LMS7_CH_AB, RFIC_LMS7_TUNE_TX_FDD, cfg->tx_lo, NULL);
+    }
+    for (unsigned i = 0; i < RFIC_CHANS; i++) {
+        unsigned ch = (i == 0) ? LMS7_CH_A : LMS7_CH_B;
+        if ((cfg->rx_bw_set >> i) & 1) {
+            res = res ? res : xsdr_rfic_bb_set_badwidth(d, ch, false, cfg->rx_bw[i], NULL);
+        }
+        if ((cfg->tx_bw_set >> i) & 1) {
+            res = res ? res : xsdr_rfic_bb_set_badwidth(d, ch, true, cfg->tx_bw[i], NULL);
+        }
+    }
+    res = res ? res : xsdr_set_rx_port_switch(d, cfg->gpo_rxsw);
+    res = res ? res : xsdr_set_tx_port_switch(d, cfg->gpo_txsw);
+    return res;
+}
+
+int xsdr_snapshot_restore(xsdr_dev_t *d, const char* path)
+{
+    struct timespec start, stop;
+    struct xsdr_snapshot_cfg cfg;
+    xsdr_dev_t *live;
+    uint32_t* regs;
+    int res, cnt;
+
+    live = (xsdr_dev_t*)malloc(sizeof(xsdr_dev_t));
+    regs = (uint32_t*)malloc(LMS7002M_DUMP_MAX * sizeof(uint32_t));
+    if (!live || !regs) {
+        res = -ENOMEM;
+        goto failed_free;
+    }
+
+    // Incompatible file leaves the device untouched in cold state
+    res = cnt = xsdr_snapshot_read(path, d->hwid, &cfg, regs, LMS7002M_DUMP_MAX);
+    if (cnt < 0)
+        goto failed_free;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    // In-process copy of the cold state to roll back to, it's never stored
+    memcpy(live, d, sizeof(*d));
+
+    res = _xsdr_snapshot_warm(d, &cfg, regs, cnt);
+    if (res) {
+        USDR_LOG("XDEV", USDR_LOG_WARNING, "Snapshot `%s` verification failed (%d), doing full initialization\n",
+                 path, res);
+
+        memcpy(d, live, sizeof(*d));
+        res = _xsdr_snapshot_replay(d, &cfg);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    USDR_LOG("XDEV", USDR_LOG_INFO, "Snapshot `%s` restored in %d us, res=%d\n", path,
+             (int)((stop.tv_sec - start.tv_sec) * 1000000 + (stop.tv_nsec - start.tv_nsec) / 1000), res);
+
+failed_free:
+    free(regs);
+    free(live);
+    return res;
+}
@@ -49,6 +49,16 @@ struct xsdr_dev
 
     unsigned lms7_lob;
 
+    // Last written board GPO, there's no readback for them
+    uint8_t gpo_clk_cfg;
+    uint8_t gpo_rxsw;
+    uint8_t gpo_txsw;
+
+    // Frequency split applied by xsdr_rfic_fe_tune(), tuned frequency is rf + bb
+    unsigned tune_policy;
+    double tune_rf[2]; // RX, TX
+    double tune_bb[2];
+
     bool afe_active;
     bool siso_sdr_active_rx;
     bool siso_sdr_active_tx;
@@ -94,6 +104,11 @@ int xsdr_rfic_bb_set_badwidth(xsdr_dev_t *d,
                               unsigned bw,
                               unsigned* actualbw);
 
+int xsdr_rfic_bb_set_gfir(xsdr_dev_t *d,
+                          unsigned channel,
+                          bool dir_tx,
+                          unsigned bw);
+
 int xsdr_rfic_set_gain(xsdr_dev_t *d,
                        unsigned channel,
                        unsigned gain_type,
@@ -106,6 +121,22 @@ int xsdr_rfic_fe_set_freq(xsdr_dev_t *d,
                           double freq,
                           double *actualfreq);
 
+enum xsdr_tune_policy {
+    XSDR_TUNE_RF_ONLY = 0,   // Always relock RF synthesizer, NCO is left untouched
+    XSDR_TUNE_NCO_FIRST = 1, // Move NCO only while the channel stays within usable IF bandwidth
+};
+
+// Tune RX/TX/TDD frequency according to policy, resulting split is in tune_rf / tune_bb
+int xsdr_rfic_fe_tune(xsdr_dev_t *d,
+                      unsigned type,
+                      double freq,
+                      unsigned policy);
+
+// Calibrate LMS8001 PLL profile for the frequency in advance, so later
+// xsdr_rfic_fe_set_freq() only switches the profile
+int xsdr_rfic_fe_preload_freq(xsdr_dev_t *d,
+                              double freq);
+
 int xsdr_rfic_fe_set_lna(xsdr_dev_t *d,
                          unsigned channel,
                          //unsigned dir,
@@ -170,6 +201,117 @@ int xsdr_calibrate(xsdr_dev_t *d, unsigned channel, unsigned param, int* sarray)
 
 int xsdr_trspi_lms8(xsdr_dev_t *d, uint32_t out, uint32_t* in);
 
+// Configured device state: host side context, board GPO and LMS7002M register
+// image. Restore powers up RFIC and loads registers directly, checking only
+// readback of PLL registers and lock status. On mismatch the device is brought
+// up through the regular configuration calls instead.
+int xsdr_snapshot_save(xsdr_dev_t *d, const char* path);
+int xsdr_snapshot_restore(xsdr_dev_t *d, const char* path);
+
+// Configuration record stored in the snapshot. Only plain configuration values
+// are listed here, runtime bindings, callbacks and detected hardware always
+// come from the live device. Any change here needs XSDR_SNAPSHOT_VERSION bump.
+struct xsdr_snapshot_cfg {
+    // LMS7002M host side shadows of the loaded register image
+    struct lms7002m_rfe_cfg rfe[2];
+    struct lms7002m_rbb_cfg rbb[2];
+    struct lms7002m_trf_cfg trf[2];
+    uint16_t reg_mac;
+    uint16_t reg_en_dir[2];
+    uint16_t reg_rxtsp_dscpcfg[2];
+    uint16_t reg_rxtsp_dscmode[2];
+    uint16_t reg_rxtsp_hbdo_iq[2];
+    uint16_t reg_txtsp_dscpcfg[2];
+    uint16_t reg_txtsp_dscmode[2];
+    uint16_t reg_txtsp_hbdo_iq[2];
+    int8_t   reg_tbb_gc_corr[2];
+    uint8_t  reg_tbb_gc[2];
+    uint16_t reg_rxgain[2][3];
+
+    // Paths and gains
+    uint8_t rx_cfg_path;
+    uint8_t tx_cfg_path;
+    uint8_t trf_lb_loss;
+    uint8_t trf_lb_atten;
+    uint8_t tx_loss[2];
+    uint8_t rx_rfic_path;
+    uint8_t tx_rfic_path;
+    uint8_t rx_lna_lb_active;
+    uint8_t rx_gain_profile;
+    int32_t rx_gain;
+
+    // Rates, dividers and data path
+    uint8_t rxcgen_div;
+    uint8_t txcgen_div;
+    uint8_t rxtsp_div;
+    uint8_t txtsp_div;
+    uint8_t tx_host_inter;
+    uint8_t rx_host_decim;
+    uint8_t rx_no_siso_map;
+    uint8_t tx_no_siso_map;
+    lms7002m_limelight_conf_t lml_mode;
+    lms7002m_lml_map_t map_rx;
+    lms7002m_lml_map_t map_tx;
+    uint32_t lml_rx_chs;
+    uint32_t lml_rx_flags;
+    uint32_t lml_tx_chs;
+    uint32_t lml_tx_flags;
+    uint32_t s_rxrate;
+    uint32_t s_txrate;
+    uint32_t s_adcclk;
+    uint32_t s_dacclk;
+    uint32_t s_flags;
+
+    // Frequencies and bandwidths, bit N of *_set marks channel N as valid
+    uint32_t fref;
+    uint32_t cgen_clk;
+    uint32_t rx_lo;
+    uint32_t tx_lo;
+    uint32_t lms7_lob;
+    uint32_t tune_policy;
+    double tune_rf[2];
+    double tune_bb[2];
+    uint32_t rx_bw[RFIC_CHANS];
+    uint32_t tx_bw[RFIC_CHANS];
+    uint32_t rx_dsp[RFIC_CHANS];
+    uint32_t tx_dsp[RFIC_CHANS];
+    uint32_t rx_gfir_bw[RFIC_CHANS];
+    uint32_t tx_gfir_bw[RFIC_CHANS];
+    uint8_t rx_bw_set;
+    uint8_t tx_bw_set;
+    uint8_t rx_dsp_set;
+    uint8_t tx_dsp_set;
+    uint8_t rx_gfir_bw_set;
+    uint8_t tx_gfir_bw_set;
+    uint8_t gfir_auto;
+
+    // Board
+    uint8_t gpo_clk_cfg;
+    uint8_t gpo_rxsw;
+    uint8_t gpo_txsw;
+    uint8_t afe_active;
+};
+
+// Snapshot file header, followed by struct xsdr_snapshot_cfg and register image.
+// Files are accepted only when version and record layout match this build.
+struct xsdr_snapshot_hdr {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t layout;     // xsdr_snapshot_layout() of the writer
+    uint32_t hwid;
+    uint32_t state_size; // sizeof(struct xsdr_snapshot_cfg)
+    uint32_t regs_cnt;
+    uint32_t checksum;   // FNV-1a over record and register image
+};
+
+uint32_t xsdr_snapshot_layout(void);
+
+void xsdr_snapshot_cfg_get(const xsdr_dev_t *d, struct xsdr_snapshot_cfg *cfg);
+
+// File level part of save/restore, read returns number of registers
+int xsdr_snapshot_write(const xsdr_dev_t *d, const uint32_t* regs, unsigned cnt, const char* path);
+int xsdr_snapshot_read(const char* path, uint32_t hwid, struct xsdr_snapshot_cfg *cfg, uint32_t* regs, unsigned max);
+
 #ifndef NO_IGPO
 
 enum {
@@ -5,11 +5,17 @@
 #include <string.h>
 #include <stdio.h>
 #include <poll.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <math.h>
 
 #include "device.h"
 #include "device_vfs.h"
 
 #include "../ipblks/streams/streams_api.h"
+#include "../common/wb_stitch.h"
 
 #include "mdev.h"
 
@@ -25,6 +31,8 @@ static int _mdev_stream_sync(device_t* device,
 
 #define DEV_MAX 32
 #define STREAMS_MAX 2
+#define STITCH_HOP_MAX 2048
+#define CHANS_MAX 64
 
 struct stream_mdev {
     stream_handle_t base;
@@ -41,10 +49,30 @@ struct stream_mdev {
     unsigned pkt_bytes;
     unsigned pkt_symbs;
 
-    // Stat
+    // Stitched wideband RX, one channel per board is combined to a single output
+    wb_stitch_t* stitch;
+    float* stitch_buf[DEV_MAX];
+
+    // Stat, per channel statistics of all boards in the channel order
+    struct usdr_dms_ch_stat ch_stat[CHANS_MAX];
 };
 typedef struct stream_mdev stream_mdev_t;
 
+// Executes VFS get/set on a child device for the parallel broadcast
+struct mdev_worker {
+    pthread_t thread;
+    sem_t start;
+    sem_t done;
+    bool quit;
+
+    pdevice_t dev;
+    const char* path;
+    bool get;
+    uint64_t value;
+    int res;
+};
+typedef struct mdev_worker mdev_worker_t;
+
 struct dev_multi {
     // Virtual lowlevel
     lowlevel_dev_t lldev;
@@ -65,6 +93,30 @@ struct dev_multi {
     stream_handle_t* real_str_rx[DEV_MAX];
     stream_handle_t* real_str_tx[DEV_MAX];
 
+    // Last start measurement, skew is in samples relative to the latest started board
+    bool sync_valid;
+    uint32_t sync_ts[DEV_MAX];
+    int64_t sync_skew[DEV_MAX];
+    int64_t sync_spread;
+
+    // Parallel VFS broadcast, child 0 is always served by the calling thread
+    pthread_mutex_t bcast_lock;
+    mdev_worker_t workers[DEV_MAX];
+    unsigned workers_cnt;
+    int bcast_res[DEV_MAX];  // Per child result of the last broadcast
+    uint32_t bcast_failed;   // Mask of children failed the last broadcast
+    uint32_t bcast_diverged; // Mask of children with value different from child 0 on the last aggregated get
+
+    // Stitched wideband RX, boards are tuned around stitch_freq stitch_spacing Hz apart
+    uint64_t rate;           // RX rate common to all boards, 0 if unknown or different
+    uint64_t board_rate[DEV_MAX]; // Last RX rate set on every board
+    uint64_t stitch_freq;
+    uint64_t stitch_spacing; // 0 - regular multichannel RX
+    unsigned stitch_fftsz;
+    unsigned stitch_bins;    // Effective spacing, rate / stitch_fftsz units
+    int32_t stitch_gain[DEV_MAX];  // Board gain correction, mdB
+    int32_t stitch_phase[DEV_MAX]; // Board phase correction, mdeg
+
     // FIXUP! Remove me after fixing vfs operations
     vfs_object_t vfs_obj;
 };
@@ -86,11 +138,15 @@ int mdev_generic_get(lldev_t dev, int generic_op, const char** pout)
     return -EINVAL;
 }
 
+static void _mdev_workers_stop(dev_multi_t* obj);
+
 static
 int mdev_generic_destroy(lldev_t dev)
 {
     dev_multi_t* obj =  container_of(dev, dev_multi_t, lldev);
 
+    _mdev_workers_stop(obj);
+
     // Causes double free
     //for (unsigned i = 0; i < STREAMS_MAX; i++) {
     //    _mdev_unregister_stream(&obj->virt_dev, &obj->streams[i].base);
@@ -136,18 +192,288 @@ struct lowlevel_ops s_mdev_ops = {
 
 
 
+static int _mdev_job_exec(mdev_worker_t* w)
+{
+    return w->get ? usdr_device_vfs_obj_val_get_u64(w->dev, w->path, &w->value) :
+                    usdr_device_vfs_obj_val_set_by_path(w->dev, w->path, w->value);
+}
+
+static void* _mdev_worker_thread(void* param)
+{
+    mdev_worker_t* w = (mdev_worker_t*)param;
+
+    for (;;) {
+        while (sem_wait(&w->start) == -1 && errno == EINTR);
+        if (w->quit)
+            break;
+
+        w->res = _mdev_job_exec(w);
+        sem_post(&w->done);
+    }
+    return NULL;
+}
+
+static void _mdev_workers_start(dev_multi_t* obj)
+{
+    pthread_mutex_init(&obj->bcast_lock, NULL);
+
+    for (unsigned i = 1; i < obj->cnt; i++) {
+        mdev_worker_t* w = &obj->workers[i];
+        w->quit = false;
+        sem_init(&w->start, 0, 0);
+        sem_init(&w->done, 0, 0);
+
+        if (pthread_create(&w->thread, NULL, _mdev_worker_thread, w)) {
+            USDR_LOG("MDEV", USDR_LOG_WARNING, "Unable to start worker for device %d, remaining devices are updated serially\n", i);
+            sem_destroy(&w->start);
+            sem_destroy(&w->done);
+            break;
+        }
+        obj->workers_cnt = i;
+    }
+}
+
+static void _mdev_workers_stop(dev_multi_t* obj)
+{
+    for (unsigned i = 1; i <= obj->workers_cnt; i++) {
+        mdev_worker_t* w = &obj->workers[i];
+        w->quit = true;
+        sem_post(&w->start);
+        pthread_join(w->thread, NULL);
+        sem_destroy(&w->start);
+        sem_destroy(&w->done);
+    }
+    obj->workers_cnt = 0;
+    pthread_mutex_destroy(&obj->bcast_lock);
+}
+
+// Get or set the path on every child concurrently, values[] holds a value per child.
+// All children are processed regardless of errors, the first error is returned
+static int _mdev_broadcast(dev_multi_t* obj, const char* path, bool get, uint64_t* values)
+{
+    int res = 0;
+    unsigned i;
+
+    pthread_mutex_lock(&obj->bcast_lock);
+    for (i = 0; i < obj->cnt; i++) {
+        mdev_worker_t* w = &obj->workers[i];
+        w->dev = obj->real[i]->pdev;
+        w->path = path;
+        w->get = get;
+        w->value = values[i];
+
+        if (i > 0 && i <= obj->workers_cnt) {
+            sem_post(&w->start);
+        }
+    }
+
+    for (i = 0; i < obj->cnt; i++) {
+        if (i == 0 || i > obj->workers_cnt) {
+            obj->workers[i].res = _mdev_job_exec(&obj->workers[i]);
+        }
+    }
+
+    obj->bcast_failed = 0;
+    for (i = 0; i < obj->cnt; i++) {
+        mdev_worker_t* w = &obj->workers[i];
+        if (i > 0 && i <= obj->workers_cnt) {
+            while (sem_wait(&w->done) == -1 && errno == EINTR);
+        }
+
+        values[i] = w->value;
+        obj->bcast_res[i] = w->res;
+        if (w->res) {
+            USDR_LOG("MDEV", USDR_LOG_WARNING, "MDEV device %d: unable to %s %s, error %d\n",
+                     i, get ? "get" : "set", path, w->res);
+            obj->bcast_failed |= 1u << i;
+            res = res ? res : w->res;
+        }
+    }
+    pthread_mutex_unlock(&obj->bcast_lock);
+    return res;
+}
+
+// Per child access through /dm/mdev/<n>/<child path>
+static bool _mdev_child_path(dev_multi_t* obj, const char* path, unsigned* idx, const char** child_path)
+{
+    int n = 0;
+    if (sscanf(path, "/dm/mdev/%u%n", idx, &n) != 1 || path[n] != '/' || *idx >= obj->cnt)
+        return false;
+
+    *child_path = path + n;
+    return true;
+}
+
+// RX rate set by the path, false if the path doesn't change it
+static bool _mdev_rate_of(const char* path, uint64_t value, uint64_t* rate)
+{
+    if (strcmp(path, "/dm/rate/master") == 0) {
+        *rate = value;
+        return true;
+    }
+    if (strcmp(path, "/dm/rate/rxtxadcdac") == 0) {
+        const uint32_t* rates = (const uint32_t*)(uintptr_t)value;
+        *rate = rates[0];
+        return true;
+    }
+    return false;
+}
+
+// Remember rates of boards the set succeeded on, values are per board
+static void _mdev_rate_capture(dev_multi_t* obj, const char* path, const uint64_t* values, uint32_t failed)
+{
+    uint64_t rate;
+
+    for (unsigned i = 0; i < obj->cnt; i++) {
+        if (!(failed & (1u << i)) && _mdev_rate_of(path, values[i], &rate))
+            obj->board_rate[i] = rate;
+    }
+
+    obj->rate = obj->board_rate[0];
+    for (unsigned i = 1; i < obj->cnt; i++) {
+        if (obj->board_rate[i] != obj->rate)
+            obj->rate = 0;
+    }
+}
+
+static stream_mdev_t* _mdev_stitch_stream(dev_multi_t* obj)
+{
+    stream_mdev_t* str = &obj->streams[0];
+    return (str->stitch) ? str : NULL;
+}
+
+static double _mdev_stitch_bin(dev_multi_t* obj)
+{
+    return (double)obj->rate / obj->stitch_fftsz;
+}
+
+// Tune every board of the stitched stream to its sub-band
+static int _mdev_stitch_tune(dev_multi_t* obj)
+{
+    stream_mdev_t* str = _mdev_stitch_stream(obj);
+    uint64_t values[DEV_MAX];
+
+    if (!str)
+        return 0;
+
+    for (unsigned i = 0; i < obj->cnt; i++) {
+        values[i] = obj->stitch_freq;
+    }
+    for (unsigned j = 0; j < str->dev_cnt; j++) {
+        values[str->dev_idx[j]] = obj->stitch_freq + llround(wb_stitch_offset(str->stitch, j) * _mdev_stitch_bin(obj));
+
+        USDR_LOG("MDEV", USDR_LOG_INFO, "Stitch: device %d tuned to %.3f MHz\n",
+                 str->dev_idx[j], values[str->dev_idx[j]] / 1.0e6);
+    }
+
+    return _mdev_broadcast(obj, "/dm/sdr/0/rx/freqency", false, values);
+}
+
+static int _mdev_stitch_eq(dev_multi_t* obj, unsigned idx)
+{
+    stream_mdev_t* str = _mdev_stitch_stream(obj);
+    if (!str)
+        return 0;
+
+    for (unsigned j = 0; j < str->dev_cnt; j++) {
+        if (str->dev_idx[j] != idx)
+            continue;
+
+        return wb_stitch_set_eq(str->stitch, j,
+                                pow(10, obj->stitch_gain[idx] / 20000.0),
+                                obj->stitch_phase[idx] * M_PI / 180000.0);
+    }
+    return 0;
+}
+
+static int _mdev_stitch_set(dev_multi_t* obj, const char* path, uint64_t value)
+{
+    unsigned idx;
+
+    if (strcmp(path, "spacing") == 0) {
+        if (_mdev_stitch_stream(obj))
+            return -EBUSY;
+
+        obj->stitch_spacing = value;
+        return 0;
+    } else if (strcmp(path, "freq") == 0) {
+        obj->stitch_freq = value;
+        return _mdev_stitch_tune(obj);
+    } else if (sscanf(path, "gain/%u", &idx) == 1 && idx < obj->cnt) {
+        obj->stitch_gain[idx] = (int32_t)value;
+        return _mdev_stitch_eq(obj, idx);
+    } else if (sscanf(path, "phase/%u", &idx) == 1 && idx < obj->cnt) {
+        obj->stitch_phase[idx] = (int32_t)value;
+        return _mdev_stitch_eq(obj, idx);
+    }
+    return -EINVAL;
+}
+
+static int _mdev_stitch_get(dev_multi_t* obj, const char* path, uint64_t* ovalue)
+{
+    stream_mdev_t* str = _mdev_stitch_stream(obj);
+    unsigned idx;
+
+    if (strcmp(path, "spacing") == 0) {
+        // Effective one once the stream is created
+        *ovalue = (str) ? llround(obj->stitch_bins * _mdev_stitch_bin(obj)) : obj->stitch_spacing;
+        return 0;
+    } else if (strcmp(path, "freq") == 0) {
+        *ovalue = obj->stitch_freq;
+        return 0;
+    } else if (strcmp(path, "rate") == 0) {
+        if (!str)
+            return -EAGAIN;
+
+        *ovalue = obj->rate * wb_stitch_interp(str->stitch);
+        return 0;
+    } else if (strcmp(path, "fftsz") == 0) {
+        if (!str)
+            return -EAGAIN;
+
+        *ovalue = obj->stitch_fftsz;
+        return 0;
+    } else if (sscanf(path, "gain/%u", &idx) == 1 && idx < obj->cnt) {
+        *ovalue = (int64_t)obj->stitch_gain[idx];
+        return 0;
+    } else if (sscanf(path, "phase/%u", &idx) == 1 && idx < obj->cnt) {
+        *ovalue = (int64_t)obj->stitch_phase[idx];
+        return 0;
+    }
+    return -EINVAL;
+}
+
 static int _mdev_obj_set_i64(pusdr_vfs_obj_t vfsobj, uint64_t value)
 {
     dev_multi_t* obj = (dev_multi_t*)vfsobj->object;
+    uint64_t values[DEV_MAX];
+    const char* path;
+    unsigned idx;
     int res;
 
-    for (unsigned i = 0; i < obj->cnt; i++) {
-        pdevice_t child_dev = obj->real[i]->pdev;
-        res = usdr_device_vfs_obj_val_set_by_path(child_dev, vfsobj->full_path, value);
-
-        if (res) {
+    if (strncmp(vfsobj->full_path, "/dm/mdev/stitch/", 16) == 0) {
+        return _mdev_stitch_set(obj, vfsobj->full_path + 16, value);
+    }
+    if (_mdev_child_path(obj, vfsobj->full_path, &idx, &path)) {
+        res = usdr_device_vfs_obj_val_set_by_path(obj->real[idx]->pdev, path, value);
+        if (res)
             return res;
+
+        for (unsigned i = 0; i < obj->cnt; i++) {
+            values[i] = value;
         }
+        _mdev_rate_capture(obj, path, values, ~(1u << idx));
+        return 0;
+    }
+
+    for (unsigned i = 0; i < obj->cnt; i++) {
+        values[i] = value;
+    }
+
+    res = _mdev_broadcast(obj, vfsobj->full_path, false, values);
+    _mdev_rate_capture(obj, vfsobj->full_path, values, obj->bcast_failed);
+    if (res) {
+        return res;
     }
 
     USDR_LOG("DSTR", USDR_LOG_TRACE, "MDEV VFS %s set to %lld\n",
@@ -155,16 +481,100 @@ static int _mdev_obj_set_i64(pusdr_vfs_obj_t vfsobj, uint64_t value)
     return 0;
 }
 
+static int _mdev_obj_set_ai64(pusdr_vfs_obj_t vfsobj, unsigned count, const uint64_t* ovalue)
+{
+    dev_multi_t* obj = (dev_multi_t*)vfsobj->object;
+    uint64_t values[DEV_MAX];
+    int res;
+
+    if (count == 1)
+        return _mdev_obj_set_i64(vfsobj, ovalue[0]);
+    if (count != obj->cnt)
+        return -EINVAL;
+
+    memcpy(values, ovalue, count * sizeof(uint64_t));
+    res = _mdev_broadcast(obj, vfsobj->full_path, false, values);
+    _mdev_rate_capture(obj, vfsobj->full_path, values, obj->bcast_failed);
+    return res;
+}
+
+static int _mdev_obj_get_ai64(pusdr_vfs_obj_t vfsobj, unsigned maxcnt, uint64_t* ovalue)
+{
+    dev_multi_t* obj = (dev_multi_t*)vfsobj->object;
+    uint64_t values[DEV_MAX] = { 0 };
+    int res;
+
+    if (maxcnt < obj->cnt)
+        return -EINVAL;
+
+    res = _mdev_broadcast(obj, vfsobj->full_path, true, values);
+
+    obj->bcast_diverged = obj->bcast_failed;
+    for (unsigned i = 1; i < obj->cnt; i++) {
+        if (values[i] != values[0])
+            obj->bcast_diverged |= 1u << i;
+    }
+    if (obj->bcast_diverged) {
+        USDR_LOG("MDEV", USDR_LOG_WARNING, "MDEV VFS %s is inconsistent across devices, mask %08x\n",
+                 vfsobj->full_path, obj->bcast_diverged);
+    }
+
+    memcpy(ovalue, values, obj->cnt * sizeof(uint64_t));
+    return res ? res : (int)obj->cnt;
+}
+
 static int _mdev_obj_get_i64(pusdr_vfs_obj_t vfsobj, uint64_t* ovalue)
 {
     dev_multi_t* obj = (dev_multi_t*)vfsobj->object;
     pdevice_t child_dev = obj->real[0]->pdev;
+    const char* path;
+    unsigned idx;
     int res;
 
     if (strcmp(vfsobj->full_path, "/ll/devices") == 0) {
         *ovalue = obj->cnt;
         return 0;
     }
+    if (strcmp(vfsobj->full_path, "/dm/mdev/failed") == 0) {
+        *ovalue = obj->bcast_failed;
+        return 0;
+    }
+    if (strcmp(vfsobj->full_path, "/dm/mdev/diverged") == 0) {
+        *ovalue = obj->bcast_diverged;
+        return 0;
+    }
+    if (strncmp(vfsobj->full_path, "/dm/mdev/stitch/", 16) == 0) {
+        return _mdev_stitch_get(obj, vfsobj->full_path + 16, ovalue);
+    }
+    if (sscanf(vfsobj->full_path, "/dm/mdev/err/%u", &idx) == 1) {
+        if (idx >= obj->cnt)
+            return -EINVAL;
+
+        *ovalue = (int64_t)obj->bcast_res[idx];
+        return 0;
+    }
+    if (_mdev_child_path(obj, vfsobj->full_path, &idx, &path)) {
+        return usdr_device_vfs_obj_val_get_u64(obj->real[idx]->pdev, path, ovalue);
+    }
+    if (strncmp(vfsobj->full_path, "/dm/sync/", 9) == 0) {
+        const char* path = vfsobj->full_path + 9;
+        unsigned idx = 0;
+
+        if (!obj->sync_valid)
+            return -EAGAIN;
+
+        if (strcmp(path, "skew") == 0) {
+            *ovalue = obj->sync_spread;
+            return 0;
+        } else if (sscanf(path, "skew/%u", &idx) == 1 && idx < obj->cnt) {
+            *ovalue = obj->sync_skew[idx];
+            return 0;
+        } else if (sscanf(path, "ts/%u", &idx) == 1 && idx < obj->cnt) {
+            *ovalue = obj->sync_ts[idx];
+            return 0;
+        }
+        return -EINVAL;
+    }
 
     res = usdr_device_vfs_obj_val_get_u64(child_dev, vfsobj->full_path, ovalue);
     if (res) {
@@ -190,8 +600,8 @@ int _mdev_get_obj(pdevice_t dev, const char* fullpath, pusdr_vfs_obj_t *vfsobj)
     vfso->ops.gi64 = &_mdev_obj_get_i64;
     vfso->ops.sstr = NULL;
     vfso->ops.gstr = NULL;
-    vfso->ops.sai64 = NULL;
-    vfso->ops.gai64 = NULL;
+    vfso->ops.sai64 = &_mdev_obj_set_ai64;
+    vfso->ops.gai64 = &_mdev_obj_get_ai64;
     vfso->data.i64 = 0;
     strncpy(vfso->full_path, fullpath, sizeof(vfso->full_path));
 
@@ -199,6 +609,19 @@ int _mdev_get_obj(pdevice_t dev, const char* fullpath, pusdr_vfs_obj_t *vfsobj)
     return 0;
 }
 
+static void _mstr_stitch_free(stream_mdev_t* str)
+{
+    if (!str->stitch)
+        return;
+
+    wb_stitch_destroy(str->stitch);
+    str->stitch = NULL;
+    for (unsigned i = 0; i < DEV_MAX; i++) {
+        free(str->stitch_buf[i]);
+        str->stitch_buf[i] = NULL;
+    }
+}
+
 static
 int _mstr_stream_destroy(stream_handle_t* stream)
 {
@@ -219,6 +642,7 @@ int _mstr_stream_destroy(stream_handle_t* stream)
         str->dev_mask[i] = false;
     }
 
+    _mstr_stitch_free(str);
     return 0;
 }
 
@@ -246,6 +670,67 @@ int _mstr_stream_op(stream_handle_t* stream, unsigned command, dm_time_t timesta
 }
 
 
+// Boards are time aligned, a sample is valid only when it's valid on every board.
+// Statistics of `step` channels of every board are joined in the channel order.
+static
+void _mstr_recv_nfo(stream_mdev_t* str, const struct usdr_dms_recv_nfo* lnfo, unsigned step,
+                    struct usdr_dms_recv_nfo* nfo)
+{
+    bool stats = step != 0 && str->channels <= CHANS_MAX;
+
+    *nfo = lnfo[0];
+    for (unsigned i = 0; i < str->dev_cnt; i++) {
+        if (lnfo[i].totsyms < nfo->totsyms)
+            nfo->totsyms = lnfo[i].totsyms;
+        if (lnfo[i].totlost > nfo->totlost)
+            nfo->totlost = lnfo[i].totlost;
+        if (lnfo[i].stats == NULL)
+            stats = false;
+    }
+
+    if (stats) {
+        for (unsigned i = 0; i < str->dev_cnt; i++) {
+            memcpy(&str->ch_stat[step * i], lnfo[i].stats, step * sizeof(struct usdr_dms_ch_stat));
+        }
+    }
+    nfo->stats = stats ? str->ch_stat : NULL;
+}
+
+// Every board delivers one packet, combined output is interp times longer
+static
+int _mstr_stitch_recv(stream_mdev_t* str, dev_multi_t* obj,
+                      char **stream_buffs,
+                      unsigned timeout,
+                      struct usdr_dms_recv_nfo* nfo)
+{
+    struct usdr_dms_recv_nfo lnfo[DEV_MAX] = { { 0 } };
+    unsigned interp = wb_stitch_interp(str->stitch);
+    int res, i, idx;
+
+    for (i = 0; i < str->dev_cnt; i++) {
+        char* buf = (char*)str->stitch_buf[i];
+        idx = str->dev_idx[i];
+
+        res = obj->real_str_rx[idx]->ops->recv(obj->real_str_rx[idx], &buf, timeout,
+                                                &lnfo[i]);
+        if (res)
+            return res;
+    }
+
+    res = wb_stitch_process(str->stitch, (const float* const*)str->stitch_buf,
+                            str->pkt_symbs / interp, (float*)stream_buffs[0]);
+    if (res)
+        return res;
+
+    if (nfo) {
+        _mstr_recv_nfo(str, lnfo, 0, nfo);
+        nfo->fsymtime *= interp;
+        nfo->totsyms *= interp;
+        nfo->totlost *= interp;
+    }
+    return 0;
+}
+
 static
 int _mstr_stream_recv(stream_handle_t* stream,
                       char **stream_buffs,
@@ -257,9 +742,13 @@ int _mstr_stream_recv(stream_handle_t* stream,
     stream_handle_t** real_str = str->type == USDR_DMS_RX ? obj->real_str_rx : obj->real_str_tx;
     size_t step = str->channels / str->dev_cnt;
 
-    struct usdr_dms_recv_nfo lnfo[DEV_MAX];
+    struct usdr_dms_recv_nfo lnfo[DEV_MAX] = { { 0 } };
 
     int res, i, idx;
+    if (str->stitch) {
+        return _mstr_stitch_recv(str, obj, stream_buffs, timeout, nfo);
+    }
+
     for (i = 0; i < str->dev_cnt; i++) {
         idx = str->dev_idx[i];
 
@@ -270,7 +759,7 @@ int _mstr_stream_recv(stream_handle_t* stream,
     }
 
     if (nfo)
-        *nfo = lnfo[0];
+        _mstr_recv_nfo(str, lnfo, step, nfo);
     return 0;
 }
 
@@ -337,6 +826,84 @@ stream_ops_t _mstr_ops = {
 };
 
 
+// Checked before child streams are created
+static
+int _mdev_stitch_check(dev_multi_t* obj, const char* dformat, uint64_t channels)
+{
+    bool valid = strncmp(dformat, "cf32", 4) == 0;
+
+    for (unsigned i = 0; i < obj->cnt; i++) {
+        uint64_t child_msk = (channels >> (obj->rx_chans * i)) & ((1u << obj->rx_chans) - 1);
+        if (child_msk & (child_msk - 1))
+            valid = false;
+    }
+    if (!valid) {
+        USDR_LOG("MDEV", USDR_LOG_ERROR, "Stitched RX needs exactly one cf32 channel per device\n");
+        return -EINVAL;
+    }
+    if (obj->rate == 0) {
+        USDR_LOG("MDEV", USDR_LOG_ERROR, "Stitched RX needs the same sample rate to be set on all devices first\n");
+        return -EINVAL;
+    }
+    return 0;
+}
+
+// Boards are expected to be time aligned by the "align" sync. FFT size is
+// derived from the packet size so every packet is an integer number of hops.
+static
+int _mdev_stitch_init(dev_multi_t* obj, stream_mdev_t* mstr, unsigned chans)
+{
+    unsigned hop = mstr->pkt_symbs & -mstr->pkt_symbs;
+    unsigned spacing;
+    int res;
+
+    if (chans != 1) {
+        USDR_LOG("MDEV", USDR_LOG_ERROR, "Stitched RX needs exactly one cf32 channel per device\n");
+        return -EINVAL;
+    }
+
+    if (hop > STITCH_HOP_MAX)
+        hop = STITCH_HOP_MAX;
+
+    obj->stitch_fftsz = 2 * hop;
+    spacing = 2 * llround(obj->stitch_spacing / _mdev_stitch_bin(obj) / 2);
+    obj->stitch_bins = spacing;
+
+    res = wb_stitch_create(mstr->dev_cnt, obj->stitch_fftsz, spacing, &mstr->stitch);
+    if (res) {
+        USDR_LOG("MDEV", USDR_LOG_ERROR, "Unable to stitch %d devices %.3f MHz apart with %d point FFT (%d samples packet), error %d\n",
+                 mstr->dev_cnt, obj->stitch_spacing / 1.0e6, obj->stitch_fftsz, mstr->pkt_symbs, res);
+        return res;
+    }
+
+    for (unsigned i = 0; i < mstr->dev_cnt; i++) {
+        mstr->stitch_buf[i] = (float*)malloc(mstr->pkt_symbs * 2 * sizeof(float));
+        if (!mstr->stitch_buf[i]) {
+            _mstr_stitch_free(mstr);
+            return -ENOMEM;
+        }
+    }
+
+    for (unsigned i = 0; i < obj->cnt; i++) {
+        _mdev_stitch_eq(obj, i);
+    }
+
+    res = _mdev_stitch_tune(obj);
+    if (res) {
+        _mstr_stitch_free(mstr);
+        return res;
+    }
+
+    mstr->channels = 1;
+    mstr->pkt_symbs *= wb_stitch_interp(mstr->stitch);
+    mstr->pkt_bytes = mstr->pkt_symbs * 2 * sizeof(float);
+
+    USDR_LOG("MDEV", USDR_LOG_INFO, "Stitched RX: %d devices %.3f MHz apart, %.3f MSps output, FFT %d\n",
+             mstr->dev_cnt, spacing * _mdev_stitch_bin(obj) / 1.0e6,
+             obj->rate * wb_stitch_interp(mstr->stitch) / 1.0e6, obj->stitch_fftsz);
+    return 0;
+}
+
 static
 int _mdev_create_stream(device_t* dev, const char* sid, const char* dformat,
                         uint64_t channels, unsigned pktsyms,
@@ -358,40 +925,51 @@ int _mdev_create_stream(device_t* dev, const char* sid, const char* dformat,
     unsigned chmsk = (1u << choff) - 1;
     int res;
 
+    if (rx && obj->stitch_spacing) {
+        res = _mdev_stitch_check(obj, dformat, channels);
+        if (res)
+            return res;
+    }
+
     // Bifurcate to children
     unsigned pcnt = 0;
     for (unsigned i = 0; i < obj->cnt; i++) {
-        uint64_t child_msk = ((channels >> (choff * i)) & chmsk);
         mstr->dev_mask[i] = false;
+        if (((channels >> (choff * i)) & chmsk) && real_str[i]) {
+            USDR_LOG("MDEV", USDR_LOG_WARNING, "Device %d stream is already in use!\n", i);
+            return -EBUSY;
+        }
+    }
+
+    for (unsigned i = 0; i < obj->cnt; i++) {
+        uint64_t child_msk = ((channels >> (choff * i)) & chmsk);
         if (child_msk == 0) {
             USDR_LOG("MDEV", USDR_LOG_TRACE, "Device %d ignored\n", i);
             continue;
         }
 
-        if (real_str[i]) {
-            USDR_LOG("MDEV", USDR_LOG_WARNING, "Device %d stream is already in use!\n", i);
-            return -EBUSY;
-        }
-
         USDR_LOG("MDEV", USDR_LOG_ERROR, "Creating stream for dev %d with %x mask (child chans %d)\n",
                  i, (unsigned)child_msk, choff);
         pdevice_t child_dev = obj->real[i]->pdev;
         res = child_dev->create_stream(child_dev, sid, dformat, child_msk, pktsyms, flags,
                                        &real_str[i]);
-        if (res)
-            return res;
+        if (res) {
+            real_str[i] = NULL;
+            goto failed;
+        }
 
         mstr->dev_mask[i] = true;
 
         tmp = -1;
         res = real_str[i]->ops->option_get(real_str[i], "fd", &tmp);
         if (res)
-            return res;
+            goto failed;
 
         if (tmp < 0) {
             USDR_LOG("MDEV", USDR_LOG_ERROR, "Need a real in LL layer to work in MDEV configuration for %s\n",
                      sid);
-            return -ENOTSUP;
+            res = -ENOTSUP;
+            goto failed;
         }
 
         mstr->poll_fd[pcnt].fd = tmp;
@@ -402,9 +980,12 @@ int _mdev_create_stream(device_t* dev, const char* sid, const char* dformat,
         pcnt++;
     }
 
-    res = real_str[0]->ops->stat(real_str[0], &nfo);
+    if (pcnt == 0)
+        return -EINVAL;
+
+    res = real_str[mstr->dev_idx[0]]->ops->stat(real_str[mstr->dev_idx[0]], &nfo);
     if (res)
-        return res;
+        goto failed;
 
     USDR_LOG("DSTR", USDR_LOG_TRACE, "Natural format %d x (%d chans %d bytes %d symbs)\n",
              pcnt, nfo.channels, nfo.pktbszie, nfo.pktsyms);
@@ -418,11 +999,119 @@ int _mdev_create_stream(device_t* dev, const char* sid, const char* dformat,
     mstr->base.ops = &_mstr_ops;
     mstr->dev_cnt = pcnt;
 
+    if (rx && obj->stitch_spacing) {
+        res = _mdev_stitch_init(obj, mstr, nfo.channels);
+        if (res)
+            goto failed;
+    }
+
     *out_handle = (stream_handle_t*)mstr;
     return 0;
 
-// TODO error handling
+failed:
+    // Children are released so the next attempt doesn't get -EBUSY
+    for (unsigned i = 0; i < obj->cnt; i++) {
+        if (!mstr->dev_mask[i])
+            continue;
+
+        pdevice_t child_dev = obj->real[i]->pdev;
+        child_dev->unregister_stream(child_dev, real_str[i]);
+        real_str[i] = NULL;
+        mstr->dev_mask[i] = false;
+    }
+    return res;
+}
+
+// Snapshot of timestamp counters of all boards after they have been started
+// by the shared 1PPS/SYSREF event. Counters are read forward and then backward,
+// so the average of both readings refers to the same moment on every board.
+static
+int _mdev_sync_measure(dev_multi_t* obj)
+{
+    uint64_t ts_reg[DEV_MAX];
+    uint32_t fwd[DEV_MAX], bwd[DEV_MAX];
+    int32_t offs[DEV_MAX];
+    int32_t offs_min = 0, offs_max = 0;
+    int res;
+
+    obj->sync_valid = false;
+
+    for (unsigned i = 0; i < obj->cnt; i++) {
+        res = usdr_device_vfs_obj_val_get_u64(obj->real[i]->pdev, "/ll/sync/0/ts", &ts_reg[i]);
+        if (res) {
+            USDR_LOG("MDEV", USDR_LOG_ERROR, "Device %d has no timestamp counter, can't measure start skew\n", i);
+            return -ENOTSUP;
+        }
+    }
+
+    for (unsigned i = 0; i < obj->cnt; i++) {
+        res = lowlevel_reg_rd32(obj->real[i], 0, ts_reg[i], &fwd[i]);
+        if (res)
+            return res;
+    }
+    for (unsigned i = obj->cnt; i-- > 0; ) {
+        res = lowlevel_reg_rd32(obj->real[i], 0, ts_reg[i], &bwd[i]);
+        if (res)
+            return res;
+    }
+
+    for (unsigned i = 0; i < obj->cnt; i++) {
+        if (fwd[i] == 0 && bwd[i] == 0) {
+            USDR_LOG("MDEV", USDR_LOG_WARNING, "Device %d hasn't been started yet\n", i);
+            return -EAGAIN;
+        }
+
+        obj->sync_ts[i] = fwd[i] + (uint32_t)(bwd[i] - fwd[i]) / 2;
+        offs[i] = (int32_t)(obj->sync_ts[i] - obj->sync_ts[0]);
+
+        if (offs[i] < offs_min)
+            offs_min = offs[i];
+        if (offs[i] > offs_max)
+            offs_max = offs[i];
+    }
+
+    for (unsigned i = 0; i < obj->cnt; i++) {
+        obj->sync_skew[i] = offs[i] - offs_min;
+
+        USDR_LOG("MDEV", USDR_LOG_INFO, "Device %d started %" PRId64 " samples before the latest one (TS %u/%u)\n",
+                 i, obj->sync_skew[i], fwd[i], bwd[i]);
+    }
+
+    obj->sync_spread = offs_max - offs_min;
+    obj->sync_valid = true;
+
+    USDR_LOG("MDEV", (obj->sync_spread) ? USDR_LOG_WARNING : USDR_LOG_INFO,
+             "Start skew between %d devices is %" PRId64 " samples\n", obj->cnt, obj->sync_spread);
+    return 0;
+}
+
+// Discards leading samples on early started boards to compensate measured skew
+static
+int _mdev_sync_align(dev_multi_t* obj, stream_mdev_t** mstr, unsigned scount)
+{
+    int res = _mdev_sync_measure(obj);
+    if (res)
+        return res;
+
+    for (unsigned j = 0; j < scount; j++) {
+        if (!mstr[j] || mstr[j]->type != USDR_DMS_RX)
+            continue;
+
+        for (unsigned i = 0; i < obj->cnt; i++) {
+            if (!mstr[j]->dev_mask[i])
+                continue;
 
+            res = obj->real_str_rx[i]->ops->option_set(obj->real_str_rx[i], "skip_syms",
+                                                       obj->sync_skew[i]);
+            if (res) {
+                USDR_LOG("MDEV", USDR_LOG_ERROR, "Device %d unable to discard %" PRId64 " samples, error %d\n",
+                         i, obj->sync_skew[i], res);
+                return res;
+            }
+        }
+    }
+
+    return 0;
 }
 
 int _mdev_stream_sync(device_t* dev,
@@ -432,11 +1121,10 @@ int _mdev_stream_sync(device_t* dev,
     bool sysref = !strcmp(synctype, "sysref");
     bool sysref_gen = !strcmp(synctype, "sysref+gen");
     int res;
-    stream_mdev_t* mstr[2] = {
-        (pstr[0]) ? container_of(pstr[0], stream_mdev_t, base) : NULL,
-        (scount > 1 && pstr[1]) ? container_of(pstr[1], stream_mdev_t, base) : NULL,
-    };
 
+    if (!strcmp(synctype, "measure")) {
+        return _mdev_sync_measure(obj);
+    }
     if (sysref_gen) {
         return -EINVAL;
     }
@@ -444,6 +1132,18 @@ int _mdev_stream_sync(device_t* dev,
         return -EINVAL;
     }
 
+    stream_mdev_t* mstr[2] = {
+        (pstr[0]) ? container_of(pstr[0], stream_mdev_t, base) : NULL,
+        (scount > 1 && pstr[1]) ? container_of(pstr[1], stream_mdev_t, base) : NULL,
+    };
+
+    if (!strcmp(synctype, "align")) {
+        return _mdev_sync_align(obj, mstr, scount);
+    }
+
+    // Retimers are rearmed, previous measurement is no longer relevant
+    obj->sync_valid = false;
+
     for (unsigned i = 0; i < obj->cnt; i++) {
         stream_handle_t* strs[2] = {
             mstr[0] ? (mstr[0]->type == USDR_DMS_RX ? obj->real_str_rx[i] : obj->real_str_tx[i]) : NULL,
@@ -485,13 +1185,14 @@ int _mdev_unregister_stream(device_t* dev, stream_handle_t* stream)
 
     int i, idx;
     for (i = 0; i < str->dev_cnt; i++) {
-        pdevice_t child_dev = obj->real[i]->pdev;
         idx = str->dev_idx[i];
+        pdevice_t child_dev = obj->real[idx]->pdev;
 
         child_dev->unregister_stream(child_dev, real_str[idx]);
         real_str[idx] = NULL;
     }
 
+    _mstr_stitch_free(str);
     return 0;
 }
 
@@ -571,6 +1272,8 @@ int mdev_create(unsigned pcnt, const char** names, const char** values, lldev_t*
         goto error_init;
     }
 
+    _mdev_workers_start(obj);
+
     USDR_LOG("DSTR", USDR_LOG_WARNING, "Creating multi device with %d nodes, each %d/%d RX/TX chans, MDEV captured: %d\n",
              obj->cnt, obj->rx_chans, obj->tx_chans, res == 0 ? 1 : 0);
     *odev = &obj->lldev;
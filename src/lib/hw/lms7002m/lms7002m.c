@@ -47,6 +47,20 @@ struct pll_cfg {
 static int lms7002m_spi_post(lms7002m_state_t* obj, uint32_t* regs, unsigned count)
 {
     int res;
+    if (obj->rec_buf) {
+        for (unsigned i = 0; i < count; i++) {
+            if (obj->rec_cnt < obj->rec_max) {
+                obj->rec_buf[obj->rec_cnt] = regs[i];
+            }
+            obj->rec_cnt++;
+
+            if (((regs[i] >> 16) & 0x7fff) == LML_0x0020) {
+                obj->reg_amac = regs[i];
+            }
+        }
+        return 0;
+    }
+
     for (unsigned i = 0; i < count; i++) {
         res = lowlevel_spi_tr32(obj->dev, obj->subdev, obj->lsaddr, regs[i], NULL);
         if (res)
@@ -64,6 +78,160 @@ static int lms7002m_spi_post(lms7002m_state_t* obj, uint32_t* regs, unsigned cou
     return 0;
 }
 
+int lms7002m_regs_post(lms7002m_state_t* m, const uint32_t* regs, unsigned count)
+{
+    uint32_t seq[LMS7002M_SEQ_MAX + 1];
+    if (count > LMS7002M_SEQ_MAX)
+        return -E2BIG;
+
+    // Restore MAC only if the sequence leaves it different
+    uint16_t amac = m->reg_amac;
+    for (unsigned i = 0; i < count; i++) {
+        if (((regs[i] >> 16) & 0x7fff) == LML_0x0020)
+            amac = regs[i];
+    }
+
+    memcpy(seq, regs, count * sizeof(uint32_t));
+    if (amac != m->reg_mac) {
+        seq[count++] = MAKE_LMS7002M_REG_WR(LML_0x0020, m->reg_mac);
+    }
+    return lms7002m_spi_post(m, seq, count);
+}
+
+struct lms7002m_reg_img {
+    uint16_t addr;
+    uint16_t val;
+    uint8_t ch;
+};
+
+// Resulting register values per channel of a captured write sequence
+static unsigned _lms7002m_regs_image(const uint32_t* regs, unsigned count,
+                                     struct lms7002m_reg_img* img, unsigned max)
+{
+    unsigned mac = LMS7_CH_AB;
+    unsigned n = 0;
+
+    for (unsigned i = 0; i < count; i++) {
+        uint16_t addr = (regs[i] >> 16) & 0x7fff;
+        uint16_t val = regs[i];
+
+        if (addr == LML_0x0020) {
+            mac = GET_LMS7002M_LML_0X0020_MAC(val);
+            continue;
+        }
+
+        for (unsigned ch = LMS7_CH_A; ch <= LMS7_CH_B; ch <<= 1) {
+            unsigned k;
+            if (!(mac & ch))
+                continue;
+
+            for (k = 0; k < n; k++) {
+                if (img[k].addr == addr && img[k].ch == ch)
+                    break;
+            }
+            if (k == n) {
+                if (n == max)
+                    return max + 1;
+                img[n].addr = addr;
+                img[n].ch = ch;
+                n++;
+            }
+            img[k].val = val;
+        }
+    }
+    return n;
+}
+
+static int _lms7002m_regs_img_find(const struct lms7002m_reg_img* img, unsigned n,
+                                   uint16_t addr, unsigned ch)
+{
+    for (unsigned k = 0; k < n; k++) {
+        if (img[k].addr == addr && img[k].ch == ch)
+            return k;
+    }
+    return -1;
+}
+
+int lms7002m_regs_delta(lms7002m_state_t* m,
+                        const uint32_t* from, unsigned from_cnt,
+                        const uint32_t* to, unsigned to_cnt,
+                        uint32_t* out, unsigned max)
+{
+    struct lms7002m_reg_img fimg[LMS7002M_SEQ_MAX];
+    struct lms7002m_reg_img timg[LMS7002M_SEQ_MAX];
+    uint8_t tmac[LMS7002M_SEQ_MAX];
+    unsigned fn = _lms7002m_regs_image(from, from_cnt, fimg, LMS7002M_SEQ_MAX);
+    unsigned tn = _lms7002m_regs_image(to, to_cnt, timg, LMS7002M_SEQ_MAX);
+    unsigned j = 0;
+
+    if (fn > LMS7002M_SEQ_MAX || tn > LMS7002M_SEQ_MAX)
+        return -E2BIG;
+
+    // Drop unchanged registers, write the same value to A & B at once
+    for (unsigned k = 0; k < tn; k++) {
+        int f = _lms7002m_regs_img_find(fimg, fn, timg[k].addr, timg[k].ch);
+        tmac[k] = (f >= 0 && fimg[f].val == timg[k].val) ? LMS7_CH_NONE : timg[k].ch;
+    }
+    for (unsigned k = 0; k < tn; k++) {
+        if (tmac[k] != LMS7_CH_A)
+            continue;
+
+        int b = _lms7002m_regs_img_find(timg, tn, timg[k].addr, LMS7_CH_B);
+        if (b >= 0 && tmac[b] == LMS7_CH_B && timg[b].val == timg[k].val) {
+            tmac[k] = LMS7_CH_AB;
+            tmac[b] = LMS7_CH_NONE;
+        }
+    }
+
+    for (unsigned mac = LMS7_CH_A; mac <= LMS7_CH_AB; mac++) {
+        bool mac_set = false;
+        for (unsigned k = 0; k < tn; k++) {
+            if (tmac[k] != mac)
+                continue;
+
+            if (j + 2 > max)
+                return -E2BIG;
+
+            if (!mac_set) {
+                uint16_t regmac = m->reg_mac;
+                SET_LMS7002M_LML_0X0020_MAC(regmac, mac);
+                out[j++] = MAKE_LMS7002M_REG_WR(LML_0x0020, regmac);
+                mac_set = true;
+            }
+            out[j++] = MAKE_LMS7002M_REG_WR(timg[k].addr, timg[k].val);
+        }
+    }
+
+    return j;
+}
+
+int lms7002m_rec_start(lms7002m_state_t* m, uint32_t* buf, unsigned max)
+{
+    if (m->rec_buf)
+        return -EBUSY;
+
+    if (max == 0)
+        return -EINVAL;
+
+    // Capture starts with the current MAC, so the channel of every write is known
+    buf[0] = MAKE_LMS7002M_REG_WR(LML_0x0020, m->reg_mac);
+    m->rec_buf = buf;
+    m->rec_cnt = 1;
+    m->rec_max = max;
+    return 0;
+}
+
+int lms7002m_rec_stop(lms7002m_state_t* m)
+{
+    unsigned cnt = m->rec_cnt;
+    unsigned max = m->rec_max;
+
+    m->rec_buf = NULL;
+    m->rec_cnt = 0;
+    m->rec_max = 0;
+    return (cnt > max) ? -E2BIG : (int)cnt;
+}
+
 static int lms7002m_spi_rd(lms7002m_state_t* obj, uint16_t addr, uint16_t* data)
 {
     uint32_t rd;
@@ -86,6 +254,10 @@ int lms7002m_create(lldev_t dev, unsigned subdev, unsigned lsaddr,
     out->dev = dev;
     out->subdev = subdev;
     out->lsaddr = lsaddr;
+    out->rec_buf = NULL;
+    out->rec_cnt = 0;
+    out->rec_max = 0;
+    memset(out->reg_rxgain, 0, sizeof(out->reg_rxgain));
 
     uint32_t reset_regs[] = {
         MAKE_LMS7002M_LML_0x0020(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, LMS7_CH_AB),
@@ -870,6 +1042,32 @@ static void _lms7002m_mask_field_set(lms7002m_state_t* m, uint16_t reg[2], unsig
     }
 }
 
+int lms7002m_xxtsp_en(lms7002m_state_t* m, lms7002m_xxtsp_t tsp, bool enable)
+{
+    unsigned mac = GET_LMS7002M_LML_0X0020_MAC(m->reg_mac);
+    if (mac == LMS7_CH_NONE)
+        return -EINVAL;
+
+    uint16_t *dscmode = (tsp == LMS_RXTSP) ? m->reg_rxtsp_dscmode : m->reg_txtsp_dscmode;
+    _lms7002m_mask_field_set(m, dscmode, RXTSP_0X0400_EN_OFF, RXTSP_0X0400_EN_MSK, enable ? 1 : 0);
+
+    uint16_t maca = m->reg_mac, macb = m->reg_mac;
+    SET_LMS7002M_LML_0X0020_MAC(maca, LMS7_CH_A);
+    SET_LMS7002M_LML_0X0020_MAC(macb, LMS7_CH_B);
+
+    uint32_t regs_ab[] = {
+        MAKE_LMS7002M_REG_WR(LML_0x0020, maca),
+        MAKE_LMS7002M_REG_WR((tsp == LMS_RXTSP) ? RXTSP_0x0400 : TXTSP_0x0200, dscmode[0]),
+        MAKE_LMS7002M_REG_WR(LML_0x0020, macb),
+        MAKE_LMS7002M_REG_WR((tsp == LMS_RXTSP) ? RXTSP_0x0400 : TXTSP_0x0200, dscmode[1]),
+        MAKE_LMS7002M_REG_WR(LML_0x0020, m->reg_mac),
+    };
+
+    uint32_t *pregs = (mac == LMS7_CH_AB) ? regs_ab : (mac == LMS7_CH_A) ? &regs_ab[1] : &regs_ab[3];
+    const unsigned pregs_cnt = (mac == LMS7_CH_AB) ? SIZEOF_ARRAY(regs_ab) : 1;
+    return lms7002m_spi_post(m, pregs, pregs_cnt);
+}
+
 int lms7002m_rxtsp_dc_corr(lms7002m_state_t* m, bool byp, unsigned wnd)
 {
     _lms7002m_mask_field_set(m, m->reg_rxtsp_dscpcfg, RXTSP_0X040C_DC_BYP_OFF, RXTSP_0X040C_DC_BYP_MSK, byp ? 1 : 0);
@@ -970,6 +1168,75 @@ int lms7002m_xxtsp_iq_phcorr(lms7002m_state_t* m, lms7002m_xxtsp_t tsp, int acor
 }
 
 
+// GFIR coefficient memory, 5 banks of 8 words per 0x40 block
+enum {
+    TXTSP_GFIR1_COEFF = 0x0280,
+    TXTSP_GFIR2_COEFF = 0x02C0,
+    TXTSP_GFIR3_COEFF = 0x0300,
+    RXTSP_GFIR1_COEFF = 0x0480,
+    RXTSP_GFIR2_COEFF = 0x04C0,
+    RXTSP_GFIR3_COEFF = 0x0500,
+
+    GFIR_BLOCK_BANKS = 5,
+    GFIR_BLOCK_STRIDE = 0x40,
+};
+
+int lms7002m_xxtsp_gfir(lms7002m_state_t* m, lms7002m_xxtsp_t tsp, lms7002m_gfir_t gfir,
+                        const lms7002m_gfir_design_t* d)
+{
+    static const uint16_t coeff_base[2][3] = {
+        { TXTSP_GFIR1_COEFF, TXTSP_GFIR2_COEFF, TXTSP_GFIR3_COEFF },
+        { RXTSP_GFIR1_COEFF, RXTSP_GFIR2_COEFF, RXTSP_GFIR3_COEFF },
+    };
+    static const uint16_t ln_addr[2][3] = {
+        { TXTSP_0x0205, TXTSP_0x0206, TXTSP_0x0207 },
+        { RXTSP_0x0405, RXTSP_0x0406, RXTSP_0x0407 },
+    };
+    static const uint16_t byp_msk[2][3] = {
+        { TXTSP_0X0208_GFIR1_BYP_MSK, TXTSP_0X0208_GFIR2_BYP_MSK, TXTSP_0X0208_GFIR3_BYP_MSK },
+        { RXTSP_0X040C_GFIR1_BYP_MSK, RXTSP_0X040C_GFIR2_BYP_MSK, RXTSP_0X040C_GFIR3_BYP_MSK },
+    };
+    static const uint8_t byp_off[2][3] = {
+        { TXTSP_0X0208_GFIR1_BYP_OFF, TXTSP_0X0208_GFIR2_BYP_OFF, TXTSP_0X0208_GFIR3_BYP_OFF },
+        { RXTSP_0X040C_GFIR1_BYP_OFF, RXTSP_0X040C_GFIR2_BYP_OFF, RXTSP_0X040C_GFIR3_BYP_OFF },
+    };
+    const unsigned t = (tsp == LMS_RXTSP) ? 1 : 0;
+    uint16_t *dscpcfg = (tsp == LMS_RXTSP) ? m->reg_rxtsp_dscpcfg : m->reg_txtsp_dscpcfg;
+    int res;
+
+    if (gfir > LMS7_GFIR3 || (d && d->gfir != gfir))
+        return -EINVAL;
+
+    if (d) {
+        int16_t img[LMS7_GFIR_TAPS_MAX];
+        uint32_t regs[LMS7_GFIR_TAPS_MAX];
+        unsigned banks = lms7002m_gfir_image(d, img);
+        unsigned cnt = banks * LMS7_GFIR_BANK_LEN;
+
+        for (unsigned i = 0; i < cnt; i++) {
+            unsigned b = i / LMS7_GFIR_BANK_LEN;
+            unsigned addr = coeff_base[t][gfir] + (b / GFIR_BLOCK_BANKS) * GFIR_BLOCK_STRIDE +
+                            (b % GFIR_BLOCK_BANKS) * LMS7_GFIR_BANK_LEN + i % LMS7_GFIR_BANK_LEN;
+
+            regs[i] = MAKE_LMS7002M_REG_WR(addr, (uint16_t)img[i]);
+        }
+
+        res = lms7002m_spi_post(m, regs, cnt);
+        if (res)
+            return res;
+    }
+
+    _lms7002m_mask_field_set(m, dscpcfg, byp_off[t][gfir], byp_msk[t][gfir], d ? 0 : 1);
+
+    // GFIRx_L / GFIRx_N layout is the same in all six registers
+    uint32_t regs[] = {
+        MAKE_LMS7002M_REG_WR(ln_addr[t][gfir], d ? ((d->l << RXTSP_0X0405_GFIR1_L_OFF) |
+                                                    (d->n << RXTSP_0X0405_GFIR1_N_OFF)) : 0),
+    };
+    return _lms7002m_xxtsp_wregwith_dspcfg(m, tsp, regs, SIZEOF_ARRAY(regs));
+}
+
+
 int lms7002m_rfe_path(lms7002m_state_t* m, lms7002m_rfe_path_t p, lms7002m_rfe_mode_t mode)
 {
     if (_lms7002m_is_none(m))
@@ -1027,6 +1294,7 @@ static int _lms7002m_rfe_update_gains(lms7002m_state_t* m)
             m->rfe[i].lb ? 1 : m->rfe[i].lna,
             m->rfe[i].lb ? m->rfe[i].lbg : 0,
             m->rfe[i].tia);
+        m->reg_rxgain[i][0] = regs[j - 1];
     };
 
     regs[j++] = MAKE_LMS7002M_REG_WR(LML_0x0020, m->reg_mac);
@@ -1050,14 +1318,99 @@ static unsigned _find_idx(int value, const int* list, unsigned count)
     return i;
 }
 
+static const int lna_attens[] = {
+    IGNORE_IDX, 300, 270, 240, 210, 180, 150, 120, 90, 60, 50, 40, 30, 20, 10, 0
+};
+static const int tia_attens[] = {
+    IGNORE_IDX, 120, 30, 0
+};
+
+int lms7002m_rfe_step_atten(lms7002m_rfe_gain_t gain, unsigned idx)
+{
+    switch (gain) {
+    case RFE_GAIN_LNA:
+        return (idx > 0 && idx < SIZEOF_ARRAY(lna_attens)) ? lna_attens[idx] : -EINVAL;
+    case RFE_GAIN_TIA:
+        return (idx > 0 && idx < SIZEOF_ARRAY(tia_attens)) ? tia_attens[idx] : -EINVAL;
+    default:
+        return -EINVAL;
+    }
+}
+
+// RBB_0x0119, RBB_0x011A for PGA gain in dB
+static void _lms7002m_rbb_pga_regs(unsigned gain, uint32_t* regs)
+{
+    static const uint8_t rcc_corr[] = { 31, 30, 29, 29, 28, 27, 26, 26, 25, 24, 24, 23, 23, 22, 22, 21,
+                                        21, 20, 20, 19, 19, 19, 18, 18, 18, 17, 17, 17, 16, 16, 16, 16 };
+    unsigned rcc_ctl = rcc_corr[gain];
+    unsigned c_ctl = (gain < 8) ? 3u : (gain < 13) ? 2u : (gain < 21) ? 1u : 0;
+
+    regs[0] = MAKE_LMS7002M_RBB_0x0119(0, 20, 20, gain);
+    regs[1] = MAKE_LMS7002M_RBB_0x011A(rcc_ctl, c_ctl);
+}
+
+int lms7002m_rx_gain_set(lms7002m_state_t* m, unsigned chs,
+                         unsigned lna, unsigned tia, unsigned pga,
+                         unsigned* writes)
+{
+    uint32_t from[2 * 4], to[2 * 4], seq[LMS7002M_SEQ_MAX];
+    unsigned fcnt = 0, tcnt = 0;
+    uint32_t nregs[3];
+    int res;
+
+    if (lms7002m_rfe_step_atten(RFE_GAIN_LNA, lna) < 0 ||
+        lms7002m_rfe_step_atten(RFE_GAIN_TIA, tia) < 0 || pga > 31)
+        return -EINVAL;
+
+    _lms7002m_rbb_pga_regs(pga, &nregs[1]);
+
+    for (unsigned i = 0; i < 2; i++) {
+        uint16_t mac = m->reg_mac;
+        if (!(chs & (i + 1)))
+            continue;
+
+        SET_LMS7002M_LML_0X0020_MAC(mac, i + 1);
+        from[fcnt++] = MAKE_LMS7002M_REG_WR(LML_0x0020, mac);
+        to[tcnt++] = MAKE_LMS7002M_REG_WR(LML_0x0020, mac);
+
+        nregs[0] = MAKE_LMS7002M_RFE_0x0113(m->rfe[i].lb ? 1 : lna, m->rfe[i].lb ? m->rfe[i].lbg : 0, tia);
+        for (unsigned k = 0; k < 3; k++) {
+            if (m->reg_rxgain[i][k])
+                from[fcnt++] = MAKE_LMS7002M_REG_WR((k == 0) ? RFE_0x0113 : (k == 1) ? RBB_0x0119 : RBB_0x011A,
+                                                    m->reg_rxgain[i][k]);
+            to[tcnt++] = MAKE_LMS7002M_REG_WR((k == 0) ? RFE_0x0113 : (k == 1) ? RBB_0x0119 : RBB_0x011A,
+                                              nregs[k]);
+        }
+    }
+
+    res = lms7002m_regs_delta(m, from, fcnt, to, tcnt, seq, SIZEOF_ARRAY(seq));
+    if (res < 0)
+        return res;
+
+    if (writes)
+        *writes = res;
+    if (res == 0)
+        return 0;
+
+    res = lms7002m_regs_post(m, seq, res);
+    if (res)
+        return res;
+
+    for (unsigned i = 0; i < 2; i++) {
+        if (!(chs & (i + 1)))
+            continue;
+
+        m->rfe[i].lna = lna;
+        m->rfe[i].tia = tia;
+        m->reg_rxgain[i][0] = MAKE_LMS7002M_RFE_0x0113(m->rfe[i].lb ? 1 : lna, m->rfe[i].lb ? m->rfe[i].lbg : 0, tia);
+        m->reg_rxgain[i][1] = nregs[1];
+        m->reg_rxgain[i][2] = nregs[2];
+    }
+    return 0;
+}
+
 int lms7002m_rfe_gain(lms7002m_state_t* m, lms7002m_rfe_gain_t gain, int gainx10, int *goutx10)
 {
-    static const int lna_attens[] = {
-        IGNORE_IDX, 300, 270, 240, 210, 180, 150, 120, 90, 60, 50, 40, 30, 20, 10, 0
-    };
-    static const int tia_attens[] = {
-        IGNORE_IDX, 120, 30, 0
-    };
     static const int lb_attens[] = {
         400, 240, 170, 140, 110, 90, 75, 62, 50, 40, 30, 24, 16, 10, 5, 0
     };
@@ -1236,21 +1589,21 @@ int lms7002m_rbb_path(lms7002m_state_t* m, lms7002m_rbb_path_t path, lms7002m_rb
 
 int lms7002m_rbb_pga(lms7002m_state_t* m, int gainx10)
 {
-    static const uint8_t rcc_corr[] = { 31, 30, 29, 29, 28, 27, 26, 26, 25, 24, 24, 23, 23, 22, 22, 21,
-                                        21, 20, 20, 19, 19, 19, 18, 18, 18, 17, 17, 17, 16, 16, 16, 16 };
     if (gainx10 < 0)
         gainx10 = 0;
     else if (gainx10 > 310)
         gainx10 = 310;
 
-    unsigned gain = gainx10 / 10;
-    unsigned rcc_ctl = rcc_corr[gain];
-    unsigned c_ctl = (gain < 8) ? 3u : (gain < 13) ? 2u : (gain < 21) ? 1u : 0;
+    uint32_t regs[2];
+    _lms7002m_rbb_pga_regs(gainx10 / 10, regs);
 
-    uint32_t regs[] = {
-        MAKE_LMS7002M_RBB_0x0119(0, 20, 20, gain),
-        MAKE_LMS7002M_RBB_0x011A(rcc_ctl, c_ctl)
-    };
+    for (unsigned i = 0; i < 2; i++) {
+        if (!_lms7002m_check_chan(m, i))
+            continue;
+
+        m->reg_rxgain[i][1] = regs[0];
+        m->reg_rxgain[i][2] = regs[1];
+    }
     return lms7002m_spi_post(m, regs, SIZEOF_ARRAY(regs));
 }
 
@@ -1402,3 +1755,263 @@ lms7002m_trf_path_t lms7002m_trf_from_rfe_path(lms7002m_rfe_path_t rfe_path)
     default: return TRF_MUTE;
     }
 }
+
+
+// Register map of the dump, SXX block is SXR on MAC A and SXT on MAC B
+struct lms7002m_reg_range {
+    uint16_t first;
+    uint16_t last;
+};
+
+static const struct lms7002m_reg_range s_dump_global[] = {
+    { 0x0021, 0x002C },
+    { 0x002E, 0x002E },
+    { 0x0081, 0x0082 },
+    { 0x0084, 0x008D },
+    { 0x0092, 0x00A7 },
+};
+
+// DC calibration block is dumped for both MACs, duplicate writes are harmless
+static const struct lms7002m_reg_range s_dump_channel[] = {
+    { 0x0100, 0x0124 },
+    { 0x0200, 0x0208 },
+    { 0x020C, 0x020C },
+    { 0x0240, 0x0243 },
+    { 0x0400, 0x040C },
+    { 0x0440, 0x0443 },
+    { 0x05C0, 0x05C0 },
+    { 0x05C2, 0x05CC },
+};
+
+// PLL configuration, read back after load
+static const struct lms7002m_reg_range s_verify_regs[] = {
+    { CGEN_ENABLE, CGEN_0x008B },
+    { SXX_0x011C, 0x0122 },
+};
+
+static bool _lms7002m_in_ranges(const struct lms7002m_reg_range* r, unsigned cnt, unsigned addr)
+{
+    for (unsigned k = 0; k < cnt; k++) {
+        if (addr >= r[k].first && addr <= r[k].last)
+            return true;
+    }
+    return false;
+}
+
+static int _lms7002m_dump_addr(lms7002m_state_t* m, unsigned addr, uint32_t* out, unsigned* j, unsigned max)
+{
+    uint16_t val;
+    int res;
+
+    if (*j == max)
+        return -E2BIG;
+
+    res = lms7002m_spi_rd(m, addr, &val);
+    if (res)
+        return res;
+
+    out[(*j)++] = MAKE_LMS7002M_REG_WR(addr, val);
+    return 0;
+}
+
+static int _lms7002m_dump_ranges(lms7002m_state_t* m, const struct lms7002m_reg_range* r, unsigned cnt,
+                                 uint32_t* out, unsigned* j, unsigned max)
+{
+    int res;
+    for (unsigned k = 0; k < cnt; k++) {
+        for (unsigned addr = r[k].first; addr <= r[k].last; addr++) {
+            res = _lms7002m_dump_addr(m, addr, out, j, max);
+            if (res)
+                return res;
+        }
+    }
+    return 0;
+}
+
+// Coefficient memory of GFIRs which aren't bypassed on the active MAC
+static int _lms7002m_dump_gfir(lms7002m_state_t* m, uint32_t* out, unsigned* j, unsigned max)
+{
+    static const uint16_t cfg_addr[2] = { TXTSP_0x0208, RXTSP_0x040C };
+    static const uint16_t coeff_base[2] = { TXTSP_GFIR1_COEFF, RXTSP_GFIR1_COEFF };
+    static const uint16_t byp_msk[2][3] = {
+        { TXTSP_0X0208_GFIR1_BYP_MSK, TXTSP_0X0208_GFIR2_BYP_MSK, TXTSP_0X0208_GFIR3_BYP_MSK },
+        { RXTSP_0X040C_GFIR1_BYP_MSK, RXTSP_0X040C_GFIR2_BYP_MSK, RXTSP_0X040C_GFIR3_BYP_MSK },
+    };
+    int res;
+
+    for (unsigned t = 0; t < 2; t++) {
+        uint16_t cfg;
+        res = lms7002m_spi_rd(m, cfg_addr[t], &cfg);
+        if (res)
+            return res;
+
+        for (unsigned gfir = LMS7_GFIR1; gfir <= LMS7_GFIR3; gfir++) {
+            unsigned banks = (gfir == LMS7_GFIR3) ? LMS7_GFIR3_BANKS : LMS7_GFIR12_BANKS;
+            if (cfg & byp_msk[t][gfir])
+                continue;
+
+            for (unsigned b = 0; b < banks; b++) {
+                for (unsigned i = 0; i < LMS7_GFIR_BANK_LEN; i++) {
+                    unsigned addr = coeff_base[t] + gfir * GFIR_BLOCK_STRIDE +
+                                    (b / GFIR_BLOCK_BANKS) * GFIR_BLOCK_STRIDE +
+                                    (b % GFIR_BLOCK_BANKS) * LMS7_GFIR_BANK_LEN + i;
+
+                    res = _lms7002m_dump_addr(m, addr, out, j, max);
+                    if (res)
+                        return res;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+int lms7002m_regs_dump(lms7002m_state_t* m, uint32_t* out, unsigned max)
+{
+    uint32_t rmac = MAKE_LMS7002M_REG_WR(LML_0x0020, m->reg_mac);
+    unsigned j = 0;
+    int res = 0, rres;
+
+    if (m->rec_buf)
+        return -EBUSY;
+
+    for (unsigned ch = 0; ch < 2 && !res; ch++) {
+        uint16_t mac = m->reg_mac;
+        SET_LMS7002M_LML_0X0020_MAC(mac, ch + 1);
+
+        if (j == max)
+            return -E2BIG;
+
+        out[j] = MAKE_LMS7002M_REG_WR(LML_0x0020, mac);
+        res = lms7002m_spi_post(m, &out[j++], 1);
+
+        if (ch == 0) {
+            res = (res) ? res : _lms7002m_dump_ranges(m, s_dump_global, SIZEOF_ARRAY(s_dump_global), out, &j, max);
+        }
+        res = (res) ? res : _lms7002m_dump_ranges(m, s_dump_channel, SIZEOF_ARRAY(s_dump_channel), out, &j, max);
+        res = (res) ? res : _lms7002m_dump_gfir(m, out, &j, max);
+    }
+
+    rres = lms7002m_spi_post(m, &rmac, 1);
+    if (res)
+        return res;
+    if (rres)
+        return rres;
+    if (j == max)
+        return -E2BIG;
+
+    out[j++] = rmac;
+    return (int)j;
+}
+
+int lms7002m_regs_load(lms7002m_state_t* m, const uint32_t* regs, unsigned count)
+{
+    uint32_t seq[LMS7002M_SEQ_MAX];
+    int res;
+
+    for (unsigned i = 0; i < count; i += LMS7002M_SEQ_MAX) {
+        unsigned n = (count - i > LMS7002M_SEQ_MAX) ? LMS7002M_SEQ_MAX : count - i;
+
+        memcpy(seq, regs + i, n * sizeof(uint32_t));
+        res = lms7002m_spi_post(m, seq, n);
+        if (res)
+            return res;
+    }
+
+    // Dump always ends with MAC selection
+    if (count && ((regs[count - 1] >> 16) & 0x7fff) == LML_0x0020) {
+        m->reg_mac = regs[count - 1];
+    }
+    return 0;
+}
+
+int lms7002m_regs_verify(lms7002m_state_t* m, const uint32_t* regs, unsigned count)
+{
+    uint32_t rmac = MAKE_LMS7002M_REG_WR(LML_0x0020, m->reg_mac);
+    int res = 0, rres;
+
+    for (unsigned i = 0; i < count && !res; i++) {
+        uint16_t addr = (regs[i] >> 16) & 0x7fff;
+        uint16_t val;
+
+        if (addr == LML_0x0020) {
+            uint32_t w = regs[i];
+            res = lms7002m_spi_post(m, &w, 1);
+            continue;
+        }
+        if (!_lms7002m_in_ranges(s_verify_regs, SIZEOF_ARRAY(s_verify_regs), addr))
+            continue;
+
+        res = lms7002m_spi_rd(m, addr, &val);
+        if (res == 0 && val != (uint16_t)regs[i]) {
+            USDR_LOG("7002", USDR_LOG_WARNING, "Register %04x readback %04x, expected %04x\n",
+                     addr, val, (uint16_t)regs[i]);
+            res = -ESTALE;
+        }
+    }
+
+    rres = lms7002m_spi_post(m, &rmac, 1);
+    return (res) ? res : rres;
+}
+
+static int _lms7002m_pll_cmp(lms7002m_state_t* m, bool cgen, bool* locked)
+{
+    uint16_t en, cmp;
+    bool active;
+    int res = lms7002m_spi_rd(m, cgen ? CGEN_ENABLE : SXX_0x011C, &en);
+    if (res)
+        return res;
+
+    active = (cgen) ?
+        GET_LMS7002M_CGEN_ENABLE_EN_G(en) && !GET_LMS7002M_CGEN_ENABLE_PD_VCO(en) &&
+            !GET_LMS7002M_CGEN_ENABLE_PD_VCO_COMP(en) :
+        GET_LMS7002M_SXX_0X011C_EN_G(en) && !GET_LMS7002M_SXX_0X011C_PD_VCO(en) &&
+            !GET_LMS7002M_SXX_0X011C_PD_VCO_COMP(en);
+    if (!active) {
+        // Powered down PLL or comparator, nothing to check
+        *locked = true;
+        return 0;
+    }
+
+    res = lms7002m_spi_rd(m, cgen ? CGEN_0x008C : SXX_0x0123, &cmp);
+    if (res)
+        return res;
+
+    *locked = ((cgen) ?
+                   (GET_LMS7002M_CGEN_0X008C_VCO_CMPHO(cmp) << 1) | GET_LMS7002M_CGEN_0X008C_VCO_CMPLO(cmp) :
+                   (GET_LMS7002M_SXX_0X0123_VCO_CMPHO(cmp) << 1) | GET_LMS7002M_SXX_0X0123_VCO_CMPLO(cmp)) ==
+              LMS7002M_VCO_OK;
+    return 0;
+}
+
+int lms7002m_pll_check(lms7002m_state_t* m, unsigned plls, unsigned* unlocked)
+{
+    uint32_t rmac = MAKE_LMS7002M_REG_WR(LML_0x0020, m->reg_mac);
+    bool locked;
+    int res = 0, rres;
+
+    *unlocked = 0;
+    if (plls & LMS7002M_PLL_CGEN) {
+        res = _lms7002m_pll_cmp(m, true, &locked);
+        if (res == 0 && !locked)
+            *unlocked |= LMS7002M_PLL_CGEN;
+    }
+
+    for (unsigned ch = 0; ch < 2 && !res; ch++) {
+        unsigned pll = (ch == 0) ? LMS7002M_PLL_SXR : LMS7002M_PLL_SXT;
+        uint16_t mac = m->reg_mac;
+        uint32_t w;
+        if (!(plls & pll))
+            continue;
+
+        SET_LMS7002M_LML_0X0020_MAC(mac, ch + 1);
+        w = MAKE_LMS7002M_REG_WR(LML_0x0020, mac);
+        res = lms7002m_spi_post(m, &w, 1);
+        res = (res) ? res : _lms7002m_pll_cmp(m, false, &locked);
+        if (res == 0 && !locked)
+            *unlocked |= pll;
+    }
+
+    rres = lms7002m_spi_post(m, &rmac, 1);
+    return (res) ? res : rres;
+}
@@ -7,6 +7,7 @@
 // LMS7002M control logic mostly for block specific perfective
 #include <stdint.h>
 #include <usdr_lowlevel.h>
+#include "lms7002m_gfir.h"
 
 // RFE path configuration for a single channel
 struct lms7002m_rfe_cfg {
@@ -62,6 +63,14 @@ struct lms7002m_state {
     uint16_t reg_txtsp_hbdo_iq[2];
     int8_t   reg_tbb_gc_corr[2];
     uint8_t  reg_tbb_gc[2];
+
+    // Last written RFE_0x0113, RBB_0x0119, RBB_0x011A per channel, 0 - unknown
+    uint16_t reg_rxgain[2][3];
+
+    // Register capture, when rec_buf is set writes are stored instead of being sent
+    uint32_t* rec_buf;
+    unsigned rec_cnt;
+    unsigned rec_max;
 };
 typedef struct lms7002m_state lms7002m_state_t;
 
@@ -169,6 +178,8 @@ typedef enum lms7002m_xxtsp lms7002m_xxtsp_t;
 int lms7002m_rxtsp_dc_corr(lms7002m_state_t* m, bool byp, unsigned wnd);
 
 int lms7002m_xxtsp_enable(lms7002m_state_t* m, lms7002m_xxtsp_t tsp, bool enable);
+// Toggle only EN bit of the cached mode register, bypasses and corrections stay as is
+int lms7002m_xxtsp_en(lms7002m_state_t* m, lms7002m_xxtsp_t tsp, bool enable);
 int lms7002m_xxtsp_int_dec(lms7002m_state_t* m, lms7002m_xxtsp_t tsp, unsigned intdec_ord);
 
 // XTSP data generator
@@ -187,6 +198,10 @@ int lms7002m_xxtsp_cmix(lms7002m_state_t* m, lms7002m_xxtsp_t tsp, int32_t freq)
 int lms7002m_xxtsp_iq_gcorr(lms7002m_state_t* m, lms7002m_xxtsp_t tsp, unsigned ig, unsigned qg);
 int lms7002m_xxtsp_iq_phcorr(lms7002m_state_t* m, lms7002m_xxtsp_t tsp, int acorr);
 
+// Load designed coefficients and clear GFIRx_BYP, @p d NULL bypasses @p gfir
+int lms7002m_xxtsp_gfir(lms7002m_state_t* m, lms7002m_xxtsp_t tsp, lms7002m_gfir_t gfir,
+                        const lms7002m_gfir_design_t* d);
+
 // RFE
 enum lms7002m_rfe_path {
     RFE_NONE = 0,
@@ -216,6 +231,16 @@ typedef enum lms7002m_rfe_gain lms7002m_rfe_gain_t;
 // Attenuation in dB * 10, e.g. for 3dB 30 should be given
 int lms7002m_rfe_gain(lms7002m_state_t* m, lms7002m_rfe_gain_t gain, int gainx10, int *goutx10);
 
+// Attenuation in dB * 10 of LNA / TIA register code, negative for unused codes
+int lms7002m_rfe_step_atten(lms7002m_rfe_gain_t gain, unsigned idx);
+
+// Set LNA / TIA codes and PGA gain (dB) of chs at once, only registers that
+// differ from the last written values are sent. Number of writes is returned
+// in writes (0 when nothing has changed).
+int lms7002m_rx_gain_set(lms7002m_state_t* m, unsigned chs,
+                         unsigned lna, unsigned tia, unsigned pga,
+                         unsigned* writes);
+
 // TRF
 enum lms7002m_trf_path {
     TRF_MUTE,
@@ -307,4 +332,50 @@ enum lms7002m_vco_comparator {
 // RFE - TRF loopback control
 lms7002m_trf_path_t lms7002m_trf_from_rfe_path(lms7002m_rfe_path_t rfe_path);
 
+// Capture all register writes of subsequent calls into buf instead of sending them,
+// cached state is updated as usual. The capture opens with the current MAC value.
+// Returns number of captured writes or -E2BIG when buf was too small.
+int lms7002m_rec_start(lms7002m_state_t* m, uint32_t* buf, unsigned max);
+int lms7002m_rec_stop(lms7002m_state_t* m);
+
+enum {
+    LMS7002M_SEQ_MAX = 64,
+};
+
+// Build the shortest write sequence moving chip from register state captured
+// in `from` to the one captured in `to`. Writes are merged per channel, only
+// registers with different resulting values are kept; from_cnt == 0 gives the
+// complete `to` state. Returns number of words in out or negative error.
+int lms7002m_regs_delta(lms7002m_state_t* m,
+                        const uint32_t* from, unsigned from_cnt,
+                        const uint32_t* to, unsigned to_cnt,
+                        uint32_t* out, unsigned max);
+
+// Send prepared sequence word by word (SPI cores take a single 32-bit command
+// per transaction), active MAC is restored at the end
+int lms7002m_regs_post(lms7002m_state_t* m, const uint32_t* regs, unsigned count);
+
+enum {
+    LMS7002M_DUMP_MAX = 1024,
+};
+
+// Read back complete writable register state of both channels (including
+// coefficients of active GFIRs) as a write sequence, returns number of words
+int lms7002m_regs_dump(lms7002m_state_t* m, uint32_t* out, unsigned max);
+
+// Write sequence obtained with lms7002m_regs_dump(), no VCO searches involved
+int lms7002m_regs_load(lms7002m_state_t* m, const uint32_t* regs, unsigned count);
+
+// Compare PLL configuration registers with the dump, -ESTALE on mismatch
+int lms7002m_regs_verify(lms7002m_state_t* m, const uint32_t* regs, unsigned count);
+
+enum lms7002m_pll {
+    LMS7002M_PLL_CGEN = 1,
+    LMS7002M_PLL_SXR = 2,
+    LMS7002M_PLL_SXT = 4,
+};
+
+// VCO comparators of powered up PLLs, mask of the ones out of lock in unlocked
+int lms7002m_pll_check(lms7002m_state_t* m, unsigned plls, unsigned* unlocked);
+
 #endif
@@ -0,0 +1,156 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include "lms7002m_gfir.h"
+
+#include <math.h>
+#include <errno.h>
+#include <string.h>
+
+enum {
+    GFIR_ONE = 32768,
+};
+
+// Quantization noise floor of Q15 coefficients, no point to design deeper
+#define GFIR_ATTEN_MAX   90.0
+#define GFIR_ATTEN_MIN   21.0
+
+static unsigned _gfir_banks(lms7002m_gfir_t gfir)
+{
+    return (gfir == LMS7_GFIR3) ? LMS7_GFIR3_BANKS : LMS7_GFIR12_BANKS;
+}
+
+unsigned lms7002m_gfir_max_taps(lms7002m_gfir_t gfir, unsigned clkdiv)
+{
+    if (clkdiv == 0 || clkdiv > LMS7_GFIR_CLKDIV_MAX)
+        return 0;
+
+    return _gfir_banks(gfir) * ((clkdiv > LMS7_GFIR_BANK_LEN) ? LMS7_GFIR_BANK_LEN : clkdiv);
+}
+
+static double _bessel_i0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (unsigned k = 1; k < 64; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12)
+            break;
+    }
+    return sum;
+}
+
+int lms7002m_gfir_design(lms7002m_gfir_t gfir, unsigned clkdiv,
+                         double pass, double stop,
+                         lms7002m_gfir_design_t* out)
+{
+    double h[LMS7_GFIR_TAPS_MAX];
+    double atten, beta, fc, sum = 0;
+    unsigned taps = lms7002m_gfir_max_taps(gfir, clkdiv);
+    unsigned banks = _gfir_banks(gfir);
+    int32_t qsum = 0;
+    int mid, center;
+
+    if (gfir > LMS7_GFIR3 || taps == 0)
+        return -EINVAL;
+    if (!(pass > 0 && pass < stop && stop <= 0.5))
+        return -EINVAL;
+
+    // Odd length, symmetric around the center tap
+    if ((taps & 1) == 0)
+        taps--;
+
+    // Kaiser length estimate solved for attenuation
+    fc = (pass + stop) / 2;
+    atten = 7.95 + 14.36 * (stop - pass) * (taps - 1);
+    if (atten > GFIR_ATTEN_MAX)
+        atten = GFIR_ATTEN_MAX;
+    if (atten < GFIR_ATTEN_MIN)
+        atten = GFIR_ATTEN_MIN;
+
+    beta = (atten > 50) ? 0.1102 * (atten - 8.7) :
+               0.5842 * pow(atten - 21, 0.4) + 0.07886 * (atten - 21);
+
+    mid = (int)taps / 2;
+    for (int k = 0; k < (int)taps; k++) {
+        double t = k - mid;
+        double r = t / mid;
+        double s = (t == 0) ? 2 * fc : sin(2 * M_PI * fc * t) / (M_PI * t);
+        double w = _bessel_i0(beta * sqrt(1.0 - r * r)) / _bessel_i0(beta);
+
+        h[k] = s * w;
+        sum += h[k];
+    }
+
+    memset(out, 0, sizeof(*out));
+    for (unsigned k = 0; k < taps; k++) {
+        long q = lround(h[k] / sum * GFIR_ONE);
+        if (q > INT16_MAX)
+            q = INT16_MAX;
+        if (q < INT16_MIN)
+            q = INT16_MIN;
+
+        out->coeffs[k] = (int16_t)q;
+        qsum += q;
+    }
+
+    // Exact unity DC gain, rounding error goes to the center tap
+    center = out->coeffs[mid] + (GFIR_ONE - qsum);
+    out->coeffs[mid] = (center > INT16_MAX) ? INT16_MAX : (int16_t)center;
+
+    out->gfir = gfir;
+    out->taps = taps;
+    out->l = (taps + banks - 1) / banks - 1;
+    out->n = clkdiv - 1;
+    out->atten_db = atten;
+    return 0;
+}
+
+unsigned lms7002m_gfir_image(const lms7002m_gfir_design_t* d, int16_t img[LMS7_GFIR_TAPS_MAX])
+{
+    unsigned banks = _gfir_banks(d->gfir);
+    unsigned per_bank = d->l + 1u;
+
+    for (unsigned b = 0; b < banks; b++) {
+        for (unsigned p = 0; p < LMS7_GFIR_BANK_LEN; p++) {
+            unsigned k = b * per_bank + p;
+            img[b * LMS7_GFIR_BANK_LEN + p] = (p < per_bank && k < d->taps) ? d->coeffs[k] : 0;
+        }
+    }
+    return banks;
+}
+
+void lms7002m_gfir_model(const lms7002m_gfir_design_t* d,
+                         int16_t hist[LMS7_GFIR_TAPS_MAX],
+                         const int16_t* in, int16_t* out, unsigned count)
+{
+    const unsigned taps = d->taps;
+
+    for (unsigned i = 0; i < count; i++) {
+        int64_t acc = 0;
+
+        // hist[0] is the newest sample
+        memmove(hist + 1, hist, (taps - 1) * sizeof(int16_t));
+        hist[0] = in[i];
+
+        for (unsigned k = 0; k < taps; k++) {
+            acc += (int32_t)d->coeffs[k] * hist[k];
+        }
+
+        acc = (acc + GFIR_ONE / 2) >> 15;
+        out[i] = (acc > INT16_MAX) ? INT16_MAX : (acc < INT16_MIN) ? INT16_MIN : (int16_t)acc;
+    }
+}
+
+double lms7002m_gfir_response_db(const lms7002m_gfir_design_t* d, double freq)
+{
+    double re = 0, im = 0, mag;
+
+    for (unsigned k = 0; k < d->taps; k++) {
+        re += d->coeffs[k] * cos(2 * M_PI * freq * k);
+        im -= d->coeffs[k] * sin(2 * M_PI * freq * k);
+    }
+
+    mag = sqrt(re * re + im * im) / GFIR_ONE;
+    return (mag < 1e-10) ? -200.0 : 20 * log10(mag);
+}
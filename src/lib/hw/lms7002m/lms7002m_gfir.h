@@ -0,0 +1,68 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef LMS7002M_GFIR_H
+#define LMS7002M_GFIR_H
+
+#include <stdint.h>
+
+// LMS7002M TSP general purpose FIR filters. GFIR1/GFIR2 have 5 banks,
+// GFIR3 has 15 banks; each bank is 8 coefficient words, one multiplier per
+// bank. Filters run at the TSP output rate (after HBD on RX, before HBI on TX)
+// with GFIRx_N + 1 TSP clocks per sample, so a bank computes up to
+// MIN(8, N + 1) taps, that is GFIRx_L + 1.
+//
+// Coefficients are 16 bit signed Q15, unity gain is 32768.
+
+enum lms7002m_gfir {
+    LMS7_GFIR1 = 0,
+    LMS7_GFIR2 = 1,
+    LMS7_GFIR3 = 2,
+};
+typedef enum lms7002m_gfir lms7002m_gfir_t;
+
+enum {
+    LMS7_GFIR_BANK_LEN = 8,
+    LMS7_GFIR12_BANKS = 5,
+    LMS7_GFIR3_BANKS = 15,
+
+    LMS7_GFIR_TAPS_MAX = LMS7_GFIR3_BANKS * LMS7_GFIR_BANK_LEN,
+    LMS7_GFIR_CLKDIV_MAX = 256,
+};
+
+struct lms7002m_gfir_design {
+    uint8_t gfir;   // lms7002m_gfir_t
+    uint8_t l;      // GFIRx_L
+    uint8_t n;      // GFIRx_N
+    uint8_t taps;
+    int16_t coeffs[LMS7_GFIR_TAPS_MAX];
+
+    float atten_db; // Target stopband attenuation used for the design
+};
+typedef struct lms7002m_gfir_design lms7002m_gfir_design_t;
+
+// Maximum number of taps at @p clkdiv TSP clocks per sample
+unsigned lms7002m_gfir_max_taps(lms7002m_gfir_t gfir, unsigned clkdiv);
+
+// Kaiser windowed lowpass, @p pass and @p stop are normalized to the filter
+// sample rate (0 .. 0.5). Longest odd length fitting the filter is used and
+// DC gain is trimmed to exact unity after quantization.
+int lms7002m_gfir_design(lms7002m_gfir_t gfir, unsigned clkdiv,
+                         double pass, double stop,
+                         lms7002m_gfir_design_t* out);
+
+// Coefficient memory image, @p img is filled with bank-ordered words
+// (LMS7_GFIR_BANK_LEN per bank) and number of banks is returned
+unsigned lms7002m_gfir_image(const lms7002m_gfir_design_t* d, int16_t img[LMS7_GFIR_TAPS_MAX]);
+
+// Software model of the quantized filter: 16 bit input, wide accumulator,
+// Q15 rounding and 16 bit saturation on the output. @p hist keeps the last
+// taps - 1 input samples between calls and must be zeroed initially.
+void lms7002m_gfir_model(const lms7002m_gfir_design_t* d,
+                         int16_t hist[LMS7_GFIR_TAPS_MAX],
+                         const int16_t* in, int16_t* out, unsigned count);
+
+// Magnitude response of the quantized filter in dB, @p freq is normalized
+double lms7002m_gfir_response_db(const lms7002m_gfir_design_t* d, double freq);
+
+#endif
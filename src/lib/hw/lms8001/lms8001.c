@@ -6,6 +6,8 @@
 
 #include <usdr_logging.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 
 enum lms8_vco_params {
     LMS8_VCO1_MIN = 4400000000ULL,
@@ -22,6 +24,16 @@ enum {
     LMS_LDO_1P25 = 101,
 };
 
+enum {
+    LMS8_PROFILE_STRIDE = PLL_PROFILE_1_PLL_ENABLE_n - PLL_PROFILE_0_PLL_ENABLE_n,
+
+    LMS8_CAL_POLLS = 100,
+    LMS8_LOCK_POLLS = 100,
+};
+
+// Relocate PLL_PROFILE_0 register write to profile p
+#define LMS8_PROFILE_WR(p, wr) ((wr) + (((uint32_t)(p) * LMS8_PROFILE_STRIDE) << 16))
+
 static int lms8001_spi_post(lms8001_state_t* obj, uint32_t* regs, unsigned count)
 {
     int res;
@@ -30,14 +42,34 @@ static int lms8001_spi_post(lms8001_state_t* obj, uint32_t* regs, unsigned count
         if (res)
             return res;
 
+        obj->spi_count++;
         USDR_LOG("8001", USDR_LOG_INFO, "[%d/%d] reg wr %08x\n", i, count, regs[i]);
     }
 
     return 0;
 }
 
-// TODO: Add profile
-int lms8001_tune(lms8001_state_t* state, unsigned fref, uint64_t out)
+static int lms8001_reg_rd(lms8001_state_t* obj, uint16_t addr, uint16_t* val)
+{
+    uint32_t dout = 0;
+    int res = lowlevel_spi_tr32(obj->dev, obj->subdev, obj->lsaddr, (uint32_t)addr << 16, &dout);
+    if (res)
+        return res;
+
+    obj->spi_count++;
+    *val = dout;
+    return 0;
+}
+
+static uint64_t lms8001_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Program PLL profile and run VCO auto calibration on it, profile becomes active
+static int lms8001_profile_program(lms8001_state_t* state, unsigned p, unsigned fref, uint64_t out)
 {
     if (out > LMS8_VCO3_MAX) {
         return -EINVAL;
@@ -46,6 +78,7 @@ int lms8001_tune(lms8001_state_t* state, unsigned fref, uint64_t out)
     int res;
     uint64_t vco;
     unsigned divi = 0;
+    uint16_t cal = 0;
 
     for (divi = 0; divi < 4; divi++) {
         vco = out << divi;
@@ -64,44 +97,243 @@ int lms8001_tune(lms8001_state_t* state, unsigned fref, uint64_t out)
         return -EINVAL;
     }
 
-    USDR_LOG("8001", USDR_LOG_ERROR, "OUT=%.3f VCO=%.3f PLL NINT=%d FRAC=%d DIV=%d\n",
-             out  / 1.0e6, vco / 1.0e6, (unsigned)nint, (unsigned)frac, (1 << divi));
+    USDR_LOG("8001", USDR_LOG_ERROR, "OUT=%.3f VCO=%.3f PLL NINT=%d FRAC=%d DIV=%d PROFILE=%d\n",
+             out  / 1.0e6, vco / 1.0e6, (unsigned)nint, (unsigned)frac, (1 << divi), p);
 
     // TODO: Prescaler DIV
     uint32_t pll_regs[] = {
-        MAKE_LMS8001_PLL_PROFILE_0_PLL_LPF_CFG1_n(1, 1, 8, 8),
-        MAKE_LMS8001_PLL_PROFILE_0_PLL_LPF_CFG2_n(1, 0, 8),
+        LMS8_PROFILE_WR(p, MAKE_LMS8001_PLL_PROFILE_0_PLL_LPF_CFG1_n(1, 1, 8, 8)),
+        LMS8_PROFILE_WR(p, MAKE_LMS8001_PLL_PROFILE_0_PLL_LPF_CFG2_n(1, 0, 8)),
 
         //MAKE_LMS8001_PLL_PROFILE_0_PLL_CP_CFG0_n(0, 0, 4, 0),
         //MAKE_LMS8001_PLL_PROFILE_0_PLL_CP_CFG1_n(2, 16),
 
-        MAKE_LMS8001_PLL_PROFILE_0_PLL_CP_CFG0_n(0, 0, 2, 1),
-        MAKE_LMS8001_PLL_PROFILE_0_PLL_CP_CFG1_n(2, 5),
+        LMS8_PROFILE_WR(p, MAKE_LMS8001_PLL_PROFILE_0_PLL_CP_CFG0_n(0, 0, 2, 1)),
+        LMS8_PROFILE_WR(p, MAKE_LMS8001_PLL_PROFILE_0_PLL_CP_CFG1_n(2, 5)),
 
-        MAKE_LMS8001_PLL_PROFILE_0_PLL_VCO_CFG_n(0, 1, 2, 3, 1),
-        MAKE_LMS8001_PLL_PROFILE_0_PLL_FF_CFG_n(divi == 0 ? 0 : 1, divi, divi),
+        LMS8_PROFILE_WR(p, MAKE_LMS8001_PLL_PROFILE_0_PLL_VCO_CFG_n(0, 1, 2, 3, 1)),
+        LMS8_PROFILE_WR(p, MAKE_LMS8001_PLL_PROFILE_0_PLL_FF_CFG_n(divi == 0 ? 0 : 1, divi, divi)),
 
-        MAKE_LMS8001_PLL_PROFILE_0_PLL_SDM_CFG_n(frac == 0 ? 1 : 0, 1, 0, 0, nint),
+        LMS8_PROFILE_WR(p, MAKE_LMS8001_PLL_PROFILE_0_PLL_SDM_CFG_n(frac == 0 ? 1 : 0, 1, 0, 0, nint)),
 
-        MAKE_LMS8001_PLL_PROFILE_0_PLL_FRACMODL_n(frac),
-        MAKE_LMS8001_PLL_PROFILE_0_PLL_FRACMODH_n(frac >> 16),
+        LMS8_PROFILE_WR(p, MAKE_LMS8001_PLL_PROFILE_0_PLL_FRACMODL_n(frac)),
+        LMS8_PROFILE_WR(p, MAKE_LMS8001_PLL_PROFILE_0_PLL_FRACMODH_n(frac >> 16)),
 
-        // Auto calibration
-        MAKE_LMS8001_PLL_CONFIGURATION_PLL_CFG(1, 1, 0, 1, 1, 0, 0),
+        // Auto calibration of the selected profile
+        MAKE_LMS8001_PLL_CONFIGURATION_PLL_CFG(1, 1, 0, 1, 1, 0, p),
         MAKE_LMS8001_PLL_CONFIGURATION_PLL_CAL_AUTO1(0, 1, 7, 0),
 
         // Enable (divider disabled)
-        MAKE_LMS8001_PLL_PROFILE_0_PLL_ENABLE_n(1, 0, 1, 1, 1, 1, 1, 1, divi == 0 ? 0 : 1, 0, 1, 1, 1),
+        LMS8_PROFILE_WR(p, MAKE_LMS8001_PLL_PROFILE_0_PLL_ENABLE_n(1, 0, 1, 1, 1, 1, 1, 1, divi == 0 ? 0 : 1, 0, 1, 1, 1)),
 
         // Start auto calibration
         MAKE_LMS8001_PLL_CONFIGURATION_PLL_CAL_AUTO0(1, 0, 0, 0, 0),
 
         // LO dist settings
-        MAKE_LMS8001_PLL_PROFILE_0_PLL_LODIST_CFG_n(state->chan_mask, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0),
+        LMS8_PROFILE_WR(p, MAKE_LMS8001_PLL_PROFILE_0_PLL_LODIST_CFG_n(state->chan_mask, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0)),
     };
 
+    state->profiles[p].lo = 0;
+    state->active_profile = p;
+
     res = lms8001_spi_post(state, pll_regs, SIZEOF_ARRAY(pll_regs));
-    return res;
+    if (res)
+        return res;
+
+    for (unsigned i = 0; i < LMS8_CAL_POLLS; i++) {
+        res = lms8001_reg_rd(state, PLL_CONFIGURATION_PLL_CAL_AUTO0, &cal);
+        if (res)
+            return res;
+
+        if (GET_LMS8001_PLL_CONFIGURATION_PLL_CAL_AUTO0_FREQ_FINAL_VAL(cal) &&
+            GET_LMS8001_PLL_CONFIGURATION_PLL_CAL_AUTO0_VCO_SEL_FINAL_VAL(cal))
+            break;
+
+        usleep(10);
+    }
+
+    if (!GET_LMS8001_PLL_CONFIGURATION_PLL_CAL_AUTO0_FREQ_FINAL_VAL(cal) ||
+        !GET_LMS8001_PLL_CONFIGURATION_PLL_CAL_AUTO0_VCO_SEL_FINAL_VAL(cal)) {
+        // Leave PLL in auto calibration mode, profile will be recalibrated on next use
+        USDR_LOG("8001", USDR_LOG_WARNING, "Profile %d: no VCO calibration results, profile isn't cached\n", p);
+        return 0;
+    }
+
+    state->profiles[p].vco_sel = GET_LMS8001_PLL_CONFIGURATION_PLL_CAL_AUTO0_VCO_SEL_FINAL(cal);
+    state->profiles[p].vco_freq = GET_LMS8001_PLL_CONFIGURATION_PLL_CAL_AUTO0_FREQ_FINAL(cal);
+
+    // Keep calibration results in the profile so switching to it doesn't need recalibration
+    uint32_t store_regs[] = {
+        LMS8_PROFILE_WR(p, MAKE_LMS8001_PLL_PROFILE_0_PLL_VCO_FREQ_n(state->profiles[p].vco_freq)),
+        LMS8_PROFILE_WR(p, MAKE_LMS8001_PLL_PROFILE_0_PLL_VCO_CFG_n(0, 1, 2, state->profiles[p].vco_sel, 1)),
+        MAKE_LMS8001_PLL_CONFIGURATION_PLL_CAL_AUTO0(0, 0, 0, 0, 0),
+        MAKE_LMS8001_PLL_CONFIGURATION_PLL_CFG(1, 1, 0, 0, 1, 0, p),
+    };
+
+    res = lms8001_spi_post(state, store_regs, SIZEOF_ARRAY(store_regs));
+    if (res)
+        return res;
+
+    state->profiles[p].lo = out;
+    state->profiles[p].fref = fref;
+
+    USDR_LOG("8001", USDR_LOG_INFO, "Profile %d: LO %.3f Mhz calibrated VCO%d CAP=%d\n",
+             p, out / 1.0e6, state->profiles[p].vco_sel, state->profiles[p].vco_freq);
+    return 0;
+}
+
+static int lms8001_profile_select(lms8001_state_t* state, unsigned p)
+{
+    uint32_t sel_regs[] = {
+        MAKE_LMS8001_PLL_CONFIGURATION_PLL_CFG(1, 1, 0, 0, 1, 0, p),
+    };
+
+    state->active_profile = p;
+    return lms8001_spi_post(state, sel_regs, SIZEOF_ARRAY(sel_regs));
+}
+
+// Returns cached profile for the frequency, or a free / least recently used one
+// other than @p keep
+static unsigned lms8001_profile_lookup(lms8001_state_t* state, unsigned fref, uint64_t out,
+                                       unsigned keep, bool* hit)
+{
+    unsigned lru = (keep == 0) ? 1 : 0;
+
+    for (unsigned p = 0; p < LMS8001_PLL_PROFILES; p++) {
+        if (state->profiles[p].lo == out && state->profiles[p].fref == fref) {
+            *hit = true;
+            return p;
+        }
+    }
+
+    *hit = false;
+    for (unsigned p = 0; p < LMS8001_PLL_PROFILES; p++) {
+        if (p == keep)
+            continue;
+        if (state->profiles[p].lo == 0)
+            return p;
+
+        if (state->profiles[p].last_use < state->profiles[lru].last_use)
+            lru = p;
+    }
+    return lru;
+}
+
+static int lms8001_wait_lock(lms8001_state_t* state, bool* locked)
+{
+    int res;
+    uint16_t status;
+
+    *locked = false;
+    for (unsigned i = 0; i < LMS8_LOCK_POLLS; i++) {
+        res = lms8001_reg_rd(state, PLL_CONFIGURATION_PLL_CFG_STATUS, &status);
+        if (res)
+            return res;
+
+        if (GET_LMS8001_PLL_CONFIGURATION_PLL_CFG_STATUS_PLL_LOCK(status)) {
+            *locked = true;
+            return 0;
+        }
+
+        usleep(5);
+    }
+
+    return 0;
+}
+
+int lms8001_hop(lms8001_state_t* state, unsigned fref, uint64_t out, struct lms8001_hop_stat* stat)
+{
+    struct lms8001_hop_stat hs;
+    unsigned spi_start = state->spi_count;
+    uint64_t start = lms8001_now_ns();
+    bool hit;
+    int res;
+
+    unsigned p = lms8001_profile_lookup(state, fref, out, LMS8001_PLL_PROFILES, &hit);
+    if (hit && p == state->active_profile) {
+        res = 0;
+    } else if (hit) {
+        res = lms8001_profile_select(state, p);
+    } else {
+        res = lms8001_profile_program(state, p, fref, out);
+    }
+    if (res)
+        return res;
+
+    state->profiles[p].last_use = ++state->use_stamp;
+
+    hs.profile = p;
+    hs.hit = hit;
+    res = lms8001_wait_lock(state, &hs.locked);
+    if (res)
+        return res;
+
+    hs.spi_transactions = state->spi_count - spi_start;
+    hs.settle_ns = lms8001_now_ns() - start;
+
+    USDR_LOG("8001", (hs.locked) ? USDR_LOG_INFO : USDR_LOG_WARNING,
+             "LO %.3f Mhz on profile %d (%s): %d SPI transactions, %s in %.1f us\n",
+             out / 1.0e6, p, hit ? "hop" : "calibrated", hs.spi_transactions,
+             hs.locked ? "locked" : "NOT locked", hs.settle_ns / 1000.0);
+
+    state->last_hop = hs;
+    if (stat) {
+        *stat = hs;
+    }
+    return (hs.locked) ? 0 : -ETIMEDOUT;
+}
+
+int lms8001_tune(lms8001_state_t* state, unsigned fref, uint64_t out)
+{
+    return lms8001_hop(state, fref, out, NULL);
+}
+
+int lms8001_profile_preload(lms8001_state_t* state, unsigned fref, const uint64_t* lo, unsigned count)
+{
+    unsigned prev = state->active_profile;
+    uint64_t prev_lo = state->profiles[prev].lo;
+    unsigned prev_fref = state->profiles[prev].fref;
+    unsigned keep = (prev_lo != 0) ? prev : LMS8001_PLL_PROFILES;
+    bool hit, locked;
+    int res = 0, rres;
+
+    if (count > LMS8001_PLL_PROFILES - ((prev_lo != 0) ? 1 : 0))
+        return -EINVAL;
+
+    for (unsigned i = 0; i < count && res == 0; i++) {
+        unsigned p = lms8001_profile_lookup(state, fref, lo[i], keep, &hit);
+        if (!hit) {
+            res = lms8001_profile_program(state, p, fref, lo[i]);
+        }
+
+        state->profiles[p].last_use = ++state->use_stamp;
+    }
+
+    if (prev_lo == 0)
+        return res;
+
+    // Go back to the LO which was in use before preloading, it's never evicted
+    // but calibration could have been lost on a failed programming
+    if (state->profiles[prev].lo == prev_lo) {
+        rres = (state->active_profile != prev) ? lms8001_profile_select(state, prev) : 0;
+    } else {
+        rres = lms8001_profile_program(state, prev, prev_fref, prev_lo);
+    }
+
+    rres = (rres) ? rres : lms8001_wait_lock(state, &locked);
+    if (rres == 0 && !locked)
+        rres = -ETIMEDOUT;
+    if (rres) {
+        USDR_LOG("8001", USDR_LOG_ERROR, "Unable to restore LO %.3f Mhz after preloading, error %d\n",
+                 prev_lo / 1.0e6, rres);
+    }
+
+    return (res) ? res : rres;
+}
+
+void lms8001_profile_flush(lms8001_state_t* state)
+{
+    memset(state->profiles, 0, sizeof(state->profiles));
 }
 
 int lms8001_ch_enable(lms8001_state_t* state, unsigned mask)
@@ -111,6 +343,9 @@ int lms8001_ch_enable(lms8001_state_t* state, unsigned mask)
 
     state->chan_mask = mask;
 
+    // LO distribution is a part of every profile
+    lms8001_profile_flush(state);
+
     uint32_t en_regs[] = {
         MAKE_LMS8001_BIASLDOCONFIG_LOBUFA_LDO_Config(0, 0, e[0], LMS_LDO_1P25),
         MAKE_LMS8001_BIASLDOCONFIG_LOBUFB_LDO_Config(0, 0, e[1], LMS_LDO_1P25),
@@ -151,6 +386,12 @@ int lms8001_create(lldev_t dev, unsigned subdev, unsigned lsaddr, lms8001_state_
     out->subdev = subdev;
     out->lsaddr = lsaddr;
 
+    out->spi_count = 0;
+    out->use_stamp = 0;
+    out->active_profile = 0;
+    memset(&out->last_hop, 0, sizeof(out->last_hop));
+    lms8001_profile_flush(out);
+
     res = lms8001_spi_post(out, lms_init, SIZEOF_ARRAY(lms_init));
 
     // Move away!
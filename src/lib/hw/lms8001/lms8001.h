@@ -6,9 +6,31 @@
 
 // LMS8001 control logic mostly for block specific perfective
 #include <stdint.h>
+#include <stdbool.h>
 #include <usdr_lowlevel.h>
 
 
+enum {
+    LMS8001_PLL_PROFILES = 8,
+};
+
+// Calibrated PLL profile cached in the chip
+struct lms8001_pll_profile {
+    uint64_t lo;        // 0 -- profile is free
+    unsigned fref;
+    unsigned last_use;  // LRU stamp
+    uint8_t vco_sel;
+    uint8_t vco_freq;
+};
+
+struct lms8001_hop_stat {
+    unsigned profile;
+    unsigned spi_transactions;
+    uint32_t settle_ns;
+    bool hit;           // Profile was already calibrated, only switched
+    bool locked;
+};
+
 struct lms8001_state {
     lldev_t dev;
     unsigned subdev;
@@ -16,6 +38,12 @@ struct lms8001_state {
 
     // Enabled channel masks
     unsigned chan_mask;
+
+    unsigned spi_count;
+    unsigned use_stamp;
+    unsigned active_profile;
+    struct lms8001_pll_profile profiles[LMS8001_PLL_PROFILES];
+    struct lms8001_hop_stat last_hop;
 };
 typedef struct lms8001_state lms8001_state_t;
 
@@ -23,7 +51,20 @@ typedef struct lms8001_state lms8001_state_t;
 int lms8001_create(lldev_t dev, unsigned subdev, unsigned lsaddr, lms8001_state_t *out);
 int lms8001_destroy(lms8001_state_t* m);
 
+// Tune LO, switching to a cached PLL profile when the frequency has been used before
 int lms8001_tune(lms8001_state_t* state, unsigned fref, uint64_t out);
 int lms8001_ch_enable(lms8001_state_t* state, unsigned mask);
 
+// Same as lms8001_tune() with SPI transaction count and settle time of the hop,
+// -ETIMEDOUT when PLL didn't lock (statistics are filled anyway)
+int lms8001_hop(lms8001_state_t* state, unsigned fref, uint64_t out, struct lms8001_hop_stat* stat);
+
+// Program and calibrate up to LMS8001_PLL_PROFILES frequencies (one less while
+// a profile is active), least recently used profiles are evicted. The active
+// profile is never evicted and is selected back, error if it doesn't lock.
+int lms8001_profile_preload(lms8001_state_t* state, unsigned fref, const uint64_t* lo, unsigned count);
+
+// Forget all cached profiles
+void lms8001_profile_flush(lms8001_state_t* state);
+
 #endif
@@ -25,6 +25,15 @@ int si549_reg_wr(lldev_t dev, subdev_t subdev, lsopaddr_t ls_op_addr,
                                         0, NULL, 2, data);
 }
 
+static
+int si549_reg_q(struct lowlevel_i2c_queue* q, lsopaddr_t ls_op_addr,
+                uint8_t addr, uint8_t val)
+{
+    uint8_t data[2] = {addr, val};
+    int res = lowlevel_i2c_q_add(q, ls_op_addr, 2, data, 0);
+    return (res < 0) ? res : 0;
+}
+
 enum si549_helpers {
     si549_Fvco_min = 10800000000,
     si549_Fvco_max = 12109728345,
@@ -73,23 +82,28 @@ int si549_set_freq(lldev_t dev, subdev_t subdev, lsopaddr_t addr,
     fbdiv_frac = frem;
 
     USDR_LOG("S549", USDR_LOG_INFO, "Si549 LSDIV=%d/%d, HSDIV=%d, VCO=%" PRIu64 " FBDIV=%u/%u\n", lsdiv, lsdiv_rv, hsdiv, fvco, fbdiv, fbdiv_frac);
-    si549_reg_wr(dev, subdev, addr, 255, 0);
-    si549_reg_wr(dev, subdev, addr, 69, 0);
-    si549_reg_wr(dev, subdev, addr, 17, 0);
-
-    si549_reg_wr(dev, subdev, addr, 23, hsdiv & 0xff);
-    si549_reg_wr(dev, subdev, addr, 24, ((lsdiv_rv) << 4) | ((hsdiv >> 8) & 0x7));
-    si549_reg_wr(dev, subdev, addr, 26, fbdiv_frac & 0xff);
-    si549_reg_wr(dev, subdev, addr, 27, (fbdiv_frac >> 8) & 0xff);
-    si549_reg_wr(dev, subdev, addr, 28, (fbdiv_frac >> 16) & 0xff);
-    si549_reg_wr(dev, subdev, addr, 29, (fbdiv_frac >> 24) & 0xff);
-    si549_reg_wr(dev, subdev, addr, 30, fbdiv & 0xff);
-    si549_reg_wr(dev, subdev, addr, 31, (fbdiv >> 8) & 0xff);
-
-    si549_reg_wr(dev, subdev, addr, 7, 8);
-    si549_reg_wr(dev, subdev, addr, 17, 1);
-
-    return 0;
+    struct lowlevel_i2c_queue q;
+    int res = 0;
+
+    // Whole update goes as one queue, the output is held off until the last write
+    lowlevel_i2c_q_init(&q);
+    res = (res) ? res : si549_reg_q(&q, addr, 255, 0);
+    res = (res) ? res : si549_reg_q(&q, addr, 69, 0);
+    res = (res) ? res : si549_reg_q(&q, addr, 17, 0);
+
+    res = (res) ? res : si549_reg_q(&q, addr, 23, hsdiv & 0xff);
+    res = (res) ? res : si549_reg_q(&q, addr, 24, ((lsdiv_rv) << 4) | ((hsdiv >> 8) & 0x7));
+    res = (res) ? res : si549_reg_q(&q, addr, 26, fbdiv_frac & 0xff);
+    res = (res) ? res : si549_reg_q(&q, addr, 27, (fbdiv_frac >> 8) & 0xff);
+    res = (res) ? res : si549_reg_q(&q, addr, 28, (fbdiv_frac >> 16) & 0xff);
+    res = (res) ? res : si549_reg_q(&q, addr, 29, (fbdiv_frac >> 24) & 0xff);
+    res = (res) ? res : si549_reg_q(&q, addr, 30, fbdiv & 0xff);
+    res = (res) ? res : si549_reg_q(&q, addr, 31, (fbdiv >> 8) & 0xff);
+
+    res = (res) ? res : si549_reg_q(&q, addr, 7, 8);
+    res = (res) ? res : si549_reg_q(&q, addr, 17, 1);
+
+    return (res) ? res : lowlevel_i2c_q_exec(dev, subdev, &q);
 }
 
 int si549_enable(lldev_t dev, subdev_t subdev, lsopaddr_t addr, bool enable)
@@ -7,6 +7,7 @@
 
 enum dma_rx32 {
     DMA_BUFFERS = 32,
+    DMA_MAX_BURSTS = 32, // Limited by burst mask width
 };
 
 enum dma_rx32_cfg_regs {
@@ -116,3 +117,15 @@ int dma_rx32_configure(lldev_t dev,
     return 0;
 }
 
+int dma_rx32_set_bursts(lldev_t dev,
+                        subdev_t subdev,
+                        unsigned cfg_dma_base,
+                        unsigned burstspblk)
+{
+    if (burstspblk == 0 || burstspblk > DMA_MAX_BURSTS)
+        return -EINVAL;
+
+    return lowlevel_reg_wr32(dev, subdev,
+                             cfg_dma_base + DRX32_CFG_BBURSTSZ,
+                             burstspblk - 1);
+}
@@ -29,4 +29,11 @@ int dma_rx32_configure(lldev_t dev,
                        unsigned cfg_dma_base,
                        const struct fifo_config* pfc,
                        unsigned flags);
+
+// Change number of bursts in DMA buffer on the fly, burst size is kept
+// intact so new value is picked up on the next buffer boundary
+int dma_rx32_set_bursts(lldev_t dev,
+                        subdev_t subdev,
+                        unsigned cfg_dma_base,
+                        unsigned burstspblk);
 #endif
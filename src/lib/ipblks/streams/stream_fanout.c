@@ -0,0 +1,514 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <inttypes.h>
+
+#include "stream_fanout.h"
+
+#include <usdr_logging.h>
+#include "../../xdsp/conv.h"
+
+struct stream_fanout_slot {
+    void* buf;
+    struct usdr_dms_recv_nfo nfo;
+    unsigned refs;
+};
+
+struct stream_fanout_reader {
+    struct stream_handle base;
+    stream_fanout_t* fan;
+
+    unsigned policy;
+    bool busy;           // Converting slot at `seq` outside of the lock
+    uint64_t seq;        // Next slot to consume
+
+    conv_function_t tf_data;
+    size_function_t tf_size;
+
+    uint64_t pkts;
+    uint64_t dropped;    // Packets dropped by the overflow policy
+    unsigned lost_syms;  // Lost symbols not yet reported to the user
+};
+typedef struct stream_fanout_reader stream_fanout_reader_t;
+
+struct stream_fanout {
+    stream_handle_t* src;
+
+    pthread_mutex_t mtx;
+    pthread_cond_t cond;
+
+    unsigned depth;
+    uint64_t head;       // Oldest slot not returned to the hardware
+    uint64_t tail;       // Next slot to fetch from the source
+    bool fetching;
+
+    char wire_fmt[16];
+    unsigned wire_bytes;
+    usdr_dms_nfo_t snfo;
+
+    unsigned rcnt;
+    stream_fanout_reader_t* readers[FANOUT_MAX_READERS];
+    struct stream_fanout_slot slots[FANOUT_MAX_DEPTH];
+};
+
+static struct stream_fanout_slot* _fanout_slot(stream_fanout_t* fan, uint64_t seq)
+{
+    return &fan->slots[seq % fan->depth];
+}
+
+// Return consumed buffers to the hardware, strictly in order
+static int _fanout_release_done(stream_fanout_t* fan)
+{
+    int res = 0;
+    while (fan->head != fan->tail) {
+        struct stream_fanout_slot* s = _fanout_slot(fan, fan->head);
+        if (s->refs)
+            break;
+
+        res = fan->src->ops->release_raw(fan->src, s->buf);
+        if (res) {
+            USDR_LOG("FOUT", USDR_LOG_ERROR, "Unable to release wire buffer %p, error %d\n",
+                     s->buf, res);
+        }
+        s->buf = NULL;
+        fan->head++;
+    }
+    return res;
+}
+
+static void _fanout_reader_drop(stream_fanout_t* fan, stream_fanout_reader_t* r, uint64_t upto)
+{
+    for (; r->seq < upto; r->seq++) {
+        struct stream_fanout_slot* s = _fanout_slot(fan, r->seq);
+        s->refs--;
+        r->dropped++;
+        r->lost_syms += s->nfo.totsyms;
+    }
+}
+
+// Force lagging non-blocking readers to let the oldest slot go
+static void _fanout_evict_oldest(stream_fanout_t* fan)
+{
+    for (unsigned i = 0; i < fan->rcnt; i++) {
+        stream_fanout_reader_t* r = fan->readers[i];
+        if (r->seq != fan->head || r->busy || r->policy == USDR_DMS_FANOUT_BLOCK)
+            continue;
+
+        USDR_LOG("FOUT", USDR_LOG_DEBUG, "Reader %p overrun, dropping packet %" PRIu64 "\n",
+                 r, r->seq);
+        _fanout_reader_drop(fan, r, r->seq + 1);
+    }
+}
+
+static int _fanout_wait(stream_fanout_t* fan, const struct timespec* deadline)
+{
+    if (deadline == NULL)
+        return pthread_cond_wait(&fan->cond, &fan->mtx);
+
+    return pthread_cond_timedwait(&fan->cond, &fan->mtx, deadline);
+}
+
+// Milliseconds left until deadline rounded up, ~0u for no deadline
+static unsigned _fanout_remaining_ms(const struct timespec* deadline)
+{
+    struct timespec now;
+    int64_t ns;
+
+    if (deadline == NULL)
+        return ~0u;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    ns = (int64_t)(deadline->tv_sec - now.tv_sec) * 1000000000 + (deadline->tv_nsec - now.tv_nsec);
+    return (ns > 0) ? (unsigned)((ns + 999999) / 1000000) : 0;
+}
+
+// Wait for the next slot of the reader, returns with the slot marked busy
+static
+int _fanout_reader_acquire(stream_fanout_reader_t* r,
+                           unsigned timeout,
+                           struct usdr_dms_recv_nfo* nfo,
+                           struct stream_fanout_slot** pslot)
+{
+    stream_fanout_t* fan = r->fan;
+    struct stream_fanout_slot* slot;
+    struct timespec ts, *deadline = NULL;
+    int res = 0;
+
+    if (timeout != ~0u) {
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += timeout / 1000;
+        ts.tv_nsec += (timeout % 1000) * 1000000;
+        if (ts.tv_nsec >= 1000000000) {
+            ts.tv_nsec -= 1000000000;
+            ts.tv_sec++;
+        }
+        deadline = &ts;
+    }
+
+    pthread_mutex_lock(&fan->mtx);
+    if (r->busy) {
+        pthread_mutex_unlock(&fan->mtx);
+        return -EBUSY;
+    }
+
+    for (;;) {
+        if (r->policy == USDR_DMS_FANOUT_SKIP && fan->tail - r->seq > 1) {
+            // Latest only reader, never deliver stale data
+            _fanout_reader_drop(fan, r, fan->tail - 1);
+            _fanout_release_done(fan);
+        }
+
+        if (r->seq != fan->tail)
+            break;
+
+        if (fan->tail - fan->head == fan->depth) {
+            _fanout_evict_oldest(fan);
+            _fanout_release_done(fan);
+        }
+
+        if (fan->tail - fan->head == fan->depth || fan->fetching) {
+            // Waiting for slow blocking reader or other reader fetching data
+            res = _fanout_wait(fan, deadline);
+            if (res == ETIMEDOUT) {
+                pthread_mutex_unlock(&fan->mtx);
+                return -ETIMEDOUT;
+            }
+            continue;
+        }
+
+        // Time spent waiting above counts against the caller's timeout,
+        // an expired deadline still polls the source once
+        unsigned left = _fanout_remaining_ms(deadline);
+        slot = _fanout_slot(fan, fan->tail);
+        fan->fetching = true;
+        pthread_mutex_unlock(&fan->mtx);
+
+        res = fan->src->ops->recv_raw(fan->src, &slot->buf, left, &slot->nfo);
+
+        pthread_mutex_lock(&fan->mtx);
+        fan->fetching = false;
+        if (res == 0) {
+            slot->refs = fan->rcnt;
+            fan->tail++;
+        }
+        pthread_cond_broadcast(&fan->cond);
+        if (res) {
+            pthread_mutex_unlock(&fan->mtx);
+            return res;
+        }
+    }
+
+    slot = _fanout_slot(fan, r->seq);
+    r->busy = true;
+    if (nfo) {
+        nfo->fsymtime = slot->nfo.fsymtime;
+        nfo->totsyms = slot->nfo.totsyms;
+        nfo->totlost = r->lost_syms;
+        nfo->extra = slot->nfo.extra;
+        nfo->stats = NULL;
+    }
+    r->lost_syms = 0;
+    pthread_mutex_unlock(&fan->mtx);
+
+    *pslot = slot;
+    return 0;
+}
+
+static
+int _fanout_reader_finish(stream_fanout_reader_t* r, struct stream_fanout_slot* slot)
+{
+    stream_fanout_t* fan = r->fan;
+    int res;
+
+    pthread_mutex_lock(&fan->mtx);
+    r->busy = false;
+    r->pkts++;
+    r->seq++;
+    slot->refs--;
+    res = _fanout_release_done(fan);
+    pthread_cond_broadcast(&fan->cond);
+    pthread_mutex_unlock(&fan->mtx);
+    return res;
+}
+
+static
+int _fanout_reader_recv(stream_handle_t* str,
+                        char** stream_buffs,
+                        unsigned timeout,
+                        struct usdr_dms_recv_nfo* nfo)
+{
+    stream_fanout_reader_t* r = (stream_fanout_reader_t*)str;
+    stream_fanout_t* fan = r->fan;
+    struct stream_fanout_slot* slot;
+    unsigned wire_bytes;
+    int res;
+
+    res = _fanout_reader_acquire(r, timeout, nfo, &slot);
+    if (res)
+        return res;
+
+    // Packet size may be altered on the fly, keep layout in sync with the source
+    wire_bytes = (uint64_t)slot->nfo.totsyms * fan->wire_bytes / fan->snfo.pktsyms;
+    r->tf_data((const void**)&slot->buf, wire_bytes, (void**)stream_buffs, r->tf_size(wire_bytes, false));
+
+    return _fanout_reader_finish(r, slot);
+}
+
+// Wire buffer is shared with other readers and must be treated as read-only
+static
+int _fanout_reader_recv_raw(stream_handle_t* str,
+                            void** wire_buf,
+                            unsigned timeout,
+                            struct usdr_dms_recv_nfo* nfo)
+{
+    stream_fanout_reader_t* r = (stream_fanout_reader_t*)str;
+    struct stream_fanout_slot* slot;
+    int res;
+
+    res = _fanout_reader_acquire(r, timeout, nfo, &slot);
+    if (res)
+        return res;
+
+    *wire_buf = slot->buf;
+    return 0;
+}
+
+static
+int _fanout_reader_release_raw(stream_handle_t* str, void* wire_buf)
+{
+    stream_fanout_reader_t* r = (stream_fanout_reader_t*)str;
+    struct stream_fanout_slot* slot = _fanout_slot(r->fan, r->seq);
+
+    if (!r->busy || slot->buf != wire_buf)
+        return -EINVAL;
+
+    return _fanout_reader_finish(r, slot);
+}
+
+static
+int _fanout_reader_op(stream_handle_t* UNUSED str,
+                      unsigned UNUSED command,
+                      dm_time_t UNUSED tm)
+{
+    // Source stream is controlled by its owner only
+    return -ENOTSUP;
+}
+
+static
+int _fanout_reader_stat(stream_handle_t* str, usdr_dms_nfo_t* nfo)
+{
+    stream_fanout_reader_t* r = (stream_fanout_reader_t*)str;
+    stream_fanout_t* fan = r->fan;
+    int res = fan->src->ops->stat(fan->src, nfo);
+    if (res)
+        return res;
+
+    unsigned wire_bytes = (uint64_t)nfo->pktsyms * fan->wire_bytes / fan->snfo.pktsyms;
+    nfo->pktbszie = r->tf_size(wire_bytes, false) / nfo->channels;
+    return 0;
+}
+
+static
+int _fanout_reader_option_get(stream_handle_t* str, const char* name, int64_t* out_val)
+{
+    stream_fanout_reader_t* r = (stream_fanout_reader_t*)str;
+    if (strcmp(name, "pkts") == 0) {
+        *out_val = r->pkts;
+        return 0;
+    } else if (strcmp(name, "dropped") == 0) {
+        *out_val = r->dropped;
+        return 0;
+    } else if (strcmp(name, "backlog") == 0) {
+        *out_val = r->fan->tail - r->seq;
+        return 0;
+    } else if (strcmp(name, "wire_fmt") == 0) {
+        *out_val = (intptr_t)r->fan->wire_fmt;
+        return 0;
+    } else if (strcmp(name, "wire_bytes") == 0) {
+        *out_val = r->fan->wire_bytes;
+        return 0;
+    }
+    return -EINVAL;
+}
+
+static
+int _fanout_reader_option_set(stream_handle_t* UNUSED str, const char* UNUSED name, int64_t UNUSED in_val)
+{
+    return -EINVAL;
+}
+
+static
+int _fanout_reader_destroy(stream_handle_t* str)
+{
+    return stream_fanout_detach(str);
+}
+
+static const struct stream_ops s_fanout_reader_ops = {
+    .destroy = &_fanout_reader_destroy,
+    .op = &_fanout_reader_op,
+    .recv = &_fanout_reader_recv,
+    .recv_raw = &_fanout_reader_recv_raw,
+    .release_raw = &_fanout_reader_release_raw,
+    .stat = &_fanout_reader_stat,
+    .option_get = &_fanout_reader_option_get,
+    .option_set = &_fanout_reader_option_set,
+};
+
+
+int stream_fanout_create(stream_handle_t* src,
+                         unsigned depth,
+                         stream_fanout_t** out)
+{
+    int res;
+    int64_t wfmt, wbytes, bufs;
+    stream_fanout_t* fan;
+
+    if (src->ops->recv_raw == NULL || src->ops->release_raw == NULL) {
+        USDR_LOG("FOUT", USDR_LOG_ERROR, "Stream doesn't support zero-copy access\n");
+        return -ENOTSUP;
+    }
+
+    // Source needs one buffer of its ring to keep receiving into
+    if (src->ops->option_get(src, "buffers", &bufs) == 0 && bufs > 1) {
+        if (depth == 0 && bufs - 1 < FANOUT_MAX_DEPTH / 2)
+            depth = bufs - 1;
+        if (depth >= bufs) {
+            USDR_LOG("FOUT", USDR_LOG_ERROR, "Fan-out depth %d doesn't fit into source ring of %d buffers\n",
+                     depth, (int)bufs);
+            return -EINVAL;
+        }
+    }
+
+    if (depth == 0)
+        depth = FANOUT_MAX_DEPTH / 2;
+    if (depth > FANOUT_MAX_DEPTH)
+        return -EINVAL;
+
+    fan = (stream_fanout_t*)malloc(sizeof(stream_fanout_t));
+    if (fan == NULL)
+        return -ENOMEM;
+
+    memset(fan, 0, sizeof(*fan));
+    fan->src = src;
+    fan->depth = depth;
+
+    res = src->ops->stat(src, &fan->snfo);
+    res = (res) ? res : src->ops->option_get(src, "wire_fmt", &wfmt);
+    res = (res) ? res : src->ops->option_get(src, "wire_bytes", &wbytes);
+    if (res) {
+        free(fan);
+        return res;
+    }
+    if (fan->snfo.type != USDR_DMS_RX) {
+        free(fan);
+        return -ENOTSUP;
+    }
+
+    strncpy(fan->wire_fmt, (const char*)(intptr_t)wfmt, sizeof(fan->wire_fmt) - 1);
+    fan->wire_bytes = wbytes;
+
+    pthread_mutex_init(&fan->mtx, NULL);
+    pthread_cond_init(&fan->cond, NULL);
+
+    USDR_LOG("FOUT", USDR_LOG_INFO, "Fan-out created on stream %p, wire format %s, %d bytes x %d buffers\n",
+             src, fan->wire_fmt, fan->wire_bytes, fan->depth);
+
+    *out = fan;
+    return 0;
+}
+
+int stream_fanout_destroy(stream_fanout_t* fan)
+{
+    if (fan->rcnt)
+        return -EBUSY;
+
+    _fanout_release_done(fan);
+    pthread_cond_destroy(&fan->cond);
+    pthread_mutex_destroy(&fan->mtx);
+    free(fan);
+    return 0;
+}
+
+int stream_fanout_attach(stream_fanout_t* fan,
+                         const char* host_fmt,
+                         unsigned policy,
+                         stream_handle_t** reader)
+{
+    stream_fanout_reader_t* r;
+    transform_info_t funcs;
+
+    if (policy > USDR_DMS_FANOUT_SKIP)
+        return -EINVAL;
+    if (host_fmt == NULL)
+        host_fmt = fan->wire_fmt;
+
+    funcs = get_transform_fn(fan->wire_fmt, host_fmt, 1, fan->snfo.channels);
+    if (funcs.cfunc == NULL || funcs.sfunc == NULL) {
+        USDR_LOG("FOUT", USDR_LOG_ERROR, "No transform function '%s'->'%s' are available for 1->%d demux\n",
+                 fan->wire_fmt, host_fmt, fan->snfo.channels);
+        return -EINVAL;
+    }
+
+    r = (stream_fanout_reader_t*)malloc(sizeof(stream_fanout_reader_t));
+    if (r == NULL)
+        return -ENOMEM;
+
+    memset(r, 0, sizeof(*r));
+    r->base.dev = fan->src->dev;
+    r->base.ops = &s_fanout_reader_ops;
+    r->fan = fan;
+    r->policy = policy;
+    r->tf_data = funcs.cfunc;
+    r->tf_size = funcs.sfunc;
+
+    pthread_mutex_lock(&fan->mtx);
+    if (fan->rcnt == FANOUT_MAX_READERS) {
+        pthread_mutex_unlock(&fan->mtx);
+        free(r);
+        return -EBUSY;
+    }
+
+    // New reader sees only data fetched after attachment
+    r->seq = fan->tail;
+    fan->readers[fan->rcnt++] = r;
+    pthread_mutex_unlock(&fan->mtx);
+
+    USDR_LOG("FOUT", USDR_LOG_INFO, "Reader %p attached as '%s' policy %d\n",
+             r, host_fmt, policy);
+
+    *reader = &r->base;
+    return 0;
+}
+
+int stream_fanout_detach(stream_handle_t* reader)
+{
+    stream_fanout_reader_t* r = (stream_fanout_reader_t*)reader;
+    stream_fanout_t* fan = r->fan;
+    unsigned i;
+
+    if (reader->ops != &s_fanout_reader_ops)
+        return -EINVAL;
+
+    pthread_mutex_lock(&fan->mtx);
+    for (i = 0; i < fan->rcnt && fan->readers[i] != r; i++);
+    if (i == fan->rcnt || r->busy) {
+        pthread_mutex_unlock(&fan->mtx);
+        return (i == fan->rcnt) ? -EINVAL : -EBUSY;
+    }
+
+    _fanout_reader_drop(fan, r, fan->tail);
+    fan->readers[i] = fan->readers[--fan->rcnt];
+    _fanout_release_done(fan);
+    pthread_cond_broadcast(&fan->cond);
+    pthread_mutex_unlock(&fan->mtx);
+
+    USDR_LOG("FOUT", USDR_LOG_INFO, "Reader %p detached, %" PRIu64 " packets received, %" PRIu64 " dropped\n",
+             r, r->pkts, r->dropped);
+    free(r);
+    return 0;
+}
@@ -0,0 +1,37 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef STREAM_FANOUT_H
+#define STREAM_FANOUT_H
+
+#include "streams_api.h"
+
+// Zero-copy fan-out of a single RX stream to several readers.
+//
+// Wire buffers obtained from the source stream are kept in a refcounted
+// window and returned to the hardware only after every reader which holds
+// a reference consumed it. Each reader is a regular stream_handle_t with
+// its own cursor, host format and overflow policy.
+
+enum {
+    FANOUT_MAX_READERS = 16,
+    FANOUT_MAX_DEPTH = 32,
+};
+
+struct stream_fanout;
+typedef struct stream_fanout stream_fanout_t;
+
+int stream_fanout_create(stream_handle_t* src,
+                         unsigned depth,
+                         stream_fanout_t** out);
+
+int stream_fanout_destroy(stream_fanout_t* fan);
+
+int stream_fanout_attach(stream_fanout_t* fan,
+                         const char* host_fmt,
+                         unsigned policy,
+                         stream_handle_t** reader);
+
+int stream_fanout_detach(stream_handle_t* reader);
+
+#endif
@@ -16,7 +16,7 @@
 
 //
 // TODO: OP calls don't work at the moment
-// TODO: Dynamic RX packet reconfiguration doesn't work
+// NOTE: Dynamic RX packet reconfiguration alters host packets only, USB transfer size is fixed on creation
 //
 
 
@@ -60,6 +60,9 @@ struct stream_limesdr {
     uint64_t rcnt;
     uint64_t overruns;
 
+    unsigned pend_pkt_symbs;   // Requested host packet size, 0 -- nothing pending
+    uint64_t pkt_switch_ts;    // Sample index where current packet size took effect
+
 };
 typedef struct stream_limesdr stream_limesdr_t;
 
@@ -92,6 +95,13 @@ int _limestr_stream_recv(stream_handle_t* str,
     lldev_t dev = stream->base.dev->dev;
     struct lowlevel_ops* ops = lowlevel_get_ops(dev);
 
+    // Each call returns exactly one host packet, so we're on the packet boundary
+    bool pkt_switch = (stream->pend_pkt_symbs != 0);
+    if (pkt_switch) {
+        stream->host_pkt_symbs = stream->pend_pkt_symbs;
+        stream->pend_pkt_symbs = 0;
+    }
+
     char* dma_buf;
     unsigned host_bps = (stream->burst_host_bytes / stream->burst_symbs);
     unsigned wire_bps = (stream->burst_bytes / stream->burst_symbs);
@@ -241,10 +251,17 @@ int _limestr_stream_recv(stream_handle_t* str,
         }
     } while (host_smpl_rem != 0);
 
+    if (pkt_switch) {
+        stream->pkt_switch_ts = fsym_time;
+        USDR_LOG("DSTR", USDR_LOG_INFO, "Lime stream %d packet size changed to %d samples @%" PRIu64 "\n",
+                 stream->ll_streamo, stream->host_pkt_symbs, stream->pkt_switch_ts);
+    }
+
     if (nfo) {
         nfo->totsyms  = stream->host_pkt_symbs - host_smpl_rem;
         nfo->totlost  = 0;
         nfo->fsymtime = fsym_time;
+        nfo->stats    = NULL;
 
         USDR_LOG("DSTR", USDR_LOG_TRACE, "OUT %lld - %d\n", (long long)nfo->fsymtime, nfo->totsyms);
     }
@@ -354,13 +371,33 @@ int _limestr_stream_get(stream_handle_t* str, const char* name, int64_t* out_val
     if (strcmp(name, "fd") == 0) {
         *out_val = stream->fd;
         return 0;
+    } else if (strcmp(name, "pktsyms") == 0) {
+        *out_val = stream->host_pkt_symbs;
+        return 0;
+    } else if (strcmp(name, "pktsyms_ts") == 0) {
+        if (stream->pend_pkt_symbs)
+            return -EAGAIN;
+
+        *out_val = stream->pkt_switch_ts;
+        return 0;
     }
     return -EINVAL;
 }
 
 static
-int _limestr_stream_set(stream_handle_t* str, const char* name, int64_t UNUSED in_val)
+int _limestr_stream_set(stream_handle_t* str, const char* name, int64_t in_val)
 {
+    stream_limesdr_t* stream = (stream_limesdr_t*)str;
+    if (strcmp(name, "pktsyms") == 0) {
+        if (stream->ll_streamo != LIMESDR_RX)
+            return -ENOTSUP;
+        if (in_val <= 0 || in_val > UINT32_MAX)
+            return -EINVAL;
+
+        // Host packet is assembled from bursts, so any size goes
+        stream->pend_pkt_symbs = (in_val == stream->host_pkt_symbs) ? 0 : in_val;
+        return 0;
+    }
     return -EINVAL;
 }
 
@@ -536,6 +573,8 @@ int create_limesdr_stream(device_t* device,
 
     strdev->rcnt = 0;
     strdev->overruns = 0;
+    strdev->pend_pkt_symbs = 0;
+    strdev->pkt_switch_ts = 0;
     strdev->blk_time_prev = ~0UL;
     strdev->lag_remaining = 0;
 
@@ -6,6 +6,8 @@
 #include <string.h>
 #include <assert.h>
 #include <inttypes.h>
+#include <time.h>
+#include <pthread.h>
 
 #include "stream_sfetrx4_dma32.h"
 
@@ -29,6 +31,49 @@ struct stream_stats {
 };
 typedef struct stream_stats stream_stats_t;
 
+enum {
+    CYCLIC_TAGS = 64,
+    CYCLIC_TO_MS = 100,
+    // Bursts of a buffer are reported as a bit mask in the upper OOB word
+    SFETRX4_MAX_BURSTS = 32,
+};
+
+// Waveform converted to wire format, split into chunks of at most one packet.
+// When it fits into the DMA ring the number of chunks divides the ring length,
+// so every buffer always carries the same chunk and is filled only on the first
+// pass. Longer waveforms are copied on every cycle.
+struct sfetrx4_wave {
+    char* wire;         // Whole waveform, contiguous
+    unsigned samples;
+    unsigned chunks;
+    unsigned ring;      // Ring length the split was made for
+    unsigned* start;    // First sample of every chunk, chunks + 1 entries
+    unsigned gen;
+};
+
+struct sfetrx4_cyclic {
+    pthread_t thread;
+    pthread_mutex_t mtx;
+    bool stop;
+    int error;
+
+    struct sfetrx4_wave* cur;
+    struct sfetrx4_wave* next; // Swapped in on the next cycle boundary
+    unsigned gen;
+    uint64_t cycles;
+    dm_time_t ts;
+    unsigned ring;     // Observed DMA ring length, 0 until the first buffer is reused
+
+    // Wire data already placed into DMA buffers, buffers are reused in the
+    // ring order so after the first pass most of them don't need a copy
+    struct {
+        void* buf;
+        unsigned gen;
+        unsigned chunk;
+    } tag[CYCLIC_TAGS];
+    unsigned tags;
+};
+
 
 struct stream_sfetrx_dma32 {
     struct stream_handle base;
@@ -62,6 +107,41 @@ struct stream_sfetrx_dma32 {
     stream_stats_t stats;
     int fd;
     unsigned burst_count;
+
+    char wire_fmt[16];   // Format of data in DMA buffers
+
+    // Runtime packet size reconfiguration
+    unsigned max_pkt_bytes;    // DMA buffer size allocated on creation
+    unsigned pend_burst_count; // Requested bursts, 0 -- nothing pending (atomic, cleared by RX)
+    uint64_t pkt_switch_ts;    // Sample index where current packet size took effect
+
+    uint64_t restart_ns;       // Time spent to create or restart the stream
+    bool pooled;               // Restarted from the pool
+    unsigned core_id;          // Pool slot
+    unsigned ll_channels;      // Geometry the lowlevel stream was initialized with
+    unsigned ll_bits_per_sym;
+    unsigned ll_buffers;       // DMA ring length requested on initialization
+
+    // Discard of leading samples to align streams of several boards
+    uint64_t align_syms;       // Total samples to discard, timestamps are rebased on it
+    uint64_t skip_syms;        // Whole packets worth of samples still to drop
+    unsigned shift_syms;       // Sub-packet shift applied to every delivered packet
+    char* shift_buf;           // Carry of the previous packet + staging area, host format
+    bool shift_primed;
+    uint64_t shift_ts;
+
+    // Per-channel signal statistics gathered during conversion
+    conv_stat_function_t tf_stat; // NULL if not available for the format
+    bool stats_en;
+    conv_ch_stat_t ch_stat[16];
+    struct usdr_dms_ch_stat ch_stat_out[16];
+
+    // Device level consumer of the statistics (AGC)
+    sfetrx4_level_cb_t level_cb;
+    void* level_obj;
+
+    // Cyclic transmission, TX only
+    struct sfetrx4_cyclic* cyclic;
 };
 typedef struct stream_sfetrx_dma32 stream_sfetrx_dma32_t;
 
@@ -70,15 +150,16 @@ enum usdr_str_tpye {
     USDR_ZCPY_TX,
 };
 
+static int _sfetrx4_cyclic_stop(stream_sfetrx_dma32_t* stream);
+
 static
-int _sfetrx4_destroy(stream_handle_t* str)
+int _sfetrx4_stop(stream_sfetrx_dma32_t* stream)
 {
-    stream_sfetrx_dma32_t* stream = (stream_sfetrx_dma32_t*)str;
     lldev_t dev = stream->base.dev->dev;
-
-    USDR_LOG("DSTR", USDR_LOG_DEBUG, "Destroying strem %d\n", stream->ll_streamo);
     int res;
 
+    _sfetrx4_cyclic_stop(stream);
+
     if (stream->type == USDR_ZCPY_RX) {
         //Grcefull stop
         res = lowlevel_reg_wr32(dev, 0,
@@ -97,19 +178,39 @@ int _sfetrx4_destroy(stream_handle_t* str)
             return res;
     }
 
+    return 0;
+}
+
+static
+int _sfetrx4_destroy(stream_handle_t* str)
+{
+    stream_sfetrx_dma32_t* stream = (stream_sfetrx_dma32_t*)str;
+    lldev_t dev = stream->base.dev->dev;
+
+    USDR_LOG("DSTR", USDR_LOG_DEBUG, "Destroying strem %d\n", stream->ll_streamo);
+    int res = _sfetrx4_stop(stream);
+    if (res)
+        return res;
+
     lowlevel_ops_t* dops = lowlevel_get_ops(dev);
     res = dops->stream_deinitialize(dev, 0, stream->ll_streamo);
 
     // Cleanup device state
+    free(stream->shift_buf);
     free(stream);
     return res;
 }
 
+static uint32_t _sfetrx4_burst_mask(unsigned bursts)
+{
+    return ((((uint64_t)1U) << bursts) - 1) << (SFETRX4_MAX_BURSTS - bursts);
+}
+
 static
-int _sfetrx4_stream_recv(stream_handle_t* str,
-                         char** stream_buffs,
-                         unsigned timeout,
-                         struct usdr_dms_recv_nfo* nfo)
+int _sfetrx4_stream_recv_raw(stream_handle_t* str,
+                             void** wire_buf,
+                             unsigned timeout,
+                             struct usdr_dms_recv_nfo* nfo)
 {
     int res;
     struct lowlevel_ops* ops;
@@ -138,6 +239,10 @@ int _sfetrx4_stream_recv(stream_handle_t* str,
     if (res < 0)
         return res;
 
+    unsigned pend_bursts = __atomic_load_n(&stream->pend_burst_count, __ATOMIC_ACQUIRE);
+    bool geometry_switch = pend_bursts &&
+            (oob_data[0] >> 32) == _sfetrx4_burst_mask(pend_bursts);
+
     //if (res > 1) {
     if (oob_data[0] & 0xffffff) {
         unsigned pkt_lost = oob_data[0] & 0xffffff;
@@ -146,7 +251,7 @@ int _sfetrx4_stream_recv(stream_handle_t* str,
 
         stream->stats.dropped += pkt_lost;
         stream->r_ts += stream->pkt_symbs * pkt_lost;
-    } else if ((oob_data[0] >> 32) != stream->burst_mask) {
+    } else if ((oob_data[0] >> 32) != stream->burst_mask && !geometry_switch) {
         USDR_LOG("UDMS", USDR_LOG_INFO, "Recv %016" PRIx64 ".%016" PRIx64 " [%08x] EXTRA:%d buf=%p seq=%16" PRIu64 "\n", oob_data[0], oob_data[1], stream->burst_mask, res, dma_buf,
                 stream->rcnt);
 
@@ -155,29 +260,173 @@ int _sfetrx4_stream_recv(stream_handle_t* str,
                  stream->rcnt);
     }
 
+    if (geometry_switch) {
+        // First buffer with the new number of bursts
+        unsigned burst_symbs = stream->pkt_symbs / stream->burst_count;
+        unsigned burst_bytes = stream->pkt_bytes / stream->burst_count;
+
+        stream->burst_count = pend_bursts;
+        stream->burst_mask = _sfetrx4_burst_mask(stream->burst_count);
+        stream->pkt_symbs = burst_symbs * stream->burst_count;
+        stream->pkt_bytes = burst_bytes * stream->burst_count;
+        stream->host_bytes = stream->tf_size(stream->pkt_bytes, false);
+        stream->pkt_switch_ts = stream->r_ts;
+        // Publishes pkt_switch_ts to option_get()
+        __atomic_store_n(&stream->pend_burst_count, 0, __ATOMIC_RELEASE);
+
+        USDR_LOG("UDMS", USDR_LOG_INFO, "Stream[%d] packet size changed to %d samples (%d bursts) @%" PRIu64 "\n",
+                 stream->ll_streamo, stream->pkt_symbs, stream->burst_count, stream->pkt_switch_ts);
+    }
+
     stream->stats.pktok ++;
     stream->stats.wirebytes += stream->pkt_bytes;
     stream->stats.symbols += stream->pkt_symbs;
-
-    // Data transformation
-    stream->tf_data((const void**)&dma_buf, stream->pkt_bytes, (void**)stream_buffs, stream->host_bytes);
     stream->rcnt++;
 
     if (nfo) {
-        nfo->fsymtime = stream->r_ts;
+        nfo->fsymtime = stream->r_ts - stream->align_syms;
         nfo->totsyms = stream->pkt_symbs;
         nfo->totlost = 0;
         nfo->extra = (oob_size >= 16) ? oob_data[1] : 0;
+        nfo->stats = NULL;
     }
 
     stream->r_ts += stream->pkt_symbs;
+    *wire_buf = dma_buf;
+    return 0;
+}
 
-    // Release DMA buffer
-    res = ops->recv_dma_release(dev, 0,
-                                stream->ll_streamo, dma_buf);
+static
+int _sfetrx4_stream_release_raw(stream_handle_t* str,
+                                void* wire_buf)
+{
+    stream_sfetrx_dma32_t* stream = (stream_sfetrx_dma32_t*)str;
+    lldev_t dev = stream->base.dev->dev;
+
+    return lowlevel_get_ops(dev)->recv_dma_release(dev, 0,
+                                                   stream->ll_streamo, wire_buf);
+}
+
+static
+int _sfetrx4_stream_recv_aligned(stream_sfetrx_dma32_t* stream,
+                                 char** stream_buffs,
+                                 unsigned timeout,
+                                 struct usdr_dms_recv_nfo* nfo);
+
+static
+int _sfetrx4_stream_recv(stream_handle_t* str,
+                         char** stream_buffs,
+                         unsigned timeout,
+                         struct usdr_dms_recv_nfo* nfo)
+{
+    int res;
+    stream_sfetrx_dma32_t* stream = (stream_sfetrx_dma32_t*)str;
+    void* dma_buf;
+
+    if (stream->skip_syms || stream->shift_syms)
+        return _sfetrx4_stream_recv_aligned(stream, stream_buffs, timeout, nfo);
+
+    res = _sfetrx4_stream_recv_raw(str, &dma_buf, timeout, nfo);
     if (res)
         return res;
 
+    // Data transformation
+    if (stream->stats_en || stream->level_cb) {
+        memset(stream->ch_stat, 0, stream->channels * sizeof(stream->ch_stat[0]));
+        stream->tf_stat((const void**)&dma_buf, stream->pkt_bytes, (void**)stream_buffs, stream->host_bytes,
+                        stream->ch_stat);
+
+        for (unsigned i = 0; i < stream->channels; i++) {
+            stream->ch_stat_out[i].sum_i = stream->ch_stat[i].sum_i;
+            stream->ch_stat_out[i].sum_q = stream->ch_stat[i].sum_q;
+            stream->ch_stat_out[i].sum_sq = stream->ch_stat[i].sum_sq;
+            stream->ch_stat_out[i].peak = stream->ch_stat[i].peak;
+            stream->ch_stat_out[i].clips = stream->ch_stat[i].clips;
+        }
+        if (nfo && stream->stats_en) {
+            nfo->stats = stream->ch_stat_out;
+        }
+        if (stream->level_cb) {
+            stream->level_cb(stream->level_obj, stream->ch_stat_out, stream->channels,
+                             stream->pkt_symbs, stream->r_ts - stream->pkt_symbs);
+        }
+    } else {
+        stream->tf_data((const void**)&dma_buf, stream->pkt_bytes, (void**)stream_buffs, stream->host_bytes);
+    }
+
+    // Release DMA buffer
+    return _sfetrx4_stream_release_raw(str, dma_buf);
+}
+
+// Drops leading packets and then delivers every packet shifted by shift_syms.
+// Tail of the previous packet is kept in carry, so output is delayed by one packet.
+static
+int _sfetrx4_stream_recv_aligned(stream_sfetrx_dma32_t* stream,
+                                 char** stream_buffs,
+                                 unsigned timeout,
+                                 struct usdr_dms_recv_nfo* nfo)
+{
+    struct usdr_dms_recv_nfo lnfo;
+    void* dma_buf;
+    char* stage[16];
+    bool deliver;
+    int res;
+
+    while (stream->skip_syms) {
+        res = _sfetrx4_stream_recv_raw(&stream->base, &dma_buf, timeout, &lnfo);
+        if (res)
+            return res;
+
+        res = _sfetrx4_stream_release_raw(&stream->base, dma_buf);
+        if (res)
+            return res;
+
+        stream->skip_syms -= (stream->skip_syms < lnfo.totsyms) ? stream->skip_syms : lnfo.totsyms;
+    }
+
+    if (stream->shift_syms == 0)
+        return _sfetrx4_stream_recv(&stream->base, stream_buffs, timeout, nfo);
+
+    unsigned ch_bytes = stream->host_bytes / stream->channels;
+    unsigned head_bytes = stream->shift_syms * (ch_bytes / stream->pkt_symbs);
+    unsigned tail_bytes = ch_bytes - head_bytes;
+    char* carry = stream->shift_buf;
+
+    assert(stream->channels <= SIZEOF_ARRAY(stage));
+    for (unsigned i = 0; i < stream->channels; i++) {
+        stage[i] = stream->shift_buf + stream->host_bytes + i * ch_bytes;
+    }
+
+    do {
+        deliver = stream->shift_primed;
+
+        res = _sfetrx4_stream_recv_raw(&stream->base, &dma_buf, timeout, &lnfo);
+        if (res)
+            return res;
+
+        stream->tf_data((const void**)&dma_buf, stream->pkt_bytes, (void**)stage, stream->host_bytes);
+
+        res = _sfetrx4_stream_release_raw(&stream->base, dma_buf);
+        if (res)
+            return res;
+
+        for (unsigned i = 0; deliver && i < stream->channels; i++) {
+            memcpy(stream_buffs[i], carry + i * ch_bytes, tail_bytes);
+            memcpy(stream_buffs[i] + tail_bytes, stage[i], head_bytes);
+        }
+        if (deliver && nfo) {
+            *nfo = lnfo;
+            nfo->fsymtime = stream->shift_ts;
+        }
+
+        for (unsigned i = 0; i < stream->channels; i++) {
+            memcpy(carry + i * ch_bytes, stage[i] + head_bytes, tail_bytes);
+        }
+
+        stream->shift_ts = lnfo.fsymtime + stream->shift_syms;
+        stream->shift_primed = true;
+    } while (!deliver);
+
     return 0;
 }
 
@@ -198,6 +447,8 @@ int _sfetrx4_stream_send(stream_handle_t* str,
 
     if (stream->type != USDR_ZCPY_TX)
         return -ENOTSUP;
+    if (stream->cyclic)
+        return -EBUSY;
     if (stream->pkt_symbs < samples) {
         //return -EOVERFLOW;
 
@@ -288,6 +539,293 @@ int _sfetrx4_stream_send(stream_handle_t* str,
     return 0;
 }
 
+static unsigned _sfetrx4_wire_bytes(stream_sfetrx_dma32_t* stream, unsigned samples)
+{
+    return stream->channels * samples * stream->bps / 8;
+}
+
+static void _sfetrx4_wave_free(struct sfetrx4_wave* w)
+{
+    if (w == NULL)
+        return;
+
+    free(w->start);
+    free(w->wire);
+    free(w);
+}
+
+unsigned sfetrx4_cyclic_split(unsigned samples, unsigned pkt_symbs, unsigned granule,
+                              unsigned ring, unsigned* start)
+{
+    unsigned pkts = (samples + pkt_symbs - 1) / pkt_symbs;
+    unsigned n = samples / granule;
+    unsigned d, k;
+
+    if (ring != 0 && pkts <= ring) {
+        for (d = pkts; ring % d; d++);
+
+        // Every chunk gets at least one granule and fits the packet
+        if (d <= n) {
+            for (k = 0; k < d; k++) {
+                start[k] = (uint64_t)k * n / d * granule;
+            }
+            start[d] = samples;
+
+            for (k = 0; k < d && start[k + 1] - start[k] <= pkt_symbs; k++);
+            if (k == d)
+                return d;
+        }
+    }
+
+    for (k = 0; k < pkts; k++) {
+        start[k] = k * pkt_symbs;
+    }
+    start[pkts] = samples;
+    return pkts;
+}
+
+static void _sfetrx4_wave_split(stream_sfetrx_dma32_t* stream, struct sfetrx4_wave* w, unsigned ring)
+{
+    // Smallest number of samples taking whole bytes on wire
+    unsigned bits = stream->channels * stream->bps;
+    unsigned granule = 1;
+    while ((granule * bits) % 8)
+        granule *= 2;
+
+    w->chunks = sfetrx4_cyclic_split(w->samples, stream->pkt_symbs, granule, ring, w->start);
+    w->ring = ring;
+}
+
+static int _sfetrx4_wave_make(stream_sfetrx_dma32_t* stream,
+                              const char **stream_buffs,
+                              unsigned samples,
+                              struct sfetrx4_wave** out)
+{
+    unsigned wire_pkt = _sfetrx4_wire_bytes(stream, stream->pkt_symbs);
+    unsigned host_off = stream->tf_size(wire_pkt, true) / stream->channels;
+    const char* nstreams[16];
+    struct sfetrx4_wave* w;
+    unsigned pkts;
+
+    if (samples == 0)
+        return -EINVAL;
+    if (stream->channels > SIZEOF_ARRAY(nstreams))
+        return -EINVAL;
+
+    w = (struct sfetrx4_wave*)calloc(1, sizeof(struct sfetrx4_wave));
+    if (w == NULL)
+        return -ENOMEM;
+
+    pkts = (samples + stream->pkt_symbs - 1) / stream->pkt_symbs;
+    w->samples = samples;
+    w->wire = (char*)malloc((size_t)pkts * wire_pkt);
+    w->start = (unsigned*)malloc(sizeof(unsigned) * ((pkts > CYCLIC_TAGS ? pkts : CYCLIC_TAGS) + 1));
+    if (w->wire == NULL || w->start == NULL) {
+        _sfetrx4_wave_free(w);
+        return -ENOMEM;
+    }
+
+    memcpy(nstreams, stream_buffs, sizeof(void*) * stream->channels);
+    for (unsigned c = 0; c < pkts; c++) {
+        unsigned ns = (c == pkts - 1) ? samples - c * stream->pkt_symbs : stream->pkt_symbs;
+        unsigned wire_bytes = _sfetrx4_wire_bytes(stream, ns);
+        void* dst = w->wire + (size_t)c * wire_pkt;
+
+        stream->tf_data((const void**)nstreams, stream->tf_size(wire_bytes, true), &dst, wire_bytes);
+
+        for (unsigned i = 0; i < stream->channels; i++) {
+            nstreams[i] += host_off;
+        }
+    }
+
+    _sfetrx4_wave_split(stream, w, stream->ll_buffers);
+    *out = w;
+    return 0;
+}
+
+static void* _sfetrx4_cyclic_thread(void* obj)
+{
+    stream_sfetrx_dma32_t* stream = (stream_sfetrx_dma32_t*)obj;
+    struct sfetrx4_cyclic* cy = stream->cyclic;
+    lldev_t dev = stream->base.dev->dev;
+    struct lowlevel_ops* ops = lowlevel_get_ops(dev);
+    unsigned chunk = 0;
+    int res = 0;
+
+    for (;;) {
+        struct sfetrx4_wave* old = NULL;
+        struct sfetrx4_wave* w;
+        void* buffer;
+        bool stop;
+
+        pthread_mutex_lock(&cy->mtx);
+        if (chunk == 0 && cy->next) {
+            old = cy->cur;
+            cy->cur = cy->next;
+            cy->next = NULL;
+        }
+        stop = cy->stop;
+        w = cy->cur;
+        pthread_mutex_unlock(&cy->mtx);
+
+        _sfetrx4_wave_free(old);
+        if (stop)
+            break;
+
+        // Ring length reported on initialization may be adjusted by lowlevel
+        if (chunk == 0 && cy->ring != 0 && w->ring != cy->ring) {
+            _sfetrx4_wave_split(stream, w, cy->ring);
+            for (unsigned t = 0; t < cy->tags; t++) {
+                cy->tag[t].gen = ~0u;
+            }
+        }
+
+        res = ops->send_dma_get(dev, 0, stream->ll_streamo, &buffer, NULL, NULL, CYCLIC_TO_MS);
+        if (res == -ETIMEDOUT)
+            continue;
+        if (res < 0)
+            break;
+
+        unsigned ns = w->start[chunk + 1] - w->start[chunk];
+        unsigned wire_bytes = _sfetrx4_wire_bytes(stream, ns);
+        unsigned t;
+
+        for (t = 0; t < cy->tags && cy->tag[t].buf != buffer; t++);
+        if (t < cy->tags && cy->ring == 0) {
+            // Buffers are handed out in the ring order
+            cy->ring = cy->tags;
+        }
+        if (t == cy->tags && t < CYCLIC_TAGS) {
+            cy->tag[t].buf = buffer;
+            cy->tag[t].gen = ~0u;
+            cy->tags++;
+        }
+        if (t == CYCLIC_TAGS || cy->tag[t].gen != w->gen || cy->tag[t].chunk != chunk) {
+            memcpy(buffer, w->wire + _sfetrx4_wire_bytes(stream, w->start[chunk]), wire_bytes);
+            if (t < CYCLIC_TAGS) {
+                cy->tag[t].gen = w->gen;
+                cy->tag[t].chunk = chunk;
+            }
+        }
+
+        uint64_t oob[1] = { cy->ts };
+        res = ops->send_dma_commit(dev, 0, stream->ll_streamo, buffer, wire_bytes,
+                                   &oob, sizeof(oob));
+        if (res)
+            break;
+
+        if (cy->ts < INT64_MAX) {
+            cy->ts += ns;
+        }
+        stream->stats.wirebytes += wire_bytes;
+        stream->stats.symbols += ns;
+        stream->stats.pktok++;
+        stream->rcnt++;
+
+        if (++chunk == w->chunks) {
+            chunk = 0;
+
+            pthread_mutex_lock(&cy->mtx);
+            cy->cycles++;
+            pthread_mutex_unlock(&cy->mtx);
+        }
+    }
+
+    if (res) {
+        USDR_LOG("UDMS", USDR_LOG_ERROR, "Stream[%d] cyclic transmission aborted, error %d\n",
+                 stream->ll_streamo, res);
+    }
+
+    pthread_mutex_lock(&cy->mtx);
+    cy->error = res;
+    pthread_mutex_unlock(&cy->mtx);
+    return NULL;
+}
+
+static
+int _sfetrx4_stream_send_cyclic(stream_handle_t* str,
+                                const char **stream_buffs,
+                                unsigned samples,
+                                dm_time_t timestamp)
+{
+    stream_sfetrx_dma32_t* stream = (stream_sfetrx_dma32_t*)str;
+    struct sfetrx4_cyclic* cy = stream->cyclic;
+    struct sfetrx4_wave* w;
+    int res;
+
+    if (stream->type != USDR_ZCPY_TX)
+        return -ENOTSUP;
+
+    res = _sfetrx4_wave_make(stream, stream_buffs, samples, &w);
+    if (res)
+        return res;
+
+    if (cy) {
+        struct sfetrx4_wave* old;
+
+        pthread_mutex_lock(&cy->mtx);
+        res = cy->error;
+        old = cy->next;
+        w->gen = ++cy->gen;
+        cy->next = w;
+        pthread_mutex_unlock(&cy->mtx);
+
+        _sfetrx4_wave_free(old);
+        return res;
+    }
+
+    cy = (struct sfetrx4_cyclic*)calloc(1, sizeof(struct sfetrx4_cyclic));
+    if (cy == NULL) {
+        _sfetrx4_wave_free(w);
+        return -ENOMEM;
+    }
+
+    w->gen = 0;
+    cy->cur = w;
+    cy->ts = timestamp;
+    pthread_mutex_init(&cy->mtx, NULL);
+    stream->cyclic = cy;
+
+    res = pthread_create(&cy->thread, NULL, _sfetrx4_cyclic_thread, stream);
+    if (res) {
+        stream->cyclic = NULL;
+        pthread_mutex_destroy(&cy->mtx);
+        _sfetrx4_wave_free(w);
+        free(cy);
+        return -res;
+    }
+
+    USDR_LOG("UDMS", USDR_LOG_INFO, "Stream[%d] cyclic transmission of %d samples in %d packets\n",
+             stream->ll_streamo, samples, w->chunks);
+    return 0;
+}
+
+static int _sfetrx4_cyclic_stop(stream_sfetrx_dma32_t* stream)
+{
+    struct sfetrx4_cyclic* cy = stream->cyclic;
+    int res;
+
+    if (cy == NULL)
+        return 0;
+
+    pthread_mutex_lock(&cy->mtx);
+    cy->stop = true;
+    pthread_mutex_unlock(&cy->mtx);
+
+    pthread_join(cy->thread, NULL);
+    res = cy->error;
+
+    USDR_LOG("UDMS", USDR_LOG_INFO, "Stream[%d] cyclic transmission stopped after %" PRIu64 " cycles\n",
+             stream->ll_streamo, cy->cycles);
+
+    _sfetrx4_wave_free(cy->cur);
+    _sfetrx4_wave_free(cy->next);
+    pthread_mutex_destroy(&cy->mtx);
+    free(cy);
+    stream->cyclic = NULL;
+    return res;
+}
+
 
 static int _sfetrx4_op(stream_handle_t* str,
                        unsigned command,
@@ -320,6 +858,10 @@ static int _sfetrx4_op(stream_handle_t* str,
         if (res)
             return res;
     } else {
+        if (!start) {
+            _sfetrx4_cyclic_stop(stream);
+        }
+
         res = sfe_tx4_ctl(dev, 0, stream->cnf_base,
                           stream->channels != 1, false, start);
         if (res)
@@ -356,12 +898,54 @@ int _sfetrx4_option_get(stream_handle_t* str, const char* name, int64_t* out_val
     if (strcmp(name, "fd") == 0) {
         *out_val = stream->fd;
         return 0;
+    } else if (strcmp(name, "wire_fmt") == 0) {
+        *out_val = (intptr_t)stream->wire_fmt;
+        return 0;
+    } else if (strcmp(name, "wire_bytes") == 0) {
+        *out_val = stream->pkt_bytes;
+        return 0;
+    } else if (strcmp(name, "buffers") == 0) {
+        *out_val = stream->ll_buffers;
+        return 0;
+    } else if (strcmp(name, "pktsyms") == 0) {
+        *out_val = stream->pkt_symbs;
+        return 0;
+    } else if (strcmp(name, "pktsyms_ts") == 0) {
+        if (__atomic_load_n(&stream->pend_burst_count, __ATOMIC_ACQUIRE))
+            return -EAGAIN;
+
+        *out_val = stream->pkt_switch_ts;
+        return 0;
+    } else if (strcmp(name, "restart_ns") == 0) {
+        *out_val = stream->restart_ns;
+        return 0;
+    } else if (strcmp(name, "pooled") == 0) {
+        *out_val = stream->pooled;
+        return 0;
+    } else if (strcmp(name, "skip_syms") == 0) {
+        *out_val = stream->align_syms;
+        return 0;
+    } else if (strcmp(name, "stats") == 0) {
+        *out_val = stream->stats_en;
+        return 0;
+    } else if (strcmp(name, "cyclic_cycles") == 0) {
+        struct sfetrx4_cyclic* cy = stream->cyclic;
+        int res;
+
+        if (cy == NULL)
+            return -ENOENT;
+
+        pthread_mutex_lock(&cy->mtx);
+        *out_val = cy->cycles;
+        res = cy->error;
+        pthread_mutex_unlock(&cy->mtx);
+        return res;
     }
     return -EINVAL;
 }
 
 static
-int _sfetrx4_option_set(stream_handle_t* str, const char* name, int64_t UNUSED in_val)
+int _sfetrx4_option_set(stream_handle_t* str, const char* name, int64_t in_val)
 {
     stream_sfetrx_dma32_t* stream = (stream_sfetrx_dma32_t*)str;
     if (strcmp(name, "ready") == 0) {
@@ -371,6 +955,81 @@ int _sfetrx4_option_set(stream_handle_t* str, const char* name, int64_t UNUSED i
         // Issue rx ready, should be put inside
         return lowlevel_reg_wr32(stream->base.dev->dev, 0,
                                  stream->cnf_base + 1, 4);
+    } else if (strcmp(name, "pktsyms") == 0) {
+        if (stream->type != USDR_ZCPY_RX || stream->burst_count == 0)
+            return -ENOTSUP;
+
+        // Burst geometry is fixed in FE, only number of bursts per buffer can be altered
+        unsigned burst_symbs = stream->pkt_symbs / stream->burst_count;
+        unsigned burst_bytes = stream->pkt_bytes / stream->burst_count;
+        unsigned bursts = in_val / burst_symbs;
+
+        if (in_val <= 0 || in_val % burst_symbs) {
+            USDR_LOG("UDMS", USDR_LOG_ERROR, "Stream[%d] packet size should be multiple of %d samples\n",
+                     stream->ll_streamo, burst_symbs);
+            return -EINVAL;
+        }
+        if (bursts * burst_bytes > stream->max_pkt_bytes || bursts > SFETRX4_MAX_BURSTS) {
+            USDR_LOG("UDMS", USDR_LOG_ERROR, "Stream[%d] packet size %d exceeds allocated DMA buffer of %d samples\n",
+                     stream->ll_streamo, (unsigned)in_val, stream->max_pkt_bytes / burst_bytes * burst_symbs);
+            return -EINVAL;
+        }
+        if (bursts == stream->burst_count &&
+            __atomic_load_n(&stream->pend_burst_count, __ATOMIC_ACQUIRE) == 0)
+            return 0;
+        if (stream->shift_syms)
+            return -EBUSY;
+
+        int res = dma_rx32_set_bursts(stream->base.dev->dev, 0, stream->cfg_base, bursts);
+        if (res)
+            return res;
+
+        __atomic_store_n(&stream->pend_burst_count,
+                         (bursts == stream->burst_count) ? 0 : bursts, __ATOMIC_RELEASE);
+        return 0;
+    } else if (strcmp(name, "skip_syms") == 0) {
+        if (stream->type != USDR_ZCPY_RX)
+            return -ENOTSUP;
+        if (in_val < 0)
+            return -EINVAL;
+
+        // Can be altered only before the first packet is received
+        if (stream->rcnt != 0 || __atomic_load_n(&stream->pend_burst_count, __ATOMIC_ACQUIRE))
+            return -EBUSY;
+
+        unsigned shift = in_val % stream->pkt_symbs;
+        unsigned ch_bytes = stream->host_bytes / stream->channels;
+        if (shift && ch_bytes % stream->pkt_symbs)
+            return -ENOTSUP;
+
+        free(stream->shift_buf);
+        stream->shift_buf = NULL;
+        if (shift) {
+            stream->shift_buf = (char*)malloc(2 * stream->host_bytes);
+            if (!stream->shift_buf)
+                return -ENOMEM;
+        }
+
+        stream->align_syms = in_val;
+        stream->skip_syms = in_val - shift;
+        stream->shift_syms = shift;
+        stream->shift_primed = false;
+
+        USDR_LOG("UDMS", USDR_LOG_INFO, "Stream[%d] discarding %" PRIu64 " leading samples\n",
+                 stream->ll_streamo, stream->align_syms);
+        return 0;
+    } else if (strcmp(name, "stats") == 0) {
+        if (stream->type != USDR_ZCPY_RX || stream->tf_stat == NULL)
+            return -ENOTSUP;
+
+        stream->stats_en = (in_val != 0);
+        return 0;
+    } else if (strcmp(name, "cyclic") == 0) {
+        // Only stopping is possible, use send_cyclic() to start
+        if (in_val != 0)
+            return -EINVAL;
+
+        return _sfetrx4_cyclic_stop(stream);
     }
     return -EINVAL;
 }
@@ -403,7 +1062,10 @@ static const struct stream_ops s_sfetr4_dma32_ops = {
     .destroy = &_sfetrx4_destroy,
     .op = &_sfetrx4_op,
     .recv = &_sfetrx4_stream_recv,
+    .recv_raw = &_sfetrx4_stream_recv_raw,
+    .release_raw = &_sfetrx4_stream_release_raw,
     .send = &_sfetrx4_stream_send,
+    .send_cyclic = &_sfetrx4_stream_send_cyclic,
     .stat = &_sfetrx4_stat,
     .option_get = &_sfetrx4_option_get,
     .option_set = &_sfetrx4_option_set,
@@ -474,6 +1136,7 @@ static int initialize_stream_rx_32(device_t* device,
                                    unsigned sx_base,
                                    unsigned sx_cfg_base,
                                    struct parsed_data_format pfmt,
+                                   stream_sfetrx_dma32_t* pooled,
                                    stream_sfetrx_dma32_t** outu,
                                    bool need_fd,
                                    bool need_tx_stat,
@@ -531,6 +1194,9 @@ static int initialize_stream_rx_32(device_t* device,
         USDR_LOG("DSTR", USDR_LOG_INFO, "No transformation!\n");
     }
 
+    conv_stat_function_t stat_func = (logicchs <= 16) ?
+        get_stat_transform_fn(sc.sfmt, pfmt.host_fmt, 1, logicchs) : NULL;
+
     if (data_lane_bifurcation) {
         struct bitsfmt bfmt = get_bits_fmt(sc.sfmt);
         if ((bfmt.complex) && (sc.chmsk == 1 || sc.chmsk == 2)) {
@@ -575,11 +1241,27 @@ static int initialize_stream_rx_32(device_t* device,
     sparams.bits_per_sym = 0;
 
     sparams.underlying_fd = -1;
-    res = dops->stream_initialize(device->dev, 0, &sparams, &sid);
-    if (res)
-        return res;
+    if (pooled) {
+        // Lowlevel ring is kept as is, DMA buffers are filled up to the block size
+        if (sparams.block_size != pooled->max_pkt_bytes || sparams.buffer_count != pooled->ll_buffers ||
+            (need_fd && pooled->fd < 0))
+            return -EAGAIN;
+
+        sid = pooled->ll_streamo;
+        sparams.underlying_fd = pooled->fd;
+        strdev = pooled;
+    } else {
+        res = dops->stream_initialize(device->dev, 0, &sparams, &sid);
+        if (res)
+            return res;
+
+        strdev = (stream_sfetrx_dma32_t*)malloc(sizeof(stream_sfetrx_dma32_t));
+        strdev->max_pkt_bytes = sparams.block_size;
+        strdev->ll_channels = sparams.channels;
+        strdev->ll_bits_per_sym = sparams.bits_per_sym;
+        strdev->ll_buffers = sparams.buffer_count;
+    }
 
-    strdev = (stream_sfetrx_dma32_t*)malloc(sizeof(stream_sfetrx_dma32_t));
     //usdr_dmo_init(&strdev->obj_stream, &s_dms_ops);
     //strdev->parent = device;
     strdev->base.dev = device;
@@ -602,6 +1284,11 @@ static int initialize_stream_rx_32(device_t* device,
 
     strdev->tf_data = funcs.cfunc;
     strdev->tf_size = funcs.sfunc;
+    strdev->tf_stat = stat_func;
+    strdev->stats_en = false;
+    strdev->level_cb = NULL;
+    strdev->level_obj = NULL;
+    strdev->cyclic = NULL;
 
     strdev->cached_samples = ~0u;
     strdev->rcnt = 0;
@@ -614,8 +1301,20 @@ static int initialize_stream_rx_32(device_t* device,
 
     strdev->fd = sparams.underlying_fd;
 
-    strdev->burst_mask = ((((uint64_t)1U) << fc.burstspblk) - 1) << (32 - fc.burstspblk);
+    strdev->burst_mask = _sfetrx4_burst_mask(fc.burstspblk);
     strdev->burst_count = fc.burstspblk;
+    strncpy(strdev->wire_fmt, sc.sfmt, sizeof(strdev->wire_fmt) - 1);
+    strdev->wire_fmt[sizeof(strdev->wire_fmt) - 1] = 0;
+
+    strdev->pend_burst_count = 0;
+    strdev->pkt_switch_ts = 0;
+    strdev->restart_ns = 0;
+    strdev->pooled = (pooled != NULL);
+    strdev->align_syms = 0;
+    strdev->skip_syms = 0;
+    strdev->shift_syms = 0;
+    strdev->shift_buf = NULL;
+    strdev->shift_primed = false;
     *outu = strdev;
     return 0;
 }
@@ -634,6 +1333,7 @@ static int initialize_stream_tx_32(device_t* device,
                                    unsigned sx_base,
                                    unsigned sx_cfg_base,
                                    struct parsed_data_format pfmt,
+                                   stream_sfetrx_dma32_t* pooled,
                                    stream_sfetrx_dma32_t** outu,
                                    bool need_fd,
                                    bool data_lane_bifurcation)
@@ -735,9 +1435,23 @@ static int initialize_stream_tx_32(device_t* device,
         return -EINVAL;
     }
 
-    res = dops->stream_initialize(device->dev, 0, &sparams, &sid);
-    if (res)
-        return res;
+    if (pooled) {
+        if (sparams.block_size > pooled->max_pkt_bytes || sparams.buffer_count != pooled->ll_buffers ||
+            (need_fd && pooled->fd < 0))
+            return -EAGAIN;
+
+        // Lowlevel converts byte counts to samples with the geometry given on initialization
+        if (sparams.channels != pooled->ll_channels || sparams.bits_per_sym != pooled->ll_bits_per_sym)
+            return -EAGAIN;
+
+        sid = pooled->ll_streamo;
+        sparams.underlying_fd = pooled->fd;
+        sparams.out_mtu_size = pooled->max_pkt_bytes;
+    } else {
+        res = dops->stream_initialize(device->dev, 0, &sparams, &sid);
+        if (res)
+            return res;
+    }
 
     if (pktsyms == 0) {
         if (sparams.out_mtu_size > max_mtu)
@@ -750,7 +1464,15 @@ static int initialize_stream_tx_32(device_t* device,
         sparams.block_size = sparams.out_mtu_size;
     }
 
-    strdev = (stream_sfetrx_dma32_t*)malloc(sizeof(stream_sfetrx_dma32_t));
+    if (pooled) {
+        strdev = pooled;
+    } else {
+        strdev = (stream_sfetrx_dma32_t*)malloc(sizeof(stream_sfetrx_dma32_t));
+        strdev->max_pkt_bytes = sparams.block_size;
+        strdev->ll_channels = sparams.channels;
+        strdev->ll_bits_per_sym = sparams.bits_per_sym;
+        strdev->ll_buffers = sparams.buffer_count;
+    }
 
     strdev->base.dev = device;
     strdev->base.ops = &s_sfetr4_dma32_ops;
@@ -772,6 +1494,11 @@ static int initialize_stream_tx_32(device_t* device,
 
     strdev->tf_data = funcs.cfunc;
     strdev->tf_size = funcs.sfunc;
+    strdev->tf_stat = NULL;
+    strdev->stats_en = false;
+    strdev->level_cb = NULL;
+    strdev->level_obj = NULL;
+    strdev->cyclic = NULL;
 
     strdev->cached_samples = ~0u;
     strdev->rcnt = 0;
@@ -786,23 +1513,36 @@ static int initialize_stream_tx_32(device_t* device,
 
     strdev->burst_mask = 0;
     strdev->burst_count = 0; //TODO: fill actual maximum burst count
+    strncpy(strdev->wire_fmt, sc.sfmt, sizeof(strdev->wire_fmt) - 1);
+    strdev->wire_fmt[sizeof(strdev->wire_fmt) - 1] = 0;
+
+    strdev->pend_burst_count = 0;
+    strdev->pkt_switch_ts = 0;
+    strdev->restart_ns = 0;
+    strdev->pooled = (pooled != NULL);
+    strdev->align_syms = 0;
+    strdev->skip_syms = 0;
+    strdev->shift_syms = 0;
+    strdev->shift_buf = NULL;
+    strdev->shift_primed = false;
     *outu = strdev;
     return 0;
 }
 
 
-int create_sfetrx4_stream(device_t* device,
-                          unsigned core_id,
-                          const char* dformat,
-                          logical_ch_msk_t channels,
-                          unsigned pktsyms,
-                          unsigned flags,
-                          unsigned sx_base,
-                          unsigned sx_cfg_base,
-                          unsigned fe_fifobsz,
-                          unsigned fe_base,
-                          stream_handle_t** outu,
-                          unsigned *hw_chans_cnt)
+static int _sfetrx4_create(device_t* device,
+                           unsigned core_id,
+                           const char* dformat,
+                           logical_ch_msk_t channels,
+                           unsigned pktsyms,
+                           unsigned flags,
+                           unsigned sx_base,
+                           unsigned sx_cfg_base,
+                           unsigned fe_fifobsz,
+                           unsigned fe_base,
+                           stream_sfetrx_dma32_t* pooled,
+                           stream_handle_t** outu,
+                           unsigned *hw_chans_cnt)
 {
     bool need_fd = (flags & DMS_FLAG_NEED_FD) == DMS_FLAG_NEED_FD;
     bool need_tx_stat = (flags & DMS_FLAG_NEED_TX_STAT) == DMS_FLAG_NEED_TX_STAT;
@@ -820,13 +1560,13 @@ int create_sfetrx4_stream(device_t* device,
     case CORE_SFERX_DMA32_R0:
         res = initialize_stream_rx_32(device, channels, pktsyms,
                                       fe_fifobsz, fe_base,
-                                      sx_base, sx_cfg_base, pfmt,
+                                      sx_base, sx_cfg_base, pfmt, pooled,
                                       (stream_sfetrx_dma32_t** )outu,
                                       need_fd, need_tx_stat, bifurcation);
         break;
     case CORE_SFETX_DMA32_R0:
         res = initialize_stream_tx_32(device, channels, pktsyms,
-                                       sx_base, sx_cfg_base, pfmt,
+                                       sx_base, sx_cfg_base, pfmt, pooled,
                                        (stream_sfetrx_dma32_t** )outu,
                                        need_fd, bifurcation);
         break;
@@ -837,10 +1577,169 @@ int create_sfetrx4_stream(device_t* device,
     if (res)
         return res;
 
+    (*(stream_sfetrx_dma32_t** )outu)->core_id = core_id;
     *hw_chans_cnt = (*(stream_sfetrx_dma32_t** )outu)->channels;
     return 0;
 }
 
+int create_sfetrx4_stream(device_t* device,
+                          unsigned core_id,
+                          const char* dformat,
+                          logical_ch_msk_t channels,
+                          unsigned pktsyms,
+                          unsigned flags,
+                          unsigned sx_base,
+                          unsigned sx_cfg_base,
+                          unsigned fe_fifobsz,
+                          unsigned fe_base,
+                          stream_handle_t** outu,
+                          unsigned *hw_chans_cnt)
+{
+    return _sfetrx4_create(device, core_id, dformat, channels, pktsyms, flags,
+                           sx_base, sx_cfg_base, fe_fifobsz, fe_base, NULL,
+                           outu, hw_chans_cnt);
+}
+
+int sfetrx4_stream_set_level_cb(stream_handle_t* str, sfetrx4_level_cb_t cb, void* obj)
+{
+    stream_sfetrx_dma32_t* stream = (stream_sfetrx_dma32_t*)str;
+    if (stream->type != USDR_ZCPY_RX || stream->tf_stat == NULL)
+        return -ENOTSUP;
+
+    stream->level_obj = obj;
+    stream->level_cb = cb;
+    return 0;
+}
+
+void sfetrx4_pool_init(struct sfetrx4_pool* pool)
+{
+    memset(pool, 0, sizeof(*pool));
+}
+
+static uint64_t _sfetrx4_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+int sfetrx4_pool_create_stream(struct sfetrx4_pool* pool,
+                               device_t* device,
+                               unsigned core_id,
+                               const char* dformat,
+                               logical_ch_msk_t channels,
+                               unsigned pktsyms,
+                               unsigned flags,
+                               unsigned sx_base,
+                               unsigned sx_cfg_base,
+                               unsigned fe_fifobsz,
+                               unsigned fe_base,
+                               stream_handle_t** outu,
+                               unsigned *hw_chans_cnt)
+{
+    stream_sfetrx_dma32_t* pooled;
+    uint64_t start = _sfetrx4_now_ns();
+    int res = -EAGAIN;
+
+    if (core_id >= SIZEOF_ARRAY(pool->parked))
+        return -EINVAL;
+
+    pooled = (stream_sfetrx_dma32_t*)pool->parked[core_id];
+    if (pooled) {
+        res = _sfetrx4_create(device, core_id, dformat, channels, pktsyms, flags,
+                              sx_base, sx_cfg_base, fe_fifobsz, fe_base, pooled,
+                              outu, hw_chans_cnt);
+        if (res == 0) {
+            pool->parked[core_id] = NULL;
+            pool->hits++;
+        } else if (res == -EAGAIN) {
+            USDR_LOG("DSTR", USDR_LOG_INFO, "Pooled stream %d doesn't fit requested geometry, reallocating\n",
+                     pooled->ll_streamo);
+
+            pool->parked[core_id] = NULL;
+            res = _sfetrx4_destroy(&pooled->base);
+            if (res)
+                return res;
+
+            res = -EAGAIN;
+        } else {
+            // Cores may be half reconfigured, never park it again
+            pool->parked[core_id] = NULL;
+            _sfetrx4_destroy(&pooled->base);
+            return res;
+        }
+    }
+
+    if (res == -EAGAIN) {
+        pool->misses++;
+        res = create_sfetrx4_stream(device, core_id, dformat, channels, pktsyms, flags,
+                                    sx_base, sx_cfg_base, fe_fifobsz, fe_base,
+                                    outu, hw_chans_cnt);
+        if (res)
+            return res;
+    }
+
+    pool->restart_ns = _sfetrx4_now_ns() - start;
+    ((stream_sfetrx_dma32_t*)*outu)->restart_ns = pool->restart_ns;
+
+    USDR_LOG("DSTR", USDR_LOG_INFO, "Stream %d is ready in %.1f us (%s), pool hits/misses %d/%d\n",
+             ((stream_sfetrx_dma32_t*)*outu)->ll_streamo, pool->restart_ns / 1000.0,
+             ((stream_sfetrx_dma32_t*)*outu)->pooled ? "pooled" : "allocated",
+             pool->hits, pool->misses);
+    return 0;
+}
+
+int sfetrx4_pool_release_stream(struct sfetrx4_pool* pool,
+                                stream_handle_t* str)
+{
+    stream_sfetrx_dma32_t* stream = (stream_sfetrx_dma32_t*)str;
+    lldev_t dev = stream->base.dev->dev;
+    lowlevel_ops_t* dops = lowlevel_get_ops(dev);
+    int res;
+
+    if (stream->core_id >= SIZEOF_ARRAY(pool->parked) || pool->parked[stream->core_id] != NULL)
+        return _sfetrx4_destroy(str);
+
+    res = _sfetrx4_stop(stream);
+    if (res)
+        return res;
+
+    if (stream->type == USDR_ZCPY_RX) {
+        // Drop everything was captured before stop, so restarted stream begins clean
+        void* buf;
+        uint64_t oob_data[2];
+        unsigned oob_size;
+        for (unsigned i = 0; i < stream->ll_buffers; i++) {
+            oob_size = sizeof(oob_data);
+            res = dops->recv_dma_wait(dev, 0, stream->ll_streamo, &buf, &oob_data, &oob_size, 0);
+            if (res < 0)
+                break;
+
+            dops->recv_dma_release(dev, 0, stream->ll_streamo, buf);
+        }
+    }
+
+    free(stream->shift_buf);
+    stream->shift_buf = NULL;
+
+    USDR_LOG("DSTR", USDR_LOG_DEBUG, "Stream %d is parked\n", stream->ll_streamo);
+    pool->parked[stream->core_id] = str;
+    return 0;
+}
+
+int sfetrx4_pool_destroy(struct sfetrx4_pool* pool)
+{
+    int res = 0;
+    for (unsigned i = 0; i < SIZEOF_ARRAY(pool->parked); i++) {
+        if (pool->parked[i] == NULL)
+            continue;
+
+        res = (res) ? res : _sfetrx4_destroy(pool->parked[i]);
+        pool->parked[i] = NULL;
+    }
+    return res;
+}
+
 enum {
     ST_STOP         = 0,
     ST_ONEPPS       = 1,
@@ -857,9 +1756,20 @@ int sfetrx4_stream_sync(device_t* device,
                         stream_handle_t** pstr, unsigned scount, const char* synctype)
 {
     int res;
-    int retimer_base = 14; //TODO: get from device
+    uint64_t retimer_base;
     stream_sfetrx_dma32_t** pstream = (stream_sfetrx_dma32_t**)pstr;
 
+    // Single board is always aligned with itself
+    if (synctype && (!strcmp(synctype, "measure") || !strcmp(synctype, "align")))
+        return 0;
+
+    res = usdr_device_vfs_obj_val_get_u64(device, "/ll/sync/0/base", &retimer_base);
+    if (res) {
+        USDR_LOG("UDMS", USDR_LOG_ERROR, "Device has no retimer core, sync `%s` isn't supported!\n",
+                 synctype ? synctype : "none");
+        return -ENOTSUP;
+    }
+
     if (synctype == NULL || !strcmp(synctype, "none")) {
         res = lowlevel_reg_wr32(device->dev, 0, retimer_base, (1u << 31) | (ST_FREERUN << 16));
     } else if (!strcmp(synctype, "sysref") || !strcmp(synctype, "1pps")) {
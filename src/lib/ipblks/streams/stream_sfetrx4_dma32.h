@@ -46,6 +46,54 @@ int create_sfetrx4_stream(device_t* device,
                           stream_handle_t** outu,
                           unsigned *hw_chans_cnt);
 
+// Called from usdr_dms_recv() with per-channel statistics of every RX packet
+// starting at sample ts
+typedef void (*sfetrx4_level_cb_t)(void* obj, const struct usdr_dms_ch_stat* stats,
+                                   unsigned channels, unsigned nsyms, uint64_t ts);
+
+// Attach level consumer to RX stream, NULL detaches. -ENOTSUP if statistics
+// can't be gathered for the stream format.
+int sfetrx4_stream_set_level_cb(stream_handle_t* str, sfetrx4_level_cb_t cb, void* obj);
+
+// Splits cyclic waveform of `samples` into chunks of at most `pkt_symbs`
+// starting at multiples of `granule`. When the waveform fits into the DMA ring
+// of `ring` buffers the number of chunks divides it. `start` receives the
+// first sample of every chunk plus the total, so it has to hold
+// max(ring, packets) + 1 entries. Returns number of chunks.
+unsigned sfetrx4_cyclic_split(unsigned samples, unsigned pkt_symbs, unsigned granule,
+                              unsigned ring, unsigned* start);
+
+// Pool of stopped streams keeping lowlevel buffers for fast restart
+struct sfetrx4_pool {
+    stream_handle_t* parked[2]; // Indexed by core_id
+    uint64_t restart_ns;        // Time spent on the last stream creation
+    unsigned hits;
+    unsigned misses;
+};
+
+void sfetrx4_pool_init(struct sfetrx4_pool* pool);
+
+// Reuses parked stream when buffer geometry allows, creates a new one otherwise
+int sfetrx4_pool_create_stream(struct sfetrx4_pool* pool,
+                               device_t* device,
+                               unsigned core_id,
+                               const char* dformat,
+                               logical_ch_msk_t channels,
+                               unsigned pktsyms,
+                               unsigned flags,
+                               unsigned sx_base,
+                               unsigned sx_cfg_base,
+                               unsigned fe_fifobsz,
+                               unsigned fe_base,
+                               stream_handle_t** outu,
+                               unsigned *hw_chans_cnt);
+
+// Stops the stream and puts it into the pool instead of destroying
+int sfetrx4_pool_release_stream(struct sfetrx4_pool* pool,
+                                stream_handle_t* str);
+
+int sfetrx4_pool_destroy(struct sfetrx4_pool* pool);
+
 // Syncronize streams
 int sfetrx4_stream_sync(device_t* device,
                         stream_handle_t** pstream, unsigned scount,
@@ -0,0 +1,470 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "stream_shm.h"
+
+#include <usdr_logging.h>
+#include "../../xdsp/conv.h"
+
+enum {
+    SHM_RING_MAGIC = 0x55534852, // USHR
+    SHM_ALIGN = 64,
+};
+
+struct stream_shm_hdr {
+    uint32_t magic;
+    uint32_t depth;
+    uint32_t slot_bytes;    // Slot size including slot header
+    uint32_t pkt_bytes;     // Wire bytes of a full packet
+    uint32_t pktsyms;
+    uint32_t channels;
+    char wire_fmt[16];
+    uint32_t _pad0[6];
+
+    uint32_t seq;           // Number of published packets, futex word
+    uint32_t waiters;       // Consumers sleeping on seq
+    uint32_t _pad1[14];
+};
+
+struct stream_shm_slot {
+    uint32_t stamp;         // Packet number + 1, 0 while the slot is being written
+    uint32_t totsyms;
+    uint32_t totlost;
+    uint32_t _pad0;
+    uint64_t fsymtime;
+    uint64_t extra;
+    uint32_t _pad1[8];
+};
+
+struct stream_shm_producer {
+    char name[STREAM_SHM_NAME_MAX];
+    struct stream_shm_hdr* hdr;
+    size_t length;
+    uint32_t seq;
+};
+
+struct stream_shm_reader {
+    struct stream_handle base;
+
+    struct stream_shm_hdr* hdr;
+    size_t length;
+
+    uint32_t next;          // Next packet to consume
+
+    conv_function_t tf_data;
+    size_function_t tf_size;
+
+    uint64_t pkts;
+    uint64_t dropped;       // Packets overwritten before they were consumed
+    unsigned lost_syms;     // Lost symbols not yet reported to the user
+};
+typedef struct stream_shm_reader stream_shm_reader_t;
+
+
+static struct stream_shm_slot* _shm_slot(struct stream_shm_hdr* hdr, uint32_t seq)
+{
+    uint8_t* base = (uint8_t*)(hdr + 1);
+    return (struct stream_shm_slot*)(base + (size_t)(seq % hdr->depth) * hdr->slot_bytes);
+}
+
+static int _shm_futex(uint32_t* addr, int op, uint32_t val, const struct timespec* ts)
+{
+    // Ring is shared between processes, so no FUTEX_PRIVATE_FLAG
+    return syscall(SYS_futex, addr, op, val, ts, NULL, 0);
+}
+
+static int _shm_map(const char* name, bool crt, size_t length, void** out)
+{
+    int fd, res = 0;
+    void* addr;
+
+    // Consumers write waiters counter only
+    fd = shm_open(name, crt ? (O_CREAT | O_EXCL | O_RDWR) : O_RDWR, 0600);
+    if (fd < 0)
+        return -errno;
+
+    if (crt && ftruncate(fd, length)) {
+        res = -errno;
+        goto failed;
+    }
+
+    if (!crt) {
+        struct stat st;
+        if (fstat(fd, &st)) {
+            res = -errno;
+            goto failed;
+        }
+        if ((size_t)st.st_size < sizeof(struct stream_shm_hdr)) {
+            res = -EINVAL;
+            goto failed;
+        }
+        length = st.st_size;
+    }
+
+    addr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        res = -errno;
+        goto failed;
+    }
+
+    close(fd);
+    *out = addr;
+    return length;
+
+failed:
+    close(fd);
+    if (crt)
+        shm_unlink(name);
+    return res;
+}
+
+int stream_shm_producer_create(const char* name,
+                               const char* wire_fmt,
+                               unsigned channels,
+                               unsigned pktsyms,
+                               unsigned pkt_bytes,
+                               unsigned depth,
+                               stream_shm_producer_t** out)
+{
+    stream_shm_producer_t* p;
+    struct stream_shm_hdr* hdr;
+    unsigned slot_bytes;
+    size_t length;
+    void* addr;
+    int res;
+
+    if (depth < 2 || depth > STREAM_SHM_MAX_DEPTH || pkt_bytes == 0 || channels == 0 || pktsyms == 0)
+        return -EINVAL;
+    if (strlen(name) >= STREAM_SHM_NAME_MAX || strlen(wire_fmt) >= sizeof(hdr->wire_fmt))
+        return -EINVAL;
+
+    slot_bytes = (sizeof(struct stream_shm_slot) + pkt_bytes + SHM_ALIGN - 1) & ~(SHM_ALIGN - 1u);
+    length = sizeof(struct stream_shm_hdr) + (size_t)slot_bytes * depth;
+
+    p = (stream_shm_producer_t*)malloc(sizeof(stream_shm_producer_t));
+    if (p == NULL)
+        return -ENOMEM;
+
+    // Stale object of a crashed owner
+    shm_unlink(name);
+
+    res = _shm_map(name, true, length, &addr);
+    if (res < 0) {
+        USDR_LOG("SHMR", USDR_LOG_ERROR, "Unable to create shared memory `%s`, error %d\n", name, res);
+        free(p);
+        return res;
+    }
+
+    hdr = (struct stream_shm_hdr*)addr;
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->depth = depth;
+    hdr->slot_bytes = slot_bytes;
+    hdr->pkt_bytes = pkt_bytes;
+    hdr->pktsyms = pktsyms;
+    hdr->channels = channels;
+    strncpy(hdr->wire_fmt, wire_fmt, sizeof(hdr->wire_fmt) - 1);
+    __atomic_store_n(&hdr->magic, SHM_RING_MAGIC, __ATOMIC_RELEASE);
+
+    strncpy(p->name, name, sizeof(p->name) - 1);
+    p->name[sizeof(p->name) - 1] = 0;
+    p->hdr = hdr;
+    p->length = length;
+    p->seq = 0;
+
+    USDR_LOG("SHMR", USDR_LOG_INFO, "Ring `%s` created, %s %d ch, %d bytes x %d slots\n",
+             name, wire_fmt, channels, pkt_bytes, depth);
+
+    *out = p;
+    return 0;
+}
+
+int stream_shm_producer_destroy(stream_shm_producer_t* p)
+{
+    shm_unlink(p->name);
+    munmap(p->hdr, p->length);
+    free(p);
+    return 0;
+}
+
+void* stream_shm_producer_slot(stream_shm_producer_t* p)
+{
+    struct stream_shm_slot* s = _shm_slot(p->hdr, p->seq);
+
+    // Readers of the previous lap see the slot as overwritten from now on
+    __atomic_store_n(&s->stamp, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return s + 1;
+}
+
+void stream_shm_producer_commit(stream_shm_producer_t* p, const struct usdr_dms_recv_nfo* nfo)
+{
+    struct stream_shm_slot* s = _shm_slot(p->hdr, p->seq);
+
+    s->totsyms = nfo->totsyms;
+    s->totlost = nfo->totlost;
+    s->fsymtime = nfo->fsymtime;
+    s->extra = nfo->extra;
+    __atomic_store_n(&s->stamp, p->seq + 1, __ATOMIC_RELEASE);
+
+    p->seq++;
+    __atomic_store_n(&p->hdr->seq, p->seq, __ATOMIC_RELEASE);
+
+    // Pairs with the fence in the reader, either it sees new seq or we see it waiting
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&p->hdr->waiters, __ATOMIC_RELAXED)) {
+        _shm_futex(&p->hdr->seq, FUTEX_WAKE, INT_MAX, NULL);
+    }
+}
+
+
+static int _shm_reader_wait(stream_shm_reader_t* r, uint32_t seq, const struct timespec* deadline)
+{
+    struct stream_shm_hdr* hdr = r->hdr;
+    struct timespec now, rel, *prel = NULL;
+    int res = 0;
+
+    if (deadline) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        rel.tv_sec = deadline->tv_sec - now.tv_sec;
+        rel.tv_nsec = deadline->tv_nsec - now.tv_nsec;
+        if (rel.tv_nsec < 0) {
+            rel.tv_nsec += 1000000000;
+            rel.tv_sec--;
+        }
+        if (rel.tv_sec < 0)
+            return -ETIMEDOUT;
+        prel = &rel;
+    }
+
+    __atomic_add_fetch(&hdr->waiters, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&hdr->seq, __ATOMIC_SEQ_CST) == seq) {
+        if (_shm_futex(&hdr->seq, FUTEX_WAIT, seq, prel) && errno == ETIMEDOUT)
+            res = -ETIMEDOUT;
+    }
+    __atomic_sub_fetch(&hdr->waiters, 1, __ATOMIC_SEQ_CST);
+    return res;
+}
+
+static
+int _shm_reader_recv(stream_handle_t* str,
+                     char** stream_buffs,
+                     unsigned timeout,
+                     struct usdr_dms_recv_nfo* nfo)
+{
+    stream_shm_reader_t* r = (stream_shm_reader_t*)str;
+    struct stream_shm_hdr* hdr = r->hdr;
+    struct timespec ts, *deadline = NULL;
+    int res;
+
+    if (timeout != ~0u) {
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        ts.tv_sec += timeout / 1000;
+        ts.tv_nsec += (timeout % 1000) * 1000000;
+        if (ts.tv_nsec >= 1000000000) {
+            ts.tv_nsec -= 1000000000;
+            ts.tv_sec++;
+        }
+        deadline = &ts;
+    }
+
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&hdr->seq, __ATOMIC_ACQUIRE);
+        struct stream_shm_slot* s;
+        uint32_t stamp, wire_bytes, totsyms;
+
+        if (seq == r->next) {
+            res = _shm_reader_wait(r, seq, deadline);
+            if (res)
+                return res;
+            continue;
+        }
+
+        if (seq - r->next > hdr->depth) {
+            // Lapped by the producer, continue from the oldest slot
+            uint32_t skip = seq - hdr->depth - r->next;
+            r->dropped += skip;
+            r->lost_syms += skip * hdr->pktsyms;
+            r->next += skip;
+        }
+
+        s = _shm_slot(hdr, r->next);
+        stamp = __atomic_load_n(&s->stamp, __ATOMIC_ACQUIRE);
+        totsyms = s->totsyms;
+        if (stamp != r->next + 1 || totsyms > hdr->pktsyms) {
+            r->dropped++;
+            r->lost_syms += hdr->pktsyms;
+            r->next++;
+            continue;
+        }
+
+        if (nfo) {
+            nfo->fsymtime = s->fsymtime;
+            nfo->totsyms = totsyms;
+            nfo->extra = s->extra;
+            nfo->stats = NULL;
+        }
+
+        wire_bytes = (uint64_t)totsyms * hdr->pkt_bytes / hdr->pktsyms;
+        const void* wire = s + 1;
+        r->tf_data(&wire, wire_bytes, (void**)stream_buffs, r->tf_size(wire_bytes, false));
+
+        // Producer may have started to overwrite the slot during conversion
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&s->stamp, __ATOMIC_RELAXED) != stamp) {
+            r->dropped++;
+            r->lost_syms += totsyms;
+            r->next++;
+            continue;
+        }
+
+        if (nfo) {
+            nfo->totlost = r->lost_syms + s->totlost;
+        }
+        r->lost_syms = 0;
+        r->pkts++;
+        r->next++;
+        return 0;
+    }
+}
+
+static
+int _shm_reader_op(stream_handle_t* UNUSED str,
+                   unsigned UNUSED command,
+                   dm_time_t UNUSED tm)
+{
+    // Stream is controlled by the owner process only
+    return -ENOTSUP;
+}
+
+static
+int _shm_reader_stat(stream_handle_t* str, usdr_dms_nfo_t* nfo)
+{
+    stream_shm_reader_t* r = (stream_shm_reader_t*)str;
+    struct stream_shm_hdr* hdr = r->hdr;
+
+    nfo->type = USDR_DMS_RX;
+    nfo->channels = hdr->channels;
+    nfo->pktsyms = hdr->pktsyms;
+    nfo->pktbszie = r->tf_size(hdr->pkt_bytes, false) / hdr->channels;
+    nfo->totsamptick = hdr->channels;
+    nfo->burst_count = 1;
+    return 0;
+}
+
+static
+int _shm_reader_option_get(stream_handle_t* str, const char* name, int64_t* out_val)
+{
+    stream_shm_reader_t* r = (stream_shm_reader_t*)str;
+    if (strcmp(name, "pkts") == 0) {
+        *out_val = r->pkts;
+        return 0;
+    } else if (strcmp(name, "dropped") == 0) {
+        *out_val = r->dropped;
+        return 0;
+    } else if (strcmp(name, "backlog") == 0) {
+        *out_val = __atomic_load_n(&r->hdr->seq, __ATOMIC_ACQUIRE) - r->next;
+        return 0;
+    }
+    return -EINVAL;
+}
+
+static
+int _shm_reader_option_set(stream_handle_t* UNUSED str, const char* UNUSED name, int64_t UNUSED in_val)
+{
+    return -EINVAL;
+}
+
+static
+int _shm_reader_destroy(stream_handle_t* str)
+{
+    stream_shm_reader_t* r = (stream_shm_reader_t*)str;
+
+    USDR_LOG("SHMR", USDR_LOG_INFO, "Reader %p detached, %" PRIu64 " packets received, %" PRIu64 " dropped\n",
+             r, r->pkts, r->dropped);
+
+    munmap(r->hdr, r->length);
+    free(r);
+    return 0;
+}
+
+static const struct stream_ops s_shm_reader_ops = {
+    .destroy = &_shm_reader_destroy,
+    .op = &_shm_reader_op,
+    .recv = &_shm_reader_recv,
+    .stat = &_shm_reader_stat,
+    .option_get = &_shm_reader_option_get,
+    .option_set = &_shm_reader_option_set,
+};
+
+int stream_shm_attach(device_t* dev,
+                      const char* name,
+                      const char* host_fmt,
+                      stream_handle_t** out)
+{
+    stream_shm_reader_t* r;
+    struct stream_shm_hdr* hdr;
+    transform_info_t funcs;
+    void* addr;
+    int res;
+
+    res = _shm_map(name, false, 0, &addr);
+    if (res < 0) {
+        USDR_LOG("SHMR", USDR_LOG_ERROR, "Unable to open shared memory `%s`, error %d\n", name, res);
+        return res;
+    }
+
+    hdr = (struct stream_shm_hdr*)addr;
+    if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != SHM_RING_MAGIC ||
+            hdr->depth == 0 || hdr->pktsyms == 0 || hdr->channels == 0 ||
+            sizeof(*hdr) + (size_t)hdr->slot_bytes * hdr->depth > (size_t)res) {
+        munmap(addr, res);
+        return -EINVAL;
+    }
+
+    if (host_fmt == NULL)
+        host_fmt = hdr->wire_fmt;
+
+    funcs = get_transform_fn(hdr->wire_fmt, host_fmt, 1, hdr->channels);
+    if (funcs.cfunc == NULL || funcs.sfunc == NULL) {
+        USDR_LOG("SHMR", USDR_LOG_ERROR, "No transform function '%s'->'%s' are available for 1->%d demux\n",
+                 hdr->wire_fmt, host_fmt, hdr->channels);
+        munmap(addr, res);
+        return -EINVAL;
+    }
+
+    r = (stream_shm_reader_t*)malloc(sizeof(stream_shm_reader_t));
+    if (r == NULL) {
+        munmap(addr, res);
+        return -ENOMEM;
+    }
+
+    memset(r, 0, sizeof(*r));
+    r->base.dev = dev;
+    r->base.ops = &s_shm_reader_ops;
+    r->hdr = hdr;
+    r->length = res;
+    r->tf_data = funcs.cfunc;
+    r->tf_size = funcs.sfunc;
+
+    // New reader sees only data published after attachment
+    r->next = __atomic_load_n(&hdr->seq, __ATOMIC_ACQUIRE);
+
+    USDR_LOG("SHMR", USDR_LOG_INFO, "Reader %p attached to `%s` as '%s'\n",
+             r, name, host_fmt);
+
+    *out = &r->base;
+    return 0;
+}
@@ -0,0 +1,48 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef STREAM_SHM_H
+#define STREAM_SHM_H
+
+#include "streams_api.h"
+
+// RX wire packets published to other processes through POSIX shared memory.
+//
+// Single producer ring, the producer never waits for consumers: slots are
+// overwritten in order and each one carries a sequence stamp, so a lagging
+// consumer detects overrun and torn reads. Consumers are regular RX stream
+// handles converting wire data to their own host format right from the
+// shared memory. Sleeping consumers are woken up through a futex on the
+// published packet counter.
+
+enum {
+    STREAM_SHM_MAX_DEPTH = 256,
+    STREAM_SHM_NAME_MAX = 64,
+};
+
+struct stream_shm_producer;
+typedef struct stream_shm_producer stream_shm_producer_t;
+
+int stream_shm_producer_create(const char* name,
+                               const char* wire_fmt,
+                               unsigned channels,
+                               unsigned pktsyms,
+                               unsigned pkt_bytes,
+                               unsigned depth,
+                               stream_shm_producer_t** out);
+
+// Shared memory object is unlinked, attached consumers keep their mapping
+int stream_shm_producer_destroy(stream_shm_producer_t* p);
+
+// Slot for the next packet of pkt_bytes, it's invalidated for consumers and
+// may be filled until stream_shm_producer_commit()
+void* stream_shm_producer_slot(stream_shm_producer_t* p);
+void stream_shm_producer_commit(stream_shm_producer_t* p, const struct usdr_dms_recv_nfo* nfo);
+
+// Attach consumer to the ring, @p host_fmt NULL keeps wire format
+int stream_shm_attach(device_t* dev,
+                      const char* name,
+                      const char* host_fmt,
+                      stream_handle_t** out);
+
+#endif
@@ -0,0 +1,454 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <math.h>
+#include <inttypes.h>
+
+#include "stream_trigger.h"
+
+#include <usdr_logging.h>
+#include "../../xdsp/conv.h"
+#include "../../xdsp/detector_functions.h"
+
+enum {
+    TRIGGER_HIST_PKTS = 4, // History headroom in source packets, amortizes compaction
+};
+
+struct stream_trigger {
+    struct stream_handle base;
+    stream_handle_t* src;
+    struct usdr_dms_trigger_cfg cfg;
+
+    usdr_dms_nfo_t snfo;
+    unsigned wire_bytes;
+    conv_function_t tf_data;
+    size_function_t tf_size;
+
+    detector_power_cf32_function_t fn_power;
+    detector_xcorr_cf32_function_t fn_xcorr;
+    detector_scan_f32_function_t fn_scan;
+    float* pre;          // Unit energy preamble
+    unsigned look;       // Samples the metric needs past its index
+
+    unsigned cap;        // History capacity in samples
+    float** hist;        // cf32 history of every channel
+    void** outs;         // Conversion targets inside the history
+    float* metric;
+    uint64_t base_ts;    // Timestamp of hist[][0]
+    bool have_base;
+
+    unsigned fill;       // Valid samples in the history
+    unsigned mpos;       // Metric is computed up to
+    unsigned spos;       // Metric is scanned up to
+    unsigned armed;
+    bool pending;        // Waiting for post trigger samples
+    unsigned tpos;
+
+    uint64_t pkts;
+    uint64_t triggers;
+    uint64_t windows;
+    uint64_t dropped;    // Windows cut by lost samples
+    uint64_t lost_syms;  // Lost samples not yet reported to the user
+};
+typedef struct stream_trigger stream_trigger_t;
+
+static void _trigger_compact(stream_trigger_t* t)
+{
+    unsigned from = t->pending ? t->tpos : t->spos;
+    from = (from > t->cfg.pre_syms) ? from - t->cfg.pre_syms : 0;
+    if (from == 0)
+        return;
+
+    for (unsigned c = 0; c < t->snfo.channels; c++) {
+        memmove(t->hist[c], t->hist[c] + 2 * from, (t->fill - from) * 2 * sizeof(float));
+    }
+    if (t->mpos > from) {
+        memmove(t->metric, t->metric + from, (t->mpos - from) * sizeof(float));
+    }
+
+    t->fill -= from;
+    t->mpos = (t->mpos > from) ? t->mpos - from : 0;
+    t->spos = (t->spos > from) ? t->spos - from : 0;
+    t->tpos -= (t->pending) ? from : 0;
+    t->base_ts += from;
+}
+
+static void _trigger_reset(stream_trigger_t* t, uint64_t ts)
+{
+    if (t->pending) {
+        t->dropped++;
+        t->pending = false;
+    }
+    t->fill = t->mpos = t->spos = 0;
+    t->base_ts = ts;
+}
+
+static int _trigger_fetch(stream_trigger_t* t, unsigned timeout)
+{
+    stream_handle_t* src = t->src;
+    struct usdr_dms_recv_nfo rnfo;
+    void* buf;
+    unsigned wire_bytes;
+    int res;
+
+    res = src->ops->recv_raw(src, &buf, timeout, &rnfo);
+    if (res)
+        return res;
+
+    if (rnfo.totsyms > t->snfo.pktsyms) {
+        USDR_LOG("TRIG", USDR_LOG_ERROR, "Packet of %d samples exceeds %d samples history reserve\n",
+                 rnfo.totsyms, t->snfo.pktsyms);
+        src->ops->release_raw(src, buf);
+        return -EOVERFLOW;
+    }
+
+    if (!t->have_base) {
+        t->base_ts = rnfo.fsymtime;
+        t->have_base = true;
+    } else if (rnfo.totlost || rnfo.fsymtime != t->base_ts + t->fill) {
+        // History isn't contiguous anymore
+        USDR_LOG("TRIG", USDR_LOG_DEBUG, "Discontinuity at %" PRIu64 ", %d samples lost\n",
+                 rnfo.fsymtime, rnfo.totlost);
+        if (rnfo.totlost) {
+            t->lost_syms += rnfo.totlost;
+        } else if (rnfo.fsymtime > t->base_ts + t->fill) {
+            t->lost_syms += rnfo.fsymtime - t->base_ts - t->fill;
+        }
+        _trigger_reset(t, rnfo.fsymtime);
+    }
+
+    if (t->fill + rnfo.totsyms > t->cap) {
+        _trigger_compact(t);
+    }
+
+    // Packet size may be altered on the fly, keep layout in sync with the source
+    wire_bytes = (uint64_t)rnfo.totsyms * t->wire_bytes / t->snfo.pktsyms;
+    for (unsigned c = 0; c < t->snfo.channels; c++) {
+        t->outs[c] = t->hist[c] + 2 * t->fill;
+    }
+    t->tf_data((const void**)&buf, wire_bytes, t->outs, t->tf_size(wire_bytes, false));
+    t->fill += rnfo.totsyms;
+    t->pkts++;
+
+    return src->ops->release_raw(src, buf);
+}
+
+// Run detector over newly converted samples up to the next trigger
+static void _trigger_detect(stream_trigger_t* t)
+{
+    const float* h = t->hist[t->cfg.channel];
+    unsigned lim = (t->fill > t->look) ? t->fill - t->look : 0;
+    unsigned idx;
+
+    if (t->mpos < lim) {
+        if (t->fn_xcorr) {
+            t->fn_xcorr(h + 2 * t->mpos, lim - t->mpos, t->pre, t->cfg.preamble_syms, t->metric + t->mpos);
+        } else {
+            t->fn_power(h + 2 * t->mpos, lim - t->mpos, t->metric + t->mpos);
+        }
+        t->mpos = lim;
+    }
+
+    if (t->spos == t->mpos)
+        return;
+
+    idx = t->fn_scan(t->metric + t->spos, t->mpos - t->spos, t->cfg.thr_on, t->cfg.thr_off, &t->armed);
+    t->spos += idx;
+    if (t->spos == t->mpos)
+        return;
+
+    t->pending = true;
+    t->tpos = t->spos++;
+    t->triggers++;
+}
+
+static unsigned _trigger_remaining(const struct timespec* deadline)
+{
+    struct timespec now;
+    int64_t ms;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    ms = (deadline->tv_sec - now.tv_sec) * 1000 + (deadline->tv_nsec - now.tv_nsec) / 1000000;
+    return (ms > 0) ? ms : 0;
+}
+
+static
+int _trigger_recv(stream_handle_t* str,
+                  char** stream_buffs,
+                  unsigned timeout,
+                  struct usdr_dms_recv_nfo* nfo)
+{
+    stream_trigger_t* t = (stream_trigger_t*)str;
+    struct timespec deadline;
+    unsigned start, count, rem = ~0u;
+    bool fetched = false;
+    int res;
+
+    if (timeout != ~0u) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout / 1000;
+        deadline.tv_nsec += (timeout % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_nsec -= 1000000000;
+            deadline.tv_sec++;
+        }
+    }
+
+    for (;;) {
+        if (!t->pending)
+            _trigger_detect(t);
+        if (t->pending && t->fill >= t->tpos + t->cfg.post_syms)
+            break;
+
+        // Source may have data ready all the time, don't spin past the deadline
+        if (timeout != ~0u) {
+            rem = _trigger_remaining(&deadline);
+            if (rem == 0 && fetched)
+                return -ETIMEDOUT;
+        }
+
+        res = _trigger_fetch(t, rem);
+        if (res)
+            return res;
+        fetched = true;
+    }
+
+    start = (t->tpos > t->cfg.pre_syms) ? t->tpos - t->cfg.pre_syms : 0;
+    count = t->tpos + t->cfg.post_syms - start;
+    for (unsigned c = 0; c < t->snfo.channels; c++) {
+        memcpy(stream_buffs[c], t->hist[c] + 2 * start, count * 2 * sizeof(float));
+    }
+
+    if (nfo) {
+        nfo->fsymtime = t->base_ts + start;
+        nfo->totsyms = count;
+        nfo->totlost = t->lost_syms;
+        nfo->extra = t->base_ts + t->tpos;
+        nfo->stats = NULL;
+    }
+
+    t->lost_syms = 0;
+    t->pending = false;
+    t->windows++;
+    return 0;
+}
+
+static
+int _trigger_op(stream_handle_t* UNUSED str,
+                unsigned UNUSED command,
+                dm_time_t UNUSED tm)
+{
+    // Source stream is controlled by its owner only
+    return -ENOTSUP;
+}
+
+static
+int _trigger_stat(stream_handle_t* str, usdr_dms_nfo_t* nfo)
+{
+    stream_trigger_t* t = (stream_trigger_t*)str;
+    int res = t->src->ops->stat(t->src, nfo);
+    if (res)
+        return res;
+
+    nfo->pktsyms = t->cfg.pre_syms + t->cfg.post_syms;
+    nfo->pktbszie = nfo->pktsyms * 2 * sizeof(float);
+    return 0;
+}
+
+static
+int _trigger_option_get(stream_handle_t* str, const char* name, int64_t* out_val)
+{
+    stream_trigger_t* t = (stream_trigger_t*)str;
+    if (strcmp(name, "pkts") == 0) {
+        *out_val = t->pkts;
+        return 0;
+    } else if (strcmp(name, "triggers") == 0) {
+        *out_val = t->triggers;
+        return 0;
+    } else if (strcmp(name, "windows") == 0) {
+        *out_val = t->windows;
+        return 0;
+    } else if (strcmp(name, "dropped") == 0) {
+        *out_val = t->dropped;
+        return 0;
+    } else if (strcmp(name, "armed") == 0) {
+        *out_val = t->armed;
+        return 0;
+    }
+    return -EINVAL;
+}
+
+static
+int _trigger_option_set(stream_handle_t* str, const char* name, int64_t in_val)
+{
+    stream_trigger_t* t = (stream_trigger_t*)str;
+    if (strcmp(name, "rearm") == 0) {
+        t->armed = (in_val != 0);
+        return 0;
+    }
+    return -EINVAL;
+}
+
+static
+int _trigger_destroy(stream_handle_t* str)
+{
+    return stream_trigger_destroy(str);
+}
+
+static const struct stream_ops s_trigger_ops = {
+    .destroy = &_trigger_destroy,
+    .op = &_trigger_op,
+    .recv = &_trigger_recv,
+    .stat = &_trigger_stat,
+    .option_get = &_trigger_option_get,
+    .option_set = &_trigger_option_set,
+};
+
+static int _trigger_set_preamble(stream_trigger_t* t, const float* p, unsigned plen)
+{
+    double e = 0;
+    float scale;
+
+    if (p == NULL || plen == 0 || plen > TRIGGER_MAX_PREAMBLE)
+        return -EINVAL;
+
+    for (unsigned k = 0; k < 2 * plen; k++) {
+        e += (double)p[k] * p[k];
+    }
+    if (!(e > 0))
+        return -EINVAL;
+
+    t->pre = (float*)malloc(plen * 2 * sizeof(float));
+    if (t->pre == NULL)
+        return -ENOMEM;
+
+    scale = 1.0 / sqrt(e);
+    for (unsigned k = 0; k < 2 * plen; k++) {
+        t->pre[k] = p[k] * scale;
+    }
+
+    t->look = plen - 1;
+    t->cfg.preamble = t->pre;
+    return 0;
+}
+
+int stream_trigger_create(stream_handle_t* src,
+                          const struct usdr_dms_trigger_cfg* cfg,
+                          stream_handle_t** out)
+{
+    int res;
+    int64_t wfmt, wbytes;
+    stream_trigger_t* t;
+    transform_info_t funcs;
+    const char* fname = NULL;
+
+    if (src->ops->recv_raw == NULL || src->ops->release_raw == NULL) {
+        USDR_LOG("TRIG", USDR_LOG_ERROR, "Stream doesn't support zero-copy access\n");
+        return -ENOTSUP;
+    }
+    if (cfg->type > USDR_DMS_TRIG_XCORR || cfg->post_syms == 0 || cfg->thr_off > cfg->thr_on)
+        return -EINVAL;
+
+    t = (stream_trigger_t*)malloc(sizeof(stream_trigger_t));
+    if (t == NULL)
+        return -ENOMEM;
+
+    memset(t, 0, sizeof(*t));
+    t->base.dev = src->dev;
+    t->base.ops = &s_trigger_ops;
+    t->src = src;
+    t->cfg = *cfg;
+    t->armed = 1;
+
+    res = src->ops->stat(src, &t->snfo);
+    res = (res) ? res : src->ops->option_get(src, "wire_fmt", &wfmt);
+    res = (res) ? res : src->ops->option_get(src, "wire_bytes", &wbytes);
+    if (res)
+        goto failed;
+
+    if (t->snfo.type != USDR_DMS_RX || cfg->channel >= t->snfo.channels) {
+        res = -EINVAL;
+        goto failed;
+    }
+
+    funcs = get_transform_fn((const char*)(intptr_t)wfmt, "cf32", 1, t->snfo.channels);
+    if (funcs.cfunc == NULL || funcs.sfunc == NULL) {
+        USDR_LOG("TRIG", USDR_LOG_ERROR, "No transform function '%s'->'cf32' are available for 1->%d demux\n",
+                 (const char*)(intptr_t)wfmt, t->snfo.channels);
+        res = -EINVAL;
+        goto failed;
+    }
+    t->tf_data = funcs.cfunc;
+    t->tf_size = funcs.sfunc;
+    t->wire_bytes = wbytes;
+
+    if (cfg->type == USDR_DMS_TRIG_XCORR) {
+        res = _trigger_set_preamble(t, cfg->preamble, cfg->preamble_syms);
+        if (res)
+            goto failed;
+
+        t->fn_xcorr = detector_xcorr_cf32_c(cpu_vcap_get(), &fname);
+    } else {
+        t->cfg.preamble = NULL;
+        t->cfg.preamble_syms = 0;
+        t->fn_power = detector_power_cf32_c(cpu_vcap_get(), &fname);
+    }
+    t->fn_scan = detector_scan_f32_c(cpu_vcap_get(), NULL);
+
+    t->cap = cfg->pre_syms + cfg->post_syms + t->look + TRIGGER_HIST_PKTS * t->snfo.pktsyms;
+    t->metric = (float*)malloc(t->cap * sizeof(float));
+    t->hist = (float**)calloc(t->snfo.channels, sizeof(float*));
+    t->outs = (void**)calloc(t->snfo.channels, sizeof(void*));
+    if (t->metric == NULL || t->hist == NULL || t->outs == NULL) {
+        res = -ENOMEM;
+        goto failed;
+    }
+    for (unsigned c = 0; c < t->snfo.channels; c++) {
+        t->hist[c] = (float*)malloc(t->cap * 2 * sizeof(float));
+        if (t->hist[c] == NULL) {
+            res = -ENOMEM;
+            goto failed;
+        }
+    }
+
+    USDR_LOG("TRIG", USDR_LOG_INFO, "Trigger created on stream %p, %s on channel %d, window %d+%d samples, %s\n",
+             src, (cfg->type == USDR_DMS_TRIG_XCORR) ? "correlation" : "power", cfg->channel,
+             cfg->pre_syms, cfg->post_syms, fname);
+
+    *out = &t->base;
+    return 0;
+
+failed:
+    stream_trigger_destroy(&t->base);
+    return res;
+}
+
+int stream_trigger_destroy(stream_handle_t* trig)
+{
+    stream_trigger_t* t = (stream_trigger_t*)trig;
+
+    if (trig->ops != &s_trigger_ops)
+        return -EINVAL;
+
+    if (t->triggers) {
+        USDR_LOG("TRIG", USDR_LOG_INFO, "Trigger %p destroyed, %" PRIu64 " triggers, %" PRIu64 " windows, %" PRIu64 " dropped\n",
+                 t, t->triggers, t->windows, t->dropped);
+    }
+
+    if (t->hist) {
+        for (unsigned c = 0; c < t->snfo.channels; c++) {
+            free(t->hist[c]);
+        }
+    }
+    free(t->hist);
+    free(t->outs);
+    free(t->metric);
+    free(t->pre);
+    free(t);
+    return 0;
+}
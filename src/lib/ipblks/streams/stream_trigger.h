@@ -0,0 +1,28 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef STREAM_TRIGGER_H
+#define STREAM_TRIGGER_H
+
+#include "streams_api.h"
+
+// Triggered capture on top of an RX stream.
+//
+// Wire buffers are pulled from the source with recv_raw() and converted to
+// cf32 history, the detector runs on the selected channel right after the
+// conversion. Only windows of pre + post samples around every trigger are
+// handed to the user, the rest of the data is discarded without ever
+// leaving the library. The source stream stays owned and controlled by the
+// caller, it may also be a fan-out reader.
+
+enum {
+    TRIGGER_MAX_PREAMBLE = 4096,
+};
+
+int stream_trigger_create(stream_handle_t* src,
+                          const struct usdr_dms_trigger_cfg* cfg,
+                          stream_handle_t** out);
+
+int stream_trigger_destroy(stream_handle_t* trig);
+
+#endif
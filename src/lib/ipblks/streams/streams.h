@@ -32,6 +32,10 @@ struct sample_format {
 #define SFMT_CF32 "cf32"
 #define SFMT_CF32_CI12 "cf32@ci12"
 
+// IEEE 754 half precision
+#define SFMT_CF16 "cf16"
+#define SFMT_CF16_CI12 "cf16@ci12"
+
 #define SFMT_FFT512_LOGPWR_I16 "cfftlpwri16"
 
 /// unspecified format, i.e. special structure-like format,
@@ -21,12 +21,28 @@ struct stream_ops {
                 unsigned timeout_ms,
                 struct usdr_dms_recv_nfo* nfo);
 
+    // Optional zero-copy access to wire buffers (RX only), every buffer
+    // obtained by recv_raw() should be returned back with release_raw()
+    // in the same order
+    int (*recv_raw)(stream_handle_t* stream,
+                    void **wire_buf,
+                    unsigned timeout_ms,
+                    struct usdr_dms_recv_nfo* nfo);
+    int (*release_raw)(stream_handle_t* stream, void *wire_buf);
+
     int (*send)(stream_handle_t* stream,
                 const char **stream_buffs,
                 unsigned samples,
                 dm_time_t timestamp,
                 unsigned timeout_ms);
 
+    // Optional cyclic transmission (TX only), waveform is converted once and
+    // replayed until stopped, next call swaps it on a cycle boundary
+    int (*send_cyclic)(stream_handle_t* stream,
+                       const char **stream_buffs,
+                       unsigned samples,
+                       dm_time_t timestamp);
+
     int (*stat)(stream_handle_t*, usdr_dms_nfo_t* nfo);
 
     // Custom stream options
@@ -89,6 +89,7 @@ enum {
 
 enum {
     VMA_STREAM_IDX_SHIFT = 28,
+    VMA_EVMAP_IDX = 0x20,
 };
 
 struct stream_core_state_rxbrst {
@@ -175,7 +176,8 @@ struct usdr_dev {
         struct event_data_log streaming[MAX_INT];
 
         struct i2c_cache i2cc[4 * MAX_I2C_COUNT];
-        uint32_t i2clut[MAX_I2C_COUNT];
+
+        struct pcie_driver_evmap* evmap;
 };
 
 static struct usdr_dev *usdr_list = NULL;
@@ -302,6 +304,13 @@ static irqreturn_t usdr_pcie_irq_i2c(int irq, void *data)
 }
 */
 
+// Data of the event must be stored before the sequence number is updated
+static void usdr_evmap_signal(struct usdr_dev *d, unsigned event_no)
+{
+    smp_wmb();
+    WRITE_ONCE(d->evmap->seq[event_no], d->evmap->seq[event_no] + 1);
+}
+
 // generic non-specific IRQ
 static irqreturn_t usdr_pcie_irq_event(int irq, void *data)
 {
@@ -315,6 +324,7 @@ static irqreturn_t usdr_pcie_irq_event(int irq, void *data)
 
     DEBUG_DEV_OUT(&d->pdev->dev, "IRQ Event: %d; cnt: %d\n", event_no, atomic_read(&d->irq_ev_cnt[event_no]));
     atomic_inc(&d->irq_ev_cnt[event_no]);
+    usdr_evmap_signal(d, event_no);
     wake_up_interruptible(&d->irq_ev_wq[event_no]);
 
     return IRQ_HANDLED;
@@ -482,8 +492,10 @@ irq_found:
             //       i, irq, event_no, flags, b->rptr, data[3], data[2], data[1], data[0], ets);
         } else {
             d->rb_ev_data[event_no] = data[1]; //0
+            WRITE_ONCE(d->evmap->data[event_no], data[1]);
         }
         atomic_inc(&d->irq_ev_cnt[event_no]);
+        usdr_evmap_signal(d, event_no);
         //wake_up_interruptible(&d->irq_ev_wq[event_no]);
         wakeups |= (1u << event_no);
     }
@@ -1109,8 +1121,8 @@ static int usdr_wait_event(struct usdr_dev *usdrdev,
         return res;
     }
 
-    BUG_ON(cnt > 0xff);
-    return cnt;
+    // SPI/I2C completions polled from the event page aren't consumed here
+    return (cnt > 0xff) ? 0xff : cnt;
 }
 
 static long usdrfd_ioctl(struct file *filp,
@@ -1232,6 +1244,9 @@ static long usdrfd_ioctl(struct file *filp,
         base = usdrdev->dl.spi_base[busno];
         irq = usdrdev->dl.spi_int_number[busno];
 
+        // Drop completions of transactions polled by userspace
+        atomic_xchg(&usdrdev->irq_ev_cnt[irq], 0);
+
         if (core == SPI_CORE_32W) {
             usdr_reg_wr32(usdrdev, base, sp.dw_io);
         } else if (core == SPI_CORE_CFGW_CS8) {
@@ -1269,6 +1284,7 @@ static long usdrfd_ioctl(struct file *filp,
     case PCIE_DRIVER_SI2C_TRANSACT: {
         struct pcie_driver_si2c si2c;
         unsigned i2cinst, i2cbus, i2caddr, core, base, irq, idx, lut, cmd;
+        __u64 cmd_lut;
 
         if (copy_from_user(&si2c, uptr, sizeof(si2c)))
                 return -EFAULT;
@@ -1300,14 +1316,13 @@ static long usdrfd_ioctl(struct file *filp,
         DEBUG_DEV_OUT(&usdrdev->pdev->dev, "I2C[%d.%d.%02x] W:%d,R:%d,CMD:%08x,LUT:%08x\n",
                       i2cinst, i2cbus, i2caddr, si2c.wcnt, si2c.rcnt, cmd, lut);
 
-        if (usdrdev->i2clut[i2cinst] == lut) {
-            usdr_reg_wr32(usdrdev, base, cmd);
-        } else {
-            // NOTE: usdr_reg_wr64 do cpu_to_be64() which reverse DWORD order on PCIe bus
-            __u64 cmd_lut = ((__u64)lut << 32) | cmd;
-            usdr_reg_wr64(usdrdev, base - 1, cmd_lut);
-            usdrdev->i2clut[i2cinst] = lut;
-        }
+        // Drop completions of transactions polled by userspace
+        atomic_xchg(&usdrdev->irq_ev_cnt[irq], 0);
+
+        // LUT isn't cached, it may be changed by userspace polled transactions
+        // NOTE: usdr_reg_wr64 do cpu_to_be64() which reverse DWORD order on PCIe bus
+        cmd_lut = ((__u64)lut << 32) | cmd;
+        usdr_reg_wr64(usdrdev, base - 1, cmd_lut);
 
         if (si2c.rcnt > 0) {
             unsigned dout, cnt;
@@ -1338,6 +1353,15 @@ static long usdrfd_ioctl(struct file *filp,
 
         return 0;
     }
+    case PCIE_DRIVER_EVMAP_CONF: {
+        struct pcie_driver_evmap_conf ec;
+        ec.out_vma_off = ((off_t)VMA_EVMAP_IDX) << VMA_STREAM_IDX_SHIFT;
+        ec.out_vma_length = PAGE_SIZE;
+
+        if (copy_to_user(uptr, &ec, sizeof(ec)))
+            return -EFAULT;
+        return 0;
+    }
     case PCIE_DRIVER_WAIT_SINGLE_EVENT: {
         unsigned event_no = ioctl_param & 0xFF;
         unsigned timeout_ms = ioctl_param >> 8;
@@ -1437,6 +1461,23 @@ static int usdrfd_mmap_io(struct usdr_dev *usdrdev, struct vm_area_struct *vma)
     return 0;
 }
 
+static int usdrfd_mmap_evmap(struct usdr_dev *usdrdev, struct vm_area_struct *vma)
+{
+    if (((vma->vm_end - vma->vm_start) >> PAGE_SHIFT) != 1)
+        return -EINVAL;
+    if (vma->vm_flags & VM_WRITE)
+        return -EPERM;
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(6, 3, 0)
+    vma->vm_flags &= ~VM_MAYWRITE;
+#else
+    vm_flags_clear(vma, VM_MAYWRITE);
+#endif
+
+    vma->vm_ops = &usdrfd_remap_vm_ops;
+    return vm_insert_page(vma, vma->vm_start, virt_to_page(usdrdev->evmap));
+}
+
 static int usdrfd_mmap(struct file *filp, struct vm_area_struct *vma)
 {
         struct usdr_dev *usdrdev = filp->private_data;
@@ -1455,6 +1496,9 @@ static int usdrfd_mmap(struct file *filp, struct vm_area_struct *vma)
         if (streamno == 0) {
             return usdrfd_mmap_io(usdrdev, vma);
         }
+        if (streamno == VMA_EVMAP_IDX) {
+            return usdrfd_mmap_evmap(usdrdev, vma);
+        }
 
         if (streamno > usdrdev->dl.streams_count) {
             return -EINVAL;
@@ -1582,6 +1626,13 @@ static int usdr_probe(struct pci_dev *pdev,
 		err = -ENOMEM;
 		goto err_unmap;
 	}
+        usdrdev->evmap = (struct pcie_driver_evmap*)get_zeroed_page(GFP_KERNEL);
+        if (!usdrdev->evmap) {
+		dev_err(&pdev->dev, "Failed to allocate memory.\n");
+		err = -ENOMEM;
+		goto err_free_dev;
+	}
+
         pci_set_drvdata(pdev, usdrdev);
         usdrdev->bar_addr = bar_addr;
         usdrdev->devno = usdr_no;
@@ -1630,6 +1681,8 @@ static int usdr_probe(struct pci_dev *pdev,
 failed_cdev:
         device_destroy(usdr_class, MKDEV(MAJOR(dev_first), MINOR(dev_first) + devices));
 failed_device:
+        free_page((unsigned long)usdrdev->evmap);
+err_free_dev:
         kfree(usdrdev);
 //err_allocdma:
         //usdr_freedma(usdrdev, usdrdev->rxdma, usdrdev->rxdma_bufsize);
@@ -1687,6 +1740,9 @@ static void usdr_remove(struct pci_dev *pdev)
         pci_iounmap(pdev, usdrdev->bar_addr);
 	pci_release_regions(pdev);
 
+        free_page((unsigned long)usdrdev->evmap);
+        usdrdev->evmap = NULL;
+
 	pci_clear_master(pdev);
 	pci_disable_device(pdev);
 	pci_set_drvdata(pdev, NULL);
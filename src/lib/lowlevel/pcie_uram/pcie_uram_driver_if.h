@@ -138,6 +138,21 @@ struct pcie_driver_woa_oob {
     void* oobdata;
 };
 
+// Event page, mapped read-only to userspace. Driver stores event data and
+// then increments sequence number of the event, so completion of short
+// SPI/I2C transactions can be polled without a syscall.
+#define PCIE_DRIVER_EVMAP_MAX 32
+
+struct pcie_driver_evmap {
+    uint32_t seq[PCIE_DRIVER_EVMAP_MAX];
+    uint32_t data[PCIE_DRIVER_EVMAP_MAX];
+};
+
+struct pcie_driver_evmap_conf {
+    off_t out_vma_off;    // Offset need to be passed to mmap() for event page
+    size_t out_vma_length;
+};
+
 // Driver functions
 
 #define PCIE_DRIVER_MAGIC          0xDD
@@ -173,4 +188,7 @@ struct pcie_driver_woa_oob {
 // Request specific deriver ABI version
 #define PCIE_DRIVER_CLAIM_VERSION     _IOW(PCIE_DRIVER_MAGIC, 23, uint32_t)
 
+// Get mmap() offset of the event page, older drivers don't support it
+#define PCIE_DRIVER_EVMAP_CONF        _IOR(PCIE_DRIVER_MAGIC, 24, struct pcie_driver_evmap_conf)
+
 #endif
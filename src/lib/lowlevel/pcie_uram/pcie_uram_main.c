@@ -15,6 +15,8 @@
 #include <stdio.h>
 #include <endian.h>
 #include <dirent.h>
+#include <time.h>
+#include <pthread.h>
 
 #include "../device/device.h"
 #include "../device/device_cores.h"
@@ -32,6 +34,27 @@
 // Since version 3:  check SPI/I2C core compatibility
 #define USDR_DRIVER_ABI_VERSION 3
 
+enum {
+    // Default time to spin on the event page before sleeping in the driver
+    LSOP_POLL_BUDGET_US = 50,
+    LSOP_TIMEOUT_MS = 1000,
+};
+
+enum lsop_path {
+    LSOP_SPI_POLLED,
+    LSOP_SPI_IRQ,
+    LSOP_I2C_POLLED,
+    LSOP_I2C_IRQ,
+    LSOP_PATH_COUNT,
+};
+
+struct lsop_latency {
+    uint64_t count;
+    uint64_t total_ns;
+    uint32_t last_ns;
+    uint32_t max_ns;
+};
+
 struct stream_cache_data {
     unsigned flags;
     unsigned bufavail;
@@ -61,6 +84,17 @@ struct pcie_uram_dev
     struct lowlevel_dev ll;
     uint32_t *mmaped_io;
 
+    // Polled SPI/I2C, available with mmaped IO and event page only
+    const struct pcie_driver_evmap* evmap;
+    unsigned poll_budget_ns;
+    unsigned spi_int_number[MAX_SPI_COUNT];
+    unsigned i2c_int_number[MAX_I2C_COUNT];
+    struct i2c_cache i2cc[4 * MAX_I2C_COUNT];
+    struct lsop_latency lsop_lat[LSOP_PATH_COUNT];
+
+    // SPI/I2C cores take one command at a time, both paths are serialized
+    pthread_mutex_t lsop_mtx;
+
     int fd;
 
     char name[128];
@@ -302,6 +336,175 @@ int pcie_spi_transact(pcie_uram_dev_t* dev, unsigned bus, unsigned in, unsigned
 }
 #endif
 
+static uint64_t pcie_host_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static unsigned pcie_lsop_latency(pcie_uram_dev_t* d, bool i2c, bool polled, uint64_t start)
+{
+    struct lsop_latency* l = &d->lsop_lat[(i2c ? LSOP_I2C_POLLED : LSOP_SPI_POLLED) + (polled ? 0 : 1)];
+    uint64_t ns = pcie_host_ns() - start;
+
+    l->count++;
+    l->total_ns += ns;
+    l->last_ns = (ns > UINT32_MAX) ? UINT32_MAX : ns;
+    if (l->last_ns > l->max_ns)
+        l->max_ns = l->last_ns;
+
+    return l->last_ns;
+}
+
+// Wait for the event sequence to move past @p seq: spin on the event page for
+// the poll budget, then sleep in the driver. Stale counts left in the driver
+// by earlier polled transactions only cause an extra loop.
+static int pcie_evmap_wait(pcie_uram_dev_t* d, unsigned irq, uint32_t seq, bool* polled)
+{
+    uint64_t start = pcie_host_ns();
+    int res;
+
+    do {
+        if (__atomic_load_n(&d->evmap->seq[irq], __ATOMIC_ACQUIRE) != seq) {
+            *polled = true;
+            return 0;
+        }
+    } while (pcie_host_ns() - start < d->poll_budget_ns);
+
+    *polled = false;
+    for (;;) {
+        res = ioctl(d->fd, PCIE_DRIVER_WAIT_SINGLE_EVENT, irq | (LSOP_TIMEOUT_MS << 8));
+        if (__atomic_load_n(&d->evmap->seq[irq], __ATOMIC_ACQUIRE) != seq)
+            return 0;
+        if (res < 0)
+            return -errno;
+    }
+}
+
+static int pcie_spi_polled(pcie_uram_dev_t* d, unsigned ls_op_addr, uint32_t spi_param,
+                           uint32_t* dout, bool* polled)
+{
+    unsigned busno = SPIEXT_LSOP_GET_BUS(ls_op_addr);
+    unsigned irq = d->spi_int_number[busno];
+    unsigned base = d->db.spi_base[busno];
+    uint32_t seq = __atomic_load_n(&d->evmap->seq[irq], __ATOMIC_ACQUIRE);
+    int res;
+
+    if (d->db.spi_core[busno] == SPI_CORE_32W) {
+        res = pcie_reg_op_iommap(d, base, NULL, 0, &spi_param, 4);
+    } else {
+        // Same DWORD order as 64-bit write in the driver, config goes first
+        uint32_t cmd[2] = { SPIEXT_LSOP_GET_CFG(ls_op_addr), spi_param };
+        res = pcie_reg_op_iommap(d, base - 1, NULL, 0, cmd, 8);
+    }
+    if (res)
+        return res;
+
+    res = pcie_evmap_wait(d, irq, seq, polled);
+    if (res)
+        return res;
+
+    *dout = d->evmap->data[irq];
+    return 0;
+}
+
+static int pcie_i2c_polled(pcie_uram_dev_t* d, unsigned ls_op_addr,
+                           unsigned wcnt, const uint8_t* wrb, unsigned rcnt, uint8_t* rdb,
+                           bool* polled)
+{
+    unsigned i2cinst = LSOP_I2C_INSTANCE(ls_op_addr);
+    unsigned irq, base, idx, dout;
+    uint32_t seq, cmd[2];
+    int res;
+
+    if (i2cinst >= d->db.i2c_count || d->db.i2c_core[i2cinst] != I2C_CORE_AUTO_LUTUPD)
+        return -EINVAL;
+
+    irq = d->i2c_int_number[i2cinst];
+    base = d->db.i2c_base[i2cinst];
+    seq = __atomic_load_n(&d->evmap->seq[irq], __ATOMIC_ACQUIRE);
+
+    // The driver doesn't cache LUT, so both sides keep own index state
+    idx = si2c_update_lut_idx(&d->i2cc[4 * i2cinst], LSOP_I2C_ADDR(ls_op_addr), LSOP_I2C_BUSNO(ls_op_addr));
+    cmd[0] = si2c_get_lut(&d->i2cc[4 * i2cinst]);
+    res = si2c_make_ctrl_reg(idx, wrb, wcnt, rcnt, &cmd[1]);
+    if (res)
+        return res;
+
+    res = pcie_reg_op_iommap(d, base - 1, NULL, 0, cmd, 8);
+    if (res)
+        return res;
+
+    // Write-only commands complete with an event too, wait for it so the
+    // next transaction can't take it for its own
+    res = pcie_evmap_wait(d, irq, seq, polled);
+    if (res)
+        return res;
+
+    dout = d->evmap->data[irq];
+    for (unsigned i = 0; i < rcnt; i++) {
+        rdb[i] = dout >> (8 * i);
+    }
+    return 0;
+}
+
+// Whole queue runs under a single lock. With the event map every command is
+// polled to completion; over ioctl the settle delay is needed only after
+// write-only commands since the driver waits for reads itself
+static int pcie_i2c_batch(pcie_uram_dev_t* d, unsigned count, const struct lowlevel_i2c_op* ops,
+                          size_t meminsz, uint8_t* pin)
+{
+    unsigned i, rdoff = 0;
+    bool settle = true, polled = false;
+    int res = 0;
+
+    for (i = 0; i < count; i++) {
+        if (ops[i].wrsz > LOWLEVEL_I2C_WR_MAX || ops[i].rdsz > LOWLEVEL_I2C_RD_MAX)
+            return -EINVAL;
+        rdoff += ops[i].rdsz;
+    }
+    if (rdoff > meminsz)
+        return -EINVAL;
+
+    rdoff = 0;
+    pthread_mutex_lock(&d->lsop_mtx);
+    for (i = 0; i < count; i++) {
+        const struct lowlevel_i2c_op* op = &ops[i];
+
+        if (d->evmap) {
+            res = pcie_i2c_polled(d, op->addr, op->wrsz, op->wr, op->rdsz, pin + rdoff, &polled);
+        } else {
+            struct pcie_driver_si2c ioi2c;
+            memset(&ioi2c, 0, sizeof(ioi2c));
+            ioi2c.addr = op->addr;
+            ioi2c.wcnt = op->wrsz;
+            ioi2c.rcnt = op->rdsz;
+            memcpy(ioi2c.wrb, op->wr, op->wrsz);
+
+            if (settle)
+                usleep(1000);
+
+            res = ioctl(d->fd, PCIE_DRIVER_SI2C_TRANSACT, &ioi2c);
+            if (res) {
+                res = -errno;
+            } else {
+                memcpy(pin + rdoff, ioi2c.rdb, op->rdsz);
+            }
+            settle = (op->rdsz == 0);
+        }
+        if (res)
+            break;
+
+        USDR_LOG("PCIE", USDR_LOG_NOTE, "I2C%d.%d.%d: Q%d W=%d R=%d\n",
+                 LSOP_I2C_INSTANCE(op->addr), LSOP_I2C_BUSNO(op->addr),
+                 LSOP_I2C_ADDR(op->addr), i, op->wrsz, op->rdsz);
+        rdoff += op->rdsz;
+    }
+    pthread_mutex_unlock(&d->lsop_mtx);
+    return res;
+}
+
 #define MAX_DUMP_BUFFER 256
 static char* _dump_buffer(size_t cnt, const void* pin)
 {
@@ -357,11 +560,22 @@ int pcie_uram_ls_op(lldev_t dev, subdev_t subdev,
         }
 
         struct pcie_driver_spi32 iospi = { ls_op_addr, spi_param };
-        res = ioctl(d->fd, PCIE_DRIVER_SPI32_TRANSACT, &iospi);
+        uint64_t start = pcie_host_ns();
+        bool polled = false;
+        pthread_mutex_lock(&d->lsop_mtx);
+        if (d->evmap) {
+            res = pcie_spi_polled(d, ls_op_addr, spi_param, &iospi.dw_io, &polled);
+        } else {
+            res = ioctl(d->fd, PCIE_DRIVER_SPI32_TRANSACT, &iospi);
+            if (res)
+                res = -errno;
+        }
+        pthread_mutex_unlock(&d->lsop_mtx);
         if (res)
-            return -errno;
+            return res;
 
-        USDR_LOG("PCIE", USDR_LOG_NOTE, "SPI%d: DW=%08x => %08x\n", SPIEXT_LSOP_GET_BUS(ls_op_addr), *(const uint32_t*)pout, iospi.dw_io);
+        USDR_LOG("PCIE", USDR_LOG_NOTE, "SPI%d: DW=%08x => %08x (%s %u ns)\n", SPIEXT_LSOP_GET_BUS(ls_op_addr), *(const uint32_t*)pout, iospi.dw_io,
+                 polled ? "polled" : "irq", pcie_lsop_latency(d, false, polled, start));
 
         if (meminsz) {
             if (pdb->spi_core[SPIEXT_LSOP_GET_BUS(ls_op_addr)] == SPI_CORE_32W) {
@@ -390,25 +604,43 @@ int pcie_uram_ls_op(lldev_t dev, subdev_t subdev,
             ioi2c.rdb_p = pin;
         }
 
-        usleep(1000);
-
         USDR_LOG("PCIE", USDR_LOG_NOTE, "I2C%d.%d.%d: W=%d R=%d OUT=%s\n",
                  LSOP_I2C_INSTANCE(ls_op_addr), LSOP_I2C_BUSNO(ls_op_addr),
                  LSOP_I2C_ADDR(ls_op_addr), ioi2c.wcnt, ioi2c.rcnt, _dump_buffer(memoutsz, pout));
 
-        res = ioctl(d->fd, PCIE_DRIVER_SI2C_TRANSACT, &ioi2c);
+        uint64_t start = pcie_host_ns();
+        bool polled = false;
+        pthread_mutex_lock(&d->lsop_mtx);
+        if (d->evmap && memoutsz <= sizeof(ioi2c.wrb) && meminsz <= 4) {
+            res = pcie_i2c_polled(d, ls_op_addr, memoutsz, ioi2c.wrb, meminsz, ioi2c.rdb, &polled);
+        } else {
+            // The driver doesn't wait for write-only commands, give the previous one time to finish
+            usleep(1000);
+            res = ioctl(d->fd, PCIE_DRIVER_SI2C_TRANSACT, &ioi2c);
+            if (res)
+                res = -errno;
+        }
+        pthread_mutex_unlock(&d->lsop_mtx);
         if (res)
-            return -errno;
+            return res;
 
         if (meminsz <= sizeof(ioi2c.rdb)) {
             memcpy(pin, ioi2c.rdb, meminsz);
         }
-        USDR_LOG("PCIE", USDR_LOG_NOTE, "I2C%d.%d.%d:         => %s\n",
+        USDR_LOG("PCIE", USDR_LOG_NOTE, "I2C%d.%d.%d:         => %s (%s %u ns)\n",
                  LSOP_I2C_INSTANCE(ls_op_addr), LSOP_I2C_BUSNO(ls_op_addr),
-                 LSOP_I2C_ADDR(ls_op_addr), _dump_buffer(meminsz, pin));
+                 LSOP_I2C_ADDR(ls_op_addr), _dump_buffer(meminsz, pin),
+                 polled ? "polled" : "irq", pcie_lsop_latency(d, true, polled, start));
 
         return 0;
     }
+    case USDR_LSOP_I2C_BATCH: {
+        if (memoutsz != ls_op_addr * sizeof(struct lowlevel_i2c_op))
+            return -EINVAL;
+
+        // Per-transaction latency stats are left to the single op path
+        return pcie_i2c_batch(d, ls_op_addr, (const struct lowlevel_i2c_op*)pout, meminsz, (uint8_t*)pin);
+    }
     case USDR_LSOP_DRP: {
         return device_bus_drp_generic_op(dev, subdev, &d->db, ls_op_addr, meminsz, pin, memoutsz, pout);
     }
@@ -705,7 +937,22 @@ int pcie_uram_destroy(lldev_t dev)
         dev->pdev->destroy(dev->pdev);
     }
 
+    for (unsigned p = 0; p < LSOP_PATH_COUNT; p++) {
+        static const char* s_path[] = { "SPI polled", "SPI irq", "I2C polled", "I2C irq" };
+        const struct lsop_latency* l = &d->lsop_lat[p];
+        if (l->count == 0)
+            continue;
+
+        USDR_LOG("PCIE", USDR_LOG_INFO, "%s: %s %llu transactions, avg %llu ns, max %u ns\n",
+                 d->name, s_path[p], (unsigned long long)l->count,
+                 (unsigned long long)(l->total_ns / l->count), l->max_ns);
+    }
+
     //
+    if (d->evmap) {
+        munmap((void*)d->evmap, 4096);
+        d->evmap = NULL;
+    }
     if (d->mmaped_io) {
         munmap(d->mmaped_io, 4096);
         d->mmaped_io = NULL;
@@ -717,6 +964,7 @@ int pcie_uram_destroy(lldev_t dev)
 
     USDR_LOG("PCIE", USDR_LOG_INFO, "Device %s destroyed!\n", d->name);
 
+    pthread_mutex_destroy(&d->lsop_mtx);
     free(d);
     return 0;
 }
@@ -867,6 +1115,7 @@ int pcie_uram_plugin_create(unsigned pcount, const char** devparam, const char**
     int fd, err;
     bool mmapedio = true;
     unsigned iospacesz = 4096;
+    unsigned lspoll_us = LSOP_POLL_BUDGET_US;
     char devname[128];
     snprintf(devname, sizeof(devname), "/dev/%s", pf.dev);
 
@@ -876,6 +1125,11 @@ int pcie_uram_plugin_create(unsigned pcount, const char** devparam, const char**
 
             USDR_LOG("PCIE", USDR_LOG_INFO, "mmaped IO is %s\n",
                      mmapedio ? "enabled" : "disabled");
+        } else if (strcmp(devparam[k], "lspoll") == 0) {
+            // Spin budget for SPI/I2C completion in us, 0 - always use driver
+            lspoll_us = strtoul(devval[k], NULL, 10);
+
+            USDR_LOG("PCIE", USDR_LOG_INFO, "SPI/I2C poll budget %u us\n", lspoll_us);
         }
     }
 
@@ -908,6 +1162,7 @@ int pcie_uram_plugin_create(unsigned pcount, const char** devparam, const char**
         err = ENOMEM; goto close_fd;
     }
     memset(dev, 0, sizeof(*dev));
+    pthread_mutex_init(&dev->lsop_mtx, NULL);
 
     dev->ll.ops = &s_pcie_uram_ops;
     dev->fd = fd;
@@ -1046,6 +1301,25 @@ int pcie_uram_plugin_create(unsigned pcount, const char** devparam, const char**
         }
     }
 
+    // Polled SPI/I2C needs direct register access and the driver event page
+    if (dev->mmaped_io && lspoll_us) {
+        struct pcie_driver_evmap_conf ec;
+        void* evmap = MAP_FAILED;
+
+        if (ioctl(dev->fd, PCIE_DRIVER_EVMAP_CONF, &ec) == 0) {
+            evmap = mmap(NULL, ec.out_vma_length, PROT_READ, MAP_SHARED, dev->fd, ec.out_vma_off);
+        }
+        if (evmap == MAP_FAILED) {
+            USDR_LOG("PCIE", USDR_LOG_WARNING, "Driver event page isn't available, SPI/I2C use ioctl(), error: %d\n",
+                     errno);
+        } else {
+            dev->evmap = (const struct pcie_driver_evmap*)evmap;
+            dev->poll_budget_ns = lspoll_us * 1000;
+            memcpy(dev->spi_int_number, dl.spi_int_number, sizeof(dev->spi_int_number));
+            memcpy(dev->i2c_int_number, dl.i2c_int_number, sizeof(dev->i2c_int_number));
+        }
+    }
+
 
     // Set NTFY routing to PCIe ???????
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1063,10 +1337,14 @@ int pcie_uram_plugin_create(unsigned pcount, const char** devparam, const char**
     return 0;
 
 clear_map:
+    if (dev->evmap) {
+        munmap((void*)dev->evmap, 4096);
+    }
     if (dev->mmaped_io) {
         munmap(dev->mmaped_io, iospacesz);
     }
 remove_dev:
+    pthread_mutex_destroy(&dev->lsop_mtx);
     free(dev);
 close_fd:
     close(fd);
@@ -144,6 +144,106 @@ int usb_uram_reg_op(lldev_t dev, unsigned ls_op_addr,
     return 0;
 }
 
+// Batching relies on the I2C core accepting a new command while the previous
+// one is still on the bus, the same way the single op path posts write-only
+// commands without waiting for them. Inside a packet commands arrive back to
+// back, so the packet is capped to keep within the core command queue, and
+// a read always ends the packet since its result register is not queued.
+// Only I2C_CORE_AUTO_LUTUPD cores are batched, anything else is rejected.
+enum {
+    USB_URAM_I2C_BATCH_MAX = 16,
+};
+
+static int usb_uram_i2c_batch(lldev_t dev, unsigned count, const struct lowlevel_i2c_op* ops,
+                              size_t meminsz, uint8_t* pin)
+{
+    usb_uram_generic_t* gen = get_uram_generic(dev);
+    device_bus_t* pdb = &gen->db;
+    uint32_t recs[USB_URAM_RAW_MAX_DW];
+    uint32_t lut = 0;
+    unsigned i, dw = 0, queued = 0, inst = 0, rdoff = 0;
+    int res;
+
+    if (gen->io_ops.io_write_raw_fn == NULL)
+        return -EOPNOTSUPP;
+
+    for (i = 0; i < count; i++) {
+        const struct lowlevel_i2c_op* op = &ops[i];
+        uint8_t instance_no = LSOP_I2C_INSTANCE(op->addr);
+        uint8_t bus_no = LSOP_I2C_BUSNO(op->addr);
+        uint8_t i2caddr = LSOP_I2C_ADDR(op->addr);
+        struct i2c_cache* pi2cc;
+        uint32_t nlut, cmd;
+        unsigned lidx;
+
+        if (instance_no >= pdb->i2c_count)
+            return -EINVAL;
+        if (pdb->i2c_core[instance_no] != I2C_CORE_AUTO_LUTUPD)
+            return -EINVAL;
+        if (bus_no > 1)
+            return -EINVAL;
+        if (rdoff + op->rdsz > meminsz)
+            return -EINVAL;
+
+        pi2cc = &gen->i2cc[4 * instance_no];
+        lidx = si2c_update_lut_idx(pi2cc, i2caddr, bus_no);
+        nlut = si2c_get_lut(pi2cc);
+        res = si2c_make_ctrl_reg(lidx, op->wr, op->wrsz, op->rdsz, &cmd);
+        if (res)
+            return res;
+
+        // LUT is updated only ahead of the first command in the packet
+        if (queued && (inst != instance_no || lut != nlut ||
+                       queued == USB_URAM_I2C_BATCH_MAX || dw + 3 > USB_URAM_RAW_MAX_DW)) {
+            res = gen->io_ops.io_write_raw_fn(dev, recs, dw, USB_IO_TIMEOUT);
+            if (res)
+                return res;
+
+            dw = queued = 0;
+        }
+
+        if (queued == 0) {
+            recs[dw++] = USB_URAM_WR_HDR(pdb->i2c_base[instance_no] - 1, 2);
+            recs[dw++] = nlut;
+        } else {
+            recs[dw++] = USB_URAM_WR_HDR(pdb->i2c_base[instance_no], 1);
+        }
+        recs[dw++] = cmd;
+        queued++;
+        inst = instance_no;
+        lut = nlut;
+
+        USDR_LOG(USBG_LOG_TAG, USDR_LOG_DEBUG, "%s: I2C[%d.%d.%02x] Q%d LUT:CMD %08x.%08x\n",
+                 lowlevel_get_devname(dev), instance_no, bus_no, i2caddr, queued, nlut, cmd);
+
+        if (op->rdsz == 0 && i != count - 1)
+            continue;
+
+        res = gen->io_ops.io_write_raw_fn(dev, recs, dw, USB_IO_TIMEOUT);
+        if (res)
+            return res;
+
+        dw = queued = 0;
+
+        if (op->rdsz > 0) {
+            uint32_t data = 0;
+            unsigned j;
+
+            // Read completes after every command ahead of it
+            res = usb_uram_read_wait(dev, USDR_LSOP_I2C_DEV, instance_no, op->rdsz, &data);
+            if (res)
+                return res;
+
+            for (j = 0; j < op->rdsz; j++)
+                pin[rdoff + j] = data >> (8 * j);
+
+            rdoff += op->rdsz;
+        }
+    }
+
+    return 0;
+}
+
 int usb_uram_ls_op(lldev_t dev, subdev_t subdev,
                    unsigned ls_op, lsopaddr_t ls_op_addr,
                    size_t meminsz, void* pin,
@@ -242,6 +342,13 @@ int usb_uram_ls_op(lldev_t dev, subdev_t subdev,
         }
         return 0;
     }
+    case USDR_LSOP_I2C_BATCH: {
+        if (memoutsz != ls_op_addr * sizeof(struct lowlevel_i2c_op))
+            return -EINVAL;
+
+        return usb_uram_i2c_batch(dev, ls_op_addr, (const struct lowlevel_i2c_op*)pout,
+                                  meminsz, (uint8_t*)pin);
+    }
     case USDR_LSOP_DRP: {
         return device_bus_drp_generic_op(dev, subdev, pdb, ls_op_addr, meminsz, pin, memoutsz, pout);
     }
@@ -33,15 +33,24 @@ enum {
 
 #define USB_IO_TIMEOUT 20000
 
+#define USB_URAM_WR_HDR(addr, dwcnt)  (((((dwcnt) - 1) & 0x3f) << 16) | ((addr) & 0xffff))
+
+enum {
+    USB_URAM_RAW_MAX_DW = 64,
+};
+
 typedef int (*io_read_fn_t)(lldev_t d, unsigned addr, uint32_t *data, unsigned dwcnt, UNUSED int timeout);
 typedef int (*io_write_fn_t)(lldev_t d, unsigned addr, const uint32_t* data, unsigned dwcnt, UNUSED int timeout);
 typedef int (*io_read_bus_fn_t)(lldev_t dev, unsigned interrupt_number, unsigned reg, size_t meminsz, void* pin);
+// Several pre-formatted write records (USB_URAM_WR_HDR + data) in one transfer
+typedef int (*io_write_raw_fn_t)(lldev_t d, const uint32_t* recs, unsigned dwcnt, UNUSED int timeout);
 
 struct usb_uram_io_ops
 {
     io_read_fn_t io_read_fn;
     io_write_fn_t io_write_fn;
     io_read_bus_fn_t io_read_bus_fn;
+    io_write_raw_fn_t io_write_raw_fn;
 };
 typedef struct usb_uram_io_ops usb_uram_io_ops_t;
 
@@ -380,12 +380,24 @@ static int usb_async_regwrite32(lldev_t d, unsigned addr, const uint32_t* data,
     if (sizedw > 0x40 || sizedw == 0)
         return -EINVAL;
 
-    odata[0] = (((sizedw - 1) & 0x3f) << 16) | (addr & 0xffff);
+    odata[0] = USB_URAM_WR_HDR(addr, sizedw);
     memcpy(&odata[1], data, sizedw * 4);
 
     return usb_post_regout(dev, odata, sizedw + 1, timeout);
 }
 
+static int usb_async_regwrite_raw(lldev_t d, const uint32_t* recs, unsigned dwcnt, int timeout)
+{
+    usb_dev_t* dev = (usb_dev_t*)d;
+    uint32_t odata[OUT_REGOUT_SIZE/4];
+
+    if (dwcnt > OUT_REGOUT_SIZE / 4 || dwcnt == 0)
+        return -EINVAL;
+
+    memcpy(odata, recs, dwcnt * 4);
+    return usb_post_regout(dev, odata, dwcnt, timeout);
+}
+
 static int usb_async_regread32(lldev_t d, unsigned addr, uint32_t* data, unsigned sizedw, int timeout)
 {
     usb_dev_t* dev = (usb_dev_t*)d;
@@ -869,7 +881,8 @@ const static
 usb_uram_io_ops_t s_io_ops = {
     usb_async_regread32,
     usb_async_regwrite32,
-    usb_read_bus
+    usb_read_bus,
+    usb_async_regwrite_raw,
 };
 
 static
@@ -87,7 +87,7 @@ static
     if (dwcnt == 0 || dwcnt >= 64)
         return -EINVAL;
 
-    pkt[0] = (((dwcnt - 1) & 0x3f) << 16) | (addr & 0xffff);
+    pkt[0] = USB_URAM_WR_HDR(addr, dwcnt);
     memcpy(&pkt[1], data, dwcnt * 4);
 
     res = dev->base.ops->write_raw_ep(dev->base.param,
@@ -102,6 +102,29 @@ static
     return 0;
 }
 
+static
+    int libusb_websdr_io_write_raw(lldev_t d, const uint32_t* recs, unsigned dwcnt, UNUSED int timeout)
+{
+    struct webusb_device_uram* dev = (struct webusb_device_uram*)d;
+    uint32_t pkt[USB_URAM_RAW_MAX_DW];
+    int res;
+
+    if (dwcnt == 0 || dwcnt > USB_URAM_RAW_MAX_DW)
+        return -EINVAL;
+
+    memcpy(pkt, recs, dwcnt * 4);
+    res = dev->base.ops->write_raw_ep(dev->base.param,
+                                      EP_CSR_OUT | 0x00,
+                                      dwcnt * 4,
+                                      (unsigned char*)&pkt);
+    if (res < 0)
+        return res;
+    if (res != dwcnt * 4)
+        return -EIO;
+
+    return 0;
+}
+
 static
     int libusb_websdr_io_read(lldev_t d, unsigned addr, uint32_t *data, unsigned dwcnt, UNUSED int timeout)
 {
@@ -202,7 +225,8 @@ static
 static struct usb_uram_io_ops s_io_ops = {
     libusb_websdr_io_read,
     libusb_websdr_io_write,
-    libusb_websdr_read_bus
+    libusb_websdr_read_bus,
+    libusb_websdr_io_write_raw,
 };
 
 static
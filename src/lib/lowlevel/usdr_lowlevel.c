@@ -34,6 +34,34 @@ const uint8_t* lowlevel_get_uuid(lldev_t dev)
 }
 
 
+int lowlevel_i2c_q_exec(lldev_t dev, subdev_t subdev, struct lowlevel_i2c_queue* q)
+{
+    unsigned i, off = 0;
+    int res;
+
+    if (q->count == 0)
+        return 0;
+
+    res = lowlevel_ls_op(dev, subdev, USDR_LSOP_I2C_BATCH, q->count,
+                         q->rdsz, q->rd, q->count * sizeof(q->ops[0]), q->ops);
+    if (res != -EOPNOTSUPP)
+        return res;
+
+    for (i = 0; i < q->count; i++) {
+        const struct lowlevel_i2c_op* op = &q->ops[i];
+        uint32_t data = 0;
+
+        res = lowlevel_ls_op(dev, subdev, USDR_LSOP_I2C_DEV, op->addr,
+                             op->rdsz, op->rdsz ? &data : NULL, op->wrsz, op->wr);
+        if (res)
+            return res;
+
+        memcpy(q->rd + off, &data, op->rdsz);
+        off += op->rdsz;
+    }
+    return 0;
+}
+
 int lowlevel_info(UNUSED const char* driver,
                   UNUSED unsigned iparam,
                   UNUSED size_t osz,
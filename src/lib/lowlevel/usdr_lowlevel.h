@@ -6,6 +6,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <errno.h>
 #include <usdr_port.h>
 
 #define USBG_LOG_TAG "USBG"
@@ -16,6 +17,7 @@ enum lowlevel_ls_ops {
     USDR_LSOP_I2C_DEV = 2, // Address format [8 bit instance_no][8 bit bus_no][16 bit i2c_address]
     USDR_LSOP_URAM = 3,  // Read followed by write
     USDR_LSOP_DRP = 4, // Xilinx DRP port
+    USDR_LSOP_I2C_BATCH = 5, // Array of struct lowlevel_i2c_op, ls_op_addr is number of ops, read data packed to pin
 
     USDR_LSOP_CUSTOM_CMD = 65536, //Custom commands
 };
@@ -50,6 +52,30 @@ typedef unsigned stream_t;
 
 typedef struct device device_t;
 
+enum {
+    LOWLEVEL_I2C_WR_MAX = 3,
+    LOWLEVEL_I2C_RD_MAX = 4,
+    LOWLEVEL_I2C_QUEUE_MAX = 32,
+};
+
+struct lowlevel_i2c_op {
+    lsopaddr_t addr;  // MAKE_LSOP_I2C_ADDR()
+    uint8_t wrsz;
+    uint8_t rdsz;
+    uint8_t wr[LOWLEVEL_I2C_WR_MAX];
+};
+
+// Transactions are executed in order, read results are packed one after
+// another into rd[]. Write-only transactions may be posted without waiting
+// for the previous one to finish, backends returning -EOPNOTSUPP for
+// USDR_LSOP_I2C_BATCH are driven one USDR_LSOP_I2C_DEV at a time.
+struct lowlevel_i2c_queue {
+    unsigned count;
+    unsigned rdsz;
+    struct lowlevel_i2c_op ops[LOWLEVEL_I2C_QUEUE_MAX];
+    uint8_t rd[LOWLEVEL_I2C_QUEUE_MAX * LOWLEVEL_I2C_RD_MAX];
+};
+
 enum lowlevel_generic_ops {
     LLGO_DEVICE_NAME,
     LLGO_DEVICE_UUID,
@@ -178,6 +204,37 @@ static inline int lowlevel_drp_rd16(lldev_t dev, subdev_t subdev, unsigned port,
                                         2, pout, 0, NULL);
 }
 
+static inline void lowlevel_i2c_q_init(struct lowlevel_i2c_queue* q) {
+    q->count = 0;
+    q->rdsz = 0;
+}
+
+// Returns offset of the read data in q->rd on success
+static inline int lowlevel_i2c_q_add(struct lowlevel_i2c_queue* q, lsopaddr_t ls_op_addr,
+                                     unsigned wrsz, const uint8_t* wr, unsigned rdsz) {
+    struct lowlevel_i2c_op* op = &q->ops[q->count];
+    unsigned i, off = q->rdsz;
+
+    if (q->count >= LOWLEVEL_I2C_QUEUE_MAX)
+        return -EOVERFLOW;
+    if (wrsz > LOWLEVEL_I2C_WR_MAX || rdsz > LOWLEVEL_I2C_RD_MAX)
+        return -EINVAL;
+
+    op->addr = ls_op_addr;
+    op->wrsz = wrsz;
+    op->rdsz = rdsz;
+    for (i = 0; i < wrsz; i++)
+        op->wr[i] = wr[i];
+
+    q->count++;
+    q->rdsz += rdsz;
+    return off;
+}
+
+// Execute all queued transactions, backends without USDR_LSOP_I2C_BATCH
+// support are served one transaction at a time
+int lowlevel_i2c_q_exec(lldev_t dev, subdev_t subdev, struct lowlevel_i2c_queue* q);
+
 static inline int lowlevel_destroy(lldev_t dev) {
     return lowlevel_get_ops(dev)->destroy(dev);
 }
@@ -7,6 +7,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <poll.h>
 
 
 static
@@ -66,6 +67,18 @@ int vll_chan_recv_sync(struct vll_chan* vc, uint8_t* data, unsigned max_size)
     return res;
 }
 
+int vll_chan_wait(struct vll_chan* vc, unsigned timeout_ms)
+{
+    struct pollfd pfd = { vc->fd, POLLIN, 0 };
+    int res;
+
+    res = poll(&pfd, 1, timeout_ms);
+    if (res < 0)
+        return -errno;
+
+    return (res == 0) ? -ETIMEDOUT : 0;
+}
+
 int vll_chan_close(struct vll_chan* vc)
 {
     close(vc->fd);
@@ -129,3 +142,97 @@ int vll_mem_close(struct vll_mem* mm)
     return 0;
 }
 
+
+int vll_ring_init(struct vll_ring* r, void* mem, size_t memsz)
+{
+    struct vll_ring_hdr* h = (struct vll_ring_hdr*)mem;
+    uint32_t dwcnt;
+
+    if (memsz < sizeof(*h) + 4)
+        return -EINVAL;
+
+    for (dwcnt = 1; 2 * dwcnt <= (memsz - sizeof(*h)) / 4; dwcnt <<= 1);
+
+    memset(h, 0, sizeof(*h));
+    h->size = dwcnt;
+    __atomic_store_n(&h->magic, VLL_RING_MAGIC, __ATOMIC_RELEASE);
+
+    return vll_ring_attach(r, mem, memsz);
+}
+
+int vll_ring_attach(struct vll_ring* r, void* mem, size_t memsz)
+{
+    struct vll_ring_hdr* h = (struct vll_ring_hdr*)mem;
+    uint32_t dwcnt;
+
+    if (__atomic_load_n(&h->magic, __ATOMIC_ACQUIRE) != VLL_RING_MAGIC)
+        return -ENODEV;
+
+    dwcnt = h->size;
+    if (dwcnt == 0 || (dwcnt & (dwcnt - 1)) || sizeof(*h) + 4 * (size_t)dwcnt > memsz)
+        return -EINVAL;
+
+    r->hdr = h;
+    r->data = (uint32_t*)(h + 1);
+    r->mask = dwcnt - 1;
+    r->wr = h->wr;
+    return 0;
+}
+
+int vll_ring_put(struct vll_ring* r, const uint32_t* data, unsigned dwcnt)
+{
+    uint32_t rd = __atomic_load_n(&r->hdr->rd, __ATOMIC_ACQUIRE);
+    if (r->wr - rd + dwcnt > r->mask + 1)
+        return -EAGAIN;
+
+    for (unsigned i = 0; i < dwcnt; i++) {
+        r->data[(r->wr + i) & r->mask] = data[i];
+    }
+    r->wr += dwcnt;
+    return 0;
+}
+
+bool vll_ring_flush(struct vll_ring* r)
+{
+    if (r->hdr->wr == r->wr)
+        return false;
+
+    __atomic_store_n(&r->hdr->wr, r->wr, __ATOMIC_RELEASE);
+
+    // Pairs with the fence in vll_ring_sleep(), either consumer sees new wr or we see the flag
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&r->hdr->need_wakeup, __ATOMIC_RELAXED) == 0)
+        return false;
+
+    return __atomic_exchange_n(&r->hdr->need_wakeup, 0, __ATOMIC_ACQ_REL) != 0;
+}
+
+unsigned vll_ring_avail(struct vll_ring* r)
+{
+    return __atomic_load_n(&r->hdr->wr, __ATOMIC_ACQUIRE) - r->hdr->rd;
+}
+
+void vll_ring_peek(struct vll_ring* r, unsigned off, uint32_t* data, unsigned dwcnt)
+{
+    uint32_t rd = r->hdr->rd + off;
+    for (unsigned i = 0; i < dwcnt; i++) {
+        data[i] = r->data[(rd + i) & r->mask];
+    }
+}
+
+void vll_ring_consume(struct vll_ring* r, unsigned dwcnt)
+{
+    __atomic_store_n(&r->hdr->rd, r->hdr->rd + dwcnt, __ATOMIC_RELEASE);
+}
+
+bool vll_ring_sleep(struct vll_ring* r)
+{
+    __atomic_store_n(&r->hdr->need_wakeup, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    if (vll_ring_avail(r) == 0)
+        return true;
+
+    __atomic_store_n(&r->hdr->need_wakeup, 0, __ATOMIC_RELAXED);
+    return false;
+}
@@ -32,6 +32,8 @@ int vll_chan_connect(struct vll_chan* vc, const char* dev);
 // Return number of bytes sent
 int vll_chan_send_sync(struct vll_chan* vc, const uint8_t* data, unsigned size);
 int vll_chan_recv_sync(struct vll_chan* vc, uint8_t* data, unsigned max_size);
+// Wait for incoming data, -ETIMEDOUT if nothing arrived
+int vll_chan_wait(struct vll_chan* vc, unsigned timeout_ms);
 
 int vll_chan_close(struct vll_chan* vc);
 
@@ -50,6 +52,52 @@ int vll_mem_protect(struct vll_mem* mm, uint32_t addr, uint32_t sz, int flags);
 
 int vll_mem_close(struct vll_mem* mm);
 
+
+// Single producer / single consumer ring of 32-bit words placed in vll_mem,
+// wr/rd are free running dword counters, data area is a power of two
+enum {
+    VLL_RING_MAGIC = 0x564c5252, // VLRR
+};
+
+struct vll_ring_hdr {
+    uint32_t magic;
+    uint32_t size;          // Data area size in dwords
+    uint32_t _pad0[14];
+
+    uint32_t wr;            // Updated by producer only
+    uint32_t _pad1[15];
+
+    uint32_t rd;            // Updated by consumer only
+    uint32_t need_wakeup;   // Set by consumer before going to sleep
+    uint32_t _pad2[14];
+};
+
+struct vll_ring {
+    struct vll_ring_hdr* hdr;
+    uint32_t* data;
+    uint32_t mask;
+    uint32_t wr;            // Producer local (not yet published) write pointer
+};
+
+// Format ring in the memory of memsz bytes
+int vll_ring_init(struct vll_ring* r, void* mem, size_t memsz);
+// Attach to the ring formatted by the other side
+int vll_ring_attach(struct vll_ring* r, void* mem, size_t memsz);
+
+// Producer: copy dwcnt words to the ring without publishing them, -EAGAIN when there's no room
+int vll_ring_put(struct vll_ring* r, const uint32_t* data, unsigned dwcnt);
+// Producer: publish all put data, returns true if consumer has to be woken up
+bool vll_ring_flush(struct vll_ring* r);
+
+// Consumer: number of dwords available
+unsigned vll_ring_avail(struct vll_ring* r);
+// Consumer: copy dwcnt words at offset off from the read pointer
+void vll_ring_peek(struct vll_ring* r, unsigned off, uint32_t* data, unsigned dwcnt);
+// Consumer: release dwcnt words
+void vll_ring_consume(struct vll_ring* r, unsigned dwcnt);
+// Consumer: announce going to sleep, returns false if data arrived meanwhile
+bool vll_ring_sleep(struct vll_ring* r);
+
 #ifdef __cplusplus
 }
 #endif
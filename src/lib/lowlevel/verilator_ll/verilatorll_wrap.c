@@ -40,7 +40,11 @@ enum {
 
     MAX_PACKET_SZ = 256,
 
-    MMAP_SIZE = 0x100000000ul
+    MMAP_SIZE = 0x100000000ul,
+
+    RING_REGION_SZ = 0x11000,
+    RING_RETRY_US = 10,
+    RING_SETUP_TIMEOUT_MS = 1000,
 };
 
 struct rbdata {
@@ -58,6 +62,11 @@ struct verilator_protocol_unix {
     struct vll_chan vch;
     struct vll_mem  vchm;
 
+    // Shared memory transport, mtx protects producer side of h2d
+    bool ring_en;
+    struct vll_ring h2d;
+    struct vll_ring d2h;
+
     struct rbdata rb[MAX_TAGS];
 };
 
@@ -67,17 +76,18 @@ int vpu_init(verilator_protocol_unix_t* pvpu, const char* dev)
 {
     int res;
 
-    for (unsigned i = 0; i < MAX_INTERRUPTS; i++) {
+    for (unsigned i = 0; i < MAX_TAGS; i++) {
         res = sem_init(&pvpu->tags[i], 0, 0);
         if (res)
             goto sem_tag_fail;
     }
 
-    res = sem_init(&pvpu->tags_avail, 0, 1);
+    res = sem_init(&pvpu->tags_avail, 0, MAX_TAGS);
     if (res)
         goto sem_tag_avail_fail;
 
-    pvpu->tags_free_idx =0;
+    pvpu->tags_free_idx = 0;
+    pvpu->ring_en = false;
     res = pthread_mutex_init(&pvpu->mtx, NULL);
     if (res)
         goto mtx_failed;
@@ -155,6 +165,7 @@ enum {
     PHYS_NTFY_BASE   = 0xfee00000,
     PHYS_RX_DMA_ST_0 = 0x10000000,
     PHYS_RX_DMA_OFF  = 0x01000000,
+    PHYS_RING_BASE   = 0xfef00000,
 };
 
 static int verilator_wrap_reg_out(verilator_dev_t* dev, unsigned reg,
@@ -163,19 +174,17 @@ static int verilator_wrap_reg_in(verilator_dev_t* dev, unsigned reg,
                                uint32_t *pinval);
 #define NEW_EVNT_ABI
 
-int verilator_process_recv(verilator_dev_t* dev)
+static int verilator_flush(verilator_dev_t* dev);
+
+static
+int verilator_process_pkt(verilator_dev_t* dev, const struct pheader* ph, const uint32_t* buffer)
 {
-    uint32_t buffer[64];
     int res;
-    struct pheader hdr;
-
-    res = vpu_recv_pkt(&dev->proto.vch, &hdr, buffer, SIZEOF_ARRAY(buffer));
-    if (res)
-        return res;
+    struct pheader hdr = *ph;
 
     switch (hdr.type) {
     case VPT_MEMORY_READ_CPLD_LAST:
-        if (hdr.tag > MAX_TAGS)
+        if (hdr.tag >= MAX_TAGS)
             return -EFAULT;
 
         if (hdr.size >= 12)
@@ -191,7 +200,7 @@ int verilator_process_recv(verilator_dev_t* dev)
         break;
 
     case VPT_INTERRUPT_NOTIFICATON:
-        if (hdr.tag > MAX_INTERRUPTS)
+        if (hdr.tag >= MAX_INTERRUPTS)
             return -EFAULT;
         USDR_LOG("VERI", USDR_LOG_TRACE, "Interrupt %d\n", hdr.tag);
 #ifdef OLD_INTERRUPTS
@@ -279,6 +288,7 @@ int verilator_process_recv(verilator_dev_t* dev)
         if (do_cnf != ~0u) {
             //Send confirmation pointer
             verilator_wrap_reg_out(dev, 9, (0 << 16) | do_cnf);
+            verilator_flush(dev);
         }
 
 #if 0
@@ -331,6 +341,13 @@ int verilator_process_recv(verilator_dev_t* dev)
 
 #endif
         break;
+    case VPT_RING_DOORBELL:
+        // Just a wakeup, data is in the ring
+        break;
+    case VPT_RING_SETUP:
+        // Answer after verilator_ring_setup() gave up, socket stays in use
+        USDR_LOG("VERI", USDR_LOG_WARNING, "Late ring setup answer %d ignored\n", ph->tag);
+        break;
     default:
         return -EFAULT;
     }
@@ -338,30 +355,182 @@ int verilator_process_recv(verilator_dev_t* dev)
     return 0;
 }
 
-static
-int verilator_tag_alloc(verilator_protocol_unix_t* dev)
+int verilator_process_recv(verilator_dev_t* dev)
 {
-    int res, tag = -1;
-    res = sem_wait(&dev->tags_avail);
+    uint32_t buffer[64];
+    int res;
+    struct pheader hdr;
+
+    res = vpu_recv_pkt(&dev->proto.vch, &hdr, buffer, SIZEOF_ARRAY(buffer));
     if (res)
         return res;
 
+    return verilator_process_pkt(dev, &hdr, buffer);
+}
 
-    for (unsigned i = 0; i < 32; i++) {
-        if (~dev->tags_free_idx & (1u << i)) {
-            //TODO atomic or
-            tag = i;
-            break;
+// Returns number of processed packets
+static
+int verilator_process_ring(verilator_dev_t* dev)
+{
+    uint32_t buffer[64];
+    int res, cnt = 0;
+    struct pheader hdr;
+
+    while ((res = vpu_ring_recv_pkt(&dev->proto.d2h, &hdr, buffer, SIZEOF_ARRAY(buffer))) != 0) {
+        if (res < 0) {
+            // Already dropped from the ring, keep going with the rest
+            USDR_LOG("VERI", USDR_LOG_ERROR, "Malformed packet in ring dropped, error %d\n", res);
+            continue;
         }
+
+        res = verilator_process_pkt(dev, &hdr, buffer);
+        if (res)
+            return res;
+
+        cnt++;
     }
 
-    return tag;
+    return cnt;
+}
+
+// Posted write, in ring mode it's delivered on the next verilator_flush()
+static
+int verilator_out(verilator_dev_t* dev, unsigned addr, const uint32_t *pdw, const unsigned dwcnt)
+{
+    int res;
+    bool wake;
+
+    if (!dev->proto.ring_en)
+        return vpu_send_memwr32(&dev->proto.vch, addr, pdw, dwcnt);
+
+    for (;;) {
+        pthread_mutex_lock(&dev->proto.mtx);
+        res = vpu_ring_send_memwr32(&dev->proto.h2d, addr, pdw, dwcnt);
+        wake = (res == -EAGAIN) ? vll_ring_flush(&dev->proto.h2d) : false;
+        pthread_mutex_unlock(&dev->proto.mtx);
+
+        if (res != -EAGAIN)
+            return res;
+
+        if (wake) {
+            res = vpu_send_doorbell(&dev->proto.vch);
+            if (res)
+                return res;
+        }
+        usleep(RING_RETRY_US);
+    }
+}
+
+static
+int verilator_flush(verilator_dev_t* dev)
+{
+    bool wake;
+
+    if (!dev->proto.ring_en)
+        return 0;
+
+    pthread_mutex_lock(&dev->proto.mtx);
+    wake = vll_ring_flush(&dev->proto.h2d);
+    pthread_mutex_unlock(&dev->proto.mtx);
+
+    return wake ? vpu_send_doorbell(&dev->proto.vch) : 0;
+}
+
+// Has to go the same way as register writes to keep ordering
+static
+int verilator_mmap_req(verilator_dev_t* dev, uint32_t addr, uint32_t size, uint32_t flags)
+{
+    const uint32_t data[3] = { addr, size, flags };
+    int res;
+
+    if (!dev->proto.ring_en)
+        return vpu_send_mmap_req32(&dev->proto.vch, addr, size, flags);
+
+    pthread_mutex_lock(&dev->proto.mtx);
+    res = vpu_ring_send_pkt(&dev->proto.h2d, VPT_MMAP_REGON_32, 0, data, SIZEOF_ARRAY(data));
+    pthread_mutex_unlock(&dev->proto.mtx);
+    if (res)
+        return res;
+
+    return verilator_flush(dev);
+}
+
+static
+int verilator_ring_setup(verilator_dev_t* dev)
+{
+    verilator_protocol_unix_t* p = &dev->proto;
+    uint8_t* base = (uint8_t*)p->vchm.addr;
+    uint32_t data[4];
+    struct pheader hdr;
+    int res;
+
+    for (unsigned i = 0; i < 2; i++) {
+        uint32_t addr = PHYS_RING_BASE + i * RING_REGION_SZ;
+
+        res = vpu_send_mmap_req32(&p->vch, addr, RING_REGION_SZ, VPT_MRF_READ | VPT_MRF_WRITE);
+        if (res)
+            return res;
+
+        res = vll_mem_protect(&p->vchm, addr, RING_REGION_SZ, PROT_READ | PROT_WRITE);
+        if (res)
+            return res;
+    }
+
+    res = vll_ring_init(&p->h2d, base + PHYS_RING_BASE, RING_REGION_SZ);
+    if (res)
+        return res;
+
+    res = vll_ring_init(&p->d2h, base + PHYS_RING_BASE + RING_REGION_SZ, RING_REGION_SZ);
+    if (res)
+        return res;
+
+    res = vpu_send_ring_setup(&p->vch, 0, PHYS_RING_BASE, PHYS_RING_BASE + RING_REGION_SZ, RING_REGION_SZ);
+    if (res)
+        return res;
+
+    // Simulators without ring support may not answer at all
+    res = vll_chan_wait(&p->vch, RING_SETUP_TIMEOUT_MS);
+    if (res)
+        return res;
+
+    res = vpu_recv_pkt(&p->vch, &hdr, data, SIZEOF_ARRAY(data));
+    if (res)
+        return res;
+
+    if (hdr.type != VPT_RING_SETUP || hdr.tag != 0)
+        return -ENOTSUP;
+
+    p->ring_en = true;
+    return 0;
+}
+
+// Returns -EAGAIN if all tags are in flight and wait is false
+static
+int verilator_tag_alloc(verilator_protocol_unix_t* dev, bool wait)
+{
+    int res;
+    res = wait ? sem_wait(&dev->tags_avail) : sem_trywait(&dev->tags_avail);
+    if (res)
+        return -errno;
+
+    for (;;) {
+        uint32_t msk = __atomic_load_n(&dev->tags_free_idx, __ATOMIC_RELAXED);
+        for (unsigned i = 0; i < MAX_TAGS; i++) {
+            if ((~msk & (1u << i)) == 0)
+                continue;
+
+            if ((__atomic_fetch_or(&dev->tags_free_idx, 1u << i, __ATOMIC_ACQUIRE) & (1u << i)) == 0)
+                return i;
+        }
+    }
 }
 
 static
 int verilator_tag_release(verilator_protocol_unix_t* dev, unsigned tag)
 {
     int res;
+    __atomic_fetch_and(&dev->tags_free_idx, ~(1u << tag), __ATOMIC_RELEASE);
+
     res = sem_post(&dev->tags_avail);
     if (res)
         return res;
@@ -369,18 +538,48 @@ int verilator_tag_release(verilator_protocol_unix_t* dev, unsigned tag)
     return 0;
 }
 
+// Issue read request, returns tag to be passed to verilator_in_cpl()
 static
-int verilator_in(verilator_dev_t* dev, unsigned addr, uint32_t *pinval, const unsigned dwcnt)
+int verilator_in_req(verilator_dev_t* dev, unsigned addr, const unsigned dwcnt, bool wait)
 {
     int res, tag;
-    tag = verilator_tag_alloc(&dev->proto);
+    tag = verilator_tag_alloc(&dev->proto, wait);
     if (tag < 0)
         return tag;
 
-    res = vpu_send_memrdreq32(&dev->proto.vch, addr, dwcnt, tag);
-    if (res < 0)
+    if (dev->proto.ring_en) {
+        for (;;) {
+            pthread_mutex_lock(&dev->proto.mtx);
+            res = vpu_ring_send_memrdreq32(&dev->proto.h2d, addr, dwcnt, tag);
+            bool wake = vll_ring_flush(&dev->proto.h2d);
+            pthread_mutex_unlock(&dev->proto.mtx);
+
+            if (wake) {
+                int err = vpu_send_doorbell(&dev->proto.vch);
+                if (err)
+                    res = err;
+            }
+            if (res != -EAGAIN)
+                break;
+
+            usleep(RING_RETRY_US);
+        }
+    } else {
+        res = vpu_send_memrdreq32(&dev->proto.vch, addr, dwcnt, tag);
+    }
+
+    if (res < 0) {
+        verilator_tag_release(&dev->proto, tag);
         return res;
+    }
+
+    return tag;
+}
 
+static
+int verilator_in_cpl(verilator_dev_t* dev, unsigned tag, uint32_t *pinval, const unsigned dwcnt)
+{
+    int res;
     res = sem_wait(&dev->proto.tags[tag]);
     if (res)
         return res;
@@ -394,6 +593,17 @@ int verilator_in(verilator_dev_t* dev, unsigned addr, uint32_t *pinval, const un
     return 0;
 }
 
+static
+int verilator_in(verilator_dev_t* dev, unsigned addr, uint32_t *pinval, const unsigned dwcnt)
+{
+    int tag;
+    tag = verilator_in_req(dev, addr, dwcnt, true);
+    if (tag < 0)
+        return tag;
+
+    return verilator_in_cpl(dev, tag, pinval, dwcnt);
+}
+
 void* thread_verilator(void* obj)
 {
     verilator_dev_t* dev = (verilator_dev_t*)obj;
@@ -402,6 +612,18 @@ void* thread_verilator(void* obj)
     USDR_LOG("VERI", USDR_LOG_NOTE, "Verilator monitor thread started\n");
 
     while (!dev->terminated) {
+        if (dev->proto.ring_en) {
+            res = verilator_process_ring(dev);
+            if (res < 0) {
+                USDR_LOG("VERI", USDR_LOG_DEBUG, "Verilator monitor thread ring error: %d\n", res);
+                return (void*)(intptr_t)res;
+            }
+
+            // Block on the socket only when the simulator is going to ring the doorbell
+            if (res > 0 || !vll_ring_sleep(&dev->proto.d2h))
+                continue;
+        }
+
         res = verilator_process_recv(dev);
         if (res == -EINTR)
             continue;
@@ -434,7 +656,7 @@ int verilator_wrap_reg_out(verilator_dev_t* dev, unsigned reg,
                                 uint32_t outval)
 {
     int res;
-    res = vpu_send_memwr32(&dev->proto.vch, reg * 4, &outval, 1);
+    res = verilator_out(dev, reg * 4, &outval, 1);
     USDR_LOG("VERI", USDR_LOG_DEBUG, "%s: Write [%04x] = %08x (%d)\n",
              dev->name, reg, outval, res);
     if (res < 0)
@@ -458,7 +680,7 @@ static int verilator_wrap_reg_out_n(verilator_dev_t* dev, unsigned reg,
                                   const uint32_t *outval, const unsigned dwcnt)
 {
     int res;
-    res = vpu_send_memwr32(&dev->proto.vch, reg * 4, outval, dwcnt);
+    res = verilator_out(dev, reg * 4, outval, dwcnt);
     USDR_LOG("VERI", USDR_LOG_DEBUG, "%s: WriteArray [%04x + %d] (%d)\n",
              dev->name, reg, dwcnt, res);
     if (res < 0)
@@ -481,6 +703,23 @@ static int verilator_wrap_reg_in_n(verilator_dev_t* dev, unsigned reg,
     return res;
 }
 
+// Waits for all in flight reads, returns the first error
+static
+int verilator_in_drain(verilator_dev_t* d, const int* tags, const unsigned* idx,
+                       unsigned cnt, uint32_t* ina)
+{
+    int res = 0;
+    for (unsigned j = 0; j < cnt; j++) {
+        int err = verilator_in_cpl(d, tags[j], &ina[idx[j]], 1);
+        if (err && res == 0)
+            res = err;
+
+        USDR_LOG("VERI", USDR_LOG_DEBUG, "%s: Read  IDX[%d] = %08x (%d)\n",
+                 d->name, idx[j], ina[idx[j]], err);
+    }
+    return res;
+}
+
 static
 int verilator_wrap_reg_op(verilator_dev_t* d, unsigned ls_op_addr,
                         uint32_t* ina, size_t meminsz, const uint32_t* outa, size_t memoutsz)
@@ -493,30 +732,49 @@ int verilator_wrap_reg_op(verilator_dev_t* d, unsigned ls_op_addr,
 
     for (unsigned k = 0; k < d->db.idx_regsps; k++) {
         if (ls_op_addr >= d->db.idxreg_virt_base[k]) {
-            // Indexed register operation
+            // Indexed register operation, read requests are kept in flight
+            // and matched by tags, so there's no round trip for every register
             unsigned amax = ((memoutsz > meminsz) ? memoutsz : meminsz) / 4;
+            unsigned pend_idx[MAX_TAGS];
+            int pend_tag[MAX_TAGS];
+            unsigned pend = 0;
 
-            for (i = 0; i < amax; i++) {
+            for (i = 0, res = 0; i < amax && res == 0; i++) {
                 //Write address
                 res = verilator_wrap_reg_out(d, d->db.idxreg_base[k],
                                            ls_op_addr - d->db.idxreg_virt_base[k] + i);
                 if (res)
-                    return res;
+                    break;
 
                 if (i < memoutsz / 4) {
                     res = verilator_wrap_reg_out(d, d->db.idxreg_base[k] + 1, outa[i]);
                     if (res)
-                        return res;
+                        break;
                 }
 
                 if (i < meminsz / 4) {
-                    res = verilator_wrap_reg_in(d, d->db.idxreg_base[k] + 1, &ina[i]);
-                    if (res)
-                        return res;
+                    int tag = verilator_in_req(d, (d->db.idxreg_base[k] + 1) * 4, 1, pend == 0);
+                    if (tag == -EAGAIN) {
+                        // Don't hold tags while waiting for the others
+                        res = verilator_in_drain(d, pend_tag, pend_idx, pend, ina);
+                        pend = 0;
+                        if (res)
+                            break;
+
+                        tag = verilator_in_req(d, (d->db.idxreg_base[k] + 1) * 4, 1, true);
+                    }
+                    if (tag < 0) {
+                        res = tag;
+                        break;
+                    }
+
+                    pend_tag[pend] = tag;
+                    pend_idx[pend++] = i;
                 }
             }
 
-            return 0;
+            int dres = verilator_in_drain(d, pend_tag, pend_idx, pend, ina);
+            return (res) ? res : dres;
         }
     }
 #if 1
@@ -560,6 +818,12 @@ static int verilator_wrap_wait_msi(verilator_dev_t* dev, unsigned i, int timeout
 {
     int res;
     struct timespec ts;
+
+    // Interrupt is a response to posted writes
+    res = verilator_flush(dev);
+    if (res)
+        return res;
+
     res = clock_gettime(CLOCK_REALTIME, &ts);
     if (res)
         return -EFAULT;
@@ -584,10 +848,10 @@ static int verilator_wrap_wait_msi(verilator_dev_t* dev, unsigned i, int timeout
 }
 
 static
-int verilator_wrap_ls_op(lldev_t dev, subdev_t subdev,
-                       unsigned ls_op, lsopaddr_t ls_op_addr,
-                       size_t meminsz, void* pin,
-                       size_t memoutsz, const void* pout)
+int verilator_wrap_ls_op_int(lldev_t dev, subdev_t subdev,
+                             unsigned ls_op, lsopaddr_t ls_op_addr,
+                             size_t meminsz, void* pin,
+                             size_t memoutsz, const void* pout)
 {
     int res;
     verilator_dev_t* d = (verilator_dev_t*)dev;
@@ -674,6 +938,21 @@ int verilator_wrap_ls_op(lldev_t dev, subdev_t subdev,
     return -EOPNOTSUPP;
 }
 
+static
+int verilator_wrap_ls_op(lldev_t dev, subdev_t subdev,
+                       unsigned ls_op, lsopaddr_t ls_op_addr,
+                       size_t meminsz, void* pin,
+                       size_t memoutsz, const void* pout)
+{
+    verilator_dev_t* d = (verilator_dev_t*)dev;
+    int res, fres;
+
+    // Posted writes of the whole operation go to the simulator in one batch
+    res = verilator_wrap_ls_op_int(dev, subdev, ls_op, ls_op_addr, meminsz, pin, memoutsz, pout);
+    fres = verilator_flush(d);
+    return (res) ? res : fres;
+}
+
 
 static
 int verilator_wrap_stream_initialize(lldev_t dev, subdev_t subdev,
@@ -716,7 +995,11 @@ int verilator_wrap_stream_initialize(lldev_t dev, subdev_t subdev,
             if (res)
                 return res;
 
-            res = vpu_send_mmap_req32(&d->proto.vch, phys_addr, page_size, PROT_WRITE);
+            res = verilator_flush(d);
+            if (res)
+                return res;
+
+            res = verilator_mmap_req(d, phys_addr, page_size, PROT_WRITE);
             if (res)
                 return res;
 
@@ -786,7 +1069,7 @@ int verilator_wrap_recv_dma_release(lldev_t dev, subdev_t subdev, stream_t chann
     if (res)
         return res;
 
-    return 0;
+    return verilator_flush(d);
 }
 
 static
@@ -877,6 +1160,13 @@ int verilator_wrap_plugin_create(unsigned pcount, const char** devparam,
     const char* path = "verilator.sock";
     int res;
     device_id_t did;
+    bool shmring = false;
+
+    for (unsigned k = 0; k < pcount; k++) {
+        if (strcmp(devparam[k], "shmring") == 0) {
+            shmring = (devval[k][0] == '1' || devval[k][0] == 'o') ? true : false;
+        }
+    }
 
 
     dev = (verilator_dev_t*)malloc(sizeof(verilator_dev_t));
@@ -903,6 +1193,15 @@ int verilator_wrap_plugin_create(unsigned pcount, const char** devparam,
 
     USDR_LOG("VERI", USDR_LOG_NOTE, "Connected to verilator\n");
 
+    if (shmring) {
+        res = verilator_ring_setup(dev);
+        if (res) {
+            USDR_LOG("VERI", USDR_LOG_WARNING, "Shared memory rings aren't supported by simulator, error %d; using socket\n", res);
+        } else {
+            USDR_LOG("VERI", USDR_LOG_INFO, "Using shared memory rings for transport\n");
+        }
+    }
+
     dev->ops = &s_verilator_wrap_ops;
     snprintf(dev->name, sizeof(dev->name) - 1, "%s", path);
 
@@ -988,7 +1287,7 @@ int verilator_wrap_plugin_create(unsigned pcount, const char** devparam,
     res = verilator_wrap_reg_out(dev, REG_WR_PNTFY_ACK, 2 << 16);
     res = verilator_wrap_reg_out(dev, REG_WR_PNTFY_ACK, 3 << 16);
 
-    res = vpu_send_mmap_req32(&dev->proto.vch, PHYS_NTFY_BASE, 4096, PROT_WRITE);
+    res = verilator_mmap_req(dev, PHYS_NTFY_BASE, 4096, PROT_WRITE);
     if (res)
         return res;
 
@@ -1002,6 +1301,9 @@ int verilator_wrap_plugin_create(unsigned pcount, const char** devparam,
     if (res)
         return res;
 #endif
+    res = verilator_flush(dev);
+    if (res)
+        goto remove_dev;
 
     // Device initialization
     res = dev->udev->initialize(dev->udev);
@@ -146,3 +146,99 @@ int vpu_send_mmap_req32(struct vll_chan* pvpu, uint32_t addr, uint32_t size, uin
     res = vll_chan_send_sync(pvpu, (const uint8_t*)buff, ph->size);
     return res == ph->size ? 0 : -EIO;
 }
+
+int vpu_send_ring_setup(struct vll_chan* pvpu, uint8_t tag, uint32_t h2d_addr, uint32_t d2h_addr, uint32_t size)
+{
+    uint32_t buff[4];
+    int res;
+    struct pheader* ph = (struct pheader*)&buff[0];
+
+    ph->type = VPT_RING_SETUP;
+    ph->tag = tag;
+    ph->size = 4 * sizeof(uint32_t);
+
+    buff[1] = h2d_addr;
+    buff[2] = d2h_addr;
+    buff[3] = size;
+
+    res = vll_chan_send_sync(pvpu, (const uint8_t*)buff, ph->size);
+    return res == ph->size ? 0 : -EIO;
+}
+
+int vpu_send_doorbell(struct vll_chan* pvpu)
+{
+    uint32_t buff[1];
+    int res;
+    struct pheader* ph = (struct pheader*)&buff[0];
+
+    ph->type = VPT_RING_DOORBELL;
+    ph->tag = 0;
+    ph->size = 1 * sizeof(uint32_t);
+
+    res = vll_chan_send_sync(pvpu, (const uint8_t*)buff, ph->size);
+    return res == ph->size ? 0 : -EIO;
+}
+
+int vpu_ring_recv_pkt(struct vll_ring* r, struct pheader* ph, uint32_t* data, unsigned maxsz)
+{
+    unsigned avail = vll_ring_avail(r);
+    unsigned dwcnt;
+
+    if (avail == 0)
+        return 0;
+
+    vll_ring_peek(r, 0, (uint32_t*)ph, 1);
+    dwcnt = ph->size / 4;
+
+    // Producer publishes whole packets only, so there's no packet boundary
+    // to resync on except the end of published data
+    if (ph->size % 4 || ph->size < sizeof(*ph) || dwcnt > avail) {
+        vll_ring_consume(r, avail);
+        return -EIO;
+    }
+
+    // Well formed but doesn't fit, skip it
+    if (dwcnt - 1 > maxsz) {
+        vll_ring_consume(r, dwcnt);
+        return -EMSGSIZE;
+    }
+
+    vll_ring_peek(r, 1, data, dwcnt - 1);
+    vll_ring_consume(r, dwcnt);
+    return 1;
+}
+
+int vpu_ring_send_pkt(struct vll_ring* r, uint8_t type, uint8_t tag, const uint32_t* pdw, unsigned dwcnt)
+{
+    const unsigned psz = sizeof(struct pheader) / sizeof(uint32_t) + dwcnt;
+    uint32_t buff[psz];
+    struct pheader* ph = (struct pheader*)&buff[0];
+
+    ph->type = type;
+    ph->tag = tag;
+    ph->size = psz * sizeof(uint32_t);
+    memcpy(buff + 1, pdw, dwcnt * 4);
+
+    return vll_ring_put(r, buff, psz);
+}
+
+int vpu_ring_send_memwr32(struct vll_ring* r, uint32_t addr, const uint32_t* pdw, unsigned dwcnt)
+{
+    const unsigned psz = sizeof(struct pheader) / sizeof(uint32_t) + 1 + dwcnt;
+    uint32_t buff[psz];
+    struct pheader* ph = (struct pheader*)&buff[0];
+
+    ph->type = VPT_MEMORY_WRITE_32;
+    ph->tag = 0;
+    ph->size = psz * sizeof(uint32_t);
+    buff[1] = addr;
+    memcpy(buff + 2, pdw, dwcnt * 4);
+
+    return vll_ring_put(r, buff, psz);
+}
+
+int vpu_ring_send_memrdreq32(struct vll_ring* r, uint32_t addr, unsigned dwcnt, uint8_t tag)
+{
+    const uint32_t buff[2] = { addr, dwcnt };
+    return vpu_ring_send_pkt(r, VPT_MEMORY_READ_REQ_32, tag, buff, 2);
+}
@@ -38,6 +38,13 @@ enum ptype {
     // MSI number n tag field
     VPT_INTERRUPT_NOTIFICATON = 7,
 
+    // Switch to shared memory rings, 1DW host->sim ring address, 2DW sim->host ring address,
+    // 3DW ring region size. Simulator answers with the same type, tag is 0 on success.
+    // After that all packets go through the rings, socket is used for VPT_RING_DOORBELL only
+    VPT_RING_SETUP = 8,
+    // Wake up ring consumer, sent only when vll_ring_flush() reports it's sleeping
+    VPT_RING_DOORBELL = 9,
+
     // mmap() 1DW start address, 2DW length, 3DW flags
     VPT_MMAP_REGON_32 = 254,
     // Get internal device UUID of simulation
@@ -51,6 +58,7 @@ enum vpt_mem_region_flags {
 };
 
 struct vll_chan;
+struct vll_ring;
 
 int vpu_recv_pkt(struct vll_chan* pvpu, struct pheader* ph, uint32_t* data, unsigned maxsz);
 
@@ -61,6 +69,18 @@ int vpu_send_cpldl_64(struct vll_chan* pvpu, uint8_t tag, uint64_t data);
 int vpu_send_memwr32(struct vll_chan* pvpu, uint32_t addr, const uint32_t* pdw, unsigned dwcnt);
 int vpu_send_memrdreq32(struct vll_chan* pvpu, uint32_t addr, unsigned dwcnt, uint8_t tag);
 int vpu_send_mmap_req32(struct vll_chan* pvpu, uint32_t addr, uint32_t size, uint32_t flags);
+int vpu_send_ring_setup(struct vll_chan* pvpu, uint8_t tag, uint32_t h2d_addr, uint32_t d2h_addr, uint32_t size);
+int vpu_send_doorbell(struct vll_chan* pvpu);
+
+// Ring transport, packets have the same layout as on the socket
+// Returns 1 if packet was received, 0 when ring is empty. Malformed packets are
+// dropped from the ring: -EMSGSIZE for a packet larger than maxsz, -EIO when
+// the header is broken and all published data is discarded
+int vpu_ring_recv_pkt(struct vll_ring* r, struct pheader* ph, uint32_t* data, unsigned maxsz);
+
+int vpu_ring_send_pkt(struct vll_ring* r, uint8_t type, uint8_t tag, const uint32_t* pdw, unsigned dwcnt);
+int vpu_ring_send_memwr32(struct vll_ring* r, uint32_t addr, const uint32_t* pdw, unsigned dwcnt);
+int vpu_ring_send_memrdreq32(struct vll_ring* r, uint32_t addr, unsigned dwcnt, uint8_t tag);
 
 
 #ifdef __cplusplus
@@ -5,5 +5,6 @@
 #include "dm_rate.h"
 #include "dm_sdr.h"
 #include "dm_stream.h"
+#include "dm_sweep.h"
 
 #include <usdr_logging.h>
@@ -9,6 +9,9 @@
 #include "../device/device.h"
 #include "../device/device_vfs.h"
 #include "../device/mdev.h"
+#ifndef __EMSCRIPTEN__
+#include "../device/device_broker.h"
+#endif
 
 #include "dm_debug.h"
 #include <stdlib.h>
@@ -97,8 +100,21 @@ int _usdr_dmd_create(const struct dev_params *par, pdm_dev_t* odev,
     int res;
     lldev_t lldev = NULL;
     pdm_dev_t dev;
+    const char* broker = NULL;
+
+#ifndef __EMSCRIPTEN__
+    for (unsigned k = 0; k < par->num; k++) {
+        if (strcmp(par->params[k], "broker") == 0 && par->value[k]) {
+            broker = par->value[k];
+        }
+    }
+#endif
 
-    if (bus_cnt <= 1) {
+    if (broker) {
+#ifndef __EMSCRIPTEN__
+        res = device_broker_connect(broker, &lldev);
+#endif
+    } else if (bus_cnt <= 1) {
         res = lowlevel_create(par->num, (const char**)par->params, (const char**)par->value, &lldev, vidpid, webops, param);
     } else {
         res = mdev_create(par->num, (const char**)par->params, (const char**)par->value, &lldev,
@@ -113,6 +129,7 @@ int _usdr_dmd_create(const struct dev_params *par, pdm_dev_t* odev,
 
     dev->lldev = lldev;
     dev->debug_obj = NULL;
+    dev->broker = NULL;
 
 #ifndef __EMSCRIPTEN__
     if (getenv("USDR_DEBUG")) {
@@ -191,6 +208,8 @@ int usdr_dmd_create_string(const char* connection_string, pdm_dev_t* odev)
 
 int usdr_dmd_close(pdm_dev_t dev)
 {
+    usdr_dmd_broker_stop(dev);
+
     while (dev->obj_head.prev != &dev->obj_head) {
         USDR_LOG("DSTR", USDR_LOG_DEBUG, "Destroying object %p!\n", dev->obj_head.prev);
         usdr_dmo_destroy(dev->obj_head.prev);
@@ -247,38 +266,150 @@ int usdr_dme_get_uint(pdm_dev_t dev, const char* path, uint64_t *oval)
 {
     pusdr_vfs_obj_t obj;
     pdevice_t udev = lowlevel_get_device(dev->lldev);
-    int res = udev->vfs_get_single_object(udev, path, &obj);
-    if (res)
-        return res;
+    int res;
 
-    return usdr_device_vfs_obj_val_get(udev, obj, oval);
+    usdr_device_ctrl_lock(udev);
+    res = udev->vfs_get_single_object(udev, path, &obj);
+    if (res == 0)
+        res = usdr_device_vfs_obj_val_get(udev, obj, oval);
+    usdr_device_ctrl_unlock(udev);
+    return res;
 }
 
 int usdr_dme_get_string(pdm_dev_t dev, const char* path, const char** oval)
 {
+    pusdr_vfs_obj_t obj;
+    pdevice_t udev = lowlevel_get_device(dev->lldev);
     uint64_t v;
-    int res = usdr_dme_get_uint(dev, path, &v);
+    int res;
+
+    usdr_device_ctrl_lock(udev);
+    res = udev->vfs_get_single_object(udev, path, &obj);
     if (res)
-        return res;
+        goto done;
 
-    *oval = (const char*)(uintptr_t)v;
-    return 0;
+    if (obj->type == VFST_STR && obj->ops.gstr) {
+        res = obj->ops.gstr(obj, 0, NULL);
+        if (res == 0)
+            *oval = obj->data.str;
+        goto done;
+    }
+
+    res = usdr_device_vfs_obj_val_get(udev, obj, &v);
+    if (res == 0)
+        *oval = (const char*)(uintptr_t)v;
+
+done:
+    usdr_device_ctrl_unlock(udev);
+    return res;
 }
 
 int usdr_dme_set_uint(pdm_dev_t dev, const char* path, uint64_t val)
 {
     pusdr_vfs_obj_t obj;
     pdevice_t udev = lowlevel_get_device(dev->lldev);
-    int res = udev->vfs_get_single_object(udev, path, &obj);
-    if (res)
-        return res;
+    int res;
 
-    return usdr_device_vfs_obj_val_set(udev, obj, val);
+    usdr_device_ctrl_lock(udev);
+    res = udev->vfs_get_single_object(udev, path, &obj);
+    if (res == 0)
+        res = usdr_device_vfs_obj_val_set(udev, obj, val);
+    usdr_device_ctrl_unlock(udev);
+    return res;
 }
 
 int usdr_dme_set_string(pdm_dev_t dev, const char* path, const char* val)
 {
-    return usdr_dme_set_uint(dev, path, (uintptr_t)val);
+    pusdr_vfs_obj_t obj;
+    pdevice_t udev = lowlevel_get_device(dev->lldev);
+    int res;
+
+    usdr_device_ctrl_lock(udev);
+    res = udev->vfs_get_single_object(udev, path, &obj);
+    if (res)
+        goto done;
+
+    if (obj->type == VFST_STR && obj->ops.sstr)
+        res = obj->ops.sstr(obj, val);
+    else
+        res = usdr_device_vfs_obj_val_set(udev, obj, (uintptr_t)val);
+
+done:
+    usdr_device_ctrl_unlock(udev);
+    return res;
+}
+
+int usdr_dmd_broker_start(pdm_dev_t dev, const char* name)
+{
+#ifndef __EMSCRIPTEN__
+    if (dev->broker)
+        return -EBUSY;
+
+    return device_broker_create(lowlevel_get_device(dev->lldev), name,
+                                &dev->broker);
+#else
+    return -ENOTSUP;
+#endif
+}
+
+int usdr_dmd_broker_stop(pdm_dev_t dev)
+{
+#ifndef __EMSCRIPTEN__
+    if (dev->broker == NULL)
+        return 0;
+
+    device_broker_destroy(dev->broker);
+    dev->broker = NULL;
+    return 0;
+#else
+    return -ENOTSUP;
+#endif
+}
+
+int usdr_dme_set_uint_vec(pdm_dev_t dev, const char* path, unsigned count, const uint64_t* vals)
+{
+    pusdr_vfs_obj_t obj;
+    pdevice_t udev = lowlevel_get_device(dev->lldev);
+    int res;
+
+    usdr_device_ctrl_lock(udev);
+    res = udev->vfs_get_single_object(udev, path, &obj);
+    if (res)
+        goto done;
+
+    if (obj->ops.sai64)
+        res = obj->ops.sai64(obj, count, vals);
+    else
+        res = (count == 1) ? usdr_device_vfs_obj_val_set(udev, obj, vals[0]) : -EINVAL;
+
+done:
+    usdr_device_ctrl_unlock(udev);
+    return res;
+}
+
+int usdr_dme_get_uint_vec(pdm_dev_t dev, const char* path, unsigned maxcnt, uint64_t* ovals)
+{
+    pusdr_vfs_obj_t obj;
+    pdevice_t udev = lowlevel_get_device(dev->lldev);
+    int res;
+
+    usdr_device_ctrl_lock(udev);
+    res = udev->vfs_get_single_object(udev, path, &obj);
+    if (res)
+        goto done;
+
+    if (obj->ops.gai64) {
+        res = obj->ops.gai64(obj, maxcnt, ovals);
+    } else if (maxcnt == 0) {
+        res = -EINVAL;
+    } else {
+        res = usdr_device_vfs_obj_val_get(udev, obj, ovals);
+        res = res ? res : 1;
+    }
+
+done:
+    usdr_device_ctrl_unlock(udev);
+    return res;
 }
 
 int usdr_dme_filter(pdm_dev_t dev, const char* pattern, const unsigned count, dme_param_t* objs)
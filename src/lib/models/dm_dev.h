@@ -19,6 +19,11 @@ int usdr_dmd_close(pdm_dev_t dev);
 int usdr_dmd_discovery(const char* filer_string, unsigned max_buf, char* devlist);
 int usdr_dmd_create_webusb(unsigned vidpid, void* webops, uintptr_t param, pdm_dev_t* odev);
 
+// Share the device with other processes, they connect with `broker=<name>`
+// and get control access plus RX streams published with usdr_dms_broker_publish()
+int usdr_dmd_broker_start(pdm_dev_t dev, const char* name);
+int usdr_dmd_broker_stop(pdm_dev_t dev);
+
 struct dme_param {
     const char* fullpath;
 };
@@ -33,6 +38,14 @@ int usdr_dme_get_string(pdm_dev_t dev, const char* path, const char** oval);
 int usdr_dme_set_uint(pdm_dev_t dev, const char* path, uint64_t val);
 int usdr_dme_set_string(pdm_dev_t dev, const char* path, const char* val);
 
+// Vector access, on multi-board devices every board gets its own value and all
+// boards are processed concurrently. Set accepts a single value or one per board,
+// get returns number of values read. Per board status of the last operation is
+// available as /dm/mdev/failed, /dm/mdev/diverged (get only) and /dm/mdev/err/<n>,
+// single board is addressed as /dm/mdev/<n>/<path>
+int usdr_dme_set_uint_vec(pdm_dev_t dev, const char* path, unsigned count, const uint64_t* vals);
+int usdr_dme_get_uint_vec(pdm_dev_t dev, const char* path, unsigned maxcnt, uint64_t* ovals);
+
 
 struct dme_findsetv_data {
     const char* name;
@@ -16,6 +16,7 @@
 struct dm_dev {
     lldev_t lldev;
     struct usdr_debug_ctx *debug_obj;
+    struct device_broker *broker;
 
     usdr_dm_obj_t obj_head;
 };
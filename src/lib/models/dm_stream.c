@@ -5,6 +5,11 @@
 #include "dm_dev_impl.h"
 
 #include "../ipblks/streams/streams_api.h"
+#include "../ipblks/streams/stream_fanout.h"
+#include "../ipblks/streams/stream_trigger.h"
+#ifndef __EMSCRIPTEN__
+#include "../device/device_broker.h"
+#endif
 
 #include <stdlib.h>
 #include <string.h>
@@ -73,6 +78,34 @@ int usdr_dms_set_ready(pusdr_dms_t stream)
     return h->ops->option_set(h, "ready", 1);
 }
 
+int usdr_dms_set_pktsyms(pusdr_dms_t stream,
+                         unsigned pktsyms)
+{
+    struct stream_handle* h = (struct stream_handle*)stream;
+    return h->ops->option_set(h, "pktsyms", pktsyms);
+}
+
+int usdr_dms_get_pktsyms_ts(pusdr_dms_t stream,
+                            dm_time_t* ts)
+{
+    struct stream_handle* h = (struct stream_handle*)stream;
+    int64_t v;
+
+    int res = h->ops->option_get(h, "pktsyms_ts", &v);
+    if (res)
+        return res;
+
+    *ts = v;
+    return 0;
+}
+
+int usdr_dms_set_stats(pusdr_dms_t stream,
+                       unsigned enable)
+{
+    struct stream_handle* h = (struct stream_handle*)stream;
+    return h->ops->option_set(h, "stats", enable);
+}
+
 int usdr_dms_op(pusdr_dms_t stream,
                 unsigned command,
                 dm_time_t tm)
@@ -107,3 +140,93 @@ int usdr_dms_send(pusdr_dms_t stream,
     struct stream_handle* h = (struct stream_handle*)stream;
     return h->ops->send(h, (const char**)stream_buffs, samples, timestamp, timeout_ms);
 }
+
+int usdr_dms_send_cyclic(pusdr_dms_t stream,
+                         const void **stream_buffs,
+                         unsigned samples,
+                         dm_time_t timestamp)
+{
+    struct stream_handle* h = (struct stream_handle*)stream;
+    if (h->ops->send_cyclic == NULL)
+        return -ENOTSUP;
+
+    return h->ops->send_cyclic(h, (const char**)stream_buffs, samples, timestamp);
+}
+
+int usdr_dms_cyclic_stop(pusdr_dms_t stream)
+{
+    struct stream_handle* h = (struct stream_handle*)stream;
+    return h->ops->option_set(h, "cyclic", 0);
+}
+
+int usdr_dms_cyclic_count(pusdr_dms_t stream,
+                          uint64_t* cycles)
+{
+    struct stream_handle* h = (struct stream_handle*)stream;
+    int64_t v;
+
+    int res = h->ops->option_get(h, "cyclic_cycles", &v);
+    if (res)
+        return res;
+
+    *cycles = v;
+    return 0;
+}
+
+int usdr_dms_fanout_create(pusdr_dms_t stream,
+                           unsigned depth,
+                           pusdr_dms_fanout_t* fanout)
+{
+    struct stream_handle* h = (struct stream_handle*)stream;
+    return stream_fanout_create(h, depth, (stream_fanout_t**)fanout);
+}
+
+int usdr_dms_fanout_attach(pusdr_dms_fanout_t fanout,
+                           const char* host_fmt,
+                           unsigned policy,
+                           pusdr_dms_t* reader)
+{
+    return stream_fanout_attach((stream_fanout_t*)fanout, host_fmt, policy,
+                                (stream_handle_t**)reader);
+}
+
+int usdr_dms_fanout_detach(pusdr_dms_t reader)
+{
+    struct stream_handle* h = (struct stream_handle*)reader;
+    return stream_fanout_detach(h);
+}
+
+int usdr_dms_fanout_destroy(pusdr_dms_fanout_t fanout)
+{
+    return stream_fanout_destroy((stream_fanout_t*)fanout);
+}
+
+int usdr_dms_broker_publish(pdm_dev_t dev,
+                            const char* sid,
+                            pusdr_dms_fanout_t fanout,
+                            unsigned depth)
+{
+#ifndef __EMSCRIPTEN__
+    if (dev->broker == NULL)
+        return -EINVAL;
+
+    return device_broker_publish(dev->broker, sid,
+                                 (stream_fanout_t*)fanout, depth);
+#else
+    return -ENOTSUP;
+#endif
+}
+
+int usdr_dms_trigger_create(pusdr_dms_t stream,
+                            const struct usdr_dms_trigger_cfg* cfg,
+                            pusdr_dms_t* trig)
+{
+    struct stream_handle* h = (struct stream_handle*)stream;
+    return stream_trigger_create(h, cfg, (stream_handle_t**)trig);
+}
+
+int usdr_dms_trigger_destroy(pusdr_dms_t trig)
+{
+    struct stream_handle* h = (struct stream_handle*)trig;
+    return stream_trigger_destroy(h);
+}
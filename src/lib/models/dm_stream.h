@@ -69,12 +69,23 @@ struct usdr_dms_frame_nfo {
     unsigned samples;
 };
 
+// Per-channel statistics of the received packet, full scale is 32767
+// DC offset is sum / totsyms, mean power is sum_sq / totsyms
+struct usdr_dms_ch_stat {
+    int64_t sum_i;
+    int64_t sum_q;
+    uint64_t sum_sq;  // Sum of I^2 + Q^2
+    uint32_t peak;    // Peak of |I| and |Q|
+    uint32_t clips;   // Number of I and Q components at full scale
+};
+
 struct usdr_dms_recv_nfo {
     dm_time_t fsymtime;
     unsigned totsyms; // Number of valid samples in the buffers
     unsigned totlost; // Number of lost samples in the frame
     unsigned max_parts;
     uint64_t extra;
+    const struct usdr_dms_ch_stat* stats; // Array for every channel, NULL when stats are off
     struct usdr_dms_frame_nfo parts[0];
 };
 
@@ -91,6 +102,22 @@ int usdr_dms_send(pusdr_dms_t stream,
                   dm_time_t timestamp,
                   unsigned timeout);
 
+/// Cyclic transmission: @p samples of every channel are converted to wire
+/// format once and replayed back to back until stopped, starting at
+/// @p timestamp (or immediately when it's >= INT64_MAX). Calling it again while
+/// replaying swaps the waveform on a cycle boundary. usdr_dms_send() is
+/// rejected with -EBUSY until usdr_dms_cyclic_stop() or USDR_DMS_STOP.
+int usdr_dms_send_cyclic(pusdr_dms_t stream,
+                         const void **stream_buffs,
+                         unsigned samples,
+                         dm_time_t timestamp);
+
+int usdr_dms_cyclic_stop(pusdr_dms_t stream);
+
+/// Number of completely transmitted waveform periods
+int usdr_dms_cyclic_count(pusdr_dms_t stream,
+                          uint64_t* cycles);
+
 int usdr_dms_destroy(pusdr_dms_t stream);
 
 int usdr_dms_info(pusdr_dms_t stream, usdr_dms_nfo_t* nfo);
@@ -105,6 +132,12 @@ int usdr_dms_set_ready(pusdr_dms_t stream);
 // extall - sync between all active streams on extrenal sync event (onepps)
 //
 // this function should be called after all calls of usdr_dms_create() but before usdr_dms_op()
+//
+// Multi-board devices additionally accept, once the shared 1pps/sysref event has occurred:
+// measure - read back start timestamps of every board, results are available as
+//           /dm/sync/skew (spread in samples), /dm/sync/skew/<n> and /dm/sync/ts/<n>
+// align   - measure and discard leading samples of early started boards on RX streams,
+//           must be called before the first usdr_dms_recv()
 int usdr_dms_sync(pdm_dev_t device,
                   const char* synctype,
                   unsigned scount,
@@ -122,6 +155,87 @@ int usdr_dms_op(pusdr_dms_t stream,
                 unsigned command,
                 dm_time_t tm);
 
+/// Change RX packet size on the fly, new size is applied on a packet boundary,
+/// use usdr_dms_info() to get updated buffer sizes
+int usdr_dms_set_pktsyms(pusdr_dms_t stream,
+                         unsigned pktsyms);
+
+/// Get sample index where current packet size took effect, -EAGAIN when
+/// requested change hasn't been applied yet
+int usdr_dms_get_pktsyms_ts(pusdr_dms_t stream,
+                            dm_time_t* ts);
+
+/// Gather per-channel signal statistics while converting RX data, results are
+/// reported in usdr_dms_recv_nfo::stats; -ENOTSUP if the format can't provide them
+int usdr_dms_set_stats(pusdr_dms_t stream,
+                       unsigned enable);
+
+// Zero-copy fan-out of one RX stream to multiple readers
+struct usdr_dms_fanout;
+typedef struct usdr_dms_fanout* pusdr_dms_fanout_t;
+
+enum usdr_dms_fanout_policy {
+    USDR_DMS_FANOUT_BLOCK,       ///< Slowest reader holds buffers, other readers wait for it
+    USDR_DMS_FANOUT_DROP_OLDEST, ///< Reader loses its oldest packet when the window is full
+    USDR_DMS_FANOUT_SKIP,        ///< Reader always jumps to the newest available packet
+};
+
+/// Create fan-out on RX stream holding up to @p depth wire buffers (0 - default)
+/// Depth has to be less than the DMA ring length of the stream, -EINVAL otherwise
+int usdr_dms_fanout_create(pusdr_dms_t stream,
+                           unsigned depth,
+                           pusdr_dms_fanout_t* fanout);
+
+/// Attach a new reader, returned handle is used with usdr_dms_recv() / usdr_dms_info()
+/// @param host_fmt host format of the reader, NULL to keep wire format
+int usdr_dms_fanout_attach(pusdr_dms_fanout_t fanout,
+                           const char* host_fmt,
+                           unsigned policy,
+                           pusdr_dms_t* reader);
+
+int usdr_dms_fanout_detach(pusdr_dms_t reader);
+
+/// All readers should be detached before the call
+int usdr_dms_fanout_destroy(pusdr_dms_fanout_t fanout);
+
+/// Publish fan-out to broker clients as stream @p sid through shared memory
+/// ring of @p depth packets (0 - default), the broker keeps its own reader
+/// attached until usdr_dmd_broker_stop()
+int usdr_dms_broker_publish(pdm_dev_t dev,
+                            const char* sid,
+                            pusdr_dms_fanout_t fanout,
+                            unsigned depth);
+
+// Triggered capture, only windows around detector events are delivered
+enum usdr_dms_trigger_type {
+    USDR_DMS_TRIG_POWER, ///< Instantaneous power |x|^2, full scale is 1.0
+    USDR_DMS_TRIG_XCORR, ///< Normalized cross-correlation with the preamble, 0..1
+};
+
+struct usdr_dms_trigger_cfg {
+    unsigned type;
+    unsigned channel;       ///< Channel index the detector runs on
+    unsigned pre_syms;      ///< Samples delivered before the trigger
+    unsigned post_syms;     ///< Samples delivered from the trigger onwards, at least 1
+    float thr_on;           ///< Trigger when the metric reaches it
+    float thr_off;          ///< Rearm once the metric falls below it
+    const float* preamble;  ///< cf32 preamble for USDR_DMS_TRIG_XCORR, copied on create
+    unsigned preamble_syms;
+};
+
+/// Create triggered capture on RX stream or fan-out reader. usdr_dms_recv() on
+/// the returned handle delivers one cf32 window per trigger, usdr_dms_info()
+/// reports the window size. fsymtime is the first sample of the window and
+/// extra is the trigger timestamp (preamble start for correlation), windows
+/// are shorter at the front when not enough history has been received yet.
+/// Windows cut by lost samples are dropped and accounted in totlost.
+int usdr_dms_trigger_create(pusdr_dms_t stream,
+                            const struct usdr_dms_trigger_cfg* cfg,
+                            pusdr_dms_t* trig);
+
+/// Source stream should be destroyed after the trigger
+int usdr_dms_trigger_destroy(pusdr_dms_t trig);
+
 
 #ifdef __cplusplus
 }
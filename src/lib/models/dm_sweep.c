@@ -0,0 +1,383 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include "dm_sweep.h"
+#include "dm_dev_impl.h"
+
+#include "../device/device.h"
+#include "../common/cfft.h"
+#include "../xdsp/fftad_functions.h"
+#include "../xdsp/fft_window_functions.h"
+#include "../xdsp/fast_math.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+// Every step is retuned, then the stream is drained up to the moment the LO has
+// settled and the samples of the step are captured. Processing of the captured
+// step (window, FFT, fftad averaging) runs on a worker while the next step is
+// retuned and settling.
+
+#define DMSW_ALIGN       64
+#define DMSW_TIMEOUT_MS  1000
+
+struct usdr_dmsw {
+    pdm_dev_t dev;
+    pusdr_dms_t rx;
+    struct usdr_dmsw_cfg cfg;
+
+    unsigned pktsyms;
+    unsigned keep;        // Bins kept on every step
+    unsigned steps;
+    double bin_hz;
+
+    // Stream to device time mapping
+    bool hw_ts;
+    uint64_t ts_reg;
+    uint64_t last_ts;     // End of the last received packet
+    uint64_t last_host_ns;
+    uint64_t discarded;
+
+    float* pkt;
+    float* cap[2];
+
+    // Worker
+    pthread_t thread;
+    sem_t start;
+    sem_t done;
+    bool quit;
+    const float* job_cap;
+    float* job_out;
+
+    float* tw;
+    float* wnd;
+    float* fbuf;
+    float* pwr;
+    fft_acc_t acc;
+    float corr;
+};
+
+static uint64_t _dmsw_host_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void* _dmsw_alloc(size_t sz)
+{
+    void* p;
+    return posix_memalign(&p, DMSW_ALIGN, sz) ? NULL : p;
+}
+
+static void _dmsw_process(usdr_dmsw_t* sw, const float* cap, float* out)
+{
+    unsigned fftsz = sw->cfg.fftsz;
+
+    fftad_init(&sw->acc, fftsz);
+    for (unsigned a = 0; a < sw->cfg.averages; a++) {
+        fft_window_cf32((wvlt_fftwf_complex*)(cap + 2 * a * fftsz), fftsz, sw->wnd,
+                        (wvlt_fftwf_complex*)sw->fbuf);
+        cfft_run(sw->fbuf, fftsz, sw->tw, fftsz, false);
+        fftad_add(&sw->acc, (wvlt_fftwf_complex*)sw->fbuf, fftsz);
+    }
+
+    // Output is centered, DC is at fftsz / 2
+    fftad_norm(&sw->acc, fftsz, 10 * log10f(2) / sw->cfg.averages, sw->corr, sw->pwr,
+               WVLT_LOG2_DEGREE_DEFAULT);
+    memcpy(out, sw->pwr + fftsz / 2 - sw->keep / 2, sw->keep * sizeof(float));
+}
+
+static void* _dmsw_worker(void* param)
+{
+    usdr_dmsw_t* sw = (usdr_dmsw_t*)param;
+
+    for (;;) {
+        while (sem_wait(&sw->start) == -1 && errno == EINTR);
+        if (sw->quit)
+            break;
+
+        _dmsw_process(sw, sw->job_cap, sw->job_out);
+        sem_post(&sw->done);
+    }
+    return NULL;
+}
+
+// Current device time in stream samples
+static int _dmsw_now(usdr_dmsw_t* sw, uint64_t* now)
+{
+    uint32_t v;
+    int res;
+
+    if (sw->hw_ts) {
+        res = lowlevel_reg_rd32(sw->dev->lldev, 0, sw->ts_reg, &v);
+        if (res)
+            return res;
+
+        *now = sw->last_ts + (int32_t)(v - (uint32_t)sw->last_ts);
+    } else {
+        // No counter access, the latest packet plus the time passed since it
+        // was received is a lower bound, keep one extra packet as a margin
+        *now = sw->last_ts + sw->pktsyms +
+                (_dmsw_host_ns() - sw->last_host_ns) * sw->cfg.rate / 1000000000ull;
+    }
+    return 0;
+}
+
+static int _dmsw_recv(usdr_dmsw_t* sw, struct usdr_dms_recv_nfo* nfo)
+{
+    void* buffs[1] = { sw->pkt };
+    int res = usdr_dms_recv(sw->rx, buffs, DMSW_TIMEOUT_MS, nfo);
+    if (res)
+        return res;
+
+    sw->last_ts = nfo->fsymtime + nfo->totsyms;
+    sw->last_host_ns = _dmsw_host_ns();
+    return 0;
+}
+
+// Retune to the step and return the first sample to be used
+static int _dmsw_tune(usdr_dmsw_t* sw, unsigned step, uint64_t* ready_ts)
+{
+    double freq = sw->cfg.start + (step * sw->keep + sw->keep / 2) * sw->bin_hz;
+    uint64_t now;
+    int res;
+
+    res = usdr_dme_set_uint(sw->dev, "/dm/sdr/0/rx/freqency", llround(freq));
+    if (res)
+        return res;
+
+    res = _dmsw_now(sw, &now);
+    if (res)
+        return res;
+
+    *ready_ts = now + (uint64_t)sw->cfg.settle_us * sw->cfg.rate / 1000000u;
+    return 0;
+}
+
+static int _dmsw_capture(usdr_dmsw_t* sw, uint64_t ready_ts, float* cap)
+{
+    struct usdr_dms_recv_nfo nfo;
+    unsigned need = sw->cfg.averages * sw->cfg.fftsz;
+    unsigned got = 0;
+    int res;
+
+    while (got < need) {
+        res = _dmsw_recv(sw, &nfo);
+        if (res)
+            return res;
+
+        // Spectrum of an FFT spanning a gap is meaningless
+        if (nfo.totlost) {
+            got -= got % sw->cfg.fftsz;
+        }
+
+        unsigned skip = (ready_ts > nfo.fsymtime) ?
+                            ((ready_ts - nfo.fsymtime < nfo.totsyms) ? ready_ts - nfo.fsymtime : nfo.totsyms) : 0;
+        unsigned cnt = nfo.totsyms - skip;
+        if (cnt > need - got)
+            cnt = need - got;
+
+        sw->discarded += skip;
+        memcpy(cap + 2 * got, sw->pkt + 2 * skip, cnt * 2 * sizeof(float));
+        got += cnt;
+    }
+
+    return 0;
+}
+
+int usdr_dmsw_run(pusdr_dmsw_t sw, float* spectrum, struct usdr_dmsw_stat* stat)
+{
+    struct usdr_dms_recv_nfo nfo;
+    uint64_t t0 = _dmsw_host_ns();
+    uint64_t ready_ts;
+    bool busy = false;
+    int res;
+
+    sw->discarded = 0;
+
+    // Establish stream time
+    res = _dmsw_recv(sw, &nfo);
+    if (res)
+        return res;
+
+    res = _dmsw_tune(sw, 0, &ready_ts);
+    if (res)
+        return res;
+
+    for (unsigned s = 0; s < sw->steps; s++) {
+        float* cap = sw->cap[s & 1];
+
+        res = _dmsw_capture(sw, ready_ts, cap);
+        if (res)
+            break;
+
+        if (busy) {
+            while (sem_wait(&sw->done) == -1 && errno == EINTR);
+        }
+
+        sw->job_cap = cap;
+        sw->job_out = spectrum + s * sw->keep;
+        sem_post(&sw->start);
+        busy = true;
+
+        if (s + 1 < sw->steps) {
+            res = _dmsw_tune(sw, s + 1, &ready_ts);
+            if (res)
+                break;
+        }
+    }
+
+    if (busy) {
+        while (sem_wait(&sw->done) == -1 && errno == EINTR);
+    }
+    if (res) {
+        USDR_LOG("DMSW", USDR_LOG_ERROR, "Sweep aborted, error %d\n", res);
+        return res;
+    }
+
+    if (stat) {
+        stat->sweep_ns = _dmsw_host_ns() - t0;
+        stat->hz_per_sec = (uint64_t)(sw->steps * sw->keep * sw->bin_hz * 1e9 / stat->sweep_ns);
+        stat->discarded = sw->discarded;
+        stat->steps = sw->steps;
+    }
+
+    USDR_LOG("DMSW", USDR_LOG_DEBUG, "Sweep of %d steps in %.3f ms, %" PRIu64 " samples discarded\n",
+             sw->steps, (_dmsw_host_ns() - t0) / 1.0e6, sw->discarded);
+    return 0;
+}
+
+unsigned usdr_dmsw_bins(pusdr_dmsw_t sw)
+{
+    return sw->steps * sw->keep;
+}
+
+double usdr_dmsw_bin_hz(pusdr_dmsw_t sw)
+{
+    return sw->bin_hz;
+}
+
+static void _dmsw_free(usdr_dmsw_t* sw)
+{
+    free(sw->pkt);
+    free(sw->cap[0]);
+    free(sw->cap[1]);
+    free(sw->tw);
+    free(sw->wnd);
+    free(sw->fbuf);
+    free(sw->pwr);
+    free(sw->acc.f_mant);
+    free(sw->acc.f_pwr);
+    free(sw);
+}
+
+int usdr_dmsw_create(pdm_dev_t dev, pusdr_dms_t rx,
+                     const struct usdr_dmsw_cfg* cfg,
+                     pusdr_dmsw_t* sweep)
+{
+    usdr_dmsw_t* sw;
+    usdr_dms_nfo_t nfo;
+    unsigned fftsz = cfg->fftsz;
+    unsigned usable = cfg->usable_pct ? cfg->usable_pct : 75;
+    unsigned keep;
+    size_t capsz;
+    double wsum = 0;
+    int res;
+
+    // Edges of wider part are attenuated by the decimation filters
+    if (fftsz < 64 || fftsz > 65536 || (fftsz & (fftsz - 1)) ||
+        cfg->averages == 0 || cfg->rate == 0 || cfg->stop <= cfg->start || usable > 75)
+        return -EINVAL;
+
+    keep = (fftsz * usable / 100) & ~1u;
+    if (keep == 0)
+        return -EINVAL;
+
+    res = usdr_dms_info(rx, &nfo);
+    if (res)
+        return res;
+
+    if (nfo.type != USDR_DMS_RX || nfo.channels != 1 || nfo.pktbszie != nfo.pktsyms * 2 * sizeof(float)) {
+        USDR_LOG("DMSW", USDR_LOG_ERROR, "Sweep needs single channel cf32 RX stream\n");
+        return -EINVAL;
+    }
+
+    sw = (usdr_dmsw_t*)calloc(1, sizeof(usdr_dmsw_t));
+    if (!sw)
+        return -ENOMEM;
+
+    sw->dev = dev;
+    sw->rx = rx;
+    sw->cfg = *cfg;
+    sw->pktsyms = nfo.pktsyms;
+    sw->bin_hz = (double)cfg->rate / fftsz;
+    sw->keep = keep;
+    sw->steps = ceil((cfg->stop - cfg->start) / (sw->keep * sw->bin_hz));
+
+    capsz = (size_t)cfg->averages * fftsz * 2 * sizeof(float);
+    sw->pkt = (float*)_dmsw_alloc(nfo.pktbszie);
+    sw->cap[0] = (float*)_dmsw_alloc(capsz);
+    sw->cap[1] = (float*)_dmsw_alloc(capsz);
+    sw->tw = (float*)_dmsw_alloc(fftsz * sizeof(float));
+    sw->wnd = (float*)_dmsw_alloc(fftsz * sizeof(float));
+    sw->fbuf = (float*)_dmsw_alloc(fftsz * 2 * sizeof(float));
+    sw->pwr = (float*)_dmsw_alloc(fftsz * sizeof(float));
+    sw->acc.f_mant = (float*)_dmsw_alloc(fftsz * sizeof(float));
+    sw->acc.f_pwr = (int32_t*)_dmsw_alloc(fftsz * sizeof(int32_t));
+    if (!sw->pkt || !sw->cap[0] || !sw->cap[1] || !sw->tw || !sw->wnd || !sw->fbuf ||
+        !sw->pwr || !sw->acc.f_mant || !sw->acc.f_pwr) {
+        _dmsw_free(sw);
+        return -ENOMEM;
+    }
+
+    cfft_twiddles(sw->tw, fftsz);
+    for (unsigned i = 0; i < fftsz; i++) {
+        sw->wnd[i] = 0.5f - 0.5f * cosf(2 * M_PI * i / fftsz);
+        wsum += sw->wnd[i];
+    }
+
+    // Full scale tone reads 0 dBFS
+    sw->corr = -20 * log10(wsum);
+    sw->acc.mine = 1e-20f;
+
+    // Device timestamp counter, same one mdev uses for start skew measurement
+    sw->hw_ts = usdr_device_vfs_obj_val_get_u64(dev->lldev->pdev, "/ll/sync/0/ts", &sw->ts_reg) == 0;
+    if (!sw->hw_ts) {
+        USDR_LOG("DMSW", USDR_LOG_WARNING, "No device timestamp counter, settling is estimated by host time\n");
+    }
+
+    sem_init(&sw->start, 0, 0);
+    sem_init(&sw->done, 0, 0);
+    if (pthread_create(&sw->thread, NULL, _dmsw_worker, sw)) {
+        sem_destroy(&sw->start);
+        sem_destroy(&sw->done);
+        _dmsw_free(sw);
+        return -EFAULT;
+    }
+
+    USDR_LOG("DMSW", USDR_LOG_INFO, "Sweep %.3f - %.3f MHz: %d steps of %.3f MHz, %d bins\n",
+             cfg->start / 1.0e6, cfg->stop / 1.0e6, sw->steps, sw->keep * sw->bin_hz / 1.0e6,
+             usdr_dmsw_bins(sw));
+
+    *sweep = sw;
+    return 0;
+}
+
+int usdr_dmsw_destroy(pusdr_dmsw_t sw)
+{
+    sw->quit = true;
+    sem_post(&sw->start);
+    pthread_join(sw->thread, NULL);
+    sem_destroy(&sw->start);
+    sem_destroy(&sw->done);
+
+    _dmsw_free(sw);
+    return 0;
+}
@@ -0,0 +1,59 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef DM_SWEEP_H
+#define DM_SWEEP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @file dm_sweep.h Pipelined spectrum sweep over a running RX stream */
+#include <usdr_port.h>
+#include "dm_dev.h"
+#include "dm_stream.h"
+
+struct usdr_dmsw;
+typedef struct usdr_dmsw usdr_dmsw_t;
+typedef usdr_dmsw_t* pusdr_dmsw_t;
+
+struct usdr_dmsw_cfg {
+    uint64_t start;       ///< Lower edge of the sweep, Hz
+    uint64_t stop;        ///< Upper edge of the sweep, Hz
+    unsigned rate;        ///< Sample rate of the stream
+    unsigned fftsz;       ///< FFT size, power of 2
+    unsigned averages;    ///< FFTs averaged on every step
+    unsigned settle_us;   ///< LO settling time after retune
+    unsigned usable_pct;  ///< Central part of the band kept on every step, % of rate (1 - 75, 0 selects 75)
+};
+
+struct usdr_dmsw_stat {
+    uint64_t sweep_ns;    ///< Wall time of the last sweep
+    uint64_t hz_per_sec;  ///< Achieved sweep rate
+    uint64_t discarded;   ///< Samples dropped while LO was settling
+    unsigned steps;
+};
+
+/// Create sweep engine on a single channel cf32 RX stream. Stream should be
+/// started before usdr_dmsw_run() and is used exclusively by the engine.
+int usdr_dmsw_create(pdm_dev_t dev, pusdr_dms_t rx,
+                     const struct usdr_dmsw_cfg* cfg,
+                     pusdr_dmsw_t* sweep);
+
+/// Number of bins in the stitched spectrum, first one is at cfg.start
+unsigned usdr_dmsw_bins(pusdr_dmsw_t sweep);
+
+/// Bin width, Hz
+double usdr_dmsw_bin_hz(pusdr_dmsw_t sweep);
+
+/// Perform one sweep, @p spectrum receives usdr_dmsw_bins() power values in dBFS
+int usdr_dmsw_run(pusdr_dmsw_t sweep, float* spectrum,
+                  struct usdr_dmsw_stat* stat);
+
+int usdr_dmsw_destroy(pusdr_dmsw_t sweep);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
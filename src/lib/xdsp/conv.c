@@ -13,6 +13,17 @@
 #include "conv_f32_i12_2.h"
 #include "conv_ci12_2cf32_2.h"
 #include "conv_2cf32_ci12_2.h"
+#include "conv_ci16_ncf32_2.h"
+#include "conv_ci12_ncf32_2.h"
+#include "conv_ci16_nci16_2.h"
+#include "conv_ncf32_ci16_2.h"
+#include "conv_ncf32_ci12_2.h"
+#include "conv_nci16_ci16_2.h"
+#include "conv_ci16_ncf32_stat_2.h"
+#include "conv_ci16_ncf16_2.h"
+#include "conv_ncf16_ci16_2.h"
+#include "conv_ci12_cf16_2.h"
+#include "conv_cf16_ci12_2.h"
 
 #include <strings.h>
 #include <string.h>
@@ -47,6 +58,11 @@ static bool isCF32(const char* s)
     return strcasecmp(s, "cf32") == 0;
 }
 
+static bool isCF16(const char* s)
+{
+    return strcasecmp(s, "cf16") == 0;
+}
+
 static void tr_dummy(const void *__restrict *__restrict indata,
                      unsigned indatabsz,
                      void *__restrict *__restrict outdata,
@@ -89,6 +105,19 @@ static unsigned tr_conv_f32_i16_sz(unsigned inbytes, bool reverse)
     return tr_conv_i16_f32_sz(inbytes, !reverse);
 }
 
+static unsigned tr_conv_i12_f16_sz(unsigned inbytes, bool reverse)
+{
+    if (reverse)
+        return inbytes * 3 / 4;
+    else
+        return inbytes * 4 / 3;
+}
+
+static unsigned tr_conv_f16_i12_sz(unsigned inbytes, bool reverse)
+{
+    return tr_conv_i12_f16_sz(inbytes, !reverse);
+}
+
 static transform_info_t s_tr_none = { NULL, NULL };
 static transform_info_t s_tr_dummy = { tr_dummy, tr_dummy_sz };
 
@@ -102,6 +131,38 @@ transform_info_t get_transform_fn(const char* from,
         return s_tr_none; //TODO!!!! implement transforms for ci16@ci12!
     }
 
+    // Half precision host format, same footprint as ci16 wire data
+    if (isCF16(from) || isCF16(to)) {
+        if (inveccnt == 1 && (outveccnt == 1 || outveccnt == 2) && isCI16(from) && isCF16(to)) {
+            transform_info_t l_conv_ci16_ncf16 = { outveccnt == 2 ? conv_get_ci16_2cf16() : conv_get_ci16_cf16(), tr_dummy_sz };
+            return l_conv_ci16_ncf16;
+        }
+        if ((inveccnt == 1 || inveccnt == 2) && outveccnt == 1 && isCF16(from) && isCI16(to)) {
+            transform_info_t l_conv_ncf16_ci16 = { inveccnt == 2 ? conv_get_2cf16_ci16() : conv_get_cf16_ci16(), tr_dummy_sz };
+            return l_conv_ncf16_ci16;
+        }
+        if (inveccnt == 1 && isCI12(from) && isCF16(to)) {
+            conv_function_t fn = (outveccnt == 1) ? conv_get_ci12_cf16() :
+                                 (outveccnt == 2) ? conv_get_ci12_2cf16() :
+                                 (outveccnt == 4) ? conv_get_ci12_4cf16() :
+                                 (outveccnt == 8) ? conv_get_ci12_8cf16() : NULL;
+            transform_info_t l_conv_ci12_ncf16 = { fn, fn ? tr_conv_i12_f16_sz : NULL };
+            return l_conv_ci12_ncf16;
+        }
+        if (outveccnt == 1 && isCF16(from) && isCI12(to)) {
+            conv_function_t fn = (inveccnt == 1) ? conv_get_cf16_ci12() :
+                                 (inveccnt == 2) ? conv_get_2cf16_ci12() :
+                                 (inveccnt == 4) ? conv_get_4cf16_ci12() :
+                                 (inveccnt == 8) ? conv_get_8cf16_ci12() : NULL;
+            transform_info_t l_conv_ncf16_ci12 = { fn, fn ? tr_conv_f16_i12_sz : NULL };
+            return l_conv_ncf16_ci12;
+        }
+        if (inveccnt == 1 && outveccnt == 1 && isCF16(from) && isCF16(to)) {
+            return s_tr_dummy;
+        }
+        return s_tr_none;
+    }
+
     if (inveccnt == 1 && outveccnt == 2 && isCI16(from) && isCF32(to)) {
         transform_info_t l_conv_ci16_2f32 = { conv_get_ci16_2cf32(), tr_conv_i16_f32_sz };
         return l_conv_ci16_2f32;
@@ -137,6 +198,40 @@ transform_info_t get_transform_fn(const char* from,
         return l_conv_ci12_2f32;
     }
 
+    if (inveccnt == 1 && (outveccnt == 4 || outveccnt == 8)) {
+        bool ch8 = (outveccnt == 8);
+
+        if (isCI16(from) && isCF32(to)) {
+            transform_info_t l_conv_ci16_ncf32 = { ch8 ? conv_get_ci16_8cf32() : conv_get_ci16_4cf32(), tr_conv_i16_f32_sz };
+            return l_conv_ci16_ncf32;
+        }
+        if (isCI12(from) && isCF32(to)) {
+            transform_info_t l_conv_ci12_ncf32 = { ch8 ? conv_get_ci12_8cf32() : conv_get_ci12_4cf32(), tr_conv_i12_f32_sz };
+            return l_conv_ci12_ncf32;
+        }
+        if (isCI16(from) && isCI16(to)) {
+            transform_info_t l_conv_ci16_nci16 = { ch8 ? conv_get_ci16_8ci16() : conv_get_ci16_4ci16(), tr_dummy_sz };
+            return l_conv_ci16_nci16;
+        }
+    }
+
+    if ((inveccnt == 4 || inveccnt == 8) && outveccnt == 1) {
+        bool ch8 = (inveccnt == 8);
+
+        if (isCF32(from) && isCI16(to)) {
+            transform_info_t l_conv_ncf32_ci16 = { ch8 ? conv_get_8cf32_ci16() : conv_get_4cf32_ci16(), tr_conv_f32_i16_sz };
+            return l_conv_ncf32_ci16;
+        }
+        if (isCF32(from) && isCI12(to)) {
+            transform_info_t l_conv_ncf32_ci12 = { ch8 ? conv_get_8cf32_ci12() : conv_get_4cf32_ci12(), tr_conv_f32_i12_sz };
+            return l_conv_ncf32_ci12;
+        }
+        if (isCI16(from) && isCI16(to)) {
+            transform_info_t l_conv_nci16_ci16 = { ch8 ? conv_get_8ci16_ci16() : conv_get_4ci16_ci16(), tr_dummy_sz };
+            return l_conv_nci16_ci16;
+        }
+    }
+
     if (inveccnt != 1 || outveccnt != 1)
         return s_tr_none;
 
@@ -171,3 +266,15 @@ bool is_transform_dummy(conv_function_t t)
 {
     return t == tr_dummy;
 }
+
+conv_stat_function_t get_stat_transform_fn(const char* from,
+                                           const char* to,
+                                           unsigned inveccnt,
+                                           unsigned outveccnt)
+{
+    if (inveccnt == 1 && isCI16(from) && isCF32(to)) {
+        return conv_get_ci16_ncf32_stat(outveccnt);
+    }
+
+    return NULL;
+}
@@ -67,6 +67,21 @@ typedef void (*filter_function_t)(const int16_t *__restrict data,
                        unsigned outdatabsz) \
    { conv_fn(indata[0], indata[1], indatabsz, outdata[0], outdatabsz); }
 
+// N-channel (de)interleavers take the whole array of channel pointers
+#define DECLARE_TR_FUNC_1_N(conv_fn) \
+    void tr_##conv_fn (const void *__restrict *__restrict indata, \
+                       unsigned indatabsz, \
+                       void *__restrict *__restrict outdata, \
+                       unsigned outdatabsz) \
+   { conv_fn(*indata, indatabsz, outdata, outdatabsz); }
+
+#define DECLARE_TR_FUNC_N_1(conv_fn) \
+    void tr_##conv_fn (const void *__restrict *__restrict indata, \
+                       unsigned indatabsz, \
+                       void *__restrict *__restrict outdata, \
+                       unsigned outdatabsz) \
+   { conv_fn(indata, indatabsz, *outdata, outdatabsz); }
+
 struct transform_info {
     conv_function_t cfunc;
     size_function_t sfunc;
@@ -80,6 +95,37 @@ transform_info_t get_transform_fn(const char* from,
 
 bool is_transform_dummy(conv_function_t t);
 
+// Per-channel signal statistics accumulated by RX conversion
+struct conv_ch_stat {
+    int64_t  sum_i;     // sum of I samples
+    int64_t  sum_q;     // sum of Q samples
+    uint64_t sum_sq;    // sum of I^2 + Q^2
+    uint32_t peak;      // max(|I|, |Q|)
+    uint32_t clips;     // I or Q components at full scale
+};
+typedef struct conv_ch_stat conv_ch_stat_t;
+
+// Same as conv_function_t, statistics are added to stat[outveccnt]
+typedef void (*conv_stat_function_t)(const void *__restrict *__restrict indata,
+                                     unsigned indatabsz,
+                                     void *__restrict *__restrict outdata,
+                                     unsigned outdatabsz,
+                                     conv_ch_stat_t *__restrict stat);
+
+#define DECLARE_TR_FUNC_1_N_STAT(conv_fn) \
+    void tr_##conv_fn (const void *__restrict *__restrict indata, \
+                       unsigned indatabsz, \
+                       void *__restrict *__restrict outdata, \
+                       unsigned outdatabsz, \
+                       conv_ch_stat_t *__restrict stat) \
+   { conv_fn(*indata, indatabsz, outdata, outdatabsz, stat); }
+
+// Conversion with statistics, NULL when not available for the format
+conv_stat_function_t get_stat_transform_fn(const char* from,
+                                           const char* to,
+                                           unsigned inveccnt,
+                                           unsigned outveccnt);
+
 #define DECLARE_TR_FUNC_FILTER(conv_fn) \
 void tr_##conv_fn (const int16_t *__restrict data, \
                    const int16_t *__restrict conv, \
@@ -108,9 +154,11 @@ typedef void (*fftad_add_function_t)
 typedef void (*fftad_add_hwi16_function_t)
     (fft_acc_t* __restrict p, uint16_t * __restrict d, unsigned fftsz);
 
+// log2_degree - accuracy of log2 approximation, see wvlt_log2f_deg()
 typedef void (*fftad_norm_function_t)
+    (fft_acc_t* __restrict p, unsigned fftsz, float scale, float corr, float* __restrict outa, unsigned log2_degree);
+typedef void (*fftad_norm_hwi16_function_t)
     (fft_acc_t* __restrict p, unsigned fftsz, float scale, float corr, float* __restrict outa);
-typedef fftad_norm_function_t fftad_norm_hwi16_function_t;
 
 #define DECLARE_TR_FUNC_FFTAD_INIT(conv_fn) \
 void tr_##conv_fn (fft_acc_t* __restrict p,  unsigned fftsz) \
@@ -127,11 +175,13 @@ void tr_##conv_fn (fft_acc_t* __restrict p, uint16_t * __restrict d, unsigned ff
 { conv_fn(p, d, fftsz); }
 
 #define DECLARE_TR_FUNC_FFTAD_NORM(conv_fn) \
+void tr_##conv_fn (fft_acc_t* __restrict p, unsigned fftsz, float scale, float corr, float* __restrict outa, unsigned log2_degree) \
+{ conv_fn(p, fftsz, scale, corr, outa, log2_degree); }
+
+#define DECLARE_TR_FUNC_FFTAD_NORM_HWI16(conv_fn) \
 void tr_##conv_fn (fft_acc_t* __restrict p, unsigned fftsz, float scale, float corr, float* __restrict outa) \
 { conv_fn(p, fftsz, scale, corr, outa); }
 
-#define DECLARE_TR_FUNC_FFTAD_NORM_HWI16(conv_fn) DECLARE_TR_FUNC_FFTAD_NORM(conv_fn)
-
 // RTSA
 
 struct fft_rtsa_settings
@@ -179,16 +229,17 @@ struct fft_diap
 };
 typedef struct fft_diap fft_diap_t;
 
+// log2_degree - accuracy of log2 approximation, see wvlt_log2f_deg()
 typedef void (*rtsa_update_function_t)
     (   wvlt_fftwf_complex* __restrict in, unsigned fft_size,
         fft_rtsa_data_t* __restrict rtsa_data,
-        float fcale_mpy, float mine, float corr, fft_diap_t diap);
+        float fcale_mpy, float mine, float corr, fft_diap_t diap, unsigned log2_degree);
 
 #define DECLARE_TR_FUNC_RTSA_UPDATE(conv_fn) \
 void tr_##conv_fn (wvlt_fftwf_complex* __restrict in, unsigned fft_size, \
                    fft_rtsa_data_t* __restrict rtsa_data, \
-                   float fcale_mpy, float mine, float corr, fft_diap_t diap) \
-{ conv_fn( in, fft_size, rtsa_data, fcale_mpy, mine, corr, diap ); }
+                   float fcale_mpy, float mine, float corr, fft_diap_t diap, unsigned log2_degree) \
+{ conv_fn( in, fft_size, rtsa_data, fcale_mpy, mine, corr, diap, log2_degree ); }
 
 
 typedef void (*rtsa_update_hwi16_function_t)
@@ -213,4 +264,36 @@ void tr_##conv_fn (wvlt_fftwf_complex* __restrict in, unsigned fftsz, float* __r
                    wvlt_fftwf_complex* __restrict out) \
 { conv_fn(in, fftsz, wnd, out); }
 
+// Triggered capture detectors
+
+// |x|^2 of every cf32 sample
+typedef void (*detector_power_cf32_function_t)
+    (const float* __restrict in, unsigned count, float* __restrict out);
+
+// Normalized cross-correlation |sum(x[n+k] * conj(p[k]))|^2 / sum(|x[n+k]|^2), k = 0..plen-1
+// for n = 0..count-1, preamble should have unit energy so the metric is in [0, 1];
+// @p in holds count + plen - 1 samples
+typedef void (*detector_xcorr_cf32_function_t)
+    (const float* __restrict in, unsigned count, const float* __restrict pre, unsigned plen,
+     float* __restrict out);
+
+// Find first metric crossing of @p thr_on, detector is rearmed after metric falls below @p thr_off.
+// Returns index of the trigger or @p count when there is none, @p armed keeps the state between calls
+typedef unsigned (*detector_scan_f32_function_t)
+    (const float* __restrict m, unsigned count, float thr_on, float thr_off, unsigned* __restrict armed);
+
+#define DECLARE_TR_FUNC_DETECTOR_POWER_CF32(conv_fn) \
+void tr_##conv_fn (const float* __restrict in, unsigned count, float* __restrict out) \
+{ conv_fn(in, count, out); }
+
+#define DECLARE_TR_FUNC_DETECTOR_XCORR_CF32(conv_fn) \
+void tr_##conv_fn (const float* __restrict in, unsigned count, const float* __restrict pre, unsigned plen, \
+                   float* __restrict out) \
+{ conv_fn(in, count, pre, plen, out); }
+
+#define DECLARE_TR_FUNC_DETECTOR_SCAN_F32(conv_fn) \
+unsigned tr_##conv_fn (const float* __restrict m, unsigned count, float thr_on, float thr_off, \
+                       unsigned* __restrict armed) \
+{ return conv_fn(m, count, thr_on, thr_off, armed); }
+
 #endif
@@ -0,0 +1,121 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include "conv_cf16_ci12_2.h"
+#include "attribute_switch.h"
+#include "fp16_inline.h"
+
+#define CONV_SCALE (1.0f/32767)
+
+#define TEMPLATE_FUNC_NAME conv_cf16_ci12_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_cf16_ci12_generic.t"
+DECLARE_TR_FUNC_1_1(conv_cf16_ci12_generic)
+
+#ifdef WVLT_AVX2
+#define TEMPLATE_FUNC_NAME conv_cf16_ci12_avx2
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx2,f16c"))
+#include "templates/conv_cf16_ci12_avx2.t"
+DECLARE_TR_FUNC_1_1(conv_cf16_ci12_avx2)
+#endif
+
+#ifdef WVLT_NEON
+#define TEMPLATE_FUNC_NAME conv_cf16_ci12_neon
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_cf16_ci12_neon.t"
+DECLARE_TR_FUNC_1_1(conv_cf16_ci12_neon)
+#endif
+
+// Multichannel variants, generic only
+#define CHCNT 2
+
+#define TEMPLATE_FUNC_NAME conv_2cf16_ci12_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ncf16_ci12_generic.t"
+DECLARE_TR_FUNC_N_1(conv_2cf16_ci12_generic)
+
+#undef CHCNT
+
+#define CHCNT 4
+
+#define TEMPLATE_FUNC_NAME conv_4cf16_ci12_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ncf16_ci12_generic.t"
+DECLARE_TR_FUNC_N_1(conv_4cf16_ci12_generic)
+
+#undef CHCNT
+
+#define CHCNT 8
+
+#define TEMPLATE_FUNC_NAME conv_8cf16_ci12_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ncf16_ci12_generic.t"
+DECLARE_TR_FUNC_N_1(conv_8cf16_ci12_generic)
+
+#undef CHCNT
+
+conv_function_t conv_get_cf16_ci12_c(generic_opts_t cpu_cap, const char** sfunc)
+{
+    const char* fname;
+    conv_function_t fn;
+
+    SELECT_GENERIC_FN(fn, fname, tr_conv_cf16_ci12_generic, cpu_cap);
+    SELECT_AVX2_FN(fn, fname, tr_conv_cf16_ci12_avx2, cpu_cap);
+    SELECT_NEON_FN(fn, fname, tr_conv_cf16_ci12_neon, cpu_cap);
+
+    if (sfunc) *sfunc = fname;
+    return fn;
+}
+
+conv_function_t conv_get_cf16_ci12()
+{
+    return conv_get_cf16_ci12_c(cpu_vcap_get(), NULL);
+}
+
+conv_function_t conv_get_2cf16_ci12_c(generic_opts_t cpu_cap, const char** sfunc)
+{
+    const char* fname;
+    conv_function_t fn;
+
+    SELECT_GENERIC_FN(fn, fname, tr_conv_2cf16_ci12_generic, cpu_cap);
+
+    if (sfunc) *sfunc = fname;
+    return fn;
+}
+
+conv_function_t conv_get_2cf16_ci12()
+{
+    return conv_get_2cf16_ci12_c(cpu_vcap_get(), NULL);
+}
+
+conv_function_t conv_get_4cf16_ci12_c(generic_opts_t cpu_cap, const char** sfunc)
+{
+    const char* fname;
+    conv_function_t fn;
+
+    SELECT_GENERIC_FN(fn, fname, tr_conv_4cf16_ci12_generic, cpu_cap);
+
+    if (sfunc) *sfunc = fname;
+    return fn;
+}
+
+conv_function_t conv_get_4cf16_ci12()
+{
+    return conv_get_4cf16_ci12_c(cpu_vcap_get(), NULL);
+}
+
+conv_function_t conv_get_8cf16_ci12_c(generic_opts_t cpu_cap, const char** sfunc)
+{
+    const char* fname;
+    conv_function_t fn;
+
+    SELECT_GENERIC_FN(fn, fname, tr_conv_8cf16_ci12_generic, cpu_cap);
+
+    if (sfunc) *sfunc = fname;
+    return fn;
+}
+
+conv_function_t conv_get_8cf16_ci12()
+{
+    return conv_get_8cf16_ci12_c(cpu_vcap_get(), NULL);
+}
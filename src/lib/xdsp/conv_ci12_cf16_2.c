@@ -0,0 +1,121 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include "conv_ci12_cf16_2.h"
+#include "attribute_switch.h"
+#include "fp16_inline.h"
+
+#define CONV_SCALE (1.0f/32767)
+
+#define TEMPLATE_FUNC_NAME conv_ci12_cf16_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ci12_cf16_generic.t"
+DECLARE_TR_FUNC_1_1(conv_ci12_cf16_generic)
+
+#ifdef WVLT_AVX2
+#define TEMPLATE_FUNC_NAME conv_ci12_cf16_avx2
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx2,f16c"))
+#include "templates/conv_ci12_cf16_avx2.t"
+DECLARE_TR_FUNC_1_1(conv_ci12_cf16_avx2)
+#endif
+
+#ifdef WVLT_NEON
+#define TEMPLATE_FUNC_NAME conv_ci12_cf16_neon
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ci12_cf16_neon.t"
+DECLARE_TR_FUNC_1_1(conv_ci12_cf16_neon)
+#endif
+
+// Multichannel variants, generic only
+#define CHCNT 2
+
+#define TEMPLATE_FUNC_NAME conv_ci12_2cf16_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ci12_ncf16_generic.t"
+DECLARE_TR_FUNC_1_N(conv_ci12_2cf16_generic)
+
+#undef CHCNT
+
+#define CHCNT 4
+
+#define TEMPLATE_FUNC_NAME conv_ci12_4cf16_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ci12_ncf16_generic.t"
+DECLARE_TR_FUNC_1_N(conv_ci12_4cf16_generic)
+
+#undef CHCNT
+
+#define CHCNT 8
+
+#define TEMPLATE_FUNC_NAME conv_ci12_8cf16_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ci12_ncf16_generic.t"
+DECLARE_TR_FUNC_1_N(conv_ci12_8cf16_generic)
+
+#undef CHCNT
+
+conv_function_t conv_get_ci12_cf16_c(generic_opts_t cpu_cap, const char** sfunc)
+{
+    const char* fname;
+    conv_function_t fn;
+
+    SELECT_GENERIC_FN(fn, fname, tr_conv_ci12_cf16_generic, cpu_cap);
+    SELECT_AVX2_FN(fn, fname, tr_conv_ci12_cf16_avx2, cpu_cap);
+    SELECT_NEON_FN(fn, fname, tr_conv_ci12_cf16_neon, cpu_cap);
+
+    if (sfunc) *sfunc = fname;
+    return fn;
+}
+
+conv_function_t conv_get_ci12_cf16()
+{
+    return conv_get_ci12_cf16_c(cpu_vcap_get(), NULL);
+}
+
+conv_function_t conv_get_ci12_2cf16_c(generic_opts_t cpu_cap, const char** sfunc)
+{
+    const char* fname;
+    conv_function_t fn;
+
+    SELECT_GENERIC_FN(fn, fname, tr_conv_ci12_2cf16_generic, cpu_cap);
+
+    if (sfunc) *sfunc = fname;
+    return fn;
+}
+
+conv_function_t conv_get_ci12_2cf16()
+{
+    return conv_get_ci12_2cf16_c(cpu_vcap_get(), NULL);
+}
+
+conv_function_t conv_get_ci12_4cf16_c(generic_opts_t cpu_cap, const char** sfunc)
+{
+    const char* fname;
+    conv_function_t fn;
+
+    SELECT_GENERIC_FN(fn, fname, tr_conv_ci12_4cf16_generic, cpu_cap);
+
+    if (sfunc) *sfunc = fname;
+    return fn;
+}
+
+conv_function_t conv_get_ci12_4cf16()
+{
+    return conv_get_ci12_4cf16_c(cpu_vcap_get(), NULL);
+}
+
+conv_function_t conv_get_ci12_8cf16_c(generic_opts_t cpu_cap, const char** sfunc)
+{
+    const char* fname;
+    conv_function_t fn;
+
+    SELECT_GENERIC_FN(fn, fname, tr_conv_ci12_8cf16_generic, cpu_cap);
+
+    if (sfunc) *sfunc = fname;
+    return fn;
+}
+
+conv_function_t conv_get_ci12_8cf16()
+{
+    return conv_get_ci12_8cf16_c(cpu_vcap_get(), NULL);
+}
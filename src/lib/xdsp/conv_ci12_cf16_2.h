@@ -0,0 +1,21 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef CONV_CI12_CF16_H
+#define CONV_CI12_CF16_H
+
+#include "conv.h"
+
+conv_function_t conv_get_ci12_cf16();
+conv_function_t conv_get_ci12_cf16_c(generic_opts_t cpu_cap, const char **sfunc);
+
+conv_function_t conv_get_ci12_2cf16();
+conv_function_t conv_get_ci12_2cf16_c(generic_opts_t cpu_cap, const char **sfunc);
+
+conv_function_t conv_get_ci12_4cf16();
+conv_function_t conv_get_ci12_4cf16_c(generic_opts_t cpu_cap, const char **sfunc);
+
+conv_function_t conv_get_ci12_8cf16();
+conv_function_t conv_get_ci12_8cf16_c(generic_opts_t cpu_cap, const char **sfunc);
+
+#endif
@@ -0,0 +1,121 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include "conv_ci12_ncf32_2.h"
+#include "attribute_switch.h"
+
+#define CONV_SCALE (1.0f/32767)
+
+#define CHCNT 4
+
+#define TEMPLATE_FUNC_NAME conv_ci12_4cf32_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ci12_ncf32_generic.t"
+DECLARE_TR_FUNC_1_N(conv_ci12_4cf32_generic)
+
+#ifdef WVLT_SSSE3
+#define TEMPLATE_FUNC_NAME conv_ci12_4cf32_ssse3
+VWLT_ATTRIBUTE(optimize("-O3"), target("ssse3"))
+#include "templates/conv_ci12_ncf32_ssse3.t"
+DECLARE_TR_FUNC_1_N(conv_ci12_4cf32_ssse3)
+#endif
+
+#ifdef WVLT_AVX
+#define TEMPLATE_FUNC_NAME conv_ci12_4cf32_avx
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx"))
+#include "templates/conv_ci12_ncf32_ssse3.t"
+DECLARE_TR_FUNC_1_N(conv_ci12_4cf32_avx)
+#endif
+
+#ifdef WVLT_AVX2
+#define TEMPLATE_FUNC_NAME conv_ci12_4cf32_avx2
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx2"))
+#include "templates/conv_ci12_ncf32_avx2.t"
+DECLARE_TR_FUNC_1_N(conv_ci12_4cf32_avx2)
+#endif
+
+#ifdef WVLT_NEON
+#define TEMPLATE_FUNC_NAME conv_ci12_4cf32_neon
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ci12_ncf32_neon.t"
+DECLARE_TR_FUNC_1_N(conv_ci12_4cf32_neon)
+#endif
+
+#undef CHCNT
+
+#define CHCNT 8
+
+#define TEMPLATE_FUNC_NAME conv_ci12_8cf32_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ci12_ncf32_generic.t"
+DECLARE_TR_FUNC_1_N(conv_ci12_8cf32_generic)
+
+#ifdef WVLT_SSSE3
+#define TEMPLATE_FUNC_NAME conv_ci12_8cf32_ssse3
+VWLT_ATTRIBUTE(optimize("-O3"), target("ssse3"))
+#include "templates/conv_ci12_ncf32_ssse3.t"
+DECLARE_TR_FUNC_1_N(conv_ci12_8cf32_ssse3)
+#endif
+
+#ifdef WVLT_AVX
+#define TEMPLATE_FUNC_NAME conv_ci12_8cf32_avx
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx"))
+#include "templates/conv_ci12_ncf32_ssse3.t"
+DECLARE_TR_FUNC_1_N(conv_ci12_8cf32_avx)
+#endif
+
+#ifdef WVLT_AVX2
+#define TEMPLATE_FUNC_NAME conv_ci12_8cf32_avx2
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx2"))
+#include "templates/conv_ci12_ncf32_avx2.t"
+DECLARE_TR_FUNC_1_N(conv_ci12_8cf32_avx2)
+#endif
+
+#ifdef WVLT_NEON
+#define TEMPLATE_FUNC_NAME conv_ci12_8cf32_neon
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ci12_ncf32_neon.t"
+DECLARE_TR_FUNC_1_N(conv_ci12_8cf32_neon)
+#endif
+
+#undef CHCNT
+
+conv_function_t conv_get_ci12_4cf32_c(generic_opts_t cpu_cap, const char** sfunc)
+{
+    const char* fname;
+    conv_function_t fn;
+
+    SELECT_GENERIC_FN(fn, fname, tr_conv_ci12_4cf32_generic, cpu_cap);
+    SELECT_SSSE3_FN(fn, fname, tr_conv_ci12_4cf32_ssse3, cpu_cap);
+    SELECT_AVX_FN(fn, fname, tr_conv_ci12_4cf32_avx, cpu_cap);
+    SELECT_AVX2_FN(fn, fname, tr_conv_ci12_4cf32_avx2, cpu_cap);
+    SELECT_NEON_FN(fn, fname, tr_conv_ci12_4cf32_neon, cpu_cap);
+
+    if (sfunc) *sfunc = fname;
+    return fn;
+}
+
+conv_function_t conv_get_ci12_4cf32()
+{
+    return conv_get_ci12_4cf32_c(cpu_vcap_get(), NULL);
+}
+
+conv_function_t conv_get_ci12_8cf32_c(generic_opts_t cpu_cap, const char** sfunc)
+{
+    const char* fname;
+    conv_function_t fn;
+
+    SELECT_GENERIC_FN(fn, fname, tr_conv_ci12_8cf32_generic, cpu_cap);
+    SELECT_SSSE3_FN(fn, fname, tr_conv_ci12_8cf32_ssse3, cpu_cap);
+    SELECT_AVX_FN(fn, fname, tr_conv_ci12_8cf32_avx, cpu_cap);
+    SELECT_AVX2_FN(fn, fname, tr_conv_ci12_8cf32_avx2, cpu_cap);
+    SELECT_NEON_FN(fn, fname, tr_conv_ci12_8cf32_neon, cpu_cap);
+
+    if (sfunc) *sfunc = fname;
+    return fn;
+}
+
+conv_function_t conv_get_ci12_8cf32()
+{
+    return conv_get_ci12_8cf32_c(cpu_vcap_get(), NULL);
+}
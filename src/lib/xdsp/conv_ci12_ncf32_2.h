@@ -0,0 +1,15 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef CONV_CI12_NCF32_H
+#define CONV_CI12_NCF32_H
+
+#include "conv.h"
+
+conv_function_t conv_get_ci12_4cf32();
+conv_function_t conv_get_ci12_4cf32_c(generic_opts_t cpu_cap, const char **sfunc);
+
+conv_function_t conv_get_ci12_8cf32();
+conv_function_t conv_get_ci12_8cf32_c(generic_opts_t cpu_cap, const char **sfunc);
+
+#endif
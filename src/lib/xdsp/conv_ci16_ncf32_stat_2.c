@@ -0,0 +1,267 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include "conv_ci16_ncf32_stat_2.h"
+#include "attribute_switch.h"
+
+#define CONV_SCALE (1.0f/32767)
+#define CONV_CLIP  32767
+
+// Iterations between flushes of 32-bit I/Q sum accumulators
+#define STAT_CHUNK 8192
+
+static inline void ci16_stat_update(conv_ch_stat_t* s, int a, int b)
+{
+    unsigned aa = (a < 0) ? -a : a;
+    unsigned ab = (b < 0) ? -b : b;
+    unsigned pk = (aa > ab) ? aa : ab;
+
+    if (s->peak < pk)
+        s->peak = pk;
+
+    s->clips += (aa >= CONV_CLIP) + (ab >= CONV_CLIP);
+    s->sum_i += a;
+    s->sum_q += b;
+    s->sum_sq += (uint32_t)(a * a) + (uint32_t)(b * b);
+}
+
+static inline void ci16_stat_fold(conv_ch_stat_t* s, int64_t si, int64_t sq, uint64_t ssq,
+                                  unsigned pi, unsigned pq, unsigned clips)
+{
+    unsigned pk = (pi > pq) ? pi : pq;
+
+    if (s->peak < pk)
+        s->peak = pk;
+
+    s->clips += clips;
+    s->sum_i += si;
+    s->sum_q += sq;
+    s->sum_sq += ssq;
+}
+
+#define CHCNT 1
+
+#define TEMPLATE_FUNC_NAME conv_ci16_1cf32_stat_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ci16_ncf32_stat_generic.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_1cf32_stat_generic)
+
+#ifdef WVLT_SSE2
+#define TEMPLATE_FUNC_NAME conv_ci16_1cf32_stat_sse2
+VWLT_ATTRIBUTE(optimize("-O3"), target("sse2"))
+#include "templates/conv_ci16_ncf32_stat_sse2.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_1cf32_stat_sse2)
+#endif
+
+#ifdef WVLT_SSE4_1
+#define TEMPLATE_FUNC_NAME conv_ci16_1cf32_stat_sse41
+VWLT_ATTRIBUTE(optimize("-O3"), target("sse4.1"))
+#include "templates/conv_ci16_ncf32_stat_sse41.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_1cf32_stat_sse41)
+#endif
+
+#ifdef WVLT_AVX
+#define TEMPLATE_FUNC_NAME conv_ci16_1cf32_stat_avx
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx"))
+#include "templates/conv_ci16_ncf32_stat_sse41.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_1cf32_stat_avx)
+#endif
+
+#ifdef WVLT_AVX2
+#define TEMPLATE_FUNC_NAME conv_ci16_1cf32_stat_avx2
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx2"))
+#include "templates/conv_ci16_ncf32_stat_avx2.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_1cf32_stat_avx2)
+#endif
+
+#ifdef WVLT_NEON
+#define TEMPLATE_FUNC_NAME conv_ci16_1cf32_stat_neon
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ci16_ncf32_stat_neon.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_1cf32_stat_neon)
+#endif
+
+#undef CHCNT
+
+#define CHCNT 2
+
+#define TEMPLATE_FUNC_NAME conv_ci16_2cf32_stat_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ci16_ncf32_stat_generic.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_2cf32_stat_generic)
+
+#ifdef WVLT_SSE2
+#define TEMPLATE_FUNC_NAME conv_ci16_2cf32_stat_sse2
+VWLT_ATTRIBUTE(optimize("-O3"), target("sse2"))
+#include "templates/conv_ci16_ncf32_stat_sse2.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_2cf32_stat_sse2)
+#endif
+
+#ifdef WVLT_SSE4_1
+#define TEMPLATE_FUNC_NAME conv_ci16_2cf32_stat_sse41
+VWLT_ATTRIBUTE(optimize("-O3"), target("sse4.1"))
+#include "templates/conv_ci16_ncf32_stat_sse41.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_2cf32_stat_sse41)
+#endif
+
+#ifdef WVLT_AVX
+#define TEMPLATE_FUNC_NAME conv_ci16_2cf32_stat_avx
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx"))
+#include "templates/conv_ci16_ncf32_stat_sse41.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_2cf32_stat_avx)
+#endif
+
+#ifdef WVLT_AVX2
+#define TEMPLATE_FUNC_NAME conv_ci16_2cf32_stat_avx2
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx2"))
+#include "templates/conv_ci16_ncf32_stat_avx2.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_2cf32_stat_avx2)
+#endif
+
+#ifdef WVLT_NEON
+#define TEMPLATE_FUNC_NAME conv_ci16_2cf32_stat_neon
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ci16_ncf32_stat_neon.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_2cf32_stat_neon)
+#endif
+
+#undef CHCNT
+
+#define CHCNT 4
+
+#define TEMPLATE_FUNC_NAME conv_ci16_4cf32_stat_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ci16_ncf32_stat_generic.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_4cf32_stat_generic)
+
+#ifdef WVLT_SSE2
+#define TEMPLATE_FUNC_NAME conv_ci16_4cf32_stat_sse2
+VWLT_ATTRIBUTE(optimize("-O3"), target("sse2"))
+#include "templates/conv_ci16_ncf32_stat_sse2.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_4cf32_stat_sse2)
+#endif
+
+#ifdef WVLT_SSE4_1
+#define TEMPLATE_FUNC_NAME conv_ci16_4cf32_stat_sse41
+VWLT_ATTRIBUTE(optimize("-O3"), target("sse4.1"))
+#include "templates/conv_ci16_ncf32_stat_sse41.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_4cf32_stat_sse41)
+#endif
+
+#ifdef WVLT_AVX
+#define TEMPLATE_FUNC_NAME conv_ci16_4cf32_stat_avx
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx"))
+#include "templates/conv_ci16_ncf32_stat_sse41.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_4cf32_stat_avx)
+#endif
+
+#ifdef WVLT_AVX2
+#define TEMPLATE_FUNC_NAME conv_ci16_4cf32_stat_avx2
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx2"))
+#include "templates/conv_ci16_ncf32_stat_avx2.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_4cf32_stat_avx2)
+#endif
+
+#ifdef WVLT_NEON
+#define TEMPLATE_FUNC_NAME conv_ci16_4cf32_stat_neon
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ci16_ncf32_stat_neon.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_4cf32_stat_neon)
+#endif
+
+#undef CHCNT
+
+#define CHCNT 8
+
+#define TEMPLATE_FUNC_NAME conv_ci16_8cf32_stat_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ci16_ncf32_stat_generic.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_8cf32_stat_generic)
+
+#ifdef WVLT_SSE2
+#define TEMPLATE_FUNC_NAME conv_ci16_8cf32_stat_sse2
+VWLT_ATTRIBUTE(optimize("-O3"), target("sse2"))
+#include "templates/conv_ci16_ncf32_stat_sse2.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_8cf32_stat_sse2)
+#endif
+
+#ifdef WVLT_SSE4_1
+#define TEMPLATE_FUNC_NAME conv_ci16_8cf32_stat_sse41
+VWLT_ATTRIBUTE(optimize("-O3"), target("sse4.1"))
+#include "templates/conv_ci16_ncf32_stat_sse41.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_8cf32_stat_sse41)
+#endif
+
+#ifdef WVLT_AVX
+#define TEMPLATE_FUNC_NAME conv_ci16_8cf32_stat_avx
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx"))
+#include "templates/conv_ci16_ncf32_stat_sse41.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_8cf32_stat_avx)
+#endif
+
+#ifdef WVLT_AVX2
+#define TEMPLATE_FUNC_NAME conv_ci16_8cf32_stat_avx2
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx2"))
+#include "templates/conv_ci16_ncf32_stat_avx2.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_8cf32_stat_avx2)
+#endif
+
+#ifdef WVLT_NEON
+#define TEMPLATE_FUNC_NAME conv_ci16_8cf32_stat_neon
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ci16_ncf32_stat_neon.t"
+DECLARE_TR_FUNC_1_N_STAT(conv_ci16_8cf32_stat_neon)
+#endif
+
+#undef CHCNT
+
+conv_stat_function_t conv_get_ci16_ncf32_stat_c(unsigned chcnt, generic_opts_t cpu_cap, const char** sfunc)
+{
+    const char* fname = NULL;
+    conv_stat_function_t fn = NULL;
+
+    switch (chcnt) {
+    case 1:
+        SELECT_GENERIC_FN(fn, fname, tr_conv_ci16_1cf32_stat_generic, cpu_cap);
+        SELECT_SSE2_FN(fn, fname, tr_conv_ci16_1cf32_stat_sse2, cpu_cap);
+        SELECT_SSE4_1_FN(fn, fname, tr_conv_ci16_1cf32_stat_sse41, cpu_cap);
+        SELECT_AVX_FN(fn, fname, tr_conv_ci16_1cf32_stat_avx, cpu_cap);
+        SELECT_AVX2_FN(fn, fname, tr_conv_ci16_1cf32_stat_avx2, cpu_cap);
+        SELECT_NEON_FN(fn, fname, tr_conv_ci16_1cf32_stat_neon, cpu_cap);
+        break;
+    case 2:
+        SELECT_GENERIC_FN(fn, fname, tr_conv_ci16_2cf32_stat_generic, cpu_cap);
+        SELECT_SSE2_FN(fn, fname, tr_conv_ci16_2cf32_stat_sse2, cpu_cap);
+        SELECT_SSE4_1_FN(fn, fname, tr_conv_ci16_2cf32_stat_sse41, cpu_cap);
+        SELECT_AVX_FN(fn, fname, tr_conv_ci16_2cf32_stat_avx, cpu_cap);
+        SELECT_AVX2_FN(fn, fname, tr_conv_ci16_2cf32_stat_avx2, cpu_cap);
+        SELECT_NEON_FN(fn, fname, tr_conv_ci16_2cf32_stat_neon, cpu_cap);
+        break;
+    case 4:
+        SELECT_GENERIC_FN(fn, fname, tr_conv_ci16_4cf32_stat_generic, cpu_cap);
+        SELECT_SSE2_FN(fn, fname, tr_conv_ci16_4cf32_stat_sse2, cpu_cap);
+        SELECT_SSE4_1_FN(fn, fname, tr_conv_ci16_4cf32_stat_sse41, cpu_cap);
+        SELECT_AVX_FN(fn, fname, tr_conv_ci16_4cf32_stat_avx, cpu_cap);
+        SELECT_AVX2_FN(fn, fname, tr_conv_ci16_4cf32_stat_avx2, cpu_cap);
+        SELECT_NEON_FN(fn, fname, tr_conv_ci16_4cf32_stat_neon, cpu_cap);
+        break;
+    case 8:
+        SELECT_GENERIC_FN(fn, fname, tr_conv_ci16_8cf32_stat_generic, cpu_cap);
+        SELECT_SSE2_FN(fn, fname, tr_conv_ci16_8cf32_stat_sse2, cpu_cap);
+        SELECT_SSE4_1_FN(fn, fname, tr_conv_ci16_8cf32_stat_sse41, cpu_cap);
+        SELECT_AVX_FN(fn, fname, tr_conv_ci16_8cf32_stat_avx, cpu_cap);
+        SELECT_AVX2_FN(fn, fname, tr_conv_ci16_8cf32_stat_avx2, cpu_cap);
+        SELECT_NEON_FN(fn, fname, tr_conv_ci16_8cf32_stat_neon, cpu_cap);
+        break;
+    default:
+        break;
+    }
+
+    if (sfunc) *sfunc = fname;
+    return fn;
+}
+
+conv_stat_function_t conv_get_ci16_ncf32_stat(unsigned chcnt)
+{
+    return conv_get_ci16_ncf32_stat_c(chcnt, cpu_vcap_get(), NULL);
+}
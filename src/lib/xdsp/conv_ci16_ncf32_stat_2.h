@@ -0,0 +1,13 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef CONV_CI16_NCF32_STAT_H
+#define CONV_CI16_NCF32_STAT_H
+
+#include "conv.h"
+
+// ci16 -> chcnt x cf32 (chcnt = 1, 2, 4 or 8) gathering per channel statistics
+conv_stat_function_t conv_get_ci16_ncf32_stat(unsigned chcnt);
+conv_stat_function_t conv_get_ci16_ncf32_stat_c(unsigned chcnt, generic_opts_t cpu_cap, const char **sfunc);
+
+#endif
@@ -0,0 +1,91 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include "conv_ncf16_ci16_2.h"
+#include "attribute_switch.h"
+#include "fp16_inline.h"
+
+#define CONV_SCALE (1.0f/32767)
+
+#define CHCNT 1
+
+#define TEMPLATE_FUNC_NAME conv_cf16_ci16_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ncf16_ci16_generic.t"
+DECLARE_TR_FUNC_N_1(conv_cf16_ci16_generic)
+
+#ifdef WVLT_AVX2
+#define TEMPLATE_FUNC_NAME conv_cf16_ci16_avx2
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx2,f16c"))
+#include "templates/conv_ncf16_ci16_avx2.t"
+DECLARE_TR_FUNC_N_1(conv_cf16_ci16_avx2)
+#endif
+
+#ifdef WVLT_NEON
+#define TEMPLATE_FUNC_NAME conv_cf16_ci16_neon
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ncf16_ci16_neon.t"
+DECLARE_TR_FUNC_N_1(conv_cf16_ci16_neon)
+#endif
+
+#undef CHCNT
+
+#define CHCNT 2
+
+#define TEMPLATE_FUNC_NAME conv_2cf16_ci16_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ncf16_ci16_generic.t"
+DECLARE_TR_FUNC_N_1(conv_2cf16_ci16_generic)
+
+#ifdef WVLT_AVX2
+#define TEMPLATE_FUNC_NAME conv_2cf16_ci16_avx2
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx2,f16c"))
+#include "templates/conv_ncf16_ci16_avx2.t"
+DECLARE_TR_FUNC_N_1(conv_2cf16_ci16_avx2)
+#endif
+
+#ifdef WVLT_NEON
+#define TEMPLATE_FUNC_NAME conv_2cf16_ci16_neon
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/conv_ncf16_ci16_neon.t"
+DECLARE_TR_FUNC_N_1(conv_2cf16_ci16_neon)
+#endif
+
+#undef CHCNT
+
+// Every AVX2 capable CPU implements F16C, so it's selected on the AVX2 level
+conv_function_t conv_get_cf16_ci16_c(generic_opts_t cpu_cap, const char** sfunc)
+{
+    const char* fname;
+    conv_function_t fn;
+
+    SELECT_GENERIC_FN(fn, fname, tr_conv_cf16_ci16_generic, cpu_cap);
+    SELECT_AVX2_FN(fn, fname, tr_conv_cf16_ci16_avx2, cpu_cap);
+    SELECT_NEON_FN(fn, fname, tr_conv_cf16_ci16_neon, cpu_cap);
+
+    if (sfunc) *sfunc = fname;
+    return fn;
+}
+
+conv_function_t conv_get_cf16_ci16()
+{
+    return conv_get_cf16_ci16_c(cpu_vcap_get(), NULL);
+}
+
+conv_function_t conv_get_2cf16_ci16_c(generic_opts_t cpu_cap, const char** sfunc)
+{
+    const char* fname;
+    conv_function_t fn;
+
+    SELECT_GENERIC_FN(fn, fname, tr_conv_2cf16_ci16_generic, cpu_cap);
+    SELECT_AVX2_FN(fn, fname, tr_conv_2cf16_ci16_avx2, cpu_cap);
+    SELECT_NEON_FN(fn, fname, tr_conv_2cf16_ci16_neon, cpu_cap);
+
+    if (sfunc) *sfunc = fname;
+    return fn;
+}
+
+conv_function_t conv_get_2cf16_ci16()
+{
+    return conv_get_2cf16_ci16_c(cpu_vcap_get(), NULL);
+}
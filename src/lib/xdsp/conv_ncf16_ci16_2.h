@@ -0,0 +1,15 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef CONV_NCF16_CI16_H
+#define CONV_NCF16_CI16_H
+
+#include "conv.h"
+
+conv_function_t conv_get_cf16_ci16();
+conv_function_t conv_get_cf16_ci16_c(generic_opts_t cpu_cap, const char **sfunc);
+
+conv_function_t conv_get_2cf16_ci16();
+conv_function_t conv_get_2cf16_ci16_c(generic_opts_t cpu_cap, const char **sfunc);
+
+#endif
@@ -0,0 +1,15 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef CONV_NCF32_CI12_H
+#define CONV_NCF32_CI12_H
+
+#include "conv.h"
+
+conv_function_t conv_get_4cf32_ci12();
+conv_function_t conv_get_4cf32_ci12_c(generic_opts_t cpu_cap, const char **sfunc);
+
+conv_function_t conv_get_8cf32_ci12();
+conv_function_t conv_get_8cf32_ci12_c(generic_opts_t cpu_cap, const char **sfunc);
+
+#endif
@@ -0,0 +1,93 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include "detector_functions.h"
+#include "attribute_switch.h"
+
+#define TEMPLATE_FUNC_NAME detector_power_cf32_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/detector_power_cf32_generic.t"
+DECLARE_TR_FUNC_DETECTOR_POWER_CF32(detector_power_cf32_generic)
+
+#define TEMPLATE_FUNC_NAME detector_xcorr_cf32_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/detector_xcorr_cf32_generic.t"
+DECLARE_TR_FUNC_DETECTOR_XCORR_CF32(detector_xcorr_cf32_generic)
+
+#define TEMPLATE_FUNC_NAME detector_scan_f32_generic
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/detector_scan_f32_generic.t"
+DECLARE_TR_FUNC_DETECTOR_SCAN_F32(detector_scan_f32_generic)
+
+#ifdef WVLT_AVX2
+#define TEMPLATE_FUNC_NAME detector_power_cf32_avx2
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx2"))
+#include "templates/detector_power_cf32_avx2.t"
+DECLARE_TR_FUNC_DETECTOR_POWER_CF32(detector_power_cf32_avx2)
+
+#define TEMPLATE_FUNC_NAME detector_xcorr_cf32_avx2
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx2,fma"))
+#include "templates/detector_xcorr_cf32_avx2.t"
+DECLARE_TR_FUNC_DETECTOR_XCORR_CF32(detector_xcorr_cf32_avx2)
+
+#define TEMPLATE_FUNC_NAME detector_scan_f32_avx2
+VWLT_ATTRIBUTE(optimize("-O3"), target("avx2"))
+#include "templates/detector_scan_f32_avx2.t"
+DECLARE_TR_FUNC_DETECTOR_SCAN_F32(detector_scan_f32_avx2)
+#endif
+
+#ifdef WVLT_NEON
+#define TEMPLATE_FUNC_NAME detector_power_cf32_neon
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/detector_power_cf32_neon.t"
+DECLARE_TR_FUNC_DETECTOR_POWER_CF32(detector_power_cf32_neon)
+
+#define TEMPLATE_FUNC_NAME detector_xcorr_cf32_neon
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/detector_xcorr_cf32_neon.t"
+DECLARE_TR_FUNC_DETECTOR_XCORR_CF32(detector_xcorr_cf32_neon)
+
+#define TEMPLATE_FUNC_NAME detector_scan_f32_neon
+VWLT_ATTRIBUTE(optimize("-O3"))
+#include "templates/detector_scan_f32_neon.t"
+DECLARE_TR_FUNC_DETECTOR_SCAN_F32(detector_scan_f32_neon)
+#endif
+
+detector_power_cf32_function_t detector_power_cf32_c(generic_opts_t cpu_cap, const char** sfunc)
+{
+    const char* fname;
+    detector_power_cf32_function_t fn;
+
+    SELECT_GENERIC_FN(fn, fname, tr_detector_power_cf32_generic, cpu_cap);
+    SELECT_AVX2_FN(fn, fname, tr_detector_power_cf32_avx2, cpu_cap);
+    SELECT_NEON_FN(fn, fname, tr_detector_power_cf32_neon, cpu_cap);
+
+    if (sfunc) *sfunc = fname;
+    return fn;
+}
+
+detector_xcorr_cf32_function_t detector_xcorr_cf32_c(generic_opts_t cpu_cap, const char** sfunc)
+{
+    const char* fname;
+    detector_xcorr_cf32_function_t fn;
+
+    SELECT_GENERIC_FN(fn, fname, tr_detector_xcorr_cf32_generic, cpu_cap);
+    SELECT_AVX2_FN(fn, fname, tr_detector_xcorr_cf32_avx2, cpu_cap);
+    SELECT_NEON_FN(fn, fname, tr_detector_xcorr_cf32_neon, cpu_cap);
+
+    if (sfunc) *sfunc = fname;
+    return fn;
+}
+
+detector_scan_f32_function_t detector_scan_f32_c(generic_opts_t cpu_cap, const char** sfunc)
+{
+    const char* fname;
+    detector_scan_f32_function_t fn;
+
+    SELECT_GENERIC_FN(fn, fname, tr_detector_scan_f32_generic, cpu_cap);
+    SELECT_AVX2_FN(fn, fname, tr_detector_scan_f32_avx2, cpu_cap);
+    SELECT_NEON_FN(fn, fname, tr_detector_scan_f32_neon, cpu_cap);
+
+    if (sfunc) *sfunc = fname;
+    return fn;
+}
@@ -0,0 +1,37 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef DETECTOR_FUNCTIONS_H
+#define DETECTOR_FUNCTIONS_H
+
+#include <stdint.h>
+#include "conv.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+detector_power_cf32_function_t detector_power_cf32_c(generic_opts_t cpu_cap, const char** sfunc);
+detector_xcorr_cf32_function_t detector_xcorr_cf32_c(generic_opts_t cpu_cap, const char** sfunc);
+detector_scan_f32_function_t detector_scan_f32_c(generic_opts_t cpu_cap, const char** sfunc);
+
+static inline void detector_power_cf32(const float* in, unsigned count, float* out)
+{
+    return (*detector_power_cf32_c(cpu_vcap_get(), NULL))(in, count, out);
+}
+
+static inline void detector_xcorr_cf32(const float* in, unsigned count, const float* pre, unsigned plen, float* out)
+{
+    return (*detector_xcorr_cf32_c(cpu_vcap_get(), NULL))(in, count, pre, plen, out);
+}
+
+static inline unsigned detector_scan_f32(const float* m, unsigned count, float thr_on, float thr_off, unsigned* armed)
+{
+    return (*detector_scan_f32_c(cpu_vcap_get(), NULL))(m, count, thr_on, thr_off, armed);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DETECTOR_FUNCTIONS_H
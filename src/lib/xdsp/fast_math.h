@@ -59,91 +59,159 @@ static inline
     return p + e;
 }
 
-#ifdef WVLT_AVX2
+/*
+ * Runtime selectable accuracy of log2 approximation:
+ *   WVLT_LOG2_MITCHELL - Mitchell's approximation, the fastest one
+ *   3 .. 6             - degree of polynomial approximation, max eps is about
+ *                        3e-3, 4e-4, 6e-5, 1e-5 respectively (0.009 .. 0.00003 dB)
+ */
+#define WVLT_LOG2_MITCHELL       0
+#define WVLT_LOG2_DEGREE_MIN     3
+#define WVLT_LOG2_DEGREE_MAX     6
+#define WVLT_LOG2_DEGREE_DEFAULT LOG_POLY_DEGREE
+
+// 10 * log10(2), converts log2 of power to dB
+#define WVLT_DB_PER_LOG2 3.01029995663981195214f
+
+// Minimax fit of log2(x)/(x - 1) for x in range [1, 2[, highest power first
+static const float wvlt_log2_poly_coefs[WVLT_LOG2_DEGREE_MAX - WVLT_LOG2_DEGREE_MIN + 1][WVLT_LOG2_DEGREE_MAX] = {
+    { 0.204446009836232697516f, -1.04913055217340124191f, 2.28330284476918490682f },
+    { -0.107254423828329604454f, 0.688243882994381274313f, -1.75647175389045657003f, 2.61761038894603480148f },
+    { 0.0596515482674574969533f, -0.465725644288844778798f, 1.48116647521213171641f, -2.52074962577807006663f, 2.8882704548164776201f },
+    { -3.4436006e-2f, 3.1821337e-1f, -1.2315303f, 2.5988452f, -3.3241990f, 3.1157899f },
+};
+
+// Returns WVLT_LOG2_MITCHELL or valid polynomial degree
+static inline
+unsigned wvlt_log2_degree(unsigned degree)
+{
+    if (degree < WVLT_LOG2_DEGREE_MIN)
+        return WVLT_LOG2_MITCHELL;
+
+    return (degree > WVLT_LOG2_DEGREE_MAX) ? WVLT_LOG2_DEGREE_MAX : degree;
+}
+
+static inline
+float wvlt_log2f_deg(float x, unsigned degree)
+{
+    degree = wvlt_log2_degree(degree);
+    if (degree == WVLT_LOG2_MITCHELL)
+        return wvlt_fastlog2(x);
+
+    const float* c = wvlt_log2_poly_coefs[degree - WVLT_LOG2_DEGREE_MIN];
+    union {float f32; int32_t i32;} i = { x };
+    float e = (float)(((i.i32 & 0x7F800000) >> 23) - 127);
+    union {int32_t i32; float f32;} m = { (i.i32 & 0x007FFFFF) | 0x3F800000 };
+
+    float p = c[0];
+    for (unsigned k = 1; k < degree; k++)
+        p = p * m.f32 + c[k];
+
+    p *= (m.f32 - 1.0f);
+    return p + e;
+}
+
+
+/*
+ * SIMD versions of wvlt_log2f_deg(), WVLT_POLYLOG2_DECL_CONSTS(degree) has to be
+ * placed before the loop, degree is checked once per vector so the branch is
+ * perfectly predicted
+ */
+
+#ifdef WVLT_SSE2
+
+#define WVLT_POLYLOG2F4_DECL_CONSTS(degree) \
+    const unsigned wvlt_log2_deg4 = wvlt_log2_degree(degree); \
+    const __m128i wvlt_log2_exp4  = _mm_set1_epi32(0x7F800000); \
+    const __m128i wvlt_log2_mant4 = _mm_set1_epi32(0x007FFFFF); \
+    const __m128  wvlt_log2_one4  = _mm_set1_ps(1.0f); \
+    const __m128i wvlt_log2_v1274 = _mm_set1_epi32(127); \
+    const __m128  wvlt_log2_mul4  = _mm_set1_ps(WVLT_FASTLOG2_MUL); \
+    const __m128  wvlt_log2_sub4  = _mm_set1_ps(WVLT_FASTLOG2_SUB); \
+    __m128 wvlt_log2_c4[WVLT_LOG2_DEGREE_MAX]; \
+    for (unsigned k = 0; k < wvlt_log2_deg4; k++) \
+        wvlt_log2_c4[k] = _mm_set1_ps(wvlt_log2_poly_coefs[wvlt_log2_deg4 - WVLT_LOG2_DEGREE_MIN][k]);
+
+#define WVLT_POLYLOG2F4(in, out) \
+{ \
+    __m128i i = _mm_castps_si128(in); \
+    if (wvlt_log2_deg4 == WVLT_LOG2_MITCHELL) { \
+        out = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(i), wvlt_log2_mul4), wvlt_log2_sub4); \
+    } else { \
+        __m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(_mm_and_si128(i, wvlt_log2_exp4), 23), wvlt_log2_v1274)); \
+        __m128 m = _mm_or_ps(_mm_castsi128_ps(_mm_and_si128(i, wvlt_log2_mant4)), wvlt_log2_one4); \
+        __m128 p = wvlt_log2_c4[0]; \
+        for (unsigned k = 1; k < wvlt_log2_deg4; k++) \
+            p = _mm_add_ps(_mm_mul_ps(p, m), wvlt_log2_c4[k]); \
+        p = _mm_mul_ps(p, _mm_sub_ps(m, wvlt_log2_one4)); \
+        out = _mm_add_ps(p, e); \
+    } \
+}
+
+#endif
 
-#define WVLT_LOG2_POLY0(x, c0) _mm256_set1_ps(c0)
-#define WVLT_LOG2_POLY1(x, c0, c1) _mm256_add_ps(_mm256_mul_ps(WVLT_LOG2_POLY0(x, c1), x), _mm256_set1_ps(c0))
-#define WVLT_LOG2_POLY2(x, c0, c1, c2) _mm256_add_ps(_mm256_mul_ps(WVLT_LOG2_POLY1(x, c1, c2), x), _mm256_set1_ps(c0))
-#define WVLT_LOG2_POLY3(x, c0, c1, c2, c3) _mm256_add_ps(_mm256_mul_ps(WVLT_LOG2_POLY2(x, c1, c2, c3), x), _mm256_set1_ps(c0))
-#define WVLT_LOG2_POLY4(x, c0, c1, c2, c3, c4) _mm256_add_ps(_mm256_mul_ps(WVLT_LOG2_POLY3(x, c1, c2, c3, c4), x), _mm256_set1_ps(c0))
-#define WVLT_LOG2_POLY5(x, c0, c1, c2, c3, c4, c5) _mm256_add_ps(_mm256_mul_ps(WVLT_LOG2_POLY4(x, c1, c2, c3, c4, c5), x), _mm256_set1_ps(c0))
+#ifdef WVLT_AVX2
 
-#define WVLT_POLYLOG2_DECL_CONSTS \
+#define WVLT_POLYLOG2_DECL_CONSTS(degree) \
+    const unsigned wvlt_log2_deg  = wvlt_log2_degree(degree); \
     const __m256i wvlt_log2_exp  = _mm256_set1_epi32(0x7F800000); \
     const __m256i wvlt_log2_mant = _mm256_set1_epi32(0x007FFFFF); \
     const __m256  wvlt_log2_one  = _mm256_set1_ps(1.0f); \
-    const __m256i wvlt_log2_v127 = _mm256_set1_epi32(127);
-
-#if   LOG_POLY_DEGREE == 3
-#define WVLT_LOG2_POLY_APPROX(x) WVLT_LOG2_POLY2(x, 2.28330284476918490682f, -1.04913055217340124191f, 0.204446009836232697516f)
-#elif LOG_POLY_DEGREE == 4
-#define WVLT_LOG2_POLY_APPROX(x) WVLT_LOG2_POLY3(x, 2.61761038894603480148f, -1.75647175389045657003f, 0.688243882994381274313f, -0.107254423828329604454f)
-#elif LOG_POLY_DEGREE == 5
-#define WVLT_LOG2_POLY_APPROX(x) WVLT_LOG2_POLY4(x, 2.8882704548164776201f, -2.52074962577807006663f, 1.48116647521213171641f, -0.465725644288844778798f, 0.0596515482674574969533f)
-#elif LOG_POLY_DEGREE == 6
-#define WVLT_LOG2_POLY_APPROX(x) WVLT_LOG2_POLY5(x, 3.1157899f, -3.3241990f, 2.5988452f, -1.2315303f,  3.1821337e-1f, -3.4436006e-2f)
-#else
-#error
-#endif
+    const __m256i wvlt_log2_v127 = _mm256_set1_epi32(127); \
+    const __m256  wvlt_log2_mul  = _mm256_set1_ps(WVLT_FASTLOG2_MUL); \
+    const __m256  wvlt_log2_sub  = _mm256_set1_ps(WVLT_FASTLOG2_SUB); \
+    __m256 wvlt_log2_c[WVLT_LOG2_DEGREE_MAX]; \
+    for (unsigned k = 0; k < wvlt_log2_deg; k++) \
+        wvlt_log2_c[k] = _mm256_set1_ps(wvlt_log2_poly_coefs[wvlt_log2_deg - WVLT_LOG2_DEGREE_MIN][k]);
 
 #define WVLT_POLYLOG2F8(in, out) \
 { \
     __m256i i = _mm256_castps_si256(in); \
-    __m256  e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(_mm256_and_si256(i, wvlt_log2_exp), 23), wvlt_log2_v127)); \
-    __m256  m = _mm256_or_ps(_mm256_castsi256_ps(_mm256_and_si256(i, wvlt_log2_mant)), wvlt_log2_one); \
-  \
-   /* Minimax polynomial fit of log2(x)/(x - 1), for x in range [1, 2[ */ \
-   __m256 p = WVLT_LOG2_POLY_APPROX(m); \
-  \
-    /* This effectively increases the polynomial degree by one, but ensures that log2(1) == 0*/ \
-    p = _mm256_mul_ps(p, _mm256_sub_ps(m, wvlt_log2_one)); \
-  \
-    out = _mm256_add_ps(p, e); \
+    if (wvlt_log2_deg == WVLT_LOG2_MITCHELL) { \
+        out = _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(i), wvlt_log2_mul), wvlt_log2_sub); \
+    } else { \
+        __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(_mm256_and_si256(i, wvlt_log2_exp), 23), wvlt_log2_v127)); \
+        __m256 m = _mm256_or_ps(_mm256_castsi256_ps(_mm256_and_si256(i, wvlt_log2_mant)), wvlt_log2_one); \
+        __m256 p = wvlt_log2_c[0]; \
+        for (unsigned k = 1; k < wvlt_log2_deg; k++) \
+            p = _mm256_add_ps(_mm256_mul_ps(p, m), wvlt_log2_c[k]); \
+        /* This effectively increases the polynomial degree by one, but ensures that log2(1) == 0*/ \
+        p = _mm256_mul_ps(p, _mm256_sub_ps(m, wvlt_log2_one)); \
+        out = _mm256_add_ps(p, e); \
+    } \
 }
 
 #endif
 
 #ifdef WVLT_NEON
 
-#define WVLT_LOG2_POLY0(x, c0) vdupq_n_f32(c0)
-#define WVLT_LOG2_POLY1(x, c0, c1) vmlaq_f32(vdupq_n_f32(c0), WVLT_LOG2_POLY0(x, c1), x)
-#define WVLT_LOG2_POLY2(x, c0, c1, c2) vmlaq_f32(vdupq_n_f32(c0), WVLT_LOG2_POLY1(x, c1, c2), x)
-#define WVLT_LOG2_POLY3(x, c0, c1, c2, c3) vmlaq_f32(vdupq_n_f32(c0), WVLT_LOG2_POLY2(x, c1, c2, c3), x)
-#define WVLT_LOG2_POLY4(x, c0, c1, c2, c3, c4) vmlaq_f32(vdupq_n_f32(c0), WVLT_LOG2_POLY3(x, c1, c2, c3, c4), x)
-#define WVLT_LOG2_POLY5(x, c0, c1, c2, c3, c4, c5) vmlaq_f32(vdupq_n_f32(c0), WVLT_LOG2_POLY4(x, c1, c2, c3, c4, c5), x)
-
-#define WVLT_POLYLOG2_DECL_CONSTS \
+#define WVLT_POLYLOG2_DECL_CONSTS(degree) \
+    const unsigned    wvlt_log2_deg   = wvlt_log2_degree(degree); \
     const int32x4_t   wvlt_log2_exp   = vdupq_n_s32(0x7F800000); \
     const int32x4_t   wvlt_log2_mant  = vdupq_n_s32(0x007FFFFF); \
     const float32x4_t wvlt_log2_f_one = vdupq_n_f32(1.0f); \
     const int32x4_t   wvlt_log2_i_one = vreinterpretq_s32_f32(wvlt_log2_f_one); \
-    const int32x4_t   wvlt_log2_v127  = vdupq_n_s32(-127);
-
-#if   LOG_POLY_DEGREE == 3
-#define WVLT_LOG2_POLY_APPROX(x) WVLT_LOG2_POLY2(x, 2.28330284476918490682f, -1.04913055217340124191f, 0.204446009836232697516f)
-#elif LOG_POLY_DEGREE == 4
-#define WVLT_LOG2_POLY_APPROX(x) WVLT_LOG2_POLY3(x, 2.61761038894603480148f, -1.75647175389045657003f, 0.688243882994381274313f, -0.107254423828329604454f)
-#elif LOG_POLY_DEGREE == 5
-#define WVLT_LOG2_POLY_APPROX(x) WVLT_LOG2_POLY4(x, 2.8882704548164776201f, -2.52074962577807006663f, 1.48116647521213171641f, -0.465725644288844778798f, 0.0596515482674574969533f)
-#elif LOG_POLY_DEGREE == 6
-#define WVLT_LOG2_POLY_APPROX(x) WVLT_LOG2_POLY5(x, 3.1157899f, -3.3241990f, 2.5988452f, -1.2315303f,  3.1821337e-1f, -3.4436006e-2f)
-#else
-#error
-#endif
+    const int32x4_t   wvlt_log2_v127  = vdupq_n_s32(-127); \
+    const float32x4_t wvlt_log2_sub   = vdupq_n_f32(-WVLT_FASTLOG2_SUB); \
+    float32x4_t wvlt_log2_c[WVLT_LOG2_DEGREE_MAX]; \
+    for (unsigned k = 0; k < wvlt_log2_deg; k++) \
+        wvlt_log2_c[k] = vdupq_n_f32(wvlt_log2_poly_coefs[wvlt_log2_deg - WVLT_LOG2_DEGREE_MIN][k]);
 
 #define WVLT_POLYLOG2F8(in, out) \
 { \
-        int32x4_t   i = vreinterpretq_s32_f32(in); \
+    int32x4_t i = vreinterpretq_s32_f32(in); \
+    if (wvlt_log2_deg == WVLT_LOG2_MITCHELL) { \
+        out = vmlaq_n_f32(wvlt_log2_sub, vcvtq_f32_u32(vreinterpretq_u32_f32(in)), WVLT_FASTLOG2_MUL); \
+    } else { \
         float32x4_t e = vcvtq_f32_s32(vsraq_n_s32(wvlt_log2_v127, vandq_s32(i, wvlt_log2_exp), 23)); \
         float32x4_t m = vreinterpretq_f32_s32(vorrq_s32(vandq_s32(i, wvlt_log2_mant), wvlt_log2_i_one)); \
-  \
-        /* Minimax polynomial fit of log2(x)/(x - 1), for x in range [1, 2[ */ \
-        float32x4_t p = WVLT_LOG2_POLY_APPROX(m); \
-  \
+        float32x4_t p = wvlt_log2_c[0]; \
+        for (unsigned k = 1; k < wvlt_log2_deg; k++) \
+            p = vmlaq_f32(wvlt_log2_c[k], p, m); \
         /* This effectively increases the polynomial degree by one, but ensures that log2(1) == 0*/ \
         p = vmulq_f32(p, vsubq_f32(m, wvlt_log2_f_one)); \
-  \
         out = vaddq_f32(p, e); \
+    } \
 }
 
 #endif
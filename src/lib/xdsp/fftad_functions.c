@@ -6,8 +6,6 @@
 #include "attribute_switch.h"
 #include "fast_math.h"
 
-#define USE_POLYLOG2
-
 #define TEMPLATE_FUNC_NAME fftad_init_generic
 VWLT_ATTRIBUTE(optimize("-O3"))
 #include "templates/fftad_init_generic.t"
@@ -38,6 +36,13 @@ VWLT_ATTRIBUTE(optimize("-O3"))
 #include "templates/fftad_norm_hwi16_generic.t"
 DECLARE_TR_FUNC_FFTAD_NORM_HWI16(fftad_norm_hwi16_generic)
 
+#ifdef WVLT_SSE2
+#define TEMPLATE_FUNC_NAME fftad_norm_sse2
+VWLT_ATTRIBUTE(optimize("-O3"), target("sse2"))
+#include "templates/fftad_norm_sse2.t"
+DECLARE_TR_FUNC_FFTAD_NORM(fftad_norm_sse2)
+#endif
+
 #ifdef WVLT_AVX2
 
 #define TEMPLATE_FUNC_NAME fftad_init_avx2
@@ -141,6 +146,7 @@ fftad_norm_function_t fftad_norm_c(generic_opts_t cpu_cap, const char** sfunc)
     fftad_norm_function_t fn;
 
     SELECT_GENERIC_FN(fn, fname, tr_fftad_norm_generic, cpu_cap);
+    SELECT_SSE2_FN(fn, fname, tr_fftad_norm_sse2, cpu_cap);
     SELECT_AVX2_FN(fn, fname, tr_fftad_norm_avx2, cpu_cap);
     SELECT_NEON_FN(fn, fname, tr_fftad_norm_neon, cpu_cap);
 
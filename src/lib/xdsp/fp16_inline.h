@@ -0,0 +1,72 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#ifndef FP16_INLINE_H
+#define FP16_INLINE_H
+
+#include <stdint.h>
+#include <math.h>
+
+// IEEE 754 binary16 <-> binary32 for generic kernels, round to nearest even
+// like F16C VCVTPS2PH and NEON FCVTN, so SIMD results are bit exact
+
+static inline uint16_t wvlt_f32_to_f16(float v)
+{
+    union { float f; uint32_t u; } x = { v };
+    const union { uint32_t u; float f; } denorm_magic = { ((127 - 15) + (23 - 10) + 1) << 23 };
+    const uint32_t f32_inf = 255u << 23;
+    const uint32_t f16_max = (127u + 16u) << 23;
+    uint32_t sign = x.u & 0x80000000u;
+    uint16_t o;
+
+    x.u ^= sign;
+    if (x.u >= f16_max) {
+        // Overflow to Inf, NaN stays quiet NaN
+        o = (x.u > f32_inf) ? 0x7e00 : 0x7c00;
+    } else if (x.u < (113u << 23)) {
+        // Subnormal result, FPU rounds mantissa on the magic addition
+        x.f += denorm_magic.f;
+        o = (uint16_t)(x.u - denorm_magic.u);
+    } else {
+        uint32_t mant_odd = (x.u >> 13) & 1;
+        x.u += ((uint32_t)(15 - 127) << 23) + 0xfff;
+        x.u += mant_odd;
+        o = (uint16_t)(x.u >> 13);
+    }
+    return o | (uint16_t)(sign >> 16);
+}
+
+static inline float wvlt_f16_to_f32(uint16_t h)
+{
+    const union { uint32_t u; float f; } magic = { 113u << 23 };
+    const uint32_t shifted_exp = 0x7c00u << 13;
+    union { uint32_t u; float f; } o;
+    uint32_t exp;
+
+    o.u = (uint32_t)(h & 0x7fffu) << 13;
+    exp = shifted_exp & o.u;
+    o.u += (127u - 15u) << 23;
+    if (exp == shifted_exp) {
+        // Inf / NaN
+        o.u += (128u - 16u) << 23;
+    } else if (exp == 0) {
+        // Zero / subnormal, renormalize
+        o.u += 1u << 23;
+        o.f -= magic.f;
+    }
+    o.u |= (uint32_t)(h & 0x8000u) << 16;
+    return o.f;
+}
+
+// Scaled binary16 to int16 with saturation, rounding as CVTPS2DQ / FCVTNS do
+static inline int16_t wvlt_f16_to_i16(uint16_t h, float scale)
+{
+    float v = wvlt_f16_to_f32(h) * scale;
+    if (!(v > -32768.f))
+        return -32768;
+    if (v >= 32767.f)
+        return 32767;
+    return (int16_t)lrintf(v);
+}
+
+#endif
@@ -0,0 +1,27 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata_p,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz * 4 / 3) < i)
+        i = (outdatabsz * 4 / 3);
+
+    const uint16_t* indata = (const uint16_t*)indata_p;
+    uint8_t* outdata = (uint8_t*)outdata_p;
+
+    for (; i >= 4; i -= 4) {
+        int16_t f0 = wvlt_f16_to_i16(*(indata++), 1.0f / CONV_SCALE);
+        int16_t f1 = wvlt_f16_to_i16(*(indata++), 1.0f / CONV_SCALE);
+
+        wu_i16u32_t a = {{f0, f1}};
+        wu_u32b_t   c = {(a.u & 0xfff00000) | ((a.u << 4) & 0x000fff00)};
+
+        *(outdata++) = c.b[1];
+        *(outdata++) = c.b[2];
+        *(outdata++) = c.b[3];
+    }
+}
+
+#undef TEMPLATE_FUNC_NAME
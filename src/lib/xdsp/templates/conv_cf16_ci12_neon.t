@@ -0,0 +1,69 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata_p,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz * 4 / 3) < i)
+        i = (outdatabsz * 4 / 3);
+
+    const uint16_t* indata = (const uint16_t*)indata_p;
+    uint8_t* outdata = (uint8_t*)outdata_p;
+
+    const uint16x8_t m0f0 = vdupq_n_u16(0xf0);
+
+    // 8 cf16 values -> 8 ci16 words, FCVTN rounds to nearest even as lrintf() does
+#define CONVERT_CF16_CI16(o, p) \
+    { \
+        float16x8_t h = vreinterpretq_f16_u16(vld1q_u16(p)); \
+        int32x4_t lo = vcvtnq_s32_f32(vmulq_n_f32(vcvt_f32_f16(vget_low_f16(h)), 1.0f / CONV_SCALE)); \
+        int32x4_t hi = vcvtnq_s32_f32(vmulq_n_f32(vcvt_high_f32_f16(h), 1.0f / CONV_SCALE)); \
+        o = vreinterpretq_u16_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi))); \
+        p += 8; \
+    }
+
+    // 16 ci16 words in wire order -> 3 byte planes for vst3
+#define PACK_CI12(ma, mb, b0, b1, b2) \
+    { \
+        uint16x8x2_t iq = vuzpq_u16(ma, mb); \
+        b0 = vmovn_u16(vshrq_n_u16(iq.val[0], 4)); \
+        b1 = vmovn_u16(vorrq_u16(vshrq_n_u16(iq.val[0], 12), vandq_u16(iq.val[1], m0f0))); \
+        b2 = vmovn_u16(vshrq_n_u16(iq.val[1], 8)); \
+    }
+
+    // 32 samples per iteration
+    for (; i >= 64; i -= 64) {
+        uint16x8_t m0, m1, m2, m3;
+        uint8x8_t l0, l1, l2, h0, h1, h2;
+
+        CONVERT_CF16_CI16(m0, indata);
+        CONVERT_CF16_CI16(m1, indata);
+        CONVERT_CF16_CI16(m2, indata);
+        CONVERT_CF16_CI16(m3, indata);
+
+        PACK_CI12(m0, m1, l0, l1, l2);
+        PACK_CI12(m2, m3, h0, h1, h2);
+
+        uint8x16x3_t w = {{ vcombine_u8(l0, h0), vcombine_u8(l1, h1), vcombine_u8(l2, h2) }};
+        vst3q_u8(outdata, w);
+        outdata += 48;
+    }
+
+#undef PACK_CI12
+#undef CONVERT_CF16_CI16
+
+    for (; i >= 4; i -= 4) {
+        int16_t f0 = wvlt_f16_to_i16(*(indata++), 1.0f / CONV_SCALE);
+        int16_t f1 = wvlt_f16_to_i16(*(indata++), 1.0f / CONV_SCALE);
+
+        wu_i16u32_t a = {{f0, f1}};
+        wu_u32b_t   c = {(a.u & 0xfff00000) | ((a.u << 4) & 0x000fff00)};
+
+        *(outdata++) = c.b[1];
+        *(outdata++) = c.b[2];
+        *(outdata++) = c.b[3];
+    }
+}
+
+#undef TEMPLATE_FUNC_NAME
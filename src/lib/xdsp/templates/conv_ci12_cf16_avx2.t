@@ -0,0 +1,49 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata_p,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    /* 12 bits -> 16 bits  =>  3 -> 4   */
+    if ((outdatabsz * 3 / 4) < i)
+        i = (outdatabsz * 3 / 4);
+
+    const uint8_t* indata = (const uint8_t*)indata_p;
+    uint16_t* outdata = (uint16_t*)outdata_p;
+
+    const __m256 scale = _mm256_set1_ps(CONV_SCALE);
+    const __m128i shfl = _mm_setr_epi8(0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11);
+    const __m128i hmsk = _mm_set1_epi16(0xfff0);
+
+    /*
+     * 12 bytes -> 8 values per iteration, every byte pair is spread to 16-bit
+     * lane: even lanes hold {f1[3:0],f0[11:0]} and are shifted up, odd lanes
+     * hold {f1[11:0],f0[11:8]} and are masked, same as the generic kernel
+     */
+    for (; i >= 16; i -= 12) {
+        __m128i x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)indata), shfl);
+        __m128i v = _mm_blend_epi16(_mm_slli_epi16(x, 4), _mm_and_si128(x, hmsk), 0xaa);
+        __m256 f = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v)), scale);
+
+        _mm_storeu_si128((__m128i*)outdata, _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+        indata += 12;
+        outdata += 8;
+    }
+
+    while (i >= 3)
+    {
+        uint8_t v0 = *(indata++);
+        uint8_t v1 = *(indata++);
+        uint8_t v2 = *(indata++);
+        i -= 3;
+
+        float a = (int16_t) (((uint16_t)v0 << 4) | ((uint16_t)v1 << 12));
+        float b = (int16_t) (((uint16_t)v2 << 8) | (v1 & 0xf0));
+
+        *(outdata++) = wvlt_f32_to_f16(a * CONV_SCALE);
+        *(outdata++) = wvlt_f32_to_f16(b * CONV_SCALE);
+    }
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,30 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata_p,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    /* 12 bits -> 16 bits  =>  3 -> 4   */
+    if ((outdatabsz * 3 / 4) < i)
+        i = (outdatabsz * 3 / 4);
+
+    const uint8_t* indata = (const uint8_t*)indata_p;
+    uint16_t* outdata = (uint16_t*)outdata_p;
+
+    while (i >= 3)
+    {
+        uint8_t v0 = *(indata++);
+        uint8_t v1 = *(indata++);
+        uint8_t v2 = *(indata++);
+        i -= 3;
+
+        float a = (int16_t) (((uint16_t)v0 << 4) | ((uint16_t)v1 << 12));
+        float b = (int16_t) (((uint16_t)v2 << 8) | (v1 & 0xf0));
+
+        *(outdata++) = wvlt_f32_to_f16(a * CONV_SCALE);
+        *(outdata++) = wvlt_f32_to_f16(b * CONV_SCALE);
+    }
+}
+
+#undef TEMPLATE_FUNC_NAME
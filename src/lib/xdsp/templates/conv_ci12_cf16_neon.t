@@ -0,0 +1,70 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata_p,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    /* 12 bits -> 16 bits  =>  3 -> 4   */
+    if ((outdatabsz * 3 / 4) < i)
+        i = (outdatabsz * 3 / 4);
+
+    const uint8_t* indata = (const uint8_t*)indata_p;
+    uint16_t* outdata = (uint16_t*)outdata_p;
+
+    const uint16x8_t m0f0 = vdupq_n_u16(0xf0);
+
+    // 8 packed ci12 samples -> 2 x 8 ci16 words in wire order
+#define UNPACK_CI12(b0, b1, b2, iq) \
+    { \
+        uint16x8_t w0 = vmovl_u8(b0); \
+        uint16x8_t w1 = vmovl_u8(b1); \
+        uint16x8_t w2 = vmovl_u8(b2); \
+        iq = vzipq_u16(vorrq_u16(vshlq_n_u16(w0, 4), vshlq_n_u16(w1, 12)), \
+                       vorrq_u16(vandq_u16(w1, m0f0), vshlq_n_u16(w2, 8))); \
+    }
+
+    // FCVTN narrows with round to nearest even, same as the generic kernel
+#define CONVERT_CI16_CF16_STORE(r, o) \
+    { \
+        int16x8_t v = vreinterpretq_s16_u16(r); \
+        float32x4_t lo = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), CONV_SCALE); \
+        float32x4_t hi = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), CONV_SCALE); \
+        vst1q_u16(o, vreinterpretq_u16_f16(vcombine_f16(vcvt_f16_f32(lo), vcvt_f16_f32(hi)))); \
+        o += 8; \
+    }
+
+    // 32 samples per iteration
+    for (; i >= 48; i -= 48) {
+        uint16x8x2_t l, h;
+        uint8x16x3_t a = vld3q_u8(indata);
+        indata += 48;
+
+        UNPACK_CI12(vget_low_u8(a.val[0]), vget_low_u8(a.val[1]), vget_low_u8(a.val[2]), l);
+        UNPACK_CI12(vget_high_u8(a.val[0]), vget_high_u8(a.val[1]), vget_high_u8(a.val[2]), h);
+
+        CONVERT_CI16_CF16_STORE(l.val[0], outdata);
+        CONVERT_CI16_CF16_STORE(l.val[1], outdata);
+        CONVERT_CI16_CF16_STORE(h.val[0], outdata);
+        CONVERT_CI16_CF16_STORE(h.val[1], outdata);
+    }
+
+#undef CONVERT_CI16_CF16_STORE
+#undef UNPACK_CI12
+
+    while (i >= 3)
+    {
+        uint8_t v0 = *(indata++);
+        uint8_t v1 = *(indata++);
+        uint8_t v2 = *(indata++);
+        i -= 3;
+
+        float a = (int16_t) (((uint16_t)v0 << 4) | ((uint16_t)v1 << 12));
+        float b = (int16_t) (((uint16_t)v2 << 8) | (v1 & 0xf0));
+
+        *(outdata++) = wvlt_f32_to_f16(a * CONV_SCALE);
+        *(outdata++) = wvlt_f32_to_f16(b * CONV_SCALE);
+    }
+}
+
+#undef TEMPLATE_FUNC_NAME
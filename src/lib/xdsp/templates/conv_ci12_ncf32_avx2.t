@@ -0,0 +1,99 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata_p,
+                        unsigned indatabsz,
+                        void *__restrict *__restrict outdata,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    /* 12 bits -> 32 bits  =>  3 -> 8   */
+    if ((outdatabsz * 3 / 8) < i)
+        i = (outdatabsz * 3 / 8);
+
+    const uint8_t* indata = (const uint8_t*)indata_p;
+    float* out[CHCNT];
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        out[c] = (float*)outdata[c];
+
+    const __m256  scale = _mm256_set1_ps(CONV_SCALE);
+    const __m256i mhi   = _mm256_set1_epi32(0xfff00000);
+    const __m256i mlo   = _mm256_set1_epi32(0x0000fff0);
+    const __m256i mx    = _mm256_set_epi8(0xB, 0xA, 0x9, 0x80,
+                                          0x8, 0x7, 0x6, 0x80,
+                                          0x5, 0x4, 0x3, 0x80,
+                                          0x2, 0x1, 0x0, 0x80,
+                                          0xB, 0xA, 0x9, 0x80,
+                                          0x8, 0x7, 0x6, 0x80,
+                                          0x5, 0x4, 0x3, 0x80,
+                                          0x2, 0x1, 0x0, 0x80);
+
+    // ticks t and t + 4 of 4 channels, packed ci12 -> ci16 words
+#define LOAD_ROW(r, t) \
+    { \
+        __m256i q = _mm256_inserti128_si256( \
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(indata + 3 * ((t) * CHCNT + g)))), \
+            _mm_loadu_si128((const __m128i*)(indata + 3 * (((t) + 4) * CHCNT + g))), 1); \
+        __m256i z = _mm256_shuffle_epi8(q, mx); \
+        r = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(z, mhi), \
+                                                _mm256_and_si256(_mm256_srli_epi32(z, 4), mlo))); \
+    }
+
+#define CONVERT_CI16_CF32_STORE(r, o) \
+    { \
+        __m256i v  = _mm256_castps_si256(r); \
+        __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(v)); \
+        __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(v, 1)); \
+        _mm256_storeu_ps(o + 0, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale)); \
+        _mm256_storeu_ps(o + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale)); \
+        o += 16; \
+    }
+
+    // the last row load reads 4 bytes past the block
+    for (; i >= 24 * CHCNT + 4; i -= 24 * CHCNT) {
+        for (unsigned g = 0; g < CHCNT; g += 4) {
+            __m256 r0, r1, r2, r3;
+
+            LOAD_ROW(r0, 0);
+            LOAD_ROW(r1, 1);
+            LOAD_ROW(r2, 2);
+            LOAD_ROW(r3, 3);
+
+            __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+            __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+            __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+            __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+
+            r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+            CONVERT_CI16_CF32_STORE(r0, out[g + 0]);
+            CONVERT_CI16_CF32_STORE(r1, out[g + 1]);
+            CONVERT_CI16_CF32_STORE(r2, out[g + 2]);
+            CONVERT_CI16_CF32_STORE(r3, out[g + 3]);
+        }
+        indata += 24 * CHCNT;
+    }
+
+#undef CONVERT_CI16_CF32_STORE
+#undef LOAD_ROW
+
+    for (; i >= 3 * CHCNT; i -= 3 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            uint8_t v0 = *(indata++);
+            uint8_t v1 = *(indata++);
+            uint8_t v2 = *(indata++);
+
+            float a = (int16_t) (((uint16_t)v0 << 4) | ((uint16_t)v1 << 12));
+            float b = (int16_t) (((uint16_t)v2 << 8) | (v1 & 0xf0));
+
+            *(out[c]++) = a * CONV_SCALE;
+            *(out[c]++) = b * CONV_SCALE;
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
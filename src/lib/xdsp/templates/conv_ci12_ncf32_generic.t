@@ -0,0 +1,35 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata_p,
+                        unsigned indatabsz,
+                        void *__restrict *__restrict outdata,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    /* 12 bits -> 32 bits  =>  3 -> 8   */
+    if ((outdatabsz * 3 / 8) < i)
+        i = (outdatabsz * 3 / 8);
+
+    const uint8_t* indata = (const uint8_t*)indata_p;
+    float* out[CHCNT];
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        out[c] = (float*)outdata[c];
+
+    for (; i >= 3 * CHCNT; i -= 3 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            uint8_t v0 = *(indata++);
+            uint8_t v1 = *(indata++);
+            uint8_t v2 = *(indata++);
+
+            float a = (int16_t) (((uint16_t)v0 << 4) | ((uint16_t)v1 << 12));
+            float b = (int16_t) (((uint16_t)v2 << 8) | (v1 & 0xf0));
+
+            *(out[c]++) = a * CONV_SCALE;
+            *(out[c]++) = b * CONV_SCALE;
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
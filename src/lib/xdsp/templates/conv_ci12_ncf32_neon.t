@@ -0,0 +1,90 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata_p,
+                        unsigned indatabsz,
+                        void *__restrict *__restrict outdata,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    /* 12 bits -> 32 bits  =>  3 -> 8   */
+    if ((outdatabsz * 3 / 8) < i)
+        i = (outdatabsz * 3 / 8);
+
+    const uint8_t* indata = (const uint8_t*)indata_p;
+    float* out[CHCNT];
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        out[c] = (float*)outdata[c];
+
+    const uint16x8_t m0f0 = vdupq_n_u16(0xf0);
+
+    // 8 packed ci12 samples -> 2 x 4 ci16 words
+#define UNPACK_CI12(b0, b1, b2, m) \
+    { \
+        uint16x8_t w0 = vmovl_u8(b0); \
+        uint16x8_t w1 = vmovl_u8(b1); \
+        uint16x8_t w2 = vmovl_u8(b2); \
+        uint16x8x2_t iq = vzipq_u16(vorrq_u16(vshlq_n_u16(w0, 4), vshlq_n_u16(w1, 12)), \
+                                    vorrq_u16(vandq_u16(w1, m0f0), vshlq_n_u16(w2, 8))); \
+        (m)[0] = vreinterpretq_u32_u16(iq.val[0]); \
+        (m)[1] = vreinterpretq_u32_u16(iq.val[1]); \
+    }
+
+#define CONVERT_CI16_CF32_STORE(r, o) \
+    { \
+        int16x8_t v = vreinterpretq_s16_u32(r); \
+        vst1q_f32(o + 0, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), CONV_SCALE)); \
+        vst1q_f32(o + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), CONV_SCALE)); \
+        o += 8; \
+    }
+
+    // 32 samples per iteration, m[k] holds samples 4k..4k+3 in wire order
+    for (; i >= 96; i -= 96) {
+        uint32x4_t m[8];
+        uint8x16x3_t a = vld3q_u8(indata);
+        uint8x16x3_t b = vld3q_u8(indata + 48);
+        indata += 96;
+
+        UNPACK_CI12(vget_low_u8(a.val[0]), vget_low_u8(a.val[1]), vget_low_u8(a.val[2]), m + 0);
+        UNPACK_CI12(vget_high_u8(a.val[0]), vget_high_u8(a.val[1]), vget_high_u8(a.val[2]), m + 2);
+        UNPACK_CI12(vget_low_u8(b.val[0]), vget_low_u8(b.val[1]), vget_low_u8(b.val[2]), m + 4);
+        UNPACK_CI12(vget_high_u8(b.val[0]), vget_high_u8(b.val[1]), vget_high_u8(b.val[2]), m + 6);
+
+        for (unsigned ts = 0; ts < 32 / CHCNT; ts += 4) {
+            for (unsigned g = 0; g < CHCNT / 4; g++) {
+                uint32x4x2_t t01 = vtrnq_u32(m[(ts + 0) * (CHCNT / 4) + g], m[(ts + 1) * (CHCNT / 4) + g]);
+                uint32x4x2_t t23 = vtrnq_u32(m[(ts + 2) * (CHCNT / 4) + g], m[(ts + 3) * (CHCNT / 4) + g]);
+
+                uint32x4_t c0 = vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0]));
+                uint32x4_t c1 = vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1]));
+                uint32x4_t c2 = vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0]));
+                uint32x4_t c3 = vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1]));
+
+                CONVERT_CI16_CF32_STORE(c0, out[4 * g + 0]);
+                CONVERT_CI16_CF32_STORE(c1, out[4 * g + 1]);
+                CONVERT_CI16_CF32_STORE(c2, out[4 * g + 2]);
+                CONVERT_CI16_CF32_STORE(c3, out[4 * g + 3]);
+            }
+        }
+    }
+
+#undef CONVERT_CI16_CF32_STORE
+#undef UNPACK_CI12
+
+    for (; i >= 3 * CHCNT; i -= 3 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            uint8_t v0 = *(indata++);
+            uint8_t v1 = *(indata++);
+            uint8_t v2 = *(indata++);
+
+            float a = (int16_t) (((uint16_t)v0 << 4) | ((uint16_t)v1 << 12));
+            float b = (int16_t) (((uint16_t)v2 << 8) | (v1 & 0xf0));
+
+            *(out[c]++) = a * CONV_SCALE;
+            *(out[c]++) = b * CONV_SCALE;
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
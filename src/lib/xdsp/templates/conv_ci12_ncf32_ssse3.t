@@ -0,0 +1,86 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata_p,
+                        unsigned indatabsz,
+                        void *__restrict *__restrict outdata,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    /* 12 bits -> 32 bits  =>  3 -> 8   */
+    if ((outdatabsz * 3 / 8) < i)
+        i = (outdatabsz * 3 / 8);
+
+    const uint8_t* indata = (const uint8_t*)indata_p;
+    float* out[CHCNT];
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        out[c] = (float*)outdata[c];
+
+    const __m128 scale = _mm_set1_ps(CONV_SCALE);
+    const __m128i mhi  = _mm_set1_epi32(0xfff00000);
+    const __m128i mlo  = _mm_set1_epi32(0x0000fff0);
+    const __m128i mx   = _mm_set_epi8(0xB, 0xA, 0x9, 0x80,
+                                      0x8, 0x7, 0x6, 0x80,
+                                      0x5, 0x4, 0x3, 0x80,
+                                      0x2, 0x1, 0x0, 0x80);
+
+    /*
+     * 4 packed ci12 samples (12 bytes) -> 4 ci16 words
+     *  lane:  | Q11..Q0 I11..I4 | I3..I0 0000 0000 |  =>  | Q << 4 | I << 4 |
+     */
+#define LOAD_ROW(r, t) \
+    { \
+        __m128i z = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(indata + 3 * ((t) * CHCNT + g))), mx); \
+        r = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(z, mhi), _mm_and_si128(_mm_srli_epi32(z, 4), mlo))); \
+    }
+
+#define CONVERT_CI16_CF32_STORE(r, o) \
+    { \
+        __m128i v  = _mm_castps_si128(r); \
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16); \
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16); \
+        _mm_storeu_ps(o + 0, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale)); \
+        _mm_storeu_ps(o + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale)); \
+        o += 8; \
+    }
+
+    // the last row load reads 4 bytes past the block
+    for (; i >= 12 * CHCNT + 4; i -= 12 * CHCNT) {
+        for (unsigned g = 0; g < CHCNT; g += 4) {
+            __m128 r0, r1, r2, r3;
+
+            LOAD_ROW(r0, 0);
+            LOAD_ROW(r1, 1);
+            LOAD_ROW(r2, 2);
+            LOAD_ROW(r3, 3);
+
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+            CONVERT_CI16_CF32_STORE(r0, out[g + 0]);
+            CONVERT_CI16_CF32_STORE(r1, out[g + 1]);
+            CONVERT_CI16_CF32_STORE(r2, out[g + 2]);
+            CONVERT_CI16_CF32_STORE(r3, out[g + 3]);
+        }
+        indata += 12 * CHCNT;
+    }
+
+#undef CONVERT_CI16_CF32_STORE
+#undef LOAD_ROW
+
+    for (; i >= 3 * CHCNT; i -= 3 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            uint8_t v0 = *(indata++);
+            uint8_t v1 = *(indata++);
+            uint8_t v2 = *(indata++);
+
+            float a = (int16_t) (((uint16_t)v0 << 4) | ((uint16_t)v1 << 12));
+            float b = (int16_t) (((uint16_t)v2 << 8) | (v1 & 0xf0));
+
+            *(out[c]++) = a * CONV_SCALE;
+            *(out[c]++) = b * CONV_SCALE;
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,58 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict *__restrict outdata,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if (outdatabsz < i)
+        i = outdatabsz;
+
+    const int16_t* ld = (const int16_t*)indata;
+    uint16_t* out[CHCNT];
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        out[c] = (uint16_t*)outdata[c];
+
+    const __m256 scale = _mm256_set1_ps(CONV_SCALE);
+
+#define CONVERT_CI16_CF16_STORE(v, o) \
+    { \
+        __m256 f = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v)), scale); \
+        _mm_storeu_si128((__m128i*)(o), _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT)); \
+        o += 8; \
+    }
+
+    // 8 time ticks of 1 channel or 4 time ticks of 2 channels per iteration
+#if CHCNT == 2
+    const __m256i deint = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+#endif
+    for (; i >= 32; i -= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)ld);
+#if CHCNT == 1
+        CONVERT_CI16_CF16_STORE(_mm256_castsi256_si128(v), out[0]);
+        CONVERT_CI16_CF16_STORE(_mm256_extracti128_si256(v, 1), out[0]);
+#else
+        v = _mm256_permutevar8x32_epi32(v, deint);
+        CONVERT_CI16_CF16_STORE(_mm256_castsi256_si128(v), out[0]);
+        CONVERT_CI16_CF16_STORE(_mm256_extracti128_si256(v, 1), out[1]);
+#endif
+        ld += 16;
+    }
+
+#undef CONVERT_CI16_CF16_STORE
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            float a = *(ld++);
+            float b = *(ld++);
+
+            *(out[c]++) = wvlt_f32_to_f16(a * CONV_SCALE);
+            *(out[c]++) = wvlt_f32_to_f16(b * CONV_SCALE);
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
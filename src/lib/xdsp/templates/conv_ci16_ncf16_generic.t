@@ -0,0 +1,30 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict *__restrict outdata,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if (outdatabsz < i)
+        i = outdatabsz;
+
+    const int16_t* ld = (const int16_t*)indata;
+    uint16_t* out[CHCNT];
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        out[c] = (uint16_t*)outdata[c];
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            float a = *(ld++);
+            float b = *(ld++);
+
+            *(out[c]++) = wvlt_f32_to_f16(a * CONV_SCALE);
+            *(out[c]++) = wvlt_f32_to_f16(b * CONV_SCALE);
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,57 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict *__restrict outdata,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if (outdatabsz < i)
+        i = outdatabsz;
+
+    const int16_t* ld = (const int16_t*)indata;
+    uint16_t* out[CHCNT];
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        out[c] = (uint16_t*)outdata[c];
+
+    // FCVTN narrows with round to nearest even, same as the generic kernel
+#define CONVERT_CI16_CF16_STORE(v, o) \
+    { \
+        float32x4_t lo = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), CONV_SCALE); \
+        float32x4_t hi = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), CONV_SCALE); \
+        vst1q_u16(o, vreinterpretq_u16_f16(vcombine_f16(vcvt_f16_f32(lo), vcvt_f16_f32(hi)))); \
+        o += 8; \
+    }
+
+    // 8 time ticks of 1 channel or 4 time ticks of 2 channels per iteration
+    for (; i >= 32; i -= 32) {
+#if CHCNT == 1
+        int16x8x2_t r = { { vld1q_s16(ld), vld1q_s16(ld + 8) } };
+
+        CONVERT_CI16_CF16_STORE(r.val[0], out[0]);
+        CONVERT_CI16_CF16_STORE(r.val[1], out[0]);
+#else
+        uint32x4x2_t r = vld2q_u32((const uint32_t*)ld);
+
+        CONVERT_CI16_CF16_STORE(vreinterpretq_s16_u32(r.val[0]), out[0]);
+        CONVERT_CI16_CF16_STORE(vreinterpretq_s16_u32(r.val[1]), out[1]);
+#endif
+        ld += 16;
+    }
+
+#undef CONVERT_CI16_CF16_STORE
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            float a = *(ld++);
+            float b = *(ld++);
+
+            *(out[c]++) = wvlt_f32_to_f16(a * CONV_SCALE);
+            *(out[c]++) = wvlt_f32_to_f16(b * CONV_SCALE);
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
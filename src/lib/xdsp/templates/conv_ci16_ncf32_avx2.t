@@ -0,0 +1,81 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict *__restrict outdata,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz / 2) < i)
+        i = (outdatabsz / 2);
+
+    const uint32_t* ld = (const uint32_t*)indata;
+    float* out[CHCNT];
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        out[c] = (float*)outdata[c];
+
+    const __m256 scale = _mm256_set1_ps(CONV_SCALE);
+
+#define LOAD_ROW(t) \
+    _mm256_castsi256_ps(_mm256_inserti128_si256( \
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(ld + (t) * CHCNT + g))), \
+        _mm_loadu_si128((const __m128i*)(ld + ((t) + 4) * CHCNT + g)), 1))
+
+#define CONVERT_CI16_CF32_STORE(r, o) \
+    { \
+        __m256i v  = _mm256_castps_si256(r); \
+        __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(v)); \
+        __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(v, 1)); \
+        _mm256_storeu_ps(o + 0, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale)); \
+        _mm256_storeu_ps(o + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale)); \
+        o += 16; \
+    }
+
+    /*
+     * Lower lanes take ticks 0..3, upper lanes ticks 4..7, so in-lane 4x4
+     * transpose leaves 8 consecutive samples of one channel in a register
+     */
+    for (; i >= 32 * CHCNT; i -= 32 * CHCNT) {
+        for (unsigned g = 0; g < CHCNT; g += 4) {
+            __m256 r0 = LOAD_ROW(0);
+            __m256 r1 = LOAD_ROW(1);
+            __m256 r2 = LOAD_ROW(2);
+            __m256 r3 = LOAD_ROW(3);
+
+            __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+            __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+            __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+            __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+
+            r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+            CONVERT_CI16_CF32_STORE(r0, out[g + 0]);
+            CONVERT_CI16_CF32_STORE(r1, out[g + 1]);
+            CONVERT_CI16_CF32_STORE(r2, out[g + 2]);
+            CONVERT_CI16_CF32_STORE(r3, out[g + 3]);
+        }
+        ld += 8 * CHCNT;
+    }
+
+#undef CONVERT_CI16_CF32_STORE
+#undef LOAD_ROW
+
+    const int16_t* ld16 = (const int16_t*)ld;
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            float a = *(ld16++);
+            float b = *(ld16++);
+
+            *(out[c]++) = a * CONV_SCALE;
+            *(out[c]++) = b * CONV_SCALE;
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
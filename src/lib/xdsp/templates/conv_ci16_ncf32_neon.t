@@ -0,0 +1,66 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict *__restrict outdata,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz / 2) < i)
+        i = (outdatabsz / 2);
+
+    const uint32_t* ld = (const uint32_t*)indata;
+    float* out[CHCNT];
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        out[c] = (float*)outdata[c];
+
+#define CONVERT_CI16_CF32_STORE(r, o) \
+    { \
+        int16x8_t v = vreinterpretq_s16_u32(r); \
+        vst1q_f32(o + 0, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), CONV_SCALE)); \
+        vst1q_f32(o + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), CONV_SCALE)); \
+        o += 8; \
+    }
+
+    // 4 time ticks per iteration, each ci16 sample is handled as 32-bit word
+    for (; i >= 16 * CHCNT; i -= 16 * CHCNT) {
+#if CHCNT == 4
+        uint32x4x4_t r = vld4q_u32(ld);
+
+        CONVERT_CI16_CF32_STORE(r.val[0], out[0]);
+        CONVERT_CI16_CF32_STORE(r.val[1], out[1]);
+        CONVERT_CI16_CF32_STORE(r.val[2], out[2]);
+        CONVERT_CI16_CF32_STORE(r.val[3], out[3]);
+#else
+        // a.val[k] = [t0.ch(k), t0.ch(k+4), t1.ch(k), t1.ch(k+4)]
+        uint32x4x4_t a = vld4q_u32(ld);
+        uint32x4x4_t b = vld4q_u32(ld + 16);
+
+        for (unsigned k = 0; k < 4; k++) {
+            uint32x4x2_t z = vuzpq_u32(a.val[k], b.val[k]);
+
+            CONVERT_CI16_CF32_STORE(z.val[0], out[k]);
+            CONVERT_CI16_CF32_STORE(z.val[1], out[k + 4]);
+        }
+#endif
+        ld += 4 * CHCNT;
+    }
+
+#undef CONVERT_CI16_CF32_STORE
+
+    const int16_t* ld16 = (const int16_t*)ld;
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            float a = *(ld16++);
+            float b = *(ld16++);
+
+            *(out[c]++) = a * CONV_SCALE;
+            *(out[c]++) = b * CONV_SCALE;
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
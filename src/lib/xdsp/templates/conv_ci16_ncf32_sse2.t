@@ -0,0 +1,67 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict *__restrict outdata,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz / 2) < i)
+        i = (outdatabsz / 2);
+
+    const uint32_t* ld = (const uint32_t*)indata;
+    float* out[CHCNT];
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        out[c] = (float*)outdata[c];
+
+    const __m128 scale = _mm_set1_ps(CONV_SCALE);
+
+#define CONVERT_CI16_CF32_STORE(r, o) \
+    { \
+        __m128i v  = _mm_castps_si128(r); \
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16); \
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16); \
+        _mm_storeu_ps(o + 0, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale)); \
+        _mm_storeu_ps(o + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale)); \
+        o += 8; \
+    }
+
+    /*
+     * Every ci16 sample is handled as 32-bit word, 4 time ticks of 4 channels
+     * are transposed so each register holds 4 consecutive samples of one channel
+     */
+    for (; i >= 16 * CHCNT; i -= 16 * CHCNT) {
+        for (unsigned g = 0; g < CHCNT; g += 4) {
+            __m128 r0 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(ld + 0 * CHCNT + g)));
+            __m128 r1 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(ld + 1 * CHCNT + g)));
+            __m128 r2 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(ld + 2 * CHCNT + g)));
+            __m128 r3 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(ld + 3 * CHCNT + g)));
+
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+            CONVERT_CI16_CF32_STORE(r0, out[g + 0]);
+            CONVERT_CI16_CF32_STORE(r1, out[g + 1]);
+            CONVERT_CI16_CF32_STORE(r2, out[g + 2]);
+            CONVERT_CI16_CF32_STORE(r3, out[g + 3]);
+        }
+        ld += 4 * CHCNT;
+    }
+
+#undef CONVERT_CI16_CF32_STORE
+
+    const int16_t* ld16 = (const int16_t*)ld;
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            float a = *(ld16++);
+            float b = *(ld16++);
+
+            *(out[c]++) = a * CONV_SCALE;
+            *(out[c]++) = b * CONV_SCALE;
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,160 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict *__restrict outdata,
+                        unsigned outdatabsz,
+                        conv_ch_stat_t *__restrict stat)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz / 2) < i)
+        i = (outdatabsz / 2);
+
+    const uint32_t* ld = (const uint32_t*)indata;
+    float* out[CHCNT];
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        out[c] = (float*)outdata[c];
+
+    const __m256 scale = _mm256_set1_ps(CONV_SCALE);
+    const __m256i fs = _mm256_set1_epi16(CONV_CLIP);
+    const __m256i one16 = _mm256_set1_epi16(1);
+    const __m256i seli = _mm256_set1_epi32(0x00000001);
+    const __m256i selq = _mm256_set1_epi32(0x00010000);
+    const __m256i zero = _mm256_setzero_si256();
+#if CHCNT == 2
+    const __m256i idx = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+#endif
+
+    // Statistics are gathered on raw wire words, lane k collects samples of channel k % CHCNT
+    __m256i pk = zero, cl = zero, si, sq, ss_lo = zero, ss_hi = zero;
+    int64_t lsi[8] = {0};
+    int64_t lsq[8] = {0};
+
+#define UPDATE_STAT(v) \
+    { \
+        __m256i av = _mm256_abs_epi16(v); \
+        __m256i p  = _mm256_madd_epi16(v, v); \
+        pk = _mm256_max_epu16(pk, av); \
+        cl = _mm256_sub_epi32(cl, _mm256_madd_epi16(_mm256_cmpeq_epi16(_mm256_max_epu16(av, fs), av), one16)); \
+        si = _mm256_add_epi32(si, _mm256_madd_epi16(v, seli)); \
+        sq = _mm256_add_epi32(sq, _mm256_madd_epi16(v, selq)); \
+        ss_lo = _mm256_add_epi64(ss_lo, _mm256_unpacklo_epi32(p, zero)); \
+        ss_hi = _mm256_add_epi64(ss_hi, _mm256_unpackhi_epi32(p, zero)); \
+    }
+
+#define CONVERT_CI16_CF32_STORE(v, o) \
+    { \
+        __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(v)); \
+        __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(v, 1)); \
+        _mm256_storeu_ps(o + 0, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale)); \
+        _mm256_storeu_ps(o + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale)); \
+        o += 16; \
+    }
+
+    // Rows hold ticks [t | t + 4] of channels g..g+3, in-lane 4x4 transpose
+#define TRANSPOSE_STORE(a0, a1, a2, a3, g) \
+    { \
+        __m256 t0 = _mm256_unpacklo_ps(_mm256_castsi256_ps(a0), _mm256_castsi256_ps(a1)); \
+        __m256 t1 = _mm256_unpackhi_ps(_mm256_castsi256_ps(a0), _mm256_castsi256_ps(a1)); \
+        __m256 t2 = _mm256_unpacklo_ps(_mm256_castsi256_ps(a2), _mm256_castsi256_ps(a3)); \
+        __m256 t3 = _mm256_unpackhi_ps(_mm256_castsi256_ps(a2), _mm256_castsi256_ps(a3)); \
+        __m256i c0 = _mm256_castps_si256(_mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0))); \
+        __m256i c1 = _mm256_castps_si256(_mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2))); \
+        __m256i c2 = _mm256_castps_si256(_mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0))); \
+        __m256i c3 = _mm256_castps_si256(_mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2))); \
+        CONVERT_CI16_CF32_STORE(c0, out[(g) + 0]); \
+        CONVERT_CI16_CF32_STORE(c1, out[(g) + 1]); \
+        CONVERT_CI16_CF32_STORE(c2, out[(g) + 2]); \
+        CONVERT_CI16_CF32_STORE(c3, out[(g) + 3]); \
+    }
+
+    while (i >= 32 * CHCNT) {
+        si = sq = zero;
+
+        // 8 time ticks per iteration, each ci16 sample is handled as 32-bit word
+        for (unsigned n = 0; n < STAT_CHUNK && i >= 32 * CHCNT; n++, i -= 32 * CHCNT) {
+            __m256i r[CHCNT];
+
+            for (unsigned j = 0; j < CHCNT; j++) {
+                r[j] = _mm256_loadu_si256((const __m256i*)(ld + 8 * j));
+                UPDATE_STAT(r[j]);
+            }
+
+#if CHCNT == 1
+            CONVERT_CI16_CF32_STORE(r[0], out[0]);
+#elif CHCNT == 2
+            __m256i p0 = _mm256_permutevar8x32_epi32(r[0], idx);
+            __m256i p1 = _mm256_permutevar8x32_epi32(r[1], idx);
+            __m256i c0 = _mm256_permute2x128_si256(p0, p1, 0x20);
+            __m256i c1 = _mm256_permute2x128_si256(p0, p1, 0x31);
+
+            CONVERT_CI16_CF32_STORE(c0, out[0]);
+            CONVERT_CI16_CF32_STORE(c1, out[1]);
+#elif CHCNT == 4
+            // r[j] = [tick 2j | tick 2j + 1]
+            TRANSPOSE_STORE(_mm256_permute2x128_si256(r[0], r[2], 0x20),
+                            _mm256_permute2x128_si256(r[0], r[2], 0x31),
+                            _mm256_permute2x128_si256(r[1], r[3], 0x20),
+                            _mm256_permute2x128_si256(r[1], r[3], 0x31), 0);
+#else
+            // r[j] = [tick j channels 0..3 | tick j channels 4..7]
+            TRANSPOSE_STORE(_mm256_permute2x128_si256(r[0], r[4], 0x20),
+                            _mm256_permute2x128_si256(r[1], r[5], 0x20),
+                            _mm256_permute2x128_si256(r[2], r[6], 0x20),
+                            _mm256_permute2x128_si256(r[3], r[7], 0x20), 0);
+            TRANSPOSE_STORE(_mm256_permute2x128_si256(r[0], r[4], 0x31),
+                            _mm256_permute2x128_si256(r[1], r[5], 0x31),
+                            _mm256_permute2x128_si256(r[2], r[6], 0x31),
+                            _mm256_permute2x128_si256(r[3], r[7], 0x31), 4);
+#endif
+            ld += 8 * CHCNT;
+        }
+
+        int32_t vsi[8], vsq[8];
+        _mm256_storeu_si256((__m256i*)vsi, si);
+        _mm256_storeu_si256((__m256i*)vsq, sq);
+
+        for (unsigned k = 0; k < 8; k++) {
+            lsi[k] += vsi[k];
+            lsq[k] += vsq[k];
+        }
+    }
+
+    uint16_t vpk[16];
+    uint32_t vcl[8];
+    uint64_t vss_lo[4], vss_hi[4];
+    _mm256_storeu_si256((__m256i*)vpk, pk);
+    _mm256_storeu_si256((__m256i*)vcl, cl);
+    _mm256_storeu_si256((__m256i*)vss_lo, ss_lo);
+    _mm256_storeu_si256((__m256i*)vss_hi, ss_hi);
+
+    // unpack{lo,hi}_epi32 work in-lane: ss_lo holds lanes 0,1,4,5 and ss_hi lanes 2,3,6,7
+    for (unsigned k = 0; k < 8; k++) {
+        uint64_t ssq = ((k & 2) ? vss_hi : vss_lo)[(k & 1) | ((k >> 1) & 2)];
+
+        ci16_stat_fold(&stat[k % CHCNT], lsi[k], lsq[k], ssq,
+                       vpk[2 * k], vpk[2 * k + 1], vcl[k]);
+    }
+
+#undef TRANSPOSE_STORE
+#undef CONVERT_CI16_CF32_STORE
+#undef UPDATE_STAT
+
+    const int16_t* ld16 = (const int16_t*)ld;
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            int16_t a = *(ld16++);
+            int16_t b = *(ld16++);
+
+            ci16_stat_update(&stat[c], a, b);
+
+            *(out[c]++) = a * CONV_SCALE;
+            *(out[c]++) = b * CONV_SCALE;
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
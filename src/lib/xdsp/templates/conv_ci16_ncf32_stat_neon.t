@@ -0,0 +1,146 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict *__restrict outdata,
+                        unsigned outdatabsz,
+                        conv_ch_stat_t *__restrict stat)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz / 2) < i)
+        i = (outdatabsz / 2);
+
+    const uint32_t* ld = (const uint32_t*)indata;
+    float* out[CHCNT];
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        out[c] = (float*)outdata[c];
+
+    const uint16x8_t fs = vdupq_n_u16(CONV_CLIP);
+
+    /*
+     * Statistics are gathered on raw wire words, lane k of accumulator set a
+     * collects samples of channel (4 * a + k) % CHCNT; s_lo/s_hi hold interleaved I/Q sums
+     */
+#define ACCN ((CHCNT + 3) / 4)
+    uint16x8_t pk[ACCN];
+    uint32x4_t cl[ACCN];
+    int32x4_t s_lo[ACCN], s_hi[ACCN];
+    uint64x2_t ss_lo[ACCN], ss_hi[ACCN];
+    int64_t lsi[4 * ACCN] = {0};
+    int64_t lsq[4 * ACCN] = {0};
+
+    for (unsigned a = 0; a < ACCN; a++) {
+        pk[a] = vdupq_n_u16(0);
+        cl[a] = vdupq_n_u32(0);
+        ss_lo[a] = ss_hi[a] = vdupq_n_u64(0);
+    }
+
+#define UPDATE_STAT(r, a) \
+    { \
+        int16x8_t v = vreinterpretq_s16_u32(r); \
+        uint16x8_t av = vreinterpretq_u16_s16(vabsq_s16(v)); \
+        pk[a] = vmaxq_u16(pk[a], av); \
+        cl[a] = vpadalq_u16(cl[a], vshrq_n_u16(vcgeq_u16(av, fs), 15)); \
+        s_lo[a] = vaddw_s16(s_lo[a], vget_low_s16(v)); \
+        s_hi[a] = vaddw_s16(s_hi[a], vget_high_s16(v)); \
+        ss_lo[a] = vpadalq_u32(ss_lo[a], vreinterpretq_u32_s32(vmull_s16(vget_low_s16(v), vget_low_s16(v)))); \
+        ss_hi[a] = vpadalq_u32(ss_hi[a], vreinterpretq_u32_s32(vmull_s16(vget_high_s16(v), vget_high_s16(v)))); \
+    }
+
+#define CONVERT_CI16_CF32_STORE(r, o) \
+    { \
+        int16x8_t v = vreinterpretq_s16_u32(r); \
+        vst1q_f32(o + 0, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), CONV_SCALE)); \
+        vst1q_f32(o + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), CONV_SCALE)); \
+        o += 8; \
+    }
+
+    while (i >= 16 * CHCNT) {
+        for (unsigned a = 0; a < ACCN; a++) {
+            s_lo[a] = s_hi[a] = vdupq_n_s32(0);
+        }
+
+        // 4 time ticks per iteration, each ci16 sample is handled as 32-bit word
+        for (unsigned n = 0; n < STAT_CHUNK && i >= 16 * CHCNT; n++, i -= 16 * CHCNT) {
+            uint32x4_t r[CHCNT];
+
+            for (unsigned j = 0; j < CHCNT; j++) {
+                r[j] = vld1q_u32(ld + 4 * j);
+                UPDATE_STAT(r[j], j % ACCN);
+            }
+
+#if CHCNT == 1
+            CONVERT_CI16_CF32_STORE(r[0], out[0]);
+#elif CHCNT == 2
+            uint32x4x2_t z = vuzpq_u32(r[0], r[1]);
+
+            CONVERT_CI16_CF32_STORE(z.val[0], out[0]);
+            CONVERT_CI16_CF32_STORE(z.val[1], out[1]);
+#else
+            for (unsigned g = 0; g < CHCNT / 4; g++) {
+                uint32x4x2_t t01 = vtrnq_u32(r[g + 0 * (CHCNT / 4)], r[g + 1 * (CHCNT / 4)]);
+                uint32x4x2_t t23 = vtrnq_u32(r[g + 2 * (CHCNT / 4)], r[g + 3 * (CHCNT / 4)]);
+
+                uint32x4_t c0 = vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0]));
+                uint32x4_t c1 = vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1]));
+                uint32x4_t c2 = vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0]));
+                uint32x4_t c3 = vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1]));
+
+                CONVERT_CI16_CF32_STORE(c0, out[4 * g + 0]);
+                CONVERT_CI16_CF32_STORE(c1, out[4 * g + 1]);
+                CONVERT_CI16_CF32_STORE(c2, out[4 * g + 2]);
+                CONVERT_CI16_CF32_STORE(c3, out[4 * g + 3]);
+            }
+#endif
+            ld += 4 * CHCNT;
+        }
+
+        for (unsigned a = 0; a < ACCN; a++) {
+            int32_t vs[8];
+            vst1q_s32(vs + 0, s_lo[a]);
+            vst1q_s32(vs + 4, s_hi[a]);
+
+            for (unsigned k = 0; k < 4; k++) {
+                lsi[4 * a + k] += vs[2 * k];
+                lsq[4 * a + k] += vs[2 * k + 1];
+            }
+        }
+    }
+
+    for (unsigned a = 0; a < ACCN; a++) {
+        uint16_t vpk[8];
+        uint32_t vcl[4];
+        uint64_t vss[4];
+        vst1q_u16(vpk, pk[a]);
+        vst1q_u32(vcl, cl[a]);
+        vst1q_u64(vss + 0, ss_lo[a]);
+        vst1q_u64(vss + 2, ss_hi[a]);
+
+        for (unsigned k = 0; k < 4; k++) {
+            ci16_stat_fold(&stat[(4 * a + k) % CHCNT], lsi[4 * a + k], lsq[4 * a + k], vss[k],
+                           vpk[2 * k], vpk[2 * k + 1], vcl[k]);
+        }
+    }
+
+#undef CONVERT_CI16_CF32_STORE
+#undef UPDATE_STAT
+#undef ACCN
+
+    const int16_t* ld16 = (const int16_t*)ld;
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            int16_t a = *(ld16++);
+            int16_t b = *(ld16++);
+
+            ci16_stat_update(&stat[c], a, b);
+
+            *(out[c]++) = a * CONV_SCALE;
+            *(out[c]++) = b * CONV_SCALE;
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,147 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict *__restrict outdata,
+                        unsigned outdatabsz,
+                        conv_ch_stat_t *__restrict stat)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz / 2) < i)
+        i = (outdatabsz / 2);
+
+    const uint32_t* ld = (const uint32_t*)indata;
+    float* out[CHCNT];
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        out[c] = (float*)outdata[c];
+
+    const __m128 scale = _mm_set1_ps(CONV_SCALE);
+    const __m128i fs = _mm_set1_epi16(CONV_CLIP);
+    const __m128i one16 = _mm_set1_epi16(1);
+    const __m128i seli = _mm_set1_epi32(0x00000001);
+    const __m128i selq = _mm_set1_epi32(0x00010000);
+    const __m128i zero = _mm_setzero_si128();
+
+    /*
+     * Statistics are gathered on raw wire words, lane k of accumulator set a
+     * collects samples of channel (4 * a + k) % CHCNT
+     */
+#define ACCN ((CHCNT + 3) / 4)
+    __m128i pk[ACCN], cl[ACCN], si[ACCN], sq[ACCN], ss_lo[ACCN], ss_hi[ACCN];
+    int64_t lsi[4 * ACCN] = {0};
+    int64_t lsq[4 * ACCN] = {0};
+
+    for (unsigned a = 0; a < ACCN; a++) {
+        pk[a] = cl[a] = ss_lo[a] = ss_hi[a] = zero;
+    }
+
+#define UPDATE_STAT(v, a) \
+    { \
+        __m128i av = _mm_abs_epi16(v); \
+        __m128i p  = _mm_madd_epi16(v, v); \
+        pk[a] = _mm_max_epu16(pk[a], av); \
+        cl[a] = _mm_sub_epi32(cl[a], _mm_madd_epi16(_mm_cmpeq_epi16(_mm_max_epu16(av, fs), av), one16)); \
+        si[a] = _mm_add_epi32(si[a], _mm_madd_epi16(v, seli)); \
+        sq[a] = _mm_add_epi32(sq[a], _mm_madd_epi16(v, selq)); \
+        ss_lo[a] = _mm_add_epi64(ss_lo[a], _mm_unpacklo_epi32(p, zero)); \
+        ss_hi[a] = _mm_add_epi64(ss_hi[a], _mm_unpackhi_epi32(p, zero)); \
+    }
+
+#define CONVERT_CI16_CF32_STORE(v, o) \
+    { \
+        _mm_storeu_ps(o + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(v)), scale)); \
+        _mm_storeu_ps(o + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_unpackhi_epi64(v, v))), scale)); \
+        o += 8; \
+    }
+
+    while (i >= 16 * CHCNT) {
+        for (unsigned a = 0; a < ACCN; a++) {
+            si[a] = sq[a] = zero;
+        }
+
+        // 4 time ticks per iteration, each ci16 sample is handled as 32-bit word
+        for (unsigned n = 0; n < STAT_CHUNK && i >= 16 * CHCNT; n++, i -= 16 * CHCNT) {
+            __m128i r[CHCNT];
+
+            for (unsigned j = 0; j < CHCNT; j++) {
+                r[j] = _mm_loadu_si128((const __m128i*)(ld + 4 * j));
+                UPDATE_STAT(r[j], j % ACCN);
+            }
+
+#if CHCNT == 1
+            CONVERT_CI16_CF32_STORE(r[0], out[0]);
+#elif CHCNT == 2
+            __m128i s0 = _mm_shuffle_epi32(r[0], _MM_SHUFFLE(3, 1, 2, 0));
+            __m128i s1 = _mm_shuffle_epi32(r[1], _MM_SHUFFLE(3, 1, 2, 0));
+            __m128i c0 = _mm_unpacklo_epi64(s0, s1);
+            __m128i c1 = _mm_unpackhi_epi64(s0, s1);
+
+            CONVERT_CI16_CF32_STORE(c0, out[0]);
+            CONVERT_CI16_CF32_STORE(c1, out[1]);
+#else
+            for (unsigned g = 0; g < CHCNT / 4; g++) {
+                __m128 r0 = _mm_castsi128_ps(r[g + 0 * (CHCNT / 4)]);
+                __m128 r1 = _mm_castsi128_ps(r[g + 1 * (CHCNT / 4)]);
+                __m128 r2 = _mm_castsi128_ps(r[g + 2 * (CHCNT / 4)]);
+                __m128 r3 = _mm_castsi128_ps(r[g + 3 * (CHCNT / 4)]);
+
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+                CONVERT_CI16_CF32_STORE(_mm_castps_si128(r0), out[4 * g + 0]);
+                CONVERT_CI16_CF32_STORE(_mm_castps_si128(r1), out[4 * g + 1]);
+                CONVERT_CI16_CF32_STORE(_mm_castps_si128(r2), out[4 * g + 2]);
+                CONVERT_CI16_CF32_STORE(_mm_castps_si128(r3), out[4 * g + 3]);
+            }
+#endif
+            ld += 4 * CHCNT;
+        }
+
+        for (unsigned a = 0; a < ACCN; a++) {
+            int32_t vsi[4], vsq[4];
+            _mm_storeu_si128((__m128i*)vsi, si[a]);
+            _mm_storeu_si128((__m128i*)vsq, sq[a]);
+
+            for (unsigned k = 0; k < 4; k++) {
+                lsi[4 * a + k] += vsi[k];
+                lsq[4 * a + k] += vsq[k];
+            }
+        }
+    }
+
+    for (unsigned a = 0; a < ACCN; a++) {
+        uint16_t vpk[8];
+        uint32_t vcl[4];
+        uint64_t vss[4];
+        _mm_storeu_si128((__m128i*)vpk, pk[a]);
+        _mm_storeu_si128((__m128i*)vcl, cl[a]);
+        _mm_storeu_si128((__m128i*)&vss[0], ss_lo[a]);
+        _mm_storeu_si128((__m128i*)&vss[2], ss_hi[a]);
+
+        for (unsigned k = 0; k < 4; k++) {
+            ci16_stat_fold(&stat[(4 * a + k) % CHCNT], lsi[4 * a + k], lsq[4 * a + k], vss[k],
+                           vpk[2 * k], vpk[2 * k + 1], vcl[k]);
+        }
+    }
+
+#undef CONVERT_CI16_CF32_STORE
+#undef UPDATE_STAT
+#undef ACCN
+
+    const int16_t* ld16 = (const int16_t*)ld;
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            int16_t a = *(ld16++);
+            int16_t b = *(ld16++);
+
+            ci16_stat_update(&stat[c], a, b);
+
+            *(out[c]++) = a * CONV_SCALE;
+            *(out[c]++) = b * CONV_SCALE;
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,58 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict *__restrict outdata,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz) < i)
+        i = (outdatabsz);
+
+    const uint32_t* ld = (const uint32_t*)indata;
+    uint32_t* out[CHCNT];
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        out[c] = (uint32_t*)outdata[c];
+
+#define LOAD_ROW(t) \
+    _mm256_castsi256_ps(_mm256_inserti128_si256( \
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(ld + (t) * CHCNT + g))), \
+        _mm_loadu_si128((const __m128i*)(ld + ((t) + 4) * CHCNT + g)), 1))
+
+    for (; i >= 32 * CHCNT; i -= 32 * CHCNT) {
+        for (unsigned g = 0; g < CHCNT; g += 4) {
+            __m256 r0 = LOAD_ROW(0);
+            __m256 r1 = LOAD_ROW(1);
+            __m256 r2 = LOAD_ROW(2);
+            __m256 r3 = LOAD_ROW(3);
+
+            __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+            __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+            __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+            __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+
+            r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+            _mm256_storeu_si256((__m256i*)out[g + 0], _mm256_castps_si256(r0)); out[g + 0] += 8;
+            _mm256_storeu_si256((__m256i*)out[g + 1], _mm256_castps_si256(r1)); out[g + 1] += 8;
+            _mm256_storeu_si256((__m256i*)out[g + 2], _mm256_castps_si256(r2)); out[g + 2] += 8;
+            _mm256_storeu_si256((__m256i*)out[g + 3], _mm256_castps_si256(r3)); out[g + 3] += 8;
+        }
+        ld += 8 * CHCNT;
+    }
+
+#undef LOAD_ROW
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            *(out[c]++) = *(ld++);
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
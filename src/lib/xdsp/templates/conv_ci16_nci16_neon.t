@@ -0,0 +1,47 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict *__restrict outdata,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz) < i)
+        i = (outdatabsz);
+
+    const uint32_t* ld = (const uint32_t*)indata;
+    uint32_t* out[CHCNT];
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        out[c] = (uint32_t*)outdata[c];
+
+    for (; i >= 16 * CHCNT; i -= 16 * CHCNT) {
+#if CHCNT == 4
+        uint32x4x4_t r = vld4q_u32(ld);
+
+        for (unsigned k = 0; k < 4; k++) {
+            vst1q_u32(out[k], r.val[k]); out[k] += 4;
+        }
+#else
+        uint32x4x4_t a = vld4q_u32(ld);
+        uint32x4x4_t b = vld4q_u32(ld + 16);
+
+        for (unsigned k = 0; k < 4; k++) {
+            uint32x4x2_t z = vuzpq_u32(a.val[k], b.val[k]);
+
+            vst1q_u32(out[k], z.val[0]); out[k] += 4;
+            vst1q_u32(out[k + 4], z.val[1]); out[k + 4] += 4;
+        }
+#endif
+        ld += 4 * CHCNT;
+    }
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            *(out[c]++) = *(ld++);
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,43 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict *__restrict outdata,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz) < i)
+        i = (outdatabsz);
+
+    const uint32_t* ld = (const uint32_t*)indata;
+    uint32_t* out[CHCNT];
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        out[c] = (uint32_t*)outdata[c];
+
+    for (; i >= 16 * CHCNT; i -= 16 * CHCNT) {
+        for (unsigned g = 0; g < CHCNT; g += 4) {
+            __m128 r0 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(ld + 0 * CHCNT + g)));
+            __m128 r1 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(ld + 1 * CHCNT + g)));
+            __m128 r2 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(ld + 2 * CHCNT + g)));
+            __m128 r3 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(ld + 3 * CHCNT + g)));
+
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+            _mm_storeu_si128((__m128i*)out[g + 0], _mm_castps_si128(r0)); out[g + 0] += 4;
+            _mm_storeu_si128((__m128i*)out[g + 1], _mm_castps_si128(r1)); out[g + 1] += 4;
+            _mm_storeu_si128((__m128i*)out[g + 2], _mm_castps_si128(r2)); out[g + 2] += 4;
+            _mm_storeu_si128((__m128i*)out[g + 3], _mm_castps_si128(r3)); out[g + 3] += 4;
+        }
+        ld += 4 * CHCNT;
+    }
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            *(out[c]++) = *(ld++);
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
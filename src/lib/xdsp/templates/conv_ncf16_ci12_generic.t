@@ -0,0 +1,34 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz * 4 / 3) < i)
+        i = (outdatabsz * 4 / 3);
+
+    const uint16_t* in[CHCNT];
+    uint8_t* outdata = (uint8_t*)outdata_p;
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        in[c] = (const uint16_t*)indata[c];
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            int16_t f0 = wvlt_f16_to_i16(*(in[c]++), 1.0f / CONV_SCALE);
+            int16_t f1 = wvlt_f16_to_i16(*(in[c]++), 1.0f / CONV_SCALE);
+
+            wu_i16u32_t a = {{f0, f1}};
+            wu_u32b_t   v = {(a.u & 0xfff00000) | ((a.u << 4) & 0x000fff00)};
+
+            *(outdata++) = v.b[1];
+            *(outdata++) = v.b[2];
+            *(outdata++) = v.b[3];
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,58 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if (outdatabsz < i)
+        i = outdatabsz;
+
+    const uint16_t* in[CHCNT];
+    int16_t* outdata = (int16_t*)outdata_p;
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        in[c] = (const uint16_t*)indata[c];
+
+    const __m256 scale = _mm256_set1_ps(1.0f / CONV_SCALE);
+
+#define CONVERT_CF16_CI16(o, p) \
+    { \
+        __m256 f = _mm256_mul_ps(_mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(p))), scale); \
+        __m256i v = _mm256_cvtps_epi32(f); \
+        o = _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)); \
+        p += 8; \
+    }
+
+    // 8 time ticks of 1 channel or 4 time ticks of 2 channels per iteration
+    for (; i >= 32; i -= 32) {
+        __m128i a, b;
+#if CHCNT == 1
+        CONVERT_CF16_CI16(a, in[0]);
+        CONVERT_CF16_CI16(b, in[0]);
+#else
+        CONVERT_CF16_CI16(a, in[0]);
+        CONVERT_CF16_CI16(b, in[1]);
+
+        __m128i t = _mm_unpacklo_epi32(a, b);
+        b = _mm_unpackhi_epi32(a, b);
+        a = t;
+#endif
+        _mm_storeu_si128((__m128i*)(outdata + 0), a);
+        _mm_storeu_si128((__m128i*)(outdata + 8), b);
+        outdata += 16;
+    }
+
+#undef CONVERT_CF16_CI16
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            *(outdata++) = wvlt_f16_to_i16(*(in[c]++), 1.0f / CONV_SCALE);
+            *(outdata++) = wvlt_f16_to_i16(*(in[c]++), 1.0f / CONV_SCALE);
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,27 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if (outdatabsz < i)
+        i = outdatabsz;
+
+    const uint16_t* in[CHCNT];
+    int16_t* outdata = (int16_t*)outdata_p;
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        in[c] = (const uint16_t*)indata[c];
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            *(outdata++) = wvlt_f16_to_i16(*(in[c]++), 1.0f / CONV_SCALE);
+            *(outdata++) = wvlt_f16_to_i16(*(in[c]++), 1.0f / CONV_SCALE);
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,57 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if (outdatabsz < i)
+        i = outdatabsz;
+
+    const uint16_t* in[CHCNT];
+    int16_t* outdata = (int16_t*)outdata_p;
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        in[c] = (const uint16_t*)indata[c];
+
+#define CONVERT_CF16_CI16(o, p) \
+    { \
+        float16x8_t h = vreinterpretq_f16_u16(vld1q_u16(p)); \
+        int32x4_t lo = vcvtnq_s32_f32(vmulq_n_f32(vcvt_f32_f16(vget_low_f16(h)), 1.0f / CONV_SCALE)); \
+        int32x4_t hi = vcvtnq_s32_f32(vmulq_n_f32(vcvt_high_f32_f16(h), 1.0f / CONV_SCALE)); \
+        o = vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)); \
+        p += 8; \
+    }
+
+    // 8 time ticks of 1 channel or 4 time ticks of 2 channels per iteration
+    for (; i >= 32; i -= 32) {
+        int16x8_t a, b;
+#if CHCNT == 1
+        CONVERT_CF16_CI16(a, in[0]);
+        CONVERT_CF16_CI16(b, in[0]);
+
+        vst1q_s16(outdata + 0, a);
+        vst1q_s16(outdata + 8, b);
+#else
+        CONVERT_CF16_CI16(a, in[0]);
+        CONVERT_CF16_CI16(b, in[1]);
+
+        uint32x4x2_t z = { { vreinterpretq_u32_s16(a), vreinterpretq_u32_s16(b) } };
+        vst2q_u32((uint32_t*)outdata, z);
+#endif
+        outdata += 16;
+    }
+
+#undef CONVERT_CF16_CI16
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            *(outdata++) = wvlt_f16_to_i16(*(in[c]++), 1.0f / CONV_SCALE);
+            *(outdata++) = wvlt_f16_to_i16(*(in[c]++), 1.0f / CONV_SCALE);
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,34 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz * 8 / 3) < i)
+        i = (outdatabsz * 8 / 3);
+
+    const float* in[CHCNT];
+    uint8_t* outdata = (uint8_t*)outdata_p;
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        in[c] = (const float*)indata[c];
+
+    for (; i >= 8 * CHCNT; i -= 8 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            float f0 = *(in[c]++) / CONV_SCALE;
+            float f1 = *(in[c]++) / CONV_SCALE;
+
+            wu_i16u32_t a0 = {{I16RND(f0), I16RND(f1)}};
+            wu_u32b_t  c0 = {(a0.u & 0xfff00000) | ((a0.u << 4) & 0x000fff00)};
+
+            *(outdata++) = c0.b[1];
+            *(outdata++) = c0.b[2];
+            *(outdata++) = c0.b[3];
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,84 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz * 8 / 3) < i)
+        i = (outdatabsz * 8 / 3);
+
+    const float* in[CHCNT];
+    uint8_t* outdata = (uint8_t*)outdata_p;
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        in[c] = (const float*)indata[c];
+
+    const __m128  scale = _mm_set1_ps(1.0f / CONV_SCALE);
+    const __m128i mhi   = _mm_set1_epi32(0xfff00000);
+    const __m128i mlo   = _mm_set1_epi32(0x000fff00);
+    const __m128i mx    = _mm_set_epi8(0x80, 0x80, 0x80, 0x80,
+                                       0xF, 0xE, 0xD, 0xB,
+                                       0xA, 0x9, 0x7, 0x6,
+                                       0x5, 0x3, 0x2, 0x1);
+
+    // 4 samples of one channel -> 4 packed ci16 words
+#define CONVERT_CF32_CI16(r, p) \
+    { \
+        __m128i i0 = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(p + 0), scale)); \
+        __m128i i1 = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(p + 4), scale)); \
+        r = _mm_castsi128_ps(_mm_packs_epi32(i0, i1)); \
+        p += 8; \
+    }
+
+    // 4 ci16 words -> 12 bytes of packed ci12
+#define STORE_ROW(t, r) \
+    { \
+        __m128i v = _mm_castps_si128(r); \
+        v = _mm_or_si128(_mm_and_si128(v, mhi), _mm_and_si128(_mm_slli_epi32(v, 4), mlo)); \
+        v = _mm_shuffle_epi8(v, mx); \
+        uint8_t* o = outdata + 3 * ((t) * CHCNT + g); \
+        _mm_storel_epi64((__m128i*)o, v); \
+        *(uint32_t*)(o + 8) = _mm_cvtsi128_si32(_mm_srli_si128(v, 8)); \
+    }
+
+    for (; i >= 32 * CHCNT; i -= 32 * CHCNT) {
+        for (unsigned g = 0; g < CHCNT; g += 4) {
+            __m128 r0, r1, r2, r3;
+
+            CONVERT_CF32_CI16(r0, in[g + 0]);
+            CONVERT_CF32_CI16(r1, in[g + 1]);
+            CONVERT_CF32_CI16(r2, in[g + 2]);
+            CONVERT_CF32_CI16(r3, in[g + 3]);
+
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+            STORE_ROW(0, r0);
+            STORE_ROW(1, r1);
+            STORE_ROW(2, r2);
+            STORE_ROW(3, r3);
+        }
+        outdata += 12 * CHCNT;
+    }
+
+#undef STORE_ROW
+#undef CONVERT_CF32_CI16
+
+    for (; i >= 8 * CHCNT; i -= 8 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            float f0 = *(in[c]++) / CONV_SCALE;
+            float f1 = *(in[c]++) / CONV_SCALE;
+
+            wu_i16u32_t a0 = {{I16RND(f0), I16RND(f1)}};
+            wu_u32b_t  c0 = {(a0.u & 0xfff00000) | ((a0.u << 4) & 0x000fff00)};
+
+            *(outdata++) = c0.b[1];
+            *(outdata++) = c0.b[2];
+            *(outdata++) = c0.b[3];
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
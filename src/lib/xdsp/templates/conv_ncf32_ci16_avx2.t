@@ -0,0 +1,78 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz * 2) < i)
+        i = (outdatabsz * 2);
+
+    const float* in[CHCNT];
+    uint32_t* st = (uint32_t*)outdata_p;
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        in[c] = (const float*)indata[c];
+
+    const __m256 scale = _mm256_set1_ps(1.0f / CONV_SCALE);
+
+    // 8 samples of one channel -> [ticks 0..3 | ticks 4..7] packed ci16 words
+#define CONVERT_CF32_CI16(r, p) \
+    { \
+        __m256i i0 = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_loadu_ps(p + 0), scale)); \
+        __m256i i1 = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_loadu_ps(p + 8), scale)); \
+        __m256i pk = _mm256_packs_epi32(i0, i1); \
+        r = _mm256_castsi256_ps(_mm256_permute4x64_epi64(pk, _MM_SHUFFLE(3, 1, 2, 0))); \
+        p += 16; \
+    }
+
+#define STORE_ROW(t, r) \
+    { \
+        __m256i v = _mm256_castps_si256(r); \
+        _mm_storeu_si128((__m128i*)(st + (t) * CHCNT + g), _mm256_castsi256_si128(v)); \
+        _mm_storeu_si128((__m128i*)(st + ((t) + 4) * CHCNT + g), _mm256_extracti128_si256(v, 1)); \
+    }
+
+    for (; i >= 64 * CHCNT; i -= 64 * CHCNT) {
+        for (unsigned g = 0; g < CHCNT; g += 4) {
+            __m256 r0, r1, r2, r3;
+
+            CONVERT_CF32_CI16(r0, in[g + 0]);
+            CONVERT_CF32_CI16(r1, in[g + 1]);
+            CONVERT_CF32_CI16(r2, in[g + 2]);
+            CONVERT_CF32_CI16(r3, in[g + 3]);
+
+            __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+            __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+            __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+            __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+
+            r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+            STORE_ROW(0, r0);
+            STORE_ROW(1, r1);
+            STORE_ROW(2, r2);
+            STORE_ROW(3, r3);
+        }
+        st += 8 * CHCNT;
+    }
+
+#undef STORE_ROW
+#undef CONVERT_CF32_CI16
+
+    int16_t* outdata = (int16_t*)st;
+
+    for (; i >= 8 * CHCNT; i -= 8 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            *(outdata++) = *(in[c]++) / CONV_SCALE;
+            *(outdata++) = *(in[c]++) / CONV_SCALE;
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,27 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz * 2) < i)
+        i = (outdatabsz * 2);
+
+    const float* in[CHCNT];
+    int16_t* outdata = (int16_t*)outdata_p;
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        in[c] = (const float*)indata[c];
+
+    for (; i >= 8 * CHCNT; i -= 8 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            *(outdata++) = *(in[c]++) / CONV_SCALE;
+            *(outdata++) = *(in[c]++) / CONV_SCALE;
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,63 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz * 2) < i)
+        i = (outdatabsz * 2);
+
+    const float* in[CHCNT];
+    uint32_t* st = (uint32_t*)outdata_p;
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        in[c] = (const float*)indata[c];
+
+    // 4 samples of one channel -> 4 packed ci16 words
+#define CONVERT_CF32_CI16(p) \
+    vreinterpretq_u32_s16(vcombine_s16( \
+        vqmovn_s32(vcvtq_s32_f32(vmulq_n_f32(vld1q_f32(p + 0), 1.0f / CONV_SCALE))), \
+        vqmovn_s32(vcvtq_s32_f32(vmulq_n_f32(vld1q_f32(p + 4), 1.0f / CONV_SCALE)))))
+
+    for (; i >= 32 * CHCNT; i -= 32 * CHCNT) {
+        uint32x4_t r[CHCNT];
+
+        for (unsigned c = 0; c < CHCNT; c++) {
+            r[c] = CONVERT_CF32_CI16(in[c]);
+            in[c] += 8;
+        }
+
+#if CHCNT == 4
+        uint32x4x4_t w = {{ r[0], r[1], r[2], r[3] }};
+        vst4q_u32(st, w);
+#else
+        // z[k].val[n] = [t(2n).ch(k), t(2n).ch(k+4), t(2n+1).ch(k), t(2n+1).ch(k+4)]
+        uint32x4x2_t z0 = vzipq_u32(r[0], r[4]);
+        uint32x4x2_t z1 = vzipq_u32(r[1], r[5]);
+        uint32x4x2_t z2 = vzipq_u32(r[2], r[6]);
+        uint32x4x2_t z3 = vzipq_u32(r[3], r[7]);
+
+        uint32x4x4_t w0 = {{ z0.val[0], z1.val[0], z2.val[0], z3.val[0] }};
+        uint32x4x4_t w1 = {{ z0.val[1], z1.val[1], z2.val[1], z3.val[1] }};
+        vst4q_u32(st, w0);
+        vst4q_u32(st + 16, w1);
+#endif
+        st += 4 * CHCNT;
+    }
+
+#undef CONVERT_CF32_CI16
+
+    int16_t* outdata = (int16_t*)st;
+
+    for (; i >= 8 * CHCNT; i -= 8 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            *(outdata++) = *(in[c]++) / CONV_SCALE;
+            *(outdata++) = *(in[c]++) / CONV_SCALE;
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,61 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz * 2) < i)
+        i = (outdatabsz * 2);
+
+    const float* in[CHCNT];
+    uint32_t* st = (uint32_t*)outdata_p;
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        in[c] = (const float*)indata[c];
+
+    const __m128 scale = _mm_set1_ps(1.0f / CONV_SCALE);
+
+    // 4 samples of one channel -> 4 packed ci16 words
+#define CONVERT_CF32_CI16(r, p) \
+    { \
+        __m128i i0 = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(p + 0), scale)); \
+        __m128i i1 = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(p + 4), scale)); \
+        r = _mm_castsi128_ps(_mm_packs_epi32(i0, i1)); \
+        p += 8; \
+    }
+
+    for (; i >= 32 * CHCNT; i -= 32 * CHCNT) {
+        for (unsigned g = 0; g < CHCNT; g += 4) {
+            __m128 r0, r1, r2, r3;
+
+            CONVERT_CF32_CI16(r0, in[g + 0]);
+            CONVERT_CF32_CI16(r1, in[g + 1]);
+            CONVERT_CF32_CI16(r2, in[g + 2]);
+            CONVERT_CF32_CI16(r3, in[g + 3]);
+
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+            _mm_storeu_si128((__m128i*)(st + 0 * CHCNT + g), _mm_castps_si128(r0));
+            _mm_storeu_si128((__m128i*)(st + 1 * CHCNT + g), _mm_castps_si128(r1));
+            _mm_storeu_si128((__m128i*)(st + 2 * CHCNT + g), _mm_castps_si128(r2));
+            _mm_storeu_si128((__m128i*)(st + 3 * CHCNT + g), _mm_castps_si128(r3));
+        }
+        st += 4 * CHCNT;
+    }
+
+#undef CONVERT_CF32_CI16
+
+    int16_t* outdata = (int16_t*)st;
+
+    for (; i >= 8 * CHCNT; i -= 8 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            *(outdata++) = *(in[c]++) / CONV_SCALE;
+            *(outdata++) = *(in[c]++) / CONV_SCALE;
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,65 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz) < i)
+        i = (outdatabsz);
+
+    const uint32_t* in[CHCNT];
+    uint32_t* st = (uint32_t*)outdata_p;
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        in[c] = (const uint32_t*)indata[c];
+
+#define STORE_ROW(t, r) \
+    { \
+        __m256i v = _mm256_castps_si256(r); \
+        _mm_storeu_si128((__m128i*)(st + (t) * CHCNT + g), _mm256_castsi256_si128(v)); \
+        _mm_storeu_si128((__m128i*)(st + ((t) + 4) * CHCNT + g), _mm256_extracti128_si256(v, 1)); \
+    }
+
+    for (; i >= 32 * CHCNT; i -= 32 * CHCNT) {
+        for (unsigned g = 0; g < CHCNT; g += 4) {
+            __m256 r0 = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*)in[g + 0]));
+            __m256 r1 = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*)in[g + 1]));
+            __m256 r2 = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*)in[g + 2]));
+            __m256 r3 = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*)in[g + 3]));
+
+            in[g + 0] += 8;
+            in[g + 1] += 8;
+            in[g + 2] += 8;
+            in[g + 3] += 8;
+
+            __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+            __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+            __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+            __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+
+            r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+            STORE_ROW(0, r0);
+            STORE_ROW(1, r1);
+            STORE_ROW(2, r2);
+            STORE_ROW(3, r3);
+        }
+        st += 8 * CHCNT;
+    }
+
+#undef STORE_ROW
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            *(st++) = *(in[c]++);
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,51 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz) < i)
+        i = (outdatabsz);
+
+    const uint32_t* in[CHCNT];
+    uint32_t* st = (uint32_t*)outdata_p;
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        in[c] = (const uint32_t*)indata[c];
+
+    for (; i >= 16 * CHCNT; i -= 16 * CHCNT) {
+        uint32x4_t r[CHCNT];
+
+        for (unsigned c = 0; c < CHCNT; c++) {
+            r[c] = vld1q_u32(in[c]);
+            in[c] += 4;
+        }
+
+#if CHCNT == 4
+        uint32x4x4_t w = {{ r[0], r[1], r[2], r[3] }};
+        vst4q_u32(st, w);
+#else
+        uint32x4x2_t z0 = vzipq_u32(r[0], r[4]);
+        uint32x4x2_t z1 = vzipq_u32(r[1], r[5]);
+        uint32x4x2_t z2 = vzipq_u32(r[2], r[6]);
+        uint32x4x2_t z3 = vzipq_u32(r[3], r[7]);
+
+        uint32x4x4_t w0 = {{ z0.val[0], z1.val[0], z2.val[0], z3.val[0] }};
+        uint32x4x4_t w1 = {{ z0.val[1], z1.val[1], z2.val[1], z3.val[1] }};
+        vst4q_u32(st, w0);
+        vst4q_u32(st + 16, w1);
+#endif
+        st += 4 * CHCNT;
+    }
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            *(st++) = *(in[c]++);
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
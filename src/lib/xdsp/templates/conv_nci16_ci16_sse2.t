@@ -0,0 +1,48 @@
+static
+void TEMPLATE_FUNC_NAME(const void *__restrict *__restrict indata,
+                        unsigned indatabsz,
+                        void *__restrict outdata_p,
+                        unsigned outdatabsz)
+{
+    unsigned i = indatabsz;
+    if ((outdatabsz) < i)
+        i = (outdatabsz);
+
+    const uint32_t* in[CHCNT];
+    uint32_t* st = (uint32_t*)outdata_p;
+
+    for (unsigned c = 0; c < CHCNT; c++)
+        in[c] = (const uint32_t*)indata[c];
+
+    for (; i >= 16 * CHCNT; i -= 16 * CHCNT) {
+        for (unsigned g = 0; g < CHCNT; g += 4) {
+            __m128 r0 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)in[g + 0]));
+            __m128 r1 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)in[g + 1]));
+            __m128 r2 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)in[g + 2]));
+            __m128 r3 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)in[g + 3]));
+
+            in[g + 0] += 4;
+            in[g + 1] += 4;
+            in[g + 2] += 4;
+            in[g + 3] += 4;
+
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+            _mm_storeu_si128((__m128i*)(st + 0 * CHCNT + g), _mm_castps_si128(r0));
+            _mm_storeu_si128((__m128i*)(st + 1 * CHCNT + g), _mm_castps_si128(r1));
+            _mm_storeu_si128((__m128i*)(st + 2 * CHCNT + g), _mm_castps_si128(r2));
+            _mm_storeu_si128((__m128i*)(st + 3 * CHCNT + g), _mm_castps_si128(r3));
+        }
+        st += 4 * CHCNT;
+    }
+
+    for (; i >= 4 * CHCNT; i -= 4 * CHCNT) {
+        for (unsigned c = 0; c < CHCNT; c++) {
+            *(st++) = *(in[c]++);
+        }
+    }
+
+    // do nothing with leftover
+}
+
+#undef TEMPLATE_FUNC_NAME
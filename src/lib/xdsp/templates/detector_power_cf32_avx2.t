@@ -0,0 +1,29 @@
+static
+void TEMPLATE_FUNC_NAME(const float* __restrict in, unsigned count, float* __restrict out)
+{
+    unsigned i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        __m256 e0 = _mm256_loadu_ps(in + 2 * i + 0);
+        __m256 e1 = _mm256_loadu_ps(in + 2 * i + 8);
+        __m256 e2 = _mm256_loadu_ps(in + 2 * i + 16);
+        __m256 e3 = _mm256_loadu_ps(in + 2 * i + 24);
+
+        __m256 p0 = _mm256_hadd_ps(_mm256_mul_ps(e0, e0), _mm256_mul_ps(e1, e1)); // pwr{ 0 1 4 5 2 3 6 7 }
+        __m256 p1 = _mm256_hadd_ps(_mm256_mul_ps(e2, e2), _mm256_mul_ps(e3, e3)); // pwr{ 8 9 C D A B E F }
+
+        p0 = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(p0), _MM_SHUFFLE(3, 1, 2, 0)));
+        p1 = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(p1), _MM_SHUFFLE(3, 1, 2, 0)));
+
+        _mm256_storeu_ps(out + i + 0, p0);
+        _mm256_storeu_ps(out + i + 8, p1);
+    }
+
+    for (; i < count; i++) {
+        const float re = in[2 * i + 0];
+        const float im = in[2 * i + 1];
+        out[i] = re * re + im * im;
+    }
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,11 @@
+static
+void TEMPLATE_FUNC_NAME(const float* __restrict in, unsigned count, float* __restrict out)
+{
+    for (unsigned i = 0; i < count; i++) {
+        const float re = in[2 * i + 0];
+        const float im = in[2 * i + 1];
+        out[i] = re * re + im * im;
+    }
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,24 @@
+static
+void TEMPLATE_FUNC_NAME(const float* __restrict in, unsigned count, float* __restrict out)
+{
+    unsigned i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        float32x4x2_t e0 = vld2q_f32(in + 2 * i + 0);
+        float32x4x2_t e1 = vld2q_f32(in + 2 * i + 8);
+
+        float32x4_t p0 = vaddq_f32(vmulq_f32(e0.val[0], e0.val[0]), vmulq_f32(e0.val[1], e0.val[1]));
+        float32x4_t p1 = vaddq_f32(vmulq_f32(e1.val[0], e1.val[0]), vmulq_f32(e1.val[1], e1.val[1]));
+
+        vst1q_f32(out + i + 0, p0);
+        vst1q_f32(out + i + 4, p1);
+    }
+
+    for (; i < count; i++) {
+        const float re = in[2 * i + 0];
+        const float im = in[2 * i + 1];
+        out[i] = re * re + im * im;
+    }
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,44 @@
+static
+unsigned TEMPLATE_FUNC_NAME(const float* __restrict m, unsigned count, float thr_on, float thr_off,
+                            unsigned* __restrict armed)
+{
+    const __m256 von = _mm256_set1_ps(thr_on);
+    const __m256 voff = _mm256_set1_ps(thr_off);
+    unsigned i = 0;
+
+    while (i < count) {
+        if (*armed) {
+            for (; i + 8 <= count; i += 8) {
+                int msk = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(m + i), von, _CMP_GE_OQ));
+                if (msk) {
+                    *armed = 0;
+                    return i + __builtin_ctz(msk);
+                }
+            }
+            for (; i < count; i++) {
+                if (m[i] >= thr_on) {
+                    *armed = 0;
+                    return i;
+                }
+            }
+        } else {
+            // Looking for the rearm point, the sample itself can't trigger
+            for (; i + 8 <= count; i += 8) {
+                int msk = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(m + i), voff, _CMP_LT_OQ));
+                if (msk) {
+                    i += __builtin_ctz(msk);
+                    break;
+                }
+            }
+            for (; i < count && !(m[i] < thr_off); i++);
+            if (i < count) {
+                *armed = 1;
+                i++;
+            }
+        }
+    }
+
+    return count;
+}
+
+#undef TEMPLATE_FUNC_NAME
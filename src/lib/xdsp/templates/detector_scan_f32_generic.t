@@ -0,0 +1,22 @@
+static
+unsigned TEMPLATE_FUNC_NAME(const float* __restrict m, unsigned count, float thr_on, float thr_off,
+                            unsigned* __restrict armed)
+{
+    unsigned st = *armed;
+
+    for (unsigned i = 0; i < count; i++) {
+        if (st) {
+            if (m[i] >= thr_on) {
+                *armed = 0;
+                return i;
+            }
+        } else if (m[i] < thr_off) {
+            st = 1;
+        }
+    }
+
+    *armed = st;
+    return count;
+}
+
+#undef TEMPLATE_FUNC_NAME
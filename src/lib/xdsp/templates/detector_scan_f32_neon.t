@@ -0,0 +1,32 @@
+static
+unsigned TEMPLATE_FUNC_NAME(const float* __restrict m, unsigned count, float thr_on, float thr_off,
+                            unsigned* __restrict armed)
+{
+    const float32x4_t von = vdupq_n_f32(thr_on);
+    const float32x4_t voff = vdupq_n_f32(thr_off);
+    unsigned i = 0;
+
+    while (i < count) {
+        if (*armed) {
+            for (; i + 4 <= count && vmaxvq_u32(vcgeq_f32(vld1q_f32(m + i), von)) == 0; i += 4);
+            for (; i < count; i++) {
+                if (m[i] >= thr_on) {
+                    *armed = 0;
+                    return i;
+                }
+            }
+        } else {
+            // Looking for the rearm point, the sample itself can't trigger
+            for (; i + 4 <= count && vmaxvq_u32(vcltq_f32(vld1q_f32(m + i), voff)) == 0; i += 4);
+            for (; i < count && !(m[i] < thr_off); i++);
+            if (i < count) {
+                *armed = 1;
+                i++;
+            }
+        }
+    }
+
+    return count;
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,67 @@
+static
+void TEMPLATE_FUNC_NAME(const float* __restrict in, unsigned count, const float* __restrict pre, unsigned plen,
+                        float* __restrict out)
+{
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+
+    for (unsigned n = 0; n < count; n++) {
+        const float* x = in + 2 * n;
+        __m256 a = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+        __m256 b = _mm256_setzero_ps(), b1 = _mm256_setzero_ps();
+        __m256 e = _mm256_setzero_ps(), e1 = _mm256_setzero_ps();
+        unsigned k = 0;
+
+        // Two accumulator sets to hide FMA latency
+        for (; k + 8 <= plen; k += 8) {
+            __m256 xv0 = _mm256_loadu_ps(x + 2 * k + 0);
+            __m256 xv1 = _mm256_loadu_ps(x + 2 * k + 8);
+            __m256 pv0 = _mm256_loadu_ps(pre + 2 * k + 0);
+            __m256 pv1 = _mm256_loadu_ps(pre + 2 * k + 8);
+
+            a  = _mm256_fmadd_ps(xv0, _mm256_moveldup_ps(pv0), a);  // xr*pr xi*pr
+            a1 = _mm256_fmadd_ps(xv1, _mm256_moveldup_ps(pv1), a1);
+            b  = _mm256_fmadd_ps(xv0, _mm256_movehdup_ps(pv0), b);  // xr*pi xi*pi
+            b1 = _mm256_fmadd_ps(xv1, _mm256_movehdup_ps(pv1), b1);
+            e  = _mm256_fmadd_ps(xv0, xv0, e);
+            e1 = _mm256_fmadd_ps(xv1, xv1, e1);
+        }
+        for (; k + 4 <= plen; k += 4) {
+            __m256 xv = _mm256_loadu_ps(x + 2 * k);
+            __m256 pv = _mm256_loadu_ps(pre + 2 * k);
+
+            a = _mm256_fmadd_ps(xv, _mm256_moveldup_ps(pv), a);
+            b = _mm256_fmadd_ps(xv, _mm256_movehdup_ps(pv), b);
+            e = _mm256_fmadd_ps(xv, xv, e);
+        }
+        a = _mm256_add_ps(a, a1);
+        b = _mm256_add_ps(b, b1);
+        e = _mm256_add_ps(e, e1);
+
+        // re = xr*pr + xi*pi in even lanes, im = xi*pr - xr*pi in odd lanes
+        __m256 bs = _mm256_xor_ps(_mm256_permute_ps(b, _MM_SHUFFLE(2, 3, 0, 1)), sign);
+        __m256 c = _mm256_addsub_ps(a, bs);
+
+        __m128 c4 = _mm_add_ps(_mm256_castps256_ps128(c), _mm256_extractf128_ps(c, 1));
+        __m128 e4 = _mm_add_ps(_mm256_castps256_ps128(e), _mm256_extractf128_ps(e, 1));
+        c4 = _mm_add_ps(c4, _mm_movehl_ps(c4, c4));
+        e4 = _mm_hadd_ps(e4, e4);
+        e4 = _mm_hadd_ps(e4, e4);
+
+        float cr = _mm_cvtss_f32(c4);
+        float ci = _mm_cvtss_f32(_mm_shuffle_ps(c4, c4, _MM_SHUFFLE(1, 1, 1, 1)));
+        float en = _mm_cvtss_f32(e4);
+
+        for (; k < plen; k++) {
+            const float xr = x[2 * k + 0], xi = x[2 * k + 1];
+            const float pr = pre[2 * k + 0], pi = pre[2 * k + 1];
+
+            cr += xr * pr + xi * pi;
+            ci += xi * pr - xr * pi;
+            en += xr * xr + xi * xi;
+        }
+
+        out[n] = (en > 0) ? (cr * cr + ci * ci) / en : 0;
+    }
+}
+
+#undef TEMPLATE_FUNC_NAME
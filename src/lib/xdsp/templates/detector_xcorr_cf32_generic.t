@@ -0,0 +1,22 @@
+static
+void TEMPLATE_FUNC_NAME(const float* __restrict in, unsigned count, const float* __restrict pre, unsigned plen,
+                        float* __restrict out)
+{
+    for (unsigned n = 0; n < count; n++) {
+        const float* x = in + 2 * n;
+        float cr = 0, ci = 0, e = 0;
+
+        for (unsigned k = 0; k < plen; k++) {
+            const float xr = x[2 * k + 0], xi = x[2 * k + 1];
+            const float pr = pre[2 * k + 0], pi = pre[2 * k + 1];
+
+            cr += xr * pr + xi * pi;
+            ci += xi * pr - xr * pi;
+            e += xr * xr + xi * xi;
+        }
+
+        out[n] = (e > 0) ? (cr * cr + ci * ci) / e : 0;
+    }
+}
+
+#undef TEMPLATE_FUNC_NAME
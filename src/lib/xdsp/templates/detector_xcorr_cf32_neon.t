@@ -0,0 +1,41 @@
+static
+void TEMPLATE_FUNC_NAME(const float* __restrict in, unsigned count, const float* __restrict pre, unsigned plen,
+                        float* __restrict out)
+{
+    for (unsigned n = 0; n < count; n++) {
+        const float* x = in + 2 * n;
+        float32x4_t vr = vdupq_n_f32(0);
+        float32x4_t vi = vdupq_n_f32(0);
+        float32x4_t ve = vdupq_n_f32(0);
+        unsigned k = 0;
+
+        for (; k + 4 <= plen; k += 4) {
+            float32x4x2_t xv = vld2q_f32(x + 2 * k);
+            float32x4x2_t pv = vld2q_f32(pre + 2 * k);
+
+            vr = vfmaq_f32(vr, xv.val[0], pv.val[0]);
+            vr = vfmaq_f32(vr, xv.val[1], pv.val[1]);
+            vi = vfmaq_f32(vi, xv.val[1], pv.val[0]);
+            vi = vfmsq_f32(vi, xv.val[0], pv.val[1]);
+            ve = vfmaq_f32(ve, xv.val[0], xv.val[0]);
+            ve = vfmaq_f32(ve, xv.val[1], xv.val[1]);
+        }
+
+        float cr = vaddvq_f32(vr);
+        float ci = vaddvq_f32(vi);
+        float en = vaddvq_f32(ve);
+
+        for (; k < plen; k++) {
+            const float xr = x[2 * k + 0], xi = x[2 * k + 1];
+            const float pr = pre[2 * k + 0], pi = pre[2 * k + 1];
+
+            cr += xr * pr + xi * pi;
+            ci += xi * pr - xr * pi;
+            en += xr * xr + xi * xi;
+        }
+
+        out[n] = (en > 0) ? (cr * cr + ci * ci) / en : 0;
+    }
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -0,0 +1,48 @@
+static
+void TEMPLATE_FUNC_NAME(fft_acc_t* __restrict p, unsigned fftsz, float scale, float corr, float* __restrict outa, unsigned log2_degree)
+{
+    WVLT_POLYLOG2F4_DECL_CONSTS(log2_degree);
+    const __m128 vcorr         = _mm_set1_ps(corr);
+    const __m128 vscale        = _mm_set1_ps(scale);
+
+    const unsigned half = fftsz >> 1;
+
+    // accumulated data is in natural order here, i.e. it's produced by generic fftad_add
+    for(unsigned i = 0; i < fftsz; i += 8)
+    {
+        __m128  m0 = _mm_load_ps(p->f_mant + i + 0);
+        __m128  m1 = _mm_load_ps(p->f_mant + i + 4);
+        __m128i p0 = _mm_load_si128((__m128i*)(p->f_pwr + i + 0));
+        __m128i p1 = _mm_load_si128((__m128i*)(p->f_pwr + i + 4));
+
+        __m128 apwr0, apwr1;
+        WVLT_POLYLOG2F4(m0, apwr0);
+        WVLT_POLYLOG2F4(m1, apwr1);
+
+        __m128 s0 = _mm_add_ps(apwr0, _mm_cvtepi32_ps(p0));
+        __m128 s1 = _mm_add_ps(apwr1, _mm_cvtepi32_ps(p1));
+
+        __m128 f0 = _mm_add_ps(_mm_mul_ps(vscale, s0), vcorr);
+        __m128 f1 = _mm_add_ps(_mm_mul_ps(vscale, s1), vcorr);
+
+        int32_t offset;
+
+        if(i + 8 <= half)
+        {
+            offset = half;
+        }
+        else if(i >= half)
+        {
+            offset = - half;
+        }
+        else
+        {
+            offset = 0;
+        }
+
+        _mm_store_ps(outa + i + offset + 0, f0);
+        _mm_store_ps(outa + i + offset + 4, f1);
+    }
+}
+
+#undef TEMPLATE_FUNC_NAME
@@ -18,7 +18,7 @@ VWLT_ATTRIBUTE(optimize("-O3"))
 static
 void TEMPLATE_FUNC_NAME(wvlt_fftwf_complex* __restrict in, unsigned fft_size,
                         fft_rtsa_data_t* __restrict rtsa_data,
-                        float fcale_mpy, float mine, float corr, fft_diap_t diap)
+                        float fcale_mpy, float mine, float corr, fft_diap_t diap, unsigned log2_degree)
 {
     const fft_rtsa_settings_t * st = &rtsa_data->settings;
     const unsigned rtsa_depth = st->rtsa_depth;
@@ -27,11 +27,7 @@ void TEMPLATE_FUNC_NAME(wvlt_fftwf_complex* __restrict in, unsigned fft_size,
 
     for(unsigned i = diap.from; i < diap.to; ++i)
     {
-#ifdef USE_POLYLOG2
-        float p = fcale_mpy * wvlt_polylog2f(in[i][0]*in[i][0] + in[i][1]*in[i][1] + mine) + corr;
-#else
-        float p = fcale_mpy * wvlt_fastlog2(in[i][0]*in[i][0] + in[i][1]*in[i][1] + mine) + corr;
-#endif
+        float p = fcale_mpy * wvlt_log2f_deg(in[i][0]*in[i][0] + in[i][1]*in[i][1] + mine, log2_degree) + corr;
         p -= st->upper_pwr_bound;
         p = fabs(p);
         p *= st->divs_for_dB;
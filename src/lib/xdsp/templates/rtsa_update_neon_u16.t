@@ -1,16 +1,15 @@
 static
 void TEMPLATE_FUNC_NAME(wvlt_fftwf_complex* __restrict in, unsigned fft_size,
                         fft_rtsa_data_t* __restrict rtsa_data,
-                        float fcale_mpy, float mine, float corr, fft_diap_t diap)
+                        float fcale_mpy, float mine, float corr, fft_diap_t diap, unsigned log2_degree)
 {
 
 #include "rtsa_update_u16_neon.inc"
 
+    WVLT_POLYLOG2_DECL_CONSTS(log2_degree);
 #ifdef USE_POLYLOG2
-    WVLT_POLYLOG2_DECL_CONSTS;
     wvlt_log2f_fn_t wvlt_log2f_fn = wvlt_polylog2f;
 #else
-    const float32x4_t log2_sub    = vdupq_n_f32(-WVLT_FASTLOG2_SUB);
     wvlt_log2f_fn_t wvlt_log2f_fn = wvlt_fastlog2;
 #endif
 
@@ -49,18 +48,9 @@ void TEMPLATE_FUNC_NAME(wvlt_fftwf_complex* __restrict in, unsigned fft_size,
         float32x4_t summ0 = vmlaq_f32(vmlaq_f32(v_mine, e0.val[0], e0.val[0]), e0.val[1], e0.val[1]);
         float32x4_t summ1 = vmlaq_f32(vmlaq_f32(v_mine, e1.val[0], e1.val[0]), e1.val[1], e1.val[1]);
 
-#ifdef USE_POLYLOG2
         float32x4_t l2_res0, l2_res1;
         WVLT_POLYLOG2F8(summ0, l2_res0);
         WVLT_POLYLOG2F8(summ1, l2_res1);
-#else
-        // fasterlog2
-        //
-        float32x4_t summ0_ = vcvtq_f32_u32(vreinterpretq_u32_f32(summ0));
-        float32x4_t summ1_ = vcvtq_f32_u32(vreinterpretq_u32_f32(summ1));
-        float32x4_t l2_res0 = vmlaq_n_f32(log2_sub, summ0_, WVLT_FASTLOG2_MUL);
-        float32x4_t l2_res1 = vmlaq_n_f32(log2_sub, summ1_, WVLT_FASTLOG2_MUL);
-#endif
         // add scale & corr
         float32x4_t pw0 = vmlaq_n_f32(v_corr, l2_res0, scale);
         float32x4_t pw1 = vmlaq_n_f32(v_corr, l2_res1, scale);
@@ -1,7 +1,7 @@
 static
 void TEMPLATE_FUNC_NAME(wvlt_fftwf_complex* __restrict in, unsigned fft_size,
                         fft_rtsa_data_t* __restrict rtsa_data,
-                        float fcale_mpy, float mine, float corr, fft_diap_t diap)
+                        float fcale_mpy, float mine, float corr, fft_diap_t diap, unsigned log2_degree)
 {
     // Attention please!
     // rtsa_depth should be multiple to 32/sizeof(rtsa_pwr_t) here!
@@ -10,12 +10,10 @@ void TEMPLATE_FUNC_NAME(wvlt_fftwf_complex* __restrict in, unsigned fft_size,
 
 #include "rtsa_update_u16_avx2.inc"
 
+    WVLT_POLYLOG2_DECL_CONSTS(log2_degree);
 #ifdef USE_POLYLOG2
-    WVLT_POLYLOG2_DECL_CONSTS;
     wvlt_log2f_fn_t wvlt_log2f_fn = wvlt_polylog2f;
 #else
-    const __m256 log2_mul      = _mm256_set1_ps(WVLT_FASTLOG2_MUL);
-    const __m256 log2_sub      = _mm256_set1_ps(WVLT_FASTLOG2_SUB);
     wvlt_log2f_fn_t wvlt_log2f_fn = wvlt_fastlog2;
 #endif
 
@@ -84,18 +82,9 @@ void TEMPLATE_FUNC_NAME(wvlt_fftwf_complex* __restrict in, unsigned fft_size,
         __m256 summ0 = _mm256_add_ps(sum0s, v_mine);
         __m256 summ1 = _mm256_add_ps(sum1s, v_mine);
 
-#ifdef USE_POLYLOG2
         __m256 l2_res0, l2_res1;
         WVLT_POLYLOG2F8(summ0, l2_res0);
         WVLT_POLYLOG2F8(summ1, l2_res1);
-#else
-        // fasterlog2
-        //
-        __m256 summ0_ = _mm256_cvtepi32_ps(_mm256_castps_si256(summ0));
-        __m256 summ1_ = _mm256_cvtepi32_ps(_mm256_castps_si256(summ1));
-        __m256 l2_res0 = _mm256_fmsub_ps(summ0_, log2_mul, log2_sub);
-        __m256 l2_res1 = _mm256_fmsub_ps(summ1_, log2_mul, log2_sub);
-#endif
         // add scale & corr
         __m256 pwr0 = _mm256_fmadd_ps(l2_res0, v_scale_mpy, v_corr);
         __m256 pwr1 = _mm256_fmadd_ps(l2_res1, v_scale_mpy, v_corr);
@@ -4,7 +4,7 @@ VWLT_ATTRIBUTE(optimize("-O3"))
 static
 void TEMPLATE_FUNC_NAME(wvlt_fftwf_complex* __restrict in, unsigned fft_size,
                         fft_rtsa_data_t* __restrict rtsa_data,
-                        float fcale_mpy, float mine, float corr, fft_diap_t diap)
+                        float fcale_mpy, float mine, float corr, fft_diap_t diap, unsigned log2_degree)
 {
 #ifdef USE_POLYLOG2
     wvlt_log2f_fn_t wvlt_log2f_fn = wvlt_polylog2f;
@@ -26,7 +26,7 @@ void TEMPLATE_FUNC_NAME(wvlt_fftwf_complex* __restrict in, unsigned fft_size,
             rtsa_discharge_u16(&pwr[j], decay_rate_pw2);
         }
 
-        float p = fcale_mpy * wvlt_log2f_fn(in[i][0]*in[i][0] + in[i][1]*in[i][1] + mine) + corr;
+        float p = fcale_mpy * wvlt_log2f_deg(in[i][0]*in[i][0] + in[i][1]*in[i][1] + mine, log2_degree) + corr;
 
         p -= st->upper_pwr_bound;
         p = fabs(p);
@@ -0,0 +1,192 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <check.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <assert.h>
+#include <stdlib.h>
+#include "xdsp_utest_common.h"
+#include "../conv_cf16_ci12_2.h"
+#include "../fp16_inline.h"
+
+#undef DEBUG_PRINT
+
+#define SPEED_WORD_COUNT (8192u)
+#define SPEED_SIZE_BZ (SPEED_WORD_COUNT * 2u)
+#define OUT_SIZE_BZ (SPEED_WORD_COUNT * 12u / 8u)
+
+static const unsigned packet_lens[3] = { 1236, 7780, SPEED_SIZE_BZ };
+
+#define SPEED_MEASURE_ITERS 1000000
+
+static uint16_t* in = NULL;
+static uint8_t* out = NULL;
+static uint8_t* out_etalon = NULL;
+
+static const char* last_fn_name = NULL;
+static generic_opts_t max_opt = OPT_GENERIC;
+
+static void setup()
+{
+    posix_memalign((void**)&in,         ALIGN_BYTES, SPEED_SIZE_BZ);
+    posix_memalign((void**)&out,        ALIGN_BYTES, OUT_SIZE_BZ);
+    posix_memalign((void**)&out_etalon, ALIGN_BYTES, OUT_SIZE_BZ);
+
+    //fill
+    for(unsigned i = 0; i < SPEED_WORD_COUNT; ++i)
+    {
+        in[i] = wvlt_f32_to_f16((float)rand() / RAND_MAX - 0.5f);
+    }
+}
+
+static void teardown()
+{
+    free(in);
+    free(out);
+    free(out_etalon);
+}
+
+static conv_function_t get_fn(generic_opts_t o, int log)
+{
+    const char* fn_name = NULL;
+    conv_function_t fn = conv_get_cf16_ci12_c(o, &fn_name);
+
+    //ignore dups
+    if(last_fn_name && !strcmp(last_fn_name, fn_name))
+        return NULL;
+
+    if(log)
+        fprintf(stderr, "%-20s\t", fn_name);
+
+    last_fn_name = fn_name;
+    return fn;
+}
+
+START_TEST(conv_cf16_ci12_check_value)
+{
+    const uint16_t pin[2] = { 0x3800, 0xbc00 }; // 0.5, -1.0
+    uint8_t pout[3] = { 0 };
+    const void* pi = pin;
+    void* po = pout;
+
+    (*conv_get_cf16_ci12_c(OPT_GENERIC, NULL))(&pi, sizeof(pin), &po, sizeof(pout));
+    ck_assert_int_eq(pout[0], 0x00); // 0x400
+    ck_assert_int_eq(pout[1], 0x04);
+    ck_assert_int_eq(pout[2], 0x80); // -0x800
+}
+END_TEST
+
+// Same as the single channel conversion of samples interleaved by channel
+START_TEST(conv_ncf16_ci12_check_value)
+{
+    const unsigned chans = 2u << _i;
+    const unsigned ch_words = SPEED_WORD_COUNT / chans;
+    conv_function_t fn = (chans == 2) ? conv_get_2cf16_ci12_c(OPT_GENERIC, NULL) :
+                         (chans == 4) ? conv_get_4cf16_ci12_c(OPT_GENERIC, NULL) :
+                                        conv_get_8cf16_ci12_c(OPT_GENERIC, NULL);
+    uint16_t* mixed = (uint16_t*)malloc(SPEED_SIZE_BZ);
+    const void* pin = (const void*)mixed;
+    const void* pins[8];
+    void* pout = (void*)out_etalon;
+
+    for (unsigned j = 0; j < SPEED_WORD_COUNT / 2; j++) {
+        const uint16_t* ch = in + (j % chans) * ch_words;
+        mixed[2 * j + 0] = ch[2 * (j / chans) + 0];
+        mixed[2 * j + 1] = ch[2 * (j / chans) + 1];
+    }
+    for (unsigned c = 0; c < chans; c++)
+        pins[c] = in + c * ch_words;
+
+    memset(out, 0, OUT_SIZE_BZ);
+    memset(out_etalon, 0xff, OUT_SIZE_BZ);
+    (*conv_get_cf16_ci12_c(OPT_GENERIC, NULL))(&pin, SPEED_SIZE_BZ, &pout, OUT_SIZE_BZ);
+    pout = (void*)out;
+    (*fn)(pins, SPEED_SIZE_BZ, &pout, OUT_SIZE_BZ);
+
+    ck_assert_int_eq(memcmp(out, out_etalon, OUT_SIZE_BZ), 0);
+    free(mixed);
+}
+END_TEST
+
+START_TEST(conv_cf16_ci12_check_simd)
+{
+    generic_opts_t opt = max_opt;
+    const unsigned bzin = packet_lens[_i];
+    const unsigned bzout = bzin * 3 / 4;
+    const void* pin = (const void*)in;
+    void* pout = (void*)out;
+    last_fn_name = NULL;
+
+    fprintf(stderr, "\n**** Check SIMD implementations, packet: %u bytes ***\n", bzin);
+
+    //get etalon output data (generic foo)
+    memset(out, 0, OUT_SIZE_BZ);
+    (*get_fn(OPT_GENERIC, 0))(&pin, bzin, &pout, bzout);
+    memcpy(out_etalon, out, OUT_SIZE_BZ);
+
+    while(opt != OPT_GENERIC)
+    {
+        conv_function_t fn = get_fn(opt--, 1);
+        if(fn)
+        {
+            memset(out, 0, OUT_SIZE_BZ);
+            (*fn)(&pin, bzin, &pout, bzout);
+
+            int res = memcmp(out, out_etalon, OUT_SIZE_BZ);
+            res ? fprintf(stderr,"\tFAILED!\n") : fprintf(stderr,"\tOK!\n");
+            ck_assert_int_eq( res, 0 );
+        }
+    }
+}
+END_TEST
+
+START_TEST(conv_cf16_ci12_speed)
+{
+    generic_opts_t opt = max_opt;
+    const void* pin = (const void*)in;
+    void* pout = (void*)out;
+    last_fn_name = NULL;
+
+    fprintf(stderr, "\n**** Compare SIMD implementations speed ***\n");
+    fprintf(stderr,   "**** packet: %u bytes, iters: %u ***\n", SPEED_SIZE_BZ, SPEED_MEASURE_ITERS);
+
+    while(opt != OPT_GENERIC)
+    {
+        conv_function_t fn = get_fn(opt--, 1);
+        if(fn)
+        {
+            //warming
+            for(int i = 0; i < 100; ++i) (*fn)(&pin, SPEED_SIZE_BZ, &pout, OUT_SIZE_BZ);
+
+            //measuring
+            uint64_t tk = clock_get_time();
+            for(int i = 0; i < SPEED_MEASURE_ITERS; ++i) (*fn)(&pin, SPEED_SIZE_BZ, &pout, OUT_SIZE_BZ);
+            uint64_t tk1 = clock_get_time() - tk;
+            fprintf(stderr, "\t%" PRIu64 " us elapsed, %" PRIu64 " ns per 1 call, ave speed = %" PRIu64 " calls/s \n",
+                    tk1, (uint64_t)(tk1*1000LL/SPEED_MEASURE_ITERS), (uint64_t)(1000000LL*SPEED_MEASURE_ITERS/tk1));
+        }
+    }
+}
+END_TEST
+
+Suite * conv_cf16_ci12_suite(void)
+{
+    Suite *s;
+    TCase *tc_core;
+
+    max_opt = cpu_vcap_get();
+
+    s = suite_create("conv_cf16_ci12");
+    tc_core = tcase_create("XDSP");
+    tcase_set_timeout(tc_core, 60);
+    tcase_add_unchecked_fixture(tc_core, setup, teardown);
+    tcase_add_test(tc_core, conv_cf16_ci12_check_value);
+    tcase_add_loop_test(tc_core, conv_ncf16_ci12_check_value, 0, 3);
+    tcase_add_loop_test(tc_core, conv_cf16_ci12_check_simd, 0, 3);
+    tcase_add_test(tc_core, conv_cf16_ci12_speed);
+
+    suite_add_tcase(s, tc_core);
+    return s;
+}
@@ -0,0 +1,177 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <check.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <assert.h>
+#include <stdlib.h>
+#include "xdsp_utest_common.h"
+#include "../conv_ci16_ncf32_2.h"
+
+#undef DEBUG_PRINT
+
+#define MAX_CHANNELS 8
+#define TICKS (4096u + 13u)
+
+#define WIRE_TICK_BZ(n) ((n) * 4u)
+#define HOST_TICK_BZ(n) ((n) * 8u)
+
+static const unsigned chans[2] = { 4, 8 };
+
+#define SPEED_MEASURE_ITERS 100000
+
+static uint8_t* wire = NULL;
+static uint8_t* wire_etalon = NULL;
+static float* host[MAX_CHANNELS];
+static float* host_etalon[MAX_CHANNELS];
+
+static const char* last_fn_name = NULL;
+static generic_opts_t max_opt = OPT_GENERIC;
+static void setup()
+{
+    posix_memalign((void**)&wire,        ALIGN_BYTES, TICKS * WIRE_TICK_BZ(MAX_CHANNELS));
+    posix_memalign((void**)&wire_etalon, ALIGN_BYTES, TICKS * WIRE_TICK_BZ(MAX_CHANNELS));
+
+    for(unsigned c = 0; c < MAX_CHANNELS; ++c)
+    {
+        posix_memalign((void**)&host[c],        ALIGN_BYTES, TICKS * HOST_TICK_BZ(1));
+        posix_memalign((void**)&host_etalon[c], ALIGN_BYTES, TICKS * HOST_TICK_BZ(1));
+    }
+
+    //fill
+    int16_t* pin = (int16_t*)wire;
+    for(unsigned i = 0; i < TICKS * WIRE_TICK_BZ(MAX_CHANNELS) / sizeof(int16_t); ++i)
+    {
+        pin[i] = (int16_t)(rand() & 0xffff);
+    }
+}
+
+static void teardown()
+{
+    free(wire);
+    free(wire_etalon);
+
+    for(unsigned c = 0; c < MAX_CHANNELS; ++c)
+    {
+        free(host[c]);
+        free(host_etalon[c]);
+    }
+}
+
+static conv_function_t get_fn(unsigned chcnt, generic_opts_t o, int log)
+{
+    const char* fn_name = NULL;
+    conv_function_t fn = (chcnt == 8) ? conv_get_ci16_8cf32_c(o, &fn_name) : conv_get_ci16_4cf32_c(o, &fn_name);
+
+    //ignore dups
+    if(last_fn_name && !strcmp(last_fn_name, fn_name))
+        return NULL;
+
+    if(log)
+        fprintf(stderr, "%-20s\t", fn_name);
+
+    last_fn_name = fn_name;
+    return fn;
+}
+
+static int is_equal(unsigned chcnt)
+{
+    for(unsigned c = 0; c < chcnt; ++c)
+    {
+        if(memcmp(host[c], host_etalon[c], TICKS * HOST_TICK_BZ(1)))
+        {
+            fprintf(stderr, "channel %u mismatch\n", c);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+START_TEST(conv_ci16_ncf32_check_simd)
+{
+    const unsigned chcnt = chans[_i];
+    generic_opts_t opt = max_opt;
+    const void* pin = (const void*)wire;
+    void** pout = (void**)host;
+    last_fn_name = NULL;
+
+    const size_t bzin  = TICKS * WIRE_TICK_BZ(chcnt);
+    const size_t bzout = TICKS * HOST_TICK_BZ(chcnt);
+
+    fprintf(stderr,"\n**** Check SIMD implementations, %u channels ***\n", chcnt);
+
+    //get etalon output data (generic foo)
+    (*get_fn(chcnt, OPT_GENERIC, 0))(&pin, bzin, pout, bzout);
+    for(unsigned c = 0; c < chcnt; ++c)
+        memcpy(host_etalon[c], host[c], TICKS * HOST_TICK_BZ(1));
+
+    while(opt != OPT_GENERIC)
+    {
+        conv_function_t fn = get_fn(chcnt, opt--, 1);
+        if(fn)
+        {
+            for(unsigned c = 0; c < chcnt; ++c)
+                memset(host[c], 0, TICKS * HOST_TICK_BZ(1));
+            (*fn)(&pin, bzin, pout, bzout);
+
+            int res = is_equal(chcnt);
+            res ? fprintf(stderr,"\tFAILED!\n") : fprintf(stderr,"\tOK!\n");
+            ck_assert_int_eq( res, 0 );
+        }
+    }
+}
+END_TEST
+
+
+START_TEST(conv_ci16_ncf32_speed)
+{
+    const unsigned chcnt = chans[_i];
+    generic_opts_t opt = max_opt;
+    const void* pin = (const void*)wire;
+    void** pout = (void**)host;
+    last_fn_name = NULL;
+
+    const size_t bzin  = TICKS * WIRE_TICK_BZ(chcnt);
+    const size_t bzout = TICKS * HOST_TICK_BZ(chcnt);
+
+    fprintf(stderr, "\n**** Compare SIMD implementations speed ***\n");
+    fprintf(stderr,   "**** channels: %u, packet: %lu bytes, iters: %u ***\n", chcnt, bzin, SPEED_MEASURE_ITERS);
+
+    while(opt != OPT_GENERIC)
+    {
+        conv_function_t fn = get_fn(chcnt, opt--, 1);
+        if(fn)
+        {
+            //warming
+            for(int i = 0; i < 100; ++i) (*fn)(&pin, bzin, pout, bzout);
+
+            //measuring
+            uint64_t tk = clock_get_time();
+            for(int i = 0; i < SPEED_MEASURE_ITERS; ++i) (*fn)(&pin, bzin, pout, bzout);
+            uint64_t tk1 = clock_get_time() - tk;
+            fprintf(stderr, "\t%" PRIu64 " us elapsed, %" PRIu64 " ns per 1 call, ave speed = %" PRIu64 " calls/s \n",
+                    tk1, (uint64_t)(tk1*1000LL/SPEED_MEASURE_ITERS), (uint64_t)(1000000LL*SPEED_MEASURE_ITERS/tk1));
+        }
+    }
+}
+END_TEST
+
+Suite * conv_ci16_ncf32_suite(void)
+{
+    Suite *s;
+    TCase *tc_core;
+
+    max_opt = cpu_vcap_get();
+
+    s = suite_create("conv_ci16_ncf32");
+    tc_core = tcase_create("XDSP");
+    tcase_set_timeout(tc_core, 60);
+    tcase_add_unchecked_fixture(tc_core, setup, teardown);
+    tcase_add_loop_test(tc_core, conv_ci16_ncf32_check_simd, 0, 2);
+    tcase_add_loop_test(tc_core, conv_ci16_ncf32_speed, 0, 2);
+
+    suite_add_tcase(s, tc_core);
+    return s;
+}
@@ -0,0 +1,194 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <check.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <assert.h>
+#include <stdlib.h>
+#include "xdsp_utest_common.h"
+#include "../conv_ncf16_ci16_2.h"
+#include "../fp16_inline.h"
+
+#undef DEBUG_PRINT
+
+#define MAX_CHANNELS 2
+#define TICKS (4096u + 13u)
+
+#define WIRE_TICK_BZ(n) ((n) * 4u)
+#define HOST_TICK_BZ(n) ((n) * 4u)
+
+static const unsigned chans[2] = { 1, 2 };
+
+#define SPEED_MEASURE_ITERS 100000
+
+static uint8_t* wire = NULL;
+static uint8_t* wire_etalon = NULL;
+static uint16_t* host[MAX_CHANNELS];
+
+static const char* last_fn_name = NULL;
+static generic_opts_t max_opt = OPT_GENERIC;
+static void setup()
+{
+    posix_memalign((void**)&wire,        ALIGN_BYTES, TICKS * WIRE_TICK_BZ(MAX_CHANNELS));
+    posix_memalign((void**)&wire_etalon, ALIGN_BYTES, TICKS * WIRE_TICK_BZ(MAX_CHANNELS));
+
+    for(unsigned c = 0; c < MAX_CHANNELS; ++c)
+    {
+        posix_memalign((void**)&host[c], ALIGN_BYTES, TICKS * HOST_TICK_BZ(1));
+    }
+
+    //fill, including values out of range to check saturation
+    for(unsigned c = 0; c < MAX_CHANNELS; ++c)
+    {
+        for(unsigned i = 0; i < TICKS * 2; ++i)
+        {
+            host[c][i] = wvlt_f32_to_f16(2.2f * rand() / RAND_MAX - 1.1f);
+        }
+    }
+}
+
+static void teardown()
+{
+    free(wire);
+    free(wire_etalon);
+
+    for(unsigned c = 0; c < MAX_CHANNELS; ++c)
+    {
+        free(host[c]);
+    }
+}
+
+static conv_function_t get_fn(unsigned chcnt, generic_opts_t o, int log)
+{
+    const char* fn_name = NULL;
+    conv_function_t fn = (chcnt == 2) ? conv_get_2cf16_ci16_c(o, &fn_name) : conv_get_cf16_ci16_c(o, &fn_name);
+
+    //ignore dups
+    if(last_fn_name && !strcmp(last_fn_name, fn_name))
+        return NULL;
+
+    if(log)
+        fprintf(stderr, "%-20s\t", fn_name);
+
+    last_fn_name = fn_name;
+    return fn;
+}
+
+static int is_equal(unsigned chcnt)
+{
+    const int16_t* got = (const int16_t*)wire;
+    const int16_t* eta = (const int16_t*)wire_etalon;
+
+    for(unsigned i = 0; i < TICKS * WIRE_TICK_BZ(chcnt) / sizeof(int16_t); ++i)
+    {
+        if(got[i] != eta[i])
+        {
+            fprintf(stderr, "[%u] %d -> etalon: %d\n", i, got[i], eta[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+START_TEST(conv_ncf16_ci16_check_value)
+{
+    const uint16_t in[4] = { 0x3800, 0xbc00, 0x4000, 0x0000 }; // 0.5, -1.0, 2.0, 0
+    int16_t out[4] = { 0 };
+    const void* pin[1] = { in };
+    void* pout = out;
+
+    (*conv_get_cf16_ci16_c(OPT_GENERIC, NULL))(pin, sizeof(in), &pout, sizeof(out));
+    ck_assert_int_eq(out[0], 16384);
+    ck_assert_int_eq(out[1], -32767);
+    ck_assert_int_eq(out[2], 32767);
+    ck_assert_int_eq(out[3], 0);
+}
+END_TEST
+
+START_TEST(conv_ncf16_ci16_check_simd)
+{
+    const unsigned chcnt = chans[_i];
+    generic_opts_t opt = max_opt;
+    const void** pin = (const void**)host;
+    void* pout = (void*)wire;
+    last_fn_name = NULL;
+
+    const size_t bzin  = TICKS * HOST_TICK_BZ(chcnt);
+    const size_t bzout = TICKS * WIRE_TICK_BZ(chcnt);
+
+    fprintf(stderr,"\n**** Check SIMD implementations, %u channels ***\n", chcnt);
+
+    //get etalon output data (generic foo)
+    (*get_fn(chcnt, OPT_GENERIC, 0))(pin, bzin, &pout, bzout);
+    memcpy(wire_etalon, wire, TICKS * WIRE_TICK_BZ(chcnt));
+
+    while(opt != OPT_GENERIC)
+    {
+        conv_function_t fn = get_fn(chcnt, opt--, 1);
+        if(fn)
+        {
+            memset(wire, 0, TICKS * WIRE_TICK_BZ(chcnt));
+            (*fn)(pin, bzin, &pout, bzout);
+
+            int res = is_equal(chcnt);
+            res ? fprintf(stderr,"\tFAILED!\n") : fprintf(stderr,"\tOK!\n");
+            ck_assert_int_eq( res, 0 );
+        }
+    }
+}
+END_TEST
+
+
+START_TEST(conv_ncf16_ci16_speed)
+{
+    const unsigned chcnt = chans[_i];
+    generic_opts_t opt = max_opt;
+    const void** pin = (const void**)host;
+    void* pout = (void*)wire;
+    last_fn_name = NULL;
+
+    const size_t bzin  = TICKS * HOST_TICK_BZ(chcnt);
+    const size_t bzout = TICKS * WIRE_TICK_BZ(chcnt);
+
+    fprintf(stderr, "\n**** Compare SIMD implementations speed ***\n");
+    fprintf(stderr,   "**** channels: %u, packet: %lu bytes, iters: %u ***\n", chcnt, bzin, SPEED_MEASURE_ITERS);
+
+    while(opt != OPT_GENERIC)
+    {
+        conv_function_t fn = get_fn(chcnt, opt--, 1);
+        if(fn)
+        {
+            //warming
+            for(int i = 0; i < 100; ++i) (*fn)(pin, bzin, &pout, bzout);
+
+            //measuring
+            uint64_t tk = clock_get_time();
+            for(int i = 0; i < SPEED_MEASURE_ITERS; ++i) (*fn)(pin, bzin, &pout, bzout);
+            uint64_t tk1 = clock_get_time() - tk;
+            fprintf(stderr, "\t%" PRIu64 " us elapsed, %" PRIu64 " ns per 1 call, ave speed = %" PRIu64 " calls/s \n",
+                    tk1, (uint64_t)(tk1*1000LL/SPEED_MEASURE_ITERS), (uint64_t)(1000000LL*SPEED_MEASURE_ITERS/tk1));
+        }
+    }
+}
+END_TEST
+
+Suite * conv_ncf16_ci16_suite(void)
+{
+    Suite *s;
+    TCase *tc_core;
+
+    max_opt = cpu_vcap_get();
+
+    s = suite_create("conv_ncf16_ci16");
+    tc_core = tcase_create("XDSP");
+    tcase_set_timeout(tc_core, 60);
+    tcase_add_unchecked_fixture(tc_core, setup, teardown);
+    tcase_add_test(tc_core, conv_ncf16_ci16_check_value);
+    tcase_add_loop_test(tc_core, conv_ncf16_ci16_check_simd, 0, 2);
+    tcase_add_loop_test(tc_core, conv_ncf16_ci16_speed, 0, 2);
+
+    suite_add_tcase(s, tc_core);
+    return s;
+}
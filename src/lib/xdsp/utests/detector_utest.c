@@ -0,0 +1,334 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <check.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <math.h>
+#include "xdsp_utest_common.h"
+#include "../detector_functions.h"
+#include "../conv_i16_f32_2.h"
+
+#define TICKS (4096u + 13u)
+#define PRE_LEN 61u
+#define EPSILON 1E-4
+
+#define SPEED_MEASURE_ITERS 10000
+
+static const unsigned pre_lens[3] = { 16, 61, 256 };
+
+static int16_t* wire = NULL;
+static float* in = NULL;
+static float* pre = NULL;
+static float* out = NULL;
+static float* out_etalon = NULL;
+
+static const char* last_fn_name = NULL;
+static generic_opts_t max_opt = OPT_GENERIC;
+
+static void fill_preamble(unsigned plen)
+{
+    for(unsigned k = 0; k < plen; ++k)
+    {
+        // Unit energy chirp
+        float ph = M_PI * k * k / plen;
+        pre[2 * k + 0] = cosf(ph) / sqrtf(plen);
+        pre[2 * k + 1] = sinf(ph) / sqrtf(plen);
+    }
+}
+
+static void setup()
+{
+    posix_memalign((void**)&wire,       ALIGN_BYTES, sizeof(int16_t) * 2 * (TICKS + 256));
+    posix_memalign((void**)&in,         ALIGN_BYTES, sizeof(float) * 2 * (TICKS + 256));
+    posix_memalign((void**)&pre,        ALIGN_BYTES, sizeof(float) * 2 * 256);
+    posix_memalign((void**)&out,        ALIGN_BYTES, sizeof(float) * TICKS);
+    posix_memalign((void**)&out_etalon, ALIGN_BYTES, sizeof(float) * TICKS);
+
+    for(unsigned i = 0; i < 2 * (TICKS + 256); ++i)
+    {
+        wire[i] = (int16_t)(rand() & 0xffff);
+        in[i] = (float)wire[i] / 32767.f;
+    }
+}
+
+static void teardown()
+{
+    free(wire);
+    free(in);
+    free(pre);
+    free(out);
+    free(out_etalon);
+}
+
+static int is_equal(unsigned count)
+{
+    for(unsigned i = 0; i < count; ++i)
+    {
+        if(fabsf(out[i] - out_etalon[i]) > EPSILON * fmaxf(1.f, fabsf(out_etalon[i])))
+        {
+            fprintf(stderr, "i=%u out=%.8f etalon=%.8f\n", i, out[i], out_etalon[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+START_TEST(detector_scan_check_value)
+{
+    const float m[12] = { 0.1f, 0.9f, 1.5f, 0.8f, 1.2f, 0.3f, 0.6f, 1.1f, 0.2f, 0.1f, 1.0f, 0.4f };
+    generic_opts_t opt = max_opt;
+    last_fn_name = NULL;
+
+    do
+    {
+        const char* fn_name = NULL;
+        detector_scan_f32_function_t fn = detector_scan_f32_c(opt, &fn_name);
+        if(last_fn_name && !strcmp(last_fn_name, fn_name))
+            continue;
+        last_fn_name = fn_name;
+
+        // on = 1.0, off = 0.5: fires at 2, rearms at 5, fires at 7, rearms at 8, fires at 10
+        unsigned armed = 1;
+        ck_assert_int_eq(fn(m, 12, 1.0f, 0.5f, &armed), 2);
+        ck_assert_int_eq(armed, 0);
+        ck_assert_int_eq(fn(m + 3, 9, 1.0f, 0.5f, &armed), 4);
+        ck_assert_int_eq(fn(m + 8, 4, 1.0f, 0.5f, &armed), 2);
+        ck_assert_int_eq(fn(m + 11, 1, 1.0f, 0.5f, &armed), 1);
+        ck_assert_int_eq(armed, 1);
+
+        // State is carried across calls
+        armed = 0;
+        ck_assert_int_eq(fn(m + 2, 3, 1.0f, 0.5f, &armed), 3);
+        ck_assert_int_eq(armed, 0);
+        ck_assert_int_eq(fn(m + 5, 7, 1.0f, 0.5f, &armed), 2);
+        fprintf(stderr, "%-30s\tOK!\n", fn_name);
+    } while(opt-- != OPT_GENERIC);
+}
+END_TEST
+
+START_TEST(detector_scan_check_simd)
+{
+    generic_opts_t opt = max_opt;
+    last_fn_name = NULL;
+
+    detector_power_cf32_c(OPT_GENERIC, NULL)(in, TICKS, out_etalon);
+
+    fprintf(stderr,"\n**** Check SIMD implementations ***\n");
+    while(opt != OPT_GENERIC)
+    {
+        const char* fn_name = NULL;
+        detector_scan_f32_function_t fn = detector_scan_f32_c(opt--, &fn_name);
+        detector_scan_f32_function_t gfn = detector_scan_f32_c(OPT_GENERIC, NULL);
+        if(last_fn_name && !strcmp(last_fn_name, fn_name))
+            continue;
+        last_fn_name = fn_name;
+
+        // Walk over all triggers of random data
+        unsigned ga = 1, sa = 1, gp = 0, sp = 0, triggers = 0;
+        while(gp < TICKS)
+        {
+            gp += gfn(out_etalon + gp, TICKS - gp, 1.5f, 0.3f, &ga) + 1;
+            sp += fn(out_etalon + sp, TICKS - sp, 1.5f, 0.3f, &sa) + 1;
+            ck_assert_int_eq(gp, sp);
+            ck_assert_int_eq(ga, sa);
+            triggers++;
+        }
+
+        fprintf(stderr, "%-30s\t%u triggers\tOK!\n", fn_name, triggers - 1);
+        ck_assert_int_gt(triggers, 10);
+    }
+}
+END_TEST
+
+START_TEST(detector_power_check_simd)
+{
+    generic_opts_t opt = max_opt;
+    last_fn_name = NULL;
+
+    detector_power_cf32_c(OPT_GENERIC, NULL)(in, TICKS, out_etalon);
+
+    fprintf(stderr,"\n**** Check SIMD implementations ***\n");
+    while(opt != OPT_GENERIC)
+    {
+        const char* fn_name = NULL;
+        detector_power_cf32_function_t fn = detector_power_cf32_c(opt--, &fn_name);
+        if(last_fn_name && !strcmp(last_fn_name, fn_name))
+            continue;
+        last_fn_name = fn_name;
+
+        memset(out, 0, sizeof(float) * TICKS);
+        fn(in, TICKS, out);
+
+        int res = is_equal(TICKS);
+        fprintf(stderr, "%-30s\t%s\n", fn_name, res ? "FAILED!" : "OK!");
+        ck_assert_int_eq(res, 0);
+    }
+}
+END_TEST
+
+START_TEST(detector_xcorr_check_simd)
+{
+    const unsigned plen = pre_lens[_i];
+    generic_opts_t opt = max_opt;
+    last_fn_name = NULL;
+
+    fill_preamble(plen);
+    detector_xcorr_cf32_c(OPT_GENERIC, NULL)(in, TICKS, pre, plen, out_etalon);
+
+    fprintf(stderr,"\n**** Check SIMD implementations, preamble %u ***\n", plen);
+    while(opt != OPT_GENERIC)
+    {
+        const char* fn_name = NULL;
+        detector_xcorr_cf32_function_t fn = detector_xcorr_cf32_c(opt--, &fn_name);
+        if(last_fn_name && !strcmp(last_fn_name, fn_name))
+            continue;
+        last_fn_name = fn_name;
+
+        memset(out, 0, sizeof(float) * TICKS);
+        fn(in, TICKS, pre, plen, out);
+
+        int res = is_equal(TICKS);
+        fprintf(stderr, "%-30s\t%s\n", fn_name, res ? "FAILED!" : "OK!");
+        ck_assert_int_eq(res, 0);
+    }
+}
+END_TEST
+
+START_TEST(detector_xcorr_check_value)
+{
+    const unsigned pos = 1000;
+    float* x = NULL;
+    posix_memalign((void**)&x, ALIGN_BYTES, sizeof(float) * 2 * (TICKS + PRE_LEN));
+
+    // Scaled and rotated preamble in the weak noise
+    fill_preamble(PRE_LEN);
+    for(unsigned i = 0; i < 2 * (TICKS + PRE_LEN); ++i)
+        x[i] = 0.01f * in[i];
+    for(unsigned k = 0; k < PRE_LEN; ++k)
+    {
+        x[2 * (pos + k) + 0] += 0.3f * (pre[2 * k + 0] * 0.6f - pre[2 * k + 1] * 0.8f);
+        x[2 * (pos + k) + 1] += 0.3f * (pre[2 * k + 0] * 0.8f + pre[2 * k + 1] * 0.6f);
+    }
+
+    generic_opts_t opt = max_opt;
+    last_fn_name = NULL;
+    do
+    {
+        const char* fn_name = NULL;
+        detector_xcorr_cf32_function_t fn = detector_xcorr_cf32_c(opt, &fn_name);
+        if(last_fn_name && !strcmp(last_fn_name, fn_name))
+            continue;
+        last_fn_name = fn_name;
+
+        fn(x, TICKS, pre, PRE_LEN, out);
+
+        unsigned armed = 1;
+        unsigned idx = detector_scan_f32(out, TICKS, 0.8f, 0.4f, &armed);
+        fprintf(stderr, "%-30s\tpeak at %u, metric %.4f\n", fn_name, idx, out[pos]);
+        ck_assert_int_eq(idx, pos);
+        ck_assert(out[pos] > 0.95f && out[pos] <= 1.0f + EPSILON);
+        ck_assert_int_eq(detector_scan_f32(out + idx + 1, TICKS - idx - 1, 0.8f, 0.4f, &armed), TICKS - idx - 1);
+    } while(opt-- != OPT_GENERIC);
+
+    free(x);
+}
+END_TEST
+
+static uint64_t measure_conv(conv_function_t fn)
+{
+    const void* pin = (const void*)wire;
+    void* pout[1] = { in };
+
+    for(int i = 0; i < 100; ++i) (*fn)(&pin, TICKS * 4, pout, TICKS * 8);
+
+    uint64_t tk = clock_get_time();
+    for(int i = 0; i < SPEED_MEASURE_ITERS; ++i) (*fn)(&pin, TICKS * 4, pout, TICKS * 8);
+    return clock_get_time() - tk;
+}
+
+static void print_speed(const char* fn_name, uint64_t tk1)
+{
+    fprintf(stderr, "%-30s\t%" PRIu64 " us elapsed, %" PRIu64 " ns per 1 call, %" PRIu64 " Msps per core\n",
+            fn_name, tk1, (uint64_t)(tk1 * 1000LL / SPEED_MEASURE_ITERS),
+            (uint64_t)((uint64_t)TICKS * SPEED_MEASURE_ITERS / tk1));
+}
+
+START_TEST(detector_speed)
+{
+    const unsigned plen = pre_lens[_i];
+    generic_opts_t opt = max_opt;
+    const char* fn_name = NULL;
+
+    fill_preamble(plen);
+    fprintf(stderr, "\n**** Compare detector and conversion speed ***\n");
+    fprintf(stderr,   "**** packet: %u samples, preamble: %u, iters: %u ***\n", TICKS, plen, SPEED_MEASURE_ITERS);
+
+    // Reference, best ci16 -> cf32 conversion running in front of the detector
+    conv_function_t cfn = conv_get_i16_f32_c(max_opt, &fn_name);
+    print_speed(fn_name, measure_conv(cfn));
+
+    last_fn_name = NULL;
+    do
+    {
+        const char* xfn_name = NULL;
+        detector_power_cf32_function_t pfn = detector_power_cf32_c(opt, &fn_name);
+        detector_scan_f32_function_t sfn = detector_scan_f32_c(opt, NULL);
+        detector_xcorr_cf32_function_t xfn = detector_xcorr_cf32_c(opt, &xfn_name);
+        if(last_fn_name && !strcmp(last_fn_name, fn_name))
+            continue;
+        last_fn_name = fn_name;
+
+        unsigned armed;
+        for(int i = 0; i < 100; ++i) (*pfn)(in, TICKS, out);
+
+        // Power and hysteresis scan over the noise never crossing the threshold
+        uint64_t tk = clock_get_time();
+        for(int i = 0; i < SPEED_MEASURE_ITERS; ++i)
+        {
+            armed = 1;
+            (*pfn)(in, TICKS, out);
+            (*sfn)(out, TICKS, 10.f, 5.f, &armed);
+        }
+        print_speed(fn_name, clock_get_time() - tk);
+
+        // Correlation costs plen MACs per sample, run fewer iterations
+        const unsigned xiters = SPEED_MEASURE_ITERS / 100;
+        tk = clock_get_time();
+        for(unsigned i = 0; i < xiters; ++i)
+        {
+            armed = 1;
+            (*xfn)(in, TICKS, pre, plen, out);
+            (*sfn)(out, TICKS, 10.f, 5.f, &armed);
+        }
+        uint64_t tk1 = clock_get_time() - tk;
+        fprintf(stderr, "%-30s\t%" PRIu64 " us elapsed, %" PRIu64 " ns per 1 call, %" PRIu64 " ksps per core\n",
+                xfn_name, tk1, (uint64_t)(tk1 * 1000LL / xiters),
+                (uint64_t)((uint64_t)TICKS * xiters * 1000 / tk1));
+    } while(opt-- != OPT_GENERIC);
+}
+END_TEST
+
+Suite * detector_suite(void)
+{
+    Suite *s;
+    TCase *tc_core;
+
+    max_opt = cpu_vcap_get();
+
+    s = suite_create("detector_functions");
+    tc_core = tcase_create("XDSP");
+    tcase_set_timeout(tc_core, 300);
+    tcase_add_unchecked_fixture(tc_core, setup, teardown);
+    tcase_add_test(tc_core, detector_scan_check_value);
+    tcase_add_test(tc_core, detector_scan_check_simd);
+    tcase_add_test(tc_core, detector_power_check_simd);
+    tcase_add_loop_test(tc_core, detector_xcorr_check_simd, 0, 3);
+    tcase_add_test(tc_core, detector_xcorr_check_value);
+    tcase_add_loop_test(tc_core, detector_speed, 0, 3);
+    suite_add_tcase(s, tc_core);
+    return s;
+}
@@ -19,6 +19,18 @@ Suite * conv_i12_f32_suite(void);
 Suite * conv_ci12_2cf32_suite(void);
 Suite * conv_f32_i12_suite(void);
 Suite * conv_2cf32_ci12_suite(void);
+Suite * conv_ci16_ncf32_suite(void);
+Suite * conv_ci12_ncf32_suite(void);
+Suite * conv_ci16_nci16_suite(void);
+Suite * conv_ncf32_ci16_suite(void);
+Suite * conv_ncf32_ci12_suite(void);
+Suite * conv_nci16_ci16_suite(void);
+Suite * conv_ci16_ncf32_stat_suite(void);
+Suite * conv_ci16_ncf16_suite(void);
+Suite * conv_ncf16_ci16_suite(void);
+Suite * conv_ci12_cf16_suite(void);
+Suite * conv_cf16_ci12_suite(void);
+Suite * detector_suite(void);
 
 int main(int argc, char** argv)
 {
@@ -42,8 +54,32 @@ int main(int argc, char** argv)
     srunner_add_suite(sr, conv_ci12_2cf32_suite());
     srunner_add_suite(sr, conv_f32_i12_suite());
     srunner_add_suite(sr, conv_2cf32_ci12_suite());
+    srunner_add_suite(sr, conv_ci16_ncf32_suite());
+    srunner_add_suite(sr, conv_ci12_ncf32_suite());
+    srunner_add_suite(sr, conv_ci16_nci16_suite());
+    srunner_add_suite(sr, conv_ncf32_ci16_suite());
+    srunner_add_suite(sr, conv_ncf32_ci12_suite());
+    srunner_add_suite(sr, conv_nci16_ci16_suite());
+    srunner_add_suite(sr, conv_ci16_ncf32_stat_suite());
+    srunner_add_suite(sr, conv_ci16_ncf16_suite());
+    srunner_add_suite(sr, conv_ncf16_ci16_suite());
+    srunner_add_suite(sr, conv_ci12_cf16_suite());
+    srunner_add_suite(sr, conv_cf16_ci12_suite());
+    srunner_add_suite(sr, detector_suite());
 #else
     sr = srunner_create(rtsa_suite());
+    srunner_add_suite(sr, conv_ci16_ncf32_suite());
+    srunner_add_suite(sr, conv_ci12_ncf32_suite());
+    srunner_add_suite(sr, conv_ci16_nci16_suite());
+    srunner_add_suite(sr, conv_ncf32_ci16_suite());
+    srunner_add_suite(sr, conv_ncf32_ci12_suite());
+    srunner_add_suite(sr, conv_nci16_ci16_suite());
+    srunner_add_suite(sr, conv_ci16_ncf32_stat_suite());
+    srunner_add_suite(sr, conv_ci16_ncf16_suite());
+    srunner_add_suite(sr, conv_ncf16_ci16_suite());
+    srunner_add_suite(sr, conv_ci12_cf16_suite());
+    srunner_add_suite(sr, conv_cf16_ci12_suite());
+    srunner_add_suite(sr, detector_suite());
 #endif
     srunner_set_fork_status (sr, CK_NOFORK);
     srunner_run_all(sr, (argc > 1) ? CK_VERBOSE : CK_NORMAL);
@@ -10,6 +10,7 @@
 #include <math.h>
 #include "xdsp_utest_common.h"
 #include "../fftad_functions.h"
+#include "../fast_math.h"
 
 #undef DEBUG_PRINT
 
@@ -17,7 +18,12 @@
 static_assert( STREAM_SIZE >= 4096, "STREAM_SIZE should be >= 4096!" );
 static const unsigned packet_lens[3] = { 256, 4096, STREAM_SIZE };
 
+// Log2 approximations to check and max allowed error in dB for them
+static const unsigned log2_degrees[5] = { WVLT_LOG2_MITCHELL, 3, 4, 5, 6 };
+static const double log2_max_db_err[5] = { 0.2, 1E-2, 1.5E-3, 2.5E-4, 5E-5 };
+
 #define SPEED_MEASURE_ITERS 1000000
+#define NORM_MEASURE_ITERS  1000
 
 #define EPSILON 1E-4
 
@@ -79,7 +85,7 @@ START_TEST(fftad_check)
 
     fftad_init_c(OPT_GENERIC, NULL)(&acc, STREAM_SIZE);
     fftad_add_c(OPT_GENERIC, NULL)(&acc, in, STREAM_SIZE);
-    fftad_norm_c(OPT_GENERIC, NULL)(&acc, STREAM_SIZE, 1.0, 0.0, out_etalon);
+    fftad_norm_c(OPT_GENERIC, NULL)(&acc, STREAM_SIZE, 1.0, 0.0, out_etalon, WVLT_LOG2_DEGREE_DEFAULT);
 
 #ifdef DEBUG_PRINT
     for(unsigned i = 0; i < STREAM_SIZE; ++i)
@@ -115,7 +121,7 @@ START_TEST(fftad_check)
 
         fn_init(&acc, STREAM_SIZE);
         fn_add(&acc, in, STREAM_SIZE);
-        fn_norm(&acc, STREAM_SIZE, 1.0, 0.0, out);
+        fn_norm(&acc, STREAM_SIZE, 1.0, 0.0, out, WVLT_LOG2_DEGREE_DEFAULT);
 
 #ifdef DEBUG_PRINT
         for(unsigned i = 0; i < STREAM_SIZE; ++i)
@@ -179,13 +185,13 @@ START_TEST(fftad_speed)
         //warming
         (*fn_init)(&acc, size);
         for(unsigned i = 0; i < 100; ++i) (*fn_add)(&acc, in, size);
-        (*fn_norm)(&acc, size, 1.0, 0.0, out);
+        (*fn_norm)(&acc, size, 1.0, 0.0, out, WVLT_LOG2_DEGREE_DEFAULT);
 
         //measuring
         uint64_t tk = clock_get_time();
         (*fn_init)(&acc, size);
         for(unsigned i = 0; i < SPEED_MEASURE_ITERS; ++i) (*fn_add)(&acc, in, size);
-        (*fn_norm)(&acc, size, 1.0, 0.0, out);
+        (*fn_norm)(&acc, size, 1.0, 0.0, out, WVLT_LOG2_DEGREE_DEFAULT);
         uint64_t tk1 = clock_get_time() - tk;
 
         fprintf(stderr, "\t%" PRIu64 " us elapsed, %" PRIu64 " ns per 1 cycle, ave speed = %" PRIu64 " cycles/s \n",
@@ -196,6 +202,76 @@ START_TEST(fftad_speed)
 }
 END_TEST
 
+START_TEST(fftad_log2_accuracy)
+{
+    const unsigned degree = log2_degrees[_i];
+    fprintf(stderr, "\n**** Check log2 approximation degree %u, iters: %u ***\n", degree, NORM_MEASURE_ITERS);
+
+    const char* fn_name = NULL;
+    fftad_init_function_t fn_init = NULL;
+    fftad_add_function_t fn_add = NULL;
+    fftad_norm_function_t fn_norm = NULL;
+    unsigned* bin_idx = (unsigned*)malloc(sizeof(unsigned) * STREAM_SIZE);
+
+    last_fn_name = NULL;
+    generic_opts_t opt = max_opt;
+
+    while(opt != OPT_GENERIC)
+    {
+        fn_norm = fftad_norm_c(opt, &fn_name);
+        if(last_fn_name && !strcmp(last_fn_name, fn_name))
+        {
+            --opt;
+            continue;
+        }
+        last_fn_name = fn_name;
+        fn_init = fftad_init_c(opt, NULL);
+        fn_add = fftad_add_c(opt, NULL);
+
+        // accumulator layout is implementation specific, so get output position of
+        // every accumulator bin first: log2(1.0) is exact for polynomial approximations
+        for(unsigned i = 0; i < STREAM_SIZE; ++i)
+        {
+            acc.f_mant[i] = 1.0f;
+            acc.f_pwr[i] = i;
+        }
+        fn_norm(&acc, STREAM_SIZE, 1.0, 0.0, out, WVLT_LOG2_DEGREE_MIN);
+        for(unsigned i = 0; i < STREAM_SIZE; ++i)
+        {
+            bin_idx[i] = (unsigned)out[i];
+        }
+
+        fn_init(&acc, STREAM_SIZE);
+        fn_add(&acc, in, STREAM_SIZE);
+        for(unsigned i = 0; i < STREAM_SIZE; ++i)
+        {
+            unsigned j = bin_idx[i];
+            out_etalon[i] = 10.0 * log10(acc.f_mant[j]) + WVLT_DB_PER_LOG2 * acc.f_pwr[j];
+        }
+
+        uint64_t tk = clock_get_time();
+        for(unsigned i = 0; i < NORM_MEASURE_ITERS; ++i)
+            fn_norm(&acc, STREAM_SIZE, WVLT_DB_PER_LOG2, 0.0, out, degree);
+        uint64_t tk1 = clock_get_time() - tk;
+
+        double max_err = 0;
+        for(unsigned i = 0; i < STREAM_SIZE; ++i)
+        {
+            double err = fabs((double)out[i] - out_etalon[i]);
+            if(err > max_err) max_err = err;
+        }
+
+        fprintf(stderr, "%-20s\tmax err = %.7f dB, %" PRIu64 " us per %u bins\n",
+                fn_name, max_err, (uint64_t)(tk1/NORM_MEASURE_ITERS), STREAM_SIZE);
+
+        ck_assert(max_err < log2_max_db_err[_i]);
+        --opt;
+    }
+
+    free(bin_idx);
+}
+END_TEST
+
 Suite * fftad_suite(void)
 {
     Suite *s;
@@ -209,6 +285,7 @@ Suite * fftad_suite(void)
     tcase_add_unchecked_fixture(tc_core, setup, teardown);
     tcase_add_test(tc_core, fftad_check);
     tcase_add_loop_test(tc_core, fftad_speed, 0, 3);
+    tcase_add_loop_test(tc_core, fftad_log2_accuracy, 0, 5);
     suite_add_tcase(s, tc_core);
     return s;
 }
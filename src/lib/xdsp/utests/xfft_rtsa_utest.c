@@ -122,7 +122,7 @@ START_TEST(rtsa_check)
     {
         wvlt_fftwf_complex* ptr = in + i * STREAM_SIZE;
         rtsa_update_c(OPT_GENERIC, NULL)
-            (ptr, STREAM_SIZE, &rtsa_data_etalon, scale_mpy, mine, corr, diap);
+            (ptr, STREAM_SIZE, &rtsa_data_etalon, scale_mpy, mine, corr, diap, WVLT_LOG2_DEGREE_DEFAULT);
     }
 
     last_fn_name = NULL;
@@ -146,7 +146,7 @@ START_TEST(rtsa_check)
         {
             wvlt_fftwf_complex* ptr = in + i * STREAM_SIZE;
             (*fn_update)
-                (ptr, STREAM_SIZE, &rtsa_data, scale_mpy, mine, corr, diap);
+                (ptr, STREAM_SIZE, &rtsa_data, scale_mpy, mine, corr, diap, WVLT_LOG2_DEGREE_DEFAULT);
         }
 
         int res = is_equal();
@@ -205,7 +205,7 @@ START_TEST(rtsa_speed)
         rtsa_init(&rtsa_data, size);
         for(unsigned i = 0; i < 100; ++i)
                 (*fn_update)
-                    (in, size, &rtsa_data, scale_mpy, mine, corr, diap);
+                    (in, size, &rtsa_data, scale_mpy, mine, corr, diap, WVLT_LOG2_DEGREE_DEFAULT);
 
         //measuring
         rtsa_init(&rtsa_data, size);
@@ -217,7 +217,7 @@ START_TEST(rtsa_speed)
             {
                 wvlt_fftwf_complex* ptr = in + j * STREAM_SIZE;
                 (*fn_update)
-                    (ptr, size, &rtsa_data, scale_mpy, mine, corr, diap);
+                    (ptr, size, &rtsa_data, scale_mpy, mine, corr, diap, WVLT_LOG2_DEGREE_DEFAULT);
             }
         }
 
@@ -11,6 +11,7 @@
 #include <cstdlib>
 #include <algorithm>
 #include <cmath>
+#include <cerrno>
 #include <string.h>
 
 // #include <usdr_logging.h>
@@ -460,6 +461,16 @@ SoapySDR::Range SoapyUSDR::getGainRange(const int direction, const size_t channe
 SoapySDR::ArgInfoList SoapyUSDR::getFrequencyArgsInfo(const int direction, const size_t channel) const
 {
     auto infos = SoapySDR::Device::getFrequencyArgsInfo(direction, channel);
+    {
+        SoapySDR::ArgInfo info;
+        info.key = "OFFSET";
+        info.name = "LO Offset";
+        info.value = "0.0";
+        info.units = "Hz";
+        info.description = "Tune RF away from the channel and compensate it with baseband NCO";
+        info.type = SoapySDR::ArgInfo::FLOAT;
+        infos.push_back(info);
+    }
     /*{
         SoapySDR::ArgInfo info;
         info.key = "CORRECTIONS";
@@ -472,24 +483,106 @@ SoapySDR::ArgInfoList SoapyUSDR::getFrequencyArgsInfo(const int direction, const
     return infos;
 }
 
+void SoapyUSDR::setFrequency(const int direction, const size_t channel, const double frequency, const SoapySDR::Kwargs &args)
+{
+    std::unique_lock<std::recursive_mutex> lock(_dev->accessMutex);
+    SoapySDR::logf(callLogLvl(), "SoapyUSDR::setFrequency(%s, %d, %g MHz)",
+                   direction == SOAPY_SDR_RX ? "RX" : "TX",
+                   int(channel), frequency/1e6);
+
+    const char* dir = (direction == SOAPY_SDR_TX) ? "tx" : "rx";
+    bool split = args.count("OFFSET") || args.count("RF") || args.count("BB");
+    double rf = frequency;
+    double bb = 0;
+
+    if (!split) {
+        // Let the driver keep RF locked and move NCO while the channel stays in IF band
+        set_tune_policy(1);
+        set_freq_component(direction, channel, false, frequency);
+        return;
+    }
+
+    set_tune_policy(0);
+    if (args.count("OFFSET")) {
+        rf = frequency + std::stod(args.at("OFFSET"));
+    }
+
+    auto rfit = args.find("RF");
+    if (rfit == args.end() || rfit->second != "IGNORE") {
+        if (rfit != args.end()) {
+            rf = std::stod(rfit->second);
+        }
+        set_freq_component(direction, channel, false, rf);
+    }
+
+    auto bbit = args.find("BB");
+    if (bbit == args.end() || bbit->second != "IGNORE") {
+        bb = (bbit != args.end()) ? std::stod(bbit->second) : frequency - _actual_rf[direction];
+        set_freq_component(direction, channel, true, bb);
+    }
+
+    SoapySDR::logf(SOAPY_SDR_INFO, "SoapyUSDR::setFrequency(%s) %.6f MHz = RF %.6f MHz + BB %.3f kHz", dir,
+                   (_actual_rf[direction] + _actual_bb[direction]) / 1e6, _actual_rf[direction] / 1e6, _actual_bb[direction] / 1e3);
+}
+
 void SoapyUSDR::setFrequency(const int direction, const size_t channel, const std::string &name, const double frequency, const SoapySDR::Kwargs &/*args*/)
 {
     std::unique_lock<std::recursive_mutex> lock(_dev->accessMutex);
     SoapySDR::logf(callLogLvl(), "SoapyUSDR::setFrequency(%s, %d, %s, %g MHz)",
                    direction == SOAPY_SDR_RX ? "RX" : "TX",
                    int(channel), name.c_str(), frequency/1e6);
+    bool bb = (name == "BB");
+
+    // Explicit RF request always relocks the synthesizer
+    if (!bb) {
+        set_tune_policy(0);
+    }
+    set_freq_component(direction, channel, bb, frequency);
+}
+
+// Policy is device wide, so it's written only when it changes. Devices without
+// it always relock RF, same as policy 0.
+void SoapyUSDR::set_tune_policy(unsigned policy)
+{
+    if (policy == _tune_policy)
+        return;
+
+    const char* pname = get_sdr_param(0, "tune", "policy", NULL);
+    int res = usdr_dme_set_uint(_dev->dev(), pname, policy);
+    if (res == -ENOENT) {
+        SoapySDR::logf(SOAPY_SDR_DEBUG, "SoapyUSDR::setFrequency() device has no %s, RF is always relocked", pname);
+    } else if (res) {
+        throw std::runtime_error(std::string("SoapyUSDR::setFrequency(") + pname + ", " + std::to_string(policy) + ")");
+    }
+    _tune_policy = policy;
+}
+
+void SoapyUSDR::set_freq_component(const int direction, const size_t channel, bool bb, double frequency)
+{
     int res;
+    uint64_t val;
 
     const char* dir = (direction == SOAPY_SDR_TX) ? "tx" : "rx";
-    const char* pname = get_sdr_param(0, dir, "freqency", (name == "BB") ? "bb" : NULL);
+    const char* pname = get_sdr_param(0, dir, "freqency", bb ? "bb" : NULL);
 
-    uint64_t val = (((uint64_t)channel) << 32) | (uint32_t)frequency;
+    if (bb) {
+        val = (((uint64_t)channel) << 32) | (uint32_t)(int32_t)frequency;
+    } else {
+        val = (uint64_t)frequency;
+    }
 
     res = usdr_dme_set_uint(_dev->dev(), pname, val);
     if (res)
         throw std::runtime_error(std::string("SoapyUSDR::setFrequency(") + pname + ", " + ")");
 
-    _actual_frequency[direction] = val;
+    // Read back the split actually applied, drivers without the getters keep requested value
+    _actual_rf[direction] = bb ? _actual_rf[direction] : frequency;
+    _actual_bb[direction] = bb ? (int32_t)frequency : _actual_bb[direction];
+
+    if (usdr_dme_get_uint(_dev->dev(), get_sdr_param(0, dir, "freqency", "rf"), &val) == 0)
+        _actual_rf[direction] = val;
+    if (usdr_dme_get_uint(_dev->dev(), get_sdr_param(0, dir, "freqency", "bb"), &val) == 0)
+        _actual_bb[direction] = (int64_t)val;
 }
 
 double SoapyUSDR::getFrequency(const int direction, const size_t channel, const std::string &name) const
@@ -497,14 +590,14 @@ double SoapyUSDR::getFrequency(const int direction, const size_t channel, const
     std::unique_lock<std::recursive_mutex> lock(_dev->accessMutex);
     SoapySDR::logf(callLogLvl(), "SoapyUSDR::getFrequency(%d, %s)", int(channel), name.c_str());
 
-    return _actual_frequency[direction];
+    return (name == "BB") ? _actual_bb[direction] : _actual_rf[direction];
 }
 
 std::vector<std::string> SoapyUSDR::listFrequencies(const int /*direction*/, const size_t /*channel*/) const
 {
     std::vector<std::string> opts;
     opts.push_back("RF");
-    //opts.push_back("BB");
+    opts.push_back("BB");
     return opts;
 }
 
@@ -180,6 +180,8 @@ public:
 
     SoapySDR::ArgInfoList getFrequencyArgsInfo(const int direction, const size_t channel) const;
 
+    void setFrequency(const int direction, const size_t channel, const double frequency, const SoapySDR::Kwargs &args = SoapySDR::Kwargs());
+
     void setFrequency(const int direction, const size_t channel, const std::string &name, const double frequency, const SoapySDR::Kwargs &args = SoapySDR::Kwargs());
 
     double getFrequency(const int direction, const size_t channel, const std::string &name) const;
@@ -312,6 +314,8 @@ private:
     };
 
     const char* get_sdr_param(int sdridx, const char* dir, const char* par, const char* subpar);
+    void set_freq_component(const int direction, const size_t channel, bool bb, double frequency);
+    void set_tune_policy(unsigned policy);
 
     enum { MAX_CHANNELS = 2 };
 
@@ -345,7 +349,10 @@ private:
 
     rfic_type_t type = RFIC_UNKNOWN;
     double _actual_bandwidth[2] = { 0, 0 };
-    double _actual_frequency[2] = { 0, 0 };
+    // Applied RF / BB split, tuned frequency is rf + bb
+    double _actual_rf[2] = { 0, 0 };
+    double _actual_bb[2] = { 0, 0 };
+    unsigned _tune_policy = ~0u; // Last written /dm/sdr/0/tune/policy
 
     double _actual_gains[10] = { 0, };
 
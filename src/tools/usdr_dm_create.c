@@ -19,8 +19,11 @@
 #include <unistd.h>
 #include <math.h>
 #include <string.h>
+#include <errno.h>
+#include <time.h>
 
 #include "../common/ring_buffer.h"
+#include "../common/sample_codec.h"
 
 #define LOG_TAG "DMCR"
 
@@ -95,6 +98,289 @@ void* disk_write_thread(void* obj)
     return NULL;
 }
 
+/*
+ *  RX compression: each writer keeps up to ZJOB_INFLIGHT blocks in the shared
+ *  worker pool and stores finished blocks in order
+ */
+#define ZJOB_INFLIGHT 8
+#define MAX_ZWORKERS  64
+
+struct zjob
+{
+    const char* src;
+    unsigned len;
+    char* dst;
+    int res;
+    bool done;
+};
+
+struct zworker_stat
+{
+    uint64_t in_bytes;
+    uint64_t out_bytes;
+    uint64_t busy_ns;
+};
+
+static int s_zmode = -1;  // -1 - store raw samples
+static int s_zfmt = 0;
+static unsigned s_zworkers = 2;
+
+static pthread_mutex_t s_zlock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_zjob_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t s_zdone_cond = PTHREAD_COND_INITIALIZER;
+static struct zjob* s_zqueue[MAX_CHS * ZJOB_INFLIGHT];
+static unsigned s_zq_head = 0;
+static unsigned s_zq_cnt = 0;
+static bool s_zquit = false;
+static struct zworker_stat s_zstat[MAX_ZWORKERS];
+
+static uint64_t thread_cpu_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/*
+ *  Thread function - compression worker
+ */
+void* compress_thread(void* obj)
+{
+    struct zworker_stat* st = &s_zstat[(intptr_t)obj];
+
+    pthread_mutex_lock(&s_zlock);
+    for (;;) {
+        while (s_zq_cnt == 0 && !s_zquit)
+            pthread_cond_wait(&s_zjob_cond, &s_zlock);
+        if (s_zq_cnt == 0)
+            break;
+
+        struct zjob* j = s_zqueue[s_zq_head];
+        s_zq_head = (s_zq_head + 1) % SIZEOF_ARRAY(s_zqueue);
+        s_zq_cnt--;
+        pthread_mutex_unlock(&s_zlock);
+
+        uint64_t t0 = thread_cpu_ns();
+        int res = sample_codec_encode(s_zfmt, s_zmode, j->src, j->len, j->dst, sample_codec_bound(j->len));
+        st->busy_ns += thread_cpu_ns() - t0;
+        st->in_bytes += j->len;
+        st->out_bytes += (res > 0) ? res : 0;
+
+        pthread_mutex_lock(&s_zlock);
+        j->res = res;
+        j->done = true;
+        pthread_cond_broadcast(&s_zdone_cond);
+    }
+    pthread_mutex_unlock(&s_zlock);
+    return NULL;
+}
+
+static void zpool_submit(struct zjob* j)
+{
+    pthread_mutex_lock(&s_zlock);
+    j->done = false;
+    s_zqueue[(s_zq_head + s_zq_cnt) % SIZEOF_ARRAY(s_zqueue)] = j;
+    s_zq_cnt++;
+    pthread_cond_signal(&s_zjob_cond);
+    pthread_mutex_unlock(&s_zlock);
+}
+
+static void zpool_wait(struct zjob* j)
+{
+    pthread_mutex_lock(&s_zlock);
+    while (!j->done)
+        pthread_cond_wait(&s_zdone_cond, &s_zlock);
+    pthread_mutex_unlock(&s_zlock);
+}
+
+static void zpool_stop(pthread_t* threads)
+{
+    pthread_mutex_lock(&s_zlock);
+    s_zquit = true;
+    pthread_cond_broadcast(&s_zjob_cond);
+    pthread_mutex_unlock(&s_zlock);
+
+    uint64_t in = 0, out = 0;
+    double busy = 0;
+    for (unsigned w = 0; w < s_zworkers; w++) {
+        const struct zworker_stat* st = &s_zstat[w];
+        pthread_join(threads[w], NULL);
+
+        USDR_LOG(LOG_TAG, USDR_LOG_INFO, "Compression worker %u: %.1f MB -> %.1f MB, %.1f MB/s per core",
+                 w, st->in_bytes / 1.0e6, st->out_bytes / 1.0e6,
+                 st->busy_ns ? st->in_bytes * 1.0e3 / st->busy_ns : 0.0);
+        in += st->in_bytes;
+        out += st->out_bytes;
+        busy += st->busy_ns / 1.0e9;
+    }
+
+    USDR_LOG(LOG_TAG, USDR_LOG_INFO, "Compression %s: ratio %.3f, %.1f MB/s per core average",
+             sample_codec_mode_to_str(s_zmode), out ? (double)in / out : 0.0,
+             busy > 0 ? in / busy / 1.0e6 : 0.0);
+}
+
+/*
+ *  Thread function - compress RX stream to file
+ */
+void* disk_zwrite_thread(void* obj)
+{
+    unsigned i = (intptr_t)obj;
+    struct zjob jobs[ZJOB_INFLIGHT];
+    unsigned head = 0, cnt = 0;
+    bool failed = false;
+
+    for (unsigned k = 0; k < ZJOB_INFLIGHT; k++) {
+        jobs[k].dst = malloc(sample_codec_bound(s_rx_blksz));
+        if (!jobs[k].dst) {
+            USDR_LOG(LOG_TAG, USDR_LOG_ERROR, "RX thread[%u]: out of memory", i);
+            failed = true;
+        }
+    }
+
+    while (!failed) {
+        bool stop = s_stop || thread_stop;
+
+        // Keep workers busy, block only when nothing is in flight
+        while (!stop && cnt < ZJOB_INFLIGHT) {
+            unsigned idx = ring_buffer_cwait(rbuff[i], cnt ? 0 : 100000);
+            if (idx == IDX_TIMEDOUT)
+                break;
+
+            struct zjob* j = &jobs[(head + cnt) % ZJOB_INFLIGHT];
+            j->src = ring_buffer_at(rbuff[i], idx);
+            j->len = s_rx_blksz;
+            zpool_submit(j);
+            cnt++;
+        }
+
+        if (cnt == 0) {
+            if (stop)
+                break;
+            continue;
+        }
+
+        struct zjob* j = &jobs[head];
+        zpool_wait(j);
+        head = (head + 1) % ZJOB_INFLIGHT;
+        cnt--;
+
+        if (j->res < 0) {
+            USDR_LOG(LOG_TAG, USDR_LOG_ERROR, "RX thread[%u]: compression failed, error=%d", i, j->res);
+            failed = true;
+        } else if (fwrite(j->dst, j->res, 1, s_out_file[i]) != 1) {
+            USDR_LOG(LOG_TAG, USDR_LOG_ERROR, "Can't write %d bytes! error=%d", j->res, errno);
+            failed = true;
+        }
+
+        ring_buffer_cpost(rbuff[i]);
+    }
+
+    // Workers may still reference our buffers
+    for (; cnt > 0; cnt--, head = (head + 1) % ZJOB_INFLIGHT) {
+        zpool_wait(&jobs[head]);
+    }
+    for (unsigned k = 0; k < ZJOB_INFLIGHT; k++) {
+        free(jobs[k].dst);
+    }
+    return NULL;
+}
+
+/*
+ *  Compressed TX file playback, decoded block is consumed by TX buffers of any size
+ */
+struct zreader
+{
+    char* enc;
+    char* raw;
+    unsigned enc_max;
+    unsigned raw_max;
+    unsigned raw_len;
+    unsigned raw_off;
+    bool error;
+};
+
+static struct zreader* s_zrd[MAX_CHS]; // NULL for raw sample files
+
+static bool tx_file_is_compressed(FILE* f)
+{
+    uint32_t magic = 0;
+    size_t res = fread(&magic, sizeof(magic), 1, f);
+    rewind(f);
+    return res == 1 && magic == SCODEC_MAGIC;
+}
+
+static int zreader_next(struct zreader* z, FILE* f)
+{
+    sample_codec_hdr_t hdr;
+    unsigned raw_len, enc_len;
+    size_t res = fread(&hdr, 1, sizeof(hdr), f);
+    if (res == 0)
+        return -ENODATA;
+    if (res != sizeof(hdr) || sample_codec_block_info(&hdr, &raw_len, &enc_len))
+        goto failed;
+
+    if (z->enc_max < sizeof(hdr) + enc_len) {
+        char* p = realloc(z->enc, sizeof(hdr) + enc_len);
+        if (!p)
+            goto failed;
+        z->enc = p;
+        z->enc_max = sizeof(hdr) + enc_len;
+    }
+    if (z->raw_max < raw_len) {
+        char* p = realloc(z->raw, raw_len);
+        if (!p)
+            goto failed;
+        z->raw = p;
+        z->raw_max = raw_len;
+    }
+
+    memcpy(z->enc, &hdr, sizeof(hdr));
+    if (fread(z->enc + sizeof(hdr), 1, enc_len, f) != enc_len)
+        goto failed;
+
+    int len = sample_codec_decode(z->enc, sizeof(hdr) + enc_len, z->raw, z->raw_max);
+    if (len < 0)
+        goto failed;
+
+    z->raw_len = len;
+    z->raw_off = 0;
+    return 0;
+
+failed:
+    z->error = true;
+    return -EINVAL;
+}
+
+static size_t tx_file_read(unsigned i, char* data, size_t len)
+{
+    struct zreader* z = s_zrd[i];
+    size_t got = 0;
+
+    if (!z)
+        return fread(data, sizeof(char), len, s_in_file[i]);
+
+    while (got < len && !z->error) {
+        if (z->raw_off == z->raw_len && zreader_next(z, s_in_file[i]))
+            break;
+
+        size_t n = len - got;
+        if (n > z->raw_len - z->raw_off)
+            n = z->raw_len - z->raw_off;
+
+        memcpy(data + got, z->raw + z->raw_off, n);
+        got += n;
+        z->raw_off += n;
+    }
+    return got;
+}
+
+static void tx_file_rewind(unsigned i)
+{
+    rewind(s_in_file[i]);
+    if (s_zrd[i])
+        s_zrd[i]->raw_off = s_zrd[i]->raw_len = 0;
+}
+
 /*
  *  Thread function - read data from file to TX stream
  */
@@ -103,6 +389,13 @@ void* disk_read_thread(void* obj)
     unsigned i = (intptr_t)obj;
     bool interrupt = false;
 
+    if (tx_file_is_compressed(s_in_file[i])) {
+        USDR_LOG(LOG_TAG, USDR_LOG_INFO, "TX thread[%u]: playing back compressed file", i);
+        s_zrd[i] = calloc(1, sizeof(struct zreader));
+        if (!s_zrd[i])
+            return NULL;
+    }
+
     while (!s_stop && !thread_stop && !interrupt) {
 
         unsigned idx = ring_buffer_pwait(tbuff[i], 100000);
@@ -112,10 +405,10 @@ void* disk_read_thread(void* obj)
         char* data = ring_buffer_at(tbuff[i], idx);
         tx_header_t* hdr = (tx_header_t*)data;
 
-        hdr->len = fread(data + sizeof(tx_header_t), sizeof(char), s_tx_blksz, s_in_file[i]);
+        hdr->len = tx_file_read(i, data + sizeof(tx_header_t), s_tx_blksz);
         hdr->flags = TXF_NONE;
 
-        if(ferror(s_in_file[i]))
+        if(ferror(s_in_file[i]) || (s_zrd[i] && s_zrd[i]->error))
         {
             USDR_LOG(LOG_TAG, USDR_LOG_ERROR, "TX thread[%u]: can't read %u bytes! res=%u error=%d", i, s_tx_blksz, hdr->len, errno);
             hdr->flags |= TXF_READ_FILE_ERROR;
@@ -126,10 +419,10 @@ void* disk_read_thread(void* obj)
         {
             if(tx_file_cycle)
             {
-                rewind(s_in_file[i]);
+                tx_file_rewind(i);
 
                 if(hdr->len == 0)
-                    hdr->len = fread(data + sizeof(tx_header_t), sizeof(char), s_tx_blksz, s_in_file[i]);
+                    hdr->len = tx_file_read(i, data + sizeof(tx_header_t), s_tx_blksz);
 
                 if(hdr->len == 0)
                 {
@@ -149,6 +442,12 @@ void* disk_read_thread(void* obj)
         ring_buffer_ppost(tbuff[i]);
     }
 
+    if (s_zrd[i]) {
+        free(s_zrd[i]->enc);
+        free(s_zrd[i]->raw);
+        free(s_zrd[i]);
+        s_zrd[i] = NULL;
+    }
     return NULL;
 }
 
@@ -272,6 +571,7 @@ static void usage(int severity, const char* me)
     USDR_LOG(LOG_TAG, severity, "Usage: %s \n"
                                 "\t[-D device_parameters] \n"
                                 "\t[-f RX_filename [./out.data]] \n"
+                                "\t[-Z RX compression (raw|fast|strong)[:threads] [off]] \n"
                                 "\t[-I TX_filename(s) (optionally colon-separated list)] \n"
                                 "\t[-o <flag: cycle TX from file>] \n"
                                 "\t[-c count [128]] \n"
@@ -419,6 +719,7 @@ int main(UNUSED int argc, UNUSED char** argv)
     pusdr_dms_t strms[2] = { NULL, NULL };
     pthread_t wthread[MAX_CHS];
     pthread_t rthread[MAX_CHS];
+    pthread_t zthread[MAX_ZWORKERS];
     unsigned count = 128;
     bool explicit_count = false;
 
@@ -477,7 +778,7 @@ int main(UNUSED int argc, UNUSED char** argv)
     //set colored log output
     usdrlog_enablecolorize(NULL);
 
-    while ((opt = getopt(argc, argv, "B:U:u:R:Qq:e:E:w:W:y:Y:l:S:O:C:F:f:c:r:i:XtTNAoha:D:s:p:P:z:I:x:")) != -1) {
+    while ((opt = getopt(argc, argv, "B:U:u:R:Qq:e:E:w:W:y:Y:l:S:O:C:F:f:c:r:i:XtTNAoha:D:s:p:P:z:I:x:Z:")) != -1) {
         switch (opt) {
         //Time-division duplexing (TDD) frequency
         case 'q': dev_data[DD_TDD_FREQ].value = atof(optarg); dev_data[DD_TDD_FREQ].ignore = false; break;
@@ -544,6 +845,23 @@ int main(UNUSED int argc, UNUSED char** argv)
         case 'f':
             filename_rx = optarg;
             break;
+        //Compress RX data with the lossless block codec (ci8/ci12/ci16 only)
+        //Compressed TX files are detected and decoded automatically
+        case 'Z':
+        {
+            char* pth = strchr(optarg, ':');
+            if (pth) {
+                *pth = 0;
+                s_zworkers = atoi(pth + 1);
+            }
+
+            s_zmode = sample_codec_mode_from_str(optarg);
+            if (s_zmode < 0 || s_zworkers == 0 || s_zworkers > MAX_ZWORKERS) {
+                USDR_LOG(LOG_TAG, USDR_LOG_ERROR, "-Z option parsing error!");
+                exit(EXIT_FAILURE);
+            }
+            break;
+        }
         //Set file name(s) to read TX data (produce sine if omitted)
         //Use colon-separated list for several TX RF channels
         //If the number of channels exceeds the number of files, round-robin file rotation will be applied.
@@ -644,6 +962,14 @@ int main(UNUSED int argc, UNUSED char** argv)
         count = -1;
     }
 
+    if (s_zmode >= 0) {
+        s_zfmt = sample_codec_fmt_from_str(fmt);
+        if (s_zfmt < 0) {
+            USDR_LOG(LOG_TAG, USDR_LOG_ERROR, "RX compression isn't supported for '%s' format, use ci8/ci12/ci16", fmt);
+            exit(EXIT_FAILURE);
+        }
+    }
+
     start_tx_delay = samples_tx;
 
     // Discover & print available device list and exit (-Q option)
@@ -879,9 +1205,17 @@ int main(UNUSED int argc, UNUSED char** argv)
                 USDR_LOG(LOG_TAG, USDR_LOG_DEBUG, "RX storage data file #%u '%s' created OK", f, fmod);
         }
 
+        for (unsigned w = 0; s_zmode >= 0 && w < s_zworkers; w++) {
+            res = pthread_create(&zthread[w], NULL, compress_thread, (void*)(intptr_t)w);
+            if (res) {
+                USDR_LOG(LOG_TAG, USDR_LOG_ERROR, "Unable to start compression thread %d: errno %d", w, res);
+                goto dev_close;
+            }
+        }
+
         for (unsigned i = 0; i < rx_bufcnt; i++) {
             rbuff[i] = ring_buffer_create(256, snfo_rx.pktbszie);
-            res = pthread_create(&wthread[i], NULL, disk_write_thread, (void*)(intptr_t)i);
+            res = pthread_create(&wthread[i], NULL, (s_zmode >= 0) ? disk_zwrite_thread : disk_write_thread, (void*)(intptr_t)i);
             if (res) {
                 USDR_LOG(LOG_TAG, USDR_LOG_ERROR, "Unable to start RX thread %d: errno %d", i, res);
                 goto dev_close;
@@ -1007,6 +1341,9 @@ stop:
         for (unsigned i = 0; i < rx_bufcnt; i++) {
             pthread_join(wthread[i], NULL);
         }
+        if (s_zmode >= 0) {
+            zpool_stop(zthread);
+        }
     }
     if (dotx) {
         for (unsigned i = 0; i < tx_bufcnt; i++) {
@@ -0,0 +1,230 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <usdr_port.h>
+#include <usdr_logging.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include "../common/sample_codec.h"
+
+#define LOG_TAG "DMUP"
+
+static void usage(int severity, const char* me)
+{
+    USDR_LOG(LOG_TAG, severity, "Usage: %s [options] input [output]\n"
+                                "\tDecompress RX capture made with usdr_dm_create -Z, or compress raw one\n"
+                                "\t[-c mode: compress raw input (fast|strong) [decompress]] \n"
+                                "\t[-F format for compression (ci8|ci12|ci16) [ci16]] \n"
+                                "\t[-S block size in bytes for compression [65536]] \n"
+                                "\t[-l loglevel [3(INFO)]] \n"
+                                "\t[-h <flag: This help>]\n"
+                                "\tOutput is optional, without it data is only verified and throughput is reported",
+             me);
+}
+
+static uint64_t cpu_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static int do_compress(FILE* in, FILE* out, unsigned fmt, unsigned mode, unsigned blksz,
+                       uint64_t* raw_bytes, uint64_t* enc_bytes, uint64_t* busy_ns)
+{
+    char* raw = malloc(blksz);
+    char* enc = malloc(sample_codec_bound(blksz));
+    int res = 0;
+
+    if (!raw || !enc) {
+        res = -ENOMEM;
+        goto cleanup;
+    }
+
+    for (;;) {
+        size_t len = fread(raw, 1, blksz, in);
+        if (len == 0)
+            break;
+
+        uint64_t t0 = cpu_ns();
+        res = sample_codec_encode(fmt, mode, raw, len, enc, sample_codec_bound(blksz));
+        *busy_ns += cpu_ns() - t0;
+        if (res < 0)
+            break;
+
+        *raw_bytes += len;
+        *enc_bytes += res;
+        if (out && fwrite(enc, res, 1, out) != 1) {
+            res = -EIO;
+            break;
+        }
+        res = 0;
+    }
+
+    if (res == 0 && ferror(in))
+        res = -EIO;
+
+cleanup:
+    free(raw);
+    free(enc);
+    return res;
+}
+
+static int do_decompress(FILE* in, FILE* out,
+                         uint64_t* raw_bytes, uint64_t* enc_bytes, uint64_t* busy_ns)
+{
+    sample_codec_hdr_t hdr;
+    char* enc = NULL;
+    char* raw = NULL;
+    unsigned enc_max = 0, raw_max = 0;
+    int res = 0;
+
+    for (;;) {
+        unsigned raw_len, enc_len;
+        size_t len = fread(&hdr, 1, sizeof(hdr), in);
+        if (len == 0)
+            break;
+
+        if (len != sizeof(hdr) || sample_codec_block_info(&hdr, &raw_len, &enc_len)) {
+            USDR_LOG(LOG_TAG, USDR_LOG_ERROR, "Broken block header at offset %" PRIu64, *enc_bytes);
+            res = -EINVAL;
+            break;
+        }
+
+        if (enc_max < sizeof(hdr) + enc_len) {
+            enc_max = sizeof(hdr) + enc_len;
+            enc = realloc(enc, enc_max);
+        }
+        if (raw_max < raw_len) {
+            raw_max = raw_len;
+            raw = realloc(raw, raw_max);
+        }
+        if (!enc || !raw) {
+            res = -ENOMEM;
+            break;
+        }
+
+        memcpy(enc, &hdr, sizeof(hdr));
+        if (fread(enc + sizeof(hdr), 1, enc_len, in) != enc_len) {
+            USDR_LOG(LOG_TAG, USDR_LOG_ERROR, "Truncated block at offset %" PRIu64, *enc_bytes);
+            res = -EINVAL;
+            break;
+        }
+
+        uint64_t t0 = cpu_ns();
+        res = sample_codec_decode(enc, sizeof(hdr) + enc_len, raw, raw_max);
+        *busy_ns += cpu_ns() - t0;
+        if (res < 0) {
+            USDR_LOG(LOG_TAG, USDR_LOG_ERROR, "Corrupted block at offset %" PRIu64, *enc_bytes);
+            break;
+        }
+
+        *raw_bytes += res;
+        *enc_bytes += sizeof(hdr) + enc_len;
+        if (out && fwrite(raw, res, 1, out) != 1) {
+            res = -EIO;
+            break;
+        }
+        res = 0;
+    }
+
+    free(enc);
+    free(raw);
+    return res;
+}
+
+int main(int argc, char** argv)
+{
+    int opt, res;
+    int mode = -1;
+    const char* fmt = "ci16";
+    unsigned blksz = 65536;
+    FILE* in;
+    FILE* out = NULL;
+    uint64_t raw_bytes = 0, enc_bytes = 0, busy_ns = 0;
+
+    usdrlog_setlevel(NULL, USDR_LOG_INFO);
+    usdrlog_enablecolorize(NULL);
+
+    while ((opt = getopt(argc, argv, "c:F:S:l:h")) != -1) {
+        switch (opt) {
+        case 'c':
+            mode = sample_codec_mode_from_str(optarg);
+            if (mode < 0) {
+                USDR_LOG(LOG_TAG, USDR_LOG_ERROR, "Unknown compression mode `%s`", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'F':
+            fmt = optarg;
+            break;
+        case 'S':
+            blksz = atoi(optarg);
+            break;
+        case 'l':
+            usdrlog_setlevel(NULL, atoi(optarg));
+            break;
+        case 'h':
+            usdrlog_disablecolorize(NULL);
+            usage(USDR_LOG_INFO, argv[0]);
+            exit(EXIT_SUCCESS);
+        default:
+            usage(USDR_LOG_ERROR, argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (optind >= argc || blksz == 0) {
+        usage(USDR_LOG_ERROR, argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    int sfmt = sample_codec_fmt_from_str(fmt);
+    if (mode >= 0 && sfmt < 0) {
+        USDR_LOG(LOG_TAG, USDR_LOG_ERROR, "Unsupported format `%s`, use ci8/ci12/ci16", fmt);
+        exit(EXIT_FAILURE);
+    }
+
+    in = fopen(argv[optind], "rb");
+    if (!in) {
+        USDR_LOG(LOG_TAG, USDR_LOG_ERROR, "Unable to open '%s'", argv[optind]);
+        return 3;
+    }
+    if (optind + 1 < argc) {
+        out = fopen(argv[optind + 1], "wb");
+        if (!out) {
+            USDR_LOG(LOG_TAG, USDR_LOG_ERROR, "Unable to create '%s'", argv[optind + 1]);
+            fclose(in);
+            return 3;
+        }
+    }
+
+    if (mode >= 0) {
+        res = do_compress(in, out, sfmt, mode, blksz, &raw_bytes, &enc_bytes, &busy_ns);
+    } else {
+        res = do_decompress(in, out, &raw_bytes, &enc_bytes, &busy_ns);
+    }
+
+    if (res) {
+        USDR_LOG(LOG_TAG, USDR_LOG_ERROR, "Processing failed: errno %d", res);
+    }
+
+    USDR_LOG(LOG_TAG, USDR_LOG_INFO, "%s %.1f MB raw / %.1f MB compressed, ratio %.3f, %.1f MB/s per core",
+             (mode >= 0) ? "Compressed" : "Decompressed",
+             raw_bytes / 1.0e6, enc_bytes / 1.0e6,
+             enc_bytes ? (double)raw_bytes / enc_bytes : 0.0,
+             busy_ns ? raw_bytes * 1.0e3 / busy_ns : 0.0);
+
+    fclose(in);
+    if (out)
+        fclose(out);
+    return res ? 1 : 0;
+}
@@ -0,0 +1,113 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <check.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "../lib/models/dm_sweep.h"
+#include "../lib/ipblks/streams/streams_api.h"
+
+// Configuration accepted by the sweep reaches the stream and gets this error
+enum {
+    MOCK_STAT_ERR = -ENODEV,
+};
+
+static struct stream_handle s_rx;
+static unsigned s_stat_calls;
+
+static int mock_stat(stream_handle_t* UNUSED str, usdr_dms_nfo_t* UNUSED nfo)
+{
+    s_stat_calls++;
+    return MOCK_STAT_ERR;
+}
+
+static const struct stream_ops s_mock_ops = {
+    .stat = &mock_stat,
+};
+
+static struct usdr_dmsw_cfg s_cfg;
+
+static void setup(void)
+{
+    memset(&s_rx, 0, sizeof(s_rx));
+    s_rx.ops = &s_mock_ops;
+    s_stat_calls = 0;
+
+    memset(&s_cfg, 0, sizeof(s_cfg));
+    s_cfg.start = 100000000;
+    s_cfg.stop = 200000000;
+    s_cfg.rate = 10000000;
+    s_cfg.fftsz = 1024;
+    s_cfg.averages = 4;
+}
+
+static int create(void)
+{
+    pusdr_dmsw_t sw = NULL;
+    int res = usdr_dmsw_create(NULL, (pusdr_dms_t)&s_rx, &s_cfg, &sw);
+    ck_assert(sw == NULL);
+    return res;
+}
+
+START_TEST(sweep_usable_pct)
+{
+    ck_assert_int_eq(create(), MOCK_STAT_ERR);
+
+    s_cfg.usable_pct = 75;
+    ck_assert_int_eq(create(), MOCK_STAT_ERR);
+    ck_assert_int_eq(s_stat_calls, 2);
+
+    s_cfg.usable_pct = 76;
+    ck_assert_int_eq(create(), -EINVAL);
+    s_cfg.usable_pct = 100;
+    ck_assert_int_eq(create(), -EINVAL);
+    ck_assert_int_eq(s_stat_calls, 2);
+}
+END_TEST
+
+START_TEST(sweep_no_bins)
+{
+    // Less than 2 bins kept
+    s_cfg.fftsz = 64;
+    s_cfg.usable_pct = 1;
+    ck_assert_int_eq(create(), -EINVAL);
+
+    s_cfg.usable_pct = 4;
+    ck_assert_int_eq(create(), MOCK_STAT_ERR);
+    ck_assert_int_eq(s_stat_calls, 1);
+}
+END_TEST
+
+START_TEST(sweep_bad_cfg)
+{
+    s_cfg.fftsz = 1000;
+    ck_assert_int_eq(create(), -EINVAL);
+
+    s_cfg.fftsz = 1024;
+    s_cfg.stop = s_cfg.start;
+    ck_assert_int_eq(create(), -EINVAL);
+
+    s_cfg.stop = 200000000;
+    s_cfg.averages = 0;
+    ck_assert_int_eq(create(), -EINVAL);
+    ck_assert_int_eq(s_stat_calls, 0);
+}
+END_TEST
+
+Suite * dm_sweep_suite(void)
+{
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("dm_sweep");
+    tc_core = tcase_create("Core");
+
+    tcase_add_checked_fixture(tc_core, setup, NULL);
+    tcase_add_test(tc_core, sweep_usable_pct);
+    tcase_add_test(tc_core, sweep_no_bins);
+    tcase_add_test(tc_core, sweep_bad_cfg);
+    suite_add_tcase(s, tc_core);
+    return s;
+}
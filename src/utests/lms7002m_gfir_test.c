@@ -0,0 +1,130 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <check.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "lms7002m_gfir.h"
+
+#define NSAMPLES 4096
+
+static lms7002m_gfir_design_t s_fd;
+static int16_t s_hist[LMS7_GFIR_TAPS_MAX];
+static int16_t s_in[NSAMPLES];
+static int16_t s_out[NSAMPLES];
+
+// RMS of the settled part of the model output for a full scale / 2 tone
+static double model_tone_db(double freq)
+{
+    double acc = 0;
+
+    memset(s_hist, 0, sizeof(s_hist));
+    for (unsigned i = 0; i < NSAMPLES; i++) {
+        s_in[i] = (int16_t)lround(16384 * cos(2 * M_PI * freq * i));
+    }
+    lms7002m_gfir_model(&s_fd, s_hist, s_in, s_out, NSAMPLES);
+
+    for (unsigned i = LMS7_GFIR_TAPS_MAX; i < NSAMPLES; i++) {
+        acc += (double)s_out[i] * s_out[i];
+    }
+    return 10 * log10(acc / (NSAMPLES - LMS7_GFIR_TAPS_MAX) / (16384.0 * 16384.0 / 2));
+}
+
+START_TEST(gfir_limits)
+{
+    ck_assert_int_eq(lms7002m_gfir_max_taps(LMS7_GFIR1, 1), 5);
+    ck_assert_int_eq(lms7002m_gfir_max_taps(LMS7_GFIR1, 32), 40);
+    ck_assert_int_eq(lms7002m_gfir_max_taps(LMS7_GFIR3, 4), 60);
+    ck_assert_int_eq(lms7002m_gfir_max_taps(LMS7_GFIR3, 16), 120);
+    ck_assert_int_eq(lms7002m_gfir_max_taps(LMS7_GFIR3, 0), 0);
+
+    ck_assert_int_ne(lms7002m_gfir_design(LMS7_GFIR3, 8, 0.3, 0.2, &s_fd), 0);
+    ck_assert_int_ne(lms7002m_gfir_design(LMS7_GFIR3, 8, 0.3, 0.6, &s_fd), 0);
+}
+END_TEST
+
+START_TEST(gfir_design_quantized)
+{
+    int32_t sum = 0;
+
+    ck_assert_int_eq(lms7002m_gfir_design(LMS7_GFIR3, 16, 0.125, 0.15, &s_fd), 0);
+    ck_assert_int_eq(s_fd.taps, 119);
+    ck_assert_int_eq(s_fd.l, 7);
+    ck_assert_int_eq(s_fd.n, 15);
+
+    for (unsigned k = 0; k < s_fd.taps; k++) {
+        sum += s_fd.coeffs[k];
+        ck_assert_int_eq(s_fd.coeffs[k], s_fd.coeffs[s_fd.taps - 1 - k]);
+    }
+    ck_assert_int_eq(sum, 32768);
+
+    ck_assert(fabs(lms7002m_gfir_response_db(&s_fd, 0.0)) < 0.001);
+    ck_assert(fabs(lms7002m_gfir_response_db(&s_fd, 0.1)) < 0.1);
+    ck_assert(lms7002m_gfir_response_db(&s_fd, 0.16) < -s_fd.atten_db + 6);
+    ck_assert(lms7002m_gfir_response_db(&s_fd, 0.4) < -s_fd.atten_db + 6);
+}
+END_TEST
+
+START_TEST(gfir_image_layout)
+{
+    int16_t img[LMS7_GFIR_TAPS_MAX];
+
+    // 4 clocks per sample, 4 taps per bank in GFIR1
+    ck_assert_int_eq(lms7002m_gfir_design(LMS7_GFIR1, 4, 0.1, 0.3, &s_fd), 0);
+    ck_assert_int_eq(s_fd.taps, 19);
+    ck_assert_int_eq(s_fd.l, 3);
+    ck_assert_int_eq(lms7002m_gfir_image(&s_fd, img), 5);
+
+    for (unsigned b = 0; b < 5; b++) {
+        for (unsigned p = 0; p < LMS7_GFIR_BANK_LEN; p++) {
+            unsigned k = b * 4 + p;
+            int16_t exp = (p < 4 && k < s_fd.taps) ? s_fd.coeffs[k] : 0;
+            ck_assert_int_eq(img[b * LMS7_GFIR_BANK_LEN + p], exp);
+        }
+    }
+}
+END_TEST
+
+START_TEST(gfir_model)
+{
+    ck_assert_int_eq(lms7002m_gfir_design(LMS7_GFIR3, 8, 0.2, 0.3, &s_fd), 0);
+
+    // DC passes unchanged
+    memset(s_hist, 0, sizeof(s_hist));
+    for (unsigned i = 0; i < 256; i++) {
+        s_in[i] = 12345;
+    }
+    lms7002m_gfir_model(&s_fd, s_hist, s_in, s_out, 256);
+    ck_assert_int_eq(s_out[255], 12345);
+
+    // Model follows the designed response
+    ck_assert(fabs(model_tone_db(0.05)) < 0.2);
+    ck_assert(model_tone_db(0.35) < -s_fd.atten_db + 10);
+
+    // Saturation instead of wrap around
+    memset(s_hist, 0, sizeof(s_hist));
+    for (unsigned i = 0; i < 256; i++) {
+        s_in[i] = (i & 1) ? INT16_MIN : INT16_MAX;
+    }
+    ck_assert_int_eq(lms7002m_gfir_design(LMS7_GFIR1, 1, 0.1, 0.4, &s_fd), 0);
+    s_fd.coeffs[0] = s_fd.coeffs[2] = s_fd.coeffs[4] = 32767;
+    s_fd.coeffs[1] = s_fd.coeffs[3] = -32768;
+    lms7002m_gfir_model(&s_fd, s_hist, s_in, s_out, 256);
+    ck_assert_int_eq(s_out[255], INT16_MIN);
+    ck_assert_int_eq(s_out[254], INT16_MAX);
+}
+END_TEST
+
+Suite * lms7002m_gfir_suite(void)
+{
+    Suite *s = suite_create("lms7002m_gfir");
+    TCase *tc_core = tcase_create("GFIR");
+    tcase_add_test(tc_core, gfir_limits);
+    tcase_add_test(tc_core, gfir_design_quantized);
+    tcase_add_test(tc_core, gfir_image_layout);
+    tcase_add_test(tc_core, gfir_model);
+    suite_add_tcase(s, tc_core);
+    return s;
+}
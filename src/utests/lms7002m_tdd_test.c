@@ -0,0 +1,176 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <check.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lms7002m.h"
+#include "mock_lowlevel.h"
+
+enum {
+    REG_MAC = 0x0020,
+    REG_TXTSP_MODE = 0x0200,
+    REG_TXTSP_CFG = 0x0208,
+    REG_RXTSP_MODE = 0x0400,
+    REG_RXTSP_CFG = 0x040C,
+
+    TSP_EN = 1,
+    MAX_WRITES = 256,
+};
+
+static lms7002m_state_t s_lms;
+static lldev_t s_dev;
+static uint32_t s_wr[MAX_WRITES];
+static unsigned s_wr_cnt;
+
+static int mock_spi(unsigned UNUSED busno, uint32_t dout, uint32_t* UNUSED din)
+{
+    if (s_wr_cnt < MAX_WRITES)
+        s_wr[s_wr_cnt] = dout;
+    s_wr_cnt++;
+    return 0;
+}
+
+static const struct mock_functions s_mock = {
+    .mock_spi_tr32 = &mock_spi,
+};
+
+static unsigned reg_addr(uint32_t wr)
+{
+    return (wr >> 16) & 0x7fff;
+}
+
+static void setup(void)
+{
+    memset(&s_lms, 0, sizeof(s_lms));
+    s_dev = mock_lowlevel_create(&s_mock);
+    s_lms.dev = s_dev;
+    s_lms.reg_mac = LMS7_CH_AB;
+    s_lms.reg_amac = LMS7_CH_AB;
+    s_wr_cnt = 0;
+
+    // Streaming TSPs with NCO in use on both channels
+    ck_assert_int_eq(lms7002m_xxtsp_enable(&s_lms, LMS_RXTSP, true), 0);
+    ck_assert_int_eq(lms7002m_xxtsp_enable(&s_lms, LMS_TXTSP, true), 0);
+    ck_assert_int_eq(lms7002m_xxtsp_cmix(&s_lms, LMS_RXTSP, 100000), 0);
+    ck_assert_int_eq(lms7002m_xxtsp_cmix(&s_lms, LMS_TXTSP, -100000), 0);
+}
+
+static void teardown(void)
+{
+    free(s_dev);
+}
+
+// Same sequence as the TDD turnaround recorder, driver cache is left as it was
+static int record(bool tx, uint32_t* regs, lms7002m_state_t* st)
+{
+    lms7002m_state_t saved = s_lms;
+    int res, cnt;
+
+    ck_assert_int_eq(lms7002m_rec_start(&s_lms, regs, LMS7002M_SEQ_MAX), 0);
+    res = lms7002m_xxtsp_en(&s_lms, LMS_RXTSP, !tx);
+    res = res ? res : lms7002m_xxtsp_en(&s_lms, LMS_TXTSP, tx);
+    cnt = lms7002m_rec_stop(&s_lms);
+
+    *st = s_lms;
+    s_lms = saved;
+    return res ? res : cnt;
+}
+
+START_TEST(tdd_tsp_en_only)
+{
+    lms7002m_state_t st_rx, st_tx;
+    uint32_t rxregs[LMS7002M_SEQ_MAX];
+    uint32_t txregs[LMS7002M_SEQ_MAX];
+    uint32_t rx2tx[LMS7002M_SEQ_MAX];
+    uint32_t rx_full[LMS7002M_SEQ_MAX];
+    int rxcnt, txcnt, cnt;
+
+    rxcnt = record(false, rxregs, &st_rx);
+    txcnt = record(true, txregs, &st_tx);
+    ck_assert_int_gt(rxcnt, 0);
+    ck_assert_int_gt(txcnt, 0);
+
+    // NCO stays enabled in the cached config of both states
+    for (unsigned i = 0; i < 2; i++) {
+        ck_assert_int_eq(st_rx.reg_rxtsp_dscpcfg[i], s_lms.reg_rxtsp_dscpcfg[i]);
+        ck_assert_int_eq(st_tx.reg_txtsp_dscpcfg[i], s_lms.reg_txtsp_dscpcfg[i]);
+        ck_assert_int_eq(st_rx.reg_rxtsp_dscmode[i] & TSP_EN, TSP_EN);
+        ck_assert_int_eq(st_rx.reg_txtsp_dscmode[i] & TSP_EN, 0);
+        ck_assert_int_eq(st_tx.reg_rxtsp_dscmode[i] & TSP_EN, 0);
+        ck_assert_int_eq(st_tx.reg_txtsp_dscmode[i] & TSP_EN, TSP_EN);
+        ck_assert_int_eq(st_rx.reg_rxtsp_dscmode[i] & ~TSP_EN, s_lms.reg_rxtsp_dscmode[i] & ~TSP_EN);
+    }
+
+    cnt = lms7002m_regs_delta(&s_lms, NULL, 0, rxregs, rxcnt, rx_full, LMS7002M_SEQ_MAX);
+    ck_assert_int_gt(cnt, 0);
+    for (int k = 0; k < cnt; k++) {
+        unsigned a = reg_addr(rx_full[k]);
+        ck_assert(a == REG_MAC || a == REG_RXTSP_MODE || a == REG_TXTSP_MODE);
+    }
+
+    // Same value on both channels goes as a single AB write
+    cnt = lms7002m_regs_delta(&s_lms, rxregs, rxcnt, txregs, txcnt, rx2tx, LMS7002M_SEQ_MAX);
+    ck_assert_int_eq(cnt, 3);
+    ck_assert_int_eq(reg_addr(rx2tx[0]), REG_MAC);
+    ck_assert_int_eq(rx2tx[0] & 3, LMS7_CH_AB);
+    ck_assert_int_eq(reg_addr(rx2tx[1]), REG_RXTSP_MODE);
+    ck_assert_int_eq(rx2tx[1] & TSP_EN, 0);
+    ck_assert_int_eq(reg_addr(rx2tx[2]), REG_TXTSP_MODE);
+    ck_assert_int_eq(rx2tx[2] & TSP_EN, TSP_EN);
+
+    s_wr_cnt = 0;
+    ck_assert_int_eq(lms7002m_regs_post(&s_lms, rx2tx, cnt), 0);
+    ck_assert_int_eq(s_wr_cnt, 3);
+    for (unsigned k = 0; k < s_wr_cnt; k++) {
+        ck_assert_int_ne(reg_addr(s_wr[k]), REG_RXTSP_CFG);
+        ck_assert_int_ne(reg_addr(s_wr[k]), REG_TXTSP_CFG);
+    }
+}
+END_TEST
+
+START_TEST(tdd_single_channel)
+{
+    lms7002m_state_t st_rx, st_tx;
+    uint32_t rxregs[LMS7002M_SEQ_MAX];
+    uint32_t txregs[LMS7002M_SEQ_MAX];
+    uint32_t tx2rx[LMS7002M_SEQ_MAX];
+    int rxcnt, txcnt, cnt;
+
+    ck_assert_int_eq(lms7002m_mac_set(&s_lms, LMS7_CH_B), 0);
+    rxcnt = record(false, rxregs, &st_rx);
+    txcnt = record(true, txregs, &st_tx);
+
+    // Channel A is untouched
+    ck_assert_int_eq(st_tx.reg_rxtsp_dscmode[0], s_lms.reg_rxtsp_dscmode[0]);
+    ck_assert_int_eq(st_tx.reg_rxtsp_dscmode[1] & TSP_EN, 0);
+
+    // Sequence returns MAC to the current value
+    cnt = lms7002m_regs_delta(&s_lms, txregs, txcnt, rxregs, rxcnt, tx2rx, LMS7002M_SEQ_MAX);
+    ck_assert_int_eq(cnt, 3);
+    ck_assert_int_eq(tx2rx[0] & 3, LMS7_CH_B);
+
+    ck_assert_int_eq(lms7002m_mac_set(&s_lms, LMS7_CH_AB), 0);
+    s_wr_cnt = 0;
+    ck_assert_int_eq(lms7002m_regs_post(&s_lms, tx2rx, cnt), 0);
+    ck_assert_int_eq(s_wr_cnt, 4);
+    ck_assert_int_eq(reg_addr(s_wr[3]), REG_MAC);
+    ck_assert_int_eq(s_wr[3] & 3, LMS7_CH_AB);
+}
+END_TEST
+
+Suite * lms7002m_tdd_suite(void)
+{
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("lms7002m_tdd");
+    tc_core = tcase_create("Core");
+
+    tcase_add_checked_fixture(tc_core, setup, teardown);
+    tcase_add_test(tc_core, tdd_tsp_en_only);
+    tcase_add_test(tc_core, tdd_single_channel);
+    suite_add_tcase(s, tc_core);
+    return s;
+}
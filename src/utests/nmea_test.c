@@ -0,0 +1,77 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <check.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "nmea.h"
+
+static nmea_state_t s_st;
+
+static unsigned feed_str(const char* s)
+{
+    return nmea_feed(&s_st, s, strlen(s));
+}
+
+START_TEST(nmea_rmc_gga)
+{
+    int64_t sec;
+
+    nmea_init(&s_st);
+    ck_assert_int_eq(nmea_unix_time(&s_st, &sec), -EAGAIN);
+
+    ck_assert_int_eq(feed_str("$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230324,003.1,W*61\r\n"), 1);
+    ck_assert_int_eq(s_st.valid, 1);
+    ck_assert_int_eq(s_st.tod_ms, (12 * 3600 + 35 * 60 + 19) * 1000);
+    ck_assert_int_eq(s_st.year, 2024);
+    ck_assert_int_eq(s_st.month, 3);
+    ck_assert_int_eq(s_st.day, 23);
+
+    ck_assert_int_eq(feed_str("$GPGGA,123520,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*4D\r\n"), 1);
+    ck_assert_int_eq(s_st.fix, 1);
+    ck_assert_int_eq(s_st.sats, 8);
+    ck_assert_int_eq(s_st.seq, 2);
+
+    // 2024-03-23 12:35:20 UTC
+    ck_assert_int_eq(nmea_unix_time(&s_st, &sec), 0);
+    ck_assert(sec == 1711197320ll);
+    ck_assert_int_eq(s_st.errors, 0);
+}
+END_TEST
+
+START_TEST(nmea_split_and_errors)
+{
+    static const char zda[] = "$GNZDA,000001.50,01,01,2024,00,00*78\r\n";
+    int64_t sec;
+
+    nmea_init(&s_st);
+
+    // Byte by byte, as it comes from UART FIFO
+    for (unsigned i = 0; i < sizeof(zda) - 1; i++) {
+        nmea_feed(&s_st, zda + i, 1);
+    }
+    ck_assert_int_eq(s_st.sentences, 1);
+    ck_assert_int_eq(s_st.tod_ms, 1500);
+    ck_assert_int_eq(nmea_unix_time(&s_st, &sec), 0);
+    ck_assert(sec == 1704067201ll);
+
+    // Broken checksum, truncated sentence and line noise
+    ck_assert_int_eq(feed_str("$GPGGA,123520,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*4E\r\n"), 0);
+    ck_assert_int_eq(feed_str("$GPGGA,1235\xff\x01$GPGGA,123520,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*4D\n"), 1);
+    ck_assert_int_eq(s_st.errors, 2);
+    ck_assert_int_eq(s_st.sats, 8);
+    ck_assert_int_eq(strncmp(s_st.last, "$GPGGA,123520", 13), 0);
+}
+END_TEST
+
+Suite * nmea_suite(void)
+{
+    Suite *s = suite_create("nmea");
+    TCase *tc_core = tcase_create("NMEA");
+    tcase_add_test(tc_core, nmea_rmc_gga);
+    tcase_add_test(tc_core, nmea_split_and_errors);
+    suite_add_tcase(s, tc_core);
+    return s;
+}
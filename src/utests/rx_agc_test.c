@@ -0,0 +1,133 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <check.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "rx_agc.h"
+
+#define RATE   1000000 // 1 sample per us
+#define NSYMS  1000
+
+static const struct rx_agc_params s_params = {
+    .target_dbfs = -20,
+    .hyst_db = 3,
+    .attack_us = 100,
+    .decay_us = 50000,
+    .holdoff_us = 200,
+    .gain_min = 0,
+    .gain_max = 70,
+};
+
+static rx_agc_t s_agc;
+static uint64_t s_ts;
+
+// Level seen by the receiver for a given input and the currently applied gain
+static bool feed(double input_dbfs, int* gain)
+{
+    double level = input_dbfs + s_agc.gain_applied;
+    bool res = rx_agc_update(&s_agc, level, level > 0, s_ts, NSYMS, gain);
+    s_ts += NSYMS;
+    return res;
+}
+
+static int settle(double input_dbfs, unsigned packets, unsigned* changes)
+{
+    int gain;
+    *changes = 0;
+    for (unsigned i = 0; i < packets; i++) {
+        if (feed(input_dbfs, &gain))
+            (*changes)++;
+    }
+    return s_agc.gain_applied;
+}
+
+START_TEST(rx_agc_level)
+{
+    // Full scale constant envelope is 0 dBFS
+    ck_assert_float_eq_tol(rx_agc_level_dbfs(2ull * 32767 * 32767 * 100 / 2, 100, 32767), 0.0, 0.01);
+    ck_assert_float_eq_tol(rx_agc_level_dbfs(100ull * 3277 * 3277, 100, 32767), -20.0, 0.01);
+    ck_assert_int_lt(rx_agc_level_dbfs(0, 100, 32767), -100);
+}
+END_TEST
+
+START_TEST(rx_agc_attack_decay)
+{
+    unsigned changes;
+    int gain;
+
+    s_ts = 0;
+    rx_agc_init(&s_agc, &s_params, RATE, 40);
+
+    // Loud input is brought to the target within a few packets
+    gain = settle(-30, 10, &changes);
+    ck_assert_int_le(abs(gain - 10), s_params.hyst_db);
+    ck_assert_int_gt(changes, 0);
+    ck_assert_int_lt(changes, 10);
+
+    // Quiet input raises gain slowly, decay is 500 times slower than attack
+    gain = settle(-50, 5, &changes);
+    ck_assert_int_lt(gain, 20);
+    gain = settle(-50, 500, &changes);
+    ck_assert_int_le(abs(gain - 30), s_params.hyst_db);
+}
+END_TEST
+
+START_TEST(rx_agc_hysteresis)
+{
+    int gain;
+
+    s_ts = 0;
+    rx_agc_init(&s_agc, &s_params, RATE, 30);
+    for (unsigned i = 0; i < 100; i++) {
+        ck_assert(!feed(-50 + ((i & 1) ? 3 : -3), &gain));
+    }
+    ck_assert_int_eq(s_agc.gain_applied, 30);
+}
+END_TEST
+
+START_TEST(rx_agc_clipping)
+{
+    int gain;
+
+    s_ts = 0;
+    rx_agc_init(&s_agc, &s_params, RATE, 30);
+    ck_assert(rx_agc_update(&s_agc, -5, true, s_ts, NSYMS, &gain));
+    ck_assert_int_le(gain, 30 - RX_AGC_CLIP_STEP);
+
+    // Packets inside the holdoff window are ignored
+    ck_assert(!rx_agc_update(&s_agc, -5, true, s_ts + NSYMS, NSYMS, &gain));
+    ck_assert(rx_agc_update(&s_agc, -5, true, s_ts + 2 * NSYMS, NSYMS, &gain));
+}
+END_TEST
+
+START_TEST(rx_agc_clamp)
+{
+    unsigned changes;
+
+    s_ts = 0;
+    rx_agc_init(&s_agc, &s_params, RATE, 100);
+    ck_assert_int_eq(s_agc.gain_applied, s_params.gain_max);
+
+    ck_assert_int_eq(settle(20, 50, &changes), s_params.gain_min);
+    ck_assert_int_eq(settle(-150, 5000, &changes), s_params.gain_max);
+}
+END_TEST
+
+Suite * rx_agc_suite(void)
+{
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("RxAgc");
+    tc_core = tcase_create("Core");
+
+    tcase_add_test(tc_core, rx_agc_level);
+    tcase_add_test(tc_core, rx_agc_attack_decay);
+    tcase_add_test(tc_core, rx_agc_hysteresis);
+    tcase_add_test(tc_core, rx_agc_clipping);
+    tcase_add_test(tc_core, rx_agc_clamp);
+    suite_add_tcase(s, tc_core);
+    return s;
+}
@@ -0,0 +1,183 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <check.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+
+#include "sample_codec.h"
+
+#define TEST_BYTES  (3 * 16384 + 7) // Not a multiple of any sample size
+
+static uint8_t s_raw[TEST_BYTES];
+static uint8_t s_enc[TEST_BYTES + 1024];
+static uint8_t s_dec[TEST_BYTES];
+
+static const unsigned s_fmt_bits[] = { 8, 12, 16 };
+
+// Band limited tone with some noise, full scale of fmt
+static void fill_signal(unsigned fmt, unsigned noise)
+{
+    int amp = (1 << (s_fmt_bits[fmt] - 1)) - 1 - noise;
+    unsigned nvals = (fmt == SCODEC_CI8) ? TEST_BYTES : (fmt == SCODEC_CI12) ? TEST_BYTES / 3 * 2 : TEST_BYTES / 2;
+    unsigned i;
+
+    srand(fmt * 1000 + noise);
+    for (i = 0; i < nvals; i++) {
+        int v = amp * 0.9 * ((i & 1) ? sin(0.01 * (i / 2)) : cos(0.01 * (i / 2))) + (noise ? (int)(rand() % (2 * noise + 1)) - (int)noise : 0);
+        switch (fmt) {
+        case SCODEC_CI8: s_raw[i] = v; break;
+        case SCODEC_CI16: s_raw[2 * i] = v; s_raw[2 * i + 1] = v >> 8; break;
+        default:
+            if (i & 1) {
+                s_raw[i / 2 * 3 + 1] |= ((unsigned)v << 4) & 0xf0;
+                s_raw[i / 2 * 3 + 2] = v >> 4;
+            } else {
+                s_raw[i / 2 * 3 + 0] = v;
+                s_raw[i / 2 * 3 + 1] = (v >> 8) & 0x0f;
+            }
+        }
+    }
+    for (i = (fmt == SCODEC_CI12) ? nvals / 2 * 3 : nvals * s_fmt_bits[fmt] / 8; i < TEST_BYTES; i++) {
+        s_raw[i] = i;
+    }
+}
+
+static int roundtrip(unsigned fmt, unsigned mode, unsigned len)
+{
+    int elen = sample_codec_encode(fmt, mode, s_raw, len, s_enc, sizeof(s_enc));
+    ck_assert_int_gt(elen, 0);
+    ck_assert_int_le(elen, sample_codec_bound(len));
+
+    memset(s_dec, 0xcc, sizeof(s_dec));
+    int dlen = sample_codec_decode(s_enc, elen, s_dec, sizeof(s_dec));
+    ck_assert_int_eq(dlen, len);
+    ck_assert_mem_eq(s_raw, s_dec, len);
+    return elen;
+}
+
+START_TEST(sample_codec_roundtrip)
+{
+    const unsigned lens[] = { 0, 1, 5, 130, 257, 4099, TEST_BYTES };
+    for (unsigned fmt = SCODEC_CI8; fmt <= SCODEC_CI16; fmt++) {
+        fill_signal(fmt, 3);
+        for (unsigned mode = SCODEC_RAW; mode <= SCODEC_STRONG; mode++) {
+            for (unsigned l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+                roundtrip(fmt, mode, lens[l]);
+            }
+        }
+    }
+}
+END_TEST
+
+START_TEST(sample_codec_ratio)
+{
+    for (unsigned fmt = SCODEC_CI8; fmt <= SCODEC_CI16; fmt++) {
+        fill_signal(fmt, (fmt == SCODEC_CI8) ? 1 : 7);
+        int fast = roundtrip(fmt, SCODEC_FAST, TEST_BYTES);
+        int strong = roundtrip(fmt, SCODEC_STRONG, TEST_BYTES);
+
+        ck_assert_int_lt(fast, TEST_BYTES);
+        ck_assert_int_le(strong, fast);
+    }
+}
+END_TEST
+
+START_TEST(sample_codec_incompressible)
+{
+    srand(1);
+    for (unsigned i = 0; i < TEST_BYTES; i++) {
+        s_raw[i] = rand();
+    }
+
+    int elen = roundtrip(SCODEC_CI16, SCODEC_STRONG, TEST_BYTES);
+    ck_assert_int_eq(elen, sizeof(sample_codec_hdr_t) + TEST_BYTES);
+}
+END_TEST
+
+START_TEST(sample_codec_corrupted)
+{
+    unsigned raw_len, enc_len;
+
+    fill_signal(SCODEC_CI16, 3);
+    int elen = sample_codec_encode(SCODEC_CI16, SCODEC_FAST, s_raw, TEST_BYTES, s_enc, sizeof(s_enc));
+    ck_assert_int_eq(sample_codec_block_info(s_enc, &raw_len, &enc_len), 0);
+    ck_assert_int_eq(raw_len, TEST_BYTES);
+    ck_assert_int_eq(enc_len + sizeof(sample_codec_hdr_t), elen);
+
+    ck_assert_int_lt(sample_codec_decode(s_enc, elen - 1, s_dec, sizeof(s_dec)), 0);
+    ck_assert_int_lt(sample_codec_decode(s_enc, elen, s_dec, TEST_BYTES - 1), 0);
+
+    s_enc[0] ^= 1;
+    ck_assert_int_lt(sample_codec_decode(s_enc, elen, s_dec, sizeof(s_dec)), 0);
+}
+END_TEST
+
+// LSB first, same as the codec bit stream
+static unsigned put_bits(uint8_t* p, unsigned pos, uint32_t v, unsigned n)
+{
+    for (unsigned i = 0; i < n; i++, pos++) {
+        if (v & (1u << i))
+            p[pos / 8] |= 1u << (pos % 8);
+    }
+    return pos;
+}
+
+// Well formed block of 4 ci16 values with every residual coded as `res_bits`
+// of `res` after the group header
+static int decode_crafted(unsigned mode, uint8_t group_hdr, unsigned esc, uint32_t res, unsigned res_bits)
+{
+    sample_codec_hdr_t hdr;
+    uint8_t* payload = s_enc + sizeof(hdr);
+    unsigned pos = 0;
+
+    memset(s_enc, 0, sizeof(s_enc));
+    pos = put_bits(payload, pos, group_hdr, 8);
+    for (unsigned k = 0; k < 4; k++) {
+        pos = put_bits(payload, pos, (1u << esc) - 1, esc);
+        pos = put_bits(payload, pos, res, res_bits);
+    }
+
+    hdr.magic = SCODEC_MAGIC;
+    hdr.mode = mode;
+    hdr.fmt = SCODEC_CI16;
+    hdr.reserved = 0;
+    hdr.raw_len = 4 * sizeof(int16_t);
+    hdr.enc_len = (pos + 7) / 8;
+    memcpy(s_enc, &hdr, sizeof(hdr));
+
+    return sample_codec_decode(s_enc, sizeof(hdr) + hdr.enc_len, s_dec, sizeof(s_dec));
+}
+
+START_TEST(sample_codec_out_of_range)
+{
+    // Small residuals are decoded
+    ck_assert_int_eq(decode_crafted(SCODEC_FAST, 4, 0, 2, 4), 4 * sizeof(int16_t));
+
+    // Escaped residuals accumulated by the order 2 predictor
+    ck_assert_int_eq(decode_crafted(SCODEC_STRONG, 0x80 | 18, 24, 0x7fffe, 20), -EINVAL);
+    ck_assert_int_eq(decode_crafted(SCODEC_STRONG, 0, 24, 0x7fffe, 20), -EINVAL);
+
+    // Full 32 bit residuals of the fast mode
+    ck_assert_int_eq(decode_crafted(SCODEC_FAST, 32, 0, 0xfffffffe, 32), -EINVAL);
+}
+END_TEST
+
+Suite * sample_codec_suite(void)
+{
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("SampleCodec");
+    tc_core = tcase_create("Core");
+
+    tcase_add_test(tc_core, sample_codec_roundtrip);
+    tcase_add_test(tc_core, sample_codec_ratio);
+    tcase_add_test(tc_core, sample_codec_incompressible);
+    tcase_add_test(tc_core, sample_codec_corrupted);
+    tcase_add_test(tc_core, sample_codec_out_of_range);
+    suite_add_tcase(s, tc_core);
+    return s;
+}
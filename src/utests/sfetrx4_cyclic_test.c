@@ -0,0 +1,116 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <check.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../lib/ipblks/streams/stream_sfetrx4_dma32.h"
+
+enum {
+    MAX_CHUNKS = 256,
+};
+
+static unsigned s_start[MAX_CHUNKS + 1];
+
+// Chunks are contiguous, within the packet and start on whole bytes
+static void check_split(unsigned chunks, unsigned samples, unsigned pkt_symbs, unsigned granule)
+{
+    ck_assert_int_gt(chunks, 0);
+    ck_assert_int_eq(s_start[0], 0);
+    ck_assert_int_eq(s_start[chunks], samples);
+
+    for (unsigned k = 0; k < chunks; k++) {
+        ck_assert_int_gt(s_start[k + 1], s_start[k]);
+        ck_assert_int_le(s_start[k + 1] - s_start[k], pkt_symbs);
+        ck_assert_int_eq(s_start[k] % granule, 0);
+    }
+}
+
+// Every DMA buffer carries the same chunk on every pass
+static void check_pinned(unsigned chunks, unsigned ring)
+{
+    unsigned pinned[MAX_CHUNKS];
+
+    for (unsigned p = 0; p < 4 * ring * chunks; p++) {
+        unsigned buf = p % ring;
+        unsigned chunk = p % chunks;
+
+        if (p < ring)
+            pinned[buf] = chunk;
+        else
+            ck_assert_int_eq(pinned[buf], chunk);
+    }
+}
+
+START_TEST(cyclic_split_ring)
+{
+    unsigned chunks;
+
+    // 5 packets are spread over 8 chunks of the 32 buffer ring
+    chunks = sfetrx4_cyclic_split(5000, 1000, 1, 32, s_start);
+    ck_assert_int_eq(chunks, 8);
+    check_split(chunks, 5000, 1000, 1);
+    check_pinned(chunks, 32);
+
+    // Already a divisor
+    chunks = sfetrx4_cyclic_split(4000, 1000, 1, 32, s_start);
+    ck_assert_int_eq(chunks, 4);
+    check_split(chunks, 4000, 1000, 1);
+
+    // Ring length which isn't a power of 2
+    chunks = sfetrx4_cyclic_split(5000, 1000, 1, 12, s_start);
+    ck_assert_int_eq(chunks, 6);
+    check_split(chunks, 5000, 1000, 1);
+    check_pinned(chunks, 12);
+}
+END_TEST
+
+START_TEST(cyclic_split_granule)
+{
+    unsigned chunks;
+
+    // 12 bit single channel takes whole bytes every 2 samples
+    chunks = sfetrx4_cyclic_split(3002, 1000, 2, 32, s_start);
+    ck_assert_int_eq(chunks, 4);
+    check_split(chunks, 3002, 1000, 2);
+    check_pinned(chunks, 32);
+
+    // Too short to give every chunk a granule, packet split is used
+    chunks = sfetrx4_cyclic_split(1, 1000, 2, 32, s_start);
+    ck_assert_int_eq(chunks, 1);
+    ck_assert_int_eq(s_start[1], 1);
+}
+END_TEST
+
+START_TEST(cyclic_split_long)
+{
+    unsigned chunks;
+
+    // Doesn't fit the ring, copied every cycle
+    chunks = sfetrx4_cyclic_split(40000, 1000, 1, 32, s_start);
+    ck_assert_int_eq(chunks, 40);
+    check_split(chunks, 40000, 1000, 1);
+
+    // Unknown ring
+    chunks = sfetrx4_cyclic_split(5500, 1000, 1, 0, s_start);
+    ck_assert_int_eq(chunks, 6);
+    ck_assert_int_eq(s_start[5], 5000);
+    check_split(chunks, 5500, 1000, 1);
+}
+END_TEST
+
+Suite * sfetrx4_cyclic_suite(void)
+{
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("sfetrx4_cyclic");
+    tc_core = tcase_create("Core");
+
+    tcase_add_test(tc_core, cyclic_split_ring);
+    tcase_add_test(tc_core, cyclic_split_granule);
+    tcase_add_test(tc_core, cyclic_split_long);
+    suite_add_tcase(s, tc_core);
+    return s;
+}
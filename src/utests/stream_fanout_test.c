@@ -0,0 +1,319 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <check.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "../lib/ipblks/streams/stream_fanout.h"
+
+enum {
+    MOCK_WIRE_BYTES = 64,
+    MOCK_WIRE_SYMS = MOCK_WIRE_BYTES / 4,
+    MOCK_BUFS = 32,
+    TEST_DEPTH = 4,
+};
+
+struct mock_src {
+    struct stream_handle base;
+    unsigned fetched;
+    unsigned released;
+    bool out_of_order;
+    unsigned last_timeout;
+    unsigned ring;
+    uint32_t bufs[MOCK_BUFS][MOCK_WIRE_BYTES / 4];
+};
+
+static struct mock_src s_src;
+static stream_fanout_t* s_fan;
+
+static int mock_recv_raw(stream_handle_t* str, void** wire_buf, unsigned timeout_ms,
+                         struct usdr_dms_recv_nfo* nfo)
+{
+    struct mock_src* m = (struct mock_src*)str;
+    uint32_t* b = m->bufs[m->fetched % MOCK_BUFS];
+
+    m->last_timeout = timeout_ms;
+
+    for (unsigned i = 0; i < MOCK_WIRE_BYTES / 4; i++)
+        b[i] = m->fetched;
+
+    nfo->fsymtime = (uint64_t)m->fetched * MOCK_WIRE_SYMS;
+    nfo->totsyms = MOCK_WIRE_SYMS;
+    nfo->totlost = 0;
+    nfo->extra = 0;
+    nfo->stats = NULL;
+
+    *wire_buf = b;
+    m->fetched++;
+    return 0;
+}
+
+static int mock_release_raw(stream_handle_t* str, void* wire_buf)
+{
+    struct mock_src* m = (struct mock_src*)str;
+    if (wire_buf != m->bufs[m->released % MOCK_BUFS])
+        m->out_of_order = true;
+
+    m->released++;
+    return 0;
+}
+
+static int mock_stat(stream_handle_t* UNUSED str, usdr_dms_nfo_t* nfo)
+{
+    memset(nfo, 0, sizeof(*nfo));
+    nfo->type = USDR_DMS_RX;
+    nfo->channels = 1;
+    nfo->pktbszie = MOCK_WIRE_BYTES;
+    nfo->pktsyms = MOCK_WIRE_SYMS;
+    return 0;
+}
+
+static int mock_option_get(stream_handle_t* str, const char* name, int64_t* out_val)
+{
+    struct mock_src* m = (struct mock_src*)str;
+    if (strcmp(name, "buffers") == 0 && m->ring) {
+        *out_val = m->ring;
+        return 0;
+    } else if (strcmp(name, "wire_fmt") == 0) {
+        *out_val = (intptr_t)"ci16";
+        return 0;
+    } else if (strcmp(name, "wire_bytes") == 0) {
+        *out_val = MOCK_WIRE_BYTES;
+        return 0;
+    }
+    return -EINVAL;
+}
+
+static const struct stream_ops s_mock_ops = {
+    .recv_raw = &mock_recv_raw,
+    .release_raw = &mock_release_raw,
+    .stat = &mock_stat,
+    .option_get = &mock_option_get,
+};
+
+static void setup(void)
+{
+    memset(&s_src, 0, sizeof(s_src));
+    s_src.base.ops = &s_mock_ops;
+    ck_assert_int_eq(stream_fanout_create(&s_src.base, TEST_DEPTH, &s_fan), 0);
+}
+
+static void teardown(void)
+{
+    ck_assert_int_eq(stream_fanout_destroy(s_fan), 0);
+    ck_assert(!s_src.out_of_order);
+}
+
+static unsigned recv_pkt(stream_handle_t* r, unsigned timeout, int* res, struct usdr_dms_recv_nfo* nfo)
+{
+    uint32_t data[MOCK_WIRE_BYTES / 4];
+    char* buffs[1] = { (char*)data };
+
+    *res = r->ops->recv(r, buffs, timeout, nfo);
+    return data[0];
+}
+
+START_TEST(fanout_two_blocking) {
+    stream_handle_t *a, *b;
+    struct usdr_dms_recv_nfo nfo;
+    int res;
+
+    ck_assert_int_eq(stream_fanout_attach(s_fan, NULL, USDR_DMS_FANOUT_BLOCK, &a), 0);
+    ck_assert_int_eq(stream_fanout_attach(s_fan, NULL, USDR_DMS_FANOUT_BLOCK, &b), 0);
+
+    for (unsigned i = 0; i < TEST_DEPTH; i++) {
+        ck_assert_int_eq(recv_pkt(a, 0, &res, &nfo), i);
+        ck_assert_int_eq(res, 0);
+        ck_assert_int_eq(nfo.fsymtime, i * MOCK_WIRE_SYMS);
+    }
+    // Nothing is returned to hardware until the slowest reader consumed it
+    ck_assert_int_eq(s_src.released, 0);
+
+    // Window is full, fast reader has to wait for the slow one
+    recv_pkt(a, 10, &res, &nfo);
+    ck_assert_int_eq(res, -ETIMEDOUT);
+    ck_assert_int_eq(s_src.fetched, TEST_DEPTH);
+
+    for (unsigned i = 0; i < TEST_DEPTH; i++) {
+        ck_assert_int_eq(recv_pkt(b, 0, &res, &nfo), i);
+        ck_assert_int_eq(res, 0);
+        ck_assert_int_eq(nfo.totlost, 0);
+        ck_assert_int_eq(s_src.released, i + 1);
+    }
+
+    ck_assert_int_eq(stream_fanout_detach(a), 0);
+    ck_assert_int_eq(stream_fanout_detach(b), 0);
+}
+END_TEST
+
+START_TEST(fanout_drop_oldest) {
+    stream_handle_t *a, *b;
+    struct usdr_dms_recv_nfo nfo;
+    int res;
+
+    ck_assert_int_eq(stream_fanout_attach(s_fan, NULL, USDR_DMS_FANOUT_BLOCK, &a), 0);
+    ck_assert_int_eq(stream_fanout_attach(s_fan, NULL, USDR_DMS_FANOUT_DROP_OLDEST, &b), 0);
+
+    for (unsigned i = 0; i < TEST_DEPTH + 2; i++) {
+        ck_assert_int_eq(recv_pkt(a, 0, &res, &nfo), i);
+        ck_assert_int_eq(res, 0);
+    }
+    ck_assert_int_eq(s_src.released, 2);
+
+    ck_assert_int_eq(recv_pkt(b, 0, &res, &nfo), 2);
+    ck_assert_int_eq(res, 0);
+    ck_assert_int_eq(nfo.totlost, 2 * MOCK_WIRE_SYMS);
+    ck_assert_int_eq(recv_pkt(b, 0, &res, &nfo), 3);
+    ck_assert_int_eq(nfo.totlost, 0);
+
+    ck_assert_int_eq(stream_fanout_detach(b), 0);
+    ck_assert_int_eq(stream_fanout_detach(a), 0);
+    ck_assert_int_eq(s_src.released, s_src.fetched);
+}
+END_TEST
+
+START_TEST(fanout_skip) {
+    stream_handle_t *a, *b;
+    struct usdr_dms_recv_nfo nfo;
+    int res;
+
+    ck_assert_int_eq(stream_fanout_attach(s_fan, NULL, USDR_DMS_FANOUT_BLOCK, &a), 0);
+    ck_assert_int_eq(stream_fanout_attach(s_fan, NULL, USDR_DMS_FANOUT_SKIP, &b), 0);
+
+    for (unsigned i = 0; i < 3; i++) {
+        recv_pkt(a, 0, &res, &nfo);
+        ck_assert_int_eq(res, 0);
+    }
+
+    // Only the latest packet is delivered
+    ck_assert_int_eq(recv_pkt(b, 0, &res, &nfo), 2);
+    ck_assert_int_eq(res, 0);
+    ck_assert_int_eq(nfo.totlost, 2 * MOCK_WIRE_SYMS);
+    ck_assert_int_eq(s_src.released, 3);
+
+    ck_assert_int_eq(stream_fanout_detach(a), 0);
+    ck_assert_int_eq(stream_fanout_detach(b), 0);
+}
+END_TEST
+
+START_TEST(fanout_convert) {
+    stream_handle_t *a;
+    float data[2 * MOCK_WIRE_SYMS];
+    char* buffs[1] = { (char*)data };
+    usdr_dms_nfo_t snfo;
+
+    ck_assert_int_eq(stream_fanout_attach(s_fan, "cf32", USDR_DMS_FANOUT_BLOCK, &a), 0);
+    ck_assert_int_eq(a->ops->stat(a, &snfo), 0);
+    ck_assert_int_eq(snfo.pktbszie, sizeof(data));
+
+    ck_assert_int_eq(a->ops->recv(a, buffs, 0, NULL), 0);
+    ck_assert_int_eq(stream_fanout_detach(a), 0);
+}
+END_TEST
+
+START_TEST(fanout_timeout) {
+    stream_handle_t *a;
+    int res;
+
+    ck_assert_int_eq(stream_fanout_attach(s_fan, NULL, USDR_DMS_FANOUT_BLOCK, &a), 0);
+
+    recv_pkt(a, ~0u, &res, NULL);
+    ck_assert_int_eq(res, 0);
+    ck_assert_int_eq(s_src.last_timeout, ~0u);
+
+    // Source gets what is left of the caller's timeout, never more
+    recv_pkt(a, 500, &res, NULL);
+    ck_assert_int_eq(res, 0);
+    ck_assert_int_gt(s_src.last_timeout, 0);
+    ck_assert_int_le(s_src.last_timeout, 500);
+
+    recv_pkt(a, 0, &res, NULL);
+    ck_assert_int_eq(res, 0);
+    ck_assert_int_eq(s_src.last_timeout, 0);
+
+    ck_assert_int_eq(stream_fanout_detach(a), 0);
+}
+END_TEST
+
+struct timed_recv {
+    stream_handle_t* r;
+    int res;
+};
+
+static void* timed_recv_thread(void* arg)
+{
+    struct timed_recv* t = (struct timed_recv*)arg;
+    recv_pkt(t->r, 500, &t->res, NULL);
+    return NULL;
+}
+
+START_TEST(fanout_timeout_after_wait) {
+    stream_handle_t *a, *b;
+    struct timed_recv t;
+    pthread_t thr;
+    int res;
+
+    ck_assert_int_eq(stream_fanout_attach(s_fan, NULL, USDR_DMS_FANOUT_BLOCK, &a), 0);
+    ck_assert_int_eq(stream_fanout_attach(s_fan, NULL, USDR_DMS_FANOUT_BLOCK, &b), 0);
+
+    for (unsigned i = 0; i < TEST_DEPTH; i++) {
+        recv_pkt(b, 0, &res, NULL);
+        ck_assert_int_eq(res, 0);
+    }
+
+    // b waits for slow a to free a slot, then fetches with the time left
+    t.r = b;
+    ck_assert_int_eq(pthread_create(&thr, NULL, timed_recv_thread, &t), 0);
+    usleep(200000);
+    recv_pkt(a, 0, &res, NULL);
+    ck_assert_int_eq(res, 0);
+    pthread_join(thr, NULL);
+
+    ck_assert_int_eq(t.res, 0);
+    ck_assert_int_eq(s_src.fetched, TEST_DEPTH + 1);
+    ck_assert_int_le(s_src.last_timeout, 350);
+
+    ck_assert_int_eq(stream_fanout_detach(a), 0);
+    ck_assert_int_eq(stream_fanout_detach(b), 0);
+}
+END_TEST
+
+// Window never takes the whole DMA ring of the source
+START_TEST(fanout_ring_depth) {
+    stream_fanout_t* f;
+
+    s_src.ring = TEST_DEPTH;
+    ck_assert_int_eq(stream_fanout_create(&s_src.base, TEST_DEPTH, &f), -EINVAL);
+    ck_assert_int_eq(stream_fanout_create(&s_src.base, TEST_DEPTH - 1, &f), 0);
+    ck_assert_int_eq(stream_fanout_destroy(f), 0);
+
+    // Default depth is shrunk to fit
+    ck_assert_int_eq(stream_fanout_create(&s_src.base, 0, &f), 0);
+    ck_assert_int_eq(stream_fanout_destroy(f), 0);
+    s_src.ring = 0;
+}
+END_TEST
+
+Suite * stream_fanout_suite(void)
+{
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("stream_fanout");
+    tc_core = tcase_create("Core");
+
+    tcase_add_checked_fixture(tc_core, setup, teardown);
+    tcase_add_test(tc_core, fanout_two_blocking);
+    tcase_add_test(tc_core, fanout_drop_oldest);
+    tcase_add_test(tc_core, fanout_skip);
+    tcase_add_test(tc_core, fanout_convert);
+    tcase_add_test(tc_core, fanout_timeout);
+    tcase_add_test(tc_core, fanout_timeout_after_wait);
+    tcase_add_test(tc_core, fanout_ring_depth);
+    suite_add_tcase(s, tc_core);
+    return s;
+}
@@ -0,0 +1,159 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <check.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "../lib/ipblks/streams/stream_shm.h"
+
+enum {
+    SHM_PKT_SYMS = 16,
+    SHM_PKT_BYTES = SHM_PKT_SYMS * 4,
+    SHM_DEPTH = 4,
+};
+
+static char s_name[STREAM_SHM_NAME_MAX];
+static stream_shm_producer_t* s_prod;
+static unsigned s_published;
+
+static void setup(void)
+{
+    snprintf(s_name, sizeof(s_name), "/usdr-utest-%d", (int)getpid());
+    s_published = 0;
+    ck_assert_int_eq(stream_shm_producer_create(s_name, "ci16", 1, SHM_PKT_SYMS, SHM_PKT_BYTES,
+                                                SHM_DEPTH, &s_prod), 0);
+}
+
+static void teardown(void)
+{
+    stream_shm_producer_destroy(s_prod);
+}
+
+static void publish(void)
+{
+    struct usdr_dms_recv_nfo nfo;
+    int16_t* d = (int16_t*)stream_shm_producer_slot(s_prod);
+
+    for (unsigned i = 0; i < 2 * SHM_PKT_SYMS; i++)
+        d[i] = s_published;
+
+    memset(&nfo, 0, sizeof(nfo));
+    nfo.fsymtime = (uint64_t)s_published * SHM_PKT_SYMS;
+    nfo.totsyms = SHM_PKT_SYMS;
+    stream_shm_producer_commit(s_prod, &nfo);
+    s_published++;
+}
+
+static int recv_pkt(stream_handle_t* r, unsigned timeout, struct usdr_dms_recv_nfo* nfo)
+{
+    int16_t data[2 * SHM_PKT_SYMS];
+    char* buffs[1] = { (char*)data };
+    int res = r->ops->recv(r, buffs, timeout, nfo);
+    if (res)
+        return res;
+
+    for (unsigned i = 1; i < 2 * SHM_PKT_SYMS; i++)
+        ck_assert_int_eq(data[i], data[0]);
+    return data[0];
+}
+
+START_TEST(shm_roundtrip) {
+    stream_handle_t* r;
+    struct usdr_dms_recv_nfo nfo;
+
+    ck_assert_int_eq(stream_shm_attach(NULL, s_name, NULL, &r), 0);
+    ck_assert_int_eq(recv_pkt(r, 0, &nfo), -ETIMEDOUT);
+
+    publish();
+    publish();
+    ck_assert_int_eq(recv_pkt(r, 0, &nfo), 0);
+    ck_assert_int_eq(nfo.totsyms, SHM_PKT_SYMS);
+    ck_assert_int_eq(nfo.totlost, 0);
+    ck_assert_int_eq(recv_pkt(r, 0, &nfo), 1);
+    ck_assert_int_eq(nfo.fsymtime, SHM_PKT_SYMS);
+
+    ck_assert_int_eq(r->ops->destroy(r), 0);
+}
+END_TEST
+
+START_TEST(shm_overrun) {
+    stream_handle_t *r;
+    struct usdr_dms_recv_nfo nfo;
+    int64_t dropped;
+
+    ck_assert_int_eq(stream_shm_attach(NULL, s_name, NULL, &r), 0);
+
+    // Producer never waits, the lagging reader continues from the oldest slot
+    for (unsigned i = 0; i < SHM_DEPTH + 3; i++)
+        publish();
+
+    ck_assert_int_eq(recv_pkt(r, 0, &nfo), 3);
+    ck_assert_int_eq(nfo.totlost, 3 * SHM_PKT_SYMS);
+    ck_assert_int_eq(recv_pkt(r, 0, &nfo), 4);
+    ck_assert_int_eq(nfo.totlost, 0);
+
+    ck_assert_int_eq(r->ops->option_get(r, "dropped", &dropped), 0);
+    ck_assert_int_eq(dropped, 3);
+    ck_assert_int_eq(r->ops->destroy(r), 0);
+}
+END_TEST
+
+static void* publish_later(void* UNUSED param)
+{
+    usleep(20000);
+    publish();
+    return NULL;
+}
+
+START_TEST(shm_wakeup) {
+    stream_handle_t *r;
+    struct usdr_dms_recv_nfo nfo;
+    pthread_t t;
+
+    ck_assert_int_eq(stream_shm_attach(NULL, s_name, NULL, &r), 0);
+    ck_assert_int_eq(pthread_create(&t, NULL, publish_later, NULL), 0);
+
+    ck_assert_int_eq(recv_pkt(r, 1000, &nfo), 0);
+
+    pthread_join(t, NULL);
+    ck_assert_int_eq(r->ops->destroy(r), 0);
+}
+END_TEST
+
+START_TEST(shm_convert) {
+    stream_handle_t *r;
+    float data[2 * SHM_PKT_SYMS];
+    char* buffs[1] = { (char*)data };
+    usdr_dms_nfo_t snfo;
+
+    ck_assert_int_eq(stream_shm_attach(NULL, s_name, "cf32", &r), 0);
+    ck_assert_int_eq(r->ops->stat(r, &snfo), 0);
+    ck_assert_int_eq(snfo.pktbszie, sizeof(data));
+
+    publish();
+    ck_assert_int_eq(r->ops->recv(r, buffs, 0, NULL), 0);
+    ck_assert_int_eq(r->ops->destroy(r), 0);
+}
+END_TEST
+
+Suite * stream_shm_suite(void)
+{
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("stream_shm");
+    tc_core = tcase_create("Core");
+
+    tcase_add_checked_fixture(tc_core, setup, teardown);
+    tcase_add_test(tc_core, shm_roundtrip);
+    tcase_add_test(tc_core, shm_overrun);
+    tcase_add_test(tc_core, shm_wakeup);
+    tcase_add_test(tc_core, shm_convert);
+    suite_add_tcase(s, tc_core);
+    return s;
+}
@@ -0,0 +1,312 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <check.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+#include "../lib/ipblks/streams/stream_trigger.h"
+
+enum {
+    MOCK_WIRE_SYMS = 64,
+    MOCK_WIRE_BYTES = MOCK_WIRE_SYMS * 4,
+    MOCK_MAX_BURSTS = 4,
+    PRE_SYMS = 32,
+    POST_SYMS = 64,
+    PREAMBLE_SYMS = 31,
+};
+
+struct mock_burst {
+    uint64_t ts;
+    unsigned len;
+    bool preamble;
+};
+
+struct mock_src {
+    struct stream_handle base;
+    uint64_t ts;
+    uint64_t gap_at;      // Skip samples once this timestamp is reached
+    unsigned gap_len;
+    unsigned bcnt;
+    struct mock_burst bursts[MOCK_MAX_BURSTS];
+    int16_t buf[2 * MOCK_WIRE_SYMS];
+};
+
+static struct mock_src s_src;
+static stream_handle_t* s_trig;
+static float s_preamble[2 * PREAMBLE_SYMS];
+
+// m-sequence of x^5 + x^3 + 1 as BPSK
+static void make_preamble(void)
+{
+    unsigned lfsr = 0x1f;
+    for (unsigned k = 0; k < PREAMBLE_SYMS; k++) {
+        unsigned bit = lfsr & 1;
+        lfsr = (lfsr >> 1) | ((((lfsr >> 0) ^ (lfsr >> 2)) & 1) << 4);
+        s_preamble[2 * k + 0] = bit ? 1.0f : -1.0f;
+        s_preamble[2 * k + 1] = 0;
+    }
+}
+
+static void mock_sample(uint64_t ts, int16_t* iq)
+{
+    iq[0] = (ts % 7) - 3;
+    iq[1] = (ts % 5) - 2;
+
+    for (unsigned b = 0; b < s_src.bcnt; b++) {
+        const struct mock_burst* m = &s_src.bursts[b];
+        if (ts < m->ts || ts >= m->ts + m->len)
+            continue;
+
+        if (m->preamble) {
+            // Rotated by 90 degrees
+            iq[1] += 8192 * s_preamble[2 * (ts - m->ts)];
+        } else {
+            iq[0] += 16384;
+        }
+    }
+}
+
+static int mock_recv_raw(stream_handle_t* str, void** wire_buf, unsigned UNUSED timeout_ms,
+                         struct usdr_dms_recv_nfo* nfo)
+{
+    struct mock_src* m = (struct mock_src*)str;
+
+    nfo->totlost = 0;
+    if (m->gap_len && m->ts >= m->gap_at) {
+        m->ts += m->gap_len;
+        nfo->totlost = m->gap_len;
+        m->gap_len = 0;
+    }
+
+    for (unsigned i = 0; i < MOCK_WIRE_SYMS; i++)
+        mock_sample(m->ts + i, &m->buf[2 * i]);
+
+    nfo->fsymtime = m->ts;
+    nfo->totsyms = MOCK_WIRE_SYMS;
+    nfo->extra = 0;
+    nfo->stats = NULL;
+
+    *wire_buf = m->buf;
+    m->ts += MOCK_WIRE_SYMS;
+    return 0;
+}
+
+static int mock_release_raw(stream_handle_t* UNUSED str, void* UNUSED wire_buf)
+{
+    return 0;
+}
+
+static int mock_stat(stream_handle_t* UNUSED str, usdr_dms_nfo_t* nfo)
+{
+    memset(nfo, 0, sizeof(*nfo));
+    nfo->type = USDR_DMS_RX;
+    nfo->channels = 1;
+    nfo->pktbszie = MOCK_WIRE_BYTES;
+    nfo->pktsyms = MOCK_WIRE_SYMS;
+    return 0;
+}
+
+static int mock_option_get(stream_handle_t* UNUSED str, const char* name, int64_t* out_val)
+{
+    if (strcmp(name, "wire_fmt") == 0) {
+        *out_val = (intptr_t)"ci16";
+        return 0;
+    } else if (strcmp(name, "wire_bytes") == 0) {
+        *out_val = MOCK_WIRE_BYTES;
+        return 0;
+    }
+    return -EINVAL;
+}
+
+static const struct stream_ops s_mock_ops = {
+    .recv_raw = &mock_recv_raw,
+    .release_raw = &mock_release_raw,
+    .stat = &mock_stat,
+    .option_get = &mock_option_get,
+};
+
+static void add_burst(uint64_t ts, unsigned len, bool preamble)
+{
+    s_src.bursts[s_src.bcnt].ts = ts;
+    s_src.bursts[s_src.bcnt].len = len;
+    s_src.bursts[s_src.bcnt].preamble = preamble;
+    s_src.bcnt++;
+}
+
+static void setup(void)
+{
+    memset(&s_src, 0, sizeof(s_src));
+    s_src.base.ops = &s_mock_ops;
+    s_trig = NULL;
+    make_preamble();
+}
+
+static void teardown(void)
+{
+    if (s_trig)
+        ck_assert_int_eq(stream_trigger_destroy(s_trig), 0);
+}
+
+static void create_power(void)
+{
+    struct usdr_dms_trigger_cfg cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.type = USDR_DMS_TRIG_POWER;
+    cfg.pre_syms = PRE_SYMS;
+    cfg.post_syms = POST_SYMS;
+    cfg.thr_on = 0.1f;
+    cfg.thr_off = 0.05f;
+
+    ck_assert_int_eq(stream_trigger_create(&s_src.base, &cfg, &s_trig), 0);
+}
+
+static int recv_window(float* data, unsigned timeout, struct usdr_dms_recv_nfo* nfo)
+{
+    char* buffs[1] = { (char*)data };
+    return s_trig->ops->recv(s_trig, buffs, timeout, nfo);
+}
+
+START_TEST(trigger_power) {
+    float data[2 * (PRE_SYMS + POST_SYMS)];
+    struct usdr_dms_recv_nfo nfo;
+    usdr_dms_nfo_t snfo;
+    int64_t val;
+
+    add_burst(1000, 100, false);
+    add_burst(3000, 10, false);
+    create_power();
+
+    ck_assert_int_eq(s_trig->ops->stat(s_trig, &snfo), 0);
+    ck_assert_int_eq(snfo.pktsyms, PRE_SYMS + POST_SYMS);
+    ck_assert_int_eq(snfo.pktbszie, sizeof(data));
+
+    ck_assert_int_eq(recv_window(data, 1000, &nfo), 0);
+    ck_assert_int_eq(nfo.extra, 1000);
+    ck_assert_int_eq(nfo.fsymtime, 1000 - PRE_SYMS);
+    ck_assert_int_eq(nfo.totsyms, PRE_SYMS + POST_SYMS);
+    ck_assert_int_eq(nfo.totlost, 0);
+    ck_assert(fabsf(data[2 * (PRE_SYMS - 1)]) < 0.001f);
+    ck_assert(data[2 * PRE_SYMS] > 0.49f);
+
+    // Burst longer than the window doesn't retrigger until power falls
+    ck_assert_int_eq(recv_window(data, 1000, &nfo), 0);
+    ck_assert_int_eq(nfo.extra, 3000);
+    ck_assert(data[2 * (PRE_SYMS + 9)] > 0.49f);
+    ck_assert(fabsf(data[2 * (PRE_SYMS + 10)]) < 0.001f);
+
+    ck_assert_int_eq(recv_window(data, 20, &nfo), -ETIMEDOUT);
+    ck_assert_int_eq(s_trig->ops->option_get(s_trig, "triggers", &val), 0);
+    ck_assert_int_eq(val, 2);
+}
+END_TEST
+
+START_TEST(trigger_short_history) {
+    float data[2 * (PRE_SYMS + POST_SYMS)];
+    struct usdr_dms_recv_nfo nfo;
+
+    add_burst(10, 4, false);
+    add_burst(60, 4, false);
+    create_power();
+
+    // Not enough samples before the first trigger
+    ck_assert_int_eq(recv_window(data, 1000, &nfo), 0);
+    ck_assert_int_eq(nfo.extra, 10);
+    ck_assert_int_eq(nfo.fsymtime, 0);
+    ck_assert_int_eq(nfo.totsyms, 10 + POST_SYMS);
+
+    // Overlapping window of the next trigger is delivered in full
+    ck_assert_int_eq(recv_window(data, 1000, &nfo), 0);
+    ck_assert_int_eq(nfo.extra, 60);
+    ck_assert_int_eq(nfo.fsymtime, 60 - PRE_SYMS);
+    ck_assert_int_eq(nfo.totsyms, PRE_SYMS + POST_SYMS);
+    ck_assert(data[2 * PRE_SYMS] > 0.49f);
+    ck_assert(fabsf(data[2 * (PRE_SYMS + 4)]) < 0.001f);
+}
+END_TEST
+
+START_TEST(trigger_gap) {
+    float data[2 * (PRE_SYMS + POST_SYMS)];
+    struct usdr_dms_recv_nfo nfo;
+    int64_t val;
+
+    // Window of the first burst is cut by the lost samples
+    add_burst(1000, 8, false);
+    add_burst(2000, 8, false);
+    s_src.gap_at = 1024;
+    s_src.gap_len = 128;
+    create_power();
+
+    ck_assert_int_eq(recv_window(data, 1000, &nfo), 0);
+    ck_assert_int_eq(nfo.extra, 2000);
+    ck_assert_int_eq(nfo.totlost, 128);
+    ck_assert_int_eq(s_trig->ops->option_get(s_trig, "dropped", &val), 0);
+    ck_assert_int_eq(val, 1);
+}
+END_TEST
+
+START_TEST(trigger_xcorr) {
+    float data[2 * (PRE_SYMS + POST_SYMS)];
+    struct usdr_dms_recv_nfo nfo;
+    struct usdr_dms_trigger_cfg cfg;
+
+    // Strong DC burst doesn't trigger, preamble does
+    add_burst(500, 300, false);
+    add_burst(2000, PREAMBLE_SYMS, true);
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.type = USDR_DMS_TRIG_XCORR;
+    cfg.pre_syms = PRE_SYMS;
+    cfg.post_syms = POST_SYMS;
+    cfg.thr_on = 0.7f;
+    cfg.thr_off = 0.3f;
+    cfg.preamble = s_preamble;
+    cfg.preamble_syms = PREAMBLE_SYMS;
+    ck_assert_int_eq(stream_trigger_create(&s_src.base, &cfg, &s_trig), 0);
+
+    ck_assert_int_eq(recv_window(data, 1000, &nfo), 0);
+    ck_assert_int_eq(nfo.extra, 2000);
+    ck_assert_int_eq(nfo.fsymtime, 2000 - PRE_SYMS);
+    ck_assert(fabsf(data[2 * PRE_SYMS + 1]) > 0.24f);
+}
+END_TEST
+
+START_TEST(trigger_bad_cfg) {
+    struct usdr_dms_trigger_cfg cfg;
+    stream_handle_t* t;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.type = USDR_DMS_TRIG_XCORR;
+    cfg.post_syms = POST_SYMS;
+    cfg.thr_on = 0.5f;
+    ck_assert_int_eq(stream_trigger_create(&s_src.base, &cfg, &t), -EINVAL);
+
+    cfg.type = USDR_DMS_TRIG_POWER;
+    cfg.channel = 1;
+    ck_assert_int_eq(stream_trigger_create(&s_src.base, &cfg, &t), -EINVAL);
+
+    cfg.channel = 0;
+    cfg.thr_off = 1.0f;
+    ck_assert_int_eq(stream_trigger_create(&s_src.base, &cfg, &t), -EINVAL);
+}
+END_TEST
+
+Suite * stream_trigger_suite(void)
+{
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("stream_trigger");
+    tc_core = tcase_create("Core");
+
+    tcase_add_checked_fixture(tc_core, setup, teardown);
+    tcase_add_test(tc_core, trigger_power);
+    tcase_add_test(tc_core, trigger_short_history);
+    tcase_add_test(tc_core, trigger_gap);
+    tcase_add_test(tc_core, trigger_xcorr);
+    tcase_add_test(tc_core, trigger_bad_cfg);
+    suite_add_tcase(s, tc_core);
+    return s;
+}
@@ -11,6 +11,19 @@
 Suite * ring_buffer_suite(void);
 Suite * trig_suite(void);
 Suite * clockgen_suite(void);
+Suite * stream_fanout_suite(void);
+Suite * sample_codec_suite(void);
+Suite * rx_agc_suite(void);
+Suite * wb_stitch_suite(void);
+Suite * nmea_suite(void);
+Suite * lms7002m_gfir_suite(void);
+Suite * lms7002m_tdd_suite(void);
+Suite * stream_shm_suite(void);
+Suite * stream_trigger_suite(void);
+Suite * sfetrx4_cyclic_suite(void);
+Suite * dm_sweep_suite(void);
+Suite * xsdr_snapshot_suite(void);
+Suite * vpu_ring_suite(void);
 
 int main(int argc, char** argv)
 {
@@ -28,6 +41,19 @@ int main(int argc, char** argv)
     sr = srunner_create(ring_buffer_suite());
     srunner_add_suite(sr, trig_suite());
     srunner_add_suite(sr, clockgen_suite());
+    srunner_add_suite(sr, stream_fanout_suite());
+    srunner_add_suite(sr, sample_codec_suite());
+    srunner_add_suite(sr, rx_agc_suite());
+    srunner_add_suite(sr, wb_stitch_suite());
+    srunner_add_suite(sr, nmea_suite());
+    srunner_add_suite(sr, lms7002m_gfir_suite());
+    srunner_add_suite(sr, lms7002m_tdd_suite());
+    srunner_add_suite(sr, stream_shm_suite());
+    srunner_add_suite(sr, stream_trigger_suite());
+    srunner_add_suite(sr, sfetrx4_cyclic_suite());
+    srunner_add_suite(sr, dm_sweep_suite());
+    srunner_add_suite(sr, xsdr_snapshot_suite());
+    srunner_add_suite(sr, vpu_ring_suite());
 
     srunner_run_all(sr, (argc > 1) ? CK_VERBOSE : CK_NORMAL);
     number_failed = srunner_ntests_failed(sr);
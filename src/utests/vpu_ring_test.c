@@ -0,0 +1,134 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <check.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "../lib/lowlevel/verilator_ll/unix_vll.h"
+#include "../lib/lowlevel/verilator_ll/vpu.h"
+
+enum {
+    RING_MEM_SZ = 4096,
+    MAX_PAYLOAD = 8,
+};
+
+static uint64_t s_mem[RING_MEM_SZ / 8];
+static struct vll_ring s_tx;
+static struct vll_ring s_rx;
+
+static struct pheader s_ph;
+static uint32_t s_data[MAX_PAYLOAD];
+
+static void setup(void)
+{
+    memset(s_mem, 0, sizeof(s_mem));
+    ck_assert_int_eq(vll_ring_init(&s_tx, s_mem, sizeof(s_mem)), 0);
+    ck_assert_int_eq(vll_ring_attach(&s_rx, s_mem, sizeof(s_mem)), 0);
+}
+
+// Publish raw words bypassing packet formatting
+static void put_raw(const uint32_t* dw, unsigned cnt)
+{
+    ck_assert_int_eq(vll_ring_put(&s_tx, dw, cnt), 0);
+    vll_ring_flush(&s_tx);
+}
+
+static void send_wr(uint32_t addr, uint32_t val)
+{
+    ck_assert_int_eq(vpu_ring_send_memwr32(&s_tx, addr, &val, 1), 0);
+    vll_ring_flush(&s_tx);
+}
+
+static void check_wr(uint32_t addr, uint32_t val)
+{
+    ck_assert_int_eq(vpu_ring_recv_pkt(&s_rx, &s_ph, s_data, MAX_PAYLOAD), 1);
+    ck_assert_int_eq(s_ph.type, VPT_MEMORY_WRITE_32);
+    ck_assert_int_eq(s_ph.size, 12);
+    ck_assert_int_eq(s_data[0], addr);
+    ck_assert_int_eq(s_data[1], val);
+}
+
+START_TEST(vpu_ring_packets)
+{
+    ck_assert_int_eq(vpu_ring_recv_pkt(&s_rx, &s_ph, s_data, MAX_PAYLOAD), 0);
+
+    // Nothing is visible before flush
+    ck_assert_int_eq(vpu_ring_send_memrdreq32(&s_tx, 0x100, 1, 5), 0);
+    ck_assert_int_eq(vpu_ring_recv_pkt(&s_rx, &s_ph, s_data, MAX_PAYLOAD), 0);
+    vll_ring_flush(&s_tx);
+
+    ck_assert_int_eq(vpu_ring_recv_pkt(&s_rx, &s_ph, s_data, MAX_PAYLOAD), 1);
+    ck_assert_int_eq(s_ph.type, VPT_MEMORY_READ_REQ_32);
+    ck_assert_int_eq(s_ph.tag, 5);
+
+    // Wraps around the ring many times
+    for (unsigned i = 0; i < 4 * RING_MEM_SZ; i++) {
+        send_wr(i, ~i);
+        check_wr(i, ~i);
+    }
+    ck_assert_int_eq(vpu_ring_recv_pkt(&s_rx, &s_ph, s_data, MAX_PAYLOAD), 0);
+}
+END_TEST
+
+START_TEST(vpu_ring_oversized)
+{
+    uint32_t big[MAX_PAYLOAD + 1] = { 0 };
+
+    ck_assert_int_eq(vpu_ring_send_pkt(&s_tx, VPT_MEMORY_WRITE_32, 0, big, MAX_PAYLOAD + 1), 0);
+    send_wr(0x10, 0x55);
+
+    // Skipped as a whole, next packet is intact
+    ck_assert_int_eq(vpu_ring_recv_pkt(&s_rx, &s_ph, s_data, MAX_PAYLOAD), -EMSGSIZE);
+    check_wr(0x10, 0x55);
+    ck_assert_int_eq(vll_ring_avail(&s_rx), 0);
+}
+END_TEST
+
+START_TEST(vpu_ring_broken_header)
+{
+    struct pheader ph = { VPT_MEMORY_WRITE_32, 0, 6 };
+    uint32_t raw[3] = { 0, 1, 2 };
+
+    // Length isn't a whole number of words
+    memcpy(&raw[0], &ph, sizeof(ph));
+    put_raw(raw, 3);
+    ck_assert_int_eq(vpu_ring_recv_pkt(&s_rx, &s_ph, s_data, MAX_PAYLOAD), -EIO);
+    ck_assert_int_eq(vll_ring_avail(&s_rx), 0);
+
+    // Zero length
+    ph.size = 0;
+    memcpy(&raw[0], &ph, sizeof(ph));
+    put_raw(raw, 1);
+    ck_assert_int_eq(vpu_ring_recv_pkt(&s_rx, &s_ph, s_data, MAX_PAYLOAD), -EIO);
+    ck_assert_int_eq(vll_ring_avail(&s_rx), 0);
+
+    // Runs past published data
+    ph.size = 16;
+    memcpy(&raw[0], &ph, sizeof(ph));
+    put_raw(raw, 2);
+    ck_assert_int_eq(vpu_ring_recv_pkt(&s_rx, &s_ph, s_data, MAX_PAYLOAD), -EIO);
+    ck_assert_int_eq(vll_ring_avail(&s_rx), 0);
+
+    // Ring is usable afterwards
+    send_wr(0x20, 0xaa);
+    check_wr(0x20, 0xaa);
+}
+END_TEST
+
+Suite * vpu_ring_suite(void)
+{
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("vpu_ring");
+    tc_core = tcase_create("Core");
+
+    tcase_add_checked_fixture(tc_core, setup, NULL);
+    tcase_add_test(tc_core, vpu_ring_packets);
+    tcase_add_test(tc_core, vpu_ring_oversized);
+    tcase_add_test(tc_core, vpu_ring_broken_header);
+    suite_add_tcase(s, tc_core);
+    return s;
+}
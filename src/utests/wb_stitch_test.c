@@ -0,0 +1,142 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <check.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "wb_stitch.h"
+
+#define BOARDS   4
+#define FFTSZ    256
+#define SPACING  194 // Odd board offsets
+#define NSYMS    (4 * FFTSZ)
+
+static float s_in[BOARDS][2 * NSYMS];
+static float s_out[2 * NSYMS * 8];
+static const float* s_pin[BOARDS] = { s_in[0], s_in[1], s_in[2], s_in[3] };
+
+// Per board gain and LO phase
+static const float s_gain[BOARDS] = { 0.8f, 1.25f, 1.0f, 0.6f };
+static const float s_phase[BOARDS] = { 1.0f, -2.5f, 0.3f, 2.0f };
+
+// Tone at freq (fs / FFTSZ units from the stitched center) as seen by every
+// board, outside of the board alias free band nothing is received
+static void fill_tone(const wb_stitch_t* st, double freq, unsigned blk)
+{
+    for (unsigned b = 0; b < BOARDS; b++) {
+        double f = freq - wb_stitch_offset(st, b);
+        for (unsigned i = 0; i < NSYMS; i++) {
+            double ph = 2 * M_PI * f * (blk * NSYMS + i) / FFTSZ + s_phase[b];
+            bool pass = fabs(f) < 0.45 * FFTSZ;
+            s_in[b][2 * i + 0] = pass ? s_gain[b] * cos(ph) : 0;
+            s_in[b][2 * i + 1] = pass ? s_gain[b] * sin(ph) : 0;
+        }
+    }
+}
+
+// Min/max amplitude of the steady state output for a tone, phase has to
+// advance evenly across block boundaries
+static void tone_response(wb_stitch_t* st, double freq, double* amin, double* amax)
+{
+    unsigned interp = wb_stitch_interp(st);
+    double step = 2 * M_PI * freq / FFTSZ / interp;
+
+    for (unsigned blk = 0; blk < 3; blk++) {
+        fill_tone(st, freq, blk);
+        ck_assert_int_eq(wb_stitch_process(st, s_pin, NSYMS, s_out), 0);
+    }
+
+    *amin = 1e9;
+    *amax = 0;
+    for (unsigned i = 0; i < NSYMS * interp; i++) {
+        double a = hypot(s_out[2 * i], s_out[2 * i + 1]);
+        if (a < *amin)
+            *amin = a;
+        if (a > *amax)
+            *amax = a;
+
+        if (i > 0 && a > 0.5) {
+            double re = s_out[2 * i] * s_out[2 * i - 2] + s_out[2 * i + 1] * s_out[2 * i - 1];
+            double im = s_out[2 * i + 1] * s_out[2 * i - 2] - s_out[2 * i] * s_out[2 * i - 1];
+            double err = remainder(atan2(im, re) - step, 2 * M_PI);
+            ck_assert_float_eq_tol(err, 0.0, 1e-3);
+        }
+    }
+}
+
+START_TEST(wb_stitch_layout)
+{
+    wb_stitch_t* st;
+
+    ck_assert_int_ne(wb_stitch_create(BOARDS, FFTSZ, SPACING + 1, &st), 0);
+    ck_assert_int_ne(wb_stitch_create(BOARDS, FFTSZ, FFTSZ, &st), 0);
+    ck_assert_int_ne(wb_stitch_create(BOARDS, FFTSZ + 1, SPACING, &st), 0);
+
+    ck_assert_int_eq(wb_stitch_create(BOARDS, FFTSZ, SPACING, &st), 0);
+    ck_assert_int_eq(wb_stitch_interp(st), 4);
+    ck_assert_int_eq(wb_stitch_offset(st, 0), -3 * SPACING / 2);
+    ck_assert_int_eq(wb_stitch_offset(st, 1), -SPACING / 2);
+    ck_assert_int_eq(wb_stitch_offset(st, 2), SPACING / 2);
+    ck_assert_int_eq(wb_stitch_offset(st, 3), 3 * SPACING / 2);
+    ck_assert_int_ne(wb_stitch_process(st, s_pin, FFTSZ / 4, s_out), 0);
+    wb_stitch_destroy(st);
+}
+END_TEST
+
+START_TEST(wb_stitch_flatness)
+{
+    double amin, amax, gmin = 1e9, gmax = 0;
+    wb_stitch_t* st;
+
+    // Scan the whole band in fractional bin steps, seams are at 0 and +/- SPACING
+    for (double f = -2 * SPACING + 16; f < 2 * SPACING - 16; f += 3.7) {
+        ck_assert_int_eq(wb_stitch_create(BOARDS, FFTSZ, SPACING, &st), 0);
+        for (unsigned b = 0; b < BOARDS; b++) {
+            wb_stitch_set_eq(st, b, 1 / s_gain[b], -s_phase[b]);
+        }
+
+        tone_response(st, f, &amin, &amax);
+        wb_stitch_destroy(st);
+
+        if (amin < gmin)
+            gmin = amin;
+        if (amax > gmax)
+            gmax = amax;
+    }
+
+    // Less than 0.05 dB of ripple
+    ck_assert_float_eq_tol(20 * log10(gmin), 0.0, 0.05);
+    ck_assert_float_eq_tol(20 * log10(gmax), 0.0, 0.05);
+}
+END_TEST
+
+START_TEST(wb_stitch_unequalized)
+{
+    double amin, amax;
+    wb_stitch_t* st;
+
+    // Without phase equalization boards cancel each other at the seam
+    ck_assert_int_eq(wb_stitch_create(BOARDS, FFTSZ, SPACING, &st), 0);
+    tone_response(st, SPACING, &amin, &amax);
+    wb_stitch_destroy(st);
+
+    ck_assert(amax < 0.9);
+}
+END_TEST
+
+Suite * wb_stitch_suite(void)
+{
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("WbStitch");
+    tc_core = tcase_create("Core");
+
+    tcase_add_test(tc_core, wb_stitch_layout);
+    tcase_add_test(tc_core, wb_stitch_flatness);
+    tcase_add_test(tc_core, wb_stitch_unequalized);
+    suite_add_tcase(s, tc_core);
+    return s;
+}
@@ -0,0 +1,183 @@
+// Copyright (c) 2023-2024 Wavelet Lab
+// SPDX-License-Identifier: MIT
+
+#include <check.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "m2_lm7_1/xsdr_ctrl.h"
+#include "mock_lowlevel.h"
+
+enum {
+    TEST_HWID = 0x30ab0001,
+    TEST_REGS = 300,
+};
+
+static char s_path[64];
+static xsdr_dev_t s_dev;
+static struct xsdr_snapshot_cfg s_cfg;
+static struct xsdr_snapshot_cfg s_img;
+static uint32_t s_regs[TEST_REGS];
+static uint32_t s_out[TEST_REGS];
+static unsigned s_spi_cnt;
+
+static int mock_spi(unsigned UNUSED busno, uint32_t UNUSED dout, uint32_t* UNUSED din)
+{
+    s_spi_cnt++;
+    return 0;
+}
+
+static const struct mock_functions s_mock = {
+    .mock_spi_tr32 = &mock_spi,
+};
+
+static void setup(void)
+{
+    snprintf(s_path, sizeof(s_path), "/tmp/xsdr_snapshot_%d.bin", (int)getpid());
+    for (unsigned i = 0; i < TEST_REGS; i++)
+        s_regs[i] = 0x80000000 | (i << 16) | i;
+
+    memset(&s_dev, 0, sizeof(s_dev));
+    s_dev.hwid = TEST_HWID;
+    s_dev.base.fref = 26000000;
+    s_dev.base.cgen_clk = 491520000;
+    s_dev.base.rx_lo = 2140000000;
+    s_dev.base.tx_lo = 1950000000;
+    s_dev.base.rx_bw[1].value = 20000000;
+    s_dev.base.rx_bw[1].set = true;
+    s_dev.base.rx_gain = 42;
+    s_dev.base.rx_rfic_path = XSDR_RX_W;
+    s_dev.base.trf_lb_atten = 37;
+    s_dev.base.lmsstate.reg_rxgain[1][2] = 0x1234;
+    s_dev.s_rxrate = 30720000;
+    s_dev.gpo_rxsw = 2;
+    s_dev.tune_rf[1] = 1.5e9;
+
+    // Runtime bindings aren't part of the record
+    s_dev.base.lmsstate.rec_buf = s_regs;
+    s_dev.base.lmsstate.rec_max = TEST_REGS;
+
+    xsdr_snapshot_cfg_get(&s_dev, &s_cfg);
+    s_spi_cnt = 0;
+    ck_assert_int_eq(xsdr_snapshot_write(&s_dev, s_regs, TEST_REGS, s_path), 0);
+}
+
+static void teardown(void)
+{
+    remove(s_path);
+}
+
+// Overwrite part of the stored file
+static void patch(long offset, const void* data, size_t size)
+{
+    FILE* f = fopen(s_path, "r+b");
+    ck_assert(f != NULL);
+    ck_assert_int_eq(fseek(f, offset, SEEK_SET), 0);
+    ck_assert_int_eq(fwrite(data, size, 1, f), 1);
+    fclose(f);
+}
+
+START_TEST(snapshot_round_trip)
+{
+    char tmp[80];
+
+    ck_assert_int_eq(xsdr_snapshot_read(s_path, TEST_HWID, &s_img, s_out, TEST_REGS), TEST_REGS);
+    ck_assert(memcmp(&s_img, &s_cfg, sizeof(s_cfg)) == 0);
+    ck_assert(memcmp(s_out, s_regs, sizeof(s_regs)) == 0);
+
+    ck_assert_int_eq(s_img.rx_lo, 2140000000);
+    ck_assert_int_eq(s_img.tx_lo, 1950000000);
+    ck_assert_int_eq(s_img.rx_bw[1], 20000000);
+    ck_assert_int_eq(s_img.rx_bw_set, 2);
+    ck_assert_int_eq(s_img.rx_gain, 42);
+    ck_assert_int_eq(s_img.rx_rfic_path, XSDR_RX_W);
+    ck_assert_int_eq(s_img.trf_lb_atten, 37);
+    ck_assert_int_eq(s_img.reg_rxgain[1][2], 0x1234);
+    ck_assert_int_eq(s_img.s_rxrate, 30720000);
+    ck_assert_int_eq(s_img.gpo_rxsw, 2);
+    ck_assert(s_img.tune_rf[1] == 1.5e9);
+
+    // Temporary file is renamed over the target
+    snprintf(tmp, sizeof(tmp), "%s.tmp", s_path);
+    ck_assert_int_eq(access(tmp, F_OK), -1);
+
+    // Doesn't fit caller's buffer
+    ck_assert_int_eq(xsdr_snapshot_read(s_path, TEST_HWID, &s_img, s_out, TEST_REGS - 1), -E2BIG);
+}
+END_TEST
+
+START_TEST(snapshot_layout_mismatch)
+{
+    uint32_t layout = xsdr_snapshot_layout() ^ 1;
+    uint32_t version = 1;
+
+    patch(offsetof(struct xsdr_snapshot_hdr, layout), &layout, sizeof(layout));
+    ck_assert_int_eq(xsdr_snapshot_read(s_path, TEST_HWID, &s_img, s_out, TEST_REGS), -EINVAL);
+
+    ck_assert_int_eq(xsdr_snapshot_write(&s_dev, s_regs, TEST_REGS, s_path), 0);
+    patch(offsetof(struct xsdr_snapshot_hdr, version), &version, sizeof(version));
+    ck_assert_int_eq(xsdr_snapshot_read(s_path, TEST_HWID, &s_img, s_out, TEST_REGS), -EINVAL);
+}
+END_TEST
+
+START_TEST(snapshot_damaged)
+{
+    uint8_t byte = 0xff;
+
+    ck_assert_int_eq(xsdr_snapshot_read(s_path, TEST_HWID + 1, &s_img, s_out, TEST_REGS), -ESTALE);
+
+    patch(sizeof(struct xsdr_snapshot_hdr) + offsetof(struct xsdr_snapshot_cfg, rx_lo), &byte, sizeof(byte));
+    ck_assert_int_eq(xsdr_snapshot_read(s_path, TEST_HWID, &s_img, s_out, TEST_REGS), -EINVAL);
+
+    ck_assert_int_eq(truncate(s_path, sizeof(struct xsdr_snapshot_hdr) + sizeof(s_cfg)), 0);
+    ck_assert_int_eq(xsdr_snapshot_read(s_path, TEST_HWID, &s_img, s_out, TEST_REGS), -EIO);
+}
+END_TEST
+
+// Rejected file leaves the device in cold state for the regular bring-up
+START_TEST(snapshot_restore_fallback)
+{
+    uint32_t layout = xsdr_snapshot_layout() ^ 1;
+    xsdr_dev_t* d = (xsdr_dev_t*)calloc(1, sizeof(xsdr_dev_t));
+    xsdr_dev_t* cold = (xsdr_dev_t*)malloc(sizeof(xsdr_dev_t));
+    lldev_t dev = mock_lowlevel_create(&s_mock);
+
+    d->base.lmsstate.dev = dev;
+    d->hwid = TEST_HWID;
+    memcpy(cold, d, sizeof(*d));
+
+    patch(offsetof(struct xsdr_snapshot_hdr, layout), &layout, sizeof(layout));
+    ck_assert_int_eq(xsdr_snapshot_restore(d, s_path), -EINVAL);
+    ck_assert(memcmp(d, cold, sizeof(*d)) == 0);
+
+    remove(s_path);
+    ck_assert_int_eq(xsdr_snapshot_restore(d, s_path), -ENOENT);
+    ck_assert(memcmp(d, cold, sizeof(*d)) == 0);
+    ck_assert_int_eq(s_spi_cnt, 0);
+
+    free(dev);
+    free(cold);
+    free(d);
+}
+END_TEST
+
+Suite * xsdr_snapshot_suite(void)
+{
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("xsdr_snapshot");
+    tc_core = tcase_create("Core");
+
+    tcase_add_checked_fixture(tc_core, setup, teardown);
+    tcase_add_test(tc_core, snapshot_round_trip);
+    tcase_add_test(tc_core, snapshot_layout_mismatch);
+    tcase_add_test(tc_core, snapshot_damaged);
+    tcase_add_test(tc_core, snapshot_restore_fallback);
+    suite_add_tcase(s, tc_core);
+    return s;
+}